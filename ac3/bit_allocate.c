@@ -23,8 +23,7 @@
 
 #include "stdafx.h"
 
-static inline sint_16 logadd(sint_16 a,sint_16  b);
-static sint_16 calc_lowcomp(sint_16 a,sint_16 b0,sint_16 b1,sint_16 bin);
+static inline sint_16 calc_lowcomp(sint_16 a,sint_16 b0,sint_16 b1,sint_16 bin);
 static inline sint_16 min_(sint_16 a,sint_16 b);
 static inline sint_16 max_(sint_16 a,sint_16 b);
 static void ba_compute_psd(sint_16 start, sint_16 end, sint_16 exps[], 
@@ -38,6 +37,10 @@ static void ba_compute_mask(sint_16 start, sint_16 end, uint_16 fscod,
 static void ba_compute_bap(sint_16 start, sint_16 end, sint_16 snroffset,
 		sint_16 psd[], sint_16 mask[], sint_16 bap[],ac3_state *state);
 
+/* state->ba_valid: the channels whose bap[] is up to date (fbw channels: bits 0..4) */
+#define BA_CPL	(1<<5)
+#define BA_LFE	(1<<6)
+
 /* Misc LUTs for bit allocation process */
 
 static const sint_16 slowdec[]  = { 0x0f,  0x11,  0x13,  0x15  };
@@ -155,25 +158,10 @@ min_(sint_16 a,sint_16 b)
 	return (a < b ? a : b);
 }
 
-static inline sint_16 
-logadd(sint_16 a,sint_16  b) 
-{ 
-	sint_16 c;
-	sint_16 address;
-
-	c = a - b; 
-	address = min_((sint_16)(abs(c) >> 1), 255); 
-	
-	if (c >= 0) 
-		return(a + latab[address]); 
-	else 
-		return(b + latab[address]); 
-}
-
-
 void bit_allocate(uint_16 fscod, bsi_t *bsi, audblk_t *audblk,ac3_state *state)
 {
 	uint_16 i;
+	uint_16 used;
 	sint_16 fgain;
 	sint_16 snroffset;
 	sint_16 start;
@@ -181,13 +169,31 @@ void bit_allocate(uint_16 fscod, bsi_t *bsi, audblk_t *audblk,ac3_state *state)
 	sint_16 fastleak;
 	sint_16 slowleak;
 
-	/* Only perform bit_allocation if the exponents have changed or we
-	 * have new sideband information */
-	if (audblk->chexpstr[0]  == 0 && audblk->chexpstr[1] == 0 &&
-			audblk->chexpstr[2]  == 0 && audblk->chexpstr[3] == 0 &&
-			audblk->chexpstr[4]  == 0 && audblk->cplexpstr   == 0 &&
-			audblk->lfeexpstr    == 0 && audblk->baie        == 0 &&
-			audblk->snroffste    == 0 && audblk->deltbaie    == 0)
+	/* Only reallocate the channels whose exponents have changed: the others
+	 * keep the bap[] of the previous block unless there is new sideband information */
+	if (audblk->baie || audblk->snroffste || audblk->deltbaie)
+		state->ba_valid = 0;
+
+	used = (uint_16)((1 << bsi->nfchans) - 1);
+	for(i = 0; i < bsi->nfchans; i++)
+		if(audblk->chexpstr[i] != EXP_REUSE)
+			state->ba_valid &= ~(1 << i);
+
+	if(audblk->cplinu)
+	{
+		used |= BA_CPL;
+		if(audblk->cplexpstr != EXP_REUSE || audblk->cplstre || audblk->cplleake)
+			state->ba_valid &= ~BA_CPL;
+	}
+
+	if(bsi->lfeon)
+	{
+		used |= BA_LFE;
+		if(audblk->lfeexpstr != EXP_REUSE)
+			state->ba_valid &= ~BA_LFE;
+	}
+
+	if((state->ba_valid & used) == used)
 		return;
 
 	/* Do some setup before we do the bit alloc */
@@ -206,12 +212,16 @@ void bit_allocate(uint_16 fscod, bsi_t *bsi, audblk_t *audblk,ac3_state *state)
 		memset(audblk->fbw_bap,0,sizeof(uint_16) * 256 * 5);
 		memset(audblk->cpl_bap,0,sizeof(uint_16) * 256);
 		memset(audblk->lfe_bap,0,sizeof(uint_16) * 7);
+		state->ba_valid = BA_CPL | BA_LFE | 0x1f;
 		return;
 	}
 		 
 
 	for(i = 0; i < bsi->nfchans; i++)
 	{
+		if(state->ba_valid & (1 << i))
+			continue;
+
 		start = 0;
 		end = audblk->endmant[i] ; 
 		fgain = fastgain[audblk->fgaincod[i]]; 
@@ -229,7 +239,7 @@ void bit_allocate(uint_16 fscod, bsi_t *bsi, audblk_t *audblk,ac3_state *state)
 		ba_compute_bap(start, end, snroffset, state->psd, state->mask, (sint_16 *)audblk->fbw_bap[i],state);
 	}
 
-	if(audblk->cplinu)
+	if(audblk->cplinu && !(state->ba_valid & BA_CPL))
 	{
 		start = audblk->cplstrtmant; 
 		end = audblk->cplendmant; 
@@ -248,7 +258,7 @@ void bit_allocate(uint_16 fscod, bsi_t *bsi, audblk_t *audblk,ac3_state *state)
 		ba_compute_bap(start, end, snroffset, state->psd, state->mask, (sint_16 *)audblk->cpl_bap,state);
 	}
 
-	if(bsi->lfeon)
+	if(bsi->lfeon && !(state->ba_valid & BA_LFE))
 	{
 		start = 0;
 		end = 7;
@@ -266,14 +276,17 @@ void bit_allocate(uint_16 fscod, bsi_t *bsi, audblk_t *audblk,ac3_state *state)
 
 		ba_compute_bap(start, end, snroffset, state->psd, state->mask, (sint_16 *)audblk->lfe_bap,state);
 	}
+
+	state->ba_valid |= used;
 }
 
 
 static void ba_compute_psd(sint_16 start, sint_16 end, sint_16 exps[], 
 		sint_16 psd[], sint_16 bndpsd[])
 {
-	int bin,i,j,k;
-	sint_16 lastbin = 0;
+	int bin,j,k;
+	sint_16 lastbin;
+	sint_16 v,c;
 	
 	/* Map the exponents into dBs */
 	for (bin=start; bin<end; bin++) 
@@ -284,21 +297,30 @@ static void ba_compute_psd(sint_16 start, sint_16 end, sint_16 exps[],
 	/* Integrate the psd function over each bit allocation band */
 	j = start; 
 	k = masktab[start]; 
-	
-	do 
-	{ 
+
+	/* the first 28 bands are one bin wide */
+	if (j < 28)
+	{
+		lastbin = min_(28, end);
+		for (; j < lastbin; j++)
+			bndpsd[j] = psd[j];
+		k = j;
+	}
+
+	/* the others: log-addition, max(a,b) + latab[|a-b|/2] */
+	while (j < end)
+	{
 		lastbin = min_((sint_16)(bndtab[k] + bndsz[k]), end); 
-		bndpsd[k] = psd[j]; 
-		j++; 
+		v = psd[j++];
 
-		for (i = j; i < lastbin; i++) 
-		{ 
-			bndpsd[k] = logadd(bndpsd[k], psd[j]);
-			j++; 
-		} 
-		
-		k++; 
-	} while (end > lastbin);
+		for (; j < lastbin; j++)
+		{
+			c = v - psd[j];
+			v = max_(v, psd[j]) + latab[min_((sint_16)(abs(c) >> 1), 255)];
+		}
+
+		bndpsd[k++] = v;
+	}
 }
 
 static void ba_compute_excitation(sint_16 start, sint_16 end,sint_16 fgain,
@@ -350,7 +372,7 @@ static void ba_compute_excitation(sint_16 start, sint_16 end,sint_16 fgain,
 			fastleak = max_(fastleak, (sint_16)(bndpsd[bin] - fgain));
 			slowleak -= state->sdecay ; 
 			slowleak = max_(slowleak, (sint_16)(bndpsd[bin] - state->sgain));
-			state->excite[bin] = max_((sint_16)(fastleak - lowcomp), slowleak); 
+			excite[bin] = max_((sint_16)(fastleak - lowcomp), slowleak); 
 		} 
 		begin = 22; 
 	} 
@@ -362,9 +384,9 @@ static void ba_compute_excitation(sint_16 start, sint_16 end,sint_16 fgain,
 	for (bin = begin; bin < bndend; bin++) 
 	{ 
 		fastleak -= state->fdecay; 
-		fastleak = max_(fastleak, (sint_16)(state->bndpsd[bin] - fgain)); 
+		fastleak = max_(fastleak, (sint_16)(bndpsd[bin] - fgain)); 
 		slowleak -= state->sdecay; 
-		slowleak = max_(slowleak, (sint_16)(state->bndpsd[bin] - state->sgain)); 
+		slowleak = max_(slowleak, (sint_16)(bndpsd[bin] - state->sgain)); 
 		excite[bin] = max_(fastleak, slowleak) ; 
 	} 
 }
@@ -387,9 +409,9 @@ static void ba_compute_mask(sint_16 start, sint_16 end, uint_16 fscod,
 	{ 
 		if (state->bndpsd[bin] < state->dbknee) 
 		{ 
-			state->excite[bin] += ((state->dbknee - state->bndpsd[bin]) >> 2); 
+			excite[bin] += ((state->dbknee - state->bndpsd[bin]) >> 2); 
 		} 
-		mask[bin] = max_(state->excite[bin], hth[fscod][bin]);
+		mask[bin] = max_(excite[bin], hth[fscod][bin]);
 	}
 	
 	/* Perform delta bit modulation if necessary */
@@ -410,7 +432,7 @@ static void ba_compute_mask(sint_16 start, sint_16 end, uint_16 fscod,
 				delta = (deltba[seg] - 4) << 7;
 			} 
 			
-			for (k = 0; k < deltlen[seg]; k++) 
+			for (k = 0; k < deltlen[seg] && band < 50; k++) 
 			{ 
 				mask[band] += delta; 
 				band++; 
@@ -422,37 +444,34 @@ static void ba_compute_mask(sint_16 start, sint_16 end, uint_16 fscod,
 static void ba_compute_bap(sint_16 start, sint_16 end, sint_16 snroffset,
 		sint_16 psd[], sint_16 mask[], sint_16 bap[],ac3_state *state)
 {
-	int i,j,k;
-	sint_16 lastbin = 0;
-	sint_16 address = 0;
+	int i,j;
+	sint_16 lastbin;
+	sint_16 m;
+	sint_16 address;
 
-	/* Compute the bit allocation pointer for each bin */
+	/* Compute the bit allocation pointer for each bin: one masking value per band */
 	i = start; 
 	j = masktab[start]; 
 
-	do 
+	while (i < end)
 	{ 
 		lastbin = min_((sint_16)(bndtab[j] + bndsz[j]), end); 
-		mask[j] -= snroffset; 
-		mask[j] -= state->floor_; 
-		
-		if (mask[j] < 0) 
-			mask[j] = 0; 
 
-		mask[j] &= 0x1fe0;
-		mask[j] += state->floor_; 
-		for (k = i; k < lastbin; k++) 
+		m = mask[j] - snroffset - state->floor_; 
+		if (m < 0) 
+			m = 0; 
+		m = (m & 0x1fe0) + state->floor_; 
+
+		for (; i < lastbin; i++) 
 		{ 
-			address = (psd[i] - mask[j]) >> 5; 
-			address = min_(63, max_(0, address)); 
-			bap[i] = baptab[address]; 
-			i++; 
+			address = (psd[i] - m) >> 5; 
+			bap[i] = baptab[min_(63, max_(0, address))]; 
 		} 
 		j++; 
-	} while (end > lastbin);
+	}
 }
 
-static sint_16 
+static inline sint_16 
 calc_lowcomp(sint_16 a,sint_16 b0,sint_16 b1,sint_16 bin) 
 { 
 
@@ -23,6 +23,8 @@
 
 #include "stdafx.h"
 
+// the bit reader itself (bitstream_get) is inlined from driver/ac3.h
+
 uint_8 bitstream_get_byte(ac3_state *state)
 {
 	if(state->chunk_start == state->chunk_end)
@@ -31,78 +33,46 @@ uint_8 bitstream_get_byte(ac3_state *state)
 	return (*state->chunk_start++);
 }
 
-uint_8 *bitstream_get_buffer_start(ac3_state *state)
+// copies 'size' bytes of the input (fill_buffer) to 'dest'
+void bitstream_get_bytes(uint_8 *dest,uint_32 size,ac3_state *state)
 {
-	return state->buffer_start;
+	uint_32 total = size;
+	uintptr_t num_bytes;
+
+	while(size)
+	{
+		if(state->chunk_start > state->chunk_end)
+		{
+			debug(1,"!!! chunk_start>end\n");
+		}
+		if(state->chunk_start >= state->chunk_end)
+			state->fill_buffer(&state->chunk_start,&state->chunk_end,state,total);
+
+		num_bytes = (uintptr_t)state->chunk_end - (uintptr_t)state->chunk_start;
+		if(num_bytes > size)
+			num_bytes = size;
+
+		memcpy(dest, state->chunk_start, num_bytes);
+
+		dest += num_bytes;
+		size -= (uint_32)num_bytes;
+		state->chunk_start += num_bytes;
+	}
 }
 
-void bitstream_buffer_frame(uint_32 frame_size,ac3_state *state)
+// starts reading the syncframe body (its first 'size' bytes are in state->buffer)
+void bitstream_set_frame(uint_32 size,ac3_state *state)
 {
-  uintptr_t bytes_read=0;
-  uintptr_t num_bytes=0;
-
-  do
-  {
-    if(state->chunk_start > state->chunk_end)
-    {
-    	debug(1,"!!! chunk_start>end\n");
-    }
-    if(state->chunk_start >= state->chunk_end)
-      state->fill_buffer(&state->chunk_start,&state->chunk_end,state,frame_size);
-
-    num_bytes = (uintptr_t)state->chunk_end - (uintptr_t)state->chunk_start;
-
-    if(bytes_read + num_bytes > frame_size)
-      num_bytes = frame_size - bytes_read;
-
-    memcpy(&state->buffer[bytes_read], state->chunk_start, num_bytes);
-
-    bytes_read += num_bytes;
-    state->chunk_start += num_bytes;
-  }
-  while (bytes_read < frame_size);
-
-  state->buffer_start = state->buffer;
-  state->buffer_end   = (uint_8 *)((uintptr_t)state->buffer + (uintptr_t)frame_size);
-
-  state->bits_left = 0;
-}
-
-void bitstream_fill_current(ac3_state *state)
-{
-	state->current_word = *((uint_32*)state->buffer_start)++;
-	state->current_word = swab32(state->current_word);
-}
-
-//
-// The fast paths for _get is in the
-// bitstream.h header file so it can be inlined.
-//
-// The "bottom half" of this routine is suffixed _bh
-//
-// -ah
-//
-
-uint_32 bitstream_get_bh(uint_32 num_bits,ac3_state *state)
-{
-	uint_32 result;
-
-	num_bits -= state->bits_left;
-	result = (state->current_word << (32 - state->bits_left)) >> (32 - state->bits_left);
-
-	bitstream_fill_current(state);
+	memset(&state->buffer[size],0,BITSTREAM_PADDING);
 
-	if(num_bits != 0)
-		result = (result << num_bits) | (state->current_word >> (32 - num_bits));
-	
-	state->bits_left = 32 - num_bits;
+	state->buffer_start = state->buffer;
+	state->buffer_end = state->buffer + size;
 
-	return result;
+	state->bit_cache = 0;
+	state->bits_left = 0;
 }
 
 void bitstream_init(ac3_state *state)
 {
-	// Setup the buffer fill callback 
-	state->buffer_start=state->buffer;
-	state->buffer_end=state->buffer;
+	bitstream_set_frame(0,state);
 }
@@ -111,8 +111,8 @@ convert_to_float(uint_32 exp, sint_32 mantissa)
 	float x;
 
 	//the scale by 2^-15 is built into the scale factor table
-        if(exp>25)
-         exp=25;
+        if(exp>24)
+         exp=24;
 	x = mantissa * scale_factor[exp];
 
 	return x;
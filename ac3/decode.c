@@ -26,43 +26,51 @@
 void __stdcall ac3_init(ac3_state *state)
 {
 	state->frame_count=0;
+	state->feed_have=0;
+	state->feed_size=0;
 	bitstream_init(state);
-	imdct_init();
+	imdct_init(state);
+	ac3_set_output(state,AC3_OUTPUT_51,AC3_FORMAT_S16,1.0f,0,NULL);
 	sanity_check_init(&state->syncinfo,&state->bsi,&state->audblk);
 }
 
-int __stdcall ac3_decode_frame(ac3_state *state)
+// decodes the syncframe in state->buffer (syncinfo is parsed, the crc is valid)
+static int decode_syncframe(ac3_state *state)
 {
 	uint_32 i;
-	int j;
 	int error_flag=0;
 
-	// debug(DAC3,"(decode_frame) begin frame %d\n",state->frame_count);
-
-	//find a syncframe and parse
-	parse_syncinfo(&state->syncinfo,&error_flag,state);
-	if(error_flag)
-	{
-		// debug(DAC3," -- fail after parse_syncinfo\n");
-		goto error;
-	}
-
         state->frame_count++;
 
 	state->sampling_rate = state->syncinfo.sampling_rate;
 
 	parse_bsi(&state->bsi,state);
+	output_setup(state);
+
+	// each frame starts a new bit allocation (block 0 carries the exponents)
+	// without delta bit allocation, unless block 0 sends one
+	state->ba_valid=0;
+	state->audblk.cpldeltbae=DELTA_BIT_NONE;
+	for(i=0; i < 5; i++)
+		state->audblk.deltbae[i]=DELTA_BIT_NONE;
 
 	stats_print_banner(&state->syncinfo,&state->bsi,state);
 
 	for(i=0; i < 6; i++)
 	{
 		//Initialize freq/time sample storage
-		memset(state->samples,0,sizeof(float) * 256 * (state->bsi.nfchans + state->bsi.lfeon));
+		memset(state->samples,0,sizeof(float) * 256 * state->bsi.nfchans);
+		if(state->bsi.lfeon)
+			memset(state->samples[5],0,sizeof(float) * 256);
 
 		// Extract most of the audblk info from the bitstream
 		// (minus the mantissas 
-		parse_audblk(&state->bsi,&state->audblk,state);
+		parse_audblk(&state->bsi,&state->audblk,i,&error_flag,state);
+		if(error_flag)
+		{
+			// debug(DAC3," -- fail after parse_audblk\n");
+			goto error;
+		}
 
 		// Take the differential exponent data and turn it into
 		// absolute exponents 
@@ -85,26 +93,20 @@ int __stdcall ac3_decode_frame(ac3_state *state)
 			goto error;
 		}
 
+		// a malformed block must not read past the end of the syncframe
+		if(bitstream_get_total_bits(state) > (uint_32)state->syncinfo.frame_size * 16)
+			goto error;
+
 		if(state->bsi.acmod == 0x2)
 		{
 			rematrix(&state->audblk,state->samples);
 		}	
 
 		// Convert the frequency samples into time samples
-		imdct(&state->bsi,&state->audblk,state->samples);
+		imdct(state,&state->bsi,&state->audblk,state->samples);
 
-		// Downmix into the requested number of channels
-		// and convert floating point to sint_16
-
-		for(j=0;j<256;j++)
-		{
-			state->left[i*256+j]=(sint_16)(state->samples[0][j]*32767.0f);
-                        state->center[i*256+j]=(sint_16)(state->samples[1][j]*32767.0f);
-                	state->right[i*256+j]=(sint_16)(state->samples[2][j]*32767.0f);
-                        state->sleft[i*256+j]=(sint_16)(state->samples[3][j]*32767.0f);
-                        state->sright[i*256+j]=(sint_16)(state->samples[4][j]*32767.0f);
-                        state->subwoofer[i*256+j]=(sint_16)(state->samples[5][j]*32767.0f);
-                }
+		// Downmix, scale, dither and pack into the requested output format
+		output_block(state,i);
 
 		sanity_check(&state->syncinfo,&state->bsi,&state->audblk,&error_flag,state);
 		if(error_flag)
@@ -122,3 +124,96 @@ error:
 
 	return -1;
 }
+
+int __stdcall ac3_decode_frame(ac3_state *state)
+{
+	int error_flag=0;
+
+	// debug(DAC3,"(decode_frame) begin frame %d\n",state->frame_count);
+
+	//find a syncframe and parse
+	parse_syncinfo(&state->syncinfo,&error_flag,state);
+	if(error_flag)
+	{
+		// debug(DAC3," -- fail after parse_syncinfo\n");
+		return -1;
+	}
+
+	return decode_syncframe(state);
+}
+
+static int feed_decode(ac3_state *state)
+{
+	uint_32 tmp=(state->feed_header[2]<<16)|(state->feed_header[3]<<8)|state->feed_header[4];
+	int size=state->feed_size;
+
+	state->feed_have=0;
+	state->feed_size=0;
+
+	bitstream_set_frame(size-5,state);
+
+	if(parse_syncinfo_crc(&state->syncinfo,tmp,state))
+		return -1;
+
+	return decode_syncframe(state)?-1:size;
+}
+
+int __stdcall ac3_feed(ac3_state *state,const uint_8 *data,int size,int *consumed)
+{
+	const uint_8 *p=data,*end=data+size;
+	uint_32 n;
+
+	while(p<end)
+	{
+		if(state->feed_size==0)
+		{
+			// look for the sync word and collect the syncinfo header
+			if(state->feed_have==0)
+			{
+				const uint_8 *s=(const uint_8 *)memchr(p,0x0b,end-p);
+				if(s==NULL)
+				{
+					p=end;
+					break;
+				}
+				p=s+1;
+				state->feed_header[state->feed_have++]=0x0b;
+				continue;
+			}
+			if(state->feed_have==1 && *p!=0x77)
+			{
+				// not consumed: it can be the start of the sync word
+				state->feed_have=0;
+				continue;
+			}
+			state->feed_header[state->feed_have++]=*p++;
+			if(state->feed_have<5)
+				continue;
+
+			if(parse_syncinfo_header(&state->syncinfo,
+				(state->feed_header[2]<<16)|(state->feed_header[3]<<8)|state->feed_header[4],state))
+			{
+				state->feed_have=0;
+				continue;
+			}
+			state->feed_size=state->syncinfo.frame_size*2;
+		}
+
+		// the rest of the syncframe goes to the frame buffer
+		n=state->feed_size-state->feed_have;
+		if(n>(uint_32)(end-p))
+			n=(uint_32)(end-p);
+		memcpy(&state->buffer[state->feed_have-5],p,n);
+		p+=n;
+		state->feed_have+=n;
+
+		if(state->feed_have==state->feed_size)
+		{
+			*consumed=(int)(p-data);
+			return feed_decode(state);
+		}
+	}
+
+	*consumed=(int)(p-data);
+	return 0;
+}
@@ -26,6 +26,36 @@
 static void exp_unpack_ch(uint_16 type,uint_16 expstr,uint_16 ngrps,uint_16 initial_exp, 
 		uint_16 exps[], uint_16 *dest, int *error_flag,ac3_state *state);
 
+/* exponent group -> the three differential exponents (A/52 7.1.3) */
+static const sint_8 exp_ungroup[125][3] =
+{
+	{-2,-2,-2}, {-2,-2,-1}, {-2,-2, 0}, {-2,-2, 1}, {-2,-2, 2},
+	{-2,-1,-2}, {-2,-1,-1}, {-2,-1, 0}, {-2,-1, 1}, {-2,-1, 2},
+	{-2, 0,-2}, {-2, 0,-1}, {-2, 0, 0}, {-2, 0, 1}, {-2, 0, 2},
+	{-2, 1,-2}, {-2, 1,-1}, {-2, 1, 0}, {-2, 1, 1}, {-2, 1, 2},
+	{-2, 2,-2}, {-2, 2,-1}, {-2, 2, 0}, {-2, 2, 1}, {-2, 2, 2},
+	{-1,-2,-2}, {-1,-2,-1}, {-1,-2, 0}, {-1,-2, 1}, {-1,-2, 2},
+	{-1,-1,-2}, {-1,-1,-1}, {-1,-1, 0}, {-1,-1, 1}, {-1,-1, 2},
+	{-1, 0,-2}, {-1, 0,-1}, {-1, 0, 0}, {-1, 0, 1}, {-1, 0, 2},
+	{-1, 1,-2}, {-1, 1,-1}, {-1, 1, 0}, {-1, 1, 1}, {-1, 1, 2},
+	{-1, 2,-2}, {-1, 2,-1}, {-1, 2, 0}, {-1, 2, 1}, {-1, 2, 2},
+	{ 0,-2,-2}, { 0,-2,-1}, { 0,-2, 0}, { 0,-2, 1}, { 0,-2, 2},
+	{ 0,-1,-2}, { 0,-1,-1}, { 0,-1, 0}, { 0,-1, 1}, { 0,-1, 2},
+	{ 0, 0,-2}, { 0, 0,-1}, { 0, 0, 0}, { 0, 0, 1}, { 0, 0, 2},
+	{ 0, 1,-2}, { 0, 1,-1}, { 0, 1, 0}, { 0, 1, 1}, { 0, 1, 2},
+	{ 0, 2,-2}, { 0, 2,-1}, { 0, 2, 0}, { 0, 2, 1}, { 0, 2, 2},
+	{ 1,-2,-2}, { 1,-2,-1}, { 1,-2, 0}, { 1,-2, 1}, { 1,-2, 2},
+	{ 1,-1,-2}, { 1,-1,-1}, { 1,-1, 0}, { 1,-1, 1}, { 1,-1, 2},
+	{ 1, 0,-2}, { 1, 0,-1}, { 1, 0, 0}, { 1, 0, 1}, { 1, 0, 2},
+	{ 1, 1,-2}, { 1, 1,-1}, { 1, 1, 0}, { 1, 1, 1}, { 1, 1, 2},
+	{ 1, 2,-2}, { 1, 2,-1}, { 1, 2, 0}, { 1, 2, 1}, { 1, 2, 2},
+	{ 2,-2,-2}, { 2,-2,-1}, { 2,-2, 0}, { 2,-2, 1}, { 2,-2, 2},
+	{ 2,-1,-2}, { 2,-1,-1}, { 2,-1, 0}, { 2,-1, 1}, { 2,-1, 2},
+	{ 2, 0,-2}, { 2, 0,-1}, { 2, 0, 0}, { 2, 0, 1}, { 2, 0, 2},
+	{ 2, 1,-2}, { 2, 1,-1}, { 2, 1, 0}, { 2, 1, 1}, { 2, 1, 2},
+	{ 2, 2,-2}, { 2, 2,-1}, { 2, 2, 0}, { 2, 2, 1}, { 2, 2, 2}
+};
+
 void exponent_unpack( bsi_t *bsi, audblk_t *audblk,int *error_flag,ac3_state *state)
 {
 	uint_16 i;
@@ -48,71 +78,57 @@ void exponent_unpack( bsi_t *bsi, audblk_t *audblk,int *error_flag,ac3_state *st
 static void exp_unpack_ch(uint_16 type,uint_16 expstr,uint_16 ngrps,uint_16 initial_exp, 
 		uint_16 exps[], uint_16 *dest,int *error_flag,ac3_state *state)
 {
-	uint_16 i,j;
+	uint_16 i;
 	sint_16 exp_acc;
-	sint_16 exp_1,exp_2,exp_3;
+	const sint_8 *d;
 
 	if(expstr == EXP_REUSE)
 		return;
 
 	/* Handle the initial absolute exponent */
 	exp_acc = initial_exp;
-	j = 0;
 
 	/* In the case of a fbw channel then the initial absolute values is 
 	 * also an exponent */
 	if(type != UNPACK_CPL)
-		dest[j++] = exp_acc;
+		*dest++ = exp_acc;
 
-	/* Loop through the groups and fill the dest array appropriately */
+	/* Loop through the groups and fill the dest array appropriately:
+	 * each exponent is repeated 1 (D15), 2 (D25) or 4 (D45) times */
 	for(i=0; i< ngrps; i++)
-	{
 		if(exps[i] > 124)
 			goto error;
 
-		exp_1 = exps[i] / 25;
-		exp_2 = (exps[i] - (exp_1 * 25)) / 5;
-		exp_3 = exps[i] - (exp_1 * 25) - (exp_2 * 5) ;
-
-		exp_acc += (exp_1 - 2);
-
-		switch(expstr)
-		{
-			case EXP_D45:
-				dest[j++] = exp_acc;
-				dest[j++] = exp_acc;
-			case EXP_D25:
-				dest[j++] = exp_acc;
-			case EXP_D15:
-				dest[j++] = exp_acc;
-		}
-
-		exp_acc += (exp_2 - 2);
-
-		switch(expstr)
-		{
-			case EXP_D45:
-				dest[j++] = exp_acc;
-				dest[j++] = exp_acc;
-			case EXP_D25:
-				dest[j++] = exp_acc;
-			case EXP_D15:
-				dest[j++] = exp_acc;
-		}
-
-		exp_acc += (exp_3 - 2);
-
-		switch(expstr)
-		{
-			case EXP_D45:
-				dest[j++] = exp_acc;
-				dest[j++] = exp_acc;
-			case EXP_D25:
-				dest[j++] = exp_acc;
-			case EXP_D15:
-				dest[j++] = exp_acc;
-		}
-	}	
+	switch(expstr)
+	{
+		case EXP_D15:
+			for(i=0; i< ngrps; i++, dest+=3)
+			{
+				d = exp_ungroup[exps[i]];
+				dest[0] = exp_acc += d[0];
+				dest[1] = exp_acc += d[1];
+				dest[2] = exp_acc += d[2];
+			}
+			break;
+		case EXP_D25:
+			for(i=0; i< ngrps; i++, dest+=6)
+			{
+				d = exp_ungroup[exps[i]];
+				dest[0] = dest[1] = exp_acc += d[0];
+				dest[2] = dest[3] = exp_acc += d[1];
+				dest[4] = dest[5] = exp_acc += d[2];
+			}
+			break;
+		case EXP_D45:
+			for(i=0; i< ngrps; i++, dest+=12)
+			{
+				d = exp_ungroup[exps[i]];
+				dest[0] = dest[1] = dest[2] = dest[3] = exp_acc += d[0];
+				dest[4] = dest[5] = dest[6] = dest[7] = exp_acc += d[1];
+				dest[8] = dest[9] = dest[10] = dest[11] = exp_acc += d[2];
+			}
+			break;
+	}
 
 	return;
 
@@ -21,441 +21,467 @@
 
 // source code license / origin is unknown; probably, public domain
 
-#pragma function(cos)
-#pragma function(sin)
+// 512 / 2x256 point IMDCT: pre-twiddle, 128 (2x64) point complex FFT, post-twiddle, window and
+// overlap-add
+// the FFT is split-radix on separate real / imaginary arrays; the pre-twiddle stores the
+// coefficients in the FFT input order, so there is no bit reverse pass
+// the post-twiddle, the window and the overlap-add are done in a single pass
+// all the tables are constant (imdcttbl.h); the delay lines and the work area are in ac3_state,
+// so several streams can be decoded at the same time
+// SSE is used when available (the caller saves the FPU state: see dpc_ac3_func())
 
 #include "stdafx.h"
 
-#ifndef M_PI
- #define M_PI 3.14159265359
+// IMDCT_SSE 1: always available, 2: checked by imdct_init()
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__) || defined(__SSE__)
+ #define IMDCT_SSE	1
+#elif defined(_M_IX86)
+ #define IMDCT_SSE	2
+ #include <intrin.h>
 #endif
 
-void imdct_do_256(float data[],float delay[]);
-void imdct_do_512(float data[],float delay[]);
+#ifdef IMDCT_SSE
+ #include <xmmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+ #define IMDCT_ALIGN(decl) __declspec(align(16)) decl
+#else
+ #define IMDCT_ALIGN(decl) decl __attribute__((aligned(16)))
+#endif
+
+#include "imdcttbl.h"
+
+// split-radix twiddles by log2(FFT size): [0]: cos(2*pi*k/n), [1]: -sin(2*pi*k/n),
+// [2], [3]: the same for 3*k; k<n/4
+static const float *const fft_twiddle[8]=
+{
+	0, 0, 0, imdct_w8[0], imdct_w16[0], imdct_w32[0], imdct_w64[0], imdct_w128[0]
+};
 
-typedef struct complex_s
+// 16-byte aligned work area inside ac3_state
+#define imdct_mem(state) ((float *)(((uintptr_t)(state)->imdct_mem+15)&~(uintptr_t)15))
+#define IMDCT_DELAY(mem,ch) ((mem)+(ch)*256)
+#define IMDCT_RE(mem) ((mem)+6*256)
+#define IMDCT_IM(mem) ((mem)+6*256+128)
+
+// (re,im) in the split-radix input order -> DFT, in place; n>=8
+// the first half holds the transform of the even inputs, the third and the last quarters
+// hold the transforms of the inputs 4m+1 and 4m+3
+
+static inline void fft4(float *re,float *im)
+{
+	float e0r=re[0]+re[1],e0i=im[0]+im[1];
+	float e1r=re[0]-re[1],e1i=im[0]-im[1];
+	float sr=re[2]+re[3],si=im[2]+im[3];
+	float dr=re[2]-re[3],di=im[2]-im[3];
+
+	re[0]=e0r+sr; im[0]=e0i+si;
+	re[2]=e0r-sr; im[2]=e0i-si;
+	re[1]=e1r+di; im[1]=e1i-dr;
+	re[3]=e1r-di; im[3]=e1i+dr;
+}
+
+static inline void fft2(float *re,float *im)
 {
-	float real;
-	float imag;
-} complex_t;
-
-
-#define N 512
-
-
-/* 128 point bit-reverse LUT */
-static uint_8 bit_reverse_512[] = {
-	0x00, 0x40, 0x20, 0x60, 0x10, 0x50, 0x30, 0x70, 
-	0x08, 0x48, 0x28, 0x68, 0x18, 0x58, 0x38, 0x78, 
-	0x04, 0x44, 0x24, 0x64, 0x14, 0x54, 0x34, 0x74, 
-	0x0c, 0x4c, 0x2c, 0x6c, 0x1c, 0x5c, 0x3c, 0x7c, 
-	0x02, 0x42, 0x22, 0x62, 0x12, 0x52, 0x32, 0x72, 
-	0x0a, 0x4a, 0x2a, 0x6a, 0x1a, 0x5a, 0x3a, 0x7a, 
-	0x06, 0x46, 0x26, 0x66, 0x16, 0x56, 0x36, 0x76, 
-	0x0e, 0x4e, 0x2e, 0x6e, 0x1e, 0x5e, 0x3e, 0x7e, 
-	0x01, 0x41, 0x21, 0x61, 0x11, 0x51, 0x31, 0x71, 
-	0x09, 0x49, 0x29, 0x69, 0x19, 0x59, 0x39, 0x79, 
-	0x05, 0x45, 0x25, 0x65, 0x15, 0x55, 0x35, 0x75, 
-	0x0d, 0x4d, 0x2d, 0x6d, 0x1d, 0x5d, 0x3d, 0x7d, 
-	0x03, 0x43, 0x23, 0x63, 0x13, 0x53, 0x33, 0x73, 
-	0x0b, 0x4b, 0x2b, 0x6b, 0x1b, 0x5b, 0x3b, 0x7b, 
-	0x07, 0x47, 0x27, 0x67, 0x17, 0x57, 0x37, 0x77, 
-	0x0f, 0x4f, 0x2f, 0x6f, 0x1f, 0x5f, 0x3f, 0x7f};
-
-static uint_8 bit_reverse_256[] = {
-	0x00, 0x20, 0x10, 0x30, 0x08, 0x28, 0x18, 0x38, 
-	0x04, 0x24, 0x14, 0x34, 0x0c, 0x2c, 0x1c, 0x3c, 
-	0x02, 0x22, 0x12, 0x32, 0x0a, 0x2a, 0x1a, 0x3a, 
-	0x06, 0x26, 0x16, 0x36, 0x0e, 0x2e, 0x1e, 0x3e, 
-	0x01, 0x21, 0x11, 0x31, 0x09, 0x29, 0x19, 0x39, 
-	0x05, 0x25, 0x15, 0x35, 0x0d, 0x2d, 0x1d, 0x3d, 
-	0x03, 0x23, 0x13, 0x33, 0x0b, 0x2b, 0x1b, 0x3b, 
-	0x07, 0x27, 0x17, 0x37, 0x0f, 0x2f, 0x1f, 0x3f};
-
-static complex_t buf[128];
-
-/* Twiddle factor LUT */
-static complex_t *w[7];
-static complex_t w_1[1];
-static complex_t w_2[2];
-static complex_t w_4[4];
-static complex_t w_8[8];
-static complex_t w_16[16];
-static complex_t w_32[32];
-static complex_t w_64[64];
-
-/* Twiddle factors for IMDCT */
-static float xcos1[128];
-static float xsin1[128];
-static float xcos2[64];
-static float xsin2[64];
-
-/* Delay buffer for time domain interleaving */
-static float delay[6][256];
-
-/* Windowing function for Modified DCT - Thank you acroread */
-static float window[] = {
-	0.00014f, 0.00024f, 0.00037f, 0.00051f, 0.00067f, 0.00086f, 0.00107f, 0.00130f,
-	0.00157f, 0.00187f, 0.00220f, 0.00256f, 0.00297f, 0.00341f, 0.00390f, 0.00443f,
-	0.00501f, 0.00564f, 0.00632f, 0.00706f, 0.00785f, 0.00871f, 0.00962f, 0.01061f,
-	0.01166f, 0.01279f, 0.01399f, 0.01526f, 0.01662f, 0.01806f, 0.01959f, 0.02121f,
-	0.02292f, 0.02472f, 0.02662f, 0.02863f, 0.03073f, 0.03294f, 0.03527f, 0.03770f,
-	0.04025f, 0.04292f, 0.04571f, 0.04862f, 0.05165f, 0.05481f, 0.05810f, 0.06153f,
-	0.06508f, 0.06878f, 0.07261f, 0.07658f, 0.08069f, 0.08495f, 0.08935f, 0.09389f,
-	0.09859f, 0.10343f, 0.10842f, 0.11356f, 0.11885f, 0.12429f, 0.12988f, 0.13563f,
-	0.14152f, 0.14757f, 0.15376f, 0.16011f, 0.16661f, 0.17325f, 0.18005f, 0.18699f,
-	0.19407f, 0.20130f, 0.20867f, 0.21618f, 0.22382f, 0.23161f, 0.23952f, 0.24757f,
-	0.25574f, 0.26404f, 0.27246f, 0.28100f, 0.28965f, 0.29841f, 0.30729f, 0.31626f,
-	0.32533f, 0.33450f, 0.34376f, 0.35311f, 0.36253f, 0.37204f, 0.38161f, 0.39126f,
-	0.40096f, 0.41072f, 0.42054f, 0.43040f, 0.44030f, 0.45023f, 0.46020f, 0.47019f,
-	0.48020f, 0.49022f, 0.50025f, 0.51028f, 0.52031f, 0.53033f, 0.54033f, 0.55031f,
-	0.56026f, 0.57019f, 0.58007f, 0.58991f, 0.59970f, 0.60944f, 0.61912f, 0.62873f,
-	0.63827f, 0.64774f, 0.65713f, 0.66643f, 0.67564f, 0.68476f, 0.69377f, 0.70269f,
-	0.71150f, 0.72019f, 0.72877f, 0.73723f, 0.74557f, 0.75378f, 0.76186f, 0.76981f,
-	0.77762f, 0.78530f, 0.79283f, 0.80022f, 0.80747f, 0.81457f, 0.82151f, 0.82831f,
-	0.83496f, 0.84145f, 0.84779f, 0.85398f, 0.86001f, 0.86588f, 0.87160f, 0.87716f,
-	0.88257f, 0.88782f, 0.89291f, 0.89785f, 0.90264f, 0.90728f, 0.91176f, 0.91610f,
-	0.92028f, 0.92432f, 0.92822f, 0.93197f, 0.93558f, 0.93906f, 0.94240f, 0.94560f,
-	0.94867f, 0.95162f, 0.95444f, 0.95713f, 0.95971f, 0.96217f, 0.96451f, 0.96674f,
-	0.96887f, 0.97089f, 0.97281f, 0.97463f, 0.97635f, 0.97799f, 0.97953f, 0.98099f,
-	0.98236f, 0.98366f, 0.98488f, 0.98602f, 0.98710f, 0.98811f, 0.98905f, 0.98994f,
-	0.99076f, 0.99153f, 0.99225f, 0.99291f, 0.99353f, 0.99411f, 0.99464f, 0.99513f,
-	0.99558f, 0.99600f, 0.99639f, 0.99674f, 0.99706f, 0.99736f, 0.99763f, 0.99788f,
-	0.99811f, 0.99831f, 0.99850f, 0.99867f, 0.99882f, 0.99895f, 0.99908f, 0.99919f,
-	0.99929f, 0.99938f, 0.99946f, 0.99953f, 0.99959f, 0.99965f, 0.99969f, 0.99974f,
-	0.99978f, 0.99981f, 0.99984f, 0.99986f, 0.99988f, 0.99990f, 0.99992f, 0.99993f,
-	0.99994f, 0.99995f, 0.99996f, 0.99997f, 0.99998f, 0.99998f, 0.99998f, 0.99999f,
-	0.99999f, 0.99999f, 0.99999f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f,
-	1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f };
-
-
-static inline void swap_cmplx(complex_t *a, complex_t *b)
+	float r=re[0],i=im[0];
+
+	re[0]=r+re[1]; im[0]=i+im[1];
+	re[1]=r-re[1]; im[1]=i-im[1];
+}
+
+// X[k]=E[k]+(W^k O1[k]+W^3k O3[k]), X[k+n/2]=E[k]-(...)
+// X[k+n/4]=E[k+n/4]-i(W^k O1[k]-W^3k O3[k]), X[k+3n/4]=E[k+n/4]+i(...)
+static void fft_combine(float *re,float *im,int n,const float *w)
 {
-	complex_t tmp;
+	int q=n/4,k;
+	const float *w1r=w,*w1i=w+q,*w3r=w+2*q,*w3i=w+3*q;
 
-	tmp = *a;
-	*a = *b;
-	*b = tmp;
+	for(k=0;k<q;k++)
+	{
+		float o1r=re[2*q+k]*w1r[k]-im[2*q+k]*w1i[k];
+		float o1i=re[2*q+k]*w1i[k]+im[2*q+k]*w1r[k];
+		float o3r=re[3*q+k]*w3r[k]-im[3*q+k]*w3i[k];
+		float o3i=re[3*q+k]*w3i[k]+im[3*q+k]*w3r[k];
+		float sr=o1r+o3r,si=o1i+o3i;
+		float dr=o1r-o3r,di=o1i-o3i;
+		float er=re[k],ei=im[k];
+		float fr=re[q+k],fi=im[q+k];
+
+		re[k]=er+sr;		im[k]=ei+si;
+		re[2*q+k]=er-sr;	im[2*q+k]=ei-si;
+		re[q+k]=fr+di;		im[q+k]=fi-dr;
+		re[3*q+k]=fr-di;	im[3*q+k]=fi+dr;
+	}
 }
 
+#ifdef IMDCT_SSE
+// n>=16: four butterflies at a time, the arrays are aligned
+static void fft_combine_sse(float *re,float *im,int n,const float *w)
+{
+	int q=n/4,k;
+	const float *w1r=w,*w1i=w+q,*w3r=w+2*q,*w3i=w+3*q;
 
+	for(k=0;k<q;k+=4)
+	{
+		__m128 ar=_mm_load_ps(re+2*q+k),ai=_mm_load_ps(im+2*q+k);
+		__m128 br=_mm_load_ps(re+3*q+k),bi=_mm_load_ps(im+3*q+k);
+		__m128 c1=_mm_load_ps(w1r+k),s1=_mm_load_ps(w1i+k);
+		__m128 c3=_mm_load_ps(w3r+k),s3=_mm_load_ps(w3i+k);
+
+		__m128 o1r=_mm_sub_ps(_mm_mul_ps(ar,c1),_mm_mul_ps(ai,s1));
+		__m128 o1i=_mm_add_ps(_mm_mul_ps(ar,s1),_mm_mul_ps(ai,c1));
+		__m128 o3r=_mm_sub_ps(_mm_mul_ps(br,c3),_mm_mul_ps(bi,s3));
+		__m128 o3i=_mm_add_ps(_mm_mul_ps(br,s3),_mm_mul_ps(bi,c3));
+		__m128 sr=_mm_add_ps(o1r,o3r),si=_mm_add_ps(o1i,o3i);
+		__m128 dr=_mm_sub_ps(o1r,o3r),di=_mm_sub_ps(o1i,o3i);
+		__m128 er=_mm_load_ps(re+k),ei=_mm_load_ps(im+k);
+		__m128 fr=_mm_load_ps(re+q+k),fi=_mm_load_ps(im+q+k);
+
+		_mm_store_ps(re+k,_mm_add_ps(er,sr));		_mm_store_ps(im+k,_mm_add_ps(ei,si));
+		_mm_store_ps(re+2*q+k,_mm_sub_ps(er,sr));	_mm_store_ps(im+2*q+k,_mm_sub_ps(ei,si));
+		_mm_store_ps(re+q+k,_mm_add_ps(fr,di));		_mm_store_ps(im+q+k,_mm_sub_ps(fi,dr));
+		_mm_store_ps(re+3*q+k,_mm_sub_ps(fr,di));	_mm_store_ps(im+3*q+k,_mm_add_ps(fi,dr));
+	}
+}
+#endif
 
-static inline complex_t cmplx_mult(complex_t a, complex_t b)
+static void fft(float *re,float *im,int log2n)
 {
-	complex_t ret;
+	int n=1<<log2n;
 
-	ret.real = a.real * b.real - a.imag * b.imag;
-	ret.imag = a.real * b.imag + a.imag * b.real;
+	if(log2n==3)
+	{
+		fft4(re,im);
+		fft2(re+4,im+4);
+		fft2(re+6,im+6);
+		fft_combine(re,im,8,imdct_w8[0]);
+		return;
+	}
 
-	return ret;
+	fft(re,im,log2n-1);
+	if(log2n==4)
+	{
+		fft4(re+8,im+8);
+		fft4(re+12,im+12);
+	}
+	else
+	{
+		fft(re+n/2,im+n/2,log2n-2);
+		fft(re+3*n/4,im+3*n/4,log2n-2);
+	}
+	fft_combine(re,im,n,fft_twiddle[log2n]);
 }
 
-void imdct_init(void)
+#ifdef IMDCT_SSE
+// the bottom of the recursion: every aligned group of four is either a 4 point transform or
+// two 2 point transforms (the upper half of an 8 point one); 'mask' (imdct_leaf64/128) is set
+// for the 4 point groups
+// four groups at a time: transposed, so that each register holds one element of four groups
+static void fft_leaves_sse(float *re,float *im,int n,const uint_32 *mask)
 {
-	int i,k;
-	complex_t angle_step;
-	complex_t current_angle;
+	int i;
 
-	/* Twiddle factors to turn IFFT into IMDCT */
-	for( i=0; i < 128; i++)
+	for(i=0;i<n;i+=16,mask+=4)
 	{
-		xcos1[i] = -cosf(2.0f * (float)M_PI * ((float)(8*i+1)/(float)(8*N))) ; 
-		xsin1[i] = -sinf(2.0f * (float)M_PI * ((float)(8*i+1)/(float)(8*N))) ;
+		__m128 r0=_mm_load_ps(re+i),r1=_mm_load_ps(re+i+4),r2=_mm_load_ps(re+i+8),r3=_mm_load_ps(re+i+12);
+		__m128 i0=_mm_load_ps(im+i),i1=_mm_load_ps(im+i+4),i2=_mm_load_ps(im+i+8),i3=_mm_load_ps(im+i+12);
+		__m128 m=_mm_load_ps((const float *)mask);
+		__m128 e0r,e0i,e1r,e1i,sr,si,dr,di;
+
+		_MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+		_MM_TRANSPOSE4_PS(i0,i1,i2,i3);
+
+		e0r=_mm_add_ps(r0,r1); e0i=_mm_add_ps(i0,i1);
+		e1r=_mm_sub_ps(r0,r1); e1i=_mm_sub_ps(i0,i1);
+		sr=_mm_add_ps(r2,r3); si=_mm_add_ps(i2,i3);
+		dr=_mm_sub_ps(r2,r3); di=_mm_sub_ps(i2,i3);
+
+		// 4 point: (e0+s, e1-j*d, e0-s, e1+j*d); 2x2 point: (e0, e1, s, d)
+		r0=_mm_add_ps(e0r,_mm_and_ps(m,sr));
+		i0=_mm_add_ps(e0i,_mm_and_ps(m,si));
+		r1=_mm_add_ps(e1r,_mm_and_ps(m,di));
+		i1=_mm_sub_ps(e1i,_mm_and_ps(m,dr));
+		r2=_mm_or_ps(_mm_and_ps(m,_mm_sub_ps(e0r,sr)),_mm_andnot_ps(m,sr));
+		i2=_mm_or_ps(_mm_and_ps(m,_mm_sub_ps(e0i,si)),_mm_andnot_ps(m,si));
+		r3=_mm_or_ps(_mm_and_ps(m,_mm_sub_ps(e1r,di)),_mm_andnot_ps(m,dr));
+		i3=_mm_or_ps(_mm_and_ps(m,_mm_add_ps(e1i,dr)),_mm_andnot_ps(m,di));
+
+		_MM_TRANSPOSE4_PS(r0,r1,r2,r3);
+		_MM_TRANSPOSE4_PS(i0,i1,i2,i3);
+
+		_mm_store_ps(re+i,r0); _mm_store_ps(re+i+4,r1); _mm_store_ps(re+i+8,r2); _mm_store_ps(re+i+12,r3);
+		_mm_store_ps(im+i,i0); _mm_store_ps(im+i+4,i1); _mm_store_ps(im+i+8,i2); _mm_store_ps(im+i+12,i3);
 	}
-	
-	/* More twiddle factors to turn IFFT into IMDCT */
-	for( i=0; i < 64; i++)
+}
+
+// the rest of the recursion, after fft_leaves_sse()
+static void fft_sse(float *re,float *im,int log2n)
+{
+	int n=1<<log2n;
+
+	if(log2n<=3)
 	{
-		xcos2[i] = -cosf(2.0f * (float)M_PI * (float)(8*i+1)/(float)(4*N)) ; 
-		xsin2[i] = -sinf(2.0f * (float)M_PI * (float)(8*i+1)/(float)(4*N)) ;
+		if(log2n==3)
+			fft_combine(re,im,8,imdct_w8[0]);
+		return;
 	}
 
-	/* Canonical twiddle factors for FFT */
-	w[0] = w_1;
-	w[1] = w_2;
-	w[2] = w_4;
-	w[3] = w_8;
-	w[4] = w_16;
-	w[5] = w_32;
-	w[6] = w_64;
+	fft_sse(re,im,log2n-1);
+	fft_sse(re+n/2,im+n/2,log2n-2);
+	fft_sse(re+3*n/4,im+3*n/4,log2n-2);
+	fft_combine_sse(re,im,n,fft_twiddle[log2n]);
+}
+#endif
 
-	for( i = 0; i < 7; i++)
+// y = conj(z) * (c + j*s), then window and overlap-add for 64 output pairs
+// data[2i], data[2i+1] come from A=y[a+i] and B=y[b-i]; 'form' selects the components:
+//  0: data (-A.im, B.re), delay (-A.re, B.im)
+//  1: data (-A.re, B.im), delay ( A.im,-B.re)
+// the data and the delay sources are the same for the 512 point transform and are the two
+// 64 point transforms for 2x256
+// the delay lines are kept multiplied by 2, as are the windows (imdct_window_data/_delay)
+static void imdct_window(float *data,float *delay,const float *wd,const float *wl,int form,
+	const float *dre,const float *dim,const float *lre,const float *lim,
+	const float *c,const float *s,int a,int b)
+{
+	int i;
+
+	for(i=0;i<64;i++)
 	{
-		angle_step.real = cosf(-2.0f * (float)M_PI / (float)(1 << (i+1)));
-		angle_step.imag = sinf(-2.0f * (float)M_PI / (float)(1 << (i+1)));
+		float ar=dre[a+i]*c[a+i]+dim[a+i]*s[a+i];
+		float ai=dre[a+i]*s[a+i]-dim[a+i]*c[a+i];
+		float br=dre[b-i]*c[b-i]+dim[b-i]*s[b-i];
+		float bi=dre[b-i]*s[b-i]-dim[b-i]*c[b-i];
+		float ev=form?-ar:-ai;
+		float od=form?bi:br;
 
-		current_angle.real = 1.0f;
-		current_angle.imag = 0.0f;
+		data[2*i]=ev*wd[2*i]+delay[2*i];
+		data[2*i+1]=od*wd[2*i+1]+delay[2*i+1];
 
-		for (k = 0; k < 1 << i; k++)
+		if(lre!=dre)
 		{
-			w[i][k] = current_angle;
-			current_angle = cmplx_mult(current_angle,angle_step);
+			ar=lre[a+i]*c[a+i]+lim[a+i]*s[a+i];
+			ai=lre[a+i]*s[a+i]-lim[a+i]*c[a+i];
+			br=lre[b-i]*c[b-i]+lim[b-i]*s[b-i];
+			bi=lre[b-i]*s[b-i]-lim[b-i]*c[b-i];
 		}
+		ev=form?ai:-ar;
+		od=form?-br:bi;
+
+		delay[2*i]=ev*wl[2*i];
+		delay[2*i+1]=od*wl[2*i+1];
 	}
 }
 
-void
-imdct_do_512(float data[],float delay[])
+#ifdef IMDCT_SSE
+#define post_twiddle(zr,zi,c,s,yr,yi) \
+	yr=_mm_add_ps(_mm_mul_ps(zr,c),_mm_mul_ps(zi,s)); \
+	yi=_mm_sub_ps(_mm_mul_ps(zr,s),_mm_mul_ps(zi,c))
+
+#define reverse(x) _mm_shuffle_ps(x,x,_MM_SHUFFLE(0,1,2,3))
+
+// 'data' (ac3_state::samples) may be unaligned; everything else is aligned
+static void imdct_window_sse(float *data,float *delay,const float *wd,const float *wl,int form,
+	const float *dre,const float *dim,const float *lre,const float *lim,
+	const float *c,const float *s,int a,int b)
 {
-	int i,k;
-	int p,q;
-	int m;
-	int two_m;
-	int two_m_plus_one;
-
-	float tmp_a_i;
-	float tmp_a_r;
-	float tmp_b_i;
-	float tmp_b_r;
-
-	float *data_ptr;
-	float *delay_ptr;
-	float *window_ptr;
-	
-	//
-	// 512 IMDCT with source and dest data in 'data'
-	//
-	
-	// Pre IFFT complex multiply plus IFFT cmplx conjugate 
-	for( i=0; i < 128; i++)
+	int i;
+	const __m128 sign=_mm_set1_ps(-0.0f);
+
+	for(i=0;i<64;i+=4)
 	{
-		/* z[i] = (X[256-2*i-1] + j * X[2*i]) * (xcos1[i] + j * xsin1[i]) ; */ 
-		buf[i].real =         (data[256-2*i-1] * xcos1[i])  -  (data[2*i]       * xsin1[i]);
-	  buf[i].imag = -1.0f * ((data[2*i]       * xcos1[i])  +  (data[256-2*i-1] * xsin1[i]));
-	}
+		int pa=a+i,pb=b-i-3;
+		__m128 ca=_mm_load_ps(c+pa),sa=_mm_load_ps(s+pa);
+		__m128 cb=_mm_load_ps(c+pb),sb=_mm_load_ps(s+pb);
+		__m128 ar,ai,br,bi,ev,od,d0,d1;
 
-	//Bit reversed shuffling
-	for(i=0; i<128; i++) 
-	{ 
-		k = bit_reverse_512[i];
-		if (k < i)
-			swap_cmplx(&buf[i],&buf[k]);
-	}
+		post_twiddle(_mm_load_ps(dre+pa),_mm_load_ps(dim+pa),ca,sa,ar,ai);
+		post_twiddle(_mm_load_ps(dre+pb),_mm_load_ps(dim+pb),cb,sb,br,bi);
+		br=reverse(br);
+		bi=reverse(bi);
 
-	/* FFT Merge */
-	for (m=0; m < 7; m++)
-	{
-		if(m)
-			two_m = (1 << m);
+		if(form)
+		{
+			ev=_mm_xor_ps(ar,sign);
+			od=bi;
+		}
 		else
-			two_m = 1;
+		{
+			ev=_mm_xor_ps(ai,sign);
+			od=br;
+		}
 
-		two_m_plus_one = (1 << (m+1));
+		d0=_mm_load_ps(delay+2*i);
+		d1=_mm_load_ps(delay+2*i+4);
+		_mm_storeu_ps(data+2*i,_mm_add_ps(_mm_mul_ps(_mm_unpacklo_ps(ev,od),_mm_load_ps(wd+2*i)),d0));
+		_mm_storeu_ps(data+2*i+4,_mm_add_ps(_mm_mul_ps(_mm_unpackhi_ps(ev,od),_mm_load_ps(wd+2*i+4)),d1));
 
-		for(k = 0; k < two_m; k++)
+		if(lre!=dre)
+		{
+			post_twiddle(_mm_load_ps(lre+pa),_mm_load_ps(lim+pa),ca,sa,ar,ai);
+			post_twiddle(_mm_load_ps(lre+pb),_mm_load_ps(lim+pb),cb,sb,br,bi);
+			br=reverse(br);
+			bi=reverse(bi);
+		}
+		if(form)
+		{
+			ev=ai;
+			od=_mm_xor_ps(br,sign);
+		}
+		else
 		{
-			for(i = 0; i < 128; i += two_m_plus_one)
-			{
-				p = k + i;
-				q = p + two_m;
-				tmp_a_r = buf[p].real;
-				tmp_a_i = buf[p].imag;
-				tmp_b_r = buf[q].real * w[m][k].real - buf[q].imag * w[m][k].imag;
-				tmp_b_i = buf[q].imag * w[m][k].real + buf[q].real * w[m][k].imag;
-				buf[p].real = tmp_a_r + tmp_b_r;
-				buf[p].imag =  tmp_a_i + tmp_b_i;
-				buf[q].real = tmp_a_r - tmp_b_r;
-				buf[q].imag =  tmp_a_i - tmp_b_i;
-
-			}
+			ev=_mm_xor_ps(ar,sign);
+			od=bi;
 		}
+
+		_mm_store_ps(delay+2*i,_mm_mul_ps(_mm_unpacklo_ps(ev,od),_mm_load_ps(wl+2*i)));
+		_mm_store_ps(delay+2*i+4,_mm_mul_ps(_mm_unpackhi_ps(ev,od),_mm_load_ps(wl+2*i+4)));
 	}
+}
+
+#undef post_twiddle
+#undef reverse
+#endif
+
+// z[i] = conj((X[256-2*i-1] + j * X[2*i]) * (xcos1[i] + j * xsin1[i])), stored at the FFT input
+// position of i (imdct_order128; imdct_pcos1/psin1 are xcos1/xsin1 in that order)
+// the positions 4g..4g+3 hold p, p+64, p+32, p+96 (bit reversal)
+static void imdct_do_512(float data[],float delay[],float *re,float *im,int sse)
+{
+	int i;
 
-	/* Post IFFT complex multiply  plus IFFT complex conjugate*/
-	for( i=0; i < 128; i++)
+#ifdef IMDCT_SSE
+	if(sse)
 	{
-		/* y[n] = z[n] * (xcos1[n] + j * xsin1[n]) ; */
-		tmp_a_r =        buf[i].real;
-		tmp_a_i = -1.0f * buf[i].imag;
-		buf[i].real =(tmp_a_r * xcos1[i])  -  (tmp_a_i  * xsin1[i]);
-	  buf[i].imag =(tmp_a_r * xsin1[i])  +  (tmp_a_i  * xcos1[i]);
-	}
-	
-	data_ptr = data;
-	delay_ptr = delay;
-	window_ptr = window;
-
-	/* Window and convert to real valued signal */
-	for(i=0; i< 64; i++) 
-	{ 
-		*data_ptr++   = 2.0f * (-buf[64+i].imag   * *window_ptr++ + *delay_ptr++); 
-		*data_ptr++   = 2.0f * ( buf[64-i-1].real * *window_ptr++ + *delay_ptr++); 
-	}
+		const __m128 sign=_mm_set1_ps(-0.0f);
 
-	for(i=0; i< 64; i++) 
-	{ 
-		*data_ptr++  = 2.0f * (-buf[i].real       * *window_ptr++ + *delay_ptr++); 
-		*data_ptr++  = 2.0f * ( buf[128-i-1].imag * *window_ptr++ + *delay_ptr++); 
-	}
-	
-	/* The trailing edge of the window goes into the delay line */
-	delay_ptr = delay;
-
-	for(i=0; i< 64; i++) 
-	{ 
-		*delay_ptr++  = -buf[64+i].real   * *--window_ptr; 
-		*delay_ptr++  =  buf[64-i-1].imag * *--window_ptr; 
+		for(i=0;i<128;i+=4)
+		{
+			const float *x=data+2*imdct_order128[i];
+			const float *y=data+255-2*imdct_order128[i];
+			__m128 xi=_mm_setr_ps(x[0],x[128],x[64],x[192]);
+			__m128 xr=_mm_setr_ps(y[0],y[-128],y[-64],y[-192]);
+			__m128 c=_mm_load_ps(imdct_pcos1+i),s=_mm_load_ps(imdct_psin1+i);
+
+			_mm_store_ps(re+i,_mm_sub_ps(_mm_mul_ps(xr,c),_mm_mul_ps(xi,s)));
+			_mm_store_ps(im+i,_mm_xor_ps(_mm_add_ps(_mm_mul_ps(xi,c),_mm_mul_ps(xr,s)),sign));
+		}
+
+		fft_leaves_sse(re,im,128,imdct_leaf128);
+		fft_sse(re,im,7);
+
+		imdct_window_sse(data,delay,imdct_window_data,imdct_window_delay,0,re,im,re,im,imdct_xcos1,imdct_xsin1,64,63);
+		imdct_window_sse(data+128,delay+128,imdct_window_data+128,imdct_window_delay+128,1,re,im,re,im,imdct_xcos1,imdct_xsin1,0,127);
+		return;
 	}
+#endif
 
-	for(i=0; i<64; i++) 
+	for(i=0;i<128;i++)
 	{
-		*delay_ptr++  =  buf[i].imag       * *--window_ptr; 
-		*delay_ptr++  = -buf[128-i-1].real * *--window_ptr; 
+		int p=imdct_order128[i];
+		float xr=data[256-2*p-1],xi=data[2*p];
+
+		re[i]=xr*imdct_pcos1[i]-xi*imdct_psin1[i];
+		im[i]=-(xi*imdct_pcos1[i]+xr*imdct_psin1[i]);
 	}
+
+	fft(re,im,7);
+
+	imdct_window(data,delay,imdct_window_data,imdct_window_delay,0,re,im,re,im,imdct_xcos1,imdct_xsin1,64,63);
+	imdct_window(data+128,delay+128,imdct_window_data+128,imdct_window_delay+128,1,re,im,re,im,imdct_xcos1,imdct_xsin1,0,127);
 }
 
-void
-imdct_do_256(float data[],float delay[])
+// X1[k] = X[2*k], X2[k] = X[2*k+1]
+// Z1[k] = conj((X1[128-2*k-1] + j * X1[2*k]) * (xcos2[k] + j * xsin2[k])) in re/im[0..63],
+// Z2: the same for X2 in re/im[64..127]
+// the positions 4g..4g+3 hold k, k+32, k+16, k+48
+static void imdct_do_256(float data[],float delay[],float *re,float *im,int sse)
 {
-	int i,k;
-	int p,q;
-	int m;
-	int two_m;
-	int two_m_plus_one;
-
-	float tmp_a_i;
-	float tmp_a_r;
-	float tmp_b_i;
-	float tmp_b_r;
-
-	float *data_ptr;
-	float *delay_ptr;
-	float *window_ptr;
-
-	complex_t *buf_1, *buf_2;
-
-	buf_1 = &buf[0];
-	buf_2 = &buf[64];
-
-	/* Pre IFFT complex multiply plus IFFT cmplx conjugate */
-	for(k=0; k<64; k++) 
-	{ 
-		/* X1[k] = X[2*k]  */
-		/* X2[k] = X[2*k+1]     */
-
-		p = 2 * (128-2*k-1);
-		q = 2 * (2 * k);
-
-		/* Z1[k] = (X1[128-2*k-1] + j * X1[2*k]) * (xcos2[k] + j * xsin2[k]); */ 
-		buf_1[k].real =         data[p] * xcos2[k] - data[q] * xsin2[k];
-	  buf_1[k].imag = -1.0f * (data[q] * xcos2[k] + data[p] * xsin2[k]); 
-		/* Z2[k] = (X2[128-2*k-1] + j * X2[2*k]) * (xcos2[k] + j * xsin2[k]); */ 
-		buf_2[k].real =          data[p + 1] * xcos2[k] - data[q + 1] * xsin2[k];
-	  buf_2[k].imag = -1.0f * ( data[q + 1] * xcos2[k] + data[p + 1] * xsin2[k]); 
-	}
+	int i;
 
-	//IFFT Bit reversed shuffling
-	for(i=0; i<64; i++) 
-	{ 
-		k = bit_reverse_256[i];
-		if (k < i)
+#ifdef IMDCT_SSE
+	if(sse)
+	{
+		const __m128 sign=_mm_set1_ps(-0.0f);
+
+		for(i=0;i<64;i+=4)
 		{
-			swap_cmplx(&buf_1[i],&buf_1[k]);
-			swap_cmplx(&buf_2[i],&buf_2[k]);
-		}
-	}
+			const float *x=data+4*imdct_order64[i];
+			const float *y=data+254-4*imdct_order64[i];
+			__m128 c=_mm_load_ps(imdct_pcos2+i),s=_mm_load_ps(imdct_psin2+i);
+			__m128 xi=_mm_setr_ps(x[0],x[128],x[64],x[192]);
+			__m128 xr=_mm_setr_ps(y[0],y[-128],y[-64],y[-192]);
 
-	/* FFT Merge */
-	for (m=0; m < 6; m++)
-	{
-		two_m = (1 << m);
-		two_m_plus_one = (1 << (m+1));
+			_mm_store_ps(re+i,_mm_sub_ps(_mm_mul_ps(xr,c),_mm_mul_ps(xi,s)));
+			_mm_store_ps(im+i,_mm_xor_ps(_mm_add_ps(_mm_mul_ps(xi,c),_mm_mul_ps(xr,s)),sign));
 
-		//original FIXME
-		if(m)
-			two_m = (1 << m);
-		else
-			two_m = 1;
+			xi=_mm_setr_ps(x[1],x[129],x[65],x[193]);
+			xr=_mm_setr_ps(y[1],y[-127],y[-63],y[-191]);
 
-		for(k = 0; k < two_m; k++)
-		{
-			for(i = 0; i < 64; i += two_m_plus_one)
-			{
-				p = k + i;
-				q = p + two_m;
-				//Do block 1
-				tmp_a_r = buf_1[p].real;
-				tmp_a_i = buf_1[p].imag;
-				tmp_b_r = buf_1[q].real * w[m][k].real - buf_1[q].imag * w[m][k].imag;
-				tmp_b_i = buf_1[q].imag * w[m][k].real + buf_1[q].real * w[m][k].imag;
-				buf_1[p].real = tmp_a_r + tmp_b_r;
-				buf_1[p].imag =  tmp_a_i + tmp_b_i;
-				buf_1[q].real = tmp_a_r - tmp_b_r;
-				buf_1[q].imag =  tmp_a_i - tmp_b_i;
-
-				//Do block 2
-				tmp_a_r = buf_2[p].real;
-				tmp_a_i = buf_2[p].imag;
-				tmp_b_r = buf_2[q].real * w[m][k].real - buf_2[q].imag * w[m][k].imag;
-				tmp_b_i = buf_2[q].imag * w[m][k].real + buf_2[q].real * w[m][k].imag;
-				buf_2[p].real = tmp_a_r + tmp_b_r;
-				buf_2[p].imag =  tmp_a_i + tmp_b_i;
-				buf_2[q].real = tmp_a_r - tmp_b_r;
-				buf_2[q].imag =  tmp_a_i - tmp_b_i;
-
-			}
+			_mm_store_ps(re+64+i,_mm_sub_ps(_mm_mul_ps(xr,c),_mm_mul_ps(xi,s)));
+			_mm_store_ps(im+64+i,_mm_xor_ps(_mm_add_ps(_mm_mul_ps(xi,c),_mm_mul_ps(xr,s)),sign));
 		}
-	}
 
-	/* Post IFFT complex multiply */
-	for( i=0; i < 64; i++)
-	{
-		/* y1[n] = z1[n] * (xcos2[n] + j * xs in2[n]) ; */ 
-		tmp_a_r =  buf_1[i].real;
-		tmp_a_i = -buf_1[i].imag;
-		buf_1[i].real =(tmp_a_r * xcos2[i])  -  (tmp_a_i  * xsin2[i]);
-	  buf_1[i].imag =(tmp_a_r * xsin2[i])  +  (tmp_a_i  * xcos2[i]);
-		/* y2[n] = z2[n] * (xcos2[n] + j * xsin2[n]) ; */ 
-		tmp_a_r =  buf_2[i].real;
-		tmp_a_i = -buf_2[i].imag;
-		buf_2[i].real =(tmp_a_r * xcos2[i])  -  (tmp_a_i  * xsin2[i]);
-	  buf_2[i].imag =(tmp_a_r * xsin2[i])  +  (tmp_a_i  * xcos2[i]);
-	}
-	
-	data_ptr = data;
-	delay_ptr = delay;
-	window_ptr = window;
-
-	/* Window and convert to real valued signal */
-	for(i=0; i< 64; i++) 
-	{ 
-		*data_ptr++  = 2.0f * (-buf_1[i].imag      * *window_ptr++ + *delay_ptr++);
-		*data_ptr++  = 2.0f * ( buf_1[64-i-1].real * *window_ptr++ + *delay_ptr++);
-	}
+		fft_leaves_sse(re,im,64,imdct_leaf64);
+		fft_leaves_sse(re+64,im+64,64,imdct_leaf64);
+		fft_sse(re,im,6);
+		fft_sse(re+64,im+64,6);
 
-	for(i=0; i< 64; i++) 
-	{
-		*data_ptr++  = 2.0f * (-buf_1[i].real      * *window_ptr++ + *delay_ptr++);
-		*data_ptr++  = 2.0f * ( buf_1[64-i-1].imag * *window_ptr++ + *delay_ptr++);
+		imdct_window_sse(data,delay,imdct_window_data,imdct_window_delay,0,re,im,re+64,im+64,imdct_xcos2,imdct_xsin2,0,63);
+		imdct_window_sse(data+128,delay+128,imdct_window_data+128,imdct_window_delay+128,1,re,im,re+64,im+64,imdct_xcos2,imdct_xsin2,0,63);
+		return;
 	}
-	
-	delay_ptr = delay;
+#endif
 
-	for(i=0; i< 64; i++) 
+	for(i=0;i<64;i++)
 	{
-		*delay_ptr++ = -buf_2[i].real      * *--window_ptr;
-		*delay_ptr++ =  buf_2[64-i-1].imag * *--window_ptr;
+		int k=imdct_order64[i];
+		int p=2*(128-2*k-1);
+		int q=2*(2*k);
+
+		re[i]=data[p]*imdct_pcos2[i]-data[q]*imdct_psin2[i];
+		im[i]=-(data[q]*imdct_pcos2[i]+data[p]*imdct_psin2[i]);
+		re[64+i]=data[p+1]*imdct_pcos2[i]-data[q+1]*imdct_psin2[i];
+		im[64+i]=-(data[q+1]*imdct_pcos2[i]+data[p+1]*imdct_psin2[i]);
 	}
 
-	for(i=0; i< 64; i++) 
+	fft(re,im,6);
+	fft(re+64,im+64,6);
+
+	imdct_window(data,delay,imdct_window_data,imdct_window_delay,0,re,im,re+64,im+64,imdct_xcos2,imdct_xsin2,0,63);
+	imdct_window(data+128,delay+128,imdct_window_data+128,imdct_window_delay+128,1,re,im,re+64,im+64,imdct_xcos2,imdct_xsin2,0,63);
+}
+
+void imdct_init(ac3_state *state)
+{
+	memset(state->imdct_mem,0,sizeof(state->imdct_mem));
+
+#if IMDCT_SSE==1
+	state->imdct_sse=1;
+#elif IMDCT_SSE==2
 	{
-		*delay_ptr++ =  buf_2[i].imag      * *--window_ptr;
-		*delay_ptr++ = -buf_2[64-i-1].real * *--window_ptr;
+		int info[4];
+		__cpuid(info,1);
+		state->imdct_sse=(info[3]&(1<<25))?1:0;	// edx: SSE
 	}
+#else
+	state->imdct_sse=0;
+#endif
 }
 
-void 
-imdct(bsi_t *bsi,audblk_t *audblk, stream_samples_t samples) {
+void imdct(ac3_state *state,bsi_t *bsi,audblk_t *audblk,stream_samples_t samples)
+{
 	int i;
+	float *mem=imdct_mem(state);
 
-	for(i=0; i<bsi->nfchans;i++)
+	for(i=0;i<bsi->nfchans;i++)
 	{
 		if(audblk->blksw[i])
-			imdct_do_256(samples[i],delay[i]);
+			imdct_do_256(samples[i],IMDCT_DELAY(mem,i),IMDCT_RE(mem),IMDCT_IM(mem),state->imdct_sse);
 		else
-			imdct_do_512(samples[i],delay[i]);
+			imdct_do_512(samples[i],IMDCT_DELAY(mem,i),IMDCT_RE(mem),IMDCT_IM(mem),state->imdct_sse);
 	}
-	if (bsi->lfeon)
-		imdct_do_512(samples[5],delay[5]);
+	if(bsi->lfeon)
+		imdct_do_512(samples[5],IMDCT_DELAY(mem,5),IMDCT_RE(mem),IMDCT_IM(mem),state->imdct_sse);
 }
@@ -0,0 +1,415 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+// generated by 'kxbench ac3imdct -tables': do not edit
+// see imdct.c
+
+#ifndef KX_IMDCTTBL_H_
+#define KX_IMDCTTBL_H_
+
+static const uint_8 imdct_order128[128]=
+{
+   0,  64,  32,  96,  16,  80,  48, 112,   8,  72,  40, 104,  24,  88,  56, 120,
+   4,  68,  36, 100,  20,  84,  52, 116,  12,  76,  44, 108,  28,  92,  60, 124,
+   2,  66,  34,  98,  18,  82,  50, 114,  10,  74,  42, 106,  26,  90,  58, 122,
+   6,  70,  38, 102,  22,  86,  54, 118,  14,  78,  46, 110,  30,  94,  62, 126,
+   1,  65,  33,  97,  17,  81,  49, 113,   9,  73,  41, 105,  25,  89,  57, 121,
+   5,  69,  37, 101,  21,  85,  53, 117,  13,  77,  45, 109,  29,  93,  61, 125,
+   3,  67,  35,  99,  19,  83,  51, 115,  11,  75,  43, 107,  27,  91,  59, 123,
+   7,  71,  39, 103,  23,  87,  55, 119,  15,  79,  47, 111,  31,  95,  63, 127
+};
+
+IMDCT_ALIGN(static const uint_32 imdct_leaf128[32])=
+{
+ 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff, 0x00000000,
+ 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff,
+ 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff, 0x00000000,
+ 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff, 0x00000000
+};
+
+static const uint_8 imdct_order64[64]=
+{
+   0,  32,  16,  48,   8,  40,  24,  56,   4,  36,  20,  52,  12,  44,  28,  60,
+   2,  34,  18,  50,  10,  42,  26,  58,   6,  38,  22,  54,  14,  46,  30,  62,
+   1,  33,  17,  49,   9,  41,  25,  57,   5,  37,  21,  53,  13,  45,  29,  61,
+   3,  35,  19,  51,  11,  43,  27,  59,   7,  39,  23,  55,  15,  47,  31,  63
+};
+
+IMDCT_ALIGN(static const uint_32 imdct_leaf64[16])=
+{
+ 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff, 0x00000000,
+ 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0xffffffff, 0xffffffff
+};
+
+IMDCT_ALIGN(static const float imdct_xcos1[128])=
+{
+ -0.999998808f, -0.999904692f, -0.999660015f, -0.999264777f, -0.998719037f, -0.998022854f,
+ -0.997176409f, -0.996179819f, -0.995033205f, -0.993736744f, -0.992290616f, -0.990695000f,
+ -0.988950253f, -0.987056553f, -0.985014260f, -0.982823551f, -0.980484843f, -0.977998495f,
+ -0.975364864f, -0.972584367f, -0.969657362f, -0.966584384f, -0.963365793f, -0.960002124f,
+ -0.956493914f, -0.952841640f, -0.949045897f, -0.945107222f, -0.941026151f, -0.936803460f,
+ -0.932439625f, -0.927935421f, -0.923291445f, -0.918508410f, -0.913587034f, -0.908528090f,
+ -0.903332353f, -0.898000598f, -0.892533541f, -0.886932135f, -0.881197095f, -0.875329375f,
+ -0.869329870f, -0.863199413f, -0.856938958f, -0.850549459f, -0.844031870f, -0.837387204f,
+ -0.830616415f, -0.823720515f, -0.816700578f, -0.809557617f, -0.802292824f, -0.794907153f,
+ -0.787401736f, -0.779777765f, -0.772036374f, -0.764178753f, -0.756205976f, -0.748119354f,
+ -0.739920080f, -0.731609404f, -0.723188460f, -0.714658678f, -0.706021249f, -0.697277486f,
+ -0.688428760f, -0.679476321f, -0.670421541f, -0.661265850f, -0.652010560f, -0.642657042f,
+ -0.633206785f, -0.623661101f, -0.614021540f, -0.604289532f, -0.594466507f, -0.584553957f,
+ -0.574553370f, -0.564466238f, -0.554294109f, -0.544038534f, -0.533701003f, -0.523283124f,
+ -0.512786388f, -0.502212465f, -0.491562903f, -0.480839342f, -0.470043331f, -0.459176540f,
+ -0.448240608f, -0.437237173f, -0.426167876f, -0.415034413f, -0.403838456f, -0.392581671f,
+ -0.381265759f, -0.369892448f, -0.358463407f, -0.346980423f, -0.335445136f, -0.323859364f,
+ -0.312224805f, -0.300543249f, -0.288816422f, -0.277046084f, -0.265234023f, -0.253382027f,
+ -0.241491884f, -0.229565367f, -0.217604280f, -0.205610409f, -0.193585590f, -0.181531608f,
+ -0.169450298f, -0.157343462f, -0.145212919f, -0.133060530f, -0.120888084f, -0.108697444f,
+ -0.0964904279f, -0.0842688903f, -0.0720346496f, -0.0597895719f, -0.0475354828f, -0.0352742374f,
+ -0.0230076816f, -0.0107376594f
+};
+
+IMDCT_ALIGN(static const float imdct_xsin1[128])=
+{
+ -0.00153398013f, -0.0138053885f, -0.0260747187f, -0.0383401215f, -0.0505997501f, -0.0628517568f,
+ -0.0750942975f, -0.0873255357f, -0.0995436162f, -0.111746714f, -0.123932973f, -0.136100575f,
+ -0.148247674f, -0.160372451f, -0.172473088f, -0.184547737f, -0.196594596f, -0.208611846f,
+ -0.220597684f, -0.232550308f, -0.244467899f, -0.256348670f, -0.268190861f, -0.279992640f,
+ -0.291752249f, -0.303467959f, -0.315137923f, -0.326760441f, -0.338333756f, -0.349856138f,
+ -0.361325800f, -0.372741073f, -0.384100199f, -0.395401478f, -0.406643212f, -0.417823702f,
+ -0.428941280f, -0.439994276f, -0.450980991f, -0.461899787f, -0.472749025f, -0.483527064f,
+ -0.494232297f, -0.504863083f, -0.515417874f, -0.525895000f, -0.536292970f, -0.546610177f,
+ -0.556845009f, -0.566996038f, -0.577061653f, -0.587040365f, -0.596930683f, -0.606731117f,
+ -0.616440177f, -0.626056373f, -0.635578334f, -0.645004511f, -0.654333591f, -0.663564146f,
+ -0.672694743f, -0.681724072f, -0.690650702f, -0.699473321f, -0.708190620f, -0.716801286f,
+ -0.725303948f, -0.733697414f, -0.741980433f, -0.750151634f, -0.758209884f, -0.766153991f,
+ -0.773982704f, -0.781694829f, -0.789289236f, -0.796764791f, -0.804120362f, -0.811354876f,
+ -0.818467140f, -0.825456142f, -0.832320869f, -0.839060247f, -0.845673263f, -0.852158904f,
+ -0.858516216f, -0.864744246f, -0.870842040f, -0.876808703f, -0.882643342f, -0.888345063f,
+ -0.893912971f, -0.899346232f, -0.904644072f, -0.909805715f, -0.914830327f, -0.919717133f,
+ -0.924465477f, -0.929074585f, -0.933543801f, -0.937872350f, -0.942059755f, -0.946105242f,
+ -0.950008273f, -0.953768194f, -0.957384527f, -0.960856616f, -0.964184046f, -0.967366278f,
+ -0.970402837f, -0.973293245f, -0.976037085f, -0.978633940f, -0.981083393f, -0.983385086f,
+ -0.985538721f, -0.987543941f, -0.989400446f, -0.991107941f, -0.992666125f, -0.994074881f,
+ -0.995333910f, -0.996443033f, -0.997402132f, -0.998211026f, -0.998869538f, -0.999377668f,
+ -0.999735296f, -0.999942362f
+};
+
+IMDCT_ALIGN(static const float imdct_xcos2[64])=
+{
+ -0.999995291f, -0.999618828f, -0.998640239f, -0.997060061f, -0.994879305f, -0.992099285f,
+ -0.988721669f, -0.984748483f, -0.980182111f, -0.975025356f, -0.969281256f, -0.962953269f,
+ -0.956045270f, -0.948561370f, -0.940506041f, -0.931884289f, -0.922701120f, -0.912962198f,
+ -0.902673304f, -0.891840696f, -0.880470872f, -0.868570685f, -0.856147349f, -0.843208253f,
+ -0.829761207f, -0.815814435f, -0.801376164f, -0.786455214f, -0.771060526f, -0.755201399f,
+ -0.738887310f, -0.722128212f, -0.704934061f, -0.687315345f, -0.669282615f, -0.650846660f,
+ -0.632018745f, -0.612810075f, -0.593232274f, -0.573297143f, -0.553016722f, -0.532403111f,
+ -0.511468828f, -0.490226477f, -0.468688816f, -0.446868837f, -0.424779683f, -0.402434647f,
+ -0.379847199f, -0.357030958f, -0.333999664f, -0.310767144f, -0.287347466f, -0.263754666f,
+ -0.240003020f, -0.216106802f, -0.192080393f, -0.167938292f, -0.143695027f, -0.119365215f,
+ -0.0949634984f, -0.0705045760f, -0.0460031815f, -0.0214740802f
+};
+
+IMDCT_ALIGN(static const float imdct_xsin2[64])=
+{
+ -0.00306795677f, -0.0276081450f, -0.0521317050f, -0.0766238645f, -0.101069860f, -0.125454977f,
+ -0.149764538f, -0.173983872f, -0.198098406f, -0.222093627f, -0.245955050f, -0.269668311f,
+ -0.293219149f, -0.316593379f, -0.339776874f, -0.362755716f, -0.385516047f, -0.408044159f,
+ -0.430326492f, -0.452349573f, -0.474100202f, -0.495565265f, -0.516731799f, -0.537587047f,
+ -0.558118522f, -0.578313768f, -0.598160684f, -0.617647290f, -0.636761844f, -0.655492842f,
+ -0.673829019f, -0.691759229f, -0.709272802f, -0.726359129f, -0.743007958f, -0.759209216f,
+ -0.774953127f, -0.790230215f, -0.805031359f, -0.819347501f, -0.833170176f, -0.846490920f,
+ -0.859301805f, -0.871595085f, -0.883363366f, -0.894599497f, -0.905296743f, -0.915448725f,
+ -0.925049245f, -0.934092522f, -0.942573190f, -0.950486064f, -0.957826436f, -0.964589775f,
+ -0.970772147f, -0.976369739f, -0.981379211f, -0.985797524f, -0.989621997f, -0.992850423f,
+ -0.995480776f, -0.997511446f, -0.998941302f, -0.999769390f
+};
+
+IMDCT_ALIGN(static const float imdct_pcos1[128])=
+{
+ -0.999998808f, -0.706021249f, -0.923291445f, -0.381265759f, -0.980484843f, -0.554294109f,
+ -0.830616415f, -0.193585590f, -0.995033205f, -0.633206785f, -0.881197095f, -0.288816422f,
+ -0.956493914f, -0.470043331f, -0.772036374f, -0.0964904279f, -0.998719037f, -0.670421541f,
+ -0.903332353f, -0.335445136f, -0.969657362f, -0.512786388f, -0.802292824f, -0.145212919f,
+ -0.988950253f, -0.594466507f, -0.856938958f, -0.241491884f, -0.941026151f, -0.426167876f,
+ -0.739920080f, -0.0475354828f, -0.999660015f, -0.688428760f, -0.913587034f, -0.358463407f,
+ -0.975364864f, -0.533701003f, -0.816700578f, -0.169450298f, -0.992290616f, -0.614021540f,
+ -0.869329870f, -0.265234023f, -0.949045897f, -0.448240608f, -0.756205976f, -0.0720346496f,
+ -0.997176409f, -0.652010560f, -0.892533541f, -0.312224805f, -0.963365793f, -0.491562903f,
+ -0.787401736f, -0.120888084f, -0.985014260f, -0.574553370f, -0.844031870f, -0.217604280f,
+ -0.932439625f, -0.403838456f, -0.723188460f, -0.0230076816f, -0.999904692f, -0.697277486f,
+ -0.918508410f, -0.369892448f, -0.977998495f, -0.544038534f, -0.823720515f, -0.181531608f,
+ -0.993736744f, -0.623661101f, -0.875329375f, -0.277046084f, -0.952841640f, -0.459176540f,
+ -0.764178753f, -0.0842688903f, -0.998022854f, -0.661265850f, -0.898000598f, -0.323859364f,
+ -0.966584384f, -0.502212465f, -0.794907153f, -0.133060530f, -0.987056553f, -0.584553957f,
+ -0.850549459f, -0.229565367f, -0.936803460f, -0.415034413f, -0.731609404f, -0.0352742374f,
+ -0.999264777f, -0.679476321f, -0.908528090f, -0.346980423f, -0.972584367f, -0.523283124f,
+ -0.809557617f, -0.157343462f, -0.990695000f, -0.604289532f, -0.863199413f, -0.253382027f,
+ -0.945107222f, -0.437237173f, -0.748119354f, -0.0597895719f, -0.996179819f, -0.642657042f,
+ -0.886932135f, -0.300543249f, -0.960002124f, -0.480839342f, -0.779777765f, -0.108697444f,
+ -0.982823551f, -0.564466238f, -0.837387204f, -0.205610409f, -0.927935421f, -0.392581671f,
+ -0.714658678f, -0.0107376594f
+};
+
+IMDCT_ALIGN(static const float imdct_psin1[128])=
+{
+ -0.00153398013f, -0.708190620f, -0.384100199f, -0.924465477f, -0.196594596f, -0.832320869f,
+ -0.556845009f, -0.981083393f, -0.0995436162f, -0.773982704f, -0.472749025f, -0.957384527f,
+ -0.291752249f, -0.882643342f, -0.635578334f, -0.995333910f, -0.0505997501f, -0.741980433f,
+ -0.428941280f, -0.942059755f, -0.244467899f, -0.858516216f, -0.596930683f, -0.989400446f,
+ -0.148247674f, -0.804120362f, -0.515417874f, -0.970402837f, -0.338333756f, -0.904644072f,
+ -0.672694743f, -0.998869538f, -0.0260747187f, -0.725303948f, -0.406643212f, -0.933543801f,
+ -0.220597684f, -0.845673263f, -0.577061653f, -0.985538721f, -0.123932973f, -0.789289236f,
+ -0.494232297f, -0.964184046f, -0.315137923f, -0.893912971f, -0.654333591f, -0.997402132f,
+ -0.0750942975f, -0.758209884f, -0.450980991f, -0.950008273f, -0.268190861f, -0.870842040f,
+ -0.616440177f, -0.992666125f, -0.172473088f, -0.818467140f, -0.536292970f, -0.976037085f,
+ -0.361325800f, -0.914830327f, -0.690650702f, -0.999735296f, -0.0138053885f, -0.716801286f,
+ -0.395401478f, -0.929074585f, -0.208611846f, -0.839060247f, -0.566996038f, -0.983385086f,
+ -0.111746714f, -0.781694829f, -0.483527064f, -0.960856616f, -0.303467959f, -0.888345063f,
+ -0.645004511f, -0.996443033f, -0.0628517568f, -0.750151634f, -0.439994276f, -0.946105242f,
+ -0.256348670f, -0.864744246f, -0.606731117f, -0.991107941f, -0.160372451f, -0.811354876f,
+ -0.525895000f, -0.973293245f, -0.349856138f, -0.909805715f, -0.681724072f, -0.999377668f,
+ -0.0383401215f, -0.733697414f, -0.417823702f, -0.937872350f, -0.232550308f, -0.852158904f,
+ -0.587040365f, -0.987543941f, -0.136100575f, -0.796764791f, -0.504863083f, -0.967366278f,
+ -0.326760441f, -0.899346232f, -0.663564146f, -0.998211026f, -0.0873255357f, -0.766153991f,
+ -0.461899787f, -0.953768194f, -0.279992640f, -0.876808703f, -0.626056373f, -0.994074881f,
+ -0.184547737f, -0.825456142f, -0.546610177f, -0.978633940f, -0.372741073f, -0.919717133f,
+ -0.699473321f, -0.999942362f
+};
+
+IMDCT_ALIGN(static const float imdct_pcos2[64])=
+{
+ -0.999995291f, -0.704934061f, -0.922701120f, -0.379847199f, -0.980182111f, -0.553016722f,
+ -0.829761207f, -0.192080393f, -0.994879305f, -0.632018745f, -0.880470872f, -0.287347466f,
+ -0.956045270f, -0.468688816f, -0.771060526f, -0.0949634984f, -0.998640239f, -0.669282615f,
+ -0.902673304f, -0.333999664f, -0.969281256f, -0.511468828f, -0.801376164f, -0.143695027f,
+ -0.988721669f, -0.593232274f, -0.856147349f, -0.240003020f, -0.940506041f, -0.424779683f,
+ -0.738887310f, -0.0460031815f, -0.999618828f, -0.687315345f, -0.912962198f, -0.357030958f,
+ -0.975025356f, -0.532403111f, -0.815814435f, -0.167938292f, -0.992099285f, -0.612810075f,
+ -0.868570685f, -0.263754666f, -0.948561370f, -0.446868837f, -0.755201399f, -0.0705045760f,
+ -0.997060061f, -0.650846660f, -0.891840696f, -0.310767144f, -0.962953269f, -0.490226477f,
+ -0.786455214f, -0.119365215f, -0.984748483f, -0.573297143f, -0.843208253f, -0.216106802f,
+ -0.931884289f, -0.402434647f, -0.722128212f, -0.0214740802f
+};
+
+IMDCT_ALIGN(static const float imdct_psin2[64])=
+{
+ -0.00306795677f, -0.709272802f, -0.385516047f, -0.925049245f, -0.198098406f, -0.833170176f,
+ -0.558118522f, -0.981379211f, -0.101069860f, -0.774953127f, -0.474100202f, -0.957826436f,
+ -0.293219149f, -0.883363366f, -0.636761844f, -0.995480776f, -0.0521317050f, -0.743007958f,
+ -0.430326492f, -0.942573190f, -0.245955050f, -0.859301805f, -0.598160684f, -0.989621997f,
+ -0.149764538f, -0.805031359f, -0.516731799f, -0.970772147f, -0.339776874f, -0.905296743f,
+ -0.673829019f, -0.998941302f, -0.0276081450f, -0.726359129f, -0.408044159f, -0.934092522f,
+ -0.222093627f, -0.846490920f, -0.578313768f, -0.985797524f, -0.125454977f, -0.790230215f,
+ -0.495565265f, -0.964589775f, -0.316593379f, -0.894599497f, -0.655492842f, -0.997511446f,
+ -0.0766238645f, -0.759209216f, -0.452349573f, -0.950486064f, -0.269668311f, -0.871595085f,
+ -0.617647290f, -0.992850423f, -0.173983872f, -0.819347501f, -0.537587047f, -0.976369739f,
+ -0.362755716f, -0.915448725f, -0.691759229f, -0.999769390f
+};
+
+IMDCT_ALIGN(static const float imdct_w8[4][2])=
+{
+ {
+  1.00000000f, 0.707106769f
+ },
+ {
+  -0.00000000f, -0.707106769f
+ },
+ {
+  1.00000000f, -0.707106769f
+ },
+ {
+  -0.00000000f, -0.707106769f
+ }
+};
+
+IMDCT_ALIGN(static const float imdct_w16[4][4])=
+{
+ {
+  1.00000000f, 0.923879504f, 0.707106769f, 0.382683426f
+ },
+ {
+  -0.00000000f, -0.382683426f, -0.707106769f, -0.923879504f
+ },
+ {
+  1.00000000f, 0.382683426f, -0.707106769f, -0.923879504f
+ },
+ {
+  -0.00000000f, -0.923879504f, -0.707106769f, 0.382683426f
+ }
+};
+
+IMDCT_ALIGN(static const float imdct_w32[4][8])=
+{
+ {
+  1.00000000f, 0.980785251f, 0.923879504f, 0.831469595f, 0.707106769f, 0.555570245f,
+  0.382683426f, 0.195090324f
+ },
+ {
+  -0.00000000f, -0.195090324f, -0.382683426f, -0.555570245f, -0.707106769f, -0.831469595f,
+  -0.923879504f, -0.980785251f
+ },
+ {
+  1.00000000f, 0.831469595f, 0.382683426f, -0.195090324f, -0.707106769f, -0.980785251f,
+  -0.923879504f, -0.555570245f
+ },
+ {
+  -0.00000000f, -0.555570245f, -0.923879504f, -0.980785251f, -0.707106769f, -0.195090324f,
+  0.382683426f, 0.831469595f
+ }
+};
+
+IMDCT_ALIGN(static const float imdct_w64[4][16])=
+{
+ {
+  1.00000000f, 0.995184720f, 0.980785251f, 0.956940353f, 0.923879504f, 0.881921291f,
+  0.831469595f, 0.773010433f, 0.707106769f, 0.634393275f, 0.555570245f, 0.471396744f,
+  0.382683426f, 0.290284663f, 0.195090324f, 0.0980171412f
+ },
+ {
+  -0.00000000f, -0.0980171412f, -0.195090324f, -0.290284663f, -0.382683426f, -0.471396744f,
+  -0.555570245f, -0.634393275f, -0.707106769f, -0.773010433f, -0.831469595f, -0.881921291f,
+  -0.923879504f, -0.956940353f, -0.980785251f, -0.995184720f
+ },
+ {
+  1.00000000f, 0.956940353f, 0.831469595f, 0.634393275f, 0.382683426f, 0.0980171412f,
+  -0.195090324f, -0.471396744f, -0.707106769f, -0.881921291f, -0.980785251f, -0.995184720f,
+  -0.923879504f, -0.773010433f, -0.555570245f, -0.290284663f
+ },
+ {
+  -0.00000000f, -0.290284663f, -0.555570245f, -0.773010433f, -0.923879504f, -0.995184720f,
+  -0.980785251f, -0.881921291f, -0.707106769f, -0.471396744f, -0.195090324f, 0.0980171412f,
+  0.382683426f, 0.634393275f, 0.831469595f, 0.956940353f
+ }
+};
+
+IMDCT_ALIGN(static const float imdct_w128[4][32])=
+{
+ {
+  1.00000000f, 0.998795450f, 0.995184720f, 0.989176512f, 0.980785251f, 0.970031261f,
+  0.956940353f, 0.941544056f, 0.923879504f, 0.903989315f, 0.881921291f, 0.857728601f,
+  0.831469595f, 0.803207517f, 0.773010433f, 0.740951121f, 0.707106769f, 0.671558976f,
+  0.634393275f, 0.595699310f, 0.555570245f, 0.514102757f, 0.471396744f, 0.427555084f,
+  0.382683426f, 0.336889863f, 0.290284663f, 0.242980182f, 0.195090324f, 0.146730468f,
+  0.0980171412f, 0.0490676761f
+ },
+ {
+  -0.00000000f, -0.0490676761f, -0.0980171412f, -0.146730468f, -0.195090324f, -0.242980182f,
+  -0.290284663f, -0.336889863f, -0.382683426f, -0.427555084f, -0.471396744f, -0.514102757f,
+  -0.555570245f, -0.595699310f, -0.634393275f, -0.671558976f, -0.707106769f, -0.740951121f,
+  -0.773010433f, -0.803207517f, -0.831469595f, -0.857728601f, -0.881921291f, -0.903989315f,
+  -0.923879504f, -0.941544056f, -0.956940353f, -0.970031261f, -0.980785251f, -0.989176512f,
+  -0.995184720f, -0.998795450f
+ },
+ {
+  1.00000000f, 0.989176512f, 0.956940353f, 0.903989315f, 0.831469595f, 0.740951121f,
+  0.634393275f, 0.514102757f, 0.382683426f, 0.242980182f, 0.0980171412f, -0.0490676761f,
+  -0.195090324f, -0.336889863f, -0.471396744f, -0.595699310f, -0.707106769f, -0.803207517f,
+  -0.881921291f, -0.941544056f, -0.980785251f, -0.998795450f, -0.995184720f, -0.970031261f,
+  -0.923879504f, -0.857728601f, -0.773010433f, -0.671558976f, -0.555570245f, -0.427555084f,
+  -0.290284663f, -0.146730468f
+ },
+ {
+  -0.00000000f, -0.146730468f, -0.290284663f, -0.427555084f, -0.555570245f, -0.671558976f,
+  -0.773010433f, -0.857728601f, -0.923879504f, -0.970031261f, -0.995184720f, -0.998795450f,
+  -0.980785251f, -0.941544056f, -0.881921291f, -0.803207517f, -0.707106769f, -0.595699310f,
+  -0.471396744f, -0.336889863f, -0.195090324f, -0.0490676761f, 0.0980171412f, 0.242980182f,
+  0.382683426f, 0.514102757f, 0.634393275f, 0.740951121f, 0.831469595f, 0.903989315f,
+  0.956940353f, 0.989176512f
+ }
+};
+
+IMDCT_ALIGN(static const float imdct_window_data[256])=
+{
+ 0.000280000007f, 0.000479999988f, 0.000739999989f, 0.00101999997f, 0.00133999996f, 0.00171999994f,
+ 0.00214000000f, 0.00260000001f, 0.00313999993f, 0.00374000007f, 0.00439999998f, 0.00511999987f,
+ 0.00594000006f, 0.00681999978f, 0.00779999979f, 0.00886000041f, 0.0100199999f, 0.0112800002f,
+ 0.0126400003f, 0.0141200004f, 0.0156999994f, 0.0174199995f, 0.0192399994f, 0.0212200005f,
+ 0.0233200006f, 0.0255800001f, 0.0279799998f, 0.0305199996f, 0.0332400016f, 0.0361200012f,
+ 0.0391799994f, 0.0424199998f, 0.0458399989f, 0.0494400002f, 0.0532400012f, 0.0572599992f,
+ 0.0614599995f, 0.0658800006f, 0.0705400035f, 0.0754000023f, 0.0804999992f, 0.0858400017f,
+ 0.0914200023f, 0.0972400010f, 0.103299998f, 0.109619997f, 0.116200000f, 0.123060003f,
+ 0.130160004f, 0.137559995f, 0.145219997f, 0.153160006f, 0.161379993f, 0.169900000f,
+ 0.178700000f, 0.187779993f, 0.197180003f, 0.206860006f, 0.216839999f, 0.227119997f,
+ 0.237700000f, 0.248579994f, 0.259759992f, 0.271259993f, 0.283039987f, 0.295139998f,
+ 0.307520002f, 0.320219994f, 0.333220005f, 0.346500009f, 0.360100001f, 0.373979986f,
+ 0.388139993f, 0.402599990f, 0.417340010f, 0.432359993f, 0.447640002f, 0.463220000f,
+ 0.479039997f, 0.495139986f, 0.511479974f, 0.528079987f, 0.544920027f, 0.561999977f,
+ 0.579299986f, 0.596819997f, 0.614579976f, 0.632520020f, 0.650659978f, 0.669000030f,
+ 0.687520027f, 0.706219971f, 0.725059986f, 0.744080007f, 0.763220012f, 0.782519996f,
+ 0.801919997f, 0.821439981f, 0.841080010f, 0.860800028f, 0.880599976f, 0.900460005f,
+ 0.920400023f, 0.940379977f, 0.960399985f, 0.980440021f, 1.00049996f, 1.02056003f,
+ 1.04061997f, 1.06066000f, 1.08065999f, 1.10062003f, 1.12052000f, 1.14038002f,
+ 1.16014004f, 1.17981994f, 1.19939995f, 1.21888006f, 1.23824000f, 1.25746000f,
+ 1.27654004f, 1.29548001f, 1.31426001f, 1.33285999f, 1.35127997f, 1.36951995f,
+ 1.38753998f, 1.40538001f, 1.42299998f, 1.44037998f, 1.45754004f, 1.47446001f,
+ 1.49114001f, 1.50756001f, 1.52372003f, 1.53962004f, 1.55524004f, 1.57060003f,
+ 1.58565998f, 1.60044003f, 1.61494005f, 1.62914002f, 1.64302003f, 1.65662003f,
+ 1.66991997f, 1.68289995f, 1.69558001f, 1.70796001f, 1.72002006f, 1.73176003f,
+ 1.74319994f, 1.75432003f, 1.76514006f, 1.77564001f, 1.78582001f, 1.79569995f,
+ 1.80527997f, 1.81456006f, 1.82351995f, 1.83220005f, 1.84055996f, 1.84863997f,
+ 1.85643995f, 1.86394000f, 1.87116003f, 1.87811995f, 1.88479996f, 1.89119995f,
+ 1.89734006f, 1.90323997f, 1.90888000f, 1.91426003f, 1.91942000f, 1.92434001f,
+ 1.92902005f, 1.93348002f, 1.93773997f, 1.94177997f, 1.94561994f, 1.94926000f,
+ 1.95270002f, 1.95597994f, 1.95905995f, 1.96197999f, 1.96472001f, 1.96731997f,
+ 1.96975994f, 1.97204006f, 1.97420001f, 1.97622001f, 1.97809994f, 1.97987998f,
+ 1.98152006f, 1.98306000f, 1.98450005f, 1.98582006f, 1.98705995f, 1.98821998f,
+ 1.98927999f, 1.99026000f, 1.99116004f, 1.99199998f, 1.99277997f, 1.99347997f,
+ 1.99412000f, 1.99471998f, 1.99526000f, 1.99575996f, 1.99621999f, 1.99662006f,
+ 1.99699998f, 1.99733996f, 1.99764001f, 1.99790001f, 1.99816000f, 1.99837995f,
+ 1.99857998f, 1.99875998f, 1.99891996f, 1.99906003f, 1.99917996f, 1.99930000f,
+ 1.99937999f, 1.99948001f, 1.99956000f, 1.99961996f, 1.99968004f, 1.99971998f,
+ 1.99976003f, 1.99979997f, 1.99984002f, 1.99986005f, 1.99987996f, 1.99989998f,
+ 1.99992001f, 1.99994004f, 1.99995995f, 1.99995995f, 1.99995995f, 1.99997997f,
+ 1.99997997f, 1.99997997f, 1.99997997f, 2.00000000f, 2.00000000f, 2.00000000f,
+ 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f,
+ 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f
+};
+
+IMDCT_ALIGN(static const float imdct_window_delay[256])=
+{
+ 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f,
+ 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f, 2.00000000f,
+ 2.00000000f, 1.99997997f, 1.99997997f, 1.99997997f, 1.99997997f, 1.99995995f,
+ 1.99995995f, 1.99995995f, 1.99994004f, 1.99992001f, 1.99989998f, 1.99987996f,
+ 1.99986005f, 1.99984002f, 1.99979997f, 1.99976003f, 1.99971998f, 1.99968004f,
+ 1.99961996f, 1.99956000f, 1.99948001f, 1.99937999f, 1.99930000f, 1.99917996f,
+ 1.99906003f, 1.99891996f, 1.99875998f, 1.99857998f, 1.99837995f, 1.99816000f,
+ 1.99790001f, 1.99764001f, 1.99733996f, 1.99699998f, 1.99662006f, 1.99621999f,
+ 1.99575996f, 1.99526000f, 1.99471998f, 1.99412000f, 1.99347997f, 1.99277997f,
+ 1.99199998f, 1.99116004f, 1.99026000f, 1.98927999f, 1.98821998f, 1.98705995f,
+ 1.98582006f, 1.98450005f, 1.98306000f, 1.98152006f, 1.97987998f, 1.97809994f,
+ 1.97622001f, 1.97420001f, 1.97204006f, 1.96975994f, 1.96731997f, 1.96472001f,
+ 1.96197999f, 1.95905995f, 1.95597994f, 1.95270002f, 1.94926000f, 1.94561994f,
+ 1.94177997f, 1.93773997f, 1.93348002f, 1.92902005f, 1.92434001f, 1.91942000f,
+ 1.91426003f, 1.90888000f, 1.90323997f, 1.89734006f, 1.89119995f, 1.88479996f,
+ 1.87811995f, 1.87116003f, 1.86394000f, 1.85643995f, 1.84863997f, 1.84055996f,
+ 1.83220005f, 1.82351995f, 1.81456006f, 1.80527997f, 1.79569995f, 1.78582001f,
+ 1.77564001f, 1.76514006f, 1.75432003f, 1.74319994f, 1.73176003f, 1.72002006f,
+ 1.70796001f, 1.69558001f, 1.68289995f, 1.66991997f, 1.65662003f, 1.64302003f,
+ 1.62914002f, 1.61494005f, 1.60044003f, 1.58565998f, 1.57060003f, 1.55524004f,
+ 1.53962004f, 1.52372003f, 1.50756001f, 1.49114001f, 1.47446001f, 1.45754004f,
+ 1.44037998f, 1.42299998f, 1.40538001f, 1.38753998f, 1.36951995f, 1.35127997f,
+ 1.33285999f, 1.31426001f, 1.29548001f, 1.27654004f, 1.25746000f, 1.23824000f,
+ 1.21888006f, 1.19939995f, 1.17981994f, 1.16014004f, 1.14038002f, 1.12052000f,
+ 1.10062003f, 1.08065999f, 1.06066000f, 1.04061997f, 1.02056003f, 1.00049996f,
+ 0.980440021f, 0.960399985f, 0.940379977f, 0.920400023f, 0.900460005f, 0.880599976f,
+ 0.860800028f, 0.841080010f, 0.821439981f, 0.801919997f, 0.782519996f, 0.763220012f,
+ 0.744080007f, 0.725059986f, 0.706219971f, 0.687520027f, 0.669000030f, 0.650659978f,
+ 0.632520020f, 0.614579976f, 0.596819997f, 0.579299986f, 0.561999977f, 0.544920027f,
+ 0.528079987f, 0.511479974f, 0.495139986f, 0.479039997f, 0.463220000f, 0.447640002f,
+ 0.432359993f, 0.417340010f, 0.402599990f, 0.388139993f, 0.373979986f, 0.360100001f,
+ 0.346500009f, 0.333220005f, 0.320219994f, 0.307520002f, 0.295139998f, 0.283039987f,
+ 0.271259993f, 0.259759992f, 0.248579994f, 0.237700000f, 0.227119997f, 0.216839999f,
+ 0.206860006f, 0.197180003f, 0.187779993f, 0.178700000f, 0.169900000f, 0.161379993f,
+ 0.153160006f, 0.145219997f, 0.137559995f, 0.130160004f, 0.123060003f, 0.116200000f,
+ 0.109619997f, 0.103299998f, 0.0972400010f, 0.0914200023f, 0.0858400017f, 0.0804999992f,
+ 0.0754000023f, 0.0705400035f, 0.0658800006f, 0.0614599995f, 0.0572599992f, 0.0532400012f,
+ 0.0494400002f, 0.0458399989f, 0.0424199998f, 0.0391799994f, 0.0361200012f, 0.0332400016f,
+ 0.0305199996f, 0.0279799998f, 0.0255800001f, 0.0233200006f, 0.0212200005f, 0.0192399994f,
+ 0.0174199995f, 0.0156999994f, 0.0141200004f, 0.0126400003f, 0.0112800002f, 0.0100199999f,
+ 0.00886000041f, 0.00779999979f, 0.00681999978f, 0.00594000006f, 0.00511999987f, 0.00439999998f,
+ 0.00374000007f, 0.00313999993f, 0.00260000001f, 0.00214000000f, 0.00171999994f, 0.00133999996f,
+ 0.00101999997f, 0.000739999989f, 0.000479999988f, 0.000280000007f
+};
+
+#endif
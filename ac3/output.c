@@ -0,0 +1,630 @@
+// KX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// output stage: the decoded channels of a block -> the stream's channel layout and sample format
+// the channel mapping (acmod), the downmix, the gain and the format scale are a single matrix,
+// built once per frame by output_setup(); output_block() then works on the block while it is
+// still in the cache after the IMDCT: matrix, TPDF dither, saturation and packing
+// (planar and stereo: one pass; other interleaved layouts: the rows, then the frames)
+// SSE2 is used when available (the caller saves the FPU state: see dpc_ac3_func())
+// the scalar and the SSE2 paths give the same samples (without dither); compared to the
+// per-sample conversion and the 3/2 -> 2 downmix this stage replaced, the output is not bit-exact:
+// samples are rounded to nearest and saturated (were: truncated, and wrapped on overload), and
+// the mix levels are the A/52 ones (were: rounded to 4 digits): 1 LSB on the 5.1 path,
+// up to 7 LSB on Lo/Ro
+
+#include "stdafx.h"
+
+// OUTPUT_SSE2 1: always available, 2: checked by ac3_set_output()
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+ #define OUTPUT_SSE2	1
+#elif defined(_M_IX86)
+ #define OUTPUT_SSE2	2
+ #include <intrin.h>
+#endif
+
+#ifdef OUTPUT_SSE2
+ #include <emmintrin.h>
+#endif
+
+// canonical channels: the planar order (left, center, right, sleft, sright, subwoofer)
+#define CH_L	0
+#define CH_C	1
+#define CH_R	2
+#define CH_SL	3
+#define CH_SR	4
+#define CH_LFE	5
+#define CH_S	6	// mono surround: SL and SR at -3 dB
+
+// samples[] index -> canonical channel, by acmod (1+1: the two programs go to L and R)
+static const sint_8 acmod_map[8][5] =
+{
+	{ CH_L, CH_R, -1, -1, -1 },
+	{ CH_C, -1, -1, -1, -1 },
+	{ CH_L, CH_R, -1, -1, -1 },
+	{ CH_L, CH_C, CH_R, -1, -1 },
+	{ CH_L, CH_R, CH_S, -1, -1 },
+	{ CH_L, CH_C, CH_R, CH_S, -1 },
+	{ CH_L, CH_R, CH_SL, CH_SR, -1 },
+	{ CH_L, CH_C, CH_R, CH_SL, CH_SR }
+};
+
+// interleaved channel order by mode (WAVE_FORMAT_EXTENSIBLE order)
+static const sint_8 mode_order[5][6] =
+{
+	{ CH_L, CH_R, CH_C, CH_LFE, CH_SL, CH_SR },	// AC3_OUTPUT_51
+	{ CH_L, CH_R, CH_SL, CH_SR, -1, -1 },		// AC3_OUTPUT_QUAD
+	{ CH_L, CH_R, -1, -1, -1, -1 },				// AC3_OUTPUT_STEREO
+	{ CH_L, CH_R, -1, -1, -1, -1 },				// AC3_OUTPUT_DOLBY
+	{ CH_C, -1, -1, -1, -1, -1 }				// AC3_OUTPUT_MONO
+};
+
+static const sint_8 mode_channels[5] = { 6, 4, 2, 2, 1 };
+
+// mix levels (A/52 5.4.2.4, 5.4.2.5)
+static const float cmixlev_lut[4] = { 0.7071f, 0.5946f, 0.5f, 0.5946f };
+static const float smixlev_lut[4] = { 0.7071f, 0.5f, 0.0f, 0.5f };
+
+int __stdcall ac3_output_channels(int mode)
+{
+	return (mode>=0 && mode<5)?mode_channels[mode]:0;
+}
+
+void __stdcall ac3_set_output(ac3_state *state,int mode,int format,float gain,int dither,void *output)
+{
+	if(mode<0 || mode>AC3_OUTPUT_MONO)
+		mode=AC3_OUTPUT_51;
+	if(format<0 || format>AC3_FORMAT_F32 || output==NULL)
+		format=AC3_FORMAT_S16;
+
+	state->out_mode=mode;
+	state->out_format=format;
+	state->out_gain=gain;
+	state->out_dither=dither && format!=AC3_FORMAT_F32;
+	state->output=output;
+	state->out_channels=output?mode_channels[mode]:6;
+
+	state->out_seed[0]=0x2545f491;
+	state->out_seed[1]=0x9e3779b9;
+	state->out_seed[2]=0x6a09e667;
+	state->out_seed[3]=0xbb67ae85;
+	state->out_seed[4]=0x3c6ef372;
+	state->out_seed[5]=0xa54ff53a;
+	state->out_seed[6]=0x510e527f;
+	state->out_seed[7]=0x9b05688c;
+
+#if OUTPUT_SSE2==1
+	state->out_sse2=1;
+#elif OUTPUT_SSE2==2
+	{
+		int info[4];
+		__cpuid(info,1);
+		state->out_sse2=(info[3]&(1<<26))?1:0;	// edx: SSE2
+	}
+#else
+	state->out_sse2=0;
+#endif
+}
+
+// per frame: acmod and the mix levels are in the bsi
+void output_setup(ac3_state *state)
+{
+	bsi_t *bsi=&state->bsi;
+	float mix[6][7];		// output (canonical) <- canonical channel (+ CH_S)
+	float row[6][6];		// output (canonical) <- samples[] index
+	float clev=cmixlev_lut[bsi->cmixlev&3],slev=smixlev_lut[bsi->surmixlev&3];
+	float scale,norm;
+	const sint_8 *map=acmod_map[bsi->acmod&7];
+	int i,j,o;
+
+	memset(mix,0,sizeof(mix));
+	switch(state->out_mode)
+	{
+		case AC3_OUTPUT_51:
+			for(i=0;i<6;i++)
+				mix[i][i]=1.0f;
+			mix[CH_SL][CH_S]=mix[CH_SR][CH_S]=0.7071f;
+			break;
+		case AC3_OUTPUT_QUAD:
+			mix[CH_L][CH_L]=mix[CH_R][CH_R]=1.0f;
+			mix[CH_L][CH_C]=mix[CH_R][CH_C]=clev;
+			mix[CH_SL][CH_SL]=mix[CH_SR][CH_SR]=1.0f;
+			mix[CH_SL][CH_S]=mix[CH_SR][CH_S]=0.7071f;
+			break;
+		case AC3_OUTPUT_STEREO:
+			// Lo/Ro
+			mix[CH_L][CH_L]=mix[CH_R][CH_R]=1.0f;
+			mix[CH_L][CH_C]=mix[CH_R][CH_C]=clev;
+			mix[CH_L][CH_SL]=mix[CH_R][CH_SR]=slev;
+			mix[CH_L][CH_S]=mix[CH_R][CH_S]=0.7071f*slev;
+			break;
+		case AC3_OUTPUT_DOLBY:
+			// Lt/Rt: the surrounds in anti-phase
+			mix[CH_L][CH_L]=mix[CH_R][CH_R]=1.0f;
+			mix[CH_L][CH_C]=mix[CH_R][CH_C]=0.7071f;
+			mix[CH_L][CH_SL]=mix[CH_L][CH_SR]=mix[CH_L][CH_S]=-0.7071f;
+			mix[CH_R][CH_SL]=mix[CH_R][CH_SR]=mix[CH_R][CH_S]=0.7071f;
+			break;
+		case AC3_OUTPUT_MONO:
+			mix[CH_C][CH_L]=mix[CH_C][CH_R]=mix[CH_C][CH_C]=1.0f;
+			mix[CH_C][CH_SL]=mix[CH_C][CH_SR]=slev;
+			mix[CH_C][CH_S]=0.7071f*slev;
+			break;
+	}
+
+	memset(row,0,sizeof(row));
+	for(o=0;o<6;o++)
+	{
+		for(i=0;i<5;i++)
+			if(map[i]>=0)
+				row[o][i]=mix[o][map[i]];
+		if(bsi->lfeon)
+			row[o][5]=mix[o][CH_LFE];
+	}
+
+	// downmixes are scaled so that they cannot clip
+	norm=1.0f;
+	if(state->out_mode!=AC3_OUTPUT_51)
+		for(o=0;o<6;o++)
+		{
+			float sum=0.0f;
+			for(i=0;i<6;i++)
+				sum+=(float)fabs(row[o][i]);
+			if(sum>norm)
+				norm=sum;
+		}
+
+	scale=state->out_gain/norm;
+	if(state->out_format==AC3_FORMAT_S16)
+		scale*=32767.0f;
+	else if(state->out_format==AC3_FORMAT_S24_32)
+		scale*=8388607.0f;
+
+	// the output rows: interleaved in the mode's order, or the six planar channels
+	for(o=0;o<state->out_channels;o++)
+	{
+		int ch=state->output?mode_order[state->out_mode][o]:o;
+		state->out_nin[o]=0;
+		for(i=0;i<6;i++)
+			if(row[ch][i]!=0.0f)
+			{
+				j=state->out_nin[o]++;
+				state->out_in[o][j]=(uint_8)i;
+				state->out_coef[o][j]=row[ch][i]*scale;
+			}
+	}
+}
+
+// ---- scalar
+
+static inline uint_32 output_rand(uint_32 *seed)
+{
+	uint_32 x=*seed;
+	x^=x<<13;
+	x^=x>>17;
+	x^=x<<5;
+	*seed=x;
+	return x;
+}
+
+// rounding to nearest (even) in float, so that the loops vectorize: a sum in [2^23,2^24) has no
+// fraction bits; output_quantize() leaves x+bias in x[] (a float store: no excess precision on x87),
+// the stores take the bias back off; the result is the one of cvtps2dq
+#define OUTPUT_BIAS16		12582912.0f						// 1.5*2^23: |x| < 2^22
+#define OUTPUT_BIAS24(x)	((x)<0.0f?-8388608.0f:8388608.0f)	// |x| <= 2^23
+#define output_s16(y)		((sint_16)(sint_32)((y)-OUTPUT_BIAS16))
+#define output_s24(y)		((sint_32)((y)-OUTPUT_BIAS24(y)))
+
+// the scalar path works on 16 samples of a row at a time, in a local array: the compiler
+// can keep it in registers (and vectorize) without having to prove that it does not alias the input
+
+// x[]: sum of coef[i]*in[i][j..j+15], in this order (as in the SSE2 path)
+static inline void output_mix(float *x,const float *const *in,const float *coef,int n,int j)
+{
+	int i,k;
+
+	if(n==0)
+	{
+		for(k=0;k<16;k++)
+			x[k]=0.0f;
+		return;
+	}
+	for(k=0;k<16;k++)
+		x[k]=coef[0]*in[0][j+k];
+	for(i=1;i<n;i++)
+		for(k=0;k<16;k++)
+			x[k]+=coef[i]*in[i][j+k];
+}
+
+// dither, saturation and rounding, in place (biased: see output_s16(), output_s24())
+static inline void output_quantize(float *x,float hi,float lo,int dither,uint_32 *seed)
+{
+	int k;
+
+	// two generators (seed[0], seed[4]): the xorshift is a dependency chain
+	if(dither)
+		for(k=0;k<16;k+=2)
+		{
+			uint_32 r0=output_rand(seed),r1=output_rand(seed+4);
+			x[k]+=(float)((sint_32)(r0>>16)-(sint_32)(r0&0xffff))*(1.0f/65536.0f);
+			x[k+1]+=(float)((sint_32)(r1>>16)-(sint_32)(r1&0xffff))*(1.0f/65536.0f);
+		}
+	// (hi, lo: variables; compared to constants, these loops do not vectorize with gcc)
+	if(hi<65536.0f)
+		for(k=0;k<16;k++)
+		{
+			float y=x[k];
+			y=y>hi?hi:y;
+			y=y<lo?lo:y;
+			x[k]=y+OUTPUT_BIAS16;
+		}
+	else
+		for(k=0;k<16;k++)
+		{
+			float y=x[k];
+			y=y>hi?hi:y;
+			y=y<lo?lo:y;
+			x[k]=y+OUTPUT_BIAS24(y);
+		}
+}
+
+static void output_block_c(ac3_state *state,int block)
+{
+	int nch=state->out_channels,format=state->out_format,dither=state->out_dither;
+	float hi=format==AC3_FORMAT_S16?32767.0f:8388607.0f,lo=-hi-1.0f;
+	sint_16 *planar[6];
+	int i,j,k,o;
+
+	planar[0]=state->left; planar[1]=state->center; planar[2]=state->right;
+	planar[3]=state->sleft; planar[4]=state->sright; planar[5]=state->subwoofer;
+
+	// row by row: a planar channel, or one channel of the interleaved frames
+	for(o=0;o<nch;o++)
+	{
+		const float *in[6],*coef=state->out_coef[o];
+		uint_32 *seed=&state->out_seed[o&3];
+		int n=state->out_nin[o];
+		float x[16];
+
+		for(i=0;i<n;i++)
+			in[i]=state->samples[state->out_in[o][i]];
+
+		if(state->output==NULL)
+		{
+			sint_16 *s16=planar[o]+block*256;
+			for(j=0;j<256;j+=16)
+			{
+				output_mix(x,in,coef,n,j);
+				output_quantize(x,hi,lo,dither,seed);
+				for(k=0;k<16;k++)
+					s16[j+k]=output_s16(x[k]);
+			}
+		}
+		else if(format==AC3_FORMAT_S16)
+		{
+			sint_16 *s16=(sint_16 *)state->output+(size_t)block*256*nch+o;
+			for(j=0;j<256;j+=16)
+			{
+				output_mix(x,in,coef,n,j);
+				output_quantize(x,hi,lo,dither,seed);
+				for(k=0;k<16;k++)
+					s16[(j+k)*nch]=output_s16(x[k]);
+			}
+		}
+		else if(format==AC3_FORMAT_S24_32)
+		{
+			sint_32 *s32=(sint_32 *)state->output+(size_t)block*256*nch+o;
+			for(j=0;j<256;j+=16)
+			{
+				output_mix(x,in,coef,n,j);
+				output_quantize(x,hi,lo,dither,seed);
+				for(k=0;k<16;k++)
+					s32[(j+k)*nch]=output_s24(x[k])*256;
+			}
+		}
+		else
+		{
+			float *f32=(float *)state->output+(size_t)block*256*nch+o;
+			for(j=0;j<256;j+=16)
+			{
+				output_mix(x,in,coef,n,j);
+				for(k=0;k<16;k++)
+					f32[(j+k)*nch]=x[k];
+			}
+		}
+	}
+}
+
+// ---- SSE2
+
+#ifdef OUTPUT_SSE2
+
+#define SHUF(x,y,a,b,c,d) _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(x),_mm_castsi128_ps(y),_MM_SHUFFLE(d,c,b,a)))
+
+// 4x4 transpose of 32-bit lanes: w[ch][sample] -> r[sample][ch]
+static inline void transpose4(__m128i *r,const __m128i *w)
+{
+	__m128i t0=_mm_unpacklo_epi32(w[0],w[1]),t1=_mm_unpacklo_epi32(w[2],w[3]);
+	__m128i t2=_mm_unpackhi_epi32(w[0],w[1]),t3=_mm_unpackhi_epi32(w[2],w[3]);
+	r[0]=_mm_unpacklo_epi64(t0,t1);
+	r[1]=_mm_unpackhi_epi64(t0,t1);
+	r[2]=_mm_unpacklo_epi64(t2,t3);
+	r[3]=_mm_unpackhi_epi64(t2,t3);
+}
+
+// 4 samples of nch 32-bit channels, interleaved
+static inline void store32(uint_32 *dst,const __m128i *w,int nch)
+{
+	__m128i r[4],p0,p1;
+
+	switch(nch)
+	{
+		case 1:
+			_mm_storeu_si128((__m128i *)dst,w[0]);
+			break;
+		case 2:
+			_mm_storeu_si128((__m128i *)dst,_mm_unpacklo_epi32(w[0],w[1]));
+			_mm_storeu_si128((__m128i *)(dst+4),_mm_unpackhi_epi32(w[0],w[1]));
+			break;
+		case 4:
+			transpose4(r,w);
+			_mm_storeu_si128((__m128i *)dst,r[0]);
+			_mm_storeu_si128((__m128i *)(dst+4),r[1]);
+			_mm_storeu_si128((__m128i *)(dst+8),r[2]);
+			_mm_storeu_si128((__m128i *)(dst+12),r[3]);
+			break;
+		case 6:
+			transpose4(r,w);
+			p0=_mm_unpacklo_epi32(w[4],w[5]);
+			p1=_mm_unpackhi_epi32(w[4],w[5]);
+			_mm_storeu_si128((__m128i *)dst,r[0]);
+			_mm_storel_epi64((__m128i *)(dst+4),p0);
+			_mm_storeu_si128((__m128i *)(dst+6),r[1]);
+			_mm_storel_epi64((__m128i *)(dst+10),_mm_srli_si128(p0,8));
+			_mm_storeu_si128((__m128i *)(dst+12),r[2]);
+			_mm_storel_epi64((__m128i *)(dst+16),p1);
+			_mm_storeu_si128((__m128i *)(dst+18),r[3]);
+			_mm_storel_epi64((__m128i *)(dst+22),_mm_srli_si128(p1,8));
+			break;
+	}
+}
+
+// 4 samples of nch 16-bit channels, interleaved (w: 32-bit, saturated by the packing)
+static inline void store16(sint_16 *dst,const __m128i *w,int nch)
+{
+	__m128i r[4],a,b,c;
+
+	switch(nch)
+	{
+		case 1:
+			_mm_storel_epi64((__m128i *)dst,_mm_packs_epi32(w[0],w[0]));
+			break;
+		case 2:
+			_mm_storeu_si128((__m128i *)dst,_mm_packs_epi32(_mm_unpacklo_epi32(w[0],w[1]),_mm_unpackhi_epi32(w[0],w[1])));
+			break;
+		case 4:
+			transpose4(r,w);
+			_mm_storeu_si128((__m128i *)dst,_mm_packs_epi32(r[0],r[1]));
+			_mm_storeu_si128((__m128i *)(dst+8),_mm_packs_epi32(r[2],r[3]));
+			break;
+		case 6:
+			// in channel pairs (32 bits): a: s0 c01 c23, s1 c01 c23; b: s0..s3 c45; c: s2, s3 c01 c23
+			transpose4(r,w);
+			a=_mm_packs_epi32(r[0],r[1]);
+			b=_mm_packs_epi32(_mm_unpacklo_epi32(w[4],w[5]),_mm_unpackhi_epi32(w[4],w[5]));
+			c=_mm_packs_epi32(r[2],r[3]);
+			_mm_storeu_si128((__m128i *)dst,SHUF(a,SHUF(b,a,0,0,2,2),0,1,0,2));
+			_mm_storeu_si128((__m128i *)(dst+8),SHUF(SHUF(a,b,3,3,1,1),c,0,2,0,1));
+			r[0]=SHUF(b,c,2,3,2,3);
+			_mm_storeu_si128((__m128i *)(dst+16),SHUF(r[0],r[0],0,2,3,1));
+			break;
+	}
+}
+
+static void output_block_sse2(ac3_state *state,int block)
+{
+	int nch=state->out_channels,format=state->out_format,dither=state->out_dither;
+	float lim=format==AC3_FORMAT_S16?32767.0f:8388607.0f;
+	__m128 hi=_mm_set1_ps(lim),lo=_mm_set1_ps(-lim-1.0f);
+	__m128 coef[6][6];
+	const float *in[6][6];
+	int nin[6];
+	void *output=state->output;
+	__m128i seed0=_mm_loadu_si128((__m128i *)state->out_seed),seed1=_mm_loadu_si128((__m128i *)(state->out_seed+4));
+	__m128i mask=_mm_set1_epi32(0xffff);
+	__m128 lsb=_mm_set1_ps(1.0f/65536.0f);
+	sint_16 *planar[6];
+	__m128 x0,x1;
+	__m128i w0,w1,w2,w3;
+	int i,j,o;
+
+	for(o=0;o<nch;o++)
+		for(nin[o]=state->out_nin[o],i=0;i<nin[o];i++)
+		{
+			coef[o][i]=_mm_set1_ps(state->out_coef[o][i]);
+			in[o][i]=state->samples[state->out_in[o][i]];
+		}
+	planar[0]=state->left; planar[1]=state->center; planar[2]=state->right;
+	planar[3]=state->sleft; planar[4]=state->sright; planar[5]=state->subwoofer;
+
+	// TPDF: the difference of two uniform 16-bit values, +-1 LSB; xorshift in 4 lanes,
+	// two generators (x0, x1) so that the chains overlap
+	#define DITHER(x,seed) \
+	{ \
+		seed=_mm_xor_si128(seed,_mm_slli_epi32(seed,13)); \
+		seed=_mm_xor_si128(seed,_mm_srli_epi32(seed,17)); \
+		seed=_mm_xor_si128(seed,_mm_slli_epi32(seed,5)); \
+		x=_mm_add_ps(x,_mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(seed,16),_mm_and_si128(seed,mask))),lsb)); \
+	}
+
+	// a row, 8 samples at a time: x0, x1 = sum of coef[o][i]*in[o][i][j..j+7], dithered
+	#define MIX(o) \
+	{ \
+		x0=_mm_mul_ps(coef[o][0],_mm_loadu_ps(in[o][0]+j)); \
+		x1=_mm_mul_ps(coef[o][0],_mm_loadu_ps(in[o][0]+j+4)); \
+		for(i=1;i<nin[o];i++) \
+		{ \
+			x0=_mm_add_ps(x0,_mm_mul_ps(coef[o][i],_mm_loadu_ps(in[o][i]+j))); \
+			x1=_mm_add_ps(x1,_mm_mul_ps(coef[o][i],_mm_loadu_ps(in[o][i]+j+4))); \
+		} \
+		if(dither) \
+		{ \
+			DITHER(x0,seed0); \
+			DITHER(x1,seed1); \
+		} \
+	}
+
+	if(output==NULL)
+	{
+		// planar sint_16: channel by channel
+		for(o=0;o<6;o++)
+		{
+			sint_16 *dst=planar[o]+block*256;
+			if(nin[o]==0)
+			{
+				memset(dst,0,256*sizeof(sint_16));
+				continue;
+			}
+			if(nin[o]==1 && !dither)
+			{
+				// a decoded channel as is (the 5.1 path): scale, saturate and pack, 16 samples at a time
+				const float *src=in[o][0];
+				__m128 c=coef[o][0];
+				for(j=0;j<256;j+=16)
+				{
+					w0=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(c,_mm_loadu_ps(src+j)),lo),hi));
+					w1=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(c,_mm_loadu_ps(src+j+4)),lo),hi));
+					w2=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(c,_mm_loadu_ps(src+j+8)),lo),hi));
+					w3=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(c,_mm_loadu_ps(src+j+12)),lo),hi));
+					_mm_storeu_si128((__m128i *)(dst+j),_mm_packs_epi32(w0,w1));
+					_mm_storeu_si128((__m128i *)(dst+j+8),_mm_packs_epi32(w2,w3));
+				}
+				continue;
+			}
+			for(j=0;j<256;j+=8)
+			{
+				MIX(o);
+				_mm_storeu_si128((__m128i *)(dst+j),_mm_packs_epi32(
+					_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x0,lo),hi)),
+					_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x1,lo),hi))));
+			}
+		}
+		_mm_storeu_si128((__m128i *)state->out_seed,seed0);
+		_mm_storeu_si128((__m128i *)(state->out_seed+4),seed1);
+		return;
+	}
+
+	if(nch==2 && format==AC3_FORMAT_S16 && nin[0] && nin[1])
+	{
+		// the stereo downmixes: both rows at once, straight into the frames
+		sint_16 *dst=(sint_16 *)output+block*256*2;
+		for(j=0;j<256;j+=8)
+		{
+			MIX(0);
+			w0=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x0,lo),hi));
+			w1=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x1,lo),hi));
+			MIX(1);
+			w2=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x0,lo),hi));
+			w3=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x1,lo),hi));
+			_mm_storeu_si128((__m128i *)(dst+j*2),_mm_packs_epi32(_mm_unpacklo_epi32(w0,w2),_mm_unpackhi_epi32(w0,w2)));
+			_mm_storeu_si128((__m128i *)(dst+j*2+8),_mm_packs_epi32(_mm_unpacklo_epi32(w1,w3),_mm_unpackhi_epi32(w1,w3)));
+		}
+		_mm_storeu_si128((__m128i *)state->out_seed,seed0);
+		_mm_storeu_si128((__m128i *)(state->out_seed+4),seed1);
+		return;
+	}
+
+	// interleaved: the rows (32-bit: float, or quantized) first, then packed 4 frames at a time
+	// (a pass per channel count, so that store16() and store32() are specialized)
+	for(o=0;o<nch;o++)
+	{
+		__m128i *row=(__m128i *)state->out_rows[o];
+		if(nin[o]==0)
+		{
+			memset(row,0,256*sizeof(sint_32));
+			continue;
+		}
+		for(j=0;j<256;j+=8,row+=2)
+		{
+			MIX(o);		// f32: never dithered
+			if(format==AC3_FORMAT_F32)
+			{
+				_mm_storeu_ps((float *)row,x0);
+				_mm_storeu_ps((float *)(row+1),x1);
+				continue;
+			}
+			w0=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x0,lo),hi));
+			w1=_mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(x1,lo),hi));
+			if(format==AC3_FORMAT_S24_32)
+			{
+				w0=_mm_slli_epi32(w0,8);
+				w1=_mm_slli_epi32(w1,8);
+			}
+			_mm_storeu_si128(row,w0);
+			_mm_storeu_si128(row+1,w1);
+		}
+	}
+
+	#define PACK(n) \
+	{ \
+		__m128i w[n]; \
+		if(format==AC3_FORMAT_S16) \
+			for(j=0;j<256;j+=4) \
+			{ \
+				for(o=0;o<n;o++) \
+					w[o]=_mm_loadu_si128((const __m128i *)(state->out_rows[o]+j)); \
+				store16((sint_16 *)output+(block*256+j)*n,w,n); \
+			} \
+		else \
+			for(j=0;j<256;j+=4) \
+			{ \
+				for(o=0;o<n;o++) \
+					w[o]=_mm_loadu_si128((const __m128i *)(state->out_rows[o]+j)); \
+				store32((uint_32 *)output+(block*256+j)*n,w,n); \
+			} \
+	}
+
+	switch(nch)
+	{
+		case 1: PACK(1); break;
+		case 2: PACK(2); break;
+		case 4: PACK(4); break;
+		case 6: PACK(6); break;
+	}
+	#undef PACK
+	#undef MIX
+	_mm_storeu_si128((__m128i *)state->out_seed,seed0);
+	_mm_storeu_si128((__m128i *)(state->out_seed+4),seed1);
+	#undef DITHER
+}
+
+#endif
+
+void output_block(ac3_state *state,int block)
+{
+#ifdef OUTPUT_SSE2
+	if(state->out_sse2)
+	{
+		output_block_sse2(state,block);
+		return;
+	}
+#endif
+	output_block_c(state,block);
+}
@@ -143,14 +143,36 @@ void parse_syncinfo(syncinfo_t *syncinfo,int *error_flag,ac3_state *state)
 	tmp = (tmp << 8) + bitstream_get_byte(state);
 	tmp = (tmp << 8) + bitstream_get_byte(state);
 
+	if(parse_syncinfo_header(syncinfo,tmp,state))
+	{
+		*error_flag=1;
+		return;
+	}
+
+	// Buffer the entire syncframe 
+	bitstream_get_bytes(state->buffer,syncinfo->frame_size * 2 - 5,state);
+	bitstream_set_frame(syncinfo->frame_size * 2 - 5,state);
+
+	if(parse_syncinfo_crc(syncinfo,tmp,state))
+	{
+		*error_flag = 1;
+		// debug(DAC3,"** AC3 CRC failed - skipping frame **\n");
+		return;
+	}
+
+	// stats_print_syncinfo(syncinfo,state);
+}
+
+/* Parse the 24 bits following the sync word (crc1, fscod, frmsizecod) */
+int parse_syncinfo_header(syncinfo_t *syncinfo,uint_32 tmp,ac3_state *state)
+{
 	// Get the sampling rate 
 	syncinfo->fscod  = (tmp >> 6) & 0x3;
 
 	if(syncinfo->fscod == 3)
 	{
 		//invalid sampling rate code
-		*error_flag = 1;	
-		return;
+		return -1;
 	}
 	else if(syncinfo->fscod == 2)
 		syncinfo->sampling_rate = 32000;
@@ -163,39 +185,35 @@ void parse_syncinfo(syncinfo_t *syncinfo,int *error_flag,ac3_state *state)
 	syncinfo->frmsizecod = tmp & 0x3f;
 
 	if(syncinfo->frmsizecod>37)
-	{
-		*error_flag=1;
-		return;
-	}
+		return -1;
 
 	// Calculate the frame size and bitrate
 	syncinfo->frame_size = 
 		frmsizecod_tbl[syncinfo->frmsizecod].frm_size[syncinfo->fscod];
 	syncinfo->bit_rate = frmsizecod_tbl[syncinfo->frmsizecod].bit_rate;
 
-	if(syncinfo->frame_size==0 || syncinfo->frame_size>sizeof(state->buffer))
-	{
-		*error_flag=1;
-		return;
-	}
+	// the body and the bit reader's padding must fit in the frame buffer
+	if(syncinfo->frame_size==0 || (uint_32)(syncinfo->frame_size * 2 - 5 + BITSTREAM_PADDING) > sizeof(state->buffer))
+		return -1;
 
-	// Buffer the entire syncframe 
-	bitstream_buffer_frame(syncinfo->frame_size * 2 - 5,state);
-	// Check the crc over the entire frame 
-	crc_init(state);
-	crc_process_byte((uint_8) (tmp>>16) ,state);
-	crc_process_byte((uint_8) ((tmp>>8) & 0xff) ,state);
-	crc_process_byte((uint_8) (tmp & 0xff) ,state);
-	crc_process_frame(bitstream_get_buffer_start(state),syncinfo->frame_size * 2 - 5,state);
+	return 0;
+}
 
-	if(!crc_validate(state))
-	{
-		*error_flag = 1;
-		// debug(DAC3,"** AC3 CRC failed - skipping frame **\n");
-		return;
-	}
+/* Check the crc over the entire frame: the header bytes (tmp) and the
+ * rest of the syncframe, already buffered in state->buffer */
+int parse_syncinfo_crc(syncinfo_t *syncinfo,uint_32 tmp,ac3_state *state)
+{
+	uint_8 header[3];
 
-	// stats_print_syncinfo(syncinfo,state);
+	header[0] = (uint_8) (tmp>>16);
+	header[1] = (uint_8) ((tmp>>8) & 0xff);
+	header[2] = (uint_8) (tmp & 0xff);
+
+	crc_init(state);
+	crc_process_frame(header,3,state);
+	crc_process_frame(state->buffer,syncinfo->frame_size * 2 - 5,state);
+
+	return crc_validate(state)?0:-1;
 }
 
 /*
@@ -332,7 +350,7 @@ void parse_bsi(bsi_t *bsi,ac3_state *state)
 }
 
 /* More pain inducing parsing */
-void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
+void parse_audblk(bsi_t *bsi,audblk_t *audblk,uint_32 block,int *error_flag,ac3_state *state)
 {
 	int i,j;
 
@@ -370,6 +388,9 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 
 	/* Does coupling strategy exist? */
 	audblk->cplstre = (uint_16)bitstream_get(1,state);
+	/* Block 0 can't reuse the state of the previous frame */
+	if(block == 0 && !audblk->cplstre)
+		goto error;
 	if (audblk->cplstre)
 	{
 		/* Is coupling turned on? */
@@ -382,6 +403,11 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 				audblk->phsflginu = (uint_16)bitstream_get(1,state);
 			audblk->cplbegf = (uint_16)bitstream_get(4,state);
 			audblk->cplendf = (uint_16)bitstream_get(4,state);
+
+			/* The coupling range must not end before it begins */
+			if(audblk->cplbegf > audblk->cplendf + 2)
+				goto error;
+
 			audblk->ncplsubnd = (audblk->cplendf + 2) - audblk->cplbegf + 1;
 
 			/* Calculate the start and end bins of the coupling channel */
@@ -464,16 +490,27 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 	{
 		/* Get the coupling channel exponent strategy */
 		audblk->cplexpstr = (uint_16)bitstream_get(2,state);
-		audblk->ncplgrps = (audblk->cplendmant - audblk->cplstrtmant) / 
-				(3 << (audblk->cplexpstr-1));
+		if(block == 0 && audblk->cplexpstr == EXP_REUSE)
+			goto error;
+		if(audblk->cplexpstr != EXP_REUSE)
+			audblk->ncplgrps = (audblk->cplendmant - audblk->cplstrtmant) / 
+					(3 << (audblk->cplexpstr-1));
 	}
 
 	for(i = 0; i < bsi->nfchans; i++)
+	{
 		audblk->chexpstr[i] = (uint_16)bitstream_get(2,state);
+		if(block == 0 && audblk->chexpstr[i] == EXP_REUSE)
+			goto error;
+	}
 
 	/* Get the exponent strategy for lfe channel */
 	if(bsi->lfeon) 
+	{
 		audblk->lfeexpstr = (uint_16)bitstream_get(1,state);
+		if(block == 0 && audblk->lfeexpstr == EXP_REUSE)
+			goto error;
+	}
 
 	/* Determine the bandwidths of all the fbw channels */
 	for(i = 0; i < bsi->nfchans; i++) 
@@ -489,6 +526,9 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 			else
 			{
 				audblk->chbwcod[i] = (uint_16)bitstream_get(6,state); 
+				/* The channel can't end past bin 253 */
+				if(audblk->chbwcod[i] > 60)
+					goto error;
 				audblk->endmant[i] = ((audblk->chbwcod[i] + 12) * 3) + 37;
 			}
 
@@ -528,6 +568,8 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 
 	/* Get the parametric bit allocation parameters */
 	audblk->baie = (uint_16)bitstream_get(1,state);
+	if(block == 0 && !audblk->baie)
+		goto error;
 
 	if(audblk->baie)
 	{
@@ -540,6 +582,8 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 
 	/* Get the SNR off set info if it exists */
 	audblk->snroffste = (uint_16)bitstream_get(1,state);
+	if(block == 0 && !audblk->snroffste)
+		goto error;
 
 	if(audblk->snroffste)
 	{
@@ -568,6 +612,8 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 	if(audblk->cplinu)
 	{
 		audblk->cplleake = (uint_16)bitstream_get(1,state);	
+		if(block == 0 && !audblk->cplleake)
+			goto error;
 		
 		if(audblk->cplleake)
 		{
@@ -627,6 +673,11 @@ void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 	}
 
 	stats_print_audblk(bsi,audblk,state);
+	return;
+
+error:
+	// debug(DAC3,"** Invalid audblk - skipping frame **\n");
+	*error_flag = 1;
 }
 
 void parse_auxdata(syncinfo_t *syncinfo,ac3_state *state)
@@ -29,7 +29,7 @@ struct rematrix_band_s
 	uint_32 end;
 };
 
-struct rematrix_band_s rematrix_band[] = { {13,24}, {25,36}, {37 ,60}, {61,252}};
+static const struct rematrix_band_s rematrix_band[] = { {13,24}, {25,36}, {37 ,60}, {61,252}};
 
 static inline uint_32 min_(uint_32 a,uint_32 b);
 
@@ -147,7 +147,7 @@ void stats_print_bsi(bsi_t *bsi,ac3_state *state)
 	debug(DAC3,"\n");
 }
 
-char *exp_strat_tbl[4] = {"R   ","D15 ","D25 ","D45 "};
+static const char *exp_strat_tbl[4] = {"R   ","D15 ","D25 ","D45 "};
 
 void stats_print_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state)
 {
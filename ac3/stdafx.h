@@ -25,6 +25,12 @@
 #include "driver/ac3.h"
 
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+// uintptr_t: stddef.h with MSVC
+#if !defined(_MSC_VER)
+ #include <stdint.h>
+#endif
+
 #endif
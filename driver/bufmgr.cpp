@@ -23,6 +23,9 @@
 
 #define n_pages(a) (((a)/KX_PAGE_SIZE)+(((a)%KX_PAGE_SIZE)?1:0))
 
+static void kx_sf_stream_map(kx_hw *hw,int num,kx_sf_stream *stream,dword pages);
+static void kx_sf_stream_unmap(kx_hw *hw,int num,dword pages);
+
 static int kx_bufmgr_alloc(kx_hw *hw,dword size,dword addr)
 {
 	kx_pagetable_t *pagetable = hw->pagetable;
@@ -37,7 +40,8 @@ static int kx_bufmgr_alloc(kx_hw *hw,dword size,dword addr)
 	{
 		if(pagetable[index].usage) 
 		{
-			if((pagetable[index].addr==addr) && (pagetable[index].sz==numpages))
+			// addr==0: not shared (streamed SoundFont pages)
+			if(addr && (pagetable[index].addr==addr) && (pagetable[index].sz==numpages))
 			{
 			        debug(DBUFF,"kx wdm debug: pagetable re-used [%x; %x; %x; %x]\n",
 			         index,
@@ -162,6 +166,10 @@ int kx_alloc_buffer(kx_hw *hw,int num)
 	dword pageindex, pagecount;
 	dword pages=n_pages(buffer->size);
 
+	// streamed SoundFont samples: set again by kx_sf_stream_map() once the pages are mapped
+	kx_sf_stream *stream=hw->voicetable[num].sf_stream;
+	hw->voicetable[num].sf_stream=NULL;
+
 	for(int t=0;t<16;t++) // try up to 16 times...
 	{
         	buffer->pageindex = kx_bufmgr_alloc(hw,pages * KX_PAGE_SIZE, buffer->physical);
@@ -193,6 +201,9 @@ int kx_alloc_buffer(kx_hw *hw,int num)
 	}
 
 	// Fill-in the pagetable
+	if(stream)
+	 kx_sf_stream_map(hw,num,stream,pages);
+	else
 	if(hw->pagetable[buffer->pageindex].usage==1) // first time only
 	{
 	  for(pagecount=0;pagecount<pages;pagecount++) 
@@ -232,6 +243,9 @@ void kx_free_buffer(kx_hw *hw,int num)
 
 	dword pages=n_pages(buffer->size);
 
+	if(hw->voicetable[num].sf_stream)
+	 kx_sf_stream_unmap(hw,num,pages);
+
 	if(hw->pagetable[buffer->pageindex].usage==1) // last one
 	{
         	for(pagecount=0;pagecount<pages;pagecount++) 
@@ -244,3 +258,520 @@ void kx_free_buffer(kx_hw *hw,int num)
 	kx_bufmgr_free(hw, buffer->pageindex);
 	buffer->pageindex = -1;
 }
+
+// SoundFont streaming
+// -------------------
+// the sample data of a streamed SoundFont is kept in pageable memory ('backing'); the first KX_SF_RESIDENT
+// bytes of each sample are also copied to 'resident' (lmem), so that notes can start without a delay
+// the other pages are copied into the pool when a note needs them:
+//  - kx_sf_stream_map() [note-on]: maps resident and pooled pages; the pages that are not in the pool are
+//    mapped to the silent page and queued in playback order (the note-on is the prefetch hint)
+//  - sf_stream_worker() [PASSIVE_LEVEL]: copies the queued pages into the pool and maps them for all
+//    the voices that play them
+// pooled pages are pinned by the voices that map them; unpinned pages are evicted in LRU order
+// a stream is not freed while its pages are copied without sf_lock held (stream->busy): the last copy
+// frees a stream destroyed meanwhile
+// everything below is protected by sf_lock
+
+static void *sf_pool_addr(kx_hw *hw,int s,dword *physical)
+{
+ __int64 a=0;
+ void *addr=hw->cb.lmem_get_addr_func(hw->cb.call_with,&hw->sf_pool,s*KX_PAGE_SIZE,physical?&a:NULL);
+ if(physical)
+  *physical=(dword)a;
+ return addr;
+}
+
+static dword sf_page_physical(kx_hw *hw,kx_sf_stream *stream,dword page)
+{
+ if(page<stream->n_pages)
+ {
+  if(stream->resident_page[page]>=0)
+  {
+   __int64 a=0;
+   hw->cb.lmem_get_addr_func(hw->cb.call_with,&stream->resident,stream->resident_page[page]*KX_PAGE_SIZE,&a);
+   return (dword)a;
+  }
+  if(stream->slot[page]>=0)
+  {
+   dword physical=0;
+   sf_pool_addr(hw,stream->slot[page],&physical);
+   return physical;
+  }
+ }
+ return hw->silentpage.dma_handle;
+}
+
+static void sf_lru_remove(kx_hw *hw,int s)
+{
+ kx_sf_slot *slot=&hw->sf_slots[s];
+
+ if(slot->prev>=0) hw->sf_slots[slot->prev].next=slot->next; else hw->sf_lru_head=slot->next;
+ if(slot->next>=0) hw->sf_slots[slot->next].prev=slot->prev; else hw->sf_lru_tail=slot->prev;
+ slot->prev=slot->next=-1;
+}
+
+// head: most recently used; tail: evicted first (free slots)
+static void sf_lru_add(kx_hw *hw,int s,int tail)
+{
+ kx_sf_slot *slot=&hw->sf_slots[s];
+
+ if(tail)
+ {
+  slot->prev=hw->sf_lru_tail; slot->next=-1;
+  if(hw->sf_lru_tail>=0) hw->sf_slots[hw->sf_lru_tail].next=s; else hw->sf_lru_head=s;
+  hw->sf_lru_tail=s;
+ }
+ else
+ {
+  slot->next=hw->sf_lru_head; slot->prev=-1;
+  if(hw->sf_lru_head>=0) hw->sf_slots[hw->sf_lru_head].prev=s; else hw->sf_lru_tail=s;
+  hw->sf_lru_head=s;
+ }
+}
+
+static inline void sf_pin(kx_hw *hw,int s)
+{
+ if(hw->sf_slots[s].pins++==0)
+  sf_lru_remove(hw,s);
+}
+
+static inline void sf_unpin(kx_hw *hw,int s)
+{
+ if(--hw->sf_slots[s].pins==0)
+  sf_lru_add(hw,s,0);
+}
+
+static void sf_fetch_queue(kx_hw *hw,kx_sf_stream *stream,dword page)
+{
+ if(hw->sf_fetch_count>=KX_SF_FETCH_QUEUE)
+ {
+  hw->sf_dropped++;
+  return;
+ }
+ kx_sf_fetch *f=&hw->sf_fetch[(hw->sf_fetch_head+hw->sf_fetch_count)%KX_SF_FETCH_QUEUE];
+ f->stream=stream;
+ f->page=page;
+ hw->sf_fetch_count++;
+ stream->slot[page]=KX_SF_PAGE_QUEUED;
+}
+
+static void sf_stream_worker(void *data)
+{
+ kx_hw *hw=(kx_hw *)data;
+ unsigned long flags=0;
+
+ while(1)
+ {
+  kx_lock_acquire(hw,&hw->sf_lock,&flags);
+
+  kx_sf_stream *stream=NULL;
+  dword page=0;
+  while(hw->sf_fetch_count)
+  {
+   kx_sf_fetch *f=&hw->sf_fetch[hw->sf_fetch_head];
+   hw->sf_fetch_head=(hw->sf_fetch_head+1)%KX_SF_FETCH_QUEUE;
+   hw->sf_fetch_count--;
+
+   if(f->stream && f->stream->slot[f->page]==KX_SF_PAGE_QUEUED)
+   {
+    stream=f->stream;
+    page=f->page;
+    break;
+   }
+  }
+  if(stream==NULL)
+  {
+   hw->sf_worker_queued=0;
+   kx_lock_release(hw,&hw->sf_lock,&flags);
+   return;
+  }
+
+  int s=hw->sf_lru_tail;
+  if(s<0) // all the pool is pinned by playing voices
+  {
+   stream->slot[page]=KX_SF_PAGE_ABSENT;
+   hw->sf_dropped++;
+   kx_lock_release(hw,&hw->sf_lock,&flags);
+   continue;
+  }
+
+  kx_sf_slot *slot=&hw->sf_slots[s];
+  sf_lru_remove(hw,s);
+  if(slot->stream)
+  {
+   slot->stream->slot[slot->page]=KX_SF_PAGE_ABSENT;
+   hw->sf_evictions++;
+  }
+  slot->stream=NULL;
+  stream->busy++;
+
+  kx_lock_release(hw,&hw->sf_lock,&flags);
+
+  // 'backing' is pageable
+  dword physical=0;
+  memcpy(sf_pool_addr(hw,s,&physical),stream->backing+page*KX_PAGE_SIZE,KX_PAGE_SIZE);
+
+  kx_lock_acquire(hw,&hw->sf_lock,&flags);
+
+  int last=kx_sf_stream_release(hw,stream);
+  if(stream->destroyed)
+  {
+   // the SoundFont was unloaded meanwhile
+   sf_lru_add(hw,s,1);
+   kx_lock_release(hw,&hw->sf_lock,&flags);
+   if(last)
+    kx_sf_stream_free(hw,stream);
+   continue;
+  }
+  slot->stream=stream;
+  slot->page=page;
+  slot->pins=0;
+  stream->slot[page]=s;
+
+  // map the page for the voices that are already playing it
+  for(int i=0;i<KX_NUMBER_OF_VOICES;i++)
+  {
+   kx_voice *v=&hw->voicetable[i];
+   if(v->sf_stream==stream && v->buffer.pageindex>=0 &&
+      page>=v->sf_stream_page && page-v->sf_stream_page<(dword)n_pages(v->buffer.size))
+   {
+    dword pageindex=v->buffer.pageindex+page-v->sf_stream_page;
+    ((dword *) hw->virtualpagetable.addr)[pageindex] = (physical << 1) | pageindex;
+    slot->pins++;
+   }
+  }
+  if(slot->pins==0)
+   sf_lru_add(hw,s,0);
+
+  kx_lock_release(hw,&hw->sf_lock,&flags);
+ }
+}
+
+static void kx_sf_stream_map(kx_hw *hw,int num,kx_sf_stream *stream,dword pages)
+{
+ kx_voice *v=&hw->voicetable[num];
+ int queue=0;
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->sf_lock,&flags);
+
+ // from now on, sf_stream_worker() maps the pages it loads for this voice, too
+ v->sf_stream=stream;
+
+ for(dword i=0;i<pages;i++)
+ {
+  dword page=v->sf_stream_page+i;
+
+  if(page<stream->n_pages && stream->resident_page[page]<0)
+  {
+   int s=stream->slot[page];
+   if(s>=0)
+   {
+    sf_pin(hw,s);
+    hw->sf_hits++;
+   }
+   else
+   {
+    hw->sf_misses++;
+    if(s==KX_SF_PAGE_ABSENT)
+     sf_fetch_queue(hw,stream,page);
+   }
+  }
+
+  dword physical=sf_page_physical(hw,stream,page);
+  dword pageindex=v->buffer.pageindex+i;
+  ((dword *) hw->virtualpagetable.addr)[pageindex] = (physical << 1) | pageindex;
+ }
+
+ if(hw->sf_fetch_count && !hw->sf_worker_queued)
+ {
+  hw->sf_worker_queued=1;
+  queue=1;
+ }
+
+ kx_lock_release(hw,&hw->sf_lock,&flags);
+
+ if(queue && hw->cb.queue_work(hw->cb.call_with,sf_stream_worker,hw))
+ {
+  // retried with the next note-on
+  kx_lock_acquire(hw,&hw->sf_lock,&flags);
+  hw->sf_worker_queued=0;
+  kx_lock_release(hw,&hw->sf_lock,&flags);
+ }
+}
+
+static void kx_sf_stream_unmap(kx_hw *hw,int num,dword pages)
+{
+ kx_voice *v=&hw->voicetable[num];
+ kx_sf_stream *stream=v->sf_stream;
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->sf_lock,&flags);
+
+ for(dword i=0;i<pages;i++)
+ {
+  dword page=v->sf_stream_page+i;
+  if(page<stream->n_pages && stream->resident_page[page]<0 && stream->slot[page]>=0)
+   sf_unpin(hw,stream->slot[page]);
+ }
+ v->sf_stream=NULL;
+
+ kx_lock_release(hw,&hw->sf_lock,&flags);
+}
+
+// size: bytes; 0: no streaming
+// cannot be changed while streamed SoundFonts are loaded
+int kx_sf_pool_init(kx_hw *hw,dword size)
+{
+ int pages=(int)(size/KX_PAGE_SIZE);
+
+ if(pages!=0 && pages<16)
+  pages=16;
+
+ if((dword)pages*KX_PAGE_SIZE==hw->sf_pool_size)
+  return 0;
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->sf_lock,&flags);
+
+ struct list *item;
+ for_each_list_entry(item, &hw->sf_index)
+ {
+  if(list_item(item, kx_sf_index, list)->stream)
+  {
+   kx_lock_release(hw,&hw->sf_lock,&flags);
+   debug(DLIB,"!! SoundFont pool: cannot be changed while streamed SoundFonts are loaded\n");
+   return -1;
+  }
+ }
+ kx_lock_release(hw,&hw->sf_lock,&flags);
+
+ kx_sf_pool_close(hw);
+
+ if(pages==0)
+  return 0;
+
+ if(!hw->cb.queue_work || !hw->cb.flush_work || !hw->cb.lmem_alloc_func)
+ {
+  debug(DLIB,"!! SoundFont pool: not supported\n");
+  return -2;
+ }
+
+ (hw->cb.malloc_func)(hw->cb.call_with,pages*sizeof(kx_sf_slot),(void **)&hw->sf_slots,KX_NONPAGED);
+ (hw->cb.malloc_func)(hw->cb.call_with,KX_SF_FETCH_QUEUE*sizeof(kx_sf_fetch),(void **)&hw->sf_fetch,KX_NONPAGED);
+ if(hw->sf_slots==NULL || hw->sf_fetch==NULL ||
+    (hw->cb.lmem_alloc_func)(hw->cb.call_with,pages*KX_PAGE_SIZE,&hw->sf_pool,KX_CACHED)!=0)
+ {
+  hw->sf_pool=NULL;
+  kx_sf_pool_close(hw);
+  debug(DLIB,"!! SoundFont pool: not enough memory (%d pages)\n",pages);
+  return -3;
+ }
+
+ hw->sf_lru_head=hw->sf_lru_tail=-1;
+ for(int i=0;i<pages;i++)
+ {
+  memset(&hw->sf_slots[i],0,sizeof(kx_sf_slot));
+  sf_lru_add(hw,i,1);
+ }
+ hw->sf_pool_slots=pages;
+ hw->sf_fetch_head=hw->sf_fetch_count=0;
+ hw->sf_pool_size=pages*KX_PAGE_SIZE;
+
+ debug(DLIB,"-- SoundFont pool: %d KB\n",hw->sf_pool_size/1024);
+
+ return 0;
+}
+
+void kx_sf_pool_close(kx_hw *hw)
+{
+ // the last fetch requests are cancelled by kx_sf_stream_destroy(); sf_stream_worker() may still run
+ if(hw->sf_pool && hw->cb.flush_work)
+  hw->cb.flush_work(hw->cb.call_with);
+
+ if(hw->sf_pool)
+  (hw->cb.lmem_free_func)(hw->cb.call_with,&hw->sf_pool);
+ if(hw->sf_slots)
+  (hw->cb.free_func)(hw->cb.call_with,hw->sf_slots);
+ if(hw->sf_fetch)
+  (hw->cb.free_func)(hw->cb.call_with,hw->sf_fetch);
+
+ hw->sf_pool=NULL;
+ hw->sf_slots=NULL;
+ hw->sf_fetch=NULL;
+ hw->sf_pool_slots=0;
+ hw->sf_pool_size=0;
+ hw->sf_fetch_count=0;
+}
+
+// returns 0 and *stream=NULL if the SoundFont is not streamed
+int kx_sf_stream_create(kx_hw *hw,kx_sound_font *sf,kx_sf_stream **stream)
+{
+ *stream=NULL;
+
+ if(hw->sf_pool==NULL)
+  return 0;
+
+ dword len=sf->header.sample_len+4;
+ dword pages=n_pages(len);
+
+ kx_sf_stream *st=NULL;
+ (hw->cb.malloc_func)(hw->cb.call_with,sizeof(kx_sf_stream)+pages*2*sizeof(int),(void **)&st,KX_NONPAGED);
+ if(st==NULL)
+  return -1;
+ memset(st,0,sizeof(kx_sf_stream));
+ st->n_pages=pages;
+ st->resident_page=(int *)(st+1);
+ st->slot=st->resident_page+pages;
+
+ // pageable: only read by sf_stream_worker() and kx_sf_stream_write()
+ // the OS layer commits the backing store as it is written (its pages are zero until then)
+ if(hw->cb.backing_alloc)
+ {
+  if((hw->cb.backing_alloc)(hw->cb.call_with,pages*KX_PAGE_SIZE,(void **)&st->backing,&st->backing_handle)!=0)
+   st->backing=NULL;
+ }
+ else
+ {
+  (hw->cb.malloc_func)(hw->cb.call_with,pages*KX_PAGE_SIZE,(void **)&st->backing,KX_PAGED);
+  if(st->backing)
+   memset(st->backing,0,pages*KX_PAGE_SIZE);
+ }
+ if(st->backing==NULL)
+ {
+  (hw->cb.free_func)(hw->cb.call_with,st);
+  return -1;
+ }
+
+ // resident pages: the beginning of each sample
+ int n_resident=0;
+ for(dword i=0;i<pages;i++)
+ {
+  st->resident_page[i]=-1;
+  st->slot[i]=KX_SF_PAGE_ABSENT;
+ }
+ for(int i=0;i<sf->header.samples;i++)
+ {
+  sfSample *smp=&sf->samples[i];
+  if(smp->start>smp->end || smp->end*2>=len)
+   continue;
+
+  dword from=smp->start*2;
+  dword to=smp->end*2;
+  if(to-from>=KX_SF_RESIDENT)
+   to=from+KX_SF_RESIDENT-1;
+
+  for(dword p=from/KX_PAGE_SIZE;p<=to/KX_PAGE_SIZE;p++)
+   if(st->resident_page[p]<0)
+    st->resident_page[p]=n_resident++;
+ }
+
+ if(n_resident &&
+    (hw->cb.lmem_alloc_func)(hw->cb.call_with,n_resident*KX_PAGE_SIZE,&st->resident,KX_CACHED)!=0)
+ {
+  kx_sf_stream_free(hw,st);
+  return -1;
+ }
+
+ debug(DLIB,"-- SoundFont stream: %d pages, %d resident\n",pages,n_resident);
+
+ *stream=st;
+ return 0;
+}
+
+void kx_sf_stream_free(kx_hw *hw,kx_sf_stream *stream)
+{
+ if(stream->resident)
+  (hw->cb.lmem_free_func)(hw->cb.call_with,&stream->resident);
+ if(stream->backing_handle)
+  (hw->cb.backing_free)(hw->cb.call_with,stream->backing,stream->backing_handle);
+ else
+  (hw->cb.free_func)(hw->cb.call_with,stream->backing);
+ (hw->cb.free_func)(hw->cb.call_with,stream);
+}
+
+// drops the reference taken with stream->busy++ before a copy made without sf_lock held;
+// sf_lock should be held
+// returns 1 if the stream was destroyed meanwhile: the caller frees it with kx_sf_stream_free()
+// after releasing the lock
+int kx_sf_stream_release(kx_hw *hw,kx_sf_stream *stream)
+{
+ return (--stream->busy==0 && stream->destroyed);
+}
+
+// the voices that play the stream should be stopped first
+// if pages of the stream are being copied (stream->busy), the last copy frees it
+void kx_sf_stream_destroy(kx_hw *hw,kx_sf_stream *stream)
+{
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->sf_lock,&flags);
+
+ for(int i=0;i<hw->sf_fetch_count;i++)
+ {
+  kx_sf_fetch *f=&hw->sf_fetch[(hw->sf_fetch_head+i)%KX_SF_FETCH_QUEUE];
+  if(f->stream==stream)
+   f->stream=NULL;
+ }
+ for(int i=0;i<hw->sf_pool_slots;i++)
+ {
+  kx_sf_slot *slot=&hw->sf_slots[i];
+  if(slot->stream==stream)
+  {
+   slot->stream=NULL;
+   if(slot->pins==0)
+   {
+    sf_lru_remove(hw,i);
+    sf_lru_add(hw,i,1);
+   }
+  }
+ }
+
+ int busy=stream->busy;
+ if(busy)
+  stream->destroyed=1;
+
+ kx_lock_release(hw,&hw->sf_lock,&flags);
+
+ if(!busy)
+  kx_sf_stream_free(hw,stream);
+}
+
+// pos, size: bytes of sample data (sf_load_sample_property)
+// called at PASSIVE_LEVEL, with stream->busy incremented
+int kx_sf_stream_write(kx_hw *hw,kx_sf_stream *stream,int pos,const void *data,int size)
+{
+ if(pos<0 || size<0 || (dword)(pos+size)>stream->n_pages*KX_PAGE_SIZE)
+  return -1;
+
+ memcpy(stream->backing+pos,data,size);
+
+ const byte *src=(const byte *)data;
+ while(size>0)
+ {
+  dword page=pos/KX_PAGE_SIZE;
+  int offset=pos%KX_PAGE_SIZE;
+  int n=KX_PAGE_SIZE-offset;
+  if(n>size)
+   n=size;
+
+  if(stream->resident_page[page]>=0)
+   memcpy((byte *)hw->cb.lmem_get_addr_func(hw->cb.call_with,&stream->resident,
+     stream->resident_page[page]*KX_PAGE_SIZE+offset,NULL),src,n);
+  else
+  if(stream->slot[page]>=0)
+  {
+   // already in the pool (a note was played while loading)
+   unsigned long flags=0;
+   kx_lock_acquire(hw,&hw->sf_lock,&flags);
+   if(stream->slot[page]>=0)
+    memcpy((byte *)sf_pool_addr(hw,stream->slot[page],NULL)+offset,src,n);
+   kx_lock_release(hw,&hw->sf_lock,&flags);
+  }
+
+  pos+=n;
+  src+=n;
+  size-=n;
+ }
+ return 0;
+}
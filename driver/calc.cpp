@@ -93,7 +93,7 @@ dword kx_samplerate_to_linearpitch(dword samplingrate)
 
 // param is controlled using KX_MAX_VOLUME.KX_MIN_VOLUME
 // ret is from 0 to max linear
-dword calc_volume(kx_hw *hw,dword value,dword max)
+dword calc_volume(dword value,dword max)
 {
     // 0x80000000 - DSound/WDM mute
     if(value==0x80000000U || value==KX_MIN_VOLUME)
@@ -111,16 +111,11 @@ dword calc_volume(kx_hw *hw,dword value,dword max)
            if((int)value>(int)KX_MAX_VOLUME)
              value=(dword)KX_MAX_VOLUME;
 
-           kx_fpu_state state;
-           hw->cb.save_fpu_state(&state);
-
-           // val=10^((val/0x10000)/20);
+           // val=10^((val/0x10000)/20); fixed point: no FPU state to save
            if(max!=0x80000000) // pre-3543
-            value=(dword)(kx_pow10((((double)(int)value)*(7.62939453125e-7)))*(double)max);
+            value=kx_fixed_db((int)value,max);
            else // 3543
-            value=(dword)(int)(-kx_pow10((((double)(int)value)*(7.62939453125e-7)))*(double)max);
-
-           hw->cb.rest_fpu_state(&state);
+            value=0-kx_fixed_db((int)value,max);
     }
     return value;
 }
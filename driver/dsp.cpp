@@ -20,6 +20,7 @@
 
 
 #include "kx.h"
+#include "driver/dspindex.h"
 
 #define is_valid_gpr(a) ( ((a)!=DSP_REG_NOT_TRANSLATED) && ((a)>=E10K1_GPR_BASE) && ((a)<hw->first_instruction) )
 #define is_register(a) (a&0xd000)
@@ -36,6 +37,8 @@
 #define TRAM_ALIGN	0x2000
 
 inline int upload_instruction(kx_hw *hw,dsp_microcode *m,int i);
+static void upload_output_instructions(kx_hw *hw,dsp_microcode *m);
+static void telemetry_drop_unloaded(kx_hw *hw);
 
 inline int e10k1_IntWriteAlignBit( int instr, int tbuffer ) {
     return (((instr)>=((tbuffer)*3))?1:0);
@@ -169,8 +172,59 @@ char *strstr(const char *str1, const char *str2)
 dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,word id,dsp_microcode **out_m=NULL);
 dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,const char *name,dsp_microcode **out_m=NULL);
 
+// register index: built in kx_load_microcode() / kx_update_microcode(), freed in kx_unload_microcode()
+// the index is ignored if m->info[] or m->code[] was replaced after it was built: the register lookups
+// then use linear search, upload_instruction() fails
+// operands are kept as info[] indices, so connect / disconnect (which only change info[].translated)
+// do not invalidate it
+static inline kx_register_index *get_register_index(kx_hw *hw,dsp_microcode *m)
+{
+   if(m->pgm<=0 || m->pgm>=MAX_PGM_NUMBER)
+    return NULL;
+   kx_register_index *idx=hw->pgm_index[m->pgm];
+   if(idx && idx->info==m->info && idx->n==m->info_size/sizeof(dsp_register_info) &&
+      idx->code==m->code && idx->n_code==m->code_size/sizeof(dsp_code))
+    return idx;
+   return NULL;
+}
+
+// called without dsp_lock held: the index is built first and then swapped in under the lock
+static int build_register_index(kx_hw *hw,dsp_microcode *m)
+{
+   if(m->pgm<=0 || m->pgm>=MAX_PGM_NUMBER)
+    return -1;
+
+   kx_register_index *idx=NULL;
+   dword n=m->info_size/sizeof(dsp_register_info);
+   dword n_code=m->code_size/sizeof(dsp_code);
+   word base[KX_INDEX_NUM_GROUPS],span[KX_INDEX_NUM_GROUPS];
+   dword size=kx_register_index_size(m->info,n,n_code,base,span);
+
+   // also without registers: upload_instruction() takes the operands from the index
+   (hw->cb.malloc_func)(hw->cb.call_with,size,(void **)&idx,KX_NONPAGED);
+   if(idx)
+    kx_register_index_build(idx,m->info,n,m->code,n_code);
+   else
+    debug(DLIB,"!! not enough memory for register index [%d]\n",m->pgm);
+
+   unsigned long flags=0;
+   kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+   kx_register_index *old=hw->pgm_index[m->pgm];
+   hw->pgm_index[m->pgm]=idx;
+   kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+   if(old)
+    (hw->cb.free_func)(hw->cb.call_with,old);
+
+   return idx?0:-1;
+}
+
 inline dsp_register_info *find_dsp_register_in_m(kx_hw *hw,dsp_microcode *m,word id)
 {
+   kx_register_index *idx=get_register_index(hw,m);
+   if(idx)
+    return kx_register_index_find(idx,id);
+
    for(dword i=0;i<m->info_size/sizeof(dsp_register_info);i++)
    	if(m->info[i].num==id)
    		return &m->info[i];
@@ -179,17 +233,197 @@ inline dsp_register_info *find_dsp_register_in_m(kx_hw *hw,dsp_microcode *m,word
 
 inline dsp_register_info *find_dsp_register_in_m(kx_hw *hw,dsp_microcode *m,const char *name)
 {
+   kx_register_index *idx=get_register_index(hw,m);
+   if(idx)
+    return kx_register_index_find(idx,name);
+
    for(dword i=0;i<m->info_size/sizeof(dsp_register_info);i++)
- 	if(strncmp(name,&m->info[i].name[0],MAX_GPR_NAME)==NULL)
+ 	if(strncmp(name,&m->info[i].name[0],MAX_GPR_NAME)==0)
    		return &m->info[i];
    return NULL;
 }
 
+static inline dsp_microcode *find_microcode(kx_hw *hw,int pgm)
+{
+   if(pgm<=0 || pgm>=MAX_PGM_NUMBER)
+    return NULL;
+   return hw->pgm_map[pgm];
+}
+
+// -----
+// DSP transactions (see kx_dsp_begin() / kx_dsp_commit() / kx_dsp_abort())
+// -----
+// while a transaction is pending, instruction uploads made by its owner go to a shadow copy of the
+// instruction memory and its writes to registers the running microcode owns are queued; resources
+// released within the transaction stay allocated until commit, so that new microcode is built in the
+// memory the running graph does not use
+// the owner is the client (file object / user client) that called kx_dsp_begin(); the OS layer brackets
+// every client request with kx_dsp_enter() / kx_dsp_leave(), so the requests of the owner are known by
+// the thread issuing them: register writes of other clients and of the driver itself go to the
+// hardware, and their microcode changes fail with -12 until the transaction ends
+
+#define KX_DSP_TXN_REGS 0x600           // register address space below the 10k2 instruction memory
+#define KX_DSP_TXN_TIMEOUT 10000        // ms without a request of the owner
+
+typedef struct
+{
+ word op,z,w,x,y;
+}kx_txn_instruction;
+
+typedef struct
+{
+ dsp_microcode *m;
+ dword flag;
+ int offset;
+ int itram_start,xtram_start;
+ word *translated;              // info[].translated
+}kx_txn_microcode;
+
+typedef struct kx_dsp_txn_t
+{
+ void *owner;                   // client of kx_dsp_begin()
+ void *thread;                  // thread of the owner's request in progress (kx_dsp_enter()) or NULL
+ dword touched;                 // txn_clock() at the owner's last request
+
+ dword regs_live[FX_REGISTER_MASSIVE_SIZE];         // fx_regs_usage at kx_dsp_begin()
+ dword microcode_live[FX_MICROCODE_MASSIVE_SIZE];   // fx_microcode_usage at kx_dsp_begin()
+ dword regs_free[FX_REGISTER_MASSIVE_SIZE];         // released within the transaction
+ dword microcode_free[FX_MICROCODE_MASSIVE_SIZE];
+ dword dirty[FX_MICROCODE_MASSIVE_SIZE];            // code[] entries not uploaded yet
+ kx_txn_instruction code[E10K2_MAX_INSTRUCTIONS];   // shadow instruction memory
+
+ // queued register writes, one per register (the last one wins)
+ dword reg_val[KX_DSP_TXN_REGS];
+ dword reg_queued[KX_DSP_TXN_REGS/32];
+ int n_regs;
+
+ kx_txn_microcode saved[MAX_PGM_NUMBER];            // microcode list at kx_dsp_begin(), in list order
+ int n_saved;
+ word *translated;              // saved[].translated storage
+ struct list unloaded;          // unloaded within the transaction; freed on commit
+}kx_dsp_txn;
+
+// the caller is the owner of the pending transaction; called with dsp_lock held
+static inline kx_dsp_txn *txn_of_caller(kx_hw *hw)
+{
+ kx_dsp_txn *txn=hw->dsp_txn;
+ if(txn && txn->thread && txn->thread==kx_current_thread())
+  return txn;
+ return NULL;
+}
+
+// GPR / TRAM data register allocated after kx_dsp_begin(): the running microcode does not use it
+static inline int is_fresh_register(kx_hw *hw,kx_dsp_txn *txn,word reg)
+{
+ int bit;
+ if(!is_valid_gpr(reg))
+  return 0;
+ if(reg>=0x200 && reg<0x300)        // TRAM data
+  bit=reg-0x100;
+ else if(hw->is_10k2 && reg>=0x400) // 10k2 GPR
+  bit=reg-0x200;
+ else if(!hw->is_10k2 && reg<0x200) // 10k1 GPR
+  bit=reg-0x100;
+ else                               // TRAM address / 10k2 TRAM control
+  return 0;
+ return get_bit(txn->regs_live,bit)?0:1;
+}
+
+// hwOP() or, for the owner of a transaction, the shadow copy
+static inline void write_instruction(kx_hw *hw,int at,word op,word z,word w,word x,word y)
+{
+ kx_dsp_txn *txn=txn_of_caller(hw);
+ if(txn)
+ {
+  kx_txn_instruction *i=&txn->code[at];
+  i->op=op; i->z=z; i->w=w; i->x=x; i->y=y;
+  set_bit(txn->dirty,at);
+ }
+ else
+  hwOP(at,op,z,w,x,y);
+}
+
+// kx_writeptr() or, for registers of the running microcode written by the owner of a transaction,
+// the commit queue
+// should be called with dsp_lock held
+static inline void write_dsp_register(kx_hw *hw,word reg,dword val)
+{
+ kx_dsp_txn *txn=txn_of_caller(hw);
+ if(txn && reg<KX_DSP_TXN_REGS && !is_fresh_register(hw,txn,reg))
+ {
+  if(!get_bit(txn->reg_queued,reg))
+  {
+   set_bit(txn->reg_queued,reg);
+   txn->n_regs++;
+  }
+  txn->reg_val[reg]=val;
+ }
+ else
+  kx_writeptr(hw,reg,0,val);
+}
+
+// kx_readptr() or, for the owner of a transaction, its queued write of the register
+// should be called with dsp_lock held
+static inline int queued_dsp_register(kx_hw *hw,word reg,dword *val)
+{
+ kx_dsp_txn *txn=txn_of_caller(hw);
+ if(txn && reg<KX_DSP_TXN_REGS && get_bit(txn->reg_queued,reg))
+ {
+  *val=txn->reg_val[reg];
+  return 1;
+ }
+ return 0;
+}
+
+static inline dword read_dsp_register(kx_hw *hw,word reg)
+{
+ dword val;
+ if(queued_dsp_register(hw,reg,&val))
+  return val;
+ return kx_readptr(hw,reg,0);
+}
+
+static void txn_abort(kx_hw *hw,unsigned long *flags);
+
+// ms; kx_voice_clock() only advances while the system timer runs (a MIDI port is open),
+// so the OS clock is used where the OS layer provides one
+static inline dword txn_clock(kx_hw *hw)
+{
+ if(hw->cb.time_ms)
+  return hw->cb.time_ms(hw->cb.call_with);
+ return kx_voice_clock(hw)/(hw->card_frequency/1000);
+}
+
+// microcode changes: fail while another client's transaction is pending (-12);
+// a transaction the owner has left alone for KX_DSP_TXN_TIMEOUT is aborted here
+static int txn_busy(kx_hw *hw)
+{
+ dword now=txn_clock(hw);
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ kx_dsp_txn *txn=hw->dsp_txn;
+ if(txn==NULL || txn_of_caller(hw))
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  return 0;
+ }
+ if(txn->thread || now-txn->touched<KX_DSP_TXN_TIMEOUT)
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  debug(DLIB,"!! dsp: a transaction of another client is pending\n");
+  return -12;
+ }
+
+ debug(DLIB,"!! dsp: transaction timed out; rolled back\n");
+ txn_abort(hw,&flags);
+ return 0;
+}
+
 // returns 0 if not found
 dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,word id,dsp_microcode **out_m)
 {
-  struct list *item;
-
   if(!(hw->initialized&KX_DSP_INITED))
   {
    debug(DLIB,"EFX find_dsp() w/o being initialized\n");
@@ -199,16 +433,9 @@ dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,word id,dsp_microcode
   unsigned long flags=0;
   kx_lock_acquire(hw,&hw->dsp_lock, &flags);
 
- int pgm=pgm_id;
-
-  for_each_list_entry(item, &hw->microcodes) 
+  dsp_microcode *m=find_microcode(hw,pgm_id);
+  if(m)
   {
-  	dsp_microcode *m;
-        m = list_item(item, dsp_microcode, list);
-        if(!m)
-         continue;
-        if(m->pgm!=pgm)
-          continue;
         // found pgm; search through info
         dsp_register_info *ret;
         ret=find_dsp_register_in_m(hw,m,id);
@@ -219,7 +446,6 @@ dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,word id,dsp_microcode
                  *out_m=m;
              return ret;
         }
-        break;
   }
 
   kx_lock_release(hw,&hw->dsp_lock,&flags);
@@ -229,8 +455,6 @@ dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,word id,dsp_microcode
 
 dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,const char *name,dsp_microcode **out_m)
 {
-  struct list *item;
-
   if(!(hw->initialized&KX_DSP_INITED))
   {
    debug(DLIB,"EFX find_dsp() w/o being initialized\n");
@@ -240,16 +464,9 @@ dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,const char *name,dsp_m
   unsigned long flags=0;
   kx_lock_acquire(hw,&hw->dsp_lock, &flags);
 
- int pgm=pgm_id;
-
-  for_each_list_entry(item, &hw->microcodes) 
+  dsp_microcode *m=find_microcode(hw,pgm_id);
+  if(m)
   {
-  	dsp_microcode *m;
-        m = list_item(item, dsp_microcode, list);
-        if(!m)
-         continue;
-        if(m->pgm!=pgm)
-         continue;
         // found pgm; search through info
         dsp_register_info *ret;
         ret=find_dsp_register_in_m(hw,m,name);
@@ -260,7 +477,6 @@ dsp_register_info *find_dsp_register(kx_hw *hw,int pgm_id,const char *name,dsp_m
                    *out_m=m;
        		return ret;
         }
-        break;
   }
 
   kx_lock_release(hw,&hw->dsp_lock,&flags);
@@ -278,7 +494,11 @@ KX_API(int,kx_set_dsp_register(kx_hw *hw,int pgm,const char *name,dword val))
  	info->p=val;
  	if(is_valid_gpr(info->translated))
  	{
- 	 kx_writeptr(hw,info->translated,0,val);
+ 	 // hw->dsp_txn
+ 	 unsigned long flags=0;
+ 	 kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ 	 write_dsp_register(hw,info->translated,val);
+ 	 kx_lock_release(hw,&hw->dsp_lock,&flags);
  	}
  	return 0;
  }
@@ -295,7 +515,10 @@ KX_API(int,kx_get_dsp_register(kx_hw *hw,int pgm,const char *name,dword *val))
  	*val=info->p;
  	if(is_valid_gpr(info->translated))
  	{
- 	 *val=kx_readptr(hw,info->translated,0);
+ 	 unsigned long flags=0;
+ 	 kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ 	 *val=read_dsp_register(hw,info->translated);
+ 	 kx_lock_release(hw,&hw->dsp_lock,&flags);
  	}
  	return 0;
  }
@@ -312,7 +535,11 @@ KX_API(int,kx_set_dsp_register(kx_hw *hw,int pgm,word id,dword val))
  	info->p=val;
  	if(is_valid_gpr(info->translated))
  	{
- 	 kx_writeptr(hw,info->translated,0,val);
+ 	 // hw->dsp_txn
+ 	 unsigned long flags=0;
+ 	 kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ 	 write_dsp_register(hw,info->translated,val);
+ 	 kx_lock_release(hw,&hw->dsp_lock,&flags);
  	}
  	return 0;
  }
@@ -329,7 +556,10 @@ KX_API(int,kx_get_dsp_register(kx_hw *hw,int pgm,word id,dword *val))
  	*val=info->p;
  	if(is_valid_gpr(info->translated))
  	{
- 	 *val=kx_readptr(hw,info->translated,0);
+ 	 unsigned long flags=0;
+ 	 kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ 	 *val=read_dsp_register(hw,info->translated);
+ 	 kx_lock_release(hw,&hw->dsp_lock,&flags);
  	}
  	return 0;
  }
@@ -337,6 +567,130 @@ KX_API(int,kx_get_dsp_register(kx_hw *hw,int pgm,word id,dword *val))
  return -1;
 }
 
+// vectored kx_set/get_dsp_register(): the microcode is looked up and dsp_lock / hw_lock are taken once
+#define KX_REG_BURST 32
+
+static inline dsp_register_info *find_reg_update(kx_hw *hw,dsp_microcode *m,const kx_reg_update *r)
+{
+ if(r->name[0])
+  return find_dsp_register_in_m(hw,m,r->name);
+ return find_dsp_register_in_m(hw,m,r->id);
+}
+
+KX_API(int,kx_set_dsp_registers(kx_hw *hw,int pgm,const kx_reg_update *regs,int n))
+{
+ if(!(hw->initialized&KX_DSP_INITED))
+ {
+  debug(DLIB,"EFX set_dsp_registers() w/o being initialized\n");
+  return -5;
+ }
+
+ dword burst[KX_REG_BURST*2];
+ int cnt=0,missing=0;
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ dsp_microcode *m=find_microcode(hw,pgm);
+ if(!m)
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  debug(DLIB,"!! set_dsp_registers: no microcode [%d]\n",pgm);
+  return -1;
+ }
+
+ for(int i=0;i<n;i++)
+ {
+  dsp_register_info *info=find_reg_update(hw,m,&regs[i]);
+  if(!info)
+  {
+   missing++;
+   continue;
+  }
+  info->p=regs[i].val;
+  if(!is_valid_gpr(info->translated))
+   continue;
+  if(txn_of_caller(hw))
+  {
+   write_dsp_register(hw,info->translated,regs[i].val);
+   continue;
+  }
+  burst[cnt*2]=info->translated;
+  burst[cnt*2+1]=regs[i].val;
+  if(++cnt==KX_REG_BURST)
+  {
+   kx_writeptr_list(hw,0,burst,cnt);
+   cnt=0;
+  }
+ }
+ if(cnt)
+  kx_writeptr_list(hw,0,burst,cnt);
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+ if(missing)
+  debug(DLIB,"!! set_dsp_registers: %d of %d registers not found [%d]\n",missing,n,pgm);
+ return missing;
+}
+
+KX_API(int,kx_get_dsp_registers(kx_hw *hw,int pgm,kx_reg_update *regs,int n))
+{
+ if(!(hw->initialized&KX_DSP_INITED))
+ {
+  debug(DLIB,"EFX get_dsp_registers() w/o being initialized\n");
+  return -5;
+ }
+
+ dword burst[KX_REG_BURST],vals[KX_REG_BURST];
+ int idx[KX_REG_BURST];
+ int cnt=0,missing=0;
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ dsp_microcode *m=find_microcode(hw,pgm);
+ if(!m)
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  debug(DLIB,"!! get_dsp_registers: no microcode [%d]\n",pgm);
+  return -1;
+ }
+
+ for(int i=0;i<n;i++)
+ {
+  dsp_register_info *info=find_reg_update(hw,m,&regs[i]);
+  if(!info)
+  {
+   missing++;
+   continue;
+  }
+  regs[i].val=info->p;
+  if(!is_valid_gpr(info->translated))
+   continue;
+  if(queued_dsp_register(hw,info->translated,&regs[i].val))
+   continue;
+  burst[cnt]=info->translated;
+  idx[cnt]=i;
+  if(++cnt==KX_REG_BURST)
+  {
+   kx_readptr_list(hw,0,burst,vals,cnt);
+   for(int j=0;j<cnt;j++)
+    regs[idx[j]].val=vals[j];
+   cnt=0;
+  }
+ }
+ if(cnt)
+ {
+  kx_readptr_list(hw,0,burst,vals,cnt);
+  for(int j=0;j<cnt;j++)
+   regs[idx[j]].val=vals[j];
+ }
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+ return missing;
+}
+
 static int get_tram_addr(kx_hw *hw,dsp_microcode *m,dsp_register_info *info,dword *addr)
 {
  	*addr=info->p;
@@ -535,7 +889,7 @@ static int set_tram_flag(kx_hw *hw,dsp_microcode *m,dsp_register_info *info,dwor
  	return 0;
 }
 
-static int get_tram_flag(kx_hw *hw,dsp_microcode *m,dsp_register_info *info,dword *flag)
+static int get_tram_flag(kx_hw *hw,dsp_register_info *info,dword *flag)
 {
  	if(is_valid_gpr(info->translated))
  	{
@@ -620,7 +974,7 @@ KX_API(int,kx_get_tram_flag(kx_hw *hw,int pgm,const char *name,dword *flag))
  
  if(info)
  {
- 	return get_tram_flag(hw,m,info,flag);
+ 	return get_tram_flag(hw,info,flag);
  }
  debug(DLIB,"!! get_tram_flag failed\n");
  return -1;
@@ -686,7 +1040,7 @@ KX_API(int,kx_get_tram_flag(kx_hw *hw,int pgm,word id,dword *flag))
  
  if(info)
  {
- 	return get_tram_flag(hw,m,info,flag);
+ 	return get_tram_flag(hw,info,flag);
  }
  debug(DLIB,"!! get_tram_flag failed\n");
  return -1;
@@ -707,6 +1061,9 @@ KX_API(int,kx_set_tram_flag(kx_hw *hw,int pgm,word id,dword flag))
 
 KX_API(int,kx_write_instruction(kx_hw *hw,int pgm,int offset,word op,word r,word a,word x,word y,int valid))
 {
+  if(txn_busy(hw))
+   return -12;
+
   struct list *item;
 
   unsigned long flags=0;
@@ -732,6 +1089,10 @@ KX_API(int,kx_write_instruction(kx_hw *hw,int pgm,int offset,word op,word r,word
             if(valid&VALID_R) m->code[offset].r=r;
             if(valid&VALID_A) m->code[offset].a=a;
 
+            kx_register_index *idx=get_register_index(hw,m);
+            if(idx && (dword)offset<idx->n_code)
+             kx_register_index_resolve(idx,offset);
+
             if(m->flag&MICROCODE_TRANSLATED)
              upload_instruction(hw,m,offset);
 
@@ -823,22 +1184,22 @@ static inline void check_const(kx_hw *hw,word &a)
     else
      if(a==KX_IN(7)) // 7
       a=KX_IN(5); // 5
+     else
+      if(a==KX_IN(4)) // 4
+       a=KX_IN(6); // 6
       else
-       if(a==KX_IN(4)) // 4
-        a=KX_IN(6); // 6
-       else
-        if(a==KX_IN(5)) // 5
-         a=KX_IN(7); // 7
+       if(a==KX_IN(5)) // 5
+        a=KX_IN(7); // 7
 
-     if(a>=KX_IN(0) && a<=KX_IN(0xe))
-     {
-      a=a-KX_IN(0)+0x40;
-     }
-     else
-     {
-    	 debug(DLIB,"Unknown 10k2 input (%x)\n",a);
-    	 a=0xc0;
-     }
+    if(a>=KX_IN(0) && a<=KX_IN(0xe))
+    {
+     a=a-KX_IN(0)+0x40;
+    }
+    else
+    {
+     debug(DLIB,"Unknown 10k2 input (%x)\n",a);
+     a=0xc0;
+    }
    }
   }
   else
@@ -1082,12 +1443,12 @@ static inline void check_const(kx_hw *hw,word &a)
 KX_API(int,kx_set_volume(kx_hw *hw,int pgm_id,word reg,dword val,dword max))
 {
 	if(pgm_id!=-1)
-         if(kx_set_dsp_register(hw,pgm_id,reg,calc_volume(hw,val,max)))
+         if(kx_set_dsp_register(hw,pgm_id,reg,calc_volume(val,max)))
          {
            debug(DLIB,"!!! Control not found in kx_set_volume() (%x; pgm_id=%x)\n",reg,pgm_id);
            return -5;
          }
-         return 0;
+	return 0;
 }
 
 KX_API(int,kx_set_volume(kx_hw *hw,const char *pgm_id,const char *name,dword val,dword max))
@@ -1103,10 +1464,10 @@ KX_API(int,kx_set_volume(kx_hw *hw,const char *pgm_id,const char *name,dword val
         m = list_item(item, dsp_microcode, list);
         if(!m)
          continue;
-        if(strncmp(m->name,pgm_id,KX_MAX_STRING)==NULL)
+        if(strncmp(m->name,pgm_id,KX_MAX_STRING)==0)
         {
          kx_lock_release(hw,&hw->dsp_lock,&flags);
-         if(kx_set_dsp_register(hw,m->pgm,name,calc_volume(hw,val,max)))
+         if(kx_set_dsp_register(hw,m->pgm,name,calc_volume(val,max)))
          {
            debug(DLIB,"!!! Control not found in kx_set_volume() (%s; id=%s)\n",name,pgm_id);
            return -5;
@@ -1119,171 +1480,96 @@ KX_API(int,kx_set_volume(kx_hw *hw,const char *pgm_id,const char *name,dword val
  return 0;
 }
 
-inline int upload_instruction(kx_hw *hw,dsp_microcode *m,int i)
+// operands and the bypass input are taken from the register index
+static inline int upload_resolved_instruction(kx_hw *hw,dsp_microcode *m,kx_register_index *idx,int i)
 {
-   word z,w,x,y;
-   dsp_register_info *tmp;
-   int have_outputs=0;
+   word ops[4];
+   const word *e=&idx->operands[i*4];
+   const word *src[4]={ &m->code[i].r, &m->code[i].a, &m->code[i].x, &m->code[i].y };
 
-   if(!(m->flag&MICROCODE_TRANSLATED))
+   for(int o=0;o<4;o++)
    {
-    debug(DLIB,"!!! uploading not-uploaded microcode [%x]\n",m->pgm);
-    return -1;
+    if(e[o]==KX_OPERAND_LITERAL)
+     ops[o]=*src[o];
+    else
+    {
+     if(e[o]==KX_OPERAND_INVALID || m->info[e[o]].translated==DSP_REG_NOT_TRANSLATED)
+     {
+      debug(DLIB,"!! Internal error %d in upload() %x\n",o+1,e[o]==KX_OPERAND_INVALID?0xdeadbeef:m->info[e[o]].translated);
+      return -1;
+     }
+     ops[o]=m->info[e[o]].translated;
+    }
    }
 
-   if(is_register(m->code[i].r))
+   if(m->offset==DSP_MICROCODE_NOT_TRANSLATED)
    {
-      tmp=find_dsp_register_in_m(hw,m,m->code[i].r);
-      if(!tmp || (tmp->translated==DSP_REG_NOT_TRANSLATED)) { debug(DLIB,"!! Internal error 1 in upload() %x\n",tmp?tmp->translated:0xdeadbeef); return -1; }
-      z=tmp->translated;
-      if((tmp->type&GPR_MASK)==GPR_OUTPUT)
-      {
-        have_outputs|=1;
-      }
+    debug(DLIB,"!! internal error II in upload()\n");
+    return -2;
    }
-   else z=m->code[i].r;
 
-   if(is_register(m->code[i].a))
-   {
-       tmp=find_dsp_register_in_m(hw,m,m->code[i].a);
-       if(!tmp || (tmp->translated==DSP_REG_NOT_TRANSLATED)) { debug(DLIB,"!! Internal error 2 in upload() %x\n",tmp?tmp->translated:0xdeadbeef); return -1; }
-       w=tmp->translated;
-       if((tmp->type&GPR_MASK)==GPR_OUTPUT)
-       {
-         have_outputs|=2;
-       }
-   }
-   else w=m->code[i].a;
+   word operation=m->code[i].op;
 
-   if(is_register(m->code[i].x))
+   // 'bypass' / 'mute': 'any_op out, a, b, c' -> 'macs out, in, 0, 0' / 'macs out, 0, 0, 0'
+   if(((m->flag&MICROCODE_BYPASS)||(!(m->flag&MICROCODE_ENABLED))) && (idx->op_flags[i]&KX_OPERAND_R_OUTPUT))
    {
-       tmp=find_dsp_register_in_m(hw,m,m->code[i].x);
-       if(!tmp || (tmp->translated==DSP_REG_NOT_TRANSLATED)) { debug(DLIB,"!! Internal error 3 in upload() %x\n",tmp?tmp->translated:0xdeadbeef); return -1; }
-       x=tmp->translated;
-       if((tmp->type&GPR_MASK)==GPR_OUTPUT)
-       {
-         have_outputs|=4;
-       }
-   }
-   else x=m->code[i].x;
+    operation=MACS;
+    ops[1]=C_0;
+    ops[2]=C_0;
+    ops[3]=C_0;
 
-   if(is_register(m->code[i].y))
-   {
-        tmp=find_dsp_register_in_m(hw,m,m->code[i].y);
-        if(!tmp || (tmp->translated==DSP_REG_NOT_TRANSLATED)) { debug(DLIB,"!! Internal error 4 in upload() %x\n",tmp?tmp->translated:0xdeadbeef); return -1; }
-        y=tmp->translated;
-        if((tmp->type&GPR_MASK)==GPR_OUTPUT)
-        {
-          have_outputs|=8;
-        }
+    if(m->flag&MICROCODE_BYPASS)
+    {
+     word in=idx->bypass_input[e[0]];
+     if(in!=KX_OPERAND_INVALID)
+      ops[1]=m->info[in].translated;
+     else
+      debug(DLIB,"note: bypass incorrect: no inputs [%d]\n",m->pgm);
+    }
    }
-   else y=m->code[i].y;
-
-   if(m->offset!=DSP_MICROCODE_NOT_TRANSLATED)
-   {
-   	word operation=m->code[i].op;
-
-        // perform some 'bypass' / 'mute' stuff here
-        // transform 'any_op out, a, b, c' -> 'macs out, in, 0, 0'
-        // transform 'any_op out, a, b, c' -> 'macs out, 0, 0, 0'
-        if((m->flag&MICROCODE_BYPASS)||(!(m->flag&MICROCODE_ENABLED)))
-        {
-         if(have_outputs&1) // only 'z' operand is interesting for us...
-         {
-          operation=MACS;
-          w=C_0; // just in case...
-          x=C_0;
-          y=C_0;
-
-          if(m->flag&MICROCODE_BYPASS) // bypass
-          {
-           // search for the corresponding input...
-           // UNEFFICIENT code FIXME
-           int n_outs=0,n_ins=0;
-           int this_out=-1;
-
-           for(dword j=0;j<m->info_size/sizeof(dsp_register_info);j++)
-           {
-            if((m->info[j].type&GPR_MASK)==GPR_OUTPUT)
-            {
-             n_outs++;
-             if(z==m->info[j].translated)
-              this_out=n_outs;
-            }
-            if((m->info[j].type&GPR_MASK)==GPR_INPUT)
-             n_ins++;
-           }
-		   
-           if((n_outs>0) && (n_ins>0))
-           {
-            if(this_out>0)
-            {
-             // this_out is the number of the output; let it be the # of the input, too :)
-             while(this_out>n_ins)
-              this_out-=n_ins;
-
-             n_ins=0;
 
-             for(int j=0;(size_t)j<m->info_size/sizeof(dsp_register_info);j++)
-             {
-              if((m->info[j].type&GPR_MASK)==GPR_INPUT)
-              {
-               n_ins++;
-               if(n_ins==this_out) // found
-               {
-                w=m->info[j].translated;
-                break;
-               }
-              }
-             }
-             if(w==C_0)
-              debug(DLIB,"!! internal error: empty input_gpr list. strange [%d]\n",m->pgm);
+   for(int o=0;o<4;o++)
+    check_const(hw,ops[o]);
 
-            } else debug(DLIB,"!! internal error in bypass/upload_instr() [pgm=%d]\n",m->pgm);
-           } else debug(DLIB,"note: bypass incorrect (ins: %d outs: %d)\n",n_ins,n_outs);
-          } // for bypass
-         } // output is 'z'
-        } // special cases?..
+   write_instruction(hw,i+m->offset,operation,ops[0],ops[1],ops[2],ops[3]);
 
-   	check_const(hw,z);
-        check_const(hw,w);
-        check_const(hw,x);
-        check_const(hw,y);
+   return 0;
+}
 
-   	hwOP(i+m->offset,operation,z,w,x,y);
+inline int upload_instruction(kx_hw *hw,dsp_microcode *m,int i)
+{
+   if(!(m->flag&MICROCODE_TRANSLATED))
+   {
+    debug(DLIB,"!!! uploading not-uploaded microcode [%x]\n",m->pgm);
+    return -1;
    }
-   else
+
+   // every loaded microcode has an index: see kx_load_microcode()
+   kx_register_index *idx=get_register_index(hw,m);
+   if(idx==NULL)
    {
-    debug(DLIB,"!! internal error II in upload()\n");
-    return -2;
+    debug(DLIB,"!! internal error: no register index in upload() [%d]\n",m->pgm);
+    return -1;
    }
 
-   return 0;
+   return upload_resolved_instruction(hw,m,idx,i);
 }
 
-inline int allocate_register(kx_hw *hw,dsp_microcode *m,int reg)
+// fx_regs_usage bit range [from,to) for the given register type
+static void get_register_pool(kx_hw *hw,dword type,int *from,int *to)
 {
- if((m->info[reg].type&GPR_MASK)==GPR_INPUT ||
-    (m->info[reg].type&GPR_MASK)==GPR_TRAMA)
- {
- 	debug(DERR,"!!! (internal error):: allocate_register() :: input??\n");
- 	return -21;
- }
-
- int from,to;
-
  // 0x100-0x1ff - TRAM flags
 
  // 10k2 GPRs: 0x400-0x5ff (-0x200 (!))
  if(hw->is_10k2)
  {
-  from=0x200/32; // linked
-  to=from+0x200/32;
+  *from=0x200; // linked
+  *to=*from+0x200;
  }
  else // GPR: 0x100.0x1ff (-0x100)
  {
-  from=0;
-  to=0x100/32; 
+  *from=0;
+  *to=0x100;
  }
 
  // internal TRAM: 0x200.0x27f (128 locations); (-0x100); 10k2: 192 locations
@@ -1295,34 +1581,40 @@ inline int allocate_register(kx_hw *hw,dsp_microcode *m,int reg)
   xtram_count=64;
  }
 
- if((m->info[reg].type&GPR_MASK)==GPR_ITRAM)
+ if((type&GPR_MASK)==GPR_ITRAM)
  {
-  from=0x100/32;
-  to=from+xtram_off/32;
+  *from=0x100;
+  *to=*from+xtram_off;
  }
 
  // external TRAM: 0x280..0x29f (32 locations); (-0x100); 10k2: 64 locations
- if((m->info[reg].type&GPR_MASK)==GPR_XTRAM)
+ if((type&GPR_MASK)==GPR_XTRAM)
  {
-  from=0x100/32+xtram_off/32;
-  to=from+xtram_count/32;
+  *from=0x100+xtram_off;
+  *to=*from+xtram_count;
  }
+}
 
- for(int i=from;i<to;i++)
-  if(hw->fx_regs_usage[i]!=0xffffffff)
-  {
-       	for(int j=0;j<32;j++)
-       	  if(!(get_bit(hw->fx_regs_usage,i*32+j)))
-       	  {
-       	  	set_bit(hw->fx_regs_usage,i*32+j);
-       	  	m->info[reg].translated=i*32+j+0x100;
-       	  	if(from==0x200/32) // 10k2 GPR register
-       	  	 m->info[reg].translated+=0x100;
-       	  	return 0;
-       	  }
-  	debug(DERR,"!!! (internal error) alocate_register() algorythm is fake\n");
-  	return -11;
-  }
+inline int allocate_register(kx_hw *hw,dsp_microcode *m,int reg)
+{
+ if((m->info[reg].type&GPR_MASK)==GPR_INPUT ||
+    (m->info[reg].type&GPR_MASK)==GPR_TRAMA)
+ {
+ 	debug(DERR,"!!! (internal error):: allocate_register() :: input??\n");
+ 	return -21;
+ }
+
+ int from,to;
+ get_register_pool(hw,m->info[reg].type,&from,&to);
+
+ int bit=kx_bitmap_alloc_bit(hw->fx_regs_usage,from,to);
+ if(bit>=0)
+ {
+    m->info[reg].translated=(word)(bit+0x100);
+    if(from==0x200) // 10k2 GPR register
+     m->info[reg].translated+=0x100;
+    return 0;
+ }
 
  debug(DLIB,"(..) no more GPRs/TRAMs in allocate_register\n");
  return -10;
@@ -1342,10 +1634,17 @@ inline int free_register(kx_hw *hw,dsp_microcode *m,int reg)
 	{
 	        if(is_valid_gpr(m->info[reg].translated))
 	        {
+	         int bit;
 	         if(m->info[reg].translated>=0x400) // 10k2 GPR II
-                   clear_bit(hw->fx_regs_usage,m->info[reg].translated-0x200);
+                   bit=m->info[reg].translated-0x200;
+                 else
+		   bit=m->info[reg].translated-0x100;
+
+                 // registers of the running microcode are kept until kx_dsp_commit()
+                 if(hw->dsp_txn && get_bit(hw->dsp_txn->regs_live,bit))
+                   set_bit(hw->dsp_txn->regs_free,bit);
                  else
-		   clear_bit(hw->fx_regs_usage,m->info[reg].translated-0x100);
+                   clear_bit(hw->fx_regs_usage,bit);
 		}
 		m->info[reg].translated=DSP_REG_NOT_TRANSLATED;
 		return 0;
@@ -1369,92 +1668,65 @@ inline int allocate_microcode(kx_hw *hw,dsp_microcode *m,int pos,int pos_pgm)
 	}
 
 	int initial=0;
-	int direction=1;
 	int final=hw->microcode_size;
-    int offset;
+	int mode=KX_ALLOC_BEST;
 
 	if(pos!=KX_MICROCODE_ABSOLUTE)
 	{
             if(pos_pgm!=0) // before or after pos_pgm
             {
-               struct list *item;
-               for_each_list_entry(item, &hw->microcodes) 
+               dsp_microcode *mm=find_microcode(hw,pos_pgm);
+               if(mm && mm->offset!=DSP_MICROCODE_NOT_TRANSLATED)
                {
-                    dsp_microcode *mm;
-                    mm = list_item(item, dsp_microcode, list);
-                    if(!mm)
-                     continue;
-                    if(mm->pgm==pos_pgm)
-                    {
-                     if(pos==KX_MICROCODE_BEFORE)
-                      final=mm->offset;
-                     else
-                      initial=mm->offset+mm->code_size-1;
-                    }
+                 if(pos==KX_MICROCODE_BEFORE)
+                  final=mm->offset;
+                 else
+                  initial=mm->offset+mm->code_size/sizeof(dsp_code);
                }
             }
+            // 'before': as close to pos_pgm (or to the end of the microcode memory) as possible
             if(pos==KX_MICROCODE_BEFORE)
-            {
-                    direction=-1;
-            }
-            offset=initial;
-            if(pos==KX_MICROCODE_BEFORE)
-             offset=final-1;
+             mode=KX_ALLOC_BEST_TOP;
         }
         else // absolute position
         {
-            initial=pos_pgm;
-            offset=initial;
-            final=offset+size;
-
-            if(offset>=hw->microcode_size)
+            if(pos_pgm>=hw->microcode_size)
             {
-             debug(DLIB,"!! note: microcode absolute position is incorrect [%d]\n",offset);
+             debug(DLIB,"!! note: microcode absolute position is incorrect [%d]\n",pos_pgm);
              return -10;
             }
+            // the requested position or the nearest one after it
+            initial=pos_pgm;
+            final=pos_pgm+size*2-1;
             if(final>hw->microcode_size)
             {
              debug(DLIB,"!! warning: incorrect microcode position [absolute]\n");
              final=hw->microcode_size;
             }
-            if(initial>=hw->microcode_size)
-            {
-             debug(DLIB,"!! warning: incorrect microcode position [absolute2]\n");
-             initial=0;
-            }
+            mode=KX_ALLOC_FIRST;
         }
 
-        while(1)
-	{
-		if(direction==1)
-		{
-		 if(offset>=final) break;
-		}
-		else
-		{
-		 if(offset<initial) break;
-		}
+        int offset=kx_bitmap_alloc(hw->fx_microcode_usage,initial,final,size,mode);
+        if(offset<0 && hw->dsp_txn)
+        {
+         // not enough space next to the running microcode: reuse the instruction memory released
+         // within the transaction; it is then uploaded with the DSP stopped (see kx_dsp_commit())
+         int released=0;
+         for(int j=0;j<FX_MICROCODE_MASSIVE_SIZE;j++)
+         {
+          released|=(hw->dsp_txn->microcode_free[j]!=0);
+          hw->fx_microcode_usage[j]&=~hw->dsp_txn->microcode_free[j];
+          hw->dsp_txn->microcode_free[j]=0;
+         }
+         if(released)
+          offset=kx_bitmap_alloc(hw->fx_microcode_usage,initial,final,size,mode);
+        }
+        if(offset>=0)
+        {
+         m->offset=offset;
+         return 0;
+        }
 
-		if(!(get_bit(hw->fx_microcode_usage,offset))) // found '0'
-		{
-			int i;
-			for(i=0;i<size && ((offset+i)<hw->microcode_size);i++)
-			 if(get_bit(hw->fx_microcode_usage,offset+i))
-			  break;
-			
-			if(i==size) // found enough room
-			{
-				for(i=0;i<size;i++)
-				 set_bit(hw->fx_microcode_usage,offset+i);
-				m->offset=offset;
-				return 0;
-			}
-			if(direction==1)
-			 offset+=i-1;
-                        // FIXME: else offset-= ???
-		}
-		offset+=direction;
-	}
 	debug(DLIB,"(..) no more microcode memory\n");
         return -10;
 }
@@ -1464,7 +1736,13 @@ inline int free_microcode(kx_hw *hw,dsp_microcode *m)
 	if(m->offset!=DSP_MICROCODE_NOT_TRANSLATED)
 	{
 		for(dword i=m->offset;i<m->offset+m->code_size/sizeof(dsp_code);i++)
-		 clear_bit(hw->fx_microcode_usage,i);
+		{
+		 // instruction memory of the running microcode is kept until kx_dsp_commit()
+		 if(hw->dsp_txn && get_bit(hw->dsp_txn->microcode_live,i))
+		  set_bit(hw->dsp_txn->microcode_free,i);
+		 else
+		  clear_bit(hw->fx_microcode_usage,i);
+		}
 		m->offset=DSP_MICROCODE_NOT_TRANSLATED;
 	}
 	return 0;
@@ -1550,6 +1828,9 @@ inline int disconnect_microcode(kx_hw *hw,dsp_microcode *src,word src_gpr,dsp_re
 
 KX_API(int,kx_disconnect_microcode(kx_hw *hw,int pgm,word src))
 {
+ if(txn_busy(hw))
+  return -12;
+
  dsp_microcode *src_m=NULL;
  dsp_register_info *source=NULL;
  word src_reg;
@@ -1592,7 +1873,7 @@ inline int untranslate_microcode(kx_hw *hw,dsp_microcode *m)
         {
           for(dword i=0;i<m->code_size/sizeof(dsp_code);i++)
        	  {
-       		  hwOP(i+m->offset,ACC3,C_0-0x2000+(hw->is_10k2?0x80:0),
+       		  write_instruction(hw,i+m->offset,ACC3,C_0-0x2000+(hw->is_10k2?0x80:0),
        		                        C_0-0x2000+(hw->is_10k2?0x80:0),
        		                        C_0-0x2000+(hw->is_10k2?0x80:0),
        		                        C_0-0x2000+(hw->is_10k2?0x80:0));
@@ -1619,7 +1900,7 @@ inline int untranslate_microcode(kx_hw *hw,dsp_microcode *m)
        		   // zero register, if it is not input (other pgm) and if it is translated
        		   if(is_valid_gpr(m->info[i].translated))
        		   {
-       		      kx_writeptr(hw,m->info[i].translated,0,0);
+       		      write_dsp_register(hw,m->info[i].translated,0);
 
                       // for TRAM registers:
                       if( ((m->info[i].type&GPR_MASK)==GPR_ITRAM) ||
@@ -1627,9 +1908,9 @@ inline int untranslate_microcode(kx_hw *hw,dsp_microcode *m)
                       {
                         // clear control flag
        		        if(hw->is_10k2)
-       		         kx_writeptr(hw,m->info[i].translated-0x100,0,0);
+       		         write_dsp_register(hw,m->info[i].translated-0x100,0);
        		        // clear address register
-       		        kx_writeptr(hw,m->info[i].translated+0x100,0,0);
+       		        write_dsp_register(hw,m->info[i].translated+0x100,0);
        		      }
        		   }
        		   if((m->info[i].type&GPR_MASK)!=GPR_TRAMA) // trama is freed automatically
@@ -1651,6 +1932,9 @@ KX_API(int,kx_untranslate_microcode(kx_hw *hw,int pgm))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
   unsigned long flags=0;
   kx_lock_acquire(hw,&hw->dsp_lock, &flags);
 
@@ -1676,6 +1960,264 @@ KX_API(int,kx_untranslate_microcode(kx_hw *hw,int pgm))
   return -1; // not found
 }
 
+// TRAM pools: iTRAM is 8192 samples (FIXME: check with 10k2?..); xTRAM: tram_size bytes of 16-bit samples
+#define ITRAM_SAMPLES	8192
+#define ITRAM_ALIGN	16
+#define XTRAM_ALIGN	512
+#define tram_limit(is_x) ((is_x)?(dword)(hw->cb.tram_size/2):(dword)ITRAM_SAMPLES)
+
+// collects TRAM extents of all translated microcode except 'm' into hw->tram_extents (sorted)
+// should be called with dsp_lock held
+static int get_tram_extents(kx_hw *hw,dsp_microcode *m,int is_x)
+{
+ int n=0;
+ struct list *item;
+ for_each_list_entry(item, &hw->microcodes)
+ {
+        dsp_microcode *mm;
+        mm = list_item(item, dsp_microcode, list);
+        if(!mm || mm==m)
+         continue;
+        if(!(mm->flag&MICROCODE_TRANSLATED))
+         continue;
+        dword start=is_x?mm->xtram_start:mm->itram_start;
+        dword size=is_x?mm->xtramsize:mm->itramsize;
+        if(start==0 && size==0)
+         continue;
+        if(n<KX_TRAM_EXTENTS)
+         n=kx_extent_insert(hw->tram_extents,n,start,size);
+ }
+ // delay lines of the running microcode are in use until kx_dsp_commit(), even if it was
+ // untranslated within the transaction
+ kx_dsp_txn *txn=hw->dsp_txn;
+ for(int i=0;txn && i<txn->n_saved;i++)
+ {
+        kx_txn_microcode *sm=&txn->saved[i];
+        if(!(sm->flag&MICROCODE_TRANSLATED))
+         continue;
+        dword start=is_x?sm->xtram_start:sm->itram_start;
+        dword size=is_x?sm->m->xtramsize:sm->m->itramsize;
+        if(start==0 && size==0)
+         continue;
+        if(n<KX_TRAM_EXTENTS)
+         n=kx_extent_insert(hw->tram_extents,n,start,size);
+ }
+ return n;
+}
+
+static int allocate_tram(kx_hw *hw,dsp_microcode *m,int is_x,dword *start)
+{
+ int n=get_tram_extents(hw,m,is_x);
+ return kx_extent_alloc(hw->tram_extents,n,tram_limit(is_x),is_x?m->xtramsize:m->itramsize,
+   is_x?XTRAM_ALIGN:ITRAM_ALIGN,start);
+}
+
+// -----
+// compaction (see kx_dsp_compact()); called with dsp_lock held
+// -----
+
+// the DSP is stopped only for the time a single microcode is being moved, so
+// that the old and the new copy never run within the same sample period
+// it is not restarted if it was already stopped by the caller
+static int dsp_stop_if_running(kx_hw *hw)
+{
+ dword dbg=kx_readptr(hw,hw->is_10k2?DBG_10K2:DBG_10K1,0);
+ if(dbg&(hw->is_10k2?DBG_10K2_SINGLE_STEP:DBG_10K1_SINGLE_STEP))
+  return 0;
+ kx_dsp_stop(hw);
+ return 1;
+}
+
+// translated microcode with the lowest (dir>0) / highest (dir<0) offset after / before 'prev'
+static dsp_microcode *next_microcode_by_offset(kx_hw *hw,dsp_microcode *prev,int dir)
+{
+ dsp_microcode *ret=NULL;
+ struct list *item;
+ for_each_list_entry(item, &hw->microcodes)
+ {
+        dsp_microcode *mm;
+        mm = list_item(item, dsp_microcode, list);
+        if(!mm || mm->offset==DSP_MICROCODE_NOT_TRANSLATED || mm->code_size==0)
+         continue;
+        if(prev && ((dir>0)?(mm->offset<=prev->offset):(mm->offset>=prev->offset)))
+         continue;
+        if(!ret || ((dir>0)?(mm->offset<ret->offset):(mm->offset>ret->offset)))
+         ret=mm;
+ }
+ return ret;
+}
+
+static void move_microcode(kx_hw *hw,dsp_microcode *m,int offset)
+{
+ int size=(int)(m->code_size/sizeof(dsp_code));
+ int old=m->offset;
+ int i;
+
+ int stopped=dsp_stop_if_running(hw);
+
+ for(i=old;i<old+size;i++)
+  clear_bit(hw->fx_microcode_usage,i);
+ for(i=offset;i<offset+size;i++)
+  set_bit(hw->fx_microcode_usage,i);
+
+ m->offset=offset;
+ for(i=0;i<size;i++)
+  upload_instruction(hw,m,i);
+
+ // clear the part of the old location that is not overwritten
+ for(i=old;i<old+size;i++)
+ {
+  if(i>=offset && i<offset+size)
+   continue;
+  hwOP(i,ACC3,C_0-0x2000+(hw->is_10k2?0x80:0),
+              C_0-0x2000+(hw->is_10k2?0x80:0),
+              C_0-0x2000+(hw->is_10k2?0x80:0),
+              C_0-0x2000+(hw->is_10k2?0x80:0));
+ }
+
+ if(stopped)
+  kx_dsp_go(hw);
+}
+
+// microcode below the largest free block is moved down, the one above it is moved up:
+// execution order and the prolog (bottom) / epilog (top) layout are kept
+// returns the number of moved microcodes
+static int compact_microcode(kx_hw *hw)
+{
+ if(hw->dsp_txn) // relocation bypasses the shadow copy
+  return 0;
+
+ int gap_start=-1,gap_len=0;
+ int pos=0;
+ while(pos<hw->microcode_size)
+ {
+  int start=kx_bitmap_scan(hw->fx_microcode_usage,pos,hw->microcode_size,0);
+  if(start>=hw->microcode_size)
+   break;
+  int end=kx_bitmap_scan(hw->fx_microcode_usage,start,hw->microcode_size,1);
+  if(end-start>gap_len)
+  {
+   gap_start=start;
+   gap_len=end-start;
+  }
+  pos=end;
+ }
+ if(gap_start<0)
+  return 0;
+
+ int moved=0;
+ int cursor=0;
+ dsp_microcode *m=NULL;
+ while((m=next_microcode_by_offset(hw,m,1))!=NULL && m->offset<gap_start)
+ {
+  if(m->offset>cursor)
+  {
+   move_microcode(hw,m,cursor);
+   moved++;
+  }
+  cursor=m->offset+m->code_size/sizeof(dsp_code);
+ }
+
+ cursor=hw->microcode_size;
+ m=NULL;
+ while((m=next_microcode_by_offset(hw,m,-1))!=NULL && m->offset>=gap_start+gap_len)
+ {
+  int size=(int)(m->code_size/sizeof(dsp_code));
+  if(m->offset+size<cursor)
+  {
+   move_microcode(hw,m,cursor-size);
+   moved++;
+  }
+  cursor=m->offset;
+ }
+
+ if(moved)
+  debug(DLIB,"dsp: compacted microcode memory [%d moved]\n",moved);
+ return moved;
+}
+
+// translated microcode with the lowest TRAM start above 'prev'
+static dsp_microcode *next_microcode_by_tram(kx_hw *hw,dsp_microcode *prev,int is_x)
+{
+ dsp_microcode *ret=NULL;
+ struct list *item;
+ for_each_list_entry(item, &hw->microcodes)
+ {
+        dsp_microcode *mm;
+        mm = list_item(item, dsp_microcode, list);
+        if(!mm || !(mm->flag&MICROCODE_TRANSLATED) || (is_x?mm->xtramsize:mm->itramsize)==0)
+         continue;
+        int start=is_x?mm->xtram_start:mm->itram_start;
+        if(prev && start<=(is_x?prev->xtram_start:prev->itram_start))
+         continue;
+        if(!ret || start<(is_x?ret->xtram_start:ret->itram_start))
+         ret=mm;
+ }
+ return ret;
+}
+
+// the delay lines restart from silence (an audible dropout): only on request, see kx_dsp_compact();
+// the microcode is bypassed while its TRAM address registers are rewritten
+static void move_tram(kx_hw *hw,dsp_microcode *m,int is_x,dword start)
+{
+ int bypass=(m->flag&MICROCODE_ENABLED) && !(m->flag&MICROCODE_BYPASS) && (strstr(m->comment,"$nobypass")==0);
+ if(bypass)
+ {
+  m->flag|=MICROCODE_BYPASS;
+  upload_output_instructions(hw,m);
+ }
+
+ if(is_x)
+  m->xtram_start=start;
+ else
+  m->itram_start=start;
+
+ dword type=is_x?GPR_XTRAM:GPR_ITRAM;
+ for(dword i=0;i<m->info_size/sizeof(dsp_register_info);i++)
+ {
+  if((m->info[i].type&GPR_MASK)!=type || !is_valid_gpr(m->info[i].translated))
+   continue;
+  dword fl=0;
+  if(m->info[i].type&TRAM_READ)
+   fl=TRAM_CLEAR;
+  set_tram_addr(hw,m,&m->info[i],m->info[i].p);
+  set_tram_flag(hw,m,&m->info[i],fl|(m->info[i].type&(TRAM_READ|TRAM_WRITE)));
+ }
+
+ if(bypass)
+ {
+  m->flag&=(~MICROCODE_BYPASS);
+  upload_output_instructions(hw,m);
+ }
+}
+
+// packs iTRAM / xTRAM extents towards 0; returns the number of moved microcodes
+static int compact_tram(kx_hw *hw,int is_x)
+{
+ if(hw->dsp_txn)
+  return 0;
+
+ dword align=is_x?XTRAM_ALIGN:ITRAM_ALIGN;
+ dword cursor=0;
+ int moved=0;
+ dsp_microcode *m=NULL;
+
+ while((m=next_microcode_by_tram(hw,m,is_x))!=NULL)
+ {
+  dword start=(cursor+align-1)/align*align;
+  if(start<(dword)(is_x?m->xtram_start:m->itram_start))
+  {
+   move_tram(hw,m,is_x,start);
+   moved++;
+  }
+  cursor=(is_x?m->xtram_start+m->xtramsize:m->itram_start+m->itramsize)+1;
+ }
+
+ if(moved)
+  debug(DLIB,"dsp: compacted %s [%d moved]\n",is_x?"xTRAM":"iTRAM",moved);
+ return moved;
+}
+
 inline int kx_translate_microcode(kx_hw *hw,dsp_microcode *m,int place,int pos_pgm)
 {
  m->itram_start=0;
@@ -1745,92 +2287,29 @@ inline int kx_translate_microcode(kx_hw *hw,dsp_microcode *m,int place,int pos_p
 
  if(m->itramsize!=0) // need itram?
  {
-     int found=1;
-     int start=0;
-     int end=m->itramsize;
+     dword start=0;
      //debug(DLIB,"iTram request: %d samples\n",m->itramsize);
-
-       while(1)
-       {
-       	     struct list *item;
-             for_each_list_entry(item, &hw->microcodes) 
-             {
-              	    dsp_microcode *mm;
-                    mm = list_item(item, dsp_microcode, list);
-                    if(!mm)
-                     continue;
-                    if(!(mm->flag&MICROCODE_TRANSLATED))
-                     continue;
-                    if((mm->itram_start==0) && (mm->itramsize==0))
-                     continue;
-                    if( ( (start>=mm->itram_start) && (start<=(mm->itram_start+mm->itramsize)) ) ||
-                        ( (end>=mm->itram_start) && (end<=(mm->itram_start+mm->itramsize)) )|| 
-                        ( (start<=mm->itram_start) && (end>=mm->itram_start+mm->itramsize)) )
-                    {
-                     // intersection
-                     found=0;
-                     break;
-                    }
-             }
-             if(found==0) // intersection
-             {
-               start+=16;
-               end+=16;
-               found=1;
-             } else break; // found
-             if(end>=8192) // FIXME: check with 10k2?..
-             {
-             	debug(DLIB,"no more free iTRAM memory\n");
-             	return -1;
-             }
-       } // while 1
-       //debug(DLIB,"iTram request: found %d samples @ %x\n",m->itramsize,start);
-       m->itram_start=start;
+     // TRAM is not compacted here: moving a delay line clears it (see move_tram())
+     if(allocate_tram(hw,m,0,&start))
+     {
+     	debug(DLIB,"no more free iTRAM memory\n");
+     	return -1;
+     }
+     //debug(DLIB,"iTram request: found %d samples @ %x\n",m->itramsize,start);
+     m->itram_start=start;
  } // need itram?..
 
  if(m->xtramsize!=0) // need xtram?
  {
-     int found=1;
-     int start=0;
-     int end=m->xtramsize;
-
-       //debug(DLIB,"xTram request: %d samples\n",m->xtramsize);
-       while(1)
-       {
-             struct list *item;
-             for_each_list_entry(item, &hw->microcodes) 
-             {
-              	    dsp_microcode *mm;
-                    mm = list_item(item, dsp_microcode, list);
-                    if(!mm)
-                     continue;
-                    if(!(mm->flag&MICROCODE_TRANSLATED))
-                     continue;
-                    if((mm->xtram_start==0) && (mm->xtramsize==0))
-                     continue;
-                    if( ( (start>=mm->xtram_start) && (start<=(mm->xtram_start+mm->xtramsize)) ) ||
-                        ( (end>=mm->xtram_start) && (end<=(mm->xtram_start+mm->xtramsize)) ) || 
-                        ( (start<=mm->xtram_start) && (end>=mm->xtram_start+mm->xtramsize)) )
-                    {
-                     // intersection
-                     found=0;
-                     break;
-                    }
-             }
-             if(found==0) // intersection
-             {
-               start+=512;
-               end+=512;
-               found=1;
-             } else break; // found
-             if(end>=hw->cb.tram_size/2)
-             {
-             	debug(DLIB,"no more free xTRAM memory (end=%d size: %x)\n",end,hw->cb.tram_size);
-             	return -2;
-             }
-       } // while 1
-       m->xtram_start=start;
-       //debug(DLIB,"xTram request: %d samples @%x\n",m->xtramsize,start);
+     dword start=0;
+     //debug(DLIB,"xTram request: %d samples\n",m->xtramsize);
+     if(allocate_tram(hw,m,1,&start))
+     {
+     	debug(DLIB,"no more free xTRAM memory (size: %d; tram: %x)\n",m->xtramsize,hw->cb.tram_size);
+     	return -2;
+     }
+     m->xtram_start=start;
+     //debug(DLIB,"xTram request: %d samples @%x\n",m->xtramsize,start);
  } // need xtram?..
 
  dword i;
@@ -1941,7 +2420,7 @@ inline int kx_translate_microcode(kx_hw *hw,dsp_microcode *m,int place,int pos_p
 
  // now, set m->offset
  if((m->offset==DSP_MICROCODE_NOT_TRANSLATED) && (m->code_size>0))
-  if(allocate_microcode(hw,m,place,pos_pgm))
+  if(allocate_microcode(hw,m,place,pos_pgm) && (compact_microcode(hw)==0 || allocate_microcode(hw,m,place,pos_pgm)))
   {
  	debug(DLIB,"!!! No free mem in microcode memory for current microcode [place=%d; pos=%d]\n",place,pos_pgm);
  	untranslate_microcode(hw,m);
@@ -1966,6 +2445,9 @@ KX_API(int,kx_translate_microcode(kx_hw *hw,int pgm,int place,int pos_pgm))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
   unsigned long flags=0;
   kx_lock_acquire(hw,&hw->dsp_lock, &flags);
 
@@ -1992,6 +2474,21 @@ KX_API(int,kx_translate_microcode(kx_hw *hw,int pgm,int place,int pos_pgm))
 }
 
 
+// re-uploads all instructions that reference outputs (after enable / disable / bypass)
+static void upload_output_instructions(kx_hw *hw,dsp_microcode *m)
+{
+   kx_register_index *idx=get_register_index(hw,m);
+   if(idx==NULL)
+   {
+    debug(DLIB,"!! internal error: no register index in upload_output_instructions() [%d]\n",m->pgm);
+    return;
+   }
+
+   for(dword i=0;i<idx->n_code;i++)
+    if(idx->op_flags[i]&KX_OPERAND_HAS_OUTPUT)
+     upload_resolved_instruction(hw,m,idx,i);
+}
+
 KX_API(int,kx_enable_microcode(kx_hw *hw,int pgm))
 {
   if(!(hw->initialized&KX_DSP_INITED))
@@ -2000,6 +2497,9 @@ KX_API(int,kx_enable_microcode(kx_hw *hw,int pgm))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
   struct list *item;
 
   unsigned long flags=0;
@@ -2018,26 +2518,7 @@ KX_API(int,kx_enable_microcode(kx_hw *hw,int pgm))
             	m->flag|=MICROCODE_ENABLED;
             	m->flag&=(~MICROCODE_BYPASS);
 
-                for(dword i=0;i<m->code_size/sizeof(dsp_code);i++)
-                {
-                  dsp_register_info *tmp1,*tmp2,*tmp3,*tmp4;
-                  tmp1=find_dsp_register_in_m(hw,m,m->code[i].r);
-                  tmp2=find_dsp_register_in_m(hw,m,m->code[i].a);
-                  tmp3=find_dsp_register_in_m(hw,m,m->code[i].x);
-                  tmp4=find_dsp_register_in_m(hw,m,m->code[i].y);
-
-                  if(tmp1 && (tmp1->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp1->type&GPR_MASK)==GPR_OUTPUT))
-                     upload_instruction(hw,m,i);
-                  else
-                  if(tmp2 && (tmp2->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp2->type&GPR_MASK)==GPR_OUTPUT))
-                     upload_instruction(hw,m,i);
-                  else
-                  if(tmp3 && (tmp3->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp3->type&GPR_MASK)==GPR_OUTPUT))
-                     upload_instruction(hw,m,i);
-                  else
-                  if(tmp4 && (tmp4->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp4->type&GPR_MASK)==GPR_OUTPUT))
-                     upload_instruction(hw,m,i);
-            	}
+                upload_output_instructions(hw,m);
             }
             kx_lock_release(hw,&hw->dsp_lock,&flags);
             return 0;
@@ -2059,6 +2540,9 @@ KX_API(int,kx_disable_microcode(kx_hw *hw,int pgm))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
   struct list *item;
 
   unsigned long flags=0;
@@ -2077,26 +2561,7 @@ KX_API(int,kx_disable_microcode(kx_hw *hw,int pgm))
                         m->flag&=(~MICROCODE_ENABLED);
                         m->flag&=(~MICROCODE_BYPASS);
 
-                        for(dword i=0;i<m->code_size/sizeof(dsp_code);i++)
-                        {
-                          dsp_register_info *tmp1,*tmp2,*tmp3,*tmp4;
-                          tmp1=find_dsp_register_in_m(hw,m,m->code[i].r);
-                          tmp2=find_dsp_register_in_m(hw,m,m->code[i].a);
-                          tmp3=find_dsp_register_in_m(hw,m,m->code[i].x);
-                          tmp4=find_dsp_register_in_m(hw,m,m->code[i].y);
-
-                          if(tmp1 && (tmp1->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp1->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                          else
-                          if(tmp2 && (tmp2->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp2->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                          else
-                          if(tmp3 && (tmp3->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp3->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                          else
-                          if(tmp4 && (tmp4->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp4->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                    	}
+                        upload_output_instructions(hw,m);
             }
             kx_lock_release(hw,&hw->dsp_lock,&flags);
             return (m->flag&MICROCODE_ENABLED)?-20:0;
@@ -2118,6 +2583,9 @@ KX_API(int,kx_set_microcode_bypass(kx_hw *hw,int pgm,int state))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
   struct list *item;
 
   unsigned long flags=0;
@@ -2139,7 +2607,7 @@ KX_API(int,kx_set_microcode_bypass(kx_hw *hw,int pgm,int state))
                  if(state)
                   debug(DLIB,"Cannot 'bypass' system microcode(s)\n");
 
-                  m->flag&=(~MICROCODE_BYPASS);
+                 m->flag&=(~MICROCODE_BYPASS);
 
                   kx_lock_release(hw,&hw->dsp_lock,&flags);
                   return -30;
@@ -2150,26 +2618,7 @@ KX_API(int,kx_set_microcode_bypass(kx_hw *hw,int pgm,int state))
                 else
                    m->flag&=(~MICROCODE_BYPASS);
 
-                        for(dword i=0;i<m->code_size/sizeof(dsp_code);i++)
-                        {
-                          dsp_register_info *tmp1,*tmp2,*tmp3,*tmp4;
-                          tmp1=find_dsp_register_in_m(hw,m,m->code[i].r);
-                          tmp2=find_dsp_register_in_m(hw,m,m->code[i].a);
-                          tmp3=find_dsp_register_in_m(hw,m,m->code[i].x);
-                          tmp4=find_dsp_register_in_m(hw,m,m->code[i].y);
-
-                          if(tmp1 && (tmp1->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp1->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                          else
-                          if(tmp2 && (tmp2->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp2->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                          else
-                          if(tmp3 && (tmp3->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp3->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                          else
-                          if(tmp4 && (tmp4->translated!=DSP_REG_NOT_TRANSLATED) && ((tmp4->type&GPR_MASK)==GPR_OUTPUT))
-                             upload_instruction(hw,m,i);
-                    	}
+                        upload_output_instructions(hw,m);
             }
             kx_lock_release(hw,&hw->dsp_lock,&flags);
             if(state)
@@ -2194,6 +2643,9 @@ KX_API(int,kx_set_microcode_flag(kx_hw *hw,int pgm,dword flag))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
   struct list *item;
 
   unsigned long flags=0;
@@ -2292,6 +2744,9 @@ KX_API(int,kx_load_microcode(kx_hw *hw,const char *name,dsp_code *code2,int code
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
  dsp_code *code=NULL;
  dsp_register_info *info=NULL;
  dsp_microcode *microcode=NULL;  
@@ -2348,11 +2803,39 @@ KX_API(int,kx_load_microcode(kx_hw *hw,const char *name,dsp_code *code2,int code
                                 if(pgm==m->pgm) // found duplicate
                                  pgm=0;
         	 	}
+        	 	// ids of microcode unloaded within a transaction are restored by kx_dsp_abort()
+        	 	if(hw->dsp_txn)
+        	 	 for_each_list_entry(item, &hw->dsp_txn->unloaded)
+        	 	 {
+        	 		dsp_microcode *m;
+                                m = list_item(item, dsp_microcode, list);
+                                if(m && pgm==m->pgm)
+                                 pgm=0;
+        	 	 }
         	 	if(pgm!=0) // found free
         	 	  break;
         	 }
          }
-          else pgm=force_pgm_id;
+         else
+         {
+                 // saved ids: unique and within the pgm tables, as the ids found above
+                 pgm=force_pgm_id;
+                 if(pgm<=0 || pgm>=MAX_PGM_NUMBER || hw->pgm_map[pgm])
+                  pgm=0;
+                 if(pgm && hw->dsp_txn)
+                 {
+                  struct list *item;
+                  for_each_list_entry(item, &hw->dsp_txn->unloaded)
+                  {
+                        dsp_microcode *m;
+                        m = list_item(item, dsp_microcode, list);
+                        if(m && pgm==m->pgm)
+                         pgm=0;
+                  }
+                 }
+                 if(pgm==0)
+                  debug(DLIB,"!! kx_load_microcode(): pgm id %d is invalid or in use\n",force_pgm_id);
+         }
 
 
          if(pgm!=0) // found free pgms         
@@ -2366,8 +2849,17 @@ KX_API(int,kx_load_microcode(kx_hw *hw,const char *name,dsp_code *code2,int code
 
          	microcode->offset=DSP_MICROCODE_NOT_TRANSLATED;
 
+         	hw->pgm_map[pgm]=microcode;
+
                 kx_lock_release(hw,&hw->dsp_lock,&flags);
-         	return pgm;
+
+                if(build_register_index(hw,microcode)==0)
+         	 return pgm;
+
+                // not translated yet: nothing refers to it
+                kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+                list_del(&microcode->list);
+                hw->pgm_map[pgm]=NULL;
          }
 
          kx_lock_release(hw,&hw->dsp_lock,&flags);
@@ -2393,6 +2885,9 @@ KX_API(int,kx_unload_microcode(kx_hw *hw,int pgm))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
   struct list *item;
 
   unsigned long flags=0;
@@ -2409,8 +2904,33 @@ KX_API(int,kx_unload_microcode(kx_hw *hw,int pgm))
             untranslate_microcode(hw,m);
 
             list_del(&m->list);
+
+            // pgm ids are unique: see kx_load_microcode()
+            kx_register_index *idx=NULL;
+            if(pgm>0 && pgm<MAX_PGM_NUMBER)
+            {
+             hw->pgm_map[pgm]=NULL;
+             idx=hw->pgm_index[pgm];
+             hw->pgm_index[pgm]=NULL;
+            }
+
+            // the microcode is freed by kx_dsp_commit() (or restored by kx_dsp_abort())
+            if(hw->dsp_txn)
+            {
+             list_add(&m->list,&hw->dsp_txn->unloaded);
+             m=NULL;
+            }
+            else
+             telemetry_drop_unloaded(hw);
+
             kx_lock_release(hw,&hw->dsp_lock,&flags);
 
+            if(idx)
+             (hw->cb.free_func)(hw->cb.call_with,idx);
+
+            if(!m)
+             return 0;
+
             // AFTER spin_release
             if(m->info)
               (hw->cb.free_func)(hw->cb.call_with,m->info);
@@ -2436,6 +2956,9 @@ KX_API(int,kx_connect_microcode(kx_hw *hw,int pgm1,word src,int pgm2,word dst))
    return -1;
   }
 
+  if(txn_busy(hw))
+   return -12;
+
  dsp_register_info *source=NULL;
  dsp_register_info *destination=NULL;
  dsp_register_info *process=NULL;
@@ -2749,7 +3272,7 @@ KX_API(int,kx_enum_microcode(kx_hw *hw,char *pgm_id,dsp_microcode *mc))
         m = list_item(item, dsp_microcode, list);
         if(!m)
          continue;
-        if(strncmp(m->name,pgm_id,KX_MAX_STRING)==NULL)
+        if(strncmp(m->name,pgm_id,KX_MAX_STRING)==0)
         {
             memcpy(mc,m,sizeof(dsp_microcode));
             mc->code=NULL;
@@ -2942,7 +3465,7 @@ KX_API(int,kx_dsp_stop(kx_hw *hw))
   kx_writeptr(hw,DBG_10K2,0,DBG_10K2_SINGLE_STEP);
  else
   kx_writeptr(hw,DBG_10K1,0,DBG_10K1_SINGLE_STEP);
-  return 0;
+ return 0;
 }
 
 KX_API(int,kx_dsp_go(kx_hw *hw))
@@ -2962,6 +3485,14 @@ KX_API(int,kx_dsp_clear(kx_hw *hw))
    return -5;
  } 
 
+ // resets the DSP for everyone: a pending transaction is rolled back, whoever owns it
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ if(hw->dsp_txn)
+  txn_abort(hw,&flags);
+ else
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+
  kx_dsp_stop(hw);
  int i;
  for(i=0;i<MAX_PGM_NUMBER;i++)
@@ -3013,6 +3544,752 @@ KX_API(int,kx_dsp_clear(kx_hw *hw))
  return 0;
 }
 
+KX_API(int,kx_get_dsp_resources(kx_hw *hw,kx_dsp_resources *res))
+{
+ if(!(hw->initialized&KX_DSP_INITED))
+ {
+   debug(DLIB,"!!! get_dsp_resources() w/o being inited\n");
+   return -5;
+ }
+
+ memset(res,0,sizeof(kx_dsp_resources));
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ int from,to;
+
+ kx_bitmap_stats(hw->fx_microcode_usage,0,hw->microcode_size,&res->pool[KX_DSP_POOL_MICROCODE]);
+
+ get_register_pool(hw,GPR_STATIC,&from,&to);
+ kx_bitmap_stats(hw->fx_regs_usage,from,to,&res->pool[KX_DSP_POOL_GPR]);
+ get_register_pool(hw,GPR_ITRAM,&from,&to);
+ kx_bitmap_stats(hw->fx_regs_usage,from,to,&res->pool[KX_DSP_POOL_ITRAM_REGS]);
+ get_register_pool(hw,GPR_XTRAM,&from,&to);
+ kx_bitmap_stats(hw->fx_regs_usage,from,to,&res->pool[KX_DSP_POOL_XTRAM_REGS]);
+
+ kx_extent_stats(hw->tram_extents,get_tram_extents(hw,NULL,0),tram_limit(0),ITRAM_ALIGN,&res->pool[KX_DSP_POOL_ITRAM]);
+ kx_extent_stats(hw->tram_extents,get_tram_extents(hw,NULL,1),tram_limit(1),XTRAM_ALIGN,&res->pool[KX_DSP_POOL_XTRAM]);
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+ return 0;
+}
+
+KX_API(int,kx_dsp_compact(kx_hw *hw,dword flags))
+{
+ if(!(hw->initialized&KX_DSP_INITED))
+ {
+   debug(DLIB,"!!! dsp_compact() w/o being inited\n");
+   return -5;
+ }
+
+ if(txn_busy(hw))
+  return -12;
+
+ int moved=0;
+
+ unsigned long lock_flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&lock_flags);
+
+ if(flags&KX_COMPACT_MICROCODE)
+  moved+=compact_microcode(hw);
+ if(flags&KX_COMPACT_ITRAM)
+  moved+=compact_tram(hw,0);
+ if(flags&KX_COMPACT_XTRAM)
+  moved+=compact_tram(hw,1);
+
+ kx_lock_release(hw,&hw->dsp_lock,&lock_flags);
+
+ return moved;
+}
+
+// -----
+// transactions
+// -----
+// load / translate / connect / disconnect / enable / disable / bypass / set_dsp_register / unload
+// calls issued by the owner between kx_dsp_begin() and kx_dsp_commit() reach the hardware in one step:
+// - instructions of microcode translated within the transaction are uploaded while the DSP is
+//   running: they are placed into instruction memory the running microcode does not use and only
+//   write to registers allocated within the transaction, so nothing reads their results yet
+// - instructions of the running microcode (re-connected, muted, untranslated), new instructions
+//   that write to its registers or reuse its memory, and queued register writes are uploaded
+//   with the DSP stopped; the DSP executes the whole instruction memory every sample period and
+//   cannot jump, so a running microcode is not switched to a copy built elsewhere: these writes
+//   are what is left of a transaction by then, at most one per instruction and one per register
+// kx_dsp_abort(), the close of the owner (kx_dsp_release()) and the timeout (KX_DSP_TXN_TIMEOUT
+// without a request of the owner, checked when another client changes the microcode) restore the
+// microcode list as it was at kx_dsp_begin(); the hardware the running microcode uses is not touched
+
+static int is_saved_microcode(kx_dsp_txn *txn,dsp_microcode *m)
+{
+ for(int i=0;i<txn->n_saved;i++)
+  if(txn->saved[i].m==m)
+   return 1;
+ return 0;
+}
+
+// clears registers written since kx_dsp_begin() and restores the saved state;
+// microcode loaded within the transaction is moved to 'created'; called with dsp_lock held
+static void txn_rollback(kx_hw *hw,kx_dsp_txn *txn,struct list *created)
+{
+ struct list *lists[2]={ &hw->microcodes, &txn->unloaded };
+ for(int l=0;l<2;l++)
+ {
+  struct list *item=lists[l]->next;
+  while(item!=lists[l])
+  {
+   struct list *next=item->next;
+   dsp_microcode *m=list_item(item, dsp_microcode, list);
+
+   // new GPRs and TRAM registers (TRAM ones are running even if no instruction references them)
+   for(dword i=0;i<m->info_size/sizeof(dsp_register_info);i++)
+   {
+    if((m->info[i].type&GPR_MASK)==GPR_INPUT || (m->info[i].type&GPR_MASK)==GPR_TRAMA)
+     continue;
+    word reg=m->info[i].translated;
+    if(!is_fresh_register(hw,txn,reg))
+     continue;
+    kx_writeptr(hw,reg,0,0);
+    if( ((m->info[i].type&GPR_MASK)==GPR_ITRAM) ||
+        ((m->info[i].type&GPR_MASK)==GPR_XTRAM) )
+    {
+     if(hw->is_10k2)
+      kx_writeptr(hw,reg-0x100,0,0);
+     kx_writeptr(hw,reg+0x100,0,0);
+    }
+   }
+
+   if(!is_saved_microcode(txn,m))
+   {
+    list_del(&m->list);
+    list_add(&m->list,created);
+   }
+   item=next;
+  }
+ }
+
+ // saved[] is in list order; list_add() inserts at the head
+ init_list(&hw->microcodes);
+ for(int i=txn->n_saved-1;i>=0;i--)
+ {
+  kx_txn_microcode *sm=&txn->saved[i];
+  dsp_microcode *m=sm->m;
+
+  list_add(&m->list,&hw->microcodes);
+  m->flag=sm->flag;
+  m->offset=sm->offset;
+  m->itram_start=sm->itram_start;
+  m->xtram_start=sm->xtram_start;
+  for(dword j=0;j<m->info_size/sizeof(dsp_register_info);j++)
+   m->info[j].translated=sm->translated[j];
+ }
+
+ memcpy(hw->fx_regs_usage,txn->regs_live,sizeof(hw->fx_regs_usage));
+ memcpy(hw->fx_microcode_usage,txn->microcode_live,sizeof(hw->fx_microcode_usage));
+
+ // the first microcode in the list wins for duplicate (forced) pgm ids
+ memset(hw->pgm_map,0,sizeof(hw->pgm_map));
+ struct list *item;
+ for_each_list_entry(item, &hw->microcodes)
+ {
+  dsp_microcode *m=list_item(item, dsp_microcode, list);
+  if(m->pgm>0 && m->pgm<MAX_PGM_NUMBER && hw->pgm_map[m->pgm]==NULL)
+   hw->pgm_map[m->pgm]=m;
+ }
+}
+
+// called without dsp_lock held: frees 'microcode' (taken off hw->microcodes) and the transaction
+static void txn_free(kx_hw *hw,kx_dsp_txn *txn,struct list *microcode)
+{
+ struct list *item=microcode->next;
+ while(item!=microcode)
+ {
+  struct list *next=item->next;
+  dsp_microcode *m=list_item(item, dsp_microcode, list);
+  if(m->info)
+   (hw->cb.free_func)(hw->cb.call_with,m->info);
+  if(m->code)
+   (hw->cb.free_func)(hw->cb.call_with,m->code);
+  (hw->cb.free_func)(hw->cb.call_with,m);
+  item=next;
+ }
+ if(txn->translated)
+  (hw->cb.free_func)(hw->cb.call_with,txn->translated);
+ (hw->cb.free_func)(hw->cb.call_with,txn);
+}
+
+// after txn_rollback(): drops indices of microcode that is gone and rebuilds the ones freed by
+// kx_unload_microcode() within the transaction
+static void txn_rebuild_indices(kx_hw *hw)
+{
+ for(int pgm=1;pgm<MAX_PGM_NUMBER;pgm++)
+ {
+  unsigned long flags=0;
+  kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+  dsp_microcode *m=hw->pgm_map[pgm];
+  kx_register_index *idx=hw->pgm_index[pgm];
+  int rebuild=(m && get_register_index(hw,m)==NULL);
+  if(idx && (m==NULL || rebuild))
+   hw->pgm_index[pgm]=NULL;
+  else
+   idx=NULL;
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+  if(idx)
+   (hw->cb.free_func)(hw->cb.call_with,idx);
+  if(rebuild)
+   build_register_index(hw,m);
+ }
+}
+
+KX_API(int,kx_dsp_begin(kx_hw *hw,void *owner))
+{
+ if(!(hw->initialized&KX_DSP_INITED))
+ {
+   debug(DLIB,"!!! dsp_begin() w/o being inited\n");
+   return -5;
+ }
+
+ if(txn_busy(hw))
+  return -12;
+
+ kx_dsp_txn *txn=NULL;
+ (hw->cb.malloc_func)(hw->cb.call_with,sizeof(kx_dsp_txn),(void **)&txn,KX_NONPAGED);
+ if(!txn)
+ {
+  debug(DLIB,"!! dsp_begin: not enough memory\n");
+  return -2;
+ }
+ memset(txn,0,sizeof(kx_dsp_txn));
+ init_list(&txn->unloaded);
+ txn->owner=owner;
+ txn->thread=kx_current_thread();
+ txn->touched=txn_clock(hw);
+
+ // storage for info[].translated of every microcode; allocated without dsp_lock held
+ unsigned long flags=0;
+ dword allocated=0;
+ while(1)
+ {
+  kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+  dword n=0;
+  struct list *item;
+  for_each_list_entry(item, &hw->microcodes)
+  {
+   dsp_microcode *m=list_item(item, dsp_microcode, list);
+   n+=m->info_size/sizeof(dsp_register_info);
+  }
+  if(txn->translated && n<=allocated)
+   break;
+
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+  if(txn->translated)
+   (hw->cb.free_func)(hw->cb.call_with,txn->translated);
+  txn->translated=NULL;
+  allocated=n+1;
+  (hw->cb.malloc_func)(hw->cb.call_with,allocated*sizeof(word),(void **)&txn->translated,KX_NONPAGED);
+  if(!txn->translated)
+  {
+   debug(DLIB,"!! dsp_begin: not enough memory\n");
+   txn_free(hw,txn,&txn->unloaded);
+   return -2;
+  }
+ }
+
+ // dsp_lock is held
+ if(hw->dsp_txn)
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  debug(DLIB,"!! dsp_begin: another transaction is pending\n");
+  txn_free(hw,txn,&txn->unloaded);
+  return -1;
+ }
+
+ memcpy(txn->regs_live,hw->fx_regs_usage,sizeof(hw->fx_regs_usage));
+ memcpy(txn->microcode_live,hw->fx_microcode_usage,sizeof(hw->fx_microcode_usage));
+
+ word *p=txn->translated;
+ struct list *item;
+ for_each_list_entry(item, &hw->microcodes)
+ {
+  dsp_microcode *m=list_item(item, dsp_microcode, list);
+  if(txn->n_saved>=MAX_PGM_NUMBER)
+  {
+   kx_lock_release(hw,&hw->dsp_lock,&flags);
+   debug(DLIB,"!! dsp_begin: too many microcodes\n");
+   txn_free(hw,txn,&txn->unloaded);
+   return -3;
+  }
+  kx_txn_microcode *sm=&txn->saved[txn->n_saved++];
+  sm->m=m;
+  sm->flag=m->flag;
+  sm->offset=m->offset;
+  sm->itram_start=m->itram_start;
+  sm->xtram_start=m->xtram_start;
+  sm->translated=p;
+  for(dword j=0;j<m->info_size/sizeof(dsp_register_info);j++)
+   *p++=m->info[j].translated;
+ }
+
+ hw->dsp_txn=txn;
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+ return 0;
+}
+
+KX_API(int,kx_dsp_commit(kx_hw *hw,void *owner))
+{
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ kx_dsp_txn *txn=hw->dsp_txn;
+ if(!txn || txn->owner!=owner)
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  debug(DLIB,"!! dsp_commit: no transaction\n");
+  return -1;
+ }
+
+ hw->dsp_txn=NULL; // write_instruction() / write_dsp_register() go to the hardware again
+
+ // new microcode: the running graph neither executes nor reads it yet
+ int i;
+ int pending=txn->n_regs;
+ for(i=0;i<hw->microcode_size;i++)
+ {
+  if(!get_bit(txn->dirty,i))
+   continue;
+  kx_txn_instruction *op=&txn->code[i];
+  if(get_bit(txn->microcode_live,i) || !is_fresh_register(hw,txn,op->z))
+  {
+   pending++;
+   continue;
+  }
+  hwOP(i,op->op,op->z,op->w,op->x,op->y);
+  clear_bit(txn->dirty,i);
+ }
+
+ // the rest, within one DSP stop
+ if(pending)
+ {
+  int stopped=dsp_stop_if_running(hw);
+
+  for(i=0;i<hw->microcode_size;i++)
+  {
+   if(!get_bit(txn->dirty,i))
+    continue;
+   kx_txn_instruction *op=&txn->code[i];
+   hwOP(i,op->op,op->z,op->w,op->x,op->y);
+  }
+  dword burst[KX_REG_BURST*2];
+  int cnt=0;
+  for(i=0;txn->n_regs && i<KX_DSP_TXN_REGS;i++)
+  {
+   if(!get_bit(txn->reg_queued,i))
+    continue;
+   burst[cnt*2]=i;
+   burst[cnt*2+1]=txn->reg_val[i];
+   if(++cnt==KX_REG_BURST)
+   {
+    kx_writeptr_list(hw,0,burst,cnt);
+    cnt=0;
+   }
+  }
+  if(cnt)
+   kx_writeptr_list(hw,0,burst,cnt);
+
+  if(stopped)
+   kx_dsp_go(hw);
+ }
+
+ for(i=0;i<FX_REGISTER_MASSIVE_SIZE;i++)
+  hw->fx_regs_usage[i]&=~txn->regs_free[i];
+ for(i=0;i<FX_MICROCODE_MASSIVE_SIZE;i++)
+  hw->fx_microcode_usage[i]&=~txn->microcode_free[i];
+
+ telemetry_drop_unloaded(hw);
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+ txn_free(hw,txn,&txn->unloaded);
+
+ return 0;
+}
+
+KX_API(int,kx_dsp_abort(kx_hw *hw,void *owner))
+{
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ kx_dsp_txn *txn=hw->dsp_txn;
+ if(!txn || txn->owner!=owner)
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  debug(DLIB,"!! dsp_abort: no transaction\n");
+  return -1;
+ }
+
+ txn_abort(hw,&flags);
+
+ return 0;
+}
+
+// rolls back hw->dsp_txn; called with dsp_lock held, which is released
+static void txn_abort(kx_hw *hw,unsigned long *flags)
+{
+ kx_dsp_txn *txn=hw->dsp_txn;
+ hw->dsp_txn=NULL;
+
+ struct list created;
+ init_list(&created);
+ txn_rollback(hw,txn,&created);
+
+ kx_lock_release(hw,&hw->dsp_lock,flags);
+
+ txn_free(hw,txn,&created);
+ txn_rebuild_indices(hw);
+}
+
+// the OS layer calls these around every request of a client: while a request of the owner of the
+// pending transaction is in progress, its thread is recorded (one at a time: a concurrent request
+// of the owner on another thread is treated as another client's)
+// no transaction is pending almost always: this is checked without dsp_lock (a transaction begun
+// concurrently is not the caller's, since kx_dsp_begin() itself runs within enter/leave)
+KX_API(void,kx_dsp_enter(kx_hw *hw,void *client))
+{
+ if(hw->dsp_txn==NULL)
+  return;
+
+ dword now=txn_clock(hw);
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ kx_dsp_txn *txn=hw->dsp_txn;
+ if(txn && txn->owner==client && txn->thread==NULL)
+ {
+  txn->thread=kx_current_thread();
+  txn->touched=now;
+ }
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+}
+
+KX_API(void,kx_dsp_leave(kx_hw *hw,void *client))
+{
+ if(hw->dsp_txn==NULL)
+  return;
+
+ dword now=txn_clock(hw);
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ kx_dsp_txn *txn=hw->dsp_txn;
+ if(txn && txn->owner==client && txn->thread==kx_current_thread())
+ {
+  txn->thread=NULL;
+  txn->touched=now;
+ }
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+}
+
+// the OS layer: 'client' is gone (its handle was closed or the process died)
+KX_API(void,kx_dsp_release(kx_hw *hw,void *client))
+{
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ if(hw->dsp_txn && hw->dsp_txn->owner==client)
+ {
+  debug(DLIB,"!! dsp: the owner of a transaction is gone; rolled back\n");
+  txn_abort(hw,&flags);
+ }
+ else
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+}
+
+// -----
+// DSP telemetry
+// -----
+// clients register taps (pgm + register) once; the driver samples them from the interval timer
+// into hw->telemetry, which the OS layer maps read-only into the client processes, so meters
+// are read without any requests; taps are resolved every frame, thus they survive re-translation
+
+// taps of microcode that is gone; called with dsp_lock held
+static void telemetry_drop_unloaded(kx_hw *hw)
+{
+ kx_telemetry_page *page=hw->telemetry;
+ if(page==NULL || hw->telemetry_taps==0)
+  return;
+
+ for(int i=0;i<KX_TELEMETRY_TAPS;i++)
+ {
+  if(hw->telemetry_refs[i] && find_microcode(hw,page->taps[i].pgm)==NULL)
+  {
+   debug(DLIB,"telemetry: microcode %d unloaded; tap %d dropped\n",page->taps[i].pgm,i);
+   page->taps[i].pgm=0;
+   hw->telemetry_refs[i]=0;
+   hw->telemetry_owner[i]=NULL;
+   hw->telemetry_taps--;
+  }
+ }
+}
+
+// called by the interval timer (with timer_lock held)
+static void telemetry_timer_func(void *data,int /*what*/)
+{
+ kx_hw *hw=(kx_hw *)data;
+ dword regs[KX_TELEMETRY_TAPS],vals[KX_TELEMETRY_TAPS],reset[KX_TELEMETRY_TAPS*2];
+ int taps[KX_TELEMETRY_TAPS];
+ int n=0,n_reset=0;
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ kx_telemetry_page *page=hw->telemetry;
+ // within a transaction pgm_map[] may refer to microcode that is not running yet
+ if(page==NULL || hw->telemetry_taps==0 || hw->dsp_txn)
+ {
+  // the last taps went with their microcode: the timer stops until telemetry_timer_sync()
+  if(page==NULL || hw->telemetry_taps==0)
+   hw->telemetry_timer.status&=~TIMER_ACTIVE;
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  return;
+ }
+
+ telemetry_drop_unloaded(hw);
+
+ kx_telemetry_frame *f=&page->frames[page->seq&(KX_TELEMETRY_FRAMES-1)];
+
+ for(int i=0;i<KX_TELEMETRY_TAPS;i++)
+ {
+  kx_telemetry_tap *t=&page->taps[i];
+  f->val[i]=0;
+  if(hw->telemetry_refs[i]==0)
+   continue;
+
+  dsp_microcode *m=find_microcode(hw,t->pgm);
+  dsp_register_info *info=m?find_dsp_register_in_m(hw,m,t->id):NULL;
+  if(info==NULL || !is_valid_gpr(info->translated))
+  {
+   t->flags&=~KX_TAP_SAMPLED;
+   continue;
+  }
+  t->flags|=KX_TAP_SAMPLED;
+  taps[n]=i;
+  regs[n++]=info->translated;
+  if(t->flags&KX_TAP_RESET)
+  {
+   reset[n_reset*2]=info->translated;
+   reset[n_reset*2+1]=0;
+   n_reset++;
+  }
+ }
+
+ kx_readptr_list(hw,0,regs,vals,n);
+ if(n_reset)
+  kx_writeptr_list(hw,0,reset,n_reset);
+ for(int i=0;i<n;i++)
+  f->val[taps[i]]=vals[i];
+
+ // the frame is complete before it is published
+ f->sample_counter=kx_readfn0(hw,WC_SAMPLECOUNTER);
+ page->seq++;
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+}
+
+// the timer runs while there are taps: installed with the first one, uninstalled with the last;
+// called with telemetry_lock held (the timer callback takes dsp_lock: timer_lock cannot be
+// acquired with it held)
+static void telemetry_timer_sync(kx_hw *hw)
+{
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ int taps=hw->telemetry?hw->telemetry_taps:0;
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+ int installed=(hw->telemetry_timer.status&TIMER_INSTALLED);
+ if(taps)
+ {
+  if(!installed)
+  {
+   hw->telemetry_timer.timer_func=telemetry_timer_func;
+   hw->telemetry_timer.data=hw;
+   kx_timer_install(hw,&hw->telemetry_timer,KX_TELEMETRY_PERIOD);
+  }
+  kx_timer_enable(hw,&hw->telemetry_timer);
+ }
+ else if(installed)
+ {
+  kx_timer_disable(hw,&hw->telemetry_timer);
+  kx_timer_uninstall(hw,&hw->telemetry_timer);
+ }
+}
+
+KX_API(int,kx_telemetry_attach(kx_hw *hw,kx_telemetry_page *page))
+{
+ unsigned long tflags=0;
+ kx_lock_acquire(hw,&hw->telemetry_lock,&tflags);
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+
+ kx_telemetry_page *prev=hw->telemetry;
+ if(page && prev)
+ {
+  kx_lock_release(hw,&hw->dsp_lock,&flags);
+  kx_lock_release(hw,&hw->telemetry_lock,&tflags);
+  return -1; // already attached
+ }
+ if(page)
+ {
+  memset(page,0,sizeof(kx_telemetry_page));
+  page->magic=KX_TELEMETRY_MAGIC;
+  page->size=sizeof(kx_telemetry_page);
+  page->period=KX_TELEMETRY_PERIOD;
+ }
+ hw->telemetry=page;
+ memset(hw->telemetry_refs,0,sizeof(hw->telemetry_refs));
+ memset(hw->telemetry_owner,0,sizeof(hw->telemetry_owner));
+ hw->telemetry_taps=0;
+
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+
+ telemetry_timer_sync(hw);
+
+ kx_lock_release(hw,&hw->telemetry_lock,&tflags);
+
+ return 0;
+}
+
+static int telemetry_add_tap(kx_hw *hw,dsp_microcode *m,dsp_register_info *info,word flags,void *client)
+{
+ kx_telemetry_page *page=hw->telemetry;
+ int i,slot=-1;
+
+ if(page==NULL)
+  return -2;
+
+ flags&=KX_TAP_RESET;
+ for(i=0;i<KX_TELEMETRY_TAPS;i++)
+ {
+  if(hw->telemetry_refs[i]==0)
+  {
+   if(slot==-1)
+    slot=i;
+   continue;
+  }
+  if(hw->telemetry_owner[i]==client &&
+     page->taps[i].pgm==m->pgm && page->taps[i].id==info->num && (page->taps[i].flags&KX_TAP_RESET)==flags)
+  {
+   hw->telemetry_refs[i]++;
+   return i;
+  }
+ }
+ if(slot==-1)
+ {
+  debug(DLIB,"!! telemetry: no free taps\n");
+  return -3;
+ }
+
+ page->taps[slot].id=info->num;
+ page->taps[slot].flags=flags;
+ page->taps[slot].pgm=m->pgm;
+ hw->telemetry_refs[slot]=1;
+ hw->telemetry_owner[slot]=client;
+ hw->telemetry_taps++;
+
+ return slot;
+}
+
+KX_API(int,kx_telemetry_add_tap(kx_hw *hw,int pgm,const char *name,word flags,void *client))
+{
+ int ret=-1;
+ unsigned long tfl=0;
+ kx_lock_acquire(hw,&hw->telemetry_lock,&tfl);
+ unsigned long fl=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&fl);
+ dsp_microcode *m=find_microcode(hw,pgm);
+ dsp_register_info *info=m?find_dsp_register_in_m(hw,m,name):NULL;
+ if(info)
+  ret=telemetry_add_tap(hw,m,info,flags,client);
+ kx_lock_release(hw,&hw->dsp_lock,&fl);
+ if(ret>=0)
+  telemetry_timer_sync(hw);
+ kx_lock_release(hw,&hw->telemetry_lock,&tfl);
+ return ret;
+}
+
+KX_API(int,kx_telemetry_add_tap(kx_hw *hw,int pgm,word id,word flags,void *client))
+{
+ int ret=-1;
+ unsigned long tfl=0;
+ kx_lock_acquire(hw,&hw->telemetry_lock,&tfl);
+ unsigned long fl=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&fl);
+ dsp_microcode *m=find_microcode(hw,pgm);
+ dsp_register_info *info=m?find_dsp_register_in_m(hw,m,id):NULL;
+ if(info)
+  ret=telemetry_add_tap(hw,m,info,flags,client);
+ kx_lock_release(hw,&hw->dsp_lock,&fl);
+ if(ret>=0)
+  telemetry_timer_sync(hw);
+ kx_lock_release(hw,&hw->telemetry_lock,&tfl);
+ return ret;
+}
+
+KX_API(int,kx_telemetry_remove_tap(kx_hw *hw,int tap,void *client))
+{
+ int ret=-1;
+ unsigned long tflags=0;
+ kx_lock_acquire(hw,&hw->telemetry_lock,&tflags);
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ if(hw->telemetry && tap>=0 && tap<KX_TELEMETRY_TAPS && hw->telemetry_refs[tap] && hw->telemetry_owner[tap]==client)
+ {
+  if(--hw->telemetry_refs[tap]==0)
+  {
+   hw->telemetry->taps[tap].pgm=0;
+   hw->telemetry_owner[tap]=NULL;
+   hw->telemetry_taps--;
+  }
+  ret=0;
+ }
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+ telemetry_timer_sync(hw);
+ kx_lock_release(hw,&hw->telemetry_lock,&tflags);
+ return ret;
+}
+
+// the OS layer: 'client' is gone; called along with unmapping its page
+KX_API(void,kx_telemetry_release(kx_hw *hw,void *client))
+{
+ unsigned long tflags=0;
+ kx_lock_acquire(hw,&hw->telemetry_lock,&tflags);
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->dsp_lock,&flags);
+ for(int i=0;i<KX_TELEMETRY_TAPS;i++)
+ {
+  if(hw->telemetry && hw->telemetry_refs[i] && hw->telemetry_owner[i]==client)
+  {
+   hw->telemetry->taps[i].pgm=0;
+   hw->telemetry_refs[i]=0;
+   hw->telemetry_owner[i]=NULL;
+   hw->telemetry_taps--;
+  }
+ }
+ kx_lock_release(hw,&hw->dsp_lock,&flags);
+ telemetry_timer_sync(hw);
+ kx_lock_release(hw,&hw->telemetry_lock,&tflags);
+}
+
 KX_API(int,kx_set_microcode_name(kx_hw *hw,int pgm_id,const char *str,int what))
 {
   if(!(hw->initialized&KX_DSP_INITED))
@@ -3168,6 +4445,9 @@ KX_API(int,kx_get_connections(kx_hw *hw,int pgm,kxconnections *out,int size))
 
 KX_API(int,kx_dsp_reload_epilog(kx_hw *hw))
 {
+ if(txn_busy(hw))
+  return -12;
+
     	const char *microcode_name;
     	int last_gpr=0x8000;
     	int last_input_gpr=0x4000;
@@ -3316,6 +4596,9 @@ KX_API(int,kx_update_microcode(kx_hw *hw,int pgm_id,const char *name,dsp_code *c
    		const char *guid,
    		unsigned int flag))
 {
+ if(txn_busy(hw))
+  return -12;
+
  debug(DLIB,"update microcode: pgm: %d; name: '%s'; code/info: %d/%d; flag: %x\n",
   pgm_id,name,code_size,info_size,flag);
 
@@ -3354,6 +4637,13 @@ KX_API(int,kx_update_microcode(kx_hw *hw,int pgm_id,const char *name,dsp_code *c
             kxconnections ins[64];
             int size=kx_get_connections(hw,pgm_id,NULL,0);
 
+            if((flag&IKX_UPDATE_DSP) && hw->dsp_txn)
+            {
+                // code[] / info[] cannot be restored by kx_dsp_abort()
+                debug(DLIB,"!! update_microcode: DSP transaction pending [%d]\n",pgm_id);
+                return -3;
+            }
+
             if(flag&IKX_UPDATE_DSP)
             {
                 if(size>=0 && (size_t)size<sizeof(ins) && (kx_get_connections(hw,pgm_id,ins,size)==0))
@@ -3376,18 +4666,25 @@ KX_API(int,kx_update_microcode(kx_hw *hw,int pgm_id,const char *name,dsp_code *c
                       (hw->cb.malloc_func)(hw->cb.call_with,code_size,(void **)&m->code,KX_NONPAGED);
                     if(m->code)
                      memcpy(m->code,code,code_size);
+                    else
+                     m->code_size=0;
                  }
                  if((flag&IKX_UPDATE_REGS) && info)
                  {
-                    m->info=0;
-                    m->info_size=info_size;
                     if(m->info)
                      (hw->cb.free_func)(hw->cb.call_with,m->info);
+                    m->info=0;
+                    m->info_size=info_size;
                     if(info_size)
                       (hw->cb.malloc_func)(hw->cb.call_with,info_size,(void **)&m->info,KX_NONPAGED);
                     if(m->info)
                      memcpy(m->info,info,info_size);
+                    else
+                     m->info_size=0;
                  }
+                 // operand table refers to both code[] and info[]
+                 if(((flag&IKX_UPDATE_CODE) && code) || ((flag&IKX_UPDATE_REGS) && info))
+                  build_register_index(hw,m);
 
                  if(flag&IKX_UPDATE_RESOURCES)
                  {
@@ -394,6 +394,62 @@ KX_API(void,kx_writeptr_multiple(kx_hw *hw, dword channel, ...))
     va_end(args);
 }
 
+// kx_writeptr_multiple() with a run-time list: 'n' reg/data pairs
+KX_API(void,kx_writeptr_list(kx_hw *hw, dword channel, const dword *list, int n))
+{
+    unsigned long flags=0;
+
+    kx_lock_acquire(hw,&hw->hw_lock, &flags);
+    for(int i=0;i<n;i++)
+    {
+        dword reg = list[i*2];
+        dword data = list[i*2+1];
+        dword regptr = (((reg << 16) & PTR_ADDRESS_MASK)
+                  | (channel & PTR_CHANNELNUM_MASK));
+        outpd(hw->port + PTR,regptr);
+
+        if(reg & 0xff000000) 
+        {
+            int size = (reg >> 24) & 0x3f;
+            int offset = (reg >> 16) & 0x1f;
+            dword mask = ((1 << size) - 1) << offset;
+            data = (data << offset) & mask;
+
+            data |= inpd(hw->port + DATA) & ~mask;
+        }
+        outpd(hw->port + DATA,data);
+    }
+    kx_lock_release(hw,&hw->hw_lock, &flags);
+}
+
+// reads 'n' registers (whole 32-bit values only) with hw_lock taken once
+KX_API(void,kx_readptr_list(kx_hw *hw, dword channel, const dword *regs, dword *vals, int n))
+{
+    unsigned long flags=0;
+
+    kx_lock_acquire(hw,&hw->hw_lock, &flags);
+    for(int i=0;i<n;i++)
+    {
+        outpd(hw->port + PTR,((regs[i] << 16) & PTR_ADDRESS_MASK) | (channel & PTR_CHANNELNUM_MASK));
+        vals[i] = inpd(hw->port + DATA);
+    }
+    kx_lock_release(hw,&hw->hw_lock, &flags);
+}
+
+// kx_readptr_list() for registers of different channels
+KX_API(void,kx_readptr_gather(kx_hw *hw, const dword *regs, const dword *channels, dword *vals, int n))
+{
+    unsigned long flags=0;
+
+    kx_lock_acquire(hw,&hw->hw_lock, &flags);
+    for(int i=0;i<n;i++)
+    {
+        outpd(hw->port + PTR,((regs[i] << 16) & PTR_ADDRESS_MASK) | (channels[i] & PTR_CHANNELNUM_MASK));
+        vals[i] = inpd(hw->port + DATA);
+    }
+    kx_lock_release(hw,&hw->hw_lock, &flags);
+}
+
 KX_API(dword, kx_readptr(kx_hw * hw, dword reg, dword channel))
 {
     dword regptr, val;
@@ -1328,6 +1384,79 @@ KX_API(int,kx_get_hw_parameter(kx_hw *hw,int id,dword *value))
     case KX_HW_DRUM_CHANNEL:
         *value=hw->drum_channel;
         break;
+    case KX_HW_SYNTH_ALLOCATIONS:
+        *value=hw->synth_allocations;
+        break;
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_WAVE:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_MIDI:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_ASIO:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_AC3:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_3D:
+        *value=hw->voice_quota[id-KX_HW_VOICE_QUOTA];
+        break;
+    case KX_HW_VOICE_ALLOCATIONS:
+        *value=hw->voice_allocs;
+        break;
+    case KX_HW_VOICE_ALLOC_FAILURES:
+        *value=hw->voice_alloc_failures;
+        break;
+    case KX_HW_VOICE_ALLOC_STEALS:
+        *value=hw->voice_alloc_steals;
+        break;
+    case KX_HW_VOICE_ALLOC_LATENCY:
+        {
+         unsigned long flags=0;
+         kx_lock_acquire(hw,&hw->k_lock,&flags);
+         *value=(hw->voice_allocs+hw->voice_alloc_failures)?
+           (dword)(hw->voice_alloc_ticks/(hw->voice_allocs+hw->voice_alloc_failures)):0;
+         kx_lock_release(hw,&hw->k_lock,&flags);
+        }
+        break;
+    case KX_HW_VOICE_ALLOC_LATENCY_MAX:
+        *value=hw->voice_alloc_ticks_max;
+        break;
+    case KX_HW_SYNTH_CHANGES:
+        *value=hw->synth_changes;
+        break;
+    case KX_HW_SYNTH_UPDATES:
+        *value=hw->synth_updates;
+        break;
+    case KX_HW_SYNTH_CLOCK:
+        *value=kx_voice_clock(hw);
+        break;
+    case KX_HW_MIDI_QUEUE_DEPTH:
+        *value=hw->midi_queued;
+        break;
+    case KX_HW_MIDI_QUEUE_MAX:
+        *value=hw->midi_queue_max;
+        break;
+    case KX_HW_MIDI_EVENTS:
+        *value=hw->midi_events;
+        break;
+    case KX_HW_MIDI_LATE:
+        *value=hw->midi_late;
+        break;
+    case KX_HW_MIDI_LATE_MAX:
+        *value=hw->midi_late_max;
+        break;
+    case KX_HW_MIDI_DROPPED:
+        *value=hw->midi_dropped;
+        break;
+    case KX_HW_SF_POOL_SIZE:
+        *value=hw->sf_pool_size/1024;
+        break;
+    case KX_HW_SF_POOL_HITS:
+        *value=hw->sf_hits;
+        break;
+    case KX_HW_SF_POOL_MISSES:
+        *value=hw->sf_misses;
+        break;
+    case KX_HW_SF_POOL_EVICTIONS:
+        *value=hw->sf_evictions;
+        break;
+    case KX_HW_SF_POOL_DROPPED:
+        *value=hw->sf_dropped;
+        break;
     default:
         *value=0;
         return -1;
@@ -1726,6 +1855,56 @@ KX_API(int,kx_set_hw_parameter(kx_hw *hw,int id,dword value))
     case KX_HW_DRUM_CHANNEL:
         hw->drum_channel=value;
         break;
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_WAVE:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_MIDI:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_ASIO:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_AC3:
+    case KX_HW_VOICE_QUOTA+KX_VOICE_CLASS_3D:
+        if(value>KX_NUMBER_OF_VOICES)
+         return -1;
+        hw->voice_quota[id-KX_HW_VOICE_QUOTA]=value; // voices above the quota are not freed
+        break;
+    case KX_HW_VOICE_ALLOCATIONS:
+        {
+         unsigned long flags=0;
+         kx_lock_acquire(hw,&hw->k_lock,&flags);
+         hw->voice_allocs=0;
+         hw->voice_alloc_failures=0;
+         hw->voice_alloc_steals=0;
+         hw->voice_alloc_ticks=0;
+         hw->voice_alloc_ticks_max=0;
+         kx_lock_release(hw,&hw->k_lock,&flags);
+        }
+        break;
+    case KX_HW_SYNTH_CHANGES:
+        hw->synth_changes=0;
+        hw->synth_updates=0;
+        break;
+    case KX_HW_MIDI_EVENTS:
+        {
+         unsigned long flags=0;
+         kx_lock_acquire(hw,&hw->k_lock,&flags);
+         hw->midi_queue_max=hw->midi_queued;
+         hw->midi_events=0;
+         hw->midi_late=0;
+         hw->midi_late_max=0;
+         hw->midi_dropped=0;
+         kx_lock_release(hw,&hw->k_lock,&flags);
+        }
+        break;
+    case KX_HW_SF_POOL_SIZE:
+        return kx_sf_pool_init(hw,value*1024);
+    case KX_HW_SF_POOL_HITS:
+        {
+         unsigned long flags=0;
+         kx_lock_acquire(hw,&hw->sf_lock,&flags);
+         hw->sf_hits=0;
+         hw->sf_misses=0;
+         hw->sf_evictions=0;
+         hw->sf_dropped=0;
+         kx_lock_release(hw,&hw->sf_lock,&flags);
+        }
+        break;
     default:
         return -1;
  }
@@ -1902,6 +2081,10 @@ void system_timer_func(void *data,int /*what*/)
 
  kx_hw *hw=(kx_hw *)data;
 
+ // keeps the voice clock from missing a WC_SAMPLECOUNTER wrap (~22s) between notes
+ if(hw->midi[0] || hw->midi[1])
+  kx_voice_clock(hw);
+
  if(hw->is_edsp) // ignore GPIO
  {
   byte card=(byte)kx_readfpga(hw,EMU_HANA_OPTION_CARDS);
@@ -405,6 +405,9 @@ KX_API(int,kx_init(kx_hw **hw_,kx_callbacks *cb,int standalone))
  my_memset(&hw->p16v_rec_timer,0,sizeof(kx_timer));
  hw->p16v_rec_timer.status=TIMER_UNINSTALLED;
 
+ my_memset(&hw->telemetry_timer,0,sizeof(kx_timer));
+ hw->telemetry_timer.status=TIMER_UNINSTALLED;
+
  my_memset(hw->p16v_volumes,0,sizeof(hw->p16v_volumes));
 
  hw->p16v_pb_opened=0;
@@ -423,6 +426,7 @@ KX_API(int,kx_init(kx_hw **hw_,kx_callbacks *cb,int standalone))
  kx_spin_lock_init(hw,&hw->pt_lock,"pt");
  kx_spin_lock_init(hw,&hw->ac97_lock,"ac97");
  kx_spin_lock_init(hw,&hw->dsp_lock,"dsp");
+ kx_spin_lock_init(hw,&hw->telemetry_lock,"telemetry");
  kx_spin_lock_init(hw,&hw->sf_lock,"sf");
 
  // voice init
@@ -434,6 +438,7 @@ KX_API(int,kx_init(kx_hw **hw_,kx_callbacks *cb,int standalone))
   hw->voicetable[i].usage = VOICE_USAGE_FREE;
   hw->voicetable[i].asio_channel = 0xffffffff;
  }
+ kx_voice_alloc_init(hw);
 
  for(i = 0; i < KX_NUMBER_OF_REC_VOICES; i++)
  {
@@ -557,6 +562,9 @@ KX_API(int, kx_close(kx_hw **hw_))
 {
  kx_hw *hw=*hw_;
 
+ // the page itself is freed by the OS layer
+ kx_telemetry_attach(hw,NULL);
+
  if(!(hw->sys_timer.status&TIMER_UNINSTALLED))
  {
   // dangerous: should have been already uninstalled
@@ -708,6 +716,9 @@ KX_API(dword,kx_getdword(kx_hw *hw,int what,dword *ret))
     case KX_DWORD_CAN_K8_PASSTHRU:
         *ret=(dword)hw->can_k8_passthru;
         break;
+    case KX_DWORD_SF_UPLOAD_CHUNK:
+        *ret=KX_SF_UPLOAD_CHUNK;
+        break;
     default:
         *ret=0;
         r=(dword)-1; // not found
@@ -533,6 +533,8 @@ int kx_dsp_close(kx_hw *hw)
 int kx_dsp_init(kx_hw *hw)
 {
  init_list(&hw->microcodes);
+ memset(hw->pgm_map,0,sizeof(hw->pgm_map));
+ memset(hw->pgm_index,0,sizeof(hw->pgm_index));
  hw->initialized|=KX_DSP_INITED;
 
  debug(DLIB,"DSP initialization\n");
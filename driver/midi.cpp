@@ -60,7 +60,7 @@ KX_API(int,kx_midi_set_volume(kx_hw *hw,int chn,dword vol))
 
 
 // midi message parser
-KX_API(int,kx_midi_play_buffer(kx_midi_state *midi,byte *buff,int len))
+static int midi_parse_buffer(kx_midi_state *midi,byte *buff,int len)
 {
  kx_hw *hw=midi->hw;
  if(!hw)
@@ -253,6 +253,245 @@ KX_API(int,kx_midi_play_buffer(kx_midi_state *midi,byte *buff,int len))
  return 0;
 }
 
+static void midi_all_off(kx_midi_state *midi)
+{
+ for(int i=0;i<MAX_MIDI_CHANNELS;i++)
+ {
+  kx_midi_changes(midi,i,CHANGE_CONTROL,64,0); // sustain off
+  kx_midi_changes(midi,i,CHANGE_CONTROL,66,0); // sostenuto off
+  kx_midi_changes(midi,i,CHANGE_CONTROL,69,0); // hold2 off
+  kx_midi_changes(midi,i,CHANGE_CONTROL,123,0); // all notes off
+ }
+}
+
+// the parser is owned by one context at a time (see kx_midi_state)
+// returns 1 if the caller owns it now
+static int midi_parser_claim(kx_midi_state *midi)
+{
+ kx_hw *hw=midi->hw;
+ unsigned long flags=0;
+
+ kx_lock_acquire(hw,&midi->lock,&flags);
+ int ret=!midi->parsing;
+ midi->parsing=1;
+ kx_lock_release(hw,&midi->lock,&flags);
+
+ return ret;
+}
+
+// does the work the other contexts have left, then gives the parser up
+static void midi_parser_release(kx_midi_state *midi)
+{
+ kx_hw *hw=midi->hw;
+ byte buff[KX_MIDI_PENDING];
+ unsigned long flags=0;
+
+ while(1)
+ {
+  // controller changes of the whole chunk: one register update per voice
+  if(midi->inited)
+   kx_synth_flush(midi);
+
+  kx_lock_acquire(hw,&midi->lock,&flags);
+  int len=midi->pending_len;
+  int stop=midi->stop_pending;
+  if(len==0 && !stop)
+  {
+   midi->parsing=0;
+   kx_lock_release(hw,&midi->lock,&flags);
+   break;
+  }
+  memcpy(buff,midi->pending,len);
+  midi->pending_len=0;
+  midi->stop_pending=0;
+  kx_lock_release(hw,&midi->lock,&flags);
+
+  // kx_midi_stop() drops the bytes queued before it
+  if(stop)
+   midi_all_off(midi);
+  if(len)
+   midi_parse_buffer(midi,buff,len);
+ }
+}
+
+KX_API(int,kx_midi_play_buffer(kx_midi_state *midi,byte *buff,int len))
+{
+ kx_hw *hw=midi->hw;
+ if(!hw)
+  return -1;
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&midi->lock,&flags);
+ if(midi->parsing)
+ {
+  // played by the owner of the parser before it gives it up
+  int ret=-3;
+  if(len>=0 && len<=KX_MIDI_PENDING-midi->pending_len)
+  {
+   memcpy(midi->pending+midi->pending_len,buff,len);
+   midi->pending_len+=len;
+   ret=0;
+  }
+  kx_lock_release(hw,&midi->lock,&flags);
+  return ret;
+ }
+ midi->parsing=1;
+ kx_lock_release(hw,&midi->lock,&flags);
+
+ int ret=midi_parse_buffer(midi,buff,len);
+ midi_parser_release(midi);
+
+ return ret;
+}
+
+// timestamped events
+// ----------------
+// events wait in midi->queue (sorted by time) and are played from the interval timer once
+// kx_midi_clock() reaches their time: the timing does not depend on when the caller runs;
+// the timer is enabled only while events are waiting
+
+KX_API(dword,kx_midi_clock(kx_midi_state *midi))
+{
+ return kx_voice_clock(midi->hw);
+}
+
+// called by the interval timer (with timer_lock held)
+static void midi_queue_timer_func(void *data,int /*what*/)
+{
+ kx_midi_state *midi=(kx_midi_state *)data;
+ kx_hw *hw=midi->hw;
+
+ #define MIDI_DISPATCH_BURST 16 // events per timer tick; the rest is played on the next one
+ kx_midi_event due[MIDI_DISPATCH_BURST];
+ int n=0;
+
+ if(!hw)
+  return;
+
+ // another context is parsing: the events stay queued until the next tick
+ if(!midi_parser_claim(midi))
+  return;
+
+ dword now=kx_voice_clock(hw);
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->k_lock,&flags);
+
+ while(midi->queue_count && n<MIDI_DISPATCH_BURST && (int)(midi->queue[midi->queue_head].time-now)<=0)
+ {
+  due[n++]=midi->queue[midi->queue_head];
+  midi->queue_head=(midi->queue_head+1)%KX_MIDI_QUEUE_SIZE;
+  midi->queue_count--;
+ }
+ hw->midi_queued-=n;
+
+ // re-enabled by kx_midi_schedule(); decided under k_lock, so that a new event is not missed
+ // the interval timer is stopped or slowed down once this returns (kx_timer_irq_handler())
+ if(midi->queue_count==0)
+  midi->queue_timer.status&=~TIMER_ACTIVE;
+
+ for(int i=0;i<n;i++)
+ {
+  dword late=now-due[i].time;
+  hw->midi_events++;
+  if(late>KX_MIDI_QUEUE_PERIOD)
+   hw->midi_late++;
+  if(late>hw->midi_late_max)
+   hw->midi_late_max=late;
+ }
+
+ kx_lock_release(hw,&hw->k_lock,&flags);
+
+ for(int i=0;i<n;i++)
+  midi_parse_buffer(midi,due[i].data,due[i].len);
+ midi_parser_release(midi);
+}
+
+KX_API(int,kx_midi_schedule(kx_midi_state *midi,dword time,byte *buff,int len))
+{
+ kx_hw *hw=midi->hw;
+
+ if(!hw || !midi->inited || !buff || len<=0)
+  return -1;
+ if(midi->queue==NULL || len>KX_MIDI_EVENT_BYTES)
+  return -2; // use kx_midi_play_buffer()
+
+ dword now=kx_voice_clock(hw);
+ int ahead=(int)(time-now);
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->k_lock,&flags);
+
+ if(midi->queue==NULL) // kx_midi_close()
+ {
+  kx_lock_release(hw,&hw->k_lock,&flags);
+  return -2;
+ }
+ if(midi->queue_count>=KX_MIDI_QUEUE_SIZE || ahead>KX_MIDI_LOOKAHEAD*hw->card_frequency)
+ {
+  hw->midi_dropped++;
+  kx_lock_release(hw,&hw->k_lock,&flags);
+  return -3;
+ }
+
+ // insert after the events with the same or earlier time: mostly appended
+ int pos=midi->queue_count;
+ while(pos>0)
+ {
+  kx_midi_event *prev=&midi->queue[(midi->queue_head+pos-1)%KX_MIDI_QUEUE_SIZE];
+  if((int)(prev->time-time)<=0)
+   break;
+  midi->queue[(midi->queue_head+pos)%KX_MIDI_QUEUE_SIZE]=*prev;
+  pos--;
+ }
+ kx_midi_event *e=&midi->queue[(midi->queue_head+pos)%KX_MIDI_QUEUE_SIZE];
+ e->time=time;
+ e->len=len;
+ memcpy(e->data,buff,len);
+ midi->queue_count++;
+
+ hw->midi_queued++;
+ if(hw->midi_queued>hw->midi_queue_max)
+  hw->midi_queue_max=hw->midi_queued;
+
+ int enable=!(midi->queue_timer.status&TIMER_ACTIVE);
+
+ kx_lock_release(hw,&hw->k_lock,&flags);
+
+ // the timer callback takes k_lock: timer_lock cannot be acquired with it held
+ if(enable)
+ {
+  kx_lock_acquire(hw,&midi->queue_timer_lock,&flags);
+  if(!midi->queue_closed)
+  {
+   if(!midi->queue_timer_installed)
+   {
+    midi->queue_timer.timer_func=midi_queue_timer_func;
+    midi->queue_timer.data=midi;
+    kx_timer_install(hw,&midi->queue_timer,KX_MIDI_QUEUE_PERIOD);
+    midi->queue_timer_installed=1;
+   }
+   kx_timer_enable(hw,&midi->queue_timer);
+  }
+  kx_lock_release(hw,&midi->queue_timer_lock,&flags);
+ }
+
+ return 0;
+}
+
+// drops the waiting events
+static void midi_queue_clear(kx_midi_state *midi)
+{
+ kx_hw *hw=midi->hw;
+ unsigned long flags=0;
+
+ kx_lock_acquire(hw,&hw->k_lock,&flags);
+ hw->midi_queued-=midi->queue_count;
+ midi->queue_head=0;
+ midi->queue_count=0;
+ kx_lock_release(hw,&hw->k_lock,&flags);
+}
+
 KX_API(int,kx_midi_stop(kx_midi_state *midi))
 {
  kx_hw *hw=midi->hw;
@@ -261,12 +500,22 @@ KX_API(int,kx_midi_stop(kx_midi_state *midi))
  {
     if(midi->inited)
     {
-     for(int i=0;i<MAX_MIDI_CHANNELS;i++)
+     midi_queue_clear(midi);
+
+     // the parser is busy: its owner stops the notes before it gives it up
+     unsigned long flags=0;
+     kx_lock_acquire(hw,&midi->lock,&flags);
+     int owner=!midi->parsing;
+     midi->parsing=1;
+     if(!owner)
+      midi->stop_pending=1;
+     midi->pending_len=0;
+     kx_lock_release(hw,&midi->lock,&flags);
+
+     if(owner)
      {
-      kx_midi_changes(midi,i,CHANGE_CONTROL,64,0); // sustain off
-      kx_midi_changes(midi,i,CHANGE_CONTROL,66,0); // sostenuto off
-      kx_midi_changes(midi,i,CHANGE_CONTROL,69,0); // hold2 off
-      kx_midi_changes(midi,i,CHANGE_CONTROL,123,0); // all notes off
+      midi_all_off(midi);
+      midi_parser_release(midi);
      }
     }
  }
@@ -997,6 +1246,20 @@ KX_API(int,kx_midi_init(kx_hw *hw,kx_midi_state *midi,int synth_))
  midi->inited=1; 
  midi->synth_num=synth_;
 
+ // voice parameter tables for kx_synth_start()
+ (hw->cb.malloc_func)(hw->cb.call_with,KX_SYNTH_ARENAS*KX_MAX_SF_VOICES*sizeof(kx_voice_param),(void **)&midi->arena,KX_NONPAGED);
+ if(midi->arena==NULL)
+  debug(DERR,"!! midi_init: no memory for voice parameters; notes will allocate\n");
+ midi->arena_busy=0;
+
+ // timestamped events: the timer is installed by the first kx_midi_schedule()
+ (hw->cb.malloc_func)(hw->cb.call_with,KX_MIDI_QUEUE_SIZE*sizeof(kx_midi_event),(void **)&midi->queue,KX_NONPAGED);
+ if(midi->queue==NULL)
+  debug(DERR,"!! midi_init: no memory for the event queue; kx_midi_schedule() disabled\n");
+ midi->queue_timer.status=TIMER_UNINSTALLED;
+ kx_spin_lock_init(hw,&midi->queue_timer_lock,"midi_queue");
+ kx_spin_lock_init(hw,&midi->lock,"midi");
+
  debug(DLIB,"Midi initialized\n");
 
  for(int i=0;i<16;i++)
@@ -1004,6 +1267,7 @@ KX_API(int,kx_midi_init(kx_hw *hw,kx_midi_state *midi,int synth_))
   kx_reset_all_controllers(midi,i,1);
   midi->channels[i].program=0x0;
  }
+ kx_synth_flush(midi); // no voices yet: clears the dirty masks
 
  if(hw->midi[synth_&1]==NULL)
   hw->midi[synth_&1]=midi;
@@ -1018,8 +1282,38 @@ KX_API(int,kx_midi_close(kx_midi_state *midi))
  if(!hw)
   return -2;
 
+ // kx_timer_uninstall() takes timer_lock: the callback is not running once it returns,
+ // and kx_midi_schedule() does not install the timer again
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&midi->queue_timer_lock,&flags);
+ midi->queue_closed=1;
+ if(midi->queue_timer_installed)
+ {
+  kx_timer_disable(hw,&midi->queue_timer);
+  kx_timer_uninstall(hw,&midi->queue_timer);
+  midi->queue_timer_installed=0;
+ }
+ kx_lock_release(hw,&midi->queue_timer_lock,&flags);
+
  kx_midi_stop(midi);
 
+ kx_lock_acquire(hw,&hw->k_lock,&flags);
+ kx_midi_event *queue=midi->queue;
+ midi->queue=NULL;
+ kx_lock_release(hw,&hw->k_lock,&flags);
+ if(queue)
+  (hw->cb.free_func)(hw->cb.call_with,queue);
+
+ if(midi->arena)
+ {
+  (hw->cb.free_func)(hw->cb.call_with,midi->arena);
+  midi->arena=NULL;
+ }
+
+ // the timer is gone; the caller does not use 'midi' any more
+ kx_spin_lock_free(hw,&midi->lock);
+ kx_spin_lock_free(hw,&midi->queue_timer_lock);
+
  midi->hw=NULL;
  midi->inited=0;
 
@@ -23,6 +23,434 @@
 
 #define MAX_SOUNDFONTS	1024
 
+// SoundFont zone index
+// --------------------
+// sf_find_voice() is called for each note-on; instead of walking the preset / instrument bags
+// and generator lists there, each preset is flattened once, when the SoundFont is loaded:
+// - one zone per (preset zone, instrument zone) pair, in file order
+// - global zones merged, key / velocity ranges intersected, final sf2_params[] and sample offsets
+// - preset headers are hashed by (bank,preset); drum kits are bank 128
+// the zone parameters are exactly what the original per-note parser computed
+
+static void sf_fill_zone(kx_sound_font *sf,kx_sf_zone *z,sf_parameters_t *inst,sf_parameters_t *preset,int nsample,int flags)
+{
+ z->flags=flags;
+
+ // key range
+ z->key_lo=-32768; z->key_hi=32767;
+ if(inst[43].flag)
+ {
+  if(inst[43].gen&0x8080)
+   { z->key_lo=1; z->key_hi=0; }
+  else
+  {
+   if(z->key_lo<(short)(inst[43].gen&0xff)) z->key_lo=(short)(inst[43].gen&0xff);
+   if(z->key_hi>(short)((inst[43].gen>>8)&0xff)) z->key_hi=(short)((inst[43].gen>>8)&0xff);
+  }
+ }
+ if(preset[43].flag)
+ {
+  if(preset[43].gen&0x8080)
+   { z->key_lo=1; z->key_hi=0; }
+  else
+  {
+   if(z->key_lo<(short)(preset[43].gen&0xff)) z->key_lo=(short)(preset[43].gen&0xff);
+   if(z->key_hi>(short)((preset[43].gen>>8)&0xff)) z->key_hi=(short)((preset[43].gen>>8)&0xff);
+  }
+ }
+ // velocity range
+ z->vel_lo=-32768; z->vel_hi=32767;
+ if(inst[44].flag)
+ {
+  if(z->vel_lo<(short)(inst[44].gen&0xff)) z->vel_lo=(short)(inst[44].gen&0xff);
+  if(z->vel_hi>(short)((inst[44].gen>>8)&0xff)) z->vel_hi=(short)((inst[44].gen>>8)&0xff);
+ }
+ if(preset[44].flag)
+ {
+  if(z->vel_lo<(short)(preset[44].gen&0xff)) z->vel_lo=(short)(preset[44].gen&0xff);
+  if(z->vel_hi>(short)((preset[44].gen>>8)&0xff)) z->vel_hi=(short)((preset[44].gen>>8)&0xff);
+ }
+
+ int start_addr=(int)(short)inst[0].gen+(int)((short)inst[4].gen)*32768;
+ int end_addr=(int)(short)inst[1].gen+(int)((short)inst[12].gen)*32768;
+ int start_loop=(int)(short)inst[2].gen+(int)((short)inst[45].gen)*32768;
+ int end_loop=(int)(short)inst[3].gen+(int)((short)inst[50].gen)*32768;
+
+ for(int ttt=0;ttt<SF_PARAMETERS;ttt++)
+ {
+  switch(ttt)
+  {
+   case 51: // coarse tune, semitones
+   case 52: // fune tune, cents
+   case 9: // initial_filterQ (cB)
+   case 15: // chorus %
+   case 16: // rev %
+   case 17: // pan %
+   case 29: // modenv sustain, %
+   case 37: // volenv sustain, cB
+   case 48: // init. attn, cB
+   case 11: // modenv to filter cutoff
+   case 7: // modenv to pitch
+   case 5: // modlfo to pitch
+   case 6: // viblfo to pitch
+   case 10: // modlfo to filter cutoff
+   case 13: // modlfo to vol
+   default:
+    z->sf2_params[ttt]=(int)(short)inst[ttt].gen+(int)(short)preset[ttt].gen;
+    break;
+   case 21:
+   case 23: // molfo delay / viblfo delay
+   case 25: // vol env params
+   case 26:
+   case 27:
+   case 28:
+   case 30:
+   case 33: // mod env params
+   case 34:
+   case 35:
+   case 36:
+   case 38:
+   	// timings in 'msec'<->abs cents - special case
+   	if(inst[ttt].flag)
+   	 z->sf2_params[ttt]=(int)(short)inst[ttt].gen+(int)(short)preset[ttt].gen;
+   	else
+   	 z->sf2_params[ttt]=-12000+(int)(short)preset[ttt].gen;
+   	break;
+   case 22:
+   case 24: // modlfo / viblfo freqs
+   case 31:
+   case 32:
+   case 39:
+   case 40: // keynum to something...
+   	 z->sf2_params[ttt]=(int)(short)inst[ttt].gen+(int)(short)preset[ttt].gen;
+   	break;
+   case 8: // initial filter cutoff
+   	if(inst[ttt].flag)
+   	 z->sf2_params[ttt]=(int)(short)inst[ttt].gen+(preset[ttt].flag?(int)(short)preset[ttt].gen:0);
+   	else
+   	 z->sf2_params[ttt]=13500+(int)(short)preset[ttt].gen; // 20000 Hz
+    break;
+  }
+ }
+
+ if(inst[47].flag && inst[47].gen!=(word)-1) // force_velocity
+  z->sf2_params[47]=(int)(short)inst[47].gen;
+ else
+  z->sf2_params[47]=-1;
+
+ if(inst[57].flag) // instr layer only; exclusive_class
+  z->sf2_params[57]=inst[57].gen;
+ else
+  z->sf2_params[57]=0;
+
+ if(inst[54].flag) // sample_mode
+  z->sf2_params[54]=inst[54].gen&0x3;
+ else
+  z->sf2_params[54]=0;
+
+ if(inst[56].flag) // scale_tune
+  z->sf2_params[56]=inst[56].gen;
+ else
+  z->sf2_params[56]=100;
+
+ // pitch: see sf_find_voice()
+ if(inst[58].flag && ((short)inst[58].gen)!=-1)
+  z->ori_key=(int)(short)inst[58].gen;
+ else
+  z->ori_key=(int)(short)sf->samples[nsample].original_key;
+
+ if(z->ori_key==-1)
+  z->ori_key=60;
+
+ if(inst[46].flag) // force_key_num
+ {
+  z->flags|=SF_ZONE_FORCE_KEY;
+  z->force_key=(int)(short)inst[46].gen;
+ }
+ else
+  z->force_key=0;
+
+ z->sample=&sf->samples[nsample];
+ z->data=NULL;
+
+ start_addr+=sf->samples[nsample].start;
+ end_addr+=sf->samples[nsample].end;
+
+ if(z->sf2_params[54]==2)
+  z->sf2_params[54]=0;
+
+ if(z->sf2_params[54]) // has any loop: 1 || 3
+ {
+   start_loop+=sf->samples[nsample].start_loop;
+   end_loop+=sf->samples[nsample].end_loop;
+ }
+ else // 0 || [2->0]
+ {
+   /*
+     // the audio stops 28-samples after the loop
+     // (for 16-bit audio -- due to cache)
+     // 3538g: 28/2 -> 28 for both
+     // pre-3538: was end_addr for start only
+     if(hw->is_10k2)
+     {
+      start_loop=end_addr+28;
+      end_loop=end_addr+28;
+     }
+     else
+     {
+      start_loop=end_addr-32;
+      end_loop=end_addr-32;
+     }
+
+     // kx_voice_start will set SOLEH/SOLEL bits
+   */
+   // pre-3536b
+   start_loop=end_addr+8/2;
+   end_loop=end_addr+40/2;
+   end_addr+=46/2;
+
+   z->sf2_params[54]=1;
+ }
+
+ z->start_addr=start_addr;
+ z->end_addr=end_addr;
+ z->start_loop=start_loop;
+ z->end_loop=end_loop;
+}
+
+// returns the number of zones of preset 'aa' or -1 for an incorrect preset
+// zones==NULL: just count
+static int sf_flatten_preset(kx_sound_font *sf,int aa,kx_sf_zone *zones)
+{
+    // just sanity check. need them more for other .._bags
+    if(sf->presets[aa].preset_bag_ndx>=sf->presets[aa+1].preset_bag_ndx)
+     return -1;
+
+    int n=0;
+
+    int has_gz=0;
+    // look for Preset Global Zone
+    if(sf->pgenlists[sf->preset_bags[sf->presets[aa].preset_bag_ndx+1].gen_ndx-1].gen_oper!=41) // not instrument
+    {
+     has_gz=1;
+    }
+
+    sf_parameters_t inst[SF_PARAMETERS],preset[SF_PARAMETERS],
+       inst_gz[SF_PARAMETERS],preset_gz[SF_PARAMETERS];
+
+    memset(&preset[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
+    memset(&preset_gz[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
+
+    sf_parameters_t *current;
+    if(has_gz)
+     current=&preset_gz[0];
+    else
+     current=&preset[0];
+
+    // parse all preset bags (generators)
+    for(int bb=sf->presets[aa].preset_bag_ndx;bb<sf->presets[aa+1].preset_bag_ndx;bb++)
+    {
+       for(int gg=sf->preset_bags[bb].gen_ndx;gg<sf->preset_bags[bb+1].gen_ndx;gg++)
+       {
+         if(sf->pgenlists[gg].gen_oper<SF_PARAMETERS)
+         {
+          if(sf->pgenlists[gg].gen_oper!=41) // instrument?
+          {
+          	current[sf->pgenlists[gg].gen_oper].gen=sf->pgenlists[gg].gen_amount.amount_w;
+          	current[sf->pgenlists[gg].gen_oper].flag=1;
+          } else // not instrument
+          {
+          	// begin new instrument
+          	int has_i_gz=0;
+          	int inst_n=sf->pgenlists[gg].gen_amount.amount_w;
+
+                memset(&inst_gz[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
+                memset(&inst[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
+
+                // look for Instrument Global Zone
+                if(sf->igenlists[sf->inst_bags[sf->insts[inst_n].inst_bag_ndx+1].gen_ndx-1].gen_oper!=53) // not sample
+                {
+                 has_i_gz=1;
+                }
+                sf_parameters_t *cur2;
+                if(has_i_gz)
+                 cur2=&inst_gz[0];
+                else
+                 cur2=&inst[0];
+
+                for(int cc=sf->insts[inst_n].inst_bag_ndx;cc<sf->insts[inst_n+1].inst_bag_ndx;cc++)
+                {
+                    int chained=0;
+
+                    for(int dd=sf->inst_bags[cc].gen_ndx;dd<sf->inst_bags[cc+1].gen_ndx;dd++)
+                    {
+                            if(sf->igenlists[dd].gen_oper<SF_PARAMETERS)
+                            {
+                               if(sf->igenlists[dd].gen_oper!=53) // sample #
+                               {
+                          	cur2[sf->igenlists[dd].gen_oper].gen=sf->igenlists[dd].gen_amount.amount_w;
+                          	cur2[sf->igenlists[dd].gen_oper].flag=1;
+                               }
+                             else // sample
+                             {
+                             // process global zones...
+                             for(int i=0;i<SF_PARAMETERS;i++)
+                             {
+                                if(!inst[i].flag) // use default or global zone
+                                {
+                             	 inst[i].gen=inst_gz[i].flag?inst_gz[i].gen:inst[i].gen;
+                             	 if(inst_gz[i].flag)
+                             	  inst[i].flag=1;
+                             	} // else:
+                             	  // there's local instr zone generator: ignore anything else
+
+                             	if(!preset[i].flag)
+                             	{
+                             	  preset[i].gen=preset_gz[i].flag?preset_gz[i].gen:preset[i].gen;
+                             	  if(preset_gz[i].flag)
+                             	   preset[i].flag=1;
+                             	} // else
+                             	  // there's local preset zone generator: ignore anything else
+                             }
+
+                             if(zones)
+                              sf_fill_zone(sf,&zones[n],inst,preset,sf->igenlists[dd].gen_amount.amount_w,
+                                chained?SF_ZONE_CHAINED:0);
+                             n++;
+                             chained=1; // the per-note parser skipped the rest of the bag if the ranges did not match
+                             }
+                            } else if(zones) debug(DLIB,"!! Incorrect igenlist generator [%d]\n",
+                              sf->igenlists[dd].gen_oper);
+                    } // for all generators in instr (dd)
+                    cur2=&inst[0];
+                    memset(&inst[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
+                } // for all bags with generators in instr (cc)
+          } // was instrument
+         } else if(zones) debug(DLIB,"!!! Unknown SF generator [%xh]\n",sf->pgenlists[gg].gen_oper);
+       } // for k: all gens in preset_bags[]
+
+       current=&preset[0];
+       memset(&preset[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
+    } // for all bags with generators in preset
+
+    return n;
+}
+
+static inline int sf_hash(int bank,int preset,int bits)
+{
+ return (int)(((((dword)bank<<7)^(dword)preset)*0x9e3779b1)>>(32-bits));
+}
+
+#define SF_ALIGN(a) (((a)+7)&~7)
+
+static kx_sf_index *sf_build_index(kx_hw *hw,kx_sound_font *sf)
+{
+ int n_presets=sf->header.presets-1; // 'EOP' is last; so: -1
+ if(n_presets<0)
+  n_presets=0;
+
+ int n_zones=0;
+ for(int aa=0;aa<n_presets;aa++)
+ {
+  int n=sf_flatten_preset(sf,aa,NULL);
+  if(n>0)
+   n_zones+=n;
+ }
+
+ int bits=4;
+ while((1<<bits)<n_presets)
+  bits++;
+
+ size_t size=SF_ALIGN(sizeof(kx_sf_index));
+ size_t zones_offset=size; size+=SF_ALIGN(n_zones*sizeof(kx_sf_zone));
+ size_t presets_offset=size; size+=SF_ALIGN(n_presets*sizeof(kx_sf_preset));
+ size_t hash_offset=size; size+=SF_ALIGN((1<<bits)*sizeof(int));
+ size_t by_key_offset=size; size+=SF_ALIGN(n_zones*sizeof(int));
+ size_t key_hi_max_offset=size; size+=SF_ALIGN(n_zones*sizeof(short));
+
+ kx_sf_index *ndx=NULL;
+ (hw->cb.malloc_func)(hw->cb.call_with,(int)size,(void **)&ndx,KX_NONPAGED);
+ if(ndx==NULL)
+ {
+  debug(DLIB,"kX: sf: Not enough memory for the zone index (%d needed)\n",(int)size);
+  return NULL;
+ }
+
+ ndx->list.next=ndx->list.prev=NULL;
+ ndx->sf=sf;
+ ndx->hash_bits=bits;
+ ndx->hash=(int *)((uintptr_t)ndx+hash_offset);
+ ndx->n_presets=n_presets;
+ ndx->presets=(kx_sf_preset *)((uintptr_t)ndx+presets_offset);
+ ndx->n_zones=n_zones;
+ ndx->zones=(kx_sf_zone *)((uintptr_t)ndx+zones_offset);
+ ndx->by_key=(int *)((uintptr_t)ndx+by_key_offset);
+ ndx->key_hi_max=(short *)((uintptr_t)ndx+key_hi_max_offset);
+ ndx->stream=NULL;
+ ndx->data=NULL;
+ ndx->n_data=0;
+ ndx->shared=0;
+ ndx->received=0;
+
+ for(int i=0;i<(1<<bits);i++)
+  ndx->hash[i]=-1;
+
+ int z=0;
+ for(int aa=0;aa<n_presets;aa++)
+ {
+  kx_sf_preset *p=&ndx->presets[aa];
+
+  p->bank=sf->presets[aa].bank;
+  p->preset=sf->presets[aa].preset;
+  p->header=aa;
+  p->first_zone=z;
+  p->flags=0;
+
+  int n=sf_flatten_preset(sf,aa,&ndx->zones[z]);
+  if(n<0)
+  {
+   p->flags|=SF_PRESET_BAD;
+   n=0;
+  }
+  p->n_zones=n;
+
+  // sort by key_lo (insertion sort: a few dozen zones per preset)
+  for(int i=z;i<z+n;i++)
+  {
+   int j=i;
+   while(j>z && ndx->zones[ndx->by_key[j-1]].key_lo>ndx->zones[i].key_lo)
+   {
+    ndx->by_key[j]=ndx->by_key[j-1];
+    j--;
+   }
+   ndx->by_key[j]=i;
+
+   if((ndx->zones[i].flags&SF_ZONE_CHAINED) || ndx->zones[i].sf2_params[47]!=-1)
+    p->flags|=SF_PRESET_ORDERED;
+  }
+
+  // prefix maximum of key_hi: lets sf_match_zones() stop scanning
+  for(int i=z;i<z+n;i++)
+  {
+   short key_hi=ndx->zones[ndx->by_key[i]].key_hi;
+   ndx->key_hi_max[i]=(i>z && ndx->key_hi_max[i-1]>key_hi)?ndx->key_hi_max[i-1]:key_hi;
+  }
+  z+=n;
+ }
+
+ // hash chains keep the file order: the per-note parser scanned all the matching presets
+ for(int aa=n_presets-1;aa>=0;aa--)
+ {
+  int h=sf_hash(ndx->presets[aa].bank,ndx->presets[aa].preset,bits);
+  ndx->presets[aa].next=ndx->hash[h];
+  ndx->hash[h]=aa;
+ }
+
+ debug(DLIB,"-- SoundFont index: %d presets, %d zones, %d bytes\n",n_presets,n_zones,(int)size);
+
+ return ndx;
+}
+
 KX_API(int,kx_load_soundfont(kx_hw *hw,kx_sound_font *in))
 {
  if(!in)
@@ -61,14 +489,47 @@ KX_API(int,kx_load_soundfont(kx_hw *hw,kx_sound_font *in))
    return -1;
  }
 
- // alloc cached memory (soundfont stuff is accessed by the synth; soundfont audio data is not modified)
- if((hw->cb.lmem_alloc_func)(hw->cb.call_with,in->header.sample_len+4,(void **)&sf->sample_data,KX_CACHED)!=0)
+ memcpy(sf,in,in->size-in->header.sample_len-4);
+ sf->sample_data=NULL;
+ sf->list.next=sf->list.prev=NULL;
+
+ // translate pointers
+ sf->presets=(sfPresetHeader *)(&sf->data);
+ sf->preset_bags=(sfModGenBag *)((uintptr_t)(&sf->data)+(uintptr_t)sf->preset_bags);
+ sf->pmodlists=(sfModList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->pmodlists);
+ sf->pgenlists=(sfGenList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->pgenlists);
+ sf->insts=(sfInst *)((uintptr_t)(&sf->data)+(uintptr_t)sf->insts);
+ sf->inst_bags=(sfModGenBag *)((uintptr_t)(&sf->data)+(uintptr_t)sf->inst_bags);
+ sf->imodlists=(sfModList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->imodlists);
+ sf->igenlists=(sfGenList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->igenlists);
+ sf->samples=(sfSample *)((uintptr_t)(&sf->data)+(uintptr_t)sf->samples);
+
+ // sample data: streamed if the pool is enabled (KX_HW_SF_POOL_SIZE, see bufmgr.cpp), loaded as a whole otherwise
+ kx_sf_stream *stream=NULL;
+ kx_sf_stream_create(hw,sf,&stream);
+ if(stream==NULL)
+ {
+  // alloc cached memory (soundfont stuff is accessed by the synth; soundfont audio data is not modified)
+  if((hw->cb.lmem_alloc_func)(hw->cb.call_with,in->header.sample_len+4,(void **)&sf->sample_data,KX_CACHED)!=0)
+  {
+   (hw->cb.free_func)(hw->cb.call_with,sf);
+   debug(DLIB,"kX: sf: Not enough memory for samples (%d needed)\n",in->header.sample_len);
+   return -1;
+  }
+  memset(hw->cb.lmem_get_addr_func(hw->cb.call_with,(void **)&sf->sample_data,0,NULL),0,in->header.sample_len);
+ }
+
+ // the index is built before the SoundFont is visible to the synth
+ kx_sf_index *ndx=sf_build_index(hw,sf);
+ if(ndx==NULL)
  {
+  if(stream)
+   kx_sf_stream_destroy(hw,stream);
+  (hw->cb.lmem_free_func)(hw->cb.call_with,(void **)&sf->sample_data);
   (hw->cb.free_func)(hw->cb.call_with,sf);
-  debug(DLIB,"kX: sf: Not enough memory for samples (%d needed)\n",in->header.sample_len);
   return -1;
  }
- memset(hw->cb.lmem_get_addr_func(hw->cb.call_with,(void **)&sf->sample_data,0,NULL),0,in->header.sample_len);
+ ndx->stream=stream;
 
  unsigned long flags=0;
  kx_lock_acquire(hw,&hw->sf_lock, &flags);
@@ -96,6 +557,9 @@ KX_API(int,kx_load_soundfont(kx_hw *hw,kx_sound_font *in))
  {
   kx_lock_release(hw,&hw->sf_lock,&flags);
 
+  (hw->cb.free_func)(hw->cb.call_with,ndx);
+  if(stream)
+   kx_sf_stream_destroy(hw,stream);
   (hw->cb.lmem_free_func)(hw->cb.call_with,(void **)&sf->sample_data);
   (hw->cb.free_func)(hw->cb.call_with,sf);
 
@@ -103,34 +567,396 @@ KX_API(int,kx_load_soundfont(kx_hw *hw,kx_sound_font *in))
   return -2;
  }
 
- // save sf->sample_data for reference
- short *sdata_tmp=sf->sample_data;
-
- memcpy(sf,in,in->size-in->header.sample_len-4);
  sf->id=id;
- sf->sample_data=sdata_tmp;
 
  debug(DLIB,"-- SoundFont Loading [%x]; new id=%d (partial)\n",sf,sf->id);
- sf->list.next=sf->list.prev=NULL;
-
- // translate pointers
- sf->presets=(sfPresetHeader *)(&sf->data);
- sf->preset_bags=(sfModGenBag *)((uintptr_t)(&sf->data)+(uintptr_t)sf->preset_bags);
- sf->pmodlists=(sfModList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->pmodlists);
- sf->pgenlists=(sfGenList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->pgenlists);
- sf->insts=(sfInst *)((uintptr_t)(&sf->data)+(uintptr_t)sf->insts);
- sf->inst_bags=(sfModGenBag *)((uintptr_t)(&sf->data)+(uintptr_t)sf->inst_bags);
- sf->imodlists=(sfModList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->imodlists);
- sf->igenlists=(sfGenList *)((uintptr_t)(&sf->data)+(uintptr_t)sf->igenlists);
- sf->samples=(sfSample *)((uintptr_t)(&sf->data)+(uintptr_t)sf->samples);
 
  list_add(&sf->list, &hw->sf);
+ list_add(&ndx->list, &hw->sf_index);
 
  kx_lock_release(hw,&hw->sf_lock,&flags);
 
  return id;
 }
 
+// sf_lock should be held
+static kx_sf_index *sf_find_index(kx_hw *hw,kx_sound_font *sf)
+{
+ struct list *item;
+ for_each_list_entry(item, &hw->sf_index)
+ {
+  kx_sf_index *ndx=list_item(item, kx_sf_index, list);
+  if(ndx->sf==sf)
+   return ndx;
+ }
+ return NULL;
+}
+
+// shared sample data
+// ------------------
+// once all the sample data of a SoundFont is uploaded, the regions used by its zones are looked up in
+// the SoundFonts loaded earlier (hash, then compared); the regions that are not found are moved to
+// a new kx_sf_data buffer, the zones are re-based and sf->sample_data is freed
+// kx_sf_data buffers are reference counted by the SoundFonts that use them (kx_sf_index.data[])
+
+typedef struct
+{
+ int lo,hi;			// samples
+ dword hash;
+ kx_sf_data *data;		// found in; NULL: stored in the new buffer
+ int offset;			// bytes, in 'data' or in the new buffer
+}sf_region;
+
+static dword sf_data_hash(const byte *p,int size)
+{
+ dword h=2166136261U;		// FNV-1a
+ for(int i=0;i<size;i++)
+  h=(h^p[i])*16777619U;
+ return h;
+}
+
+// voices that play from the sample data that is being freed
+static void sf_stop_voices(kx_hw *hw,void *lmem)
+{
+ for(int i=0;i<KX_NUMBER_OF_VOICES;i++)
+ {
+  kx_voice *v=&hw->voicetable[i];
+  if((v->usage&VOICE_USAGE_MIDI) && v->buffer.pageindex>=0 && v->sf_lmem==lmem)
+   kx_synth_term(hw,i);
+ }
+}
+
+// a block with the same hash and size; its data is compared by the caller
+// sf_lock should be held; returns -1 if not found
+static int sf_data_find(kx_sf_data *d,dword hash,int size)
+{
+ int lo=0,hi=d->n_blocks;
+ while(lo<hi)
+ {
+  int mid=(lo+hi)/2;
+  if(d->blocks[mid].hash<hash)
+   lo=mid+1;
+  else
+   hi=mid;
+ }
+ for(;lo<d->n_blocks && d->blocks[lo].hash==hash;lo++)
+ {
+  if(d->blocks[lo].size==size)
+   return d->blocks[lo].offset;
+ }
+ return -1;
+}
+
+// sf_lock should be held; returns 'd' if it is not used anymore (taken off hw->sf_data): the caller
+// frees it with sf_free_data() after releasing the lock
+static kx_sf_data *sf_unref_data(kx_hw *hw,kx_sf_data *d)
+{
+ if(--d->refs)
+  return NULL;
+ list_del(&d->list);
+ return d;
+}
+
+static void sf_free_data(kx_hw *hw,kx_sf_data *d)
+{
+ sf_stop_voices(hw,d->lmem);
+ (hw->cb.lmem_free_func)(hw->cb.call_with,&d->lmem);
+ (hw->cb.free_func)(hw->cb.call_with,d);
+}
+
+static void sf_share_samples(kx_hw *hw,kx_sound_font *sf,kx_sf_index *ndx)
+{
+ int len=sf->header.sample_len+4;
+ int n_samples=sf->header.samples;
+ const byte *base=(const byte *)hw->cb.lmem_get_addr_func(hw->cb.call_with,(void **)&sf->sample_data,0,NULL);
+
+ if(n_samples<=0 || base==NULL)
+  return;
+
+ sf_region *r=NULL;
+ kx_sf_data **used=NULL;
+ (hw->cb.malloc_func)(hw->cb.call_with,n_samples*sizeof(sf_region),(void **)&r,KX_NONPAGED);
+ (hw->cb.malloc_func)(hw->cb.call_with,(n_samples+1)*sizeof(kx_sf_data *),(void **)&used,KX_NONPAGED);
+ if(r==NULL || used==NULL)
+ {
+  if(r) (hw->cb.free_func)(hw->cb.call_with,r);
+  if(used) (hw->cb.free_func)(hw->cb.call_with,used);
+  debug(DLIB,"kX: sf: not enough memory to share the sample data\n");
+  return;
+ }
+
+ // the data used by the zones of each sample, incl. loops outside the sample and the 46 zero samples
+ for(int i=0;i<n_samples;i++)
+  r[i].lo=r[i].hi=-1;
+ for(int i=0;i<ndx->n_zones;i++)
+ {
+  kx_sf_zone *z=&ndx->zones[i];
+  int s=(int)(z->sample-sf->samples);
+  if(s<0 || s>=n_samples)
+   continue;
+  int lo=z->start_addr,hi=z->end_addr;
+  if(z->start_loop<lo) lo=z->start_loop;
+  if(z->end_loop>hi) hi=z->end_loop;
+  if((int)z->sample->start<lo) lo=z->sample->start;
+  if((int)z->sample->end+46>hi) hi=z->sample->end+46;
+  if(lo<0) lo=0;
+  if(hi>len/2) hi=len/2;
+
+  if(r[s].lo==-1 || lo<r[s].lo) r[s].lo=lo;
+  if(r[s].hi==-1 || hi>r[s].hi) r[s].hi=hi;
+ }
+
+ // sort by 'lo' (insertion sort: the samples are usually stored in order) and merge overlapping regions
+ int n=0;
+ for(int i=0;i<n_samples;i++)
+ {
+  if(r[i].lo<0 || r[i].lo>=r[i].hi)
+   continue;
+  sf_region t=r[i];
+  int j=n;
+  while(j>0 && r[j-1].lo>t.lo)
+  {
+   r[j]=r[j-1];
+   j--;
+  }
+  r[j]=t;
+  n++;
+ }
+ int m=0;
+ for(int i=0;i<n;i++)
+ {
+  if(m>0 && r[i].lo<r[m-1].hi)
+  {
+   if(r[i].hi>r[m-1].hi)
+    r[m-1].hi=r[i].hi;
+  }
+  else
+   r[m++]=r[i];
+ }
+ n=m;
+
+ if(n==0)
+ {
+  (hw->cb.free_func)(hw->cb.call_with,r);
+  (hw->cb.free_func)(hw->cb.call_with,used);
+  return;
+ }
+
+ for(int i=0;i<n;i++)
+ {
+  r[i].hash=sf_data_hash(base+r[i].lo*2,(r[i].hi-r[i].lo)*2);
+  r[i].data=NULL;
+ }
+
+ // look up the regions in the SoundFonts loaded earlier: the candidate is looked up under sf_lock
+ // and pinned with a reference, and its data is compared without the lock held; a candidate that
+ // differs (a hash collision) is not searched further: the region goes to the new buffer
+ unsigned long flags=0;
+
+ int n_used=0,unique=0,shared=0;
+ for(int i=0;i<n;i++)
+ {
+  int size=(r[i].hi-r[i].lo)*2;
+  kx_sf_data *d=NULL;
+  int offset=-1;
+
+  kx_lock_acquire(hw,&hw->sf_lock,&flags);
+  struct list *item;
+  for_each_list_entry(item, &hw->sf_data)
+  {
+   kx_sf_data *t=list_item(item, kx_sf_data, list);
+   offset=sf_data_find(t,r[i].hash,size);
+   if(offset>=0)
+   {
+    d=t;
+    d->refs++;			// keeps the data until the zones are re-based
+    break;
+   }
+  }
+  kx_lock_release(hw,&hw->sf_lock,&flags);
+
+  if(d && memcmp(hw->cb.lmem_get_addr_func(hw->cb.call_with,&d->lmem,offset,NULL),base+r[i].lo*2,size)==0)
+  {
+   r[i].data=d;
+   r[i].offset=offset;
+
+   int j;
+   for(j=0;j<n_used;j++)
+    if(used[j]==d)
+     break;
+   if(j==n_used)
+   {
+    used[n_used++]=d;
+    d=NULL;			// the reference is kept by used[]
+   }
+   shared+=size;
+  }
+  else
+  {
+   r[i].offset=unique;
+   unique+=size;
+  }
+
+  if(d)
+  {
+   kx_lock_acquire(hw,&hw->sf_lock,&flags);
+   kx_sf_data *dead=sf_unref_data(hw,d);
+   kx_lock_release(hw,&hw->sf_lock,&flags);
+   if(dead)
+    sf_free_data(hw,dead);
+  }
+ }
+
+ // new buffer: the regions that were not found
+ kx_sf_data *own=NULL;
+ (hw->cb.malloc_func)(hw->cb.call_with,sizeof(kx_sf_data)+n*sizeof(kx_sf_block),(void **)&own,KX_NONPAGED);
+ if(own)
+ {
+  memset(own,0,sizeof(kx_sf_data));
+  own->blocks=(kx_sf_block *)(own+1);
+  own->refs=1;
+
+  if(shared==0)
+  {
+   // nothing is shared: the sample data is kept as is
+   own->lmem=sf->sample_data;
+   own->size=len;
+   for(int i=0;i<n;i++)
+    r[i].offset=r[i].lo*2;
+  }
+  else
+  if(unique)
+  {
+   if((hw->cb.lmem_alloc_func)(hw->cb.call_with,unique,&own->lmem,KX_CACHED)==0)
+   {
+    own->size=unique;
+    for(int i=0;i<n;i++)
+     if(r[i].data==NULL)
+      memcpy(hw->cb.lmem_get_addr_func(hw->cb.call_with,&own->lmem,r[i].offset,NULL),base+r[i].lo*2,(r[i].hi-r[i].lo)*2);
+   }
+   else
+   {
+    (hw->cb.free_func)(hw->cb.call_with,own);
+    own=NULL;
+   }
+  }
+ }
+ if(own)
+ {
+  // blocks, sorted by hash (shell sort)
+  for(int i=0;i<n;i++)
+  {
+   if(r[i].data)
+    continue;
+   kx_sf_block *b=&own->blocks[own->n_blocks++];
+   b->hash=r[i].hash;
+   b->size=(r[i].hi-r[i].lo)*2;
+   b->offset=r[i].offset;
+  }
+  for(int gap=own->n_blocks/2;gap>0;gap/=2)
+   for(int i=gap;i<own->n_blocks;i++)
+   {
+    kx_sf_block t=own->blocks[i];
+    int j=i;
+    for(;j>=gap && own->blocks[j-gap].hash>t.hash;j-=gap)
+     own->blocks[j]=own->blocks[j-gap];
+    own->blocks[j]=t;
+   }
+  if(unique || shared==0)
+   used[n_used++]=own;
+ }
+
+ kx_lock_acquire(hw,&hw->sf_lock,&flags);
+
+ if(own==NULL || ndx->data)
+ {
+  // not enough memory (or shared already): the SoundFont keeps its sample data
+  int n_dead=0;
+  for(int i=0;i<n_used;i++)
+   if(used[i]!=own && sf_unref_data(hw,used[i]))
+    used[n_dead++]=used[i];
+  kx_lock_release(hw,&hw->sf_lock,&flags);
+
+  for(int i=0;i<n_dead;i++)
+   sf_free_data(hw,used[i]);
+
+  if(own)
+  {
+   if(own->lmem!=sf->sample_data)
+    (hw->cb.lmem_free_func)(hw->cb.call_with,&own->lmem);
+   (hw->cb.free_func)(hw->cb.call_with,own);
+  }
+  (hw->cb.free_func)(hw->cb.call_with,used);
+  (hw->cb.free_func)(hw->cb.call_with,r);
+  debug(DLIB,"kX: sf: sample data is not shared\n");
+  return;
+ }
+
+ // re-base the zones
+ for(int i=0;i<ndx->n_zones;i++)
+ {
+  kx_sf_zone *z=&ndx->zones[i];
+
+  // the region with the zone: the last one with lo<=start
+  int lo=0,hi=n;
+  while(lo<hi)
+  {
+   int mid=(lo+hi)/2;
+   if(r[mid].lo<=z->start_addr)
+    lo=mid+1;
+   else
+    hi=mid;
+  }
+  if(lo==0)
+   lo=1; // start_addr<0: clamped
+  sf_region *reg=&r[lo-1];
+
+  int delta=reg->offset/2-reg->lo;
+  z->start_addr+=delta;
+  z->end_addr+=delta;
+  z->start_loop+=delta;
+  z->end_loop+=delta;
+  z->data=reg->data?reg->data:own;
+ }
+
+ if(own->lmem)
+  list_add(&own->list,&hw->sf_data);
+ ndx->data=used;
+ ndx->n_data=n_used;
+ ndx->shared=shared;
+
+ void *old=NULL;
+ if(own->lmem!=sf->sample_data)
+  old=sf->sample_data;
+ sf->sample_data=NULL;
+
+ kx_lock_release(hw,&hw->sf_lock,&flags);
+
+ if(old)
+ {
+  sf_stop_voices(hw,old);
+  (hw->cb.lmem_free_func)(hw->cb.call_with,&old);
+ }
+ if(own->lmem==NULL) // all the data is shared
+  (hw->cb.free_func)(hw->cb.call_with,own);
+ (hw->cb.free_func)(hw->cb.call_with,r);
+
+ debug(DLIB,"-- SoundFont #%d: %d sample regions, %d bytes shared with other SoundFonts\n",sf->id,n,shared);
+}
+
+// sf_lock should be held
+// returns the number of kx_sf_data buffers that are not used anymore: moved to the beginning of ndx->data[]
+static int sf_release_data(kx_hw *hw,kx_sf_index *ndx)
+{
+ int n=0;
+ for(int i=0;i<ndx->n_data;i++)
+ {
+  if(sf_unref_data(hw,ndx->data[i]))
+   ndx->data[n++]=ndx->data[i];
+ }
+ return n;
+}
+
 KX_API(int,kx_load_soundfont_samples(kx_hw *hw,sf_load_sample_property *sf_p))
 {
  unsigned long flags=0;
@@ -145,12 +971,45 @@ KX_API(int,kx_load_soundfont_samples(kx_hw *hw,sf_load_sample_property *sf_p))
         {
         	if(sf->id==sf_p->id)
         	{
-        		if(sf_p->pos+sf_p->size<=(int)sf->header.sample_len+4)
+        		if(sf_p->pos>=0 && sf_p->size>=0 && sf_p->pos+sf_p->size<=(int)sf->header.sample_len+4)
         		{
+        		 kx_sf_index *ndx=sf_find_index(hw,sf);
+        		 kx_sf_stream *stream=ndx?ndx->stream:NULL;
+        		 if(stream)
+        		 {
+        		  // 'backing' is pageable: copied without the lock
+        		  stream->busy++;
+        		  kx_lock_release(hw,&hw->sf_lock,&flags);
+
+        		  int ret=kx_sf_stream_write(hw,stream,sf_p->pos,&sf_p->data[0],sf_p->size);
+
+        		  kx_lock_acquire(hw,&hw->sf_lock, &flags);
+        		  int destroyed=kx_sf_stream_release(hw,stream);
+        		  kx_lock_release(hw,&hw->sf_lock,&flags);
+        		  if(destroyed) // the SoundFont was unloaded meanwhile
+        		   kx_sf_stream_free(hw,stream);
+        		  return ret;
+        		 }
+
+        		 if(sf->sample_data==NULL) // shared already
+        		 {
+        		  debug(DLIB,"load sf samples: the sample data is already loaded (%d)\n",sf_p->id);
+                          kx_lock_release(hw,&hw->sf_lock,&flags);
+        		  return -3;
+        		 }
+
         		 char *pp=(char *)((hw->cb.lmem_get_addr_func)(hw->cb.call_with,(void **)&sf->sample_data,sf_p->pos,NULL));
 
         		 if(pp)
         		  memcpy(pp,&sf_p->data[0],sf_p->size);
+
+        		 // last block: the sample data is complete
+        		 if(ndx && (ndx->received+=sf_p->size)==(int)sf->header.sample_len+4)
+        		 {
+        		  kx_lock_release(hw,&hw->sf_lock,&flags);
+        		  sf_share_samples(hw,sf,ndx);
+        		  return 0;
+        		 }
 /*        		 if(sf_p->size!=4096-12) // last item
         		 {
                            if(*(dword *)((dword)sf+(dword)sf->size-4-1)!=KX_SOUNDFONT_MAGIC)
@@ -191,8 +1050,43 @@ KX_API(int,kx_unload_soundfont(kx_hw *hw,int id))
         {
           debug(DLIB,"-- SoundFont Unload [%x] id=%d\n",sf,sf->id);
           list_del(&sf->list);
+
+          kx_sf_index *ndx=NULL;
+          struct list *it;
+          for_each_list_entry(it, &hw->sf_index)
+          {
+                if(list_item(it, kx_sf_index, list)->sf==sf)
+                {
+                 ndx=list_item(it, kx_sf_index, list);
+                 list_del(&ndx->list);
+                 break;
+                }
+          }
           kx_lock_release(hw,&hw->sf_lock,&flags);
 
+          if(ndx && ndx->stream)
+          {
+           // stop the voices that still play the samples
+           for(int i=0;i<KX_NUMBER_OF_VOICES;i++)
+            if(hw->voicetable[i].sf_stream==ndx->stream)
+             kx_synth_term(hw,i);
+           kx_sf_stream_destroy(hw,ndx->stream);
+          }
+          if(ndx && ndx->data)
+          {
+           // shared sample data: freed with the last SoundFont that uses it
+           kx_lock_acquire(hw,&hw->sf_lock,&flags);
+           int n=sf_release_data(hw,ndx);
+           kx_lock_release(hw,&hw->sf_lock,&flags);
+
+           for(int i=0;i<n;i++)
+            sf_free_data(hw,ndx->data[i]);
+           (hw->cb.free_func)(hw->cb.call_with,ndx->data);
+          }
+          if(ndx)
+           (hw->cb.free_func)(hw->cb.call_with,ndx);
+          if(sf->sample_data)
+           sf_stop_voices(hw,sf->sample_data);
           (hw->cb.lmem_free_func)(hw->cb.call_with,(void **)&sf->sample_data);
           (hw->cb.free_func)(hw->cb.call_with,sf);
 
@@ -244,6 +1138,8 @@ KX_API(int,kx_enum_soundfonts(kx_hw *hw,sfHeader *hdr,int size))
         sf = list_item(item, kx_sound_font, list);
         memcpy(&hdr[total],&sf->header,sizeof(sfHeader));
         hdr[total].rom_ver.minor=(word)sf->id;
+        kx_sf_index *ndx=sf_find_index(hw,sf);
+        hdr[total].sample_shared=ndx?ndx->shared:0;
         total++;
   }
 
@@ -254,6 +1150,8 @@ KX_API(int,kx_enum_soundfonts(kx_hw *hw,sfHeader *hdr,int size))
 int kx_soundfont_init(kx_hw *hw)
 {
  init_list(&hw->sf);
+ init_list(&hw->sf_index);
+ init_list(&hw->sf_data);
  hw->initialized|=KX_SF_INITED;
  return 0;
 }
@@ -271,6 +1169,7 @@ int kx_soundfont_close(kx_hw *hw)
   {
         kx_unload_soundfont(hw,i);
   }
+  kx_sf_pool_close(hw);
 
  return 0;
 }
@@ -319,6 +1218,73 @@ KX_API(int,kx_sf_get_preset_description(kx_hw *hw,int bank,int preset,char *name
   return -1;
 }
 
+// selects the zones of preset 'p' that match note/vel: at most 'max' zone numbers, in file order
+// force_velocity zones change 'vel' for the zones that follow (as the per-note parser did)
+static int sf_match_zones(kx_sf_index *ndx,kx_sf_preset *p,int note,int *vel,int *match,int max)
+{
+ int n=0;
+
+ if(p->flags&SF_PRESET_ORDERED)
+ {
+  int skip=0;
+  for(int i=p->first_zone;i<p->first_zone+p->n_zones && n<max;i++)
+  {
+   kx_sf_zone *z=&ndx->zones[i];
+
+   if(z->flags&SF_ZONE_CHAINED)
+   {
+    if(skip)
+     continue;
+   }
+   else
+    skip=0;
+
+   if(note<z->key_lo || note>z->key_hi || *vel<z->vel_lo || *vel>z->vel_hi)
+   {
+    skip=1;
+    continue;
+   }
+   match[n++]=i;
+   if(z->sf2_params[47]!=-1)
+    *vel=z->sf2_params[47];
+  }
+  return n;
+ }
+
+ // zones with key_lo<=note
+ int lo=p->first_zone,hi=p->first_zone+p->n_zones;
+ while(lo<hi)
+ {
+  int mid=(lo+hi)/2;
+  if(ndx->zones[ndx->by_key[mid]].key_lo<=note)
+   lo=mid+1;
+  else
+   hi=mid;
+ }
+
+ // backwards: once key_hi_max<note, no earlier zone reaches the note
+ for(int i=lo-1;i>=p->first_zone && ndx->key_hi_max[i]>=note;i--)
+ {
+  int zn=ndx->by_key[i];
+  kx_sf_zone *z=&ndx->zones[zn];
+
+  if(note>z->key_hi || *vel<z->vel_lo || *vel>z->vel_hi)
+   continue;
+
+  // keep the first 'max' zones in file order
+  if(n==max && zn>match[n-1])
+   continue;
+  int j=(n<max)?n++:n-1;
+  while(j>0 && match[j-1]>zn)
+  {
+   match[j]=match[j-1];
+   j--;
+  }
+  match[j]=zn;
+ }
+ return n;
+}
+
 // returns number of filled in values
 #ifdef CE_OPTIMIZE
 #pragma optimize("gty", on)
@@ -352,13 +1318,17 @@ int sf_find_voice(kx_midi_state *midi,kx_voice_param *table,int chn,int note,int
    	break;
   }
 
+  int program=midi->channels[chn].program;
+  int *nrpn=midi->channels[chn].nrpn_sf_data;
+
 AGAIN:
 
   struct list *item;
-  for_each_list_entry(item, &hw->sf)
+  for_each_list_entry(item, &hw->sf_index)
   {
-	    kx_sound_font *sf;  	
-        sf = list_item(item, kx_sound_font, list);
+        kx_sf_index *ndx;
+        ndx = list_item(item, kx_sf_index, list);
+        kx_sound_font *sf=ndx->sf;
 
         if(sf->header.subsynth!=0)
         {
@@ -368,402 +1338,132 @@ AGAIN:
 
         debug(DSFNT,"- SoundFont #%d ('%s')\n",sf->id,sf->header.name);
 
-        // look for preset
-        for(int aa=0;aa<sf->header.presets-1;aa++) // 'EOP' is last; so: -1
+        // preset bank: drum channels use bank 128 of the SoundFont with sfman_id==bank
+        dword preset_bank;
+        if(chn==(midi->drum_channel-1))
         {
-          if(
-             (
-               (chn!=(midi->drum_channel-1)) // found non-drum channels
-              &&
-               (
-                (sf->presets[aa].preset==midi->channels[chn].program) 
-               && 
-                ((sf->presets[aa].bank+sf->header.sfman_id)==bank)
-               )
-             )  
-            ||
-             (
-               (chn==(midi->drum_channel-1))
-              &&
-               ( 
-                 (sf->presets[aa].preset==midi->channels[chn].program) 
-               && 
-                 (sf->header.sfman_id==bank)
-               &&
-                 (sf->presets[aa].bank==128)
-               )
-             )
-            )
+         if(sf->header.sfman_id!=bank)
+          continue;
+         preset_bank=128;
+        }
+        else
+        {
+         preset_bank=(dword)bank-sf->header.sfman_id;
+         if(preset_bank>0xffff)
+          continue;
+        }
+
+        for(int pp=ndx->hash[sf_hash(preset_bank,program,ndx->hash_bits)];pp!=-1;pp=ndx->presets[pp].next)
+        {
+          kx_sf_preset *p=&ndx->presets[pp];
+          if(p->bank!=preset_bank || p->preset!=program)
+           continue;
+
+          if(p->flags&SF_PRESET_BAD)
           {
-            // just sanity check. need them more for other .._bags
-            if(sf->presets[aa].preset_bag_ndx>=sf->presets[aa+1].preset_bag_ndx)
-            {
-            	debug(DLIB,"!!! Incorrect soundfont: bad preset bag [inst: %d bank: %d/%d]\n",
-            	  midi->channels[chn].program,midi->channels[chn].bank_lsb,midi->channels[chn].bank_msb);
-                kx_lock_release(hw,&hw->sf_lock,&flags);
-            	return 0;
-            }
-
-            int has_gz=0;
-            // look for Preset Global Zone
-            if(sf->pgenlists[sf->preset_bags[sf->presets[aa].preset_bag_ndx+1].gen_ndx-1].gen_oper!=41) // not instrument
-            {
-             has_gz=1;
-            }
-
-            sf_parameters_t inst[SF_PARAMETERS],preset[SF_PARAMETERS],
-               inst_gz[SF_PARAMETERS],preset_gz[SF_PARAMETERS];
-
-            memset(&preset[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
-            memset(&preset_gz[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
-
-            sf_parameters_t *current;
-            if(has_gz)
-             current=&preset_gz[0];
-            else
-             current=&preset[0];
-
-            debug(DSFNT,"- preset #%d ('%s')\n",aa,sf->presets[aa].name);
-
-            // parse all preset bags (generators)
-            for(int bb=sf->presets[aa].preset_bag_ndx;bb<sf->presets[aa+1].preset_bag_ndx;bb++)
-            {
-               for(int gg=sf->preset_bags[bb].gen_ndx;gg<sf->preset_bags[bb+1].gen_ndx;gg++)
-               {
-                 if(sf->pgenlists[gg].gen_oper<SF_PARAMETERS) 
-                 {
-                  if(sf->pgenlists[gg].gen_oper!=41) // instrument?
-                  {
-                  	current[sf->pgenlists[gg].gen_oper].gen=sf->pgenlists[gg].gen_amount.amount_w;
-                  	current[sf->pgenlists[gg].gen_oper].flag=1;
-                  } else // not instrument
-                  {
-                  	// begin new instrument
-                  	int has_i_gz=0;
-                  	int inst_n=sf->pgenlists[gg].gen_amount.amount_w;
-
-                        memset(&inst_gz[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
-                        memset(&inst[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS); 
-                        // memcpy(&inst[0],sf_defaults,sizeof(sf_parameters_t)*SF_PARAMETERS);
-
-                        // look for Instrument Global Zone
-                        if(sf->igenlists[sf->inst_bags[sf->insts[inst_n].inst_bag_ndx+1].gen_ndx-1].gen_oper!=53) // not sample
-                        {
-                         has_i_gz=1;
-                        }
-                        sf_parameters_t *cur2;
-                        if(has_i_gz)
-                         cur2=&inst_gz[0];
-                        else
-                         cur2=&inst[0];
-
-                        for(int cc=sf->insts[inst_n].inst_bag_ndx;cc<sf->insts[inst_n+1].inst_bag_ndx;cc++)
-                        {
-                            for(int dd=sf->inst_bags[cc].gen_ndx;dd<sf->inst_bags[cc+1].gen_ndx;dd++)
-                            {
-                                    if(sf->igenlists[dd].gen_oper<SF_PARAMETERS)
-                                    {
-                                       if(sf->igenlists[dd].gen_oper!=53) // sample #
-                                       {
-                                  	cur2[sf->igenlists[dd].gen_oper].gen=sf->igenlists[dd].gen_amount.amount_w;
-                                  	cur2[sf->igenlists[dd].gen_oper].flag=1;
-                                       }
-                                     else // sample
-                                     {
-
-                                     // process global zones...
-                                     for(int i=0;i<SF_PARAMETERS;i++)
-                                     {
-                                        if(!inst[i].flag) // use default or global zone
-                                        {
-                                     	 inst[i].gen=inst_gz[i].flag?inst_gz[i].gen:inst[i].gen;
-                                     	 if(inst_gz[i].flag)
-                                     	  inst[i].flag=1;
-                                     	} // else:
-                                     	  // there's local instr zone generator: ignore anything else
-
-                                     	if(!preset[i].flag)
-                                     	{
-                                     	  preset[i].gen=preset_gz[i].flag?preset_gz[i].gen:preset[i].gen;
-                                     	  if(preset_gz[i].flag)
-                                     	   preset[i].flag=1;
-                                     	} // else
-                                     	  // there's local preset zone generator: ignore anything else
-                                     }
-
-                                     // first of all: check ranges
-
-                                     // key range
-                                     if(inst[43].flag) // keyrange
-                                     {
-                                        if(inst[43].gen&0x8080)
-                                         break;
-                                     	if(note<(int)(short)(inst[43].gen&0xff) ||
-                                     	   note>(int)(short)((inst[43].gen>>8)&0xff))
-                                     	   break;
-                                     }
-                                     if(preset[43].flag) // keyrange
-                                     {
-                                        if(preset[43].gen&0x8080)
-                                         break;
-                                     	if(note<(int)((short)(preset[43].gen&0xff)) ||
-                                     	   note>(int)((short)((preset[43].gen>>8)&0xff)))
-                                     	   break;
-                                     }
-                                     // velocity range
-                                     if(inst[44].flag) // velrange
-                                     {
-                                     	if(vel<(int)(short)(inst[44].gen&0xff) ||
-                                     	   vel>(int)(short)((inst[44].gen>>8)&0xff))
-                                     	{
-                                     	   break;
-                                     	  }
-                                     }
-                                     if(preset[44].flag) // velrange
-                                     {
-                                     	if(vel<(int)((short)(preset[44].gen&0xff)) ||
-                                     	   vel>(int)((short)((preset[44].gen>>8)&0xff)))
-                                     	  {
-                                     	   break;
-                                     	  }
-                                     }
-
-                                     // finalize settings
-                                     int nsample=sf->igenlists[dd].gen_amount.amount_w;
-
-                                     int start_addr=(int)(short)inst[0].gen+(int)((short)inst[4].gen)*32768;
-                                     int end_addr=(int)(short)inst[1].gen+(int)((short)inst[12].gen)*32768;
-                                     int start_loop=(int)(short)inst[2].gen+(int)((short)inst[45].gen)*32768;
-                                     int end_loop=(int)(short)inst[3].gen+(int)((short)inst[50].gen)*32768;
-
-                                     // ----------------------- final code -----------------------
-                                     table[cnt].sf2_usage=VOICE_USAGE_MIDI|VOICE_FLAGS_16BIT|VOICE_FLAGS_MONO;
-
-                                     for(int ttt=0;ttt<SF_PARAMETERS;ttt++)
-                                     {
-                                      switch(ttt)
-                                      {
-                                       case 51: // coarse tune, semitones
-                                       case 52: // fune tune, cents
-                                       case 9: // initial_filterQ (cB)
-                                       case 15: // chorus %
-                                       case 16: // rev %
-                                       case 17: // pan %
-                                       case 29: // modenv sustain, %
-                                       case 37: // volenv sustain, cB
-                                       case 48: // init. attn, cB
-                                       case 11: // modenv to filter cutoff
-                                       case 7: // modenv to pitch
-                                       case 5: // modlfo to pitch
-                                       case 6: // viblfo to pitch
-                                       case 10: // modlfo to filter cutoff
-                                       case 13: // modlfo to vol
-                                       default:
-                                        table[cnt].sf2_params[ttt]=(int)(short)inst[ttt].gen+(int)(short)preset[ttt].gen;
-                                        break;
-                                       case 21:
-                                       case 23: // molfo delay / viblfo delay
-                                       case 25: // vol env params
-                                       case 26:
-                                       case 27:
-                                       case 28:
-                                       case 30:
-                                       case 33: // mod env params
-                                       case 34:
-                                       case 35:
-                                       case 36:
-                                       case 38:
-                                       	// timings in 'msec'<->abs cents - special case
-                                       	if(inst[ttt].flag)
-                                       	 table[cnt].sf2_params[ttt]=(int)(short)inst[ttt].gen+(int)(short)preset[ttt].gen;
-                                       	else
-                                       	 table[cnt].sf2_params[ttt]=-12000+(int)(short)preset[ttt].gen;
-                                       	break;
-                                       case 22:
-                                       case 24: // modlfo / viblfo freqs
-                                       case 31:
-                                       case 32:
-                                       case 39:
-                                       case 40: // keynum to something...
-                                       	 table[cnt].sf2_params[ttt]=(int)(short)inst[ttt].gen+(int)(short)preset[ttt].gen;
-                                       	break;
-                                       case 8: // initial filter cutoff
-                                       	if(inst[ttt].flag)
-                                       	 table[cnt].sf2_params[ttt]=(int)(short)inst[ttt].gen+(preset[ttt].flag?(int)(short)preset[ttt].gen:0);
-                                       	else
-                                       	 table[cnt].sf2_params[ttt]=13500+(int)(short)preset[ttt].gen; // 20000 Hz
-                                        break;
-                                      }
-                                     }
-
-                                     if(inst[47].flag && inst[47].gen!=(word)-1) // force_velocity
-                                     {
-                                      vel=(int)(short)inst[47].gen;
-                                      table[cnt].sf2_params[47]=vel;
-                                     }
-                                     else
-                                      table[cnt].sf2_params[47]=-1;
-
-                                     if(inst[57].flag) // instr layer only; exclusive_class
-                                      table[cnt].sf2_params[57]=inst[57].gen;
-                                     else
-                                      table[cnt].sf2_params[57]=0;
-
-                                     if(inst[54].flag) // sample_mode
-                                      table[cnt].sf2_params[54]=inst[54].gen&0x3;
-                                     else
-                                      table[cnt].sf2_params[54]=0;
-
-                                     if(inst[56].flag) // scale_tune
-                                      table[cnt].sf2_params[56]=inst[56].gen;
-                                     else
-                                      table[cnt].sf2_params[56]=100;
-
-                                     // -----------
-
-                                     // calculate offset=pitch [initial]
-                                     int offset;
-                                     int ori_key;
-
-                                     if(inst[58].flag && ((short)inst[58].gen)!=-1)
-                                      ori_key=(int)(short)inst[58].gen;
-                                     else
-                                      ori_key=(int)(short)sf->samples[nsample].original_key;
-
-                                     if(ori_key==-1)
-                                      ori_key=60;
-
-                                     if(inst[46].flag) // force_key_num
-                                     {
-                                 	offset = (int)((short)inst[46].gen - ori_key) * 4096;
-                                     }
-                                     else 
-                                     {
-                                  	offset = (note - ori_key) * 4096;
-                                     }
-                                     offset/=12;
-
-                                     // scale_tune
-                                     offset = (offset * (table[cnt].sf2_params[56]+midi->channels[chn].nrpn_sf_data[56])) / 100;
-
-                                     int tmp1= (int)(4096 * (
-                                          (table[cnt].sf2_params[51]+midi->channels[chn].nrpn_sf_data[51])*100 + 
-                                          (table[cnt].sf2_params[52]+midi->channels[chn].nrpn_sf_data[52]) + 
-                                          (int)(short)sf->samples[nsample].correction
-                                          ) ); // coarse&fine&correction
-                                     tmp1=tmp1/1200;
-                                     offset+=tmp1;
-
-                                     // root pitch = sr2pitch(sample_rate): returns 0xe000 for 48000; 0xde0b - 44100
-                                     offset+=(int)(kx_srToPitch(kx_sr_coeff(hw,sf->samples[nsample].sample_rate)) >> 8);
-                                     table[cnt].sf2_pitch = (word)offset;
-
-				     // defaults: (re-written on DCYSUSV_ON)
-                                     // ------------------------
-                                     table[cnt].fc_target = 0xffff;
-                                     table[cnt].current_fc = 0xffff;
-
-                                     // ----
-
-                                     start_addr+=sf->samples[nsample].start;
-                                     end_addr+=sf->samples[nsample].end;
-
-                                     if(table[cnt].sf2_params[54]==2)
-                                      table[cnt].sf2_params[54]=0;
-
-                                     table[cnt].loop_type=table[cnt].sf2_params[54];
-
-                                     if(table[cnt].sf2_params[54]) // has any loop: 1 || 3
-                                     {
-                                       start_loop+=sf->samples[nsample].start_loop;
-                                       end_loop+=sf->samples[nsample].end_loop;
-                                     }
-                                     else // 0 || [2->0]
-                                     {
-                                     /*
-                                       // the audio stops 28-samples after the loop
-                                       // (for 16-bit audio -- due to cache)
-                                       // 3538g: 28/2 -> 28 for both
-                                       // pre-3538: was end_addr for start only
-                                       if(hw->is_10k2)
-                                       {
-                                        start_loop=end_addr+28;
-                                        end_loop=end_addr+28;
-                                       }
-                                       else
-                                       {
-                                        start_loop=end_addr-32;
-                                        end_loop=end_addr-32;
-                                       }
-
-                                       // kx_voice_start will set SOLEH/SOLEL bits
-                                      */
-                                       // pre-3536b
-                                       start_loop=end_addr+8/2;
-                                       end_loop=end_addr+40/2;
-                                       end_addr+=46/2;
-
-                                       table[cnt].sf2_params[54]=table[cnt].loop_type=1;
-                                     }
-
-                                     // (unused) 
-                                     // sf->samples[nsample].sample_link
-
-                                     table[cnt].sample_type=sf->samples[nsample].sample_type&0xf;
-
-                                     __int64 a;
-                                     void *start_=((hw->cb.lmem_get_addr_func)(hw->cb.call_with,(void **)&sf->sample_data,start_addr*2,&a));
-
-                                     table[cnt].start = (dword) ((((uintptr_t)start_)&0xfff)/2); // lowest offset
-                                     table[cnt].startloop = start_loop-start_addr+table[cnt].start;
-                                     table[cnt].endloop = end_loop-start_addr+table[cnt].start;
-                                     table[cnt].end = end_addr-start_addr+table[cnt].start;
-
-                                     if(a==0)
-                                     {
-                                      debug(DLIB,"Error remapping phys2linear\n");
-                                      kx_lock_release(hw,&hw->sf_lock,&flags);
-                                      return 0;
-                                     }
-
-                                     // #error this is wrong, need to pass more data for kx_alloc_buffer()
-                                     // FIXME NOW !! 3543
-
-                                     // buffer.size
-                                     table[cnt].tmp_buffer_size=((table[cnt].end * 2 / KX_PAGE_SIZE) + (((table[cnt].end * 2) % KX_PAGE_SIZE) ? 1 : 0))*KX_PAGE_SIZE;
-                                     // buffer.physical
-                                     table[cnt].tmp_buffer_physical=(dword)a; // final physical address [this is only first part!]
-                                     // buffer.addr
-                                     table[cnt].tmp_buffer_addr=(void *)((uintptr_t)start_&0xfffff000);
-
-                                     table[cnt].interpolate=0;
-
-                                     cnt++;
-
-                                     if(cnt>=KX_MAX_SF_VOICES)
-                                     {
-                                      kx_lock_release(hw,&hw->sf_lock,&flags);
-                                      return cnt;
-                                      }
-
-                                     // ----------------------- end final code -------------------
-                                     }
-                                    } else debug(DLIB,"!! Incorrect igenlist generator [%d]\n",
-                                      sf->igenlists[dd].gen_oper);
-                            } // for all generators in instr (dd)
-                            cur2=&inst[0];
-                            memset(&inst[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
-                            // memcpy(&inst[0],sf_defaults,sizeof(sf_parameters_t)*SF_PARAMETERS);
-                        } // for all bags with generators in instr (cc)
-                  } // was instrument
-                 } else debug(DLIB,"!!! Unknown SF generator [%xh]\n",sf->pgenlists[gg].gen_oper);
-               } // for k: all gens in preset_bags[]
-
-               current=&preset[0];
-               memset(&preset[0],0,sizeof(sf_parameters_t)*SF_PARAMETERS);
-            } // for all bags with generators in preset
-          } // found needed preset
-        } // each preset headers
+            debug(DLIB,"!!! Incorrect soundfont: bad preset bag [inst: %d bank: %d/%d]\n",
+              midi->channels[chn].program,midi->channels[chn].bank_lsb,midi->channels[chn].bank_msb);
+            kx_lock_release(hw,&hw->sf_lock,&flags);
+            return 0;
+          }
+
+          debug(DSFNT,"- preset #%d ('%s')\n",p->header,sf->presets[p->header].name);
+
+          int match[KX_MAX_SF_VOICES];
+          int n=sf_match_zones(ndx,p,note,&vel,match,KX_MAX_SF_VOICES-cnt);
+
+          for(int i=0;i<n;i++)
+          {
+             kx_sf_zone *z=&ndx->zones[match[i]];
+             kx_voice_param *t=&table[cnt];
+
+             t->sf2_usage=VOICE_USAGE_MIDI|VOICE_FLAGS_16BIT|VOICE_FLAGS_MONO;
+             memcpy(t->sf2_params,z->sf2_params,sizeof(t->sf2_params));
+
+             // calculate offset=pitch [initial]
+             int offset;
+
+             if(z->flags&SF_ZONE_FORCE_KEY) // force_key_num
+              offset = (z->force_key - z->ori_key) * 4096;
+             else
+              offset = (note - z->ori_key) * 4096;
+             offset/=12;
+
+             // scale_tune
+             offset = (offset * (t->sf2_params[56]+nrpn[56])) / 100;
+
+             int tmp1= (int)(4096 * (
+                  (t->sf2_params[51]+nrpn[51])*100 +
+                  (t->sf2_params[52]+nrpn[52]) +
+                  (int)(short)z->sample->correction
+                  ) ); // coarse&fine&correction
+             tmp1=tmp1/1200;
+             offset+=tmp1;
+
+             // root pitch = sr2pitch(sample_rate): returns 0xe000 for 48000; 0xde0b - 44100
+             offset+=(int)(kx_srToPitch(kx_sr_coeff(hw,z->sample->sample_rate)) >> 8);
+             t->sf2_pitch = (word)offset;
+
+             // defaults: (re-written on DCYSUSV_ON)
+             t->fc_target = 0xffff;
+             t->current_fc = 0xffff;
+
+             t->loop_type=t->sf2_params[54];
+             t->sample_type=z->sample->sample_type&0xf;
+
+             if(ndx->stream)
+             {
+              // streamed: the pages are mapped by kx_alloc_buffer() (see bufmgr.cpp)
+              t->start = (dword) (((z->start_addr*2)&0xfff)/2);
+              t->tmp_stream=ndx->stream;
+              t->tmp_stream_page=z->start_addr*2/KX_PAGE_SIZE;
+              t->tmp_buffer_physical=0; // not shared with other voices
+              t->tmp_buffer_addr=NULL;
+              t->tmp_lmem=NULL;
+             }
+             else
+             {
+              __int64 a;
+              void **lmem=z->data?&z->data->lmem:(void **)&sf->sample_data;
+              void *start_=((hw->cb.lmem_get_addr_func)(hw->cb.call_with,lmem,z->start_addr*2,&a));
+
+              if(a==0)
+              {
+               debug(DLIB,"Error remapping phys2linear\n");
+               kx_lock_release(hw,&hw->sf_lock,&flags);
+               return 0;
+              }
+
+              t->start = (dword) ((((uintptr_t)start_)&0xfff)/2); // lowest offset
+              t->tmp_stream=NULL;
+
+              // #error this is wrong, need to pass more data for kx_alloc_buffer()
+              // FIXME NOW !! 3543
+
+              // buffer.physical
+              t->tmp_buffer_physical=(dword)a; // final physical address [this is only first part!]
+              // buffer.addr
+              t->tmp_buffer_addr=(void *)((uintptr_t)start_&~(uintptr_t)0xfff);
+              t->tmp_lmem=*lmem;
+             }
+             t->startloop = z->start_loop-z->start_addr+t->start;
+             t->endloop = z->end_loop-z->start_addr+t->start;
+             t->end = z->end_addr-z->start_addr+t->start;
+
+             // buffer.size
+             t->tmp_buffer_size=((t->end * 2 / KX_PAGE_SIZE) + (((t->end * 2) % KX_PAGE_SIZE) ? 1 : 0))*KX_PAGE_SIZE;
+
+             t->interpolate=0;
+
+             cnt++;
+          }
+
+          if(cnt>=KX_MAX_SF_VOICES)
+          {
+           kx_lock_release(hw,&hw->sf_lock,&flags);
+           return cnt;
+          }
+        } // each preset with this bank/preset
 
         if(cnt!=0) // found already
          break;
@@ -30,9 +30,10 @@
 #pragma optimize("gty", on)
 #pragma inline_depth(16)
 #endif
-static inline int timecent_to_msec(int timecent) // correct FIXME: optimize
+static inline int timecent_to_msec(int timecent) // correct
 {
-	return (int)(1000 * kx_pow2((double)timecent / 1200.0));
+	dword ms=kx_fixed_cents(timecent,1000); // 1000*2^(timecent/1200)
+	return ms>0x7fffffff?0x7fffffff:(int)ms;
 }
 
 #ifdef CE_OPTIMIZE
@@ -41,7 +42,8 @@ static inline int timecent_to_msec(int timecent) // correct FIXME: optimize
 #endif
 static inline int abscent_to_mHz(int abscents)
 {
-	return (int)(8176.0 * kx_pow2((double)abscents / 1200.0));
+	dword mhz=kx_fixed_cents(abscents,8176); // 8176*2^(abscents/1200)
+	return mhz>0x7fffffff?0x7fffffff:(int)mhz;
 }
 
 #ifdef CE_OPTIMIZE
@@ -465,8 +467,7 @@ static inline void recalc_cutoff(kx_hw *hw,int num,kx_midi_state *midi,int chn)
      // mHz -> abs cent: log2(hz/8.176)*1200.0
 
      if(midi->channels[chn].nrpn_awe_data[21]!=0)
-       fc=(int)(kx_log10(((float)midi->channels[chn].nrpn_awe_data[21]*62.0f+100.0f)/8.176f)*3986.313713864834f);
-       // 3986.313713864834: (1/log10(2))*1200
+       fc=(int)(((__int64)(kx_fixed_log2((dword)(midi->channels[chn].nrpn_awe_data[21]*62+100)*1000)-kx_fixed_log2(8176))*1200)>>16);
    }
 
    if(hw->synth_compat&KX_SYNTH_COMPAT_842)
@@ -931,7 +932,44 @@ static inline void recalc_pitch(kx_hw *hw,int num,kx_midi_state *midi,int chn)
 
  hw->voicetable[num].param.initial_pitch=ip;
 
- hw->voicetable[num].param.pitch_target=(dword)kx_pow2((float)ip/(float)0x1000);
+ // 2^(ip/0x1000)
+ hw->voicetable[num].param.pitch_target=kx_fixed_pow2((int)((ip>0x7ffffff?0x7ffffff:ip)<<4),1);
+}
+
+// voice model for kx_steal_voices(): envelope timing in sample periods
+static inline dword model_time(int timecent)
+{
+ LIMITVALUE(timecent,-12000,8000);
+ return (dword)timecent_to_msec(timecent)*48;
+}
+
+static inline void recalc_model(kx_hw *hw,int num,kx_midi_state *midi,int chn,int note,dword now)
+{
+ kx_voice *v=&hw->voicetable[num];
+ kx_voice_model *m=&v->model;
+ int *sf=v->param.sf2_params;
+ int *nrpn=midi->channels[chn].nrpn_sf_data;
+
+ m->on_time=now;
+ m->released=0;
+ m->off_time=0;
+ m->off_attn=0;
+
+ m->attack=model_time(sf[33]+nrpn[33])+model_time(sf[34]+nrpn[34])+
+           model_time(sf[35]+nrpn[35]+(60-note)*(sf[39]+nrpn[39]));
+ m->decay=model_time(sf[36]+nrpn[36]+(60-note)*(sf[40]+nrpn[40]));
+ m->release=model_time(sf[38]+nrpn[38]);
+ m->sustain=sf[37]+nrpn[37];
+ LIMITVALUE(m->sustain,0,1000);
+
+ // one-shot samples stop once the loop (placed after the sample) is reached
+ if(sf[54]==0 && v->param.pitch_target && v->param.startloop>v->param.start)
+  m->end=(dword)((__int64)(v->param.startloop-v->param.start)*0x4000/v->param.pitch_target)+1;
+ else
+  m->end=0;
+
+ if(v->usage&VOICE_FLAGS_STEREO)
+  memcpy(&hw->voicetable[num+1].model,m,sizeof(kx_voice_model));
 }
 
 // ----------------------------------------------------------------------------------------------
@@ -941,11 +979,51 @@ static inline void recalc_pitch(kx_hw *hw,int num,kx_midi_state *midi,int chn)
 #pragma optimize("gty", on)
 #pragma inline_depth(16)
 #endif
+static dword synth_dirty_bit(int what)
+{
+ switch(what)
+ {
+  case CHANGE_MODULATION: return SYNTH_DIRTY_MODULATION; //  chpressure & modulation
+  case CHANGE_PITCHBEND: return SYNTH_DIRTY_PITCH;
+  case CHANGE_VOLUME: return SYNTH_DIRTY_VOLUME;
+  case CHANGE_PAN: return SYNTH_DIRTY_PAN;
+  case CHANGE_REVERB: return SYNTH_DIRTY_REVERB;
+  case CHANGE_CHORUS: return SYNTH_DIRTY_CHORUS;
+  case CHANGE_SOFT_PEDAL: return SYNTH_DIRTY_CUTOFF;
+  case CHANGE_PEFE: return SYNTH_DIRTY_PEFE;
+  case CHANGE_FILTERQ: return SYNTH_DIRTY_FILTERQ;
+  case CHANGE_GP1: return SYNTH_DIRTY_GP1;
+  case CHANGE_GP2: return SYNTH_DIRTY_GP1<<1;
+  case CHANGE_GP3: return SYNTH_DIRTY_GP1<<2;
+  case CHANGE_GP4: return SYNTH_DIRTY_GP1<<3;
+ }
+ return 0;
+}
+
+// controller changes are not written immediately: dense CC / pitch bend streams would
+// rewrite the same registers many times per millisecond;
+// the channel (note==-1) or the voices are marked dirty, and kx_synth_flush() writes the final
+// values once: at the end of each kx_midi_play_buffer() chunk and of each batch of scheduled events
+// (midi.cpp: queue timer), always after the parser and with midi->lock held
 KX_API(int,kx_synth_changes(kx_midi_state *midi,int chn,int note,int what))
 {
  kx_hw *hw=midi->hw;
  int i;
 
+ if(chn<0 || chn>=MAX_MIDI_CHANNELS)
+  return -1;
+
+ hw->synth_changes++;
+
+ dword bit=synth_dirty_bit(what);
+
+ if(bit && note==-1)
+ {
+  midi->channels[chn].dirty|=bit;
+  midi->dirty_channels|=(1<<chn);
+  return 0;
+ }
+
  for(i=0;i<KX_NUMBER_OF_VOICES;i++)
  {
    if((voice_usage(hw->voicetable[i].usage)==VOICE_USAGE_MIDI) &&
@@ -955,139 +1033,254 @@ KX_API(int,kx_synth_changes(kx_midi_state *midi,int chn,int note,int what))
    {
         switch(what)
         {
-         case CHANGE_MODULATION: //  chpressure & modulation
+         case CHANGE_HOLD2:
          	{
-         	kx_fpu_state state;
-		 hw->cb.save_fpu_state(&state);
-        	 recalc_modulation(hw,i,midi,chn);
-        	hw->cb.rest_fpu_state(&state);
-         	 kx_writeptr_multiple(hw,i,
-         	   FMMOD,(hw->voicetable[i].param.modlfo2fc&0xff)|((hw->voicetable[i].param.modlfo2pitch&0xff)<<8),
-                   FM2FRQ2,(hw->voicetable[i].param.viblfofreq&0xff)|((hw->voicetable[i].param.viblfo2pitch&0xff)<<8),
-                   TREMFRQ, (hw->voicetable[i].param.modlfofreq&0xff)|((hw->voicetable[i].param.modlfo2vol&0xff)<<8),
-                   REGLIST_END);
+         	 recalc_hold2(hw,i,midi,chn);
+                // cannot be changed realtime...
                 }
          	break;
-         case CHANGE_PITCHBEND: 
+         default:
+         	if(bit)
          	{
-         	kx_fpu_state state;
-		 hw->cb.save_fpu_state(&state);
-                  recalc_pitch(hw,i,midi,chn);
-                 hw->cb.rest_fpu_state(&state);
-
-         	kx_writeptr_multiple(hw,i,
-         	 PTAB_PITCHTARGET,hw->voicetable[i].param.pitch_target,
-         	 IP,hw->voicetable[i].param.initial_pitch,
-         	 REGLIST_END);
-
-                // FIXME: we could use set_audio_parameter(KX_VOICE_PITCH+KX_VOICE_UPDATE);
-                //  -- performs realtime QKBCA/Interprom update
-                }
+         	 hw->voicetable[i].synth_dirty|=bit;
+         	 midi->dirty_channels|=(1<<chn);
+         	}
+         	else
+         	 debug(DLIB,"!!! Unknown 'what' in synth_changes (%d)!\n",what);
          	break;
-         case CHANGE_VOLUME:
-         	recalc_volume(hw,i,midi,chn,hw->voicetable[i].vel);
-                kx_writeptr(hw, IFATN_ATTENUATION, i, hw->voicetable[i].param.initial_attn);
-                // fixme?? do we need to set cvcf/vtft when envvol==0xbfff?
-         	break;
-         case CHANGE_PAN:
-         	recalc_pan(hw,i,midi,chn);
-         	kx_wave_set_parameter(hw,i,0,KX_VOICE_PAN+KX_VOICE_UPDATE,0);
-         	break;
-         case CHANGE_REVERB:
-         	recalc_reverb(hw,i,midi,chn);
-         	kx_wave_set_parameter(hw,i,0,KX_VOICE_SEND_C+KX_VOICE_UPDATE,0);
-         	break;
-         case CHANGE_CHORUS:
-         	recalc_chorus(hw,i,midi,chn);
-         	kx_wave_set_parameter(hw,i,0,KX_VOICE_SEND_D+KX_VOICE_UPDATE,0);
-         	break;
-         case CHANGE_SOFT_PEDAL:
-         	{
-		 kx_fpu_state state;
-		 hw->cb.save_fpu_state(&state);
-		  recalc_cutoff(hw,i,midi,chn);
-                 hw->cb.rest_fpu_state(&state);
+        }
+   }
+ }
+ return 0;
+}
 
-                 if(hw->synth_compat&KX_SYNTH_COMPAT_REAL_FC) 
-                  kx_writeptr(hw,IFATN_FILTERCUTOFF,i,hw->voicetable[i].param.initial_fc);
-                }
-                break;
-         case CHANGE_PEFE:
-         	recalc_filter(hw,i,midi,chn);
-         	kx_writeptr_multiple(hw,i,
-				// filter envelope 
-				    PEFE_FILTERAMOUNT, hw->voicetable[i].param.filter_amount,
-				// pitch envelope 
-				    PEFE_PITCHAMOUNT, hw->voicetable[i].param.pitch_amount,
-				    REGLIST_END);
-         	break;
-         case CHANGE_FILTERQ:
-         	recalc_filterQ(hw,i,midi,chn);
+// recalculates the dirty parameters of a voice and writes them in one kx_writeptr_list() burst
+#ifdef CE_OPTIMIZE
+#pragma optimize("gty", on)
+#pragma inline_depth(16)
+#endif
+static void synth_update_voice(kx_midi_state *midi,int i,dword what)
+{
+ kx_hw *hw=midi->hw;
+ kx_voice *v=&hw->voicetable[i];
+ int chn=v->channel;
+ dword list[16*2];
+ int n=0;
+ int sends=0; // kx_set_fx_amount() 'where'
 
-         	{
-         	 if(hw->synth_compat&KX_SYNTH_COMPAT_REAL_RESONANCE)
-         	 {
-         	 if(hw->is_10k2)
-         	 {
-        		 dword regptr;
-        		 unsigned long flags=0;
+ #define SYNTH_WRITE(reg,val) { list[n*2]=(reg); list[n*2+1]=(val); n++; }
 
-        		 regptr = (((QKBCA) << 16) & PTR_ADDRESS_MASK) | (i & PTR_CHANNELNUM_MASK);
+ if(what&SYNTH_DIRTY_MODULATION)
+ {
+  recalc_modulation(hw,i,midi,chn);
+  SYNTH_WRITE(FMMOD,(v->param.modlfo2fc&0xff)|((v->param.modlfo2pitch&0xff)<<8));
+  SYNTH_WRITE(FM2FRQ2,(v->param.viblfofreq&0xff)|((v->param.viblfo2pitch&0xff)<<8));
+  SYNTH_WRITE(TREMFRQ,(v->param.modlfofreq&0xff)|((v->param.modlfo2vol&0xff)<<8));
+ }
+ if(what&SYNTH_DIRTY_PITCH)
+ {
+  recalc_pitch(hw,i,midi,chn);
+  SYNTH_WRITE(PTAB_PITCHTARGET,v->param.pitch_target);
+  SYNTH_WRITE(IP,v->param.initial_pitch);
+  // FIXME: we could use set_audio_parameter(KX_VOICE_PITCH+KX_VOICE_UPDATE);
+  //  -- performs realtime QKBCA/Interprom update
+ }
+ if(what&SYNTH_DIRTY_VOLUME)
+ {
+  recalc_volume(hw,i,midi,chn,v->vel);
+  SYNTH_WRITE(IFATN_ATTENUATION,v->param.initial_attn);
+  // fixme?? do we need to set cvcf/vtft when envvol==0xbfff?
+ }
+ if(what&SYNTH_DIRTY_PAN)
+ {
+  recalc_pan(hw,i,midi,chn);
+  if(v->state==VOICE_STATE_STARTED) // as KX_VOICE_PAN+KX_VOICE_UPDATE
+   sends|=3;
+ }
+ if(what&SYNTH_DIRTY_REVERB)
+ {
+  recalc_reverb(hw,i,midi,chn);
+  sends|=4;
+ }
+ if(what&SYNTH_DIRTY_CHORUS)
+ {
+  recalc_chorus(hw,i,midi,chn);
+  sends|=8;
+ }
+ if(what&SYNTH_DIRTY_CUTOFF)
+ {
+  recalc_cutoff(hw,i,midi,chn);
+  if(hw->synth_compat&KX_SYNTH_COMPAT_REAL_FC)
+   SYNTH_WRITE(IFATN_FILTERCUTOFF,v->param.initial_fc);
+ }
+ if(what&SYNTH_DIRTY_PEFE)
+ {
+  recalc_filter(hw,i,midi,chn);
+  // filter envelope 
+  SYNTH_WRITE(PEFE_FILTERAMOUNT,v->param.filter_amount);
+  // pitch envelope 
+  SYNTH_WRITE(PEFE_PITCHAMOUNT,v->param.pitch_amount);
+ }
+ if(what&SYNTH_DIRTY_FILTERQ)
+ {
+  recalc_filterQ(hw,i,midi,chn);
+  if((hw->synth_compat&KX_SYNTH_COMPAT_REAL_RESONANCE) && !hw->is_10k2)
+   SYNTH_WRITE(QKBCA_RESONANCEQ,v->param.filterQ);
+ }
+ if(what&(SYNTH_DIRTY_GP1*0xf))
+ {
+  recalc_gp(hw,i,midi,chn);
+  if(hw->is_10k2)
+   sends|=((what/SYNTH_DIRTY_GP1)&0xf)<<4;
+ }
 
-        		 hw->voicetable[i].param.filterQ&=0xf;
+ // MIDI voices are not smoothed by kx_set_fx_amount(): the amounts are written as is
+ if(sends&3)
+  SYNTH_WRITE(PTAB_SENDAB,(v->param.send_a<<8)|v->param.send_b);
+ if(sends&4)
+  SYNTH_WRITE(SCSA_FXSENDAMOUNT_C,v->param.send_c);
+ if(sends&8)
+  SYNTH_WRITE(SDL_FXSENDAMOUNT_D,v->param.send_d);
+ if(sends&0x10)
+  SYNTH_WRITE(FXSENDAMOUNT_E,v->param.send_e);
+ if(sends&0x20)
+  SYNTH_WRITE(FXSENDAMOUNT_F,v->param.send_f);
+ if(sends&0x40)
+  SYNTH_WRITE(FXSENDAMOUNT_G,v->param.send_g);
+ if(sends&0x80)
+  SYNTH_WRITE(FXSENDAMOUNT_H,v->param.send_h);
+
+ #undef SYNTH_WRITE
+
+ if(n)
+ {
+  kx_writeptr_list(hw,i,list,n);
+  hw->synth_updates++;
+ }
 
-        		 kx_lock_acquire(hw,&hw->hw_lock, &flags);
+ // 10k2 resonance: upper nibble of the QKBCA byte 3
+ if((what&SYNTH_DIRTY_FILTERQ) && (hw->synth_compat&KX_SYNTH_COMPAT_REAL_RESONANCE) && hw->is_10k2)
+ {
+  dword regptr;
+  unsigned long flags=0;
 
-        		 outpd(hw->port + PTR,regptr);
+  regptr = (((QKBCA) << 16) & PTR_ADDRESS_MASK) | (i & PTR_CHANNELNUM_MASK);
 
-        		 byte old=inp(hw->port + DATA + 3);
+  v->param.filterQ&=0xf;
 
-        		 old=(byte)((old&0x0f)|(hw->voicetable[i].param.filterQ<<4));
-        		 outp(hw->port + DATA + 3,old);
+  kx_lock_acquire(hw,&hw->hw_lock, &flags);
 
-        		 kx_lock_release(hw,&hw->hw_lock, &flags);
-        	  }
-        	  else
-        	  {
-        		 kx_writeptr(hw, QKBCA_RESONANCEQ, i, hw->voicetable[i].param.filterQ);
-        	  }
-        	 }
-		}
-         	break;
-         case CHANGE_HOLD2:
-         	{
-		kx_fpu_state state;
-		 hw->cb.save_fpu_state(&state);
-         	 recalc_hold2(hw,i,midi,chn);
-         	hw->cb.rest_fpu_state(&state);
-                // cannot be changed realtime...
-                }
-         	break;
-         case CHANGE_GP1:
-         	recalc_gp(hw,i,midi,chn);
-         	kx_wave_set_parameter(hw,i,0,KX_VOICE_SEND_E+KX_VOICE_UPDATE,0);
-         	break;
-         case CHANGE_GP2:
-         	recalc_gp(hw,i,midi,chn);
-         	kx_wave_set_parameter(hw,i,0,KX_VOICE_SEND_F+KX_VOICE_UPDATE,0);
-         	break;
-         case CHANGE_GP3:
-         	recalc_gp(hw,i,midi,chn);
-         	kx_wave_set_parameter(hw,i,0,KX_VOICE_SEND_G+KX_VOICE_UPDATE,0);
-         	break;
-         case CHANGE_GP4:
-         	recalc_gp(hw,i,midi,chn);
-         	kx_wave_set_parameter(hw,i,0,KX_VOICE_SEND_H+KX_VOICE_UPDATE,0);
-         	break;
-         default:
-         	debug(DLIB,"!!! Unknown 'what' in synth_changes (%d)!\n",what);
-         	break;
-        }
-   }
+  outpd(hw->port + PTR,regptr);
+
+  byte old=inp(hw->port + DATA + 3);
+
+  old=(byte)((old&0x0f)|(v->param.filterQ<<4));
+  outp(hw->port + DATA + 3,old);
+
+  kx_lock_release(hw,&hw->hw_lock, &flags);
+ }
+}
+
+// pending changes of a single voice (before it is released)
+static void synth_flush_voice(kx_midi_state *midi,int i)
+{
+ kx_voice *v=&midi->hw->voicetable[i];
+
+ if(voice_usage(v->usage)!=VOICE_USAGE_MIDI || v->synth_id!=(uintptr_t)midi ||
+    v->channel<0 || v->channel>=MAX_MIDI_CHANNELS || !(midi->dirty_channels&(1<<v->channel)))
+  return;
+
+ dword what=v->synth_dirty|midi->channels[v->channel].dirty;
+ v->synth_dirty=0;
+ if(what)
+  synth_update_voice(midi,i,what);
+}
+
+KX_API(int,kx_synth_flush(kx_midi_state *midi))
+{
+ kx_hw *hw=midi->hw;
+
+ if(!hw || !midi->dirty_channels)
+  return 0;
+
+ // take the masks first: changes made while flushing are left for the next flush
+ dword channels=midi->dirty_channels;
+ dword dirty[MAX_MIDI_CHANNELS];
+ midi->dirty_channels=0;
+ for(int c=0;c<MAX_MIDI_CHANNELS;c++)
+ {
+  if(channels&(1<<c))
+  {
+   dirty[c]=midi->channels[c].dirty;
+   midi->channels[c].dirty=0;
+  }
+  else
+   dirty[c]=0;
+ }
+
+ for(int i=0;i<KX_NUMBER_OF_VOICES;i++)
+ {
+  kx_voice *v=&hw->voicetable[i];
+
+  if((voice_usage(v->usage)==VOICE_USAGE_MIDI) &&
+     (v->synth_id==(uintptr_t)midi) &&
+     (v->channel>=0 && v->channel<MAX_MIDI_CHANNELS) &&
+     (channels&(1<<v->channel)))
+  {
+   dword what=dirty[v->channel]|v->synth_dirty;
+   v->synth_dirty=0;
+   if(what)
+    synth_update_voice(midi,i,what);
+  }
  }
  return 0;
 }
 
+// voice parameter tables: one of the midi->arena tables (see kx_midi_init());
+// the heap is only used if all of them are busy (re-entrant note-ons) or kx_midi_init() failed to allocate them
+static kx_voice_param *synth_claim_table(kx_midi_state *midi,int *arena)
+{
+ kx_hw *hw=midi->hw;
+ unsigned long flags=0;
+
+ if(midi->arena)
+ {
+  kx_lock_acquire(hw,&hw->k_lock,&flags);
+  for(int i=0;i<KX_SYNTH_ARENAS;i++)
+  {
+   if(!(midi->arena_busy&(1<<i)))
+   {
+    midi->arena_busy|=(1<<i);
+    kx_lock_release(hw,&hw->k_lock,&flags);
+    *arena=i;
+    return &midi->arena[i*KX_MAX_SF_VOICES];
+   }
+  }
+  kx_lock_release(hw,&hw->k_lock,&flags);
+ }
+
+ kx_voice_param *table=NULL;
+ hw->cb.malloc_func(hw->cb.call_with,sizeof(kx_voice_param)*KX_MAX_SF_VOICES,(void **)&table,KX_NONPAGED);
+ hw->synth_allocations++;
+ *arena=-1;
+ return table;
+}
+
+static void synth_release_table(kx_midi_state *midi,kx_voice_param *table,int arena)
+{
+ kx_hw *hw=midi->hw;
+
+ if(arena>=0)
+ {
+  unsigned long flags=0;
+  kx_lock_acquire(hw,&hw->k_lock,&flags);
+  midi->arena_busy&=~(1<<arena);
+  kx_lock_release(hw,&hw->k_lock,&flags);
+ }
+ else
+  (hw->cb.free_func)(hw->cb.call_with,table);
+}
+
 // #define REPARSE_SF
 
 #ifdef REPARSE_SF
@@ -1112,8 +1305,8 @@ KX_API(int,kx_synth_start(kx_midi_state *midi,int chn,int note,int vel))
  			           vel,
  			           chn);
 
- kx_voice_param *table=0;
- hw->cb.malloc_func(hw->cb.call_with,sizeof(kx_voice_param)*KX_MAX_SF_VOICES,(void **)&table,KX_NONPAGED);
+ int arena=-1;
+ kx_voice_param *table=synth_claim_table(midi,&arena);
  if(!table)
  {
   debug(DLIB,"synth_start: no more memory\n");
@@ -1124,14 +1317,13 @@ KX_API(int,kx_synth_start(kx_midi_state *midi,int chn,int note,int vel))
  if(cnt<=0)
  {
   debug(DSFNT,"-- no SF data for this voice\n");
-  (hw->cb.free_func)(hw->cb.call_with,table);
+  synth_release_table(midi,table,arena);
   return 0;
  }
 
  dword unique=(dword)((dword)kx_readfn0(hw,WC_SAMPLECOUNTER)^(dword)(uintptr_t)midi);
 
- kx_fpu_state state;
- hw->cb.save_fpu_state(&state);
+ dword now=kx_voice_clock(hw);
 
  for(int j=0; j<cnt;j++)
  {
@@ -1175,6 +1367,7 @@ KX_API(int,kx_synth_start(kx_midi_state *midi,int chn,int note,int vel))
        recalc_hold2(hw,num,midi,chn); // hold2
        recalc_cutoff(hw,num,midi,chn); // soft pedal / cutoff
        recalc_gp(hw,num,midi,chn);
+       recalc_model(hw,num,midi,chn,note,now);
 
        debug(DSFNT," -- hw note[%d]: vol=%x usage=%x\n",num,hw->voicetable[num].param.volume_target,
         table[j].sf2_usage//hw->voicetable[num].usage
@@ -1190,6 +1383,9 @@ KX_API(int,kx_synth_start(kx_midi_state *midi,int chn,int note,int vel))
        hw->voicetable[num].buffer.notify=10;
        hw->voicetable[num].buffer.that=0;
        hw->voicetable[num].buffer.instance=0;
+       hw->voicetable[num].sf_stream=hw->voicetable[num].param.tmp_stream;
+       hw->voicetable[num].sf_stream_page=hw->voicetable[num].param.tmp_stream_page;
+       hw->voicetable[num].sf_lmem=hw->voicetable[num].param.tmp_lmem;
 
        if(kx_alloc_buffer(hw,num))
        {
@@ -1237,14 +1433,13 @@ KX_API(int,kx_synth_start(kx_midi_state *midi,int chn,int note,int vel))
         }
        }
        hw->voicetable[num].unique=unique;
+       hw->voicetable[num].synth_dirty=0; // recalculated above
 
        hw->voicetable[num].usage=table[j].sf2_usage|VOICE_USAGE_TEMP; // finalize usage
        if(table[j].sf2_usage&VOICE_FLAGS_STEREO)
         hw->voicetable[num+1].usage=table[j].sf2_usage|VOICE_USAGE_TEMP;
  }
 
- hw->cb.rest_fpu_state(&state);
-
  kx_voice_start_multiple(hw,fl1,fl2);
 
  for(int i=0;i<KX_NUMBER_OF_VOICES;i++)
@@ -1253,7 +1448,7 @@ KX_API(int,kx_synth_start(kx_midi_state *midi,int chn,int note,int vel))
    hw->voicetable[i].usage&=~(VOICE_USAGE_TEMP);
   }
 
- (hw->cb.free_func)(hw->cb.call_with,table);
+ synth_release_table(midi,table,arena);
 
  return 0;
 }
@@ -1261,6 +1456,11 @@ KX_API(int,kx_synth_start(kx_midi_state *midi,int chn,int note,int vel))
 KX_API(int,kx_synth_release(kx_midi_state *midi,int ch))
 {
  kx_hw *hw=midi->hw;
+
+ // the release phase keeps the last controller values
+ if(ch>=0 && ch<KX_NUMBER_OF_VOICES)
+  synth_flush_voice(midi,ch);
+
  return kx_synth_release(hw,ch);
 }
 
@@ -1279,6 +1479,8 @@ KX_API(int,kx_synth_release(kx_hw *hw,int ch))
   return -1;
  }
 
+ kx_voice_model_release(hw,ch);
+
  if(hw->voicetable[ch].param.sf2_params[54]==3) // loop until key released
  {
   hw->voicetable[ch].param.sf2_params[54]=0;
@@ -21,6 +21,65 @@
 
 #include "kx.h"
 
+// the interval timer runs at the shortest delay of the active timers, and is stopped
+// while none is active; called with timer_lock held
+static void kx_timer_update(kx_hw *hw)
+{
+	struct kx_timer *t;
+	struct list *item;
+	dword delay = TIMER_STOPPED;
+	dword old = hw->timer_delay;
+
+	for_each_list_entry(item, &hw->timers)
+	{
+		t = list_item(item, struct kx_timer, list);
+		if(!t)
+		 continue;
+
+		if((t->status & TIMER_ACTIVE) && t->delay < delay)
+			delay = t->delay;
+	}
+
+	if(old == delay)
+		return;
+
+	hw->timer_delay = delay;
+
+	if(delay==TIMER_STOPPED)
+	{
+		kx_irq_disable(hw,INTE_INTERVALTIMERENB);
+		return;
+	}
+
+	if(old==TIMER_STOPPED)
+		kx_irq_enable(hw,INTE_INTERVALTIMERENB);
+
+	int was_stopped = (old==TIMER_STOPPED);
+	delay = (delay < 1024 ? delay : 1024);
+	old = (old < 1024 ? old : 1024);
+
+	kx_writefn0w(hw, TIMER, (word)delay);
+
+	for_each_list_entry(item, &hw->timers)
+	{
+		t = list_item(item, struct kx_timer, list);
+		if(!t)
+		 continue;
+
+		t->target = t->delay / delay;
+		if(was_stopped || t->target==0)
+			// force scheduling on the next interrupt
+			t->counter = t->target - 1;
+		else
+		{
+			// keep the time elapsed since the last notification
+			t->counter = t->counter * old / delay;
+			if(t->counter >= t->target)
+				t->counter = t->target - 1;
+		}
+	}
+}
+
 void kx_timer_irq_handler(kx_hw *hw)
 {
 	struct kx_timer *t;
@@ -47,15 +106,17 @@ void kx_timer_irq_handler(kx_hw *hw)
 		}
 	}
 
+	// timer functions may clear TIMER_ACTIVE of their own timer
+	kx_timer_update(hw);
+
 	kx_lock_release(hw,&hw->timer_lock,&flags);
 
 	return;
 }
 
+// the timer is not running until kx_timer_enable()
 void kx_timer_install(kx_hw *hw, struct kx_timer *timer, dword delay)
 {
-	struct kx_timer *t;
-	struct list *item;
 	unsigned long flags=0;
 
 	if(delay < 5)
@@ -70,28 +131,6 @@ void kx_timer_install(kx_hw *hw, struct kx_timer *timer, dword delay)
 
 	list_add(&timer->list, &hw->timers);
 
-	if(hw->timer_delay > delay) 
-	{
-		if(hw->timer_delay==TIMER_STOPPED)
-			kx_irq_enable(hw,INTE_INTERVALTIMERENB);
-
-		hw->timer_delay = delay;
-		delay = (delay < 1024 ? delay : 1024);
-
-		kx_writefn0w(hw, TIMER, (word)delay);
-
-		for_each_list_entry(item, &hw->timers)
-		{
-			t = list_item(item, struct kx_timer, list);
-			if(!t)
-			 continue;
-
-			t->target = t->delay / delay;
-			// force scheduling on the next interrupt
-			t->counter = t->target - 1;
-		}
-	}
-
 	kx_lock_release(hw,&hw->timer_lock, &flags);
 
 	return;
@@ -99,9 +138,6 @@ void kx_timer_install(kx_hw *hw, struct kx_timer *timer, dword delay)
 
 void kx_timer_uninstall(kx_hw *hw, struct kx_timer *timer)
 {
-	struct kx_timer *t;
-	struct list *item;
-	dword delay = TIMER_STOPPED;
 	unsigned long flags=0;
 
 	if(timer->status==TIMER_UNINSTALLED)
@@ -110,39 +146,7 @@ void kx_timer_uninstall(kx_hw *hw, struct kx_timer *timer)
 	kx_lock_acquire(hw,&hw->timer_lock, &flags);
 
 	list_del(&timer->list);
-
-	for_each_list_entry(item, &hw->timers)
-	{
-		t = list_item(item, struct kx_timer, list);
-		if(!t)
-		 continue;
-
-		if(t->delay < delay)
-			delay = t->delay;
-	}
-
-	if(hw->timer_delay != delay)
-	{
-		hw->timer_delay = delay;
-
-		if(delay==TIMER_STOPPED)
-			kx_irq_disable(hw,INTE_INTERVALTIMERENB);
-		else {
-			delay = (delay < 1024 ? delay : 1024);
-
-			kx_writefn0w(hw, TIMER, (word)delay);
-
-			for_each_list_entry(item, &hw->timers)
-			{
-				t = list_item(item, struct kx_timer, list);
-				if(!t)
-				 continue;
-
-				t->target = t->delay / delay;
-				t->counter = t->target - 1;
-			}
-		}
-	}
+	kx_timer_update(hw);
 
 	kx_lock_release(hw,&hw->timer_lock, &flags);
 
@@ -157,6 +161,7 @@ void kx_timer_enable(kx_hw *hw, struct kx_timer *timer)
 
 	kx_lock_acquire(hw,&hw->timer_lock, &flags);
 	timer->status |= TIMER_ACTIVE;
+	kx_timer_update(hw);
 	kx_lock_release(hw,&hw->timer_lock, &flags);
 
 	return;
@@ -168,6 +173,7 @@ void kx_timer_disable(kx_hw *hw, struct kx_timer *timer)
 
 	kx_lock_acquire(hw,&hw->timer_lock, &flags);
 	timer->status &= ~TIMER_ACTIVE;
+	kx_timer_update(hw);
 	kx_lock_release(hw,&hw->timer_lock, &flags);
 	return;
 }
@@ -456,17 +456,127 @@ void kx_voice_stop(kx_hw *hw,int num)
 	}
 }
 
-int kx_voice_alloc(kx_hw *hw, int usage)
+// voice allocator
+// free voices are kept in a 64-bit bitmap (hw->voice_free) together with the mask of free
+// even/odd pairs (stereo voices), so that both mono and stereo allocations are bit scans
+// starting at hw->last_voice (circular allocation, unless KX_HW_ALT_CHN_ALLOCATION is set)
+// each voice class has a quota: MIDI voices over the quota are stolen from MIDI, so that
+// a burst of notes does not take the voices needed by wave / ASIO streams
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+ extern "C" unsigned __int64 __rdtsc(void);
+ #pragma intrinsic(__rdtsc)
+#endif
+
+static inline __int64 kx_voice_ticks(void)
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+ return (__int64)__rdtsc();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+ return (__int64)__builtin_ia32_rdtsc();
+#else
+ return 0;
+#endif
+}
+
+// should be called with k_lock held
+static inline void kx_voice_mark(kx_hw *hw,int num,int n,int is_free)
+{
+ for(int i=num;i<num+n;i++)
+ {
+  if(is_free)
+   hw->voice_free[i>>5]|=(1U<<(i&31));
+  else
+   hw->voice_free[i>>5]&=~(1U<<(i&31));
+ }
+ dword w=hw->voice_free[num>>5];
+ hw->voice_free_pairs[num>>5]=w&(w>>1)&0x55555555;
+}
+
+// first set bit at or after 'start', wrapping around; -1 if none
+static inline int kx_voice_find(const dword *map,int start)
+{
+ int i=kx_bitmap_scan(map,start,KX_NUMBER_OF_VOICES,1);
+ if(i==KX_NUMBER_OF_VOICES)
+ {
+  i=kx_bitmap_scan(map,0,start,1);
+  if(i==start)
+   return -1;
+ }
+ return i;
+}
+
+void kx_voice_alloc_init(kx_hw *hw)
+{
+ hw->voice_free[0]=hw->voice_free[1]=0;
+ for(int i=0;i<KX_NUMBER_OF_VOICES;i++)
+  if(hw->voicetable[i].usage==VOICE_USAGE_FREE)
+   kx_voice_mark(hw,i,1,1);
+
+ for(int i=0;i<KX_VOICE_CLASSES;i++)
+ {
+  hw->voice_quota[i]=KX_NUMBER_OF_VOICES;
+  hw->voice_used[i]=0;
+ }
+ hw->voice_quota[KX_VOICE_CLASS_MIDI]=KX_NUMBER_OF_VOICES-KX_VOICE_RESERVE;
+
+ hw->voice_allocs=0;
+ hw->voice_alloc_failures=0;
+ hw->voice_alloc_steals=0;
+ hw->voice_alloc_ticks=0;
+ hw->voice_alloc_ticks_max=0;
+
+ hw->voice_clock=0;
+ hw->voice_clock_wc=0;
+}
+
+int kx_voice_class(int usage,int routing)
+{
+ switch(routing)
+ {
+  case DEF_AC3_LEFT_ROUTING:
+  case DEF_AC3_CENTER_ROUTING:
+  case DEF_AC3_RIGHT_ROUTING:
+  case DEF_AC3_SLEFT_ROUTING:
+  case DEF_AC3_SRIGHT_ROUTING:
+  case DEF_AC3_SUBWOOFER_ROUTING:
+  case DEF_AC3_SCENTER_ROUTING:
+  case DEF_AC3PASSTHROUGH_ROUTING:
+  	return KX_VOICE_CLASS_AC3;
+  case DEF_3D_LEFT_ROUTING:
+  case DEF_3D_RIGHT_ROUTING:
+  case DEF_3D_TOP_ROUTING:
+  	return KX_VOICE_CLASS_3D;
+ }
+ switch(voice_usage(usage))
+ {
+  case VOICE_USAGE_MIDI:
+  	return KX_VOICE_CLASS_MIDI;
+  case VOICE_USAGE_ASIO:
+  	return KX_VOICE_CLASS_ASIO;
+ }
+ return KX_VOICE_CLASS_WAVE;
+}
+
+int kx_voice_alloc(kx_hw *hw, int usage, int voice_class)
 {
 	kx_voice *voicetable = hw->voicetable;
 	int pass=0;
-	int i=0;
-	int found=0;
+	int num=-1;
+	__int64 start_ticks=kx_voice_ticks();
+
+	if(voice_class<0 || voice_class>=KX_VOICE_CLASSES)
+	 voice_class=kx_voice_class(usage,-1);
+
+	int n=(usage & VOICE_FLAGS_STEREO ? 2 : 1);
 AGAIN:
 	unsigned long int_flags=0;
 
 	kx_lock_acquire(hw,&hw->k_lock, &int_flags);
 
+	if(pass) // retrying after kx_steal_voices()
+	 hw->voice_alloc_steals++;
+
 	usage=(usage&(~0xff))|VOICE_USAGE_TEMP;
 
     int last_voice = hw->last_voice;
@@ -474,47 +584,24 @@ AGAIN:
     if(hw->ext_flags&KX_HW_ALT_CHN_ALLOCATION)
       last_voice=0;
 
-	if(usage & VOICE_FLAGS_STEREO) 
+	if(hw->voice_used[voice_class]+n<=hw->voice_quota[voice_class])
 	{
-		for(i = (last_voice&0x7e); i < KX_NUMBER_OF_VOICES; i += 2)
-			if((voicetable[i].usage==VOICE_USAGE_FREE) && (voicetable[i + 1].usage==VOICE_USAGE_FREE))
-			{
-				voicetable[i].usage = usage;
-				voicetable[i + 1].usage = usage;
-				last_voice=i+2;
-				found=1;
-				break;
-			}
-		if(!found)
-		for(i = 0; i < (last_voice&0x7e); i += 2)
-			if((voicetable[i].usage==VOICE_USAGE_FREE) && (voicetable[i + 1].usage==VOICE_USAGE_FREE))
-			{
-				voicetable[i].usage = usage;
-				voicetable[i + 1].usage = usage;
-				last_voice=i+2;
-				found=1;
-				break;
-			}
+		if(usage & VOICE_FLAGS_STEREO)
+			num=kx_voice_find(hw->voice_free_pairs,last_voice&0x7e);
+		else
+			num=kx_voice_find(hw->voice_free,last_voice);
 	}
-	 else 
+
+	if(num>=0)
 	{
-		for(i = last_voice; i < KX_NUMBER_OF_VOICES; i++)
-			if(voicetable[i].usage==VOICE_USAGE_FREE) 
-			{
-				voicetable[i].usage = usage;
-				last_voice=i+1;
-				found=1;
-				break;
-			}
-		if(!found)
-		for(i = 0; i < last_voice; i++)
-			if(voicetable[i].usage==VOICE_USAGE_FREE) 
-			{
-				voicetable[i].usage = usage;
-				last_voice=i+1;
-				found=1;
-				break;
-			}
+		for(int i=num;i<num+n;i++)
+		{
+			voicetable[i].usage = usage;
+			voicetable[i].voice_class = voice_class;
+		}
+		kx_voice_mark(hw,num,n,0);
+		hw->voice_used[voice_class]+=n;
+		last_voice=num+n;
 	}
 
 	if(last_voice>=KX_NUMBER_OF_VOICES)
@@ -525,7 +612,7 @@ AGAIN:
 	kx_lock_release(hw,&hw->k_lock, &int_flags);
 
 
-	if(!found) // not found 'free' ones
+	if(num<0) // not found 'free' ones
 	{
 		if(pass<2) // first or second time
 		{
@@ -536,12 +623,15 @@ AGAIN:
                     }
                 }
                 debug(DLIB,"kx_alloc_voice: not found\n");
+
+		kx_lock_acquire(hw,&hw->k_lock, &int_flags);
+		hw->voice_alloc_failures++;
+		hw->voice_alloc_ticks+=(dword)(kx_voice_ticks()-start_ticks);
+		kx_lock_release(hw,&hw->k_lock, &int_flags);
 		return -1;
 	}
 
-	int num=i;
-
-	for(i = 0; i < (usage & VOICE_FLAGS_STEREO ? 2 : 1); i++) 
+	for(int i = 0; i < n; i++) 
 	{
 		kx_writeptr_multiple(hw, num + i, 	IFATN, 0xffff,
 							DCYSUSV, 0x00, // envelope is off
@@ -559,6 +649,15 @@ AGAIN:
 
         debug(DSTATE,"voice allocated (%d)\n",num);
 
+	dword ticks=(dword)(kx_voice_ticks()-start_ticks);
+
+	kx_lock_acquire(hw,&hw->k_lock, &int_flags);
+	hw->voice_allocs++;
+	hw->voice_alloc_ticks+=ticks;
+	if(ticks>hw->voice_alloc_ticks_max)
+	 hw->voice_alloc_ticks_max=ticks;
+	kx_lock_release(hw,&hw->k_lock, &int_flags);
+
 	return num;
 }
 
@@ -594,10 +693,14 @@ void kx_voice_free(kx_hw *hw,int voice_num)
 
 	kx_lock_acquire(hw,&hw->k_lock, &flags);
 
-	if(hw->voicetable[voice_num].usage & VOICE_FLAGS_STEREO)
+	int n=(hw->voicetable[voice_num].usage & VOICE_FLAGS_STEREO ? 2 : 1);
+	if(n==2)
 		 hw->voicetable[voice_num+1].usage = VOICE_USAGE_FREE;
 	hw->voicetable[voice_num].usage = VOICE_USAGE_FREE;
 
+	kx_voice_mark(hw,voice_num,n,1);
+	hw->voice_used[hw->voicetable[voice_num].voice_class]-=n;
+
 	kx_lock_release(hw,&hw->k_lock, &flags);
 
         debug(DSTATE,"voice freed (%d)\n",voice_num);
@@ -605,6 +708,107 @@ void kx_voice_free(kx_hw *hw,int voice_num)
 	return;
 }
 
+// voice models
+// ------------
+
+// WC_SAMPLECOUNTER wraps every 2^20 sample periods; it is extended here to 32 bits
+// assumes it is called at least once per wrap (see system_timer_func())
+dword kx_voice_clock(kx_hw *hw)
+{
+ dword wc=kx_readfn0(hw,WC_SAMPLECOUNTER);
+
+ unsigned long flags=0;
+ kx_lock_acquire(hw,&hw->k_lock, &flags);
+
+ dword delta=(wc-hw->voice_clock_wc)&(WC_SAMPLECOUNTER_MASK>>6);
+ if(delta<((WC_SAMPLECOUNTER_MASK>>6)>>1)) // otherwise: raced with a more recent reader
+ {
+  hw->voice_clock+=delta;
+  hw->voice_clock_wc=wc;
+ }
+ dword now=hw->voice_clock;
+
+ kx_lock_release(hw,&hw->k_lock, &flags);
+
+ return now;
+}
+
+// envelope attenuation, cB; >=1000: silent
+static int kx_voice_model_attn(kx_voice_model *m,dword now)
+{
+ int attn;
+ dword t=now-m->on_time;
+
+ if(m->released)
+ {
+  dword r=now-m->off_time;
+  if(r>=m->release)
+   return 1000;
+  attn=m->off_attn+(int)((__int64)1000*r/m->release);
+ }
+ else if(t<m->attack)
+  attn=0;
+ else if(t-m->attack<m->decay)
+  attn=(int)((__int64)m->sustain*(t-m->attack)/m->decay);
+ else
+  attn=m->sustain;
+
+ return attn>1000?1000:attn;
+}
+
+// 65536*10^(-n/20), n: 0..19 dB
+static const dword db_to_lin[20]=
+{
+ 65536,58409,52057,46396,41350,36854,32846,29274,26090,23253,
+ 20724,18471,16462,14672,13076,11654,10387,9257,8250,7353
+};
+
+// estimated CVCF_CURRENTVOL of a synth voice; *finished: stopped on loop or past the end of the sample
+static dword kx_voice_model_vol(kx_hw *hw,int num,dword now,int *releasing,int *finished)
+{
+ kx_voice_model *m=&hw->voicetable[num].model;
+
+ *releasing=m->released;
+ *finished=(m->end && (now-m->on_time)>=m->end);
+
+ int attn=kx_voice_model_attn(m,now);
+ if(attn>=1000)
+ {
+  if(m->released)
+   *finished=1;
+  return 0;
+ }
+
+ dword vol=hw->voicetable[num].param.volume_target>>16;
+ vol=(vol*db_to_lin[(attn/10)%20])>>16;
+ for(attn-=200;attn>=0;attn-=200)
+  vol/=10;
+ return vol;
+}
+
+// synth.cpp fills in the model at note-on; this records note-off
+void kx_voice_model_release(kx_hw *hw,int num)
+{
+ dword now=kx_voice_clock(hw);
+
+ for(int i=0;i<(hw->voicetable[num].usage&VOICE_FLAGS_STEREO?2:1);i++)
+ {
+  kx_voice *v=&hw->voicetable[num+i];
+  kx_voice_model *m=&v->model;
+
+  if(m->released)
+   continue;
+
+  m->off_attn=kx_voice_model_attn(m,now);
+  m->off_time=now;
+  m->released=1;
+
+  // loop until key released: the rest of the loop and the release part of the sample are played
+  if(v->param.sf2_params[54]==3 && v->param.pitch_target)
+   m->end=(now-m->on_time)+(dword)((__int64)(v->param.end-v->param.startloop)*0x4000/v->param.pitch_target)+1;
+ }
+}
+
 struct note_info
 {
  dword vol;
@@ -612,148 +816,137 @@ struct note_info
  int ignore;
 };
 
+#define STEAL_BURST	8	// voices confirmed by reading the hardware, at most
+#define STEAL_REGS	4	// registers read per voice
+
+static int steal_is_synth(kx_hw *hw,int i)
+{
+ return (voice_usage(hw->voicetable[i].usage)==VOICE_USAGE_MIDI) ||
+        (voice_usage(hw->voicetable[i].usage)==VOICE_USAGE_RELEASING);
+}
+
+// voice can be taken: stopped on loop, past the end of a one-shot sample, or quiet and releasing
+static int steal_hw_done(kx_hw *hw,int i,const dword *r,dword threshold)
+{
+ if(r[0]&CPF_STOP_MASK)
+  return 1;
+ if(hw->voicetable[i].param.sf2_params[54]==0 && // no loops: loop is actually _after_ the sample
+    kx_calc_position(hw,i,r[3]&QKBCA_CURRADDR_MASK)>hw->voicetable[i].param.startloop)
+  return 1;
+ return ((r[1]>>16)<threshold) && (r[2]&DCYSUSV_PHASE1_MASK);
+}
+
+// voices are ranked by their models (no register access); the hardware state is only read
+// for the few voices the models suggest, with a single burst
 KX_API(int,kx_steal_voices(kx_hw *hw,dword usage,int flag))
 {
  int found_voice=-1;
  struct note_info notes[KX_NUMBER_OF_VOICES];
  memset(notes,0,sizeof(notes));
 
- spinlock_t steal_lock;
- kx_spin_lock_init(hw,&steal_lock,"steal");
- unsigned long flags=0;
- kx_lock_acquire(hw,&steal_lock, &flags);
+ int stereo=(usage&VOICE_FLAGS_STEREO)?1:0;
+ int last=hw->last_voice;
+ dword now=kx_voice_clock(hw);
 
- for(int cnt=0;cnt<2;cnt++)
+ // candidates: voices (pairs, if stereo) that look free according to the models
+ // 'cleanup': a single voice that is not useful for a stereo request but can be freed for the future
+ struct { int voice; int cleanup; } cand[STEAL_BURST];
+ int n_cand=0,n_regs=0;
+ dword regs[STEAL_BURST*STEAL_REGS],chns[STEAL_BURST*STEAL_REGS],vals[STEAL_BURST*STEAL_REGS];
+
+ for(int n=0;n<KX_NUMBER_OF_VOICES;n++)
  {
-   int start,end;
+  int i=(last+n)%KX_NUMBER_OF_VOICES;
 
-   if(cnt==0)
-     { start=hw->last_voice; end=KX_NUMBER_OF_VOICES; }
-   else
-     { start=0; end=hw->last_voice; }
+  if(!steal_is_synth(hw,i))
+   continue;
 
-   for(int i=start;i<end;i++)
+  int releasing,finished;
+  dword vol=kx_voice_model_vol(hw,i,now,&releasing,&finished);
+
+  notes[i].size=hw->voicetable[i].buffer.size;
+  notes[i].vol=vol+(releasing?0:0x1000);
+
+  int voices=0,cleanup=0;
+  if(!stereo)
+  {
+   if(finished || (vol<0x200 && releasing))
+    voices=1;
+  }
+  else if(finished || (vol<0x200 && releasing))
+  {
+   voices=1;
+   cleanup=1;
+   if(!(i&1) && (i+1)!=last && steal_is_synth(hw,i+1))
    {
-    if((voice_usage(hw->voicetable[i].usage)==VOICE_USAGE_MIDI) ||
-       (voice_usage(hw->voicetable[i].usage)==VOICE_USAGE_RELEASING))
+    int releasing2,finished2;
+    dword vol2=kx_voice_model_vol(hw,i+1,now,&releasing2,&finished2);
+    if(finished2 || (vol2<0x300 && releasing2))
     {
-        notes[i].size=hw->voicetable[i].buffer.size;
+     voices=2;
+     cleanup=0;
+     notes[i+1].size=hw->voicetable[i+1].buffer.size;
+     notes[i+1].vol=vol2+(releasing2?0:0x1000);
+     n++; // the pair is handled here
+    }
+   }
+  }
 
-        // Check if voice is terminated by 'stop on loop' condition (SOLEL/SOLEH)
-        dword cpf=kx_readptr(hw,CPF,i);
-        if(cpf&CPF_STOP_MASK)
-        {
-         if(usage&VOICE_FLAGS_STEREO) // but we need stereo...
-         {
-           kx_synth_term(hw,i);
-           notes[i].ignore=1;
-           continue;
-           // free the voice, but continue searching..
-         }
-         // else:
-         found_voice=i;
-         break;
-        }
+  if(voices==0 || n_regs+voices*STEAL_REGS>STEAL_BURST*STEAL_REGS)
+   continue;
 
-        // Check if voice is looping silence
-        if(hw->voicetable[i].param.sf2_params[54]==0) // no loops
-        {
-         dword CA = kx_calc_position(hw,i,kx_readptr(hw, QKBCA, i)&QKBCA_CURRADDR_MASK);
-         if(CA > hw->voicetable[i].param.startloop) // loop is actually _after_ the sample
-         {
-          // found
-          if(usage&VOICE_FLAGS_STEREO) // we require stereo
-          {
-   	       if((!(i&1)) && // if not even voice - continue
-   	  	            ((voice_usage(hw->voicetable[i+1].usage)==VOICE_USAGE_MIDI) ||
-                    (voice_usage(hw->voicetable[i+1].usage)==VOICE_USAGE_RELEASING))) 
-           {
-             // check the next voice, too
-             if(hw->voicetable[i+1].param.sf2_params[54]==0) // no loops
-             {
-              CA = kx_calc_position(hw,i+1,kx_readptr(hw, QKBCA, i+1)&QKBCA_CURRADDR_MASK);
-              if(CA > hw->voicetable[i+1].param.startloop) // loop is actually _after_ the sample
-              {
-               found_voice=i;
-               break;
-              }
-             }
-           } // not even... or the next is not good
-           // terminate the voice -- for the future; but continue our search...
-           kx_synth_term(hw,i);
-           notes[i].ignore=1;
-           continue;
-          }
-          else // mono
-          {
-            found_voice = i; // found & ok
-	    break;
-	  }
-         }
-        }
+  cand[n_cand].voice=i;
+  cand[n_cand].cleanup=cleanup;
+  n_cand++;
+  for(int v=i;v<i+voices;v++)
+  {
+   regs[n_regs]=CPF; regs[n_regs+1]=CVCF; regs[n_regs+2]=DCYSUSV; regs[n_regs+3]=QKBCA;
+   chns[n_regs]=chns[n_regs+1]=chns[n_regs+2]=chns[n_regs+3]=v;
+   n_regs+=STEAL_REGS;
+  }
+ }
 
-    	dword curvol;
-    	
-    	curvol=notes[i].vol=kx_readptr(hw, CVCF_CURRENTVOL, i);
-    	dword dcysusv=kx_readptr(hw, DCYSUSV, i);
-        /*
-    	if(dcysusv==0xffff) // a very special case FIXME
-    	{
-    	 kx_synth_release(hw,i);
-    	 notes[i].ignore=1;
-    	 continue;
-    	}
-        */
-        dword releasing=(dcysusv&DCYSUSV_PHASE1_MASK)?1:0;
-
-   	if((curvol<0x200) && releasing)
-   	{
-   	  if(usage&VOICE_FLAGS_STEREO) // we require stereo
-   	  {
-   	  	// check the second voice-pair
-   	  	if((!(i&1)) && // if not even voice - continue
-   	  	   ((voice_usage(hw->voicetable[i+1].usage)==VOICE_USAGE_MIDI) ||
-                    (voice_usage(hw->voicetable[i+1].usage)==VOICE_USAGE_RELEASING))) 
-   	  	{
-    			dword curvol2=notes[i+1].vol=kx_readptr(hw, CVCF_CURRENTVOL, i+1);
-        		dword releasing2=(kx_readptr(hw,DCYSUSV,i+1)&DCYSUSV_PHASE1_MASK)?1:0;
-        		if((curvol2<0x300)&&releasing2)
-        		{
-        		 found_voice=i;
-        		 break;
-        		}
-   	  	}
-   	  	if(curvol<0x100)
-   	  	{
-   	  	 kx_synth_term(hw,i);
-   	  	 notes[i].ignore=1;
-   	  	}
-	  }
-	  else // mono
-	  {
-   		// The volume is less than the threshold and
-   		// the volume envelope is in the decaying state.
-   		found_voice=i;
-   		break;
-   	  }	
-   	}
+ if(n_regs)
+  kx_readptr_gather(hw,regs,chns,vals,n_regs);
 
-/*
-	// bad: else causes 'all sustained' to stay & 'all new' to be replaced on each 'note_on'...
-	if((hw->voicetable[i].usage & VOICE_SYNTH_SUSTAINED)||
-   	   (hw->voicetable[i].usage & VOICE_SYNTH_SOSTENUTO))
-   	  curvol += 0x500;
-*/
-
-	if(!releasing)
-   	 curvol+=0x1000;
-
-   	notes[i].vol=curvol;
-    } // if is midi or releasing
-   } // for i
-   if(found_voice!=-1)
-    break;
- } // cnt
+ // confirm the candidates in scan order
+ const dword *r=vals;
+ for(int c=0;c<n_cand;c++)
+ {
+  int i=cand[c].voice;
+
+  if(cand[c].cleanup)
+  {
+   if(steal_hw_done(hw,i,r,0x100))
+   {
+    kx_synth_term(hw,i);
+    notes[i].ignore=1;
+   }
+   else
+    notes[i].vol=(r[1]>>16)+((r[2]&DCYSUSV_PHASE1_MASK)?0:0x1000);
+   r+=STEAL_REGS;
+   continue;
+  }
+
+  int ok=steal_hw_done(hw,i,r,0x200);
+  if(!ok)
+   notes[i].vol=(r[1]>>16)+((r[2]&DCYSUSV_PHASE1_MASK)?0:0x1000);
+  r+=STEAL_REGS;
+  if(stereo)
+  {
+   if(ok && !steal_hw_done(hw,i+1,r,0x300))
+   {
+    ok=0;
+    notes[i+1].vol=(r[1]>>16)+((r[2]&DCYSUSV_PHASE1_MASK)?0:0x1000);
+   }
+   r+=STEAL_REGS;
+  }
+
+  if(ok && found_voice==-1)
+   found_voice=i;
+  else if(!ok)
+   debug(DSTATE,"steal: voice %d is still playing (model)\n",i);
+ }
 
   if(found_voice!=-1) // it's ok to mute the voice only, not note
   {
@@ -762,16 +955,12 @@ KX_API(int,kx_steal_voices(kx_hw *hw,dword usage,int flag))
   	 kx_synth_term(hw,found_voice+1);
   	hw->last_voice=found_voice;
 
- 	kx_lock_release(hw,&steal_lock, &flags);
   	return 0;
   }
   else
   {
-  	if(flags&KX_STEAL_MAINTENANCE) // don't process maximums in this case...
-  	{
-  	 kx_lock_release(hw,&steal_lock, &flags);
+  	if(flag&KX_STEAL_MAINTENANCE) // don't process maximums in this case...
   	 return -1;
-  	}
 
   	// find maximums
       dword vol=0x7fffffff;
@@ -824,10 +1013,7 @@ KX_API(int,kx_steal_voices(kx_hw *hw,dword usage,int flag))
   	}
 	
         if(found_voice==-1)
-        {
-	     kx_lock_release(hw,&steal_lock, &flags);
          return -1;
-        }
 
         // found_voice: minimum among maximums
         int note=hw->voicetable[found_voice].note;
@@ -904,7 +1090,6 @@ KX_API(int,kx_steal_voices(kx_hw *hw,dword usage,int flag))
 
         hw->last_voice=min_voice;
   }
-  kx_lock_release(hw,&steal_lock, &flags);
 
   return 0;
 }
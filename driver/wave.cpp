@@ -33,7 +33,7 @@ KX_API(int,kx_wave_open(kx_hw *hw,kx_voice_buffer *buffer,int usage,int sampling
   return -1;
  }
 
- int num=kx_voice_alloc(hw,usage);
+ int num=kx_voice_alloc(hw,usage,kx_voice_class(usage,device_));
  if(num==-1)
  {
   debug(DLIB,"wave_open: error allocating voice\n");
@@ -55,6 +55,7 @@ KX_API(int,kx_wave_open(kx_hw *hw,kx_voice_buffer *buffer,int usage,int sampling
 #if defined(__APPLE__) && defined(__MACH__) // MacOSX
  voice->buffer.desc=buffer->desc;
 #endif
+ voice->sf_stream=NULL;
 
  if(kx_alloc_buffer(hw,num))
  {
@@ -403,7 +404,7 @@ KX_API(int,kx_wave_set_parameter(kx_hw *hw,int num, int ch, int param,dword valu
   	 return -7;
   	}
     // 3543 new code:
-  	value=calc_volume(hw,value,(hw->is_10k2?0x8000:0xffff));
+  	value=calc_volume(value,(hw->is_10k2?0x8000:0xffff));
 
   	voice[ch].param.volume_target=value;
   	voice[ch].param.initial_cv=value;
@@ -433,7 +434,7 @@ KX_API(int,kx_wave_set_parameter(kx_hw *hw,int num, int ch, int param,dword valu
   	 return -5;
   	}
 
-  	value=calc_volume(hw,value,0xff); // note: this will be transformed back to logarithms for 10k2
+  	value=calc_volume(value,0xff); // note: this will be transformed back to logarithms for 10k2
 
   	if(ch==0)
   	{
@@ -40,6 +40,15 @@
  #endif
 #endif
 
+#if defined(__GNUC__) && !defined(_MSC_VER)
+ #ifndef __int64
+  #define __int64 long long
+ #endif
+ #ifndef __stdcall
+  #define __stdcall
+ #endif
+#endif
+
 typedef unsigned __int64 uint_64;
 typedef unsigned int   uint_32;
 typedef unsigned short uint_16;
@@ -246,8 +255,8 @@ typedef struct audblk_s
 		uint_16 cplexps[18 * 12 / 3];
 	/* Sanity checking constant */
 	uint_32	magic2;
-	/* fbw channel exponents */
-	uint_16 exps[5][252 / 3];
+	/* fbw channel exponents: the absolute exponent and up to 84 groups (D15, endmant 253) */
+	uint_16 exps[5][1 + 252 / 3];
 	/* channel gain range */
 	uint_16 gainrng[5];
 	/* low frequency exponents */
@@ -389,6 +398,7 @@ typedef struct ac3_state_s
  sint_16 sgain;
  sint_16 dbknee;
  sint_16 floor_;
+ uint_16 ba_valid;		// channels whose bap[] is current (reallocated on changes only)
  sint_16 psd[256];
  sint_16 bndpsd[256];
  sint_16 excite[256];
@@ -400,13 +410,31 @@ typedef struct ac3_state_s
  syncinfo_t syncinfo;
  uint_32 frame_count;
 
+ // bitstream.c: the next bits of the frame, MSB first; bits_left of them are valid
+ uint_64 bit_cache;
  uint_32 bits_left;
- uint_32 current_word;
  uint_16 lfsr_state;
 
  //the floating point samples for one audblk
  stream_samples_t samples;
 
+ // imdct.c: overlap-add delay lines [6][256] and the FFT work area (re[128], im[128]),
+ // aligned to 16 bytes at run time
+ float imdct_mem[6*256+2*128+4];
+ int imdct_sse;
+
+ // output.c: set by ac3_set_output(); the matrix is rebuilt per frame by output_setup()
+ int out_mode, out_format, out_dither;
+ float out_gain;
+ void *output;			// interleaved output (NULL: planar sint_16 in left..subwoofer)
+ int out_channels;		// rows below: interleaved channels, or 6 planar channels
+ int out_nin[6];		// non-zero coefficients per output row
+ uint_8 out_in[6][6];		// samples[] index of each coefficient
+ float out_coef[6][6];		// mix level * gain * format scale
+ uint_32 out_seed[8];		// TPDF dither generator
+ int out_sse2;
+ sint_32 out_rows[6][256];	// output_block(), SSE2 interleaved: the rows (float, or quantized) before packing
+
  #define CHUNK_SIZE 2047
  int stop;
 
@@ -417,12 +445,17 @@ typedef struct ac3_state_s
  uint_8 *frame_start;
  */
  /* ------- */
- uint_8 buffer[BUFFER_SIZE];
+ uint_8 buffer[BUFFER_SIZE];	// the syncframe after its 5 byte header, zero-padded
 
- uint_8 *buffer_start, *buffer_end;
+ uint_8 *buffer_start, *buffer_end;	// the next bytes to load into bit_cache, the end of the frame
  uint_8 *chunk_start, *chunk_end;
  /* ------- */
 
+ // ac3_feed(): syncframe being assembled (the body goes to buffer[])
+ uint_8 feed_header[5];		// sync word, crc1, fscod/frmsizecod
+ uint_32 feed_have;		// bytes of the syncframe collected so far
+ uint_32 feed_size;		// its size in bytes (0: the header is incomplete)
+
  //These store the persistent state of the packed mantissas
  uint_16 m_1[3];
  uint_16 m_2[3];
@@ -441,28 +474,41 @@ typedef struct ac3_state_s
 }ac3_state;
 
 
-#ifdef WORDS_BIGENDIAN
-	#define swab32(x) (x)
+// 8 bytes of the bitstream, the first one in the most significant bits
+#if defined(WORDS_BIGENDIAN)
+	#define bitstream_load64(p) (*(const uint_64 *)(p))
+#elif defined(_MSC_VER)
+	#include <stdlib.h>
+	#define bitstream_load64(p) _byteswap_uint64(*(const uint_64 *)(p))
 #else
-	#define swab32(x)\
-	((((uint_8*)&x)[0] << 24) | (((uint_8*)&x)[1] << 16) |  \
-	 (((uint_8*)&x)[2] << 8)  | (((uint_8*)&x)[3]))
+static inline uint_64 bitstream_load64(const uint_8 *p)
+{
+	uint_64 x;
+	__builtin_memcpy(&x,p,8);
+	return __builtin_bswap64(x);
+}
 #endif
 
+// the reader loads 8 bytes at a time: the frame buffer has this many zeroes past the frame
+#define BITSTREAM_PADDING 8
+
 void bitstream_init(ac3_state *state);
 
 uint_8 bitstream_get_byte(ac3_state *state);
+void bitstream_get_bytes(uint_8 *dest,uint_32 size,ac3_state *state);
 
-uint_8 *bitstream_get_buffer_start(ac3_state *state);
-void bitstream_buffer_frame(uint_32 frame_size,ac3_state *state);
+void bitstream_set_frame(uint_32 size,ac3_state *state);
 
-uint_32 bitstream_get_bh(uint_32 num_bits,ac3_state *state);
+void imdct(ac3_state *state,bsi_t *bsi,audblk_t *audblk,stream_samples_t samples);
+void imdct_init(ac3_state *state);
 
-void imdct(bsi_t *bsi,audblk_t *audblk, stream_samples_t samples);
-void imdct_init(void);
+void output_setup(ac3_state *state);
+void output_block(ac3_state *state,int block);
 
 void parse_syncinfo(syncinfo_t *syncinfo,int *error_flag,ac3_state *state);
-void parse_audblk(bsi_t *bsi,audblk_t *audblk,ac3_state *state);
+int parse_syncinfo_header(syncinfo_t *syncinfo,uint_32 tmp,ac3_state *state);
+int parse_syncinfo_crc(syncinfo_t *syncinfo,uint_32 tmp,ac3_state *state);
+void parse_audblk(bsi_t *bsi,audblk_t *audblk,uint_32 block,int *error_flag,ac3_state *state);
 void parse_bsi(bsi_t *bsi,ac3_state *state);
 void parse_auxdata(syncinfo_t *syncinfo,ac3_state *state);
 
@@ -472,7 +518,6 @@ void exponent_unpack( bsi_t *bsi, audblk_t *audblk,int *error_flag,ac3_state *st
 
 int crc_validate(ac3_state *state);
 void crc_init(ac3_state *state);
-void crc_process_byte(uint_8 data,ac3_state *state);
 void crc_process_frame(uint_8 *data,uint_32 num_bytes,ac3_state *state);
 
 void sanity_check_init(syncinfo_t *syncinfo, bsi_t *bsi, audblk_t *audblk);
@@ -489,17 +534,34 @@ void bit_allocate(uint_16 fscod, bsi_t *bsi, audblk_t *audblk,ac3_state *state);
 
 extern const uint_16 dither_lut[256]; 
 
+// tops bit_cache up to 56..63 valid bits; past the end of the frame the bits are zeroes
+static inline void bitstream_refill(ac3_state *state)
+{
+	if(state->buffer_start < state->buffer_end)
+		state->bit_cache |= bitstream_load64(state->buffer_start) >> state->bits_left;
+	state->buffer_start += (63 - state->bits_left) >> 3;
+	state->bits_left |= 56;
+}
+
+// num_bits: 1..32
 static inline uint_32 bitstream_get(uint_32 num_bits,ac3_state *state)
 {
 	uint_32 result;
-	
-	if(num_bits < state->bits_left)
-	{
-		result = (state->current_word << (32 - state->bits_left)) >> (32 - num_bits);
-		state->bits_left -= num_bits;
-		return result;
-	}
-	return bitstream_get_bh(num_bits,state);
+
+	if(num_bits > state->bits_left)
+		bitstream_refill(state);
+
+	result = (uint_32)(state->bit_cache >> (64 - num_bits));
+	state->bit_cache <<= num_bits;
+	state->bits_left -= num_bits;
+
+	return result;
+}
+
+// bits read from the syncframe so far, including its 5 byte header
+static inline uint_32 bitstream_get_total_bits(ac3_state *state)
+{
+	return (uint_32)(5 + (state->buffer_start - state->buffer)) * 8 - state->bits_left;
 }
 
 
@@ -535,6 +597,31 @@ int AC3_CALLTYPE __stdcall ac3_decode_frame(ac3_state *state);
  // 0 - success
  // !=0 - bad frame / error (output data is invalid and should be zeroed)
 
+// push-style decoding: no fill_buffer callback, the caller passes the input as it arrives
+// each ac3_state is an independent stream (no global state): streams can be decoded in parallel
+int AC3_CALLTYPE __stdcall ac3_feed(ac3_state *state,const uint_8 *data,int size,int *consumed);
+ // decodes at most one syncframe and stops after it (*consumed: input bytes used)
+ // >0 - a frame was decoded (its size in bytes), 1536 samples per channel are in left..subwoofer
+ // 0 - the input was consumed, more data is needed
+ // <0 - bad frame (output data is invalid and should be zeroed)
+
+// output stage (per stream; ac3_init() selects planar sint_16 5.1 in left..subwoofer)
+#define AC3_OUTPUT_51		0	// L R C LFE SL SR
+#define AC3_OUTPUT_QUAD		1	// L R SL SR
+#define AC3_OUTPUT_STEREO	2	// Lo/Ro downmix
+#define AC3_OUTPUT_DOLBY	3	// Lt/Rt (Pro Logic compatible) downmix
+#define AC3_OUTPUT_MONO		4
+
+#define AC3_FORMAT_S16		0	// sint_16
+#define AC3_FORMAT_S24_32	1	// 24 bits, left-justified in sint_32 (p16v)
+#define AC3_FORMAT_F32		2	// float, +-1.0 full scale, not clipped
+
+void AC3_CALLTYPE __stdcall ac3_set_output(ac3_state *state,int mode,int format,float gain,int dither,void *output);
+ // output: 1536 interleaved frames of ac3_output_channels(mode) channels per syncframe
+ // output==NULL: planar sint_16 in left..subwoofer, downmixed channels only (the others are zeroed)
+ // dither: TPDF, +-1 LSB (integer formats)
+int AC3_CALLTYPE __stdcall ac3_output_channels(int mode);
+
 #ifdef __cplusplus
  };
 #endif
@@ -0,0 +1,240 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// dspalloc.h
+// -----
+// DSP resource allocator (see dsp.cpp: allocate_microcode(), allocate_register(), allocate_tram())
+// -----
+// instruction memory, GPRs and TRAM data registers are kept in the kx_hw usage bitmaps;
+// free blocks are found a word at a time (count-trailing-zeros), never bit by bit
+// iTRAM / xTRAM delay lines are extents [start, start+size] taken from the translated
+// microcode list; a new extent is placed into the best-fitting gap between them
+// the code is OS-independent so that it can be benchmarked on the host
+// requires interface/ikx.h (kx_dsp_pool_info)
+
+#ifndef KX_DSPALLOC_H_
+#define KX_DSPALLOC_H_
+
+// _BitScanForward() is declared by wdm.h / winnt.h; host tools may not include them
+#if defined(_MSC_VER) && !defined(BitScanForward)
+ #include <intrin.h>
+ #pragma intrinsic(_BitScanForward)
+#endif
+
+// v should not be zero
+static inline int kx_ctz(dword v)
+{
+#if defined(_MSC_VER)
+ unsigned long i;
+ _BitScanForward(&i,v);
+ return (int)i;
+#else
+ return __builtin_ctz(v);
+#endif
+}
+
+// first bit in [pos,to) that is set ('value'!=0) or clear ('value'==0); returns 'to' if none
+static inline int kx_bitmap_scan(const dword *map,int pos,int to,int value)
+{
+ while(pos<to)
+ {
+  dword w=map[pos>>5];
+  if(!value)
+   w=~w;
+  w&=(0xffffffffU<<(pos&31));
+  if(w)
+  {
+   pos=(pos&~31)+kx_ctz(w);
+   return pos<to?pos:to;
+  }
+  pos=(pos|31)+1;
+ }
+ return to;
+}
+
+// placement modes for kx_bitmap_alloc()
+#define KX_ALLOC_BEST           0   // smallest free block that fits; lowest address in it
+#define KX_ALLOC_BEST_TOP       1   // smallest free block that fits; highest address in it
+#define KX_ALLOC_FIRST          2   // lowest address
+
+// allocates 'size' consecutive bits in [from,to); returns the first bit or -1
+static inline int kx_bitmap_alloc(dword *map,int from,int to,int size,int mode)
+{
+ int best=-1,best_len=0;
+ int pos=from;
+
+ if(size<=0)
+  return -1;
+
+ while(pos<to)
+ {
+  int start=kx_bitmap_scan(map,pos,to,0);
+  if(start>=to)
+   break;
+  int end=kx_bitmap_scan(map,start,to,1);
+  int len=end-start;
+
+  if(len>=size)
+  {
+   if(mode==KX_ALLOC_FIRST)
+   {
+    best=start;
+    best_len=len;
+    break;
+   }
+   // ties: the block closest to 'to' for _TOP (that is, to the microcode we are placed before)
+   if(best==-1 || len<best_len || (mode==KX_ALLOC_BEST_TOP && len==best_len))
+   {
+    best=start;
+    best_len=len;
+    if(len==size && mode!=KX_ALLOC_BEST_TOP)
+     break; // exact fit
+   }
+  }
+  pos=end;
+ }
+
+ if(best==-1)
+  return -1;
+
+ if(mode==KX_ALLOC_BEST_TOP)
+  best+=best_len-size;
+
+ for(int i=best;i<best+size;i++)
+  map[i>>5]|=(1U<<(i&31));
+
+ return best;
+}
+
+// single bit: first free one
+static inline int kx_bitmap_alloc_bit(dword *map,int from,int to)
+{
+ int bit=kx_bitmap_scan(map,from,to,0);
+ if(bit>=to)
+  return -1;
+ map[bit>>5]|=(1U<<(bit&31));
+ return bit;
+}
+
+static inline void kx_bitmap_stats(const dword *map,int from,int to,kx_dsp_pool_info *st)
+{
+ memset(st,0,sizeof(kx_dsp_pool_info));
+ st->size=to-from;
+
+ int pos=from;
+ while(pos<to)
+ {
+  int start=kx_bitmap_scan(map,pos,to,0);
+  if(start>=to)
+   break;
+  int end=kx_bitmap_scan(map,start,to,1);
+  dword len=end-start;
+  st->free+=len;
+  st->free_blocks++;
+  if(len>st->largest_free)
+   st->largest_free=len;
+  pos=end;
+ }
+ if(st->free)
+  st->fragmentation=100-(dword)(((__int64)st->largest_free*100)/st->free);
+}
+
+// TRAM extents
+typedef struct
+{
+ dword start;
+ dword size;
+}kx_extent;
+
+// keeps 'e' sorted by start; 'n' is the number of entries already there
+static inline int kx_extent_insert(kx_extent *e,int n,dword start,dword size)
+{
+ int i=n;
+ while(i>0 && e[i-1].start>start)
+ {
+  e[i]=e[i-1];
+  i--;
+ }
+ e[i].start=start;
+ e[i].size=size;
+ return n+1;
+}
+
+// an extent occupies [start, start+size] (one guard sample: delay lines may address 'start+size')
+// new extents start at multiples of 'align'; the whole extent should fit below 'limit'
+// returns 0 and the best-fitting start in *ret, or -1
+static inline int kx_extent_alloc(const kx_extent *e,int n,dword limit,dword size,dword align,dword *ret)
+{
+ dword best=0,best_gap=0;
+ int found=0;
+ dword prev=0;
+
+ for(int i=0;i<=n;i++)
+ {
+  dword gap_end=(i<n)?e[i].start:limit;
+  dword start=(prev+align-1)/align*align;
+
+  if(gap_end>start && gap_end-start>size) // [start, start+size] fits in [prev, gap_end)
+  {
+   dword gap=gap_end-prev;
+   if(!found || gap<best_gap)
+   {
+    best=start;
+    best_gap=gap;
+    found=1;
+   }
+  }
+  if(i<n && e[i].start+e[i].size+1>prev)
+   prev=e[i].start+e[i].size+1;
+ }
+
+ if(!found)
+  return -1;
+ *ret=best;
+ return 0;
+}
+
+// free space is reported as the largest request that fits (guard sample and alignment excluded)
+static inline void kx_extent_stats(const kx_extent *e,int n,dword limit,dword align,kx_dsp_pool_info *st)
+{
+ memset(st,0,sizeof(kx_dsp_pool_info));
+ st->size=limit;
+
+ dword prev=0;
+ for(int i=0;i<=n;i++)
+ {
+  dword gap_end=(i<n)?e[i].start:limit;
+  dword start=(prev+align-1)/align*align;
+  if(gap_end>start+1)
+  {
+   dword len=gap_end-start-1;
+   st->free+=len;
+   st->free_blocks++;
+   if(len>st->largest_free)
+    st->largest_free=len;
+  }
+  if(i<n && e[i].start+e[i].size+1>prev)
+   prev=e[i].start+e[i].size+1;
+ }
+ if(st->free)
+  st->fragmentation=100-(dword)(((__int64)st->largest_free*100)/st->free);
+}
+
+#endif
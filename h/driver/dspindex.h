@@ -0,0 +1,257 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// dspindex.h
+// -----
+// per-microcode register lookup index (see dsp.cpp: find_dsp_register_in_m())
+// and pre-resolved operand table (see dsp.cpp: upload_instruction())
+// -----
+// the index is a single memory block: header + open-addressing name hash +
+// direct num->entry tables + operand table; it is built once per code[]/info[]
+// and never modified
+// the code is OS-independent so that it can be benchmarked on the host
+
+#ifndef KX_DSPINDEX_H_
+#define KX_DSPINDEX_H_
+
+// register numbers are grouped by num>>14 (inputs: 0x4000+, others: 0x8000+)
+#define KX_INDEX_NUM_GROUPS     4
+
+typedef struct kx_register_index_t
+{
+ dsp_register_info *info;   // info[] the index was built for
+ dword n;                   // number of entries in info[]
+
+ dword hash_mask;           // name hash: size-1 (size is a power of two)
+ word *name_hash;           // info[] index+1; 0: empty slot
+
+ word num_base[KX_INDEX_NUM_GROUPS];
+ word num_span[KX_INDEX_NUM_GROUPS];
+ word *num_table[KX_INDEX_NUM_GROUPS];  // info[] index+1; NULL: sparse group, use linear search
+
+ // operand table: r/a/x/y of every instruction resolved to info[] indices
+ dsp_code *code;            // code[] the table was built for
+ dword n_code;
+ word *operands;            // 4 per instruction
+  #define KX_OPERAND_LITERAL    0xffff  // not a register: physical / logical value as is
+  #define KX_OPERAND_INVALID    0xfffe  // register not found in info[]
+ byte *op_flags;            // per instruction
+  #define KX_OPERAND_R_OUTPUT   0x1     // 'r' is a GPR_OUTPUT (affected by mute / bypass)
+  #define KX_OPERAND_HAS_OUTPUT 0x2     // any operand is a GPR_OUTPUT (re-uploaded on enable / bypass)
+ word *bypass_input;        // per info[] entry: input used when the output is bypassed; KX_OPERAND_INVALID: none
+}kx_register_index;
+
+static inline dword kx_register_name_hash(const char *name)
+{
+ // FNV-1a over at most MAX_GPR_NAME characters (names are compared with strncmp())
+ dword h=2166136261U;
+ for(int i=0;i<MAX_GPR_NAME && name[i];i++)
+ {
+  h^=(byte)name[i];
+  h*=16777619U;
+ }
+ return h;
+}
+
+static inline dword kx_register_index_hash_size(dword n)
+{
+ dword size=8;
+ while(size<n*2)
+  size<<=1;
+ return size;
+}
+
+// calculates the span of every num group; returns the size of the index block in bytes
+static inline dword kx_register_index_size(const dsp_register_info *info,dword n,dword n_code,word *base,word *span)
+{
+ dword g,i;
+ dword lo[KX_INDEX_NUM_GROUPS],hi[KX_INDEX_NUM_GROUPS],cnt[KX_INDEX_NUM_GROUPS];
+
+ for(g=0;g<KX_INDEX_NUM_GROUPS;g++)
+ {
+  lo[g]=0xffff; hi[g]=0; cnt[g]=0;
+ }
+ for(i=0;i<n;i++)
+ {
+  g=info[i].num>>14;
+  if(info[i].num<lo[g]) lo[g]=info[i].num;
+  if(info[i].num>hi[g]) hi[g]=info[i].num;
+  cnt[g]++;
+ }
+
+ dword size=sizeof(kx_register_index)+kx_register_index_hash_size(n)*sizeof(word);
+ size+=n_code*4*sizeof(word)+n*sizeof(word)+n_code;
+ for(g=0;g<KX_INDEX_NUM_GROUPS;g++)
+ {
+  base[g]=0;
+  span[g]=0;
+  // da_*.cpp numbering is dense; do not waste memory on hand-made sparse numbering
+  if(cnt[g] && (hi[g]-lo[g]+1)<=cnt[g]*2+16)
+  {
+   base[g]=(word)lo[g];
+   span[g]=(word)(hi[g]-lo[g]+1);
+   size+=span[g]*sizeof(word);
+  }
+ }
+ return size;
+}
+
+static inline void kx_register_index_resolve(kx_register_index *idx,dword i);
+
+// 'idx' should point to kx_register_index_size() bytes
+static inline void kx_register_index_build(kx_register_index *idx,dsp_register_info *info,dword n,dsp_code *code,dword n_code)
+{
+ dword i,g;
+ word base[KX_INDEX_NUM_GROUPS],span[KX_INDEX_NUM_GROUPS];
+ dword size=kx_register_index_size(info,n,n_code,base,span);
+
+ memset(idx,0,size);
+ idx->info=info;
+ idx->n=n;
+ idx->hash_mask=kx_register_index_hash_size(n)-1;
+ idx->name_hash=(word *)(idx+1);
+
+ word *p=idx->name_hash+idx->hash_mask+1;
+ for(g=0;g<KX_INDEX_NUM_GROUPS;g++)
+ {
+  idx->num_base[g]=base[g];
+  idx->num_span[g]=span[g];
+  if(span[g])
+  {
+   idx->num_table[g]=p;
+   p+=span[g];
+  }
+ }
+ idx->code=code;
+ idx->n_code=n_code;
+ idx->operands=p;
+ p+=n_code*4;
+ idx->bypass_input=p;
+ p+=n;
+ idx->op_flags=(byte *)p;
+
+ // insert in info[] order and keep the first entry for duplicates: same result as a linear search
+ for(i=0;i<n;i++)
+ {
+  g=info[i].num>>14;
+  if(idx->num_table[g])
+  {
+   word *e=&idx->num_table[g][info[i].num-base[g]];
+   if(*e==0)
+    *e=(word)(i+1);
+  }
+
+  dword h=kx_register_name_hash(info[i].name)&idx->hash_mask;
+  while(1)
+  {
+   word e=idx->name_hash[h];
+   if(e==0)
+   {
+    idx->name_hash[h]=(word)(i+1);
+    break;
+   }
+   if(strncmp(info[e-1].name,info[i].name,MAX_GPR_NAME)==0)
+    break;
+   h=(h+1)&idx->hash_mask;
+  }
+ }
+
+ // bypass: the k-th output is fed from the k-th input (modulo the number of inputs)
+ dword n_ins=0,n_outs=0;
+ for(i=0;i<n;i++)
+ {
+  idx->bypass_input[i]=KX_OPERAND_INVALID;
+  if((info[i].type&GPR_MASK)==GPR_INPUT)
+   n_ins++;
+ }
+ for(i=0;i<n && n_ins;i++)
+ {
+  if((info[i].type&GPR_MASK)!=GPR_OUTPUT)
+   continue;
+  dword k=n_outs++%n_ins;
+  for(dword j=0;j<n;j++)
+  {
+   if((info[j].type&GPR_MASK)==GPR_INPUT)
+   {
+    if(k==0)
+    {
+     idx->bypass_input[i]=(word)j;
+     break;
+    }
+    k--;
+   }
+  }
+ }
+
+ for(i=0;i<n_code;i++)
+  kx_register_index_resolve(idx,i);
+}
+
+static inline dsp_register_info *kx_register_index_find(const kx_register_index *idx,word id)
+{
+ dword g=id>>14;
+ if(idx->num_table[g])
+ {
+  dword o=(dword)(id-idx->num_base[g]);
+  if(o<idx->num_span[g] && idx->num_table[g][o])
+   return &idx->info[idx->num_table[g][o]-1];
+  return NULL;
+ }
+ for(dword i=0;i<idx->n;i++)
+  if(idx->info[i].num==id)
+   return &idx->info[i];
+ return NULL;
+}
+
+static inline dsp_register_info *kx_register_index_find(const kx_register_index *idx,const char *name)
+{
+ dword h=kx_register_name_hash(name)&idx->hash_mask;
+ while(1)
+ {
+  word e=idx->name_hash[h];
+  if(e==0)
+   return NULL;
+  if(strncmp(name,idx->info[e-1].name,MAX_GPR_NAME)==0)
+   return &idx->info[e-1];
+  h=(h+1)&idx->hash_mask;
+ }
+}
+
+// (re-)resolves the operands of code[i]; should be called whenever code[i] is modified in place
+static inline void kx_register_index_resolve(kx_register_index *idx,dword i)
+{
+ word ops[4]={ idx->code[i].r, idx->code[i].a, idx->code[i].x, idx->code[i].y };
+ byte fl=0;
+ for(int o=0;o<4;o++)
+ {
+  word e=KX_OPERAND_LITERAL;
+  if(ops[o]&0xd000) // is_register()
+  {
+   dsp_register_info *r=kx_register_index_find(idx,ops[o]);
+   e=r?(word)(r-idx->info):KX_OPERAND_INVALID;
+   if(r && (r->type&GPR_MASK)==GPR_OUTPUT)
+    fl|=(o==0)?(KX_OPERAND_R_OUTPUT|KX_OPERAND_HAS_OUTPUT):KX_OPERAND_HAS_OUTPUT;
+  }
+  idx->operands[i*4+o]=e;
+ }
+ idx->op_flags[i]=fl;
+}
+
+#endif
@@ -0,0 +1,87 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// fixmath.h
+// -----
+// fixed-point exp2 / log2 for the synth and volume conversions (synth.cpp, calc.cpp)
+// -----
+// table lookup with linear interpolation, integer only: can be used at DISPATCH_LEVEL
+// without saving the FPU state
+// the tables (fixtbl.h) are generated by 'kxbench synthcalc -tables'; the same benchmark
+// compares the results against the double precision versions
+
+#ifndef KX_FIXMATH_H_
+#define KX_FIXMATH_H_
+
+#include "driver/fixtbl.h"
+
+// trunc(mul * 2^(x/65536)), saturated to 0xffffffff
+static inline dword kx_fixed_pow2(int x,dword mul)
+{
+ int ip=x>>16;			// floor
+ dword frac=(dword)x&0xffff;
+ dword idx=frac>>(16-KX_FIXED_TABLE_BITS);
+ dword w=frac&((1<<(16-KX_FIXED_TABLE_BITS))-1);
+
+ // 2^(frac/65536), 2.30
+ dword f=kx_exp2_table[idx]+(((kx_exp2_table[idx+1]-kx_exp2_table[idx])*w)>>(16-KX_FIXED_TABLE_BITS));
+
+ unsigned __int64 r=(unsigned __int64)mul*f;
+ if(ip<=30)
+ {
+  if(ip<=-34) // mul*f < 2^64
+   return 0;
+  return (dword)(r>>(30-ip));
+ }
+ if(ip>=62 || (r>>(62-ip)))
+  return 0xffffffff;
+ return (dword)(r<<(ip-30));
+}
+
+// log2(v)*65536; v>0
+static inline int kx_fixed_log2(dword v)
+{
+ int msb=31;
+ while(!(v&0x80000000))
+ {
+  v<<=1;
+  msb--;
+ }
+ dword idx=(v>>(31-KX_FIXED_TABLE_BITS))&((1<<KX_FIXED_TABLE_BITS)-1);
+ dword w=(v>>(31-2*KX_FIXED_TABLE_BITS))&((1<<KX_FIXED_TABLE_BITS)-1);
+
+ return (msb<<16)+(int)(kx_log2_table[idx]+(((kx_log2_table[idx+1]-kx_log2_table[idx])*w)>>KX_FIXED_TABLE_BITS));
+}
+
+// trunc(mul * 2^(cents/1200))
+static inline dword kx_fixed_cents(int cents,dword mul)
+{
+ // 65536/1200 as 16.16
+ return kx_fixed_pow2((int)(((__int64)cents*3579139+0x8000)>>16),mul);
+}
+
+// trunc(mul * 10^(db/20)); 'db' is 16.16 (KX_VOLUME units)
+static inline dword kx_fixed_db(int db,dword mul)
+{
+ // log2(10)/20 as 0.32
+ return kx_fixed_pow2((int)(((__int64)db*713378626)>>32),mul);
+}
+
+#endif
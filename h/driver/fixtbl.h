@@ -0,0 +1,87 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+// generated by 'kxbench synthcalc -tables': do not edit
+// see driver/fixmath.h
+
+#ifndef KX_FIXTBL_H_
+#define KX_FIXTBL_H_
+
+#define KX_FIXED_TABLE_BITS	8
+
+static const dword kx_exp2_table[257]=
+{
+ 0x40000000, 0x402c6be9, 0x4058f6a8, 0x4085a051, 0x40b268fa, 0x40df50b8, 0x410c57a2, 0x41397dcc,
+ 0x4166c34c, 0x41942839, 0x41c1aca7, 0x41ef50ae, 0x421d1462, 0x424af7da, 0x4278fb2b, 0x42a71e6c,
+ 0x42d561b4, 0x4303c518, 0x433248ae, 0x4360ec8d, 0x438fb0cb, 0x43be957f, 0x43ed9ac0, 0x441cc0a3,
+ 0x444c0740, 0x447b6ead, 0x44aaf702, 0x44daa054, 0x450a6abb, 0x453a564d, 0x456a6323, 0x459a9152,
+ 0x45cae0f2, 0x45fb521a, 0x462be4e2, 0x465c9961, 0x468d6fae, 0x46be67e0, 0x46ef8210, 0x4720be55,
+ 0x47521cc6, 0x47839d7b, 0x47b5408c, 0x47e70611, 0x4818ee22, 0x484af8d6, 0x487d2646, 0x48af768a,
+ 0x48e1e9ba, 0x49147fee, 0x4947393f, 0x497a15c4, 0x49ad1598, 0x49e038d0, 0x4a137f88, 0x4a46e9d6,
+ 0x4a7a77d4, 0x4aae299b, 0x4ae1ff43, 0x4b15f8e6, 0x4b4a169c, 0x4b7e587e, 0x4bb2bea5, 0x4be7492b,
+ 0x4c1bf829, 0x4c50cbb8, 0x4c85c3f1, 0x4cbae0ef, 0x4cf022ca, 0x4d25899c, 0x4d5b157e, 0x4d90c68b,
+ 0x4dc69cdd, 0x4dfc988c, 0x4e32b9b4, 0x4e69006e, 0x4e9f6cd4, 0x4ed5ff00, 0x4f0cb70c, 0x4f439514,
+ 0x4f7a9930, 0x4fb1c37c, 0x4fe91413, 0x50208b0e, 0x50582888, 0x508fec9c, 0x50c7d765, 0x50ffe8fe,
+ 0x51382182, 0x5170810b, 0x51a907b4, 0x51e1b59a, 0x521a8ad7, 0x52538786, 0x528cabc3, 0x52c5f7aa,
+ 0x52ff6b55, 0x533906e0, 0x5372ca68, 0x53acb607, 0x53e6c9da, 0x542105fd, 0x545b6a8b, 0x5495f7a1,
+ 0x54d0ad5a, 0x550b8bd4, 0x55469329, 0x5581c378, 0x55bd1cdb, 0x55f89f70, 0x56344b52, 0x567020a0,
+ 0x56ac1f75, 0x56e847ef, 0x57249a29, 0x57611642, 0x579dbc57, 0x57da8c83, 0x581786e6, 0x5854ab9b,
+ 0x5891fac1, 0x58cf7474, 0x590d18d3, 0x594ae7fb, 0x5988e209, 0x59c7071c, 0x5a055751, 0x5a43d2c6,
+ 0x5a82799a, 0x5ac14bea, 0x5b0049d4, 0x5b3f7377, 0x5b7ec8f2, 0x5bbe4a61, 0x5bfdf7e5, 0x5c3dd19c,
+ 0x5c7dd7a4, 0x5cbe0a1c, 0x5cfe6923, 0x5d3ef4d7, 0x5d7fad59, 0x5dc092c7, 0x5e01a53f, 0x5e42e4e3,
+ 0x5e8451d0, 0x5ec5ec26, 0x5f07b405, 0x5f49a98c, 0x5f8bccdb, 0x5fce1e12, 0x60109d51, 0x60534ab7,
+ 0x60962665, 0x60d9307b, 0x611c6919, 0x615fd05e, 0x61a3666d, 0x61e72b65, 0x622b1f66, 0x626f4292,
+ 0x62b39509, 0x62f816eb, 0x633cc85b, 0x6381a978, 0x63c6ba64, 0x640bfb41, 0x64516c2e, 0x64970d4f,
+ 0x64dcdec3, 0x6522e0ad, 0x6569132f, 0x65af766a, 0x65f60a7f, 0x663ccf92, 0x6683c5c3, 0x66caed35,
+ 0x6712460b, 0x6759d065, 0x67a18c68, 0x67e97a34, 0x683199ed, 0x6879ebb6, 0x68c26fb1, 0x690b2601,
+ 0x69540ec9, 0x699d2a2c, 0x69e6784d, 0x6a2ff94f, 0x6a79ad56, 0x6ac39485, 0x6b0daeff, 0x6b57fce9,
+ 0x6ba27e65, 0x6bed3399, 0x6c381ca6, 0x6c8339b2, 0x6cce8ae1, 0x6d1a1057, 0x6d65ca38, 0x6db1b8a8,
+ 0x6dfddbcc, 0x6e4a33c9, 0x6e96c0c3, 0x6ee382de, 0x6f307a41, 0x6f7da710, 0x6fcb096f, 0x7018a185,
+ 0x70666f76, 0x70b47368, 0x7102ad80, 0x71511de4, 0x719fc4b9, 0x71eea226, 0x723db650, 0x728d015d,
+ 0x72dc8374, 0x732c3cba, 0x737c2d55, 0x73cc556d, 0x741cb528, 0x746d4cac, 0x74be1c20, 0x750f23ab,
+ 0x75606374, 0x75b1dba2, 0x76038c5b, 0x765575c8, 0x76a7980f, 0x76f9f359, 0x774c87cc, 0x779f5590,
+ 0x77f25cce, 0x78459dac, 0x78991854, 0x78ecccec, 0x7940bb9e, 0x7994e492, 0x79e947ef, 0x7a3de5df,
+ 0x7a92be8b, 0x7ae7d21a, 0x7b3d20b6, 0x7b92aa88, 0x7be86fba, 0x7c3e7073, 0x7c94acde, 0x7ceb2523,
+ 0x7d41d96e, 0x7d98c9e6, 0x7deff6b6, 0x7e476009, 0x7e9f0606, 0x7ef6e8da, 0x7f4f08ae, 0x7fa765ad,
+ 0x80000000
+};
+
+static const dword kx_log2_table[257]=
+{
+ 0x00000, 0x00171, 0x002e0, 0x0044e, 0x005ba, 0x00725, 0x0088e, 0x009f7,
+ 0x00b5d, 0x00cc3, 0x00e27, 0x00f8a, 0x010eb, 0x0124b, 0x013aa, 0x01508,
+ 0x01664, 0x017bf, 0x01919, 0x01a71, 0x01bc8, 0x01d1e, 0x01e73, 0x01fc6,
+ 0x02119, 0x0226a, 0x023ba, 0x02508, 0x02656, 0x027a2, 0x028ed, 0x02a37,
+ 0x02b80, 0x02cc8, 0x02e0f, 0x02f54, 0x03098, 0x031dc, 0x0331e, 0x0345f,
+ 0x0359f, 0x036de, 0x0381b, 0x03958, 0x03a94, 0x03bce, 0x03d08, 0x03e41,
+ 0x03f78, 0x040af, 0x041e4, 0x04319, 0x0444c, 0x0457f, 0x046b0, 0x047e1,
+ 0x04910, 0x04a3f, 0x04b6c, 0x04c99, 0x04dc5, 0x04eef, 0x05019, 0x05142,
+ 0x0526a, 0x05391, 0x054b7, 0x055dc, 0x05700, 0x05824, 0x05946, 0x05a68,
+ 0x05b89, 0x05ca8, 0x05dc7, 0x05ee5, 0x06003, 0x0611f, 0x0623a, 0x06355,
+ 0x0646f, 0x06588, 0x066a0, 0x067b7, 0x068ce, 0x069e4, 0x06af8, 0x06c0c,
+ 0x06d20, 0x06e32, 0x06f44, 0x07055, 0x07165, 0x07274, 0x07383, 0x07490,
+ 0x0759d, 0x076aa, 0x077b5, 0x078c0, 0x079ca, 0x07ad3, 0x07bdb, 0x07ce3,
+ 0x07dea, 0x07ef0, 0x07ff6, 0x080fb, 0x081ff, 0x08302, 0x08405, 0x08507,
+ 0x08608, 0x08709, 0x08809, 0x08908, 0x08a06, 0x08b04, 0x08c01, 0x08cfe,
+ 0x08dfa, 0x08ef5, 0x08fef, 0x090e9, 0x091e2, 0x092db, 0x093d2, 0x094ca,
+ 0x095c0, 0x096b6, 0x097ab, 0x098a0, 0x09994, 0x09a87, 0x09b7a, 0x09c6c,
+ 0x09d5e, 0x09e4f, 0x09f3f, 0x0a02e, 0x0a11e, 0x0a20c, 0x0a2fa, 0x0a3e7,
+ 0x0a4d4, 0x0a5c0, 0x0a6ab, 0x0a796, 0x0a881, 0x0a96a, 0x0aa53, 0x0ab3c,
+ 0x0ac24, 0x0ad0c, 0x0adf2, 0x0aed9, 0x0afbe, 0x0b0a4, 0x0b188, 0x0b26c,
+ 0x0b350, 0x0b433, 0x0b515, 0x0b5f7, 0x0b6d9, 0x0b7ba, 0x0b89a, 0x0b97a,
+ 0x0ba59, 0x0bb38, 0x0bc16, 0x0bcf4, 0x0bdd1, 0x0bead, 0x0bf8a, 0x0c065,
+ 0x0c140, 0x0c21b, 0x0c2f5, 0x0c3cf, 0x0c4a8, 0x0c580, 0x0c658, 0x0c730,
+ 0x0c807, 0x0c8de, 0x0c9b4, 0x0ca8a, 0x0cb5f, 0x0cc34, 0x0cd08, 0x0cddc,
+ 0x0ceaf, 0x0cf82, 0x0d054, 0x0d126, 0x0d1f7, 0x0d2c8, 0x0d399, 0x0d469,
+ 0x0d538, 0x0d607, 0x0d6d6, 0x0d7a4, 0x0d872, 0x0d93f, 0x0da0c, 0x0dad9,
+ 0x0dba5, 0x0dc70, 0x0dd3b, 0x0de06, 0x0ded0, 0x0df9a, 0x0e063, 0x0e12c,
+ 0x0e1f5, 0x0e2bd, 0x0e385, 0x0e44c, 0x0e513, 0x0e5d9, 0x0e69f, 0x0e765,
+ 0x0e82a, 0x0e8ef, 0x0e9b3, 0x0ea77, 0x0eb3b, 0x0ebfe, 0x0ecc1, 0x0ed83,
+ 0x0ee45, 0x0ef06, 0x0efc8, 0x0f088, 0x0f149, 0x0f209, 0x0f2c8, 0x0f387,
+ 0x0f446, 0x0f505, 0x0f5c3, 0x0f680, 0x0f73e, 0x0f7fb, 0x0f8b7, 0x0f973,
+ 0x0fa2f, 0x0faea, 0x0fba5, 0x0fc60, 0x0fd1a, 0x0fdd4, 0x0fe8e, 0x0ff47,
+ 0x10000
+};
+
+#endif
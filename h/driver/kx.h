@@ -48,8 +48,10 @@
 
 #include "interface/ikx.h"
 #include "interface/dsp.h"
+#include "driver/dspalloc.h"
 
 #include "driver/math.h"
+#include "driver/fixmath.h"
 
 // debug flags
 #define DERR    1
@@ -151,7 +153,7 @@ struct kx_callbacks
     void (*usleep)(int microseconds);
 
     #define KX_NONPAGED 0
-    // #define KX_PAGED     1      // never used
+    #define KX_PAGED     1      // streamed SoundFont samples (bufmgr.cpp)
     void (*malloc_func)(void *call_with,int len,void **b,int where);
     void (*free_func)(void *call_with,void *buff);
 
@@ -175,6 +177,23 @@ struct kx_callbacks
     int (*lmem_free_func)(void *call_with,void **lm);
     void * (*lmem_get_addr_func)(void *call_with,void **lm,int offset,__int64 *phisical); // physical is optional
 
+    // runs 'func' at PASSIVE_LEVEL (work item); can be called at DISPATCH_LEVEL; returns 0 if queued
+    // NULL: not available (SoundFonts are not streamed, see KX_HW_SF_POOL_SIZE)
+    int (*queue_work)(void *call_with,void (*func)(void *data),void *data);
+
+    // waits until the work items queued with queue_work() have completed; PASSIVE_LEVEL
+    void (*flush_work)(void *call_with);
+
+    // pageable memory for streamed SoundFont samples (bufmgr.cpp), committed as it is written and not
+    // taken from the paged pool (a pagefile-backed section); PASSIVE_LEVEL
+    // NULL: malloc_func(KX_PAGED) is used
+    int (*backing_alloc)(void *call_with,dword len,void **addr,void **handle);
+    void (*backing_free)(void *call_with,void *addr,void *handle);
+
+    // monotonic time, ms (wraps around); can be called at DISPATCH_LEVEL
+    // NULL: not available (DSP transaction timeouts use the sample counter, see dsp.cpp)
+    dword (*time_ms)(void *call_with);
+
     word io_base;
     byte irql;
 
@@ -265,6 +284,9 @@ struct kx_voice_param
  dword tmp_buffer_size;
  dword tmp_buffer_physical;
  void *tmp_buffer_addr;
+ struct kx_sf_stream_t *tmp_stream;	// streamed SoundFont: pages are mapped by kx_sf_stream_map()
+ dword tmp_stream_page;
+ void *tmp_lmem;
 };
 
 struct kx_timer 
@@ -281,6 +303,21 @@ struct kx_timer
 
 #include "interface/soundfont.h"
 
+// host-side model of a synth voice: lets kx_steal_voices() rank voices without reading
+// the hardware; times are in sample periods of kx_voice_clock()
+struct kx_voice_model
+{
+ dword on_time;		// note-on
+ dword off_time;	// note-off; valid if 'released'
+ dword attack;		// delay+attack+hold
+ dword decay;		// decay to the sustain level
+ dword release;		// release from full scale to silence
+ dword end;		// one-shot samples: time from note-on to the end of the sample; 0: looped
+ int sustain;		// sustain level, cB of attenuation
+ int off_attn;		// envelope attenuation at note-off, cB
+ int released;
+};
+
 struct kx_voice
 {
  dword usage;
@@ -306,6 +343,17 @@ struct kx_voice
  void *asio_id;
  dword asio_channel;
  void *asio_mdl,*asio_user_addr,*asio_kernel_addr;
+
+ int voice_class;	// KX_VOICE_CLASS_xxx; valid while allocated
+
+ kx_voice_model model;	// synth voices only
+ dword synth_dirty;	// SYNTH_DIRTY_xxx: note-specific controller changes not written yet (kx_synth_flush())
+
+ // streamed SoundFont samples: 'buffer' maps pages of the stream starting with 'sf_stream_page'
+ struct kx_sf_stream_t *sf_stream;
+ dword sf_stream_page;
+ // SoundFont samples in memory: the lmem block 'buffer' points into (sf_stop_voices())
+ void *sf_lmem;
 };
 
 struct kx_rec_voice
@@ -481,10 +529,29 @@ struct kx_hw
     kx_voice voicetable[KX_NUMBER_OF_VOICES];
     int last_voice;
 
+    // voice allocator (voice.cpp); protected by k_lock
+    dword voice_free[2];		// bit n: voice n is free
+    dword voice_free_pairs[2];		// bit n (even): voices n and n+1 are free
+    #define KX_VOICE_RESERVE	4	// voices MIDI cannot take by default (two stereo streams)
+    int voice_quota[KX_VOICE_CLASSES];
+    int voice_used[KX_VOICE_CLASSES];
+    dword voice_allocs,voice_alloc_failures,voice_alloc_steals;
+    __int64 voice_alloc_ticks;		// total
+    dword voice_alloc_ticks_max;
+
+    // extended WC_SAMPLECOUNTER for the voice models (kx_voice_clock())
+    dword voice_clock;
+    dword voice_clock_wc;
+
     #define KX_NUMBER_OF_REC_VOICES 2
     kx_rec_voice rec_voicetable[KX_NUMBER_OF_REC_VOICES];
 
     int synth_compat;
+    dword synth_allocations;	// memory allocations on the note-on path (KX_HW_SYNTH_ALLOCATIONS)
+    dword synth_changes,synth_updates;	// KX_HW_SYNTH_CHANGES, KX_HW_SYNTH_UPDATES
+    // timestamped MIDI events (kx_midi_schedule()), all synth states; protected by k_lock
+    dword midi_queued,midi_queue_max;	// events waiting; most ever waiting
+    dword midi_events,midi_late,midi_late_max,midi_dropped;
 
     // locks
     spinlock_t k_lock;
@@ -493,6 +560,18 @@ struct kx_hw
     spinlock_t mpu_lock[MAX_MPU_DEVICES];
     spinlock_t dsp_lock;
     spinlock_t sf_lock;
+
+    // SoundFont streaming (bufmgr.cpp): hardware-addressable pool of sample pages; protected by sf_lock
+    dword sf_pool_size;			// KX_HW_SF_POOL_SIZE, bytes; 0: SoundFonts are loaded as a whole
+    void *sf_pool;			// lmem
+    struct kx_sf_slot_t *sf_slots;
+    int sf_pool_slots;
+    int sf_lru_head,sf_lru_tail;	// unpinned slots: most / least recently used; -1: none
+    struct kx_sf_fetch_t *sf_fetch;	// pages to load (ring)
+    int sf_fetch_head,sf_fetch_count;
+    int sf_worker_queued;
+    dword sf_hits,sf_misses,sf_evictions,sf_dropped;
+
     spinlock_t uartout_lock;
     spinlock_t ac97_lock;
     spinlock_t pt_lock;
@@ -502,6 +581,8 @@ struct kx_hw
     struct list timers;
     struct list microcodes;
     struct list sf;
+    struct list sf_index;	// kx_sf_index
+    struct list sf_data;	// kx_sf_data: sample data shared by the SoundFonts
 
     // timers
     dword timer_delay;
@@ -529,6 +610,27 @@ struct kx_hw
     #define FX_MICROCODE_MASSIVE_SIZE (E10K2_MAX_INSTRUCTIONS/32) // as per 10k2
     dword fx_microcode_usage[FX_MICROCODE_MASSIVE_SIZE];
 
+    // microcode lookup (see dsp.cpp): pgm id -> microcode and per-microcode register index
+    dsp_microcode *pgm_map[MAX_PGM_NUMBER];
+    struct kx_register_index_t *pgm_index[MAX_PGM_NUMBER];
+
+    // scratch for the TRAM allocator (see dsp.cpp: allocate_tram()); protected by dsp_lock
+    // (current and, within a transaction, running microcode)
+    #define KX_TRAM_EXTENTS (MAX_PGM_NUMBER*2)
+    kx_extent tram_extents[KX_TRAM_EXTENTS];
+
+    // pending DSP transaction (see dsp.cpp: kx_dsp_begin()); protected by dsp_lock
+    struct kx_dsp_txn_t *dsp_txn;
+
+    // DSP telemetry (see dsp.cpp: kx_telemetry_xxx()); protected by dsp_lock
+    // the page is allocated by the OS layer, which maps it into the clients
+    kx_telemetry_page *telemetry;
+    int telemetry_refs[KX_TELEMETRY_TAPS];  // references of the owner per tap
+    void *telemetry_owner[KX_TELEMETRY_TAPS]; // client that added the tap
+    int telemetry_taps;                     // taps in use
+    spinlock_t telemetry_lock;              // serializes installing / uninstalling telemetry_timer
+    kx_timer telemetry_timer;               // installed while there are taps
+
     // 10k2/10k1
     int opcode_shift;
     int high_operand_shift;
@@ -629,6 +731,47 @@ KX_API(dword,kx_getdword(kx_hw *hw,int what,dword *ret)); // returns 0 on succes
 int kx_alloc_buffer(kx_hw *hw,int num);
 void kx_free_buffer(kx_hw *hw,int num);
 
+// SoundFont streaming (bufmgr.cpp)
+// only the first KX_SF_RESIDENT bytes of each sample stay in memory the hardware can read; the rest
+// is kept in pageable memory and copied into the pool (KX_HW_SF_POOL_SIZE) when a note needs it
+#define KX_SF_RESIDENT		32768	// bytes
+#define KX_SF_FETCH_QUEUE	1024	// pages
+#define KX_SF_PAGE_ABSENT	(-1)	// kx_sf_stream.slot[]
+#define KX_SF_PAGE_QUEUED	(-2)
+typedef struct kx_sf_stream_t
+{
+ dword n_pages;			// pages of sample data
+ byte *backing;			// all the sample data; pageable
+ void *backing_handle;		// kx_callbacks::backing_alloc(); NULL: malloc_func(KX_PAGED)
+ void *resident;		// lmem: the resident pages
+ int *resident_page;		// per page: page in 'resident'; -1: streamed
+ int *slot;			// per page: pool slot; KX_SF_PAGE_xxx
+ int busy;			// copies from / to 'backing' in progress (kx_sf_stream_release())
+ int destroyed;			// kx_sf_stream_destroy() was called while busy: freed by the last copy
+}kx_sf_stream;
+
+typedef struct kx_sf_slot_t
+{
+ kx_sf_stream *stream;		// NULL: free
+ dword page;
+ int pins;			// voices that map the page; the slot is in the LRU list if 0
+ int prev,next;
+}kx_sf_slot;
+
+typedef struct kx_sf_fetch_t
+{
+ kx_sf_stream *stream;		// NULL: cancelled
+ dword page;
+}kx_sf_fetch;
+
+int kx_sf_pool_init(kx_hw *hw,dword size);
+void kx_sf_pool_close(kx_hw *hw);
+int kx_sf_stream_create(kx_hw *hw,kx_sound_font *sf,kx_sf_stream **stream);
+void kx_sf_stream_destroy(kx_hw *hw,kx_sf_stream *stream);
+int kx_sf_stream_release(kx_hw *hw,kx_sf_stream *stream);	// sf_lock held; see bufmgr.cpp
+void kx_sf_stream_free(kx_hw *hw,kx_sf_stream *stream);
+int kx_sf_stream_write(kx_hw *hw,kx_sf_stream *stream,int pos,const void *data,int size);
+
 // UART
 KX_API(int,kx_mpu_write_data(kx_hw *card, byte data,int where));
 KX_API(int,kx_mpu_read_data(kx_hw *card, byte *data,int where));
@@ -663,6 +806,9 @@ KX_API(void, kx_writeptr_prof(kx_hw *hw, dword reg, dword channel, dword data));
 KX_API(void, kx_writeptr(kx_hw *card, dword reg, dword channel, dword data));
 
 KX_API(void, kx_writeptr_multiple(kx_hw *card, dword channel, ...));
+KX_API(void, kx_writeptr_list(kx_hw *card, dword channel, const dword *list, int n)); // n reg/data pairs
+KX_API(void, kx_readptr_list(kx_hw *card, dword channel, const dword *regs, dword *vals, int n));
+KX_API(void, kx_readptr_gather(kx_hw *card, const dword *regs, const dword *channels, dword *vals, int n));
 KX_API(dword, kx_readptr(kx_hw * card, dword reg, dword channel));
 KX_API(void, kx_writeptrb(kx_hw *card, dword reg, dword channel, byte data));
 KX_API(byte, kx_readptrb(kx_hw * card, dword reg, dword channel));
@@ -724,7 +870,7 @@ KX_API(int,kx_wave_setup_b2b(kx_hw *hw,int num,dword new_routing,int high_low,in
 
 KX_API(int,kx_set_fx_amount(kx_hw *hw,int where,int num,int i));
 
-dword calc_volume(kx_hw *hw,dword value,dword max);
+dword calc_volume(dword value,dword max);
 
 // kX MultiChannel device
 // ----------------------
@@ -833,6 +979,7 @@ typedef struct
  int nrpn_sf_data[SF_PARAMETERS];
  int nrpn_awe_data[AWE_PARAMETERS];
 
+ dword dirty;	// SYNTH_DIRTY_xxx: controller changes not written to the voices yet (kx_synth_flush())
 }kx_midi_channel;
 
 typedef struct
@@ -843,6 +990,84 @@ typedef struct
 
 extern sf_parameters_t sf_defaults[SF_PARAMETERS];
 
+// SoundFont sample data (see soundfont.cpp): identical samples of different SoundFonts are stored once
+typedef struct
+{
+ dword hash;
+ int size;			// bytes
+ int offset;			// in kx_sf_data.lmem
+}kx_sf_block;
+
+typedef struct
+{
+ struct list list;		// hw->sf_data
+ void *lmem;
+ int size;			// bytes
+ int refs;			// SoundFonts that use the data
+ int n_blocks;
+ kx_sf_block *blocks;		// sample data regions stored in 'lmem', sorted by hash
+}kx_sf_data;
+
+// SoundFont zone index (see soundfont.cpp)
+// built by kx_load_soundfont(); used by sf_find_voice() instead of the generator lists
+typedef struct
+{
+ short key_lo,key_hi;           // preset and instrument ranges merged; key_lo>key_hi: never matches
+ short vel_lo,vel_hi;
+ #define SF_ZONE_CHAINED	0x1	// follows another sample of the same instrument zone
+ #define SF_ZONE_FORCE_KEY	0x2
+ int flags;
+ int force_key;
+ int ori_key;
+ int start_addr,end_addr,start_loop,end_loop;	// absolute, in samples; loops are final
+ kx_sf_data *data;		// the addresses are relative to data->lmem; NULL: to sf->sample_data
+ sfSample *sample;
+ int sf2_params[SF_PARAMETERS];	// final values, incl. loop mode [54], force_velocity [47]
+}kx_sf_zone;
+
+typedef struct
+{
+ word bank,preset;		// as in sfPresetHeader; drum kits are bank 128
+ #define SF_PRESET_BAD		0x1	// incorrect preset bag: sf_find_voice() fails
+ #define SF_PRESET_ORDERED	0x2	// has chained or force_velocity zones: zones are matched in file order
+ int flags;
+ int header;			// sf->presets[]
+ int first_zone,n_zones;	// kx_sf_index.zones[], file order
+ int next;			// hash chain, file order; -1: end
+}kx_sf_preset;
+
+typedef struct
+{
+ struct list list;		// hw->sf_index, same order as hw->sf
+ kx_sound_font *sf;
+
+ int hash_bits;
+ int *hash;			// (bank,preset) -> presets[]; -1: empty
+
+ int n_presets;
+ kx_sf_preset *presets;
+
+ int n_zones;
+ kx_sf_zone *zones;
+ int *by_key;			// zone numbers of each preset sorted by key_lo (same layout as zones[])
+ short *key_hi_max;		// by_key[]: highest key_hi of the preset's zones up to this one
+
+ kx_sf_stream *stream;		// streamed sample data; NULL: sf->sample_data
+ kx_sf_data **data;		// sample data used by the zones, once sf->sample_data is shared
+ int n_data;
+ int shared;			// bytes of sample data found in the SoundFonts loaded earlier
+ int received;			// bytes of sample data uploaded so far; the blocks can arrive in any order
+}kx_sf_index;
+
+// timestamped MIDI event (kx_midi_schedule())
+#define KX_MIDI_EVENT_BYTES	12	// complete messages; longer ones (SysEx) go to kx_midi_play_buffer()
+typedef struct
+{
+ dword time;			// kx_midi_clock()
+ dword len;
+ byte data[KX_MIDI_EVENT_BYTES];
+}kx_midi_event;
+
 // synth state
 typedef struct kx_midi_state_t
 {
@@ -853,10 +1078,46 @@ typedef struct kx_midi_state_t
  int drum_channel;
 
  int synth_num;
+
+ // voice parameter tables for kx_synth_start(): allocated by kx_midi_init(), so that
+ // the note-on path does not allocate memory; a table is claimed under hw->k_lock
+ #define KX_SYNTH_ARENAS 4
+ kx_voice_param *arena;		// KX_SYNTH_ARENAS tables of KX_MAX_SF_VOICES entries
+ dword arena_busy;		// bitmask
+
+ // deferred controller updates: kx_synth_changes() only marks the channels (and voices) dirty;
+ // kx_synth_flush() recalculates each voice once and writes its registers in one burst
+ dword dirty_channels;		// bit n: channels[n].dirty or a voice on channel n is dirty
+
+ // the parser and kx_synth_flush(): kx_midi_play_buffer(), the queue timer and kx_midi_stop()
+ // run in different contexts; one of them owns the parser ('parsing') at a time, the others
+ // leave their work to it: bytes in 'pending', a kx_midi_stop() in 'stop_pending'
+ // 'lock' protects these fields only; it is not held while parsing
+ spinlock_t lock;
+ int parsing;
+ int stop_pending;
+ #define KX_MIDI_PENDING	512
+ int pending_len;
+ byte pending[KX_MIDI_PENDING];
+
+ // timestamped events: ring buffer sorted by time, allocated by kx_midi_init(); protected by hw->k_lock
+ // dispatched by 'queue_timer' (interval timer) once due
+ #define KX_MIDI_QUEUE_SIZE	256
+ #define KX_MIDI_QUEUE_PERIOD	32	// sample periods between dispatches (0.67 ms at 48 kHz)
+ #define KX_MIDI_LOOKAHEAD	2	// max. seconds ahead
+ kx_midi_event *queue;
+ int queue_head,queue_count;
+ // the timer is installed and removed with queue_timer_lock held; the timer callback does not take it
+ spinlock_t queue_timer_lock;
+ int queue_timer_installed;
+ int queue_closed;		// kx_midi_close(): no more installs
+ kx_timer queue_timer;
 }kx_midi_state;
 
 KX_API(int,kx_midi_init(kx_hw *hw,kx_midi_state *midi,int synth_));
-KX_API(int,kx_midi_play_buffer(kx_midi_state *midi,byte *buff,int len));
+KX_API(int,kx_midi_play_buffer(kx_midi_state *midi,byte *buff,int len)); // -3: the parser is busy, and KX_MIDI_PENDING is full
+KX_API(int,kx_midi_schedule(kx_midi_state *midi,dword time,byte *buff,int len)); // plays 'buff' at kx_midi_clock() 'time'
+KX_API(dword,kx_midi_clock(kx_midi_state *midi)); // sample periods (extended WC_SAMPLECOUNTER)
 KX_API(int,kx_midi_stop(kx_midi_state *midi));
 KX_API(int,kx_midi_close(kx_midi_state *midi));
 KX_API(int,kx_midi_set_volume(kx_hw *hw,int chn,dword vol)); // chn=0..1 L&R; vol: general kX vol
@@ -884,6 +1145,18 @@ KX_API(int,kx_synth_changes(kx_midi_state *midi,int ch,int note,int what)); // i
 #define CHANGE_CHORUS       93
 #define CHANGE_SOFT_PEDAL   67
 #define CHANGE_HOLD2        69
+KX_API(int,kx_synth_flush(kx_midi_state *midi)); // writes the pending controller changes
+ // kx_midi_channel.dirty, kx_voice.synth_dirty
+ #define SYNTH_DIRTY_MODULATION	0x1
+ #define SYNTH_DIRTY_PITCH	0x2
+ #define SYNTH_DIRTY_VOLUME	0x4
+ #define SYNTH_DIRTY_PAN	0x8
+ #define SYNTH_DIRTY_REVERB	0x10
+ #define SYNTH_DIRTY_CHORUS	0x20
+ #define SYNTH_DIRTY_CUTOFF	0x40
+ #define SYNTH_DIRTY_PEFE	0x80
+ #define SYNTH_DIRTY_FILTERQ	0x100
+ #define SYNTH_DIRTY_GP1	0x200	// ..GP4: 0x1000
 KX_API(int,kx_synth_start(kx_midi_state *midi,int ch,int note,int vel));
 KX_API(int,kx_synth_release(kx_midi_state *midi,int phys_chn));
 KX_API(int,kx_synth_release(kx_hw *hw,int phys_chn));
@@ -900,6 +1173,9 @@ KX_API(int,kx_set_dsp_register(kx_hw *hw,int pgm,const char *name,dword val));
 KX_API(int,kx_get_dsp_register(kx_hw *hw,int pgm,const char *name,dword *val));
 KX_API(int,kx_set_dsp_register(kx_hw *hw,int pgm,word id,dword val));
 KX_API(int,kx_get_dsp_register(kx_hw *hw,int pgm,word id,dword *val));
+// vectored versions; return the number of registers not found or <0
+KX_API(int,kx_set_dsp_registers(kx_hw *hw,int pgm,const kx_reg_update *regs,int n));
+KX_API(int,kx_get_dsp_registers(kx_hw *hw,int pgm,kx_reg_update *regs,int n));
 
 KX_API(int,kx_get_tram_addr(kx_hw *hw,int pgm,const char *name,dword *addr));
 KX_API(int,kx_set_tram_addr(kx_hw *hw,int pgm,const char *name,dword addr));
@@ -926,6 +1202,25 @@ KX_API(int,kx_get_microcode_flag(kx_hw *hw,int pgm,dword *flag));
 KX_API(int,kx_dsp_stop(kx_hw *hw));
 KX_API(int,kx_dsp_go(kx_hw *hw));
 KX_API(int,kx_dsp_clear(kx_hw *hw));
+KX_API(int,kx_get_dsp_resources(kx_hw *hw,kx_dsp_resources *res));
+KX_API(int,kx_dsp_compact(kx_hw *hw,dword flags)); // KX_COMPACT_xxx; returns the number of relocated microcodes
+// transactions (see dsp.cpp): 'owner' / 'client' identify the client (file object, user client);
+// microcode changes of other clients fail with -12 while a transaction is pending
+KX_API(int,kx_dsp_begin(kx_hw *hw,void *owner));
+KX_API(int,kx_dsp_commit(kx_hw *hw,void *owner));
+KX_API(int,kx_dsp_abort(kx_hw *hw,void *owner));
+KX_API(void,kx_dsp_enter(kx_hw *hw,void *client));   // before each request of the client
+KX_API(void,kx_dsp_leave(kx_hw *hw,void *client));   // after it
+KX_API(void,kx_dsp_release(kx_hw *hw,void *client)); // the client is gone: its transaction is rolled back
+
+// telemetry: the page is provided by the OS layer; NULL detaches it (kx_close() does this, too)
+KX_API(int,kx_telemetry_attach(kx_hw *hw,kx_telemetry_page *page));
+// return tap number or <0; taps belong to 'client' (file object, user client), and the taps of
+// a client with the same pgm/register/flags are shared
+KX_API(int,kx_telemetry_add_tap(kx_hw *hw,int pgm,const char *name,word flags,void *client));
+KX_API(int,kx_telemetry_add_tap(kx_hw *hw,int pgm,word id,word flags,void *client));
+KX_API(int,kx_telemetry_remove_tap(kx_hw *hw,int tap,void *client));
+KX_API(void,kx_telemetry_release(kx_hw *hw,void *client)); // the client is gone: its taps are removed
 KX_API(int,kx_dsp_reset(kx_hw *hw));
 KX_API(int,kx_dsp_reload_epilog(kx_hw *hw));
 
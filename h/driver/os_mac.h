@@ -54,8 +54,10 @@ typedef struct
 struct kx_hw;
 
 KX_API(void,kx_spin_lock_init(kx_hw *hw,spinlock_t *,const char *name));
+KX_API(void,kx_spin_lock_free(kx_hw *hw,spinlock_t *));
 KX_API(void,kx_lock_acquire(kx_hw *hw, spinlock_t *, unsigned long *,const char *file,int line));
 KX_API(void,kx_lock_release(kx_hw *hw, spinlock_t *, unsigned long *,const char *file,int line));
+KX_API(void *,kx_current_thread(void)); // identifies the calling thread (see dsp.cpp: kx_dsp_enter())
 
 #ifdef KX_DEBUG
  #define kx_lock_acquire(a,b,c) kx_lock_acquire(a,b,c,__FILE__,__LINE__)
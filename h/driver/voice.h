@@ -27,8 +27,12 @@ void kx_voice_stop(kx_hw *hw,int num);
 void kx_voice_stop_multiple(kx_hw *hw,dword low,dword high);
 void kx_voice_start(kx_hw *hw,int num);
 void kx_voice_start_multiple(kx_hw *hw,dword low,dword high);
-int kx_voice_alloc(kx_hw *hw, int usage);
+void kx_voice_alloc_init(kx_hw *hw);
+int kx_voice_class(int usage,int routing); // routing: DEF_xxx_ROUTING or -1
+int kx_voice_alloc(kx_hw *hw, int usage, int voice_class=-1); // voice_class<0: kx_voice_class(usage,-1)
 void kx_voice_free(kx_hw *hw, int num);
 void kx_voice_init_cache(kx_hw *hw,int i);
+dword kx_voice_clock(kx_hw *hw); // sample periods; see kx_voice_model
+void kx_voice_model_release(kx_hw *hw,int num);
 
 #endif
@@ -0,0 +1,52 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// emufx.h
+// -----
+// built-in copy of the kX effect library microcode (kxemu/emufx.cpp)
+// lets host tools load the effects by name or GUID without the plugin DLLs
+// note: only the microcode is available: plugin parameters (set_param()) are not
+// requires emu/kxemu.h
+
+#ifndef _KX_EMUFX_H_
+#define _KX_EMUFX_H_
+
+typedef struct
+{
+ const char *file;          // source, relative to the tree root
+ const char *name;          // identifier used by the source: 'eq10a', 'surrounder2_51DP'...
+ const char *guid;          // plugin GUID; NULL for alternative versions of the same plugin
+ const dsp_code *code;
+ int code_size;             // instructions
+ const dsp_register_info *info;
+ int info_size;             // registers
+ const int *itramsize,*xtramsize;   // samples
+}kx_emu_fx;
+
+// terminated by an entry with name==NULL
+extern const kx_emu_fx kx_emu_fx_library[];
+
+// looks an effect up by GUID (case-insensitive) or by name; returns NULL if not found
+const kx_emu_fx *kx_emu_find_fx(const char *name);
+
+// kx_emu_load_microcode() for a library effect; 'name' may be NULL
+int kx_emu_load_fx(kx_emu *emu,const kx_emu_fx *fx,const char *name=NULL,int force_pgm_id=0);
+
+#endif
@@ -0,0 +1,189 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// kxemu.h
+// -----
+// host-side emulator of the E10K1/E10K2 effects DSP
+// -----
+// the emulator keeps the same microcode model as the driver (see driver/dsp.cpp):
+// microcode is loaded as dsp_code[] + dsp_register_info[], translated into the
+// physical register / instruction / TRAM space of a 'virtual' chip and executed
+// on the host one sample period at a time
+// this lets effects be run, profiled and compared without a sound card
+// -----
+// two execution engines are available: a reference interpreter (interp.cpp) and a
+// compiler (jit.cpp) that translates the program into x86-64 machine code; both produce
+// bit-identical results (see kxbench: 'dspjit')
+// -----
+// the library is plain C++; the only OS dependency is the executable memory of jit.cpp
+
+#ifndef _KX_EMU_H_
+#define _KX_EMU_H_
+
+#include "defs.h"
+#include "interface/ikx.h"
+#include "interface/dsp.h"
+
+// physical layout of the virtual chip
+#define KX_EMU_REGS_K1      0x400       // 10-bit operands
+#define KX_EMU_REGS_K2      0x800       // 11-bit operands
+#define KX_EMU_MAX_REGS     KX_EMU_REGS_K2
+
+#define KX_EMU_ITRAM_SIZE   8192        // samples; see kx_translate_microcode()
+
+#define KX_EMU_MAX_IO       0x100       // physical i/o (fxbus, inputs, outputs) operand range
+
+// microcode placement: same values as KX_MICROCODE_xxx in ikx.h
+#define KX_EMU_MICROCODE_ANY        0
+#define KX_EMU_MICROCODE_AFTER      1
+#define KX_EMU_MICROCODE_BEFORE     2
+#define KX_EMU_MICROCODE_ABSOLUTE   3
+
+// execution statistics per microcode
+typedef struct
+{
+ dword code_size;           // instructions
+ __int64 executed;          // instructions actually executed (skipped ones excluded)
+ __int64 skipped;           // instructions skipped by SKIP
+}kx_emu_pgm_stats;
+
+// one resolved instruction of the instruction memory
+typedef struct
+{
+ byte op;
+ byte flags;
+  #define KX_EMU_A_ACCUM    0x1     // 'a' operand is the 67-bit accumulator
+  #define KX_EMU_SPECIAL    0x2     // reads CCR/ACCUM as a plain register: refresh them first
+ word pgm;                  // owning microcode (0: none)
+ word r,a,x,y;              // physical operands; 'r' is redirected to the sink for read-only registers
+}kx_emu_op;
+
+typedef struct kx_emu_t
+{
+ int is_10k2;
+
+ int microcode_size;        // 512 or 1024 instructions
+ int first_instruction;     // first non-register physical address (is_valid_gpr())
+ int n_regs;                // size of the physical operand space
+
+ // register file: physical operand space + one 'sink' slot for writes to read-only registers
+ dword regs[KX_EMU_MAX_REGS+1];
+ #define KX_EMU_SINK        KX_EMU_MAX_REGS
+
+ // instruction memory as uploaded (physical operands, same as hwOP())
+ dsp_code instr[E10K2_MAX_INSTRUCTIONS];
+ word instr_pgm[E10K2_MAX_INSTRUCTIONS];
+
+ // resolved program, rebuilt lazily from instr[] when 'dirty' is set
+ // leading and trailing empty instructions are not executed; 'trimmed' is set then
+ kx_emu_op *prog;
+ int prog_size;
+ int trimmed;
+ int dirty;
+
+ // resource usage, same layout as kx_hw::fx_regs_usage / fx_microcode_usage
+ dword regs_usage[1024/32];
+ dword microcode_usage[E10K2_MAX_INSTRUCTIONS/32];
+
+ // microcode list: indexed by pgm id
+ dsp_microcode *pgms[MAX_PGM_NUMBER];
+ kx_emu_pgm_stats stats[MAX_PGM_NUMBER];
+
+ // TRAM
+ dword *itram;              // KX_EMU_ITRAM_SIZE samples
+ word *xtram;               // 16-bit samples, as in host memory
+ dword xtram_size;          // samples (power of two; 0: no external TRAM)
+ dword tram_flags[0x100];   // per TRAM data register: TRAM_READ|TRAM_WRITE
+ dword dbac;                // delay base address counter
+
+ // DSP state that survives between instructions
+ __int64 accum;
+ dword last_result;         // CCR is computed from these on demand
+ int last_sat;
+ dword noise;
+
+ // host i/o: buffers bound to physical i/o registers
+ const dword *in_buf[KX_EMU_MAX_IO];
+ dword *out_buf[KX_EMU_MAX_IO];
+ int in_stride[KX_EMU_MAX_IO];
+ int out_stride[KX_EMU_MAX_IO];
+
+ __int64 samples;           // total sample periods executed
+ dword irq_count;           // number of IRQREG writes with MSB set
+
+ // execution engine
+ int engine;
+  #define KX_EMU_ENGINE_INTERP  0   // reference interpreter: one instruction at a time
+  #define KX_EMU_ENGINE_JIT     1   // native code (x86-64 only; the interpreter is used elsewhere)
+ int link_serial;           // incremented whenever prog[] is rebuilt
+ struct kx_emu_jit_t *jit;  // compiled program (jit.cpp); NULL: not compiled yet
+}kx_emu;
+
+// emulator instance
+int kx_emu_create(kx_emu **emu,int is_10k2,dword xtram_size_bytes);
+void kx_emu_destroy(kx_emu *emu);
+int kx_emu_reset(kx_emu *emu);  // unloads all microcode and clears the DSP (kx_dsp_clear())
+
+// microcode management: same semantics and return values as the kx_*_microcode() driver functions
+int kx_emu_load_microcode(kx_emu *emu,const char *name,const dsp_code *code,int code_size,
+    const dsp_register_info *info,int info_size,int itramsize,int xtramsize,
+    const char *copyright,const char *engine,const char *created,const char *comment,
+    const char *guid,int force_pgm_id=0);
+int kx_emu_unload_microcode(kx_emu *emu,int pgm);
+int kx_emu_translate_microcode(kx_emu *emu,int pgm,int place=0,int pos_pgm=0);
+int kx_emu_untranslate_microcode(kx_emu *emu,int pgm);
+int kx_emu_enable_microcode(kx_emu *emu,int pgm);
+int kx_emu_disable_microcode(kx_emu *emu,int pgm);
+int kx_emu_set_microcode_bypass(kx_emu *emu,int pgm,int state);
+int kx_emu_connect_microcode(kx_emu *emu,int pgm1,word src,int pgm2,word dst);
+int kx_emu_connect_microcode(kx_emu *emu,int pgm1,const char *src,int pgm2,const char *dst);
+dsp_microcode *kx_emu_get_microcode(kx_emu *emu,int pgm);
+
+// registers
+int kx_emu_set_dsp_register(kx_emu *emu,int pgm,const char *name,dword val);
+int kx_emu_get_dsp_register(kx_emu *emu,int pgm,const char *name,dword *val);
+int kx_emu_set_dsp_register(kx_emu *emu,int pgm,word id,dword val);
+int kx_emu_get_dsp_register(kx_emu *emu,int pgm,word id,dword *val);
+int kx_emu_set_tram_addr(kx_emu *emu,int pgm,const char *name,dword addr);
+int kx_emu_get_tram_addr(kx_emu *emu,int pgm,const char *name,dword *addr);
+
+// logical operand (KX_IN(), KX_OUT(), KX_FX(), C_xxx...) -> physical operand
+word kx_emu_map_operand(kx_emu *emu,word a);
+
+// host i/o: 'reg' is either logical (KX_IN(0), KX_FX(3)...) or physical
+// the buffer is read (written) once per sample period: buf[n*stride]
+// pass buf=NULL to unbind
+int kx_emu_bind_input(kx_emu *emu,word reg,const dword *buf,int stride=1);
+int kx_emu_bind_output(kx_emu *emu,word reg,dword *buf,int stride=1);
+
+// run 'samples' sample periods
+int kx_emu_process(kx_emu *emu,int samples);
+
+// selects KX_EMU_ENGINE_xxx; the compiled engine is the default (kxbench dspjit: 1.8x on the effect
+// library, 2.5x on its larger programs, 1.5x on random microcode)
+int kx_emu_set_engine(kx_emu *emu,int engine);
+
+int kx_emu_get_stats(kx_emu *emu,int pgm,kx_emu_pgm_stats *st);
+void kx_emu_reset_stats(kx_emu *emu);
+
+// free space per DSP pool (KX_DSP_POOL_xxx)
+int kx_emu_get_resources(kx_emu *emu,kx_dsp_resources *res);
+
+#endif
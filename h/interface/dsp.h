@@ -168,6 +168,15 @@ typedef struct
  dword p;
 }dsp_register_info;
 
+// vectored register access (see iKX::set_dsp_registers())
+typedef struct
+{
+ char name[MAX_GPR_NAME];   // register name; if empty, 'id' is used
+ word id;
+ word reserved;
+ dword val;
+}kx_reg_update;
+
 typedef struct
 {
  byte op;
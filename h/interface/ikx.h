@@ -126,6 +126,7 @@
     #define KX_DWORD_IS_A4          22  // a4 value
     #define KX_DWORD_IS_CARDBUS     23  // a4 value
     #define KX_DWORD_CAN_K8_PASSTHRU 24 // does not have 0x80008000 DSP issue [usually 10k8]
+    #define KX_DWORD_SF_UPLOAD_CHUNK 25 // largest KX_PROP_SOUNDFONT_LOAD_SMPL block, bytes of sample data
 
     // ids for get_hw_parameter
     #define KX_HW_DOO           0
@@ -178,7 +179,39 @@
       #define KX_ZSNB_MICIN 1
       // #define KX_ZSNB_SPDIFIN    1
       // #define KX_ZSNB_WUH    3
-    #define KX_HW_LAST          22
+    #define KX_HW_SYNTH_ALLOCATIONS 23  // read-only: memory allocations made by the synth on note-on
+                                        // (should stay 0; see kx_midi_init())
+    #define KX_HW_VOICE_QUOTA       24  // +KX_VOICE_CLASS_xxx (24..28): max. number of voices of the class
+    #define KX_HW_VOICE_ALLOCATIONS 29  // voice allocator statistics (read-only; set KX_HW_VOICE_ALLOCATIONS to reset)
+    #define KX_HW_VOICE_ALLOC_FAILURES  30
+    #define KX_HW_VOICE_ALLOC_STEALS    31  // allocations that had to steal MIDI voices
+    #define KX_HW_VOICE_ALLOC_LATENCY   32  // average, CPU timestamp ticks (0: not available)
+    #define KX_HW_VOICE_ALLOC_LATENCY_MAX 33
+    #define KX_HW_SYNTH_CHANGES     34  // synth controller changes received (read-only; set KX_HW_SYNTH_CHANGES to reset)
+    #define KX_HW_SYNTH_UPDATES     35  // voice register updates the changes were coalesced into
+    #define KX_HW_SYNTH_CLOCK       36  // read-only: current time of the synth event scheduler, sample periods
+                                        // (iKX::send_synth_at())
+    #define KX_HW_MIDI_QUEUE_DEPTH  37  // timestamped MIDI events waiting
+    #define KX_HW_MIDI_QUEUE_MAX    38  // most events ever waiting
+    #define KX_HW_MIDI_EVENTS       39  // events dispatched (read-only; set KX_HW_MIDI_EVENTS to reset the statistics)
+    #define KX_HW_MIDI_LATE         40  // events dispatched more than one scheduler period late
+    #define KX_HW_MIDI_LATE_MAX     41  // sample periods
+    #define KX_HW_MIDI_DROPPED      42  // rejected: queue full or too far ahead
+    #define KX_HW_SF_POOL_SIZE      43  // KB of memory for streamed SoundFont samples; 0: SoundFonts are loaded as a whole (default)
+                                        // applies to SoundFonts loaded later; cannot be changed while streamed SoundFonts are loaded
+    #define KX_HW_SF_POOL_HITS      44  // streamed sample pages found in the pool at note-on (read-only; set KX_HW_SF_POOL_HITS to reset)
+    #define KX_HW_SF_POOL_MISSES    45  // pages that had to be loaded (played as silence until then)
+    #define KX_HW_SF_POOL_EVICTIONS 46  // pages evicted from the pool (least recently used)
+    #define KX_HW_SF_POOL_DROPPED   47  // pages not loaded: load queue full or all the pool in use
+    #define KX_HW_LAST          47
+
+    // voice classes: allocation quotas (KX_HW_VOICE_QUOTA+class)
+    #define KX_VOICE_CLASS_WAVE     0
+    #define KX_VOICE_CLASS_MIDI     1
+    #define KX_VOICE_CLASS_ASIO     2
+    #define KX_VOICE_CLASS_AC3      3   // DEF_AC3_xxx_ROUTING, DEF_AC3PASSTHROUGH_ROUTING
+    #define KX_VOICE_CLASS_3D       4   // DEF_3D_xxx_ROUTING
+    #define KX_VOICE_CLASSES        5
 
     // synth compatibility flags
     #define KX_SYNTH_COMPAT_HOLD        1       // per specs
@@ -279,6 +312,22 @@
 
  #define IKX_UPDATE_ALL         (0xffffffff)
 
+ // pools for get_dsp_resources()
+ #define KX_DSP_POOL_MICROCODE  0   // instructions
+ #define KX_DSP_POOL_GPR        1   // registers
+ #define KX_DSP_POOL_ITRAM      2   // samples
+ #define KX_DSP_POOL_XTRAM      3   // samples
+ #define KX_DSP_POOL_ITRAM_REGS 4   // iTRAM data/address register pairs
+ #define KX_DSP_POOL_XTRAM_REGS 5   // xTRAM data/address register pairs
+ #define KX_DSP_POOLS           6
+
+ // flags for dsp_compact(); translate_microcode() compacts instruction memory by itself when it runs out of it,
+ // TRAM is only compacted on request
+ #define KX_COMPACT_MICROCODE   1   // remove gaps between microcode (execution order is kept)
+ #define KX_COMPACT_ITRAM       2   // pack iTRAM delay lines (moved delay lines restart from silence)
+ #define KX_COMPACT_XTRAM       4   // pack xTRAM delay lines
+ #define KX_COMPACT_ALL         (KX_COMPACT_MICROCODE|KX_COMPACT_ITRAM|KX_COMPACT_XTRAM)
+
 
  // parameters for audio_set_parameter / audio_get_parameter
 #define KX_VOICE_VOLUME     0x1
@@ -312,6 +361,77 @@ typedef struct
  dword cur_vol;
 }kx_voice_info;
 
+// DSP resources: a microcode can be translated only if every request fits into
+// the largest free block of the corresponding pool
+typedef struct
+{
+ dword size;            // pool size
+ dword free;            // free units, total
+ dword largest_free;    // largest contiguous free block
+ dword free_blocks;     // number of free blocks
+ dword fragmentation;   // 0..100%: 100*(1-largest_free/free)
+}kx_dsp_pool_info;
+
+typedef struct
+{
+ kx_dsp_pool_info pool[KX_DSP_POOLS];
+}kx_dsp_resources;
+
+// DSP telemetry: registers ('taps') sampled by the driver from the interval timer
+// into a ring of frames in a read-only page shared with all clients
+// (see iKX::map_telemetry() / add_telemetry_tap() and kx_telemetry_read())
+#define KX_TELEMETRY_TAPS       48
+#define KX_TELEMETRY_FRAMES     16      // power of two
+#define KX_TELEMETRY_PERIOD     480     // default sampling period, in samples (10 ms)
+#define KX_TELEMETRY_MAGIC      0x6d74586bU // 'kXtm'
+
+typedef struct
+{
+ int pgm;       // 0: free slot
+ word id;       // register id
+ word flags;
+  #define KX_TAP_RESET      0x1     // the register is zeroed after it is sampled (peak meters)
+  #define KX_TAP_SAMPLED    0x8000  // [status] the register was found in the last frame
+}kx_telemetry_tap;
+
+typedef struct
+{
+ dword sample_counter;              // WC_SAMPLECOUNTER
+ dword val[KX_TELEMETRY_TAPS];
+}kx_telemetry_frame;
+
+typedef struct kx_telemetry_page_t
+{
+ dword magic;
+ dword size;                        // sizeof(kx_telemetry_page)
+ volatile dword seq;                // number of frames written; the last one is frames[(seq-1)%KX_TELEMETRY_FRAMES]
+ dword period;                      // in samples
+ kx_telemetry_tap taps[KX_TELEMETRY_TAPS];
+ kx_telemetry_frame frames[KX_TELEMETRY_FRAMES];
+}kx_telemetry_page;
+
+// the largest (signed) value of 'tap' in the frames written since *seq; updates *seq
+// returns 0 if there are no new frames; a reader more than KX_TELEMETRY_FRAMES-1 frames behind loses the oldest ones
+static inline int kx_telemetry_read(const kx_telemetry_page *page,int tap,dword *seq,dword *val)
+{
+ dword last=page->seq;
+ dword from=*seq;
+ int ret=0;
+
+ if(last-from>KX_TELEMETRY_FRAMES-1) // the oldest frame may be being written
+  from=last-(KX_TELEMETRY_FRAMES-1);
+
+ for(dword i=from;i!=last;i++)
+ {
+  int v=(int)page->frames[i&(KX_TELEMETRY_FRAMES-1)].val[tap];
+  if(!ret || v>(int)*val)
+   *val=(dword)v;
+  ret=1;
+ }
+ *seq=last;
+ return ret;
+}
+
 typedef struct
 {
     dword control_bits;
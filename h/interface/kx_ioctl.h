@@ -30,6 +30,12 @@ enum
     kTransaction,
     kNumMethods
 };
+
+// IOConnectMapMemory() types
+enum
+{
+    kTelemetryMemory=1      // kx_telemetry_page, read-only
+};
 #endif
 
 // prop_op
@@ -130,6 +136,18 @@ typedef struct
  int pgm;
 }dsp_register_property;
 
+#define KX_PROP_DSP_REGISTERS       0x206 // 'GET'; dsp_registers_property followed by 'n' kx_reg_update
+typedef struct
+{
+ int pgm;
+ int n;
+ int cmd;
+  #define KX_DSP_REGISTERS_GET  0
+  #define KX_DSP_REGISTERS_SET  1
+ int ret;   // result of kx_get/set_dsp_registers()
+}dsp_registers_property;
+#define KX_MAX_DSP_REGISTERS    1024  // per request
+
 #define KX_PROP_INSTRUCTION_READ    0x207
 #define KX_PROP_INSTRUCTION_WRITE   0x208
 typedef struct
@@ -160,6 +178,10 @@ typedef struct
  #define KX_PROP_MICROCODE_BYPASS_OFF   9
  #define KX_PROP_MICROCODE_SET_FLAG 10
  #define KX_PROP_MICROCODE_GET_FLAG 11
+ #define KX_PROP_MICROCODE_DSP_COMPACT  12  // p1: KX_COMPACT_xxx
+ #define KX_PROP_MICROCODE_DSP_BEGIN    13
+ #define KX_PROP_MICROCODE_DSP_COMMIT   14
+ #define KX_PROP_MICROCODE_DSP_ABORT    15
 
  int pgm;
  int p1,p2;
@@ -193,6 +215,7 @@ typedef struct
 #define KX_PROP_MICROCODE_ENUM_ALL      0x232 // should use 'GET' op; size!=0; param is 'dsp_microcode'; first dword - size of
 #define KX_PROP_MICROCODE_QUERY         0x233 // = with size=0; param is dword
 #define KX_PROP_MICROCODE_SET_NAME      0x234 // 'GET'
+#define KX_PROP_DSP_RESOURCES           0x235 // 'GET'; param is kx_dsp_resources
 typedef struct
 {
  int pgm;
@@ -200,6 +223,27 @@ typedef struct
  dsp_microcode m;   // .flag contains 'what' for 'set_name'
 }microcode_enum_property;
 
+#define KX_PROP_TELEMETRY               0x236 // 'GET'
+typedef struct
+{
+ int cmd;
+  #define KX_TELEMETRY_MAP          0   // Windows: maps the page into the calling process, until the handle is closed
+  #define KX_TELEMETRY_UNMAP        1   // Windows; OS X uses IOConnectMapMemory(kTelemetryMemory)
+  #define KX_TELEMETRY_ADD_TAP      2   // pgm, name (or id, if name is empty), flags
+  #define KX_TELEMETRY_REMOVE_TAP   3   // tap
+ int pgm;
+ char name[MAX_GPR_NAME];
+ word id;
+ word flags;
+ int tap;
+ union
+ {
+  kx_telemetry_page *page;  // user-mode address
+  __int64 page_padding;
+ };
+ int ret;   // tap number for KX_TELEMETRY_ADD_TAP, or <0
+}telemetry_property;
+
 #define KX_PROP_LOAD_MICROCODE      0x300 // should use 'GET' op;
 #define KX_PROP_GET_MICROCODE       0x301 // should use 'GET' op;
 #define KX_PROP_UPDATE_MICROCODE    0x302 // should use 'GET' op;
@@ -230,6 +274,14 @@ typedef struct
  dword data;
 }kx_synth_data;
 
+#define KX_PROP_SOUNDFONT_SYNTH_AT  0x511
+typedef struct
+{
+ int synth_id;
+ dword time;    // KX_HW_SYNTH_CLOCK
+ dword data;
+}kx_synth_event;
+
 #define KX_PROP_VOICE_INFO  0x600
 #define KX_PROP_SPECTRAL_INFO   0x601
 
@@ -38,6 +38,7 @@
 
 #if defined(__APPLE__)
     #include <IOKit/IOKitLib.h>
+    #include <pthread.h>
 #endif
 
 class KX_CLASS_TYPE iKX
@@ -151,6 +152,15 @@ public:
         int get_dsp_register(int pgm,const char *name,dword *val);
         int set_dsp_register(int pgm,word id,dword val);
         int get_dsp_register(int pgm,word id,dword *val);
+        // vectored versions: a single request for 'n' registers (by name or, if the name is empty, by id)
+        // return the number of registers not found; <0: error
+        int set_dsp_registers(int pgm,const kx_reg_update *regs,int n);
+        int get_dsp_registers(int pgm,kx_reg_update *regs,int n);
+        // set_dsp_register(pgm,...) calls made until end_dsp_registers() are collected and sent
+        // with set_dsp_registers(); get_dsp_register(pgm,...) sends the collected ones first
+        // the calls can be nested (for the same pgm); end_dsp_registers() returns the number of registers not found
+        int begin_dsp_registers(int pgm);
+        int end_dsp_registers();
         // the same, but register type specific
         int set_tram_addr(int pgm,const char *name,dword addr); // addr is relative to tram_start
         int get_tram_addr(int pgm,const char *name,dword *addr);
@@ -180,6 +190,29 @@ public:
     int dsp_go();
     int dsp_stop();
     int dsp_clear(); // unloads all uploaded microcode; frees all hw resources; assumes dsp_stop();
+    int get_dsp_resources(kx_dsp_resources *res); // free space / largest free block / fragmentation per pool
+    int dsp_compact(dword flags=KX_COMPACT_ALL); // relocates microcode / TRAM to merge free blocks; returns the number of relocated microcodes
+
+    // DSP telemetry: registers sampled by the driver into a shared read-only page (see kx_telemetry_read())
+    // map_telemetry() returns NULL if not supported; the page is unmapped by close()
+    const kx_telemetry_page *map_telemetry();
+    int add_telemetry_tap(int pgm,const char *name,word flags=0); // flags: KX_TAP_xxx; returns tap number or <0
+    int add_telemetry_tap(int pgm,word id,word flags=0);
+    int remove_telemetry_tap(int tap);
+
+    // DSP transactions: microcode load / unload / translate / connect / disconnect / enable / bypass
+    // and set_dsp_register() calls made after dsp_begin() are applied by dsp_commit() in one step;
+    // dsp_abort() discards them and leaves the running DSP graph intact
+    // the transaction belongs to this handle, not to the process: microcode changes made through other
+    // handles (of this process too) fail with -12 meanwhile and their register writes are not part of
+    // it; closing the handle, or leaving the transaction idle for 10 seconds while another handle
+    // changes the microcode, rolls it back
+    // until then, get_dsp_register() returns the queued values through this handle and the values
+    // on the hardware through the other handles;
+    // update_microcode() (code/registers) and dsp_compact() are not available
+    int dsp_begin();
+    int dsp_commit();
+    int dsp_abort();
 
     int mute();
     int unmute();
@@ -305,9 +338,13 @@ public:
         // SoundFont
         int load_soundfont(kx_sound_font *fnt,int partial=0); // returns id or <0 -error
         int load_soundfont_x(kx_sound_font *fnt,const char *fname,long f_pos); // returns id or <0 -error
+        // KX_PROP_SOUNDFONT_LOAD_SMPL: bytes of sample data per block the driver accepts;
+        // *fixed: each request must be sizeof(sf_load_sample_property) long (older drivers)
+        int sf_upload_chunk(int *fixed);
         int unload_soundfont(int id);
         int enum_soundfonts(sfHeader *hdr,int size); // if size==0 - ret is # of bytes needed
         // on exist hdr[..].rom_ver = SF id  (.minor)
+        // hdr[..].sample_shared: bytes of sample data stored once with the SoundFonts loaded earlier
         int compile_soundfont(char *dir,char *fname,dword sfman_id=0,dword subsynth_=0); // (if fname==NULL - auto upload)
         int parse_soundfont(char *fname,char *dir,dword sfman_id=0,dword subsynth_=0);
             // if dir==NULL - auto upload; 
@@ -322,6 +359,8 @@ public:
 
         // DirectSynth / Vienna architecture
         int send_synth(int synth_id,dword data);
+        int send_synth_at(int synth_id,dword time,dword data);
+            // plays the message when the KX_HW_SYNTH_CLOCK hw parameter reaches 'time' (up to 2 s ahead)
 
         // low-level hardware parameter
         int get_hw_parameter(int id,dword *value);
@@ -414,6 +453,24 @@ private:
         char error_name[128];
     
         dword is_10k2;  // emulation, if no hardware is present; is set by set/get_dsp()
+
+        // begin_dsp_registers() queue
+        #define KX_REG_QUEUE 128
+        kx_reg_update reg_queue[KX_REG_QUEUE];
+        int reg_queue_n,reg_queue_pgm,reg_queue_depth,reg_queue_missing;
+        int queue_dsp_register(int pgm,const char *name,word id,dword val);
+        int flush_dsp_registers();
+        // the queue is shared by all threads using this iKX; the lock is recursive
+        #if defined(WIN32)
+        CRITICAL_SECTION reg_queue_lock;
+        #elif defined(__APPLE__)
+        pthread_mutex_t reg_queue_lock;
+        #endif
+        void lock_reg_queue();
+        void unlock_reg_queue();
+        void sync_dsp_registers(int pgm); // flushes writes queued for pgm before other accesses to it
+
+        kx_telemetry_page *telemetry; // mapped telemetry page
 public:
     
 #if defined(WIN32)  
@@ -526,6 +583,8 @@ private:
     io_iterator_t           iterator;
     io_connect_t            connect;
     
+    void unmap_telemetry();
+    
     int device_num;
     char device_name[KX_MAX_STRING];
 #endif // OSX-specific
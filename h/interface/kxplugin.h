@@ -140,6 +140,8 @@ public:
  int set_dsp_register(const char *id,dword val);
  int get_dsp_register(word id,dword *val);
  int get_dsp_register(const char *id,dword *val);
+ int set_dsp_registers(const kx_reg_update *regs,int n); // see iKX::set_dsp_registers()
+ int get_dsp_registers(kx_reg_update *regs,int n);
  int set_tram_addr(word id,dword addr); // relative to itram_start (i.e. logical)
  int get_tram_addr(word id,dword *addr);
  int set_tram_flag(word id,dword flag);
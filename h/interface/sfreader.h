@@ -0,0 +1,559 @@
+// kX Driver Interface
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// sfreader.h
+// -----------
+// SoundFont 2 (RIFF 'sfbk') reader used by iKX::parse_soundfont() (kxapi/parse.cpp)
+// -----------
+// the file is memory-mapped and parsed in place: the pdta tables and the sample data point
+// into the mapping, nothing is copied until the font is uploaded
+// every chunk is checked against its parent chunk and the mapping; bag / generator indices
+// are checked against the tables they refer to
+// all state is kept in sf_reader, so several fonts can be parsed at the same time
+// the code is OS-independent so that it can be tested on the host (kxbench sfparse)
+// requires interface/ikx.h, interface/dsp.h (struct list), interface/soundfont.h
+
+#ifndef _KX_SFREADER_H_
+#define _KX_SFREADER_H_
+
+#include <stddef.h>
+
+#if defined(WIN32)
+	#include <windows.h>
+#else
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// sf_reader_open_mem() flags
+#define SF_READER_VIENNA	1	// Vienna dynamic font: no 'RIFF' / 'sfbk' header (4 bytes are skipped),
+					// ends with the first non-LIST chunk; sdta and shdr are optional
+
+// error codes (as returned by iKX::parse_soundfont())
+#define SF_READER_E_OPEN	-1	// cannot open / map the file
+#define SF_READER_E_RIFF	-2	// not a RIFF file
+#define SF_READER_E_SFBK	-3	// RIFF file w/o 'sfbk'
+#define SF_READER_E_CHUNK	-4	// unknown non-LIST chunk
+#define SF_READER_E_IFIL	-5	// 'ifil' is not 4 bytes
+#define SF_READER_E_SMPL	-6	// 'sdta' w/o 'smpl'
+#define SF_READER_E_SIZE	-8	// pdta table size is not a multiple of the record size
+#define SF_READER_E_DOUBLE	-9	// table / section found twice
+#define SF_READER_E_MISSING	-11	// required pdta table is missing
+#define SF_READER_E_ORDER	-22	// bag indices are not monotonic
+#define SF_READER_E_BOUNDS	-23	// chunk exceeds its parent chunk or the file
+#define SF_READER_E_INDEX	-24	// bag / generator index is out of range
+#define SF_READER_E_MEMORY	-10
+
+typedef struct
+{
+	const byte *base;		// mapped file or caller's memory
+	size_t size;
+	int mapped;
+#if defined(WIN32)
+	HANDLE file;
+	HANDLE mapping;
+#endif
+
+	sfHeader header;		// INFO strings, table sizes, sample_len ('smpl' size, bytes)
+
+	// tables: point into the mapping (unaligned)
+	const sfPresetHeader *presets;
+	const sfModGenBag *preset_bags;
+	const sfModList *pmodlists;
+	const sfGenList *pgenlists;
+	const sfInst *insts;
+	const sfModGenBag *inst_bags;
+	const sfModList *imodlists;
+	const sfGenList *igenlists;
+	const sfSample *samples;
+	const byte *sample_data;	// 'smpl' chunk data, header.sample_len bytes
+}sf_reader;
+
+#define SF_ID(a,b,c,d)	((dword)(byte)(a)|((dword)(byte)(b)<<8)|((dword)(byte)(c)<<16)|((dword)(byte)(d)<<24))
+
+static inline dword sf_get_dword(const byte *p)
+{
+	return (dword)p[0]|((dword)p[1]<<8)|((dword)p[2]<<16)|((dword)p[3]<<24);
+}
+
+static inline const char *sf_reader_error(int code)
+{
+	switch(code)
+	{
+		case SF_READER_E_OPEN: return "cannot open the file";
+		case SF_READER_E_RIFF: return "file is not RIFF";
+		case SF_READER_E_SFBK: return "RIFF file w/o sfbk section";
+		case SF_READER_E_CHUNK: return "unknown non-LIST section";
+		case SF_READER_E_IFIL: return "ifil is not 4 bytes";
+		case SF_READER_E_SMPL: return "sdta section w/o smpl first";
+		case SF_READER_E_SIZE: return "table size mismatch";
+		case SF_READER_E_DOUBLE: return "double section found";
+		case SF_READER_E_MEMORY: return "not enough memory";
+		case SF_READER_E_MISSING: return "required pdta section is missing";
+		case SF_READER_E_ORDER: return "bag indices are not monotonic";
+		case SF_READER_E_BOUNDS: return "chunk exceeds its parent or the file";
+		case SF_READER_E_INDEX: return "index out of range";
+	}
+	return "error";
+}
+
+// chunk header at 'pos'; the chunk must end before 'end'
+static inline int sf_reader_chunk(const sf_reader *r,size_t pos,size_t end,dword *id,size_t *size)
+{
+	if(pos>end || end-pos<8)
+		return SF_READER_E_BOUNDS;
+	*id=sf_get_dword(r->base+pos);
+	*size=sf_get_dword(r->base+pos+4);
+	if(*size>end-pos-8)
+		return SF_READER_E_BOUNDS;
+	return 0;
+}
+
+static inline void sf_reader_string(char *to,size_t to_size,const byte *from,size_t size)
+{
+	if(size>to_size-1)
+		size=to_size-1;
+	memcpy(to,from,size);
+	to[size]=0;
+}
+
+static inline int sf_reader_info(sf_reader *r,size_t pos,size_t end)
+{
+	sfHeader *h=&r->header;
+
+	while(end-pos>=8)
+	{
+		dword id;
+		size_t size;
+		int ret=sf_reader_chunk(r,pos,end,&id,&size);
+		if(ret)
+			return ret;
+		const byte *data=r->base+pos+8;
+
+		switch(id)
+		{
+			case SF_ID('i','f','i','l'):
+				if(size!=4)
+					return SF_READER_E_IFIL;
+				h->ver.major=(word)(data[0]|(data[1]<<8));
+				h->ver.minor=(word)(data[2]|(data[3]<<8));
+				break;
+			case SF_ID('i','v','e','r'):
+				if(size==4)
+				{
+					h->rom_ver.major=(word)(data[0]|(data[1]<<8));
+					h->rom_ver.minor=(word)(data[2]|(data[3]<<8));
+				}
+				break;
+			case SF_ID('i','s','n','g'): sf_reader_string(h->engine,sizeof(h->engine),data,size); break;
+			case SF_ID('I','N','A','M'): sf_reader_string(h->name,sizeof(h->name),data,size); break;
+			case SF_ID('i','r','o','m'): sf_reader_string(h->rom_name,sizeof(h->rom_name),data,size); break;
+			case SF_ID('I','C','R','D'): sf_reader_string(h->card,sizeof(h->card),data,size); break;
+			case SF_ID('I','E','N','G'): sf_reader_string(h->engineer,sizeof(h->engineer),data,size); break;
+			case SF_ID('I','P','R','D'): sf_reader_string(h->product,sizeof(h->product),data,size); break;
+			case SF_ID('I','C','O','P'): sf_reader_string(h->copyright,sizeof(h->copyright),data,size); break;
+			case SF_ID('I','C','M','T'): sf_reader_string(h->comments,sizeof(h->comments),data,size); break;
+			case SF_ID('I','S','F','T'): sf_reader_string(h->creator,sizeof(h->creator),data,size); break;
+			default: // unknown: skipped
+				break;
+		}
+		pos+=8+size;
+	}
+	return 0;
+}
+
+static inline int sf_reader_sdta(sf_reader *r,size_t pos,size_t end)
+{
+	dword id;
+	size_t size;
+
+	if(r->sample_data)
+		return SF_READER_E_DOUBLE;
+	if(end-pos<8 || sf_get_dword(r->base+pos)!=SF_ID('s','m','p','l'))
+		return SF_READER_E_SMPL;
+	int ret=sf_reader_chunk(r,pos,end,&id,&size);
+	if(ret)
+		return ret;
+	if(size>0x7ffffff0) // sfHeader.sample_len is an int
+		return SF_READER_E_BOUNDS;
+
+	r->sample_data=r->base+pos+8;
+	r->header.sample_len=(int)size;
+	// 'sm24' (24-bit extension) is ignored
+	return 0;
+}
+
+static inline int sf_reader_pdta(sf_reader *r,size_t pos,size_t end)
+{
+	sfHeader *h=&r->header;
+	struct
+	{
+		dword id;
+		size_t record;
+		const void **table;
+		int *count;
+	}tables[]=
+	{
+		{ SF_ID('p','h','d','r'), sizeof(sfPresetHeader), (const void **)&r->presets, &h->presets },
+		{ SF_ID('p','b','a','g'), sizeof(sfModGenBag), (const void **)&r->preset_bags, &h->preset_bags },
+		{ SF_ID('p','m','o','d'), sizeof(sfModList), (const void **)&r->pmodlists, &h->pmodlists },
+		{ SF_ID('p','g','e','n'), sizeof(sfGenList), (const void **)&r->pgenlists, &h->pgenlists },
+		{ SF_ID('i','n','s','t'), sizeof(sfInst), (const void **)&r->insts, &h->insts },
+		{ SF_ID('i','b','a','g'), sizeof(sfModGenBag), (const void **)&r->inst_bags, &h->inst_bags },
+		{ SF_ID('i','m','o','d'), sizeof(sfModList), (const void **)&r->imodlists, &h->imodlists },
+		{ SF_ID('i','g','e','n'), sizeof(sfGenList), (const void **)&r->igenlists, &h->igenlists },
+		{ SF_ID('s','h','d','r'), sizeof(sfSample), (const void **)&r->samples, &h->samples }
+	};
+
+	while(end-pos>=8)
+	{
+		dword id;
+		size_t size;
+		int ret=sf_reader_chunk(r,pos,end,&id,&size);
+		if(ret)
+			return ret;
+
+		for(size_t i=0;i<sizeof(tables)/sizeof(tables[0]);i++)
+		{
+			if(tables[i].id!=id)
+				continue;
+			if(size%tables[i].record)
+				return SF_READER_E_SIZE;
+			if(*tables[i].table)
+				return SF_READER_E_DOUBLE;
+			if(size/tables[i].record>0xffff+1) // indices are words
+				return SF_READER_E_INDEX;
+			if(size)
+			{
+				*tables[i].table=r->base+pos+8;
+				*tables[i].count=(int)(size/tables[i].record);
+			}
+			break;
+		}
+		// unknown sub-chunks are skipped
+		pos+=8+size;
+	}
+	return 0;
+}
+
+// bag lists: bags [ndx(i), ndx(i+1)) of each item; the last item is the terminator
+static inline int sf_reader_check_bags(const sfModGenBag *bags,int n_bags,int n_gens,int n_mods)
+{
+	for(int i=0;i<n_bags;i++)
+	{
+		if(i+1<n_bags && (bags[i].gen_ndx>bags[i+1].gen_ndx || bags[i].mod_ndx>bags[i+1].mod_ndx))
+			return SF_READER_E_ORDER;
+		if(bags[i].gen_ndx>n_gens || bags[i].mod_ndx>n_mods)
+			return SF_READER_E_INDEX;
+	}
+	return 0;
+}
+
+static inline int sf_reader_check_gens(const sfGenList *gens,int n_gens,SFGenerator oper,int n_items)
+{
+	for(int i=0;i<n_gens;i++)
+		if(gens[i].gen_oper==oper && gens[i].gen_amount.amount_w>=n_items)
+			return SF_READER_E_INDEX;
+	return 0;
+}
+
+static inline int sf_reader_check(const sf_reader *r,int flags)
+{
+	const sfHeader *h=&r->header;
+
+	if(!r->presets || !r->preset_bags || !r->pgenlists || !r->insts || !r->inst_bags || !r->igenlists ||
+	   (!(flags&SF_READER_VIENNA) && !r->samples))
+		return SF_READER_E_MISSING;
+
+	// items point to [ndx(i), ndx(i+1)) bags; ndx(i+1) indexes a bag
+	for(int i=0;i<h->presets;i++)
+	{
+		if(i+1<h->presets && r->presets[i].preset_bag_ndx>r->presets[i+1].preset_bag_ndx)
+			return SF_READER_E_ORDER;
+		if(r->presets[i].preset_bag_ndx>=h->preset_bags)
+			return SF_READER_E_INDEX;
+	}
+	for(int i=0;i<h->insts;i++)
+	{
+		if(i+1<h->insts && r->insts[i].inst_bag_ndx>r->insts[i+1].inst_bag_ndx)
+			return SF_READER_E_ORDER;
+		if(r->insts[i].inst_bag_ndx>=h->inst_bags)
+			return SF_READER_E_INDEX;
+	}
+
+	int ret;
+	if((ret=sf_reader_check_bags(r->preset_bags,h->preset_bags,h->pgenlists,h->pmodlists))!=0 ||
+	   (ret=sf_reader_check_bags(r->inst_bags,h->inst_bags,h->igenlists,h->imodlists))!=0)
+		return ret;
+
+	// 41: instrument, 53: sample
+	if((ret=sf_reader_check_gens(r->pgenlists,h->pgenlists,41,h->insts))!=0)
+		return ret;
+	if(r->samples && (ret=sf_reader_check_gens(r->igenlists,h->igenlists,53,h->samples))!=0)
+		return ret;
+	return 0;
+}
+
+static inline int sf_reader_parse(sf_reader *r,int flags)
+{
+	size_t pos,end=r->size;
+
+	if(flags&SF_READER_VIENNA)
+		pos=4;
+	else
+	{
+		if(r->size<12 || sf_get_dword(r->base)!=SF_ID('R','I','F','F'))
+			return SF_READER_E_RIFF;
+		if(sf_get_dword(r->base+8)!=SF_ID('s','f','b','k'))
+			return SF_READER_E_SFBK;
+		// a RIFF size that exceeds the file is tolerated: the LIST chunks are checked
+		size_t riff=sf_get_dword(r->base+4);
+		if(riff<end-8)
+			end=riff+8;
+		pos=12;
+	}
+
+	int info=0,pdta=0;
+	while(pos<end && end-pos>=4)
+	{
+		dword id=sf_get_dword(r->base+pos);
+		if(id!=SF_ID('L','I','S','T'))
+		{
+			if(flags&SF_READER_VIENNA)
+				break;
+			return SF_READER_E_CHUNK;
+		}
+
+		size_t size;
+		int ret=sf_reader_chunk(r,pos,end,&id,&size);
+		if(ret)
+			return ret;
+		if(size<4)
+			return SF_READER_E_BOUNDS;
+
+		size_t list=pos+12,list_end=pos+8+size;
+		switch(sf_get_dword(r->base+pos+8))
+		{
+			case SF_ID('I','N','F','O'):
+				ret=(info++)?SF_READER_E_DOUBLE:sf_reader_info(r,list,list_end);
+				break;
+			case SF_ID('s','d','t','a'):
+				ret=sf_reader_sdta(r,list,list_end);
+				break;
+			case SF_ID('p','d','t','a'):
+				ret=(pdta++)?SF_READER_E_DOUBLE:sf_reader_pdta(r,list,list_end);
+				break;
+			default: // unknown LIST: skipped
+				break;
+		}
+		if(ret)
+			return ret;
+		pos=list_end;
+	}
+
+	return sf_reader_check(r,flags);
+}
+
+// parses 'size' bytes at 'data'; the memory must stay valid until sf_reader_close()
+static inline int sf_reader_open_mem(sf_reader *r,const void *data,size_t size,int flags)
+{
+	memset(r,0,sizeof(sf_reader));
+	r->base=(const byte *)data;
+	r->size=size;
+	return sf_reader_parse(r,flags);
+}
+
+static inline void sf_reader_close(sf_reader *r)
+{
+	if(r->mapped)
+	{
+#if defined(WIN32)
+		UnmapViewOfFile((LPCVOID)r->base);
+		CloseHandle(r->mapping);
+		CloseHandle(r->file);
+#else
+		munmap((void *)r->base,r->size);
+#endif
+	}
+	memset(r,0,sizeof(sf_reader));
+}
+
+// maps the file (read-only) and parses it; sf_reader_close() must be called even on failure
+static inline int sf_reader_open(sf_reader *r,const char *file_name)
+{
+	memset(r,0,sizeof(sf_reader));
+
+#if defined(WIN32)
+	r->file=CreateFileA(file_name,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+	if(r->file==INVALID_HANDLE_VALUE)
+	{
+		r->file=NULL;
+		return SF_READER_E_OPEN;
+	}
+	LARGE_INTEGER file_size;
+	if(!GetFileSizeEx(r->file,&file_size) || file_size.QuadPart<12 || (unsigned __int64)file_size.QuadPart>(size_t)-1)
+	{
+		CloseHandle(r->file);
+		r->file=NULL;
+		return (file_size.QuadPart<12)?SF_READER_E_RIFF:SF_READER_E_OPEN;
+	}
+	r->mapping=CreateFileMappingA(r->file,NULL,PAGE_READONLY,0,0,NULL);
+	r->base=r->mapping?(const byte *)MapViewOfFile(r->mapping,FILE_MAP_READ,0,0,0):NULL;
+	if(r->base==NULL)
+	{
+		if(r->mapping)
+			CloseHandle(r->mapping);
+		CloseHandle(r->file);
+		memset(r,0,sizeof(sf_reader));
+		return SF_READER_E_OPEN;
+	}
+	r->size=(size_t)file_size.QuadPart;
+#else
+	int fd=open(file_name,O_RDONLY);
+	if(fd<0)
+		return SF_READER_E_OPEN;
+	struct stat st;
+	memset(&st,0,sizeof(st));
+	if(fstat(fd,&st) || st.st_size<12 || (unsigned long long)st.st_size>(size_t)-1)
+	{
+		close(fd);
+		return (st.st_size<12)?SF_READER_E_RIFF:SF_READER_E_OPEN;
+	}
+	void *p=mmap(NULL,(size_t)st.st_size,PROT_READ,MAP_PRIVATE,fd,0);
+	close(fd);
+	if(p==MAP_FAILED)
+		return SF_READER_E_OPEN;
+	r->base=(const byte *)p;
+	r->size=(size_t)st.st_size;
+#endif
+	r->mapped=1;
+	return sf_reader_parse(r,0);
+}
+
+// kx_sound_font for KX_PROP_SOUNDFONT_LOAD (iKX::load_soundfont(fnt,1)): the header and the
+// pdta tables followed by KX_SOUNDFONT_MAGIC; the sample data is uploaded separately
+// (sf_reader_upload_samples()); fill-in header.sfman_xxx / subsynth before the call; free() it
+static inline kx_sound_font *sf_reader_build_font(const sf_reader *r)
+{
+	const sfHeader *h=&r->header;
+	kx_sound_font sf;
+
+	memset(&sf,0,sizeof(sf));
+	memcpy(&sf.header,h,sizeof(sfHeader));
+
+	// offsets
+	size_t size=0;
+	sf.presets=0;
+	size+=h->presets*sizeof(sfPresetHeader);
+	sf.preset_bags=(sfModGenBag *)size;
+	size+=h->preset_bags*sizeof(sfModGenBag);
+	sf.pmodlists=(sfModList *)size;
+	size+=h->pmodlists*sizeof(sfModList);
+	sf.pgenlists=(sfGenList *)size;
+	size+=h->pgenlists*sizeof(sfGenList);
+	sf.insts=(sfInst *)size;
+	size+=h->insts*sizeof(sfInst);
+	sf.inst_bags=(sfModGenBag *)size;
+	size+=h->inst_bags*sizeof(sfModGenBag);
+	sf.imodlists=(sfModList *)size;
+	size+=h->imodlists*sizeof(sfModList);
+	sf.igenlists=(sfGenList *)size;
+	size+=h->igenlists*sizeof(sfGenList);
+	sf.samples=(sfSample *)size;
+	size+=h->samples*sizeof(sfSample);
+	sf.sample_data=(short *)size;
+
+	// as iKX::load_soundfont(): 'size' includes the sample data and the magic
+	size_t mem_size=sizeof(sf)+size+4;
+	sf.size=(dword)(mem_size+h->sample_len);
+
+	byte *mem=(byte *)malloc(mem_size);
+	if(mem==NULL)
+		return NULL;
+	memcpy(mem,&sf,sizeof(sf));
+
+	byte *p=mem+sizeof(sf)-1; // kx_sound_font.data
+	#define sf_add(table,count,type) if(count) { memcpy(p,table,(count)*sizeof(type)); p+=(count)*sizeof(type); }
+	sf_add(r->presets,h->presets,sfPresetHeader);
+	sf_add(r->preset_bags,h->preset_bags,sfModGenBag);
+	sf_add(r->pmodlists,h->pmodlists,sfModList);
+	sf_add(r->pgenlists,h->pgenlists,sfGenList);
+	sf_add(r->insts,h->insts,sfInst);
+	sf_add(r->inst_bags,h->inst_bags,sfModGenBag);
+	sf_add(r->imodlists,h->imodlists,sfModList);
+	sf_add(r->igenlists,h->igenlists,sfGenList);
+	sf_add(r->samples,h->samples,sfSample);
+	#undef sf_add
+
+	dword magic=KX_SOUNDFONT_MAGIC;
+	memcpy(p,&magic,4);
+
+	return (kx_sound_font *)mem;
+}
+
+// KX_PROP_SOUNDFONT_LOAD_SMPL blocks: header.sample_len+4 bytes (the sample data and
+// KX_SOUNDFONT_MAGIC) are sent in blocks of 'chunk' bytes (up to KX_SF_UPLOAD_CHUNK), each starting
+// at a multiple of 'chunk'; 'send' gets the block and its size (header included) and returns 0 on success;
+// the block is at least sizeof(sf_load_sample_property) long
+typedef int (*sf_reader_send_func)(void *context,sf_load_sample_property *block,int block_size);
+
+static inline int sf_reader_upload_samples(const sf_reader *r,int id,int chunk,sf_reader_send_func send,void *context)
+{
+	const size_t header_size=offsetof(sf_load_sample_property,data);
+	if(chunk<=0 || chunk>KX_SF_UPLOAD_CHUNK)
+		chunk=KX_SF_UPLOAD_CHUNK;
+	size_t alloc=header_size+chunk;
+	if(alloc<sizeof(sf_load_sample_property))
+		alloc=sizeof(sf_load_sample_property);
+	sf_load_sample_property *block=(sf_load_sample_property *)malloc(alloc);
+	if(block==NULL)
+		return SF_READER_E_MEMORY;
+
+	const int sample_len=r->sample_data?r->header.sample_len:0;
+	const int total=sample_len+4;
+	dword magic=KX_SOUNDFONT_MAGIC;
+	int ret=0;
+
+	for(int pos=0;pos<total && ret==0;pos+=chunk)
+	{
+		int size=(total-pos<chunk)?total-pos:chunk;
+		int data=(sample_len-pos<size)?sample_len-pos:size;
+		if(data<0)
+			data=0;
+
+		block->id=id;
+		block->size=size;
+		block->pos=pos;
+		if(data)
+			memcpy(block->data,r->sample_data+pos,data);
+		for(int i=data;i<size;i++)
+			block->data[i]=((const char *)&magic)[pos+i-sample_len];
+
+		ret=send(context,block,(int)header_size+size);
+	}
+
+	free(block);
+	return ret;
+}
+
+#endif
@@ -142,6 +142,8 @@ typedef struct
  dword sfman_id;
  char sfman_file_name[256];
  int subsynth; // 0-both; 1-Synth1, 2-Synth2
+
+ int sample_shared; // enum_soundfonts(): bytes of sample data shared with the SoundFonts loaded earlier (stored once)
 }sfHeader;
 #pragma pack()
 
@@ -185,9 +187,13 @@ typedef struct	// upload sample data page by page
  int id;
  int size;
  int pos;
- char data[4096-12];
+ char data[4096-12];	// up to KX_SF_UPLOAD_CHUNK bytes: the property is offsetof(data)+size bytes long
 }sf_load_sample_property;
 
+// largest KX_PROP_SOUNDFONT_LOAD_SMPL block, bytes of sample data (KX_DWORD_SF_UPLOAD_CHUNK);
+// the drivers that do not report it take whole sf_load_sample_property blocks (see iKX::sf_upload_chunk())
+#define KX_SF_UPLOAD_CHUNK	(64*1024)
+
 #define VIENNA_DYNAMIC 256
 
 #endif
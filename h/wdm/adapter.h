@@ -39,6 +39,10 @@ DECLARE_INTERFACE_(IAdapterCommon,IUnknown)
 
 typedef IAdapterCommon *PADAPTERCOMMON;
 
+// the device extension of the FDO: PortCls' part, then the adapter (see wdm_AddDevice())
+#define KX_DEVICE_EXTENSION_SIZE (PORT_CLASS_DEVICE_EXTENSION_SIZE+sizeof(void *))
+#define adapter_from_device(device) (*(class CAdapterCommon **)((PUCHAR)(device)->DeviceExtension+PORT_CLASS_DEVICE_EXTENSION_SIZE))
+
 
 NTSTATUS NewAdapterCommon(
     OUT     PUNKNOWN *  Unknown,
@@ -105,6 +109,31 @@ public:
     UNICODE_STRING gsif_device;
     CGSIFInterface *gsif_interface;
 
+    // kx_callbacks::queue_work() items that have not completed yet (see adapter.cpp: flush_work_func())
+    KSPIN_LOCK work_lock;
+    int work_pending;
+    KEVENT work_idle;       // signaled while work_pending==0
+
+    // DSP telemetry page and its user-mode mappings, one per client handle (see property.cpp: KX_PROP_TELEMETRY)
+    kx_telemetry_page *telemetry_page;
+    FAST_MUTEX telemetry_mutex;
+    #define MAX_TELEMETRY_MAPPINGS 16
+    struct
+    {
+     PFILE_OBJECT file;     // released with KX_TELEMETRY_UNMAP or, at the latest, in IRP_MJ_CLEANUP
+     PEPROCESS process;     // referenced: the mapping can only be removed in its address space
+     PMDL mdl;
+     void *addr;
+     int refs;
+    }telemetry_map[MAX_TELEMETRY_MAPPINGS];
+
+    kx_telemetry_page *map_telemetry(PFILE_OBJECT file);
+    int unmap_telemetry(PFILE_OBJECT file);
+    void release_telemetry(int slot);
+
+    // IRP_MJ_CLEANUP of a client handle (see wdm.cpp), also when the client process was killed
+    void cleanup_file(PFILE_OBJECT file);
+
     /*****************************************************************************
      * IAdapterCommon methods
      */
@@ -33,11 +33,35 @@ iKX::iKX()
     is_10k2=(dword)-1;
     device_num=-1;
     device_name[0]=0;
+
+    reg_queue_n=0;
+    reg_queue_pgm=-1;
+    reg_queue_depth=0;
+    reg_queue_missing=0;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr,PTHREAD_MUTEX_RECURSIVE); // same as a CRITICAL_SECTION
+    pthread_mutex_init(&reg_queue_lock,&attr);
+    pthread_mutexattr_destroy(&attr);
+
+    telemetry=NULL;
 }
 
 iKX::~iKX()
 {
     close();
+    pthread_mutex_destroy(&reg_queue_lock);
+}
+
+void iKX::lock_reg_queue()
+{
+    pthread_mutex_lock(&reg_queue_lock);
+}
+
+void iKX::unlock_reg_queue()
+{
+    pthread_mutex_unlock(&reg_queue_lock);
 }
 
 int iKX::init(int id)
@@ -111,8 +135,49 @@ int iKX::init(int id)
 }
 
 
+const kx_telemetry_page *iKX::map_telemetry()
+{
+	if(telemetry==NULL && connect)
+	{
+#if MAC_OS_X_VERSION_MIN_REQUIRED <= MAC_OS_X_VERSION_10_4
+		vm_address_t addr=0;
+		vm_size_t size=0;
+		kern_return_t ret=IOConnectMapMemory(connect,kTelemetryMemory,mach_task_self(),&addr,&size,kIOMapAnywhere);
+#else
+		mach_vm_address_t addr=0;
+		mach_vm_size_t size=0;
+		kern_return_t ret=IOConnectMapMemory64(connect,kTelemetryMemory,mach_task_self(),&addr,&size,kIOMapAnywhere);
+#endif
+		if(ret==KERN_SUCCESS)
+		{
+			telemetry=(kx_telemetry_page *)(uintptr_t)addr;
+			if(size<sizeof(kx_telemetry_page) || telemetry->magic!=KX_TELEMETRY_MAGIC || telemetry->size!=sizeof(kx_telemetry_page))
+			{
+				debug("iKX: incompatible telemetry page\n");
+				unmap_telemetry();
+			}
+		}
+	}
+	return telemetry;
+}
+
+void iKX::unmap_telemetry()
+{
+	if(telemetry && connect)
+	{
+#if MAC_OS_X_VERSION_MIN_REQUIRED <= MAC_OS_X_VERSION_10_4
+		IOConnectUnmapMemory(connect,kTelemetryMemory,mach_task_self(),(vm_address_t)(uintptr_t)telemetry);
+#else
+		IOConnectUnmapMemory64(connect,kTelemetryMemory,mach_task_self(),(mach_vm_address_t)(uintptr_t)telemetry);
+#endif
+	}
+	telemetry=NULL;
+}
+
 int iKX::close(void)
 {
+	unmap_telemetry();
+	
 	// send userClose
 	if(connect)
 	{
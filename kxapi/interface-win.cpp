@@ -106,11 +106,30 @@ iKX::iKX()
         memset(asio_mem_table,0,sizeof(asio_mem_table));
 
         asio_notification=0;
+
+        reg_queue_n=0;
+        reg_queue_pgm=-1;
+        reg_queue_depth=0;
+        reg_queue_missing=0;
+        InitializeCriticalSection(&reg_queue_lock);
+
+        telemetry=NULL;
 }
 
 iKX::~iKX()
 {
     close();
+    DeleteCriticalSection(&reg_queue_lock);
+}
+
+void iKX::lock_reg_queue()
+{
+    EnterCriticalSection(&reg_queue_lock);
+}
+
+void iKX::unlock_reg_queue()
+{
+    LeaveCriticalSection(&reg_queue_lock);
 }
 
 int iKX::init_winmm()
@@ -556,6 +575,29 @@ int iKX::init(int device,int ignore_winmm)
     return ret;
 }
 
+const kx_telemetry_page *iKX::map_telemetry()
+{
+ if(telemetry==NULL)
+ {
+  telemetry_property p;
+  memset(&p,0,sizeof(p));
+  p.cmd=KX_TELEMETRY_MAP;
+  int ret_b;
+  if(ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_TELEMETRY,&p,sizeof(p),&ret_b)==0 && p.ret==0 && p.page)
+  {
+   telemetry=p.page;
+   if(telemetry->magic!=KX_TELEMETRY_MAGIC || telemetry->size!=sizeof(kx_telemetry_page))
+   {
+    debug("iKX: incompatible telemetry page\n");
+    p.cmd=KX_TELEMETRY_UNMAP;
+    ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_TELEMETRY,&p,sizeof(p),&ret_b);
+    telemetry=NULL;
+   }
+  }
+ }
+ return telemetry;
+}
+
 int iKX::close()
 {
  if(asio_inited)
@@ -583,6 +625,17 @@ int iKX::close()
   }
  }
 
+ // the mapping should be released by the same process
+ if(telemetry && hTopo)
+ {
+  telemetry_property p;
+  memset(&p,0,sizeof(p));
+  p.cmd=KX_TELEMETRY_UNMAP;
+  int ret_b;
+  ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_TELEMETRY,&p,sizeof(p),&ret_b);
+ }
+ telemetry=NULL;
+
  if(hWave)
   CloseHandle((HANDLE)hWave);
  hWave=0;
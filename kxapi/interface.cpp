@@ -380,6 +380,15 @@ int iKX::set_send_amount(int ndx, byte amount)
 
 int iKX::set_dsp_register(int pgm,const char *name,dword val)
 {
+    lock_reg_queue();
+    if(reg_queue_depth && pgm==reg_queue_pgm)
+    {
+     int ret=queue_dsp_register(pgm,name,0,val);
+     unlock_reg_queue();
+     return ret;
+    }
+    unlock_reg_queue();
+
     dsp_register_property p;
     strncpy(p.name,name,MAX_GPR_NAME);
     p.val=val;
@@ -393,6 +402,8 @@ int iKX::set_dsp_register(int pgm,const char *name,dword val)
 
 int iKX::get_dsp_register(int pgm,const char *name,dword *val)
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
     strncpy(p.name,name,MAX_GPR_NAME);
     p.pgm=pgm;
@@ -407,6 +418,8 @@ int iKX::get_dsp_register(int pgm,const char *name,dword *val)
 
 int iKX::set_tram_addr(int pgm,const char *name,dword addr) // addr is _logical_
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
     strncpy(p.name,name,MAX_GPR_NAME);
     p.val=addr;
@@ -420,6 +433,8 @@ int iKX::set_tram_addr(int pgm,const char *name,dword addr) // addr is _logical_
 
 int iKX::get_tram_addr(int pgm,const char *name,dword *addr)
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
     strncpy(p.name,name,MAX_GPR_NAME);
     p.pgm=pgm;
@@ -434,6 +449,8 @@ int iKX::get_tram_addr(int pgm,const char *name,dword *addr)
 
 int iKX::set_tram_flag(int pgm,const char *name,dword flag) // flag is TRAM_READ || TRAM_WRITE
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
     strncpy(p.name,name,MAX_GPR_NAME);
     p.val=flag;
@@ -447,6 +464,8 @@ int iKX::set_tram_flag(int pgm,const char *name,dword flag) // flag is TRAM_READ
 
 int iKX::get_tram_flag(int pgm,const char *name,dword *flag)
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
     strncpy(p.name,name,MAX_GPR_NAME);
     p.pgm=pgm;
@@ -461,6 +480,8 @@ int iKX::get_tram_flag(int pgm,const char *name,dword *flag)
 
 int iKX::set_tram_addr(int pgm,word id,dword addr) // addr is _logical_
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
         p.id=id;
     p.val=addr;
@@ -474,6 +495,8 @@ int iKX::set_tram_addr(int pgm,word id,dword addr) // addr is _logical_
 
 int iKX::get_tram_addr(int pgm,word id,dword *addr)
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
         p.id=id;
     p.pgm=pgm;
@@ -488,6 +511,8 @@ int iKX::get_tram_addr(int pgm,word id,dword *addr)
 
 int iKX::set_tram_flag(int pgm,word id,dword flag) // flag is TRAM_READ || TRAM_WRITE
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
         p.id=id;
     p.val=flag;
@@ -501,6 +526,8 @@ int iKX::set_tram_flag(int pgm,word id,dword flag) // flag is TRAM_READ || TRAM_
 
 int iKX::get_tram_flag(int pgm,word id,dword *flag)
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
     p.pgm=pgm;
     p.id=id;
@@ -515,6 +542,8 @@ int iKX::get_tram_flag(int pgm,word id,dword *flag)
 
 int iKX::write_instruction(int pgm,int offset,word op,word z,word w,word x,word y,int valid)
 {
+    sync_dsp_registers(pgm);
+
     dsp_instruction_property p;
     p.pgm=pgm;
     p.offset=offset;
@@ -529,6 +558,8 @@ int iKX::write_instruction(int pgm,int offset,word op,word z,word w,word x,word
 
 int iKX::read_instruction(int pgm,int offset,word *op,word *z,word *w,word *x,word *y)
 {
+    sync_dsp_registers(pgm);
+
     dsp_instruction_property p;
     p.pgm=pgm;
     p.offset=offset;
@@ -548,6 +579,15 @@ int iKX::read_instruction(int pgm,int offset,word *op,word *z,word *w,word *x,wo
 
 int iKX::set_dsp_register(int pgm,word id,dword val)
 {
+    lock_reg_queue();
+    if(reg_queue_depth && pgm==reg_queue_pgm)
+    {
+     int ret=queue_dsp_register(pgm,NULL,id,val);
+     unlock_reg_queue();
+     return ret;
+    }
+    unlock_reg_queue();
+
     dsp_register_property p;
     p.id=id;
     p.val=val;
@@ -561,6 +601,8 @@ int iKX::set_dsp_register(int pgm,word id,dword val)
 
 int iKX::get_dsp_register(int pgm,word id,dword *val)
 {
+    sync_dsp_registers(pgm);
+
     dsp_register_property p;
     p.id=id;
     p.pgm=pgm;
@@ -572,6 +614,123 @@ int iKX::get_dsp_register(int pgm,word id,dword *val)
         return 0;
 }
 
+static int dsp_registers(iKX *ikx,int cmd,int pgm,kx_reg_update *regs,int n)
+{
+    if(n<=0)
+     return 0;
+
+    int max_n=n<KX_MAX_DSP_REGISTERS?n:KX_MAX_DSP_REGISTERS;
+    dsp_registers_property *p=(dsp_registers_property *)api_alloc(sizeof(dsp_registers_property)+max_n*sizeof(kx_reg_update));
+    if(p==NULL)
+     return -2;
+
+    int ret=0;
+    for(int done=0;done<n;done+=max_n)
+    {
+     int cnt=n-done;
+     if(cnt>max_n)
+      cnt=max_n;
+     p->pgm=pgm;
+     p->n=cnt;
+     p->cmd=cmd;
+     p->ret=0;
+     memcpy(&p[1],&regs[done],cnt*sizeof(kx_reg_update));
+
+     int ret_b=0;
+     if(ikx->ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_DSP_REGISTERS,p,(int)(sizeof(dsp_registers_property)+cnt*sizeof(kx_reg_update)),&ret_b) || p->ret<0)
+     {
+      ret=-1;
+      break;
+     }
+     if(cmd==KX_DSP_REGISTERS_GET)
+      memcpy(&regs[done],&p[1],cnt*sizeof(kx_reg_update));
+     ret+=p->ret;
+    }
+    api_free(p);
+    return ret;
+}
+
+int iKX::set_dsp_registers(int pgm,const kx_reg_update *regs,int n)
+{
+    sync_dsp_registers(pgm); // keep the order of writes
+    return dsp_registers(this,KX_DSP_REGISTERS_SET,pgm,(kx_reg_update *)regs,n);
+}
+
+int iKX::get_dsp_registers(int pgm,kx_reg_update *regs,int n)
+{
+    sync_dsp_registers(pgm);
+    return dsp_registers(this,KX_DSP_REGISTERS_GET,pgm,regs,n);
+}
+
+int iKX::begin_dsp_registers(int pgm)
+{
+    lock_reg_queue();
+    if(pgm<=0 || (reg_queue_depth && pgm!=reg_queue_pgm))
+    {
+     unlock_reg_queue();
+     return -1;
+    }
+    if(reg_queue_depth++==0)
+    {
+     reg_queue_pgm=pgm;
+     reg_queue_n=0;
+     reg_queue_missing=0;
+    }
+    unlock_reg_queue();
+    return 0;
+}
+
+int iKX::end_dsp_registers()
+{
+    int ret=0;
+    lock_reg_queue();
+    if(reg_queue_depth && --reg_queue_depth==0)
+    {
+     flush_dsp_registers();
+     reg_queue_pgm=-1;
+     ret=reg_queue_missing;
+    }
+    unlock_reg_queue();
+    return ret;
+}
+
+void iKX::sync_dsp_registers(int pgm)
+{
+    lock_reg_queue();
+    if(reg_queue_n && pgm==reg_queue_pgm)
+     flush_dsp_registers();
+    unlock_reg_queue();
+}
+
+// queue_dsp_register() and flush_dsp_registers() are called with the queue locked
+int iKX::queue_dsp_register(int pgm,const char *name,word id,dword val)
+{
+    if(reg_queue_n==KX_REG_QUEUE)
+     flush_dsp_registers();
+
+    kx_reg_update *r=&reg_queue[reg_queue_n++];
+    memset(r->name,0,sizeof(r->name));
+    if(name)
+     strncpy(r->name,name,MAX_GPR_NAME);
+    r->id=id;
+    r->reserved=0;
+    r->val=val;
+    return 0;
+}
+
+int iKX::flush_dsp_registers()
+{
+    int ret=0;
+    if(reg_queue_n)
+    {
+     ret=dsp_registers(this,KX_DSP_REGISTERS_SET,reg_queue_pgm,reg_queue,reg_queue_n);
+     if(ret)
+      reg_queue_missing+=(ret>0)?ret:reg_queue_n;
+     reg_queue_n=0;
+    }
+    return ret;
+}
+
 int iKX::translate_microcode(int pgm,int place,int pos_pgm)
 {
     microcode_property p;
@@ -599,6 +758,62 @@ int iKX::dsp_go()
     return 0;
 }
 
+int iKX::dsp_compact(dword flags)
+{
+    microcode_property p;
+    p.cmd=KX_PROP_MICROCODE_DSP_COMPACT;
+    p.p1=flags;
+    p.p2=0;
+    p.pgm=0;
+    int ret_b=0;
+    int ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_MICROCODE,&p,sizeof(p),&ret_b);
+    if(ret)
+     return -1;
+    return p.cmd;
+}
+
+int iKX::dsp_begin()
+{
+    microcode_property p;
+    p.cmd=KX_PROP_MICROCODE_DSP_BEGIN;
+    p.p1=0;
+    p.p2=0;
+    p.pgm=0;
+    int ret_b=0;
+    int ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_MICROCODE,&p,sizeof(p),&ret_b);
+    if(ret)
+     return -1;
+    return p.cmd;
+}
+
+int iKX::dsp_commit()
+{
+    microcode_property p;
+    p.cmd=KX_PROP_MICROCODE_DSP_COMMIT;
+    p.p1=0;
+    p.p2=0;
+    p.pgm=0;
+    int ret_b=0;
+    int ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_MICROCODE,&p,sizeof(p),&ret_b);
+    if(ret)
+     return -1;
+    return p.cmd;
+}
+
+int iKX::dsp_abort()
+{
+    microcode_property p;
+    p.cmd=KX_PROP_MICROCODE_DSP_ABORT;
+    p.p1=0;
+    p.p2=0;
+    p.pgm=0;
+    int ret_b=0;
+    int ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_MICROCODE,&p,sizeof(p),&ret_b);
+    if(ret)
+     return -1;
+    return p.cmd;
+}
+
 int iKX::dsp_stop()
 {
     microcode_property p;
@@ -1009,6 +1224,30 @@ int iKX::reset_microcode(void)
 // SoundFont
 // ---------
 
+// the drivers that do not report KX_DWORD_SF_UPLOAD_CHUNK check for a whole sf_load_sample_property (Windows)
+// or take in-line requests only: 4096 bytes, 'prop' included (OS X)
+int iKX::sf_upload_chunk(int *fixed)
+{
+ dword chunk=0;
+ *fixed=0;
+ if(get_dword(KX_DWORD_SF_UPLOAD_CHUNK,&chunk)==0 && chunk>0)
+  return (chunk<KX_SF_UPLOAD_CHUNK)?(int)chunk:KX_SF_UPLOAD_CHUNK;
+#if defined(__APPLE__)
+ return 4096-(int)sizeof(dword)-(int)offsetof(sf_load_sample_property,data);
+#else
+ *fixed=1;
+ return (int)sizeof(((sf_load_sample_property *)0)->data);
+#endif
+}
+
+static sf_load_sample_property *alloc_sf_block(int chunk)
+{
+ size_t size=offsetof(sf_load_sample_property,data)+chunk;
+ if(size<sizeof(sf_load_sample_property))
+  size=sizeof(sf_load_sample_property);
+ return (sf_load_sample_property *)malloc(size);
+}
+
 int iKX::load_soundfont(kx_sound_font *fnt,int partial) // returns id or <0 -error
 {
  int ret;
@@ -1037,20 +1276,26 @@ int iKX::load_soundfont(kx_sound_font *fnt,int partial) // returns id or <0 -err
 
  if(!partial) 
  {
-  while(count>0)
+  int fixed;
+  int chunk=sf_upload_chunk(&fixed);
+  sf_load_sample_property *sf_l=alloc_sf_block(chunk);
+  if(sf_l==NULL)
+   return -11;
+
+  while(count>0 && ret==0)
   {
-   sf_load_sample_property sf_l;
-   int sfl_size=(count<(4096-12))?count:(4096-12);
-   sf_l.id=id;
-   sf_l.size=sfl_size;
-   sf_l.pos=pos;
-   memcpy(&sf_l.data[0],p,sf_l.size);
-   ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_SOUNDFONT_LOAD_SMPL,&sf_l,sizeof(sf_l),&ret_b);
+   int sfl_size=(count<chunk)?count:chunk;
+   sf_l->id=id;
+   sf_l->size=sfl_size;
+   sf_l->pos=pos;
+   memcpy(&sf_l->data[0],p,sfl_size);
+   ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_SOUNDFONT_LOAD_SMPL,sf_l,fixed?(int)sizeof(sf_load_sample_property):(int)offsetof(sf_load_sample_property,data)+sfl_size,&ret_b);
 
    count-=sfl_size;
    pos+=sfl_size;
    p+=sfl_size;
   }
+  free(sf_l);
  }
  if(ret==0) // all was ok
   ret=id;
@@ -1094,23 +1339,32 @@ int iKX::load_soundfont_x(kx_sound_font *fnt,const char *fname,long f_pos) // re
   int count=sample_len+4;
   int pos=0;
 
-  while(count>0)
+  int fixed;
+  int chunk=sf_upload_chunk(&fixed);
+  sf_load_sample_property *sf_l=alloc_sf_block(chunk);
+  if(sf_l==NULL)
   {
-   sf_load_sample_property sf_l;
-   int sfl_size=(count<(4096-12))?count:(4096-12);
-   sf_l.id=id;
-   sf_l.size=sfl_size;
-   sf_l.pos=pos;
+   fclose(f);
+   return -11;
+  }
 
-   char tmp_mem[4096-12];
-   fread(tmp_mem,4096-12,1,f);
+  while(count>0 && ret==0)
+  {
+   int sfl_size=(count<chunk)?count:chunk;
+   sf_l->id=id;
+   sf_l->size=sfl_size;
+   sf_l->pos=pos;
+
+   // note: the last 4 bytes are read from the file as well
+   memset(&sf_l->data[0],0,sfl_size);
+   fread(&sf_l->data[0],1,sfl_size,f);
 
-   memcpy(&sf_l.data[0],tmp_mem,sf_l.size);
-   ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_SOUNDFONT_LOAD_SMPL,&sf_l,sizeof(sf_l),&ret_b);
+   ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_SOUNDFONT_LOAD_SMPL,sf_l,fixed?(int)sizeof(sf_load_sample_property):(int)offsetof(sf_load_sample_property,data)+sfl_size,&ret_b);
 
    count-=sfl_size;
    pos+=sfl_size;
   }
+  free(sf_l);
 
  if(ret==0) // all was ok
   ret=id;
@@ -1151,6 +1405,56 @@ int iKX::get_spectral_info(kx_voice_info *vi)
  return ret;
 }
 
+int iKX::get_dsp_resources(kx_dsp_resources *res)
+{
+ int ret;
+ int ret_b;
+
+ ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_DSP_RESOURCES,res,sizeof(kx_dsp_resources),&ret_b);
+ return ret;
+}
+
+static int telemetry_request(iKX *ikx,telemetry_property *p)
+{
+ int ret_b;
+ if(ikx->ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_TELEMETRY,p,sizeof(telemetry_property),&ret_b))
+  return -1;
+ return p->ret;
+}
+
+int iKX::add_telemetry_tap(int pgm,const char *name,word flags)
+{
+ telemetry_property p;
+ memset(&p,0,sizeof(p));
+ p.cmd=KX_TELEMETRY_ADD_TAP;
+ p.pgm=pgm;
+ strncpy(p.name,name,MAX_GPR_NAME);
+ p.flags=flags;
+ if(p.name[0]==0)
+  return -1;
+ return telemetry_request(this,&p);
+}
+
+int iKX::add_telemetry_tap(int pgm,word id,word flags)
+{
+ telemetry_property p;
+ memset(&p,0,sizeof(p));
+ p.cmd=KX_TELEMETRY_ADD_TAP;
+ p.pgm=pgm;
+ p.id=id;
+ p.flags=flags;
+ return telemetry_request(this,&p);
+}
+
+int iKX::remove_telemetry_tap(int tap)
+{
+ telemetry_property p;
+ memset(&p,0,sizeof(p));
+ p.cmd=KX_TELEMETRY_REMOVE_TAP;
+ p.tap=tap;
+ return telemetry_request(this,&p);
+}
+
 int iKX::reset_settings()
 {
  int ret;
@@ -1304,6 +1608,19 @@ int iKX::send_synth(int synth_id,dword data)
         return 0;
 }
 
+int iKX::send_synth_at(int synth_id,dword time,dword data)
+{
+    kx_synth_event prop;
+    prop.synth_id=synth_id;
+    prop.time=time;
+    prop.data=data;
+    int ret_b=0;
+    int ret=ctrl(KX_TOPO|KX_PROP_GET|KX_PROP_SOUNDFONT_SYNTH_AT,&prop,sizeof(prop),&ret_b);
+    if(ret)
+     return ret;
+        return 0;
+}
+
 int iKX::get_connections(int pgm,kxconnections *out,int size)
 {
  int ret_b=0;
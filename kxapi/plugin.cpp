@@ -644,6 +644,16 @@ int iKXPlugin::get_dsp_register(const char *id,dword *val)
  return ikx->get_dsp_register(pgm_id,id,val);
 }
 
+int iKXPlugin::set_dsp_registers(const kx_reg_update *regs,int n)
+{
+ return ikx->set_dsp_registers(pgm_id,regs,n);
+}
+
+int iKXPlugin::get_dsp_registers(kx_reg_update *regs,int n)
+{
+ return ikx->get_dsp_registers(pgm_id,regs,n);
+}
+
 int iKXPlugin::set_tram_addr(word id,dword addr) // relative to itram_start
 {
  return ikx->set_tram_addr(pgm_id,id,addr);
@@ -718,6 +728,7 @@ int iKXPlugin::set_defaults() // resets GPRs to defaults; should call set_dsp_re
  int ret=0;
  if(info && pgm_id>0)
  {
+  ikx->begin_dsp_registers(pgm_id);
   for(dword i=0;i<info_size/sizeof(dsp_register_info);i++)
   {
    if((info[i].type&GPR_MASK)==GPR_CONTROL)
@@ -725,6 +736,7 @@ int iKXPlugin::set_defaults() // resets GPRs to defaults; should call set_dsp_re
     ret+=set_dsp_register(info[i].num,info[i].p);
    }
   }
+  ikx->end_dsp_registers();
  }
  return 0;
 }
@@ -786,8 +798,10 @@ int iKXPlugin::get_param(int ndx,kxparam_t *value)
 int iKXPlugin::set_all_params(kxparam_t *values) // at least [count]
 {
  int ret=0;
+ ikx->begin_dsp_registers(pgm_id);
  for(int i=0;i<get_param_count();i++)
   ret+=set_param(i,values[i]);
+ ikx->end_dsp_registers();
  return ret;
 }
 
@@ -1065,7 +1079,10 @@ int iKXPlugin::apply_preset(int ndx)
                {
                 if(value[cnt-1]!=0x12345678 && value[cnt]==0x87654321)
                 {
+                  // all the registers are sent with a single request
+                  ikx->begin_dsp_registers(pgm_id);
                   set_all_params(value);
+                  ikx->end_dsp_registers();
                   success=1;
                 }
                 else
@@ -1097,7 +1114,9 @@ int iKXPlugin::apply_preset(int ndx)
             {
                int num=get_param_count();
 
+               ikx->begin_dsp_registers(pgm_id);
                set_all_params((kxparam_t *)&t[(num+1)*(ndx-IKXPLUGIN_PRESETS_BUILTIN)+1]);
+               ikx->end_dsp_registers();
 
                success=1;
             }
@@ -0,0 +1,422 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// AC-3 decoder library (ac3/) outside of the driver: push-style decoding (ac3_feed) of many
+// independent streams on a thread pool, one ac3_state per stream
+// kxbench ac3dec [-threads <n>] [-chunk <bytes>] [<dir|file.ac3> ...]
+//     decodes the files (every file of a directory) with 1, 2, 4.. <n> threads (default: the
+//     number of processors): throughput per thread and scaling; the output of every stream
+//     must not depend on the number of threads
+//     without files: generated streams (ac3enc.cpp), checked against their source first
+// kxbench ac3dec -gen <dir> [<streams> [<seconds>]]   writes the generated streams
+//
+// POSIX systems: pthreads (link with -pthread); the ac3 library itself builds with any C compiler
+
+#include <math.h>
+
+#include "kxbench.h"
+
+extern "C" {
+#include "driver/ac3.h"
+}
+
+#if defined(WIN32)
+	#include <windows.h>
+#else
+	#include <pthread.h>
+	#include <dirent.h>
+	#include <unistd.h>
+#endif
+
+typedef struct
+{
+	char name[260];
+	byte *data;
+	int size;
+
+	// results of the last run
+	int frames,bad;
+	double seconds;			// of audio
+	dword checksum;
+	dword checksum_1;		// with one thread
+}ac3_stream;
+
+typedef struct
+{
+	ac3_stream *streams;
+	int count;
+	int chunk;				// bytes passed to ac3_feed() at a time
+	volatile long next;
+}ac3_pool;
+
+static long pool_next(ac3_pool *pool)
+{
+#if defined(WIN32)
+	return InterlockedIncrement(&pool->next)-1;
+#else
+	return __sync_fetch_and_add(&pool->next,1);
+#endif
+}
+
+typedef struct
+{
+	ac3_state state;
+	sint_16 pcm[6][6*256];
+}ac3_worker;
+
+static void decode_stream(ac3_stream *s,ac3_worker *w,int chunk,float *out)
+{
+	ac3_state *state=&w->state;
+	memset(state,0,sizeof(ac3_state));
+	state->left=w->pcm[0]; state->center=w->pcm[1]; state->right=w->pcm[2];
+	state->sleft=w->pcm[3]; state->sright=w->pcm[4]; state->subwoofer=w->pcm[5];
+	ac3_init(state);
+
+	s->frames=s->bad=0;
+	s->seconds=0;
+	dword sum=0x811c9dc5;
+
+	for(int pos=0;pos<s->size;)
+	{
+		int n=s->size-pos<chunk?s->size-pos:chunk;
+		int used=0;
+		int ret=ac3_feed(state,s->data+pos,n,&used);
+		pos+=used;
+		if(ret==0)
+			continue;
+		if(ret<0)
+		{
+			s->bad++;
+			continue;
+		}
+		for(int c=0;c<6;c++)
+		{
+			const sint_16 *p=w->pcm[c];
+			for(int i=0;i<6*256;i++)
+				sum=(sum^(word)p[i])*0x01000193;
+			if(out)
+				for(int i=0;i<6*256;i++)
+					out[((size_t)s->frames*6+c)*1536+i]=p[i]/32767.0f;
+		}
+		s->frames++;
+		s->seconds+=6*256/(double)state->sampling_rate;
+	}
+	s->checksum=sum;
+}
+
+#if defined(WIN32)
+static DWORD WINAPI pool_thread(LPVOID arg)
+#else
+static void *pool_thread(void *arg)
+#endif
+{
+	ac3_pool *pool=(ac3_pool *)arg;
+	ac3_worker *w=(ac3_worker *)malloc(sizeof(ac3_worker));
+	if(w)
+	{
+		long i;
+		while((i=pool_next(pool))<pool->count)
+			decode_stream(&pool->streams[i],w,pool->chunk,NULL);
+		free(w);
+	}
+	return 0;
+}
+
+// decodes all the streams with 'threads' threads; returns the time, seconds
+static double pool_run(ac3_pool *pool,int threads)
+{
+	pool->next=0;
+	double t0=bench_time();
+#if defined(WIN32)
+	HANDLE h[64];
+	for(int i=0;i<threads;i++)
+		h[i]=CreateThread(NULL,0,pool_thread,pool,0,NULL);
+	for(int i=0;i<threads;i++)
+		if(h[i])
+		{
+			WaitForSingleObject(h[i],INFINITE);
+			CloseHandle(h[i]);
+		}
+#else
+	pthread_t h[64];
+	for(int i=0;i<threads;i++)
+		pthread_create(&h[i],NULL,pool_thread,pool);
+	for(int i=0;i<threads;i++)
+		pthread_join(h[i],NULL);
+#endif
+	return bench_time()-t0;
+}
+
+static int processors(void)
+{
+#if defined(WIN32)
+	SYSTEM_INFO si;
+	GetSystemInfo(&si);
+	return (int)si.dwNumberOfProcessors;
+#else
+	long n=sysconf(_SC_NPROCESSORS_ONLN);
+	return n>0?(int)n:1;
+#endif
+}
+
+static int add_file(ac3_stream *streams,int *count,int max,const char *name)
+{
+	if(*count>=max)
+		return 0;
+	FILE *f=fopen(name,"rb");
+	if(!f)
+		return -1;
+	fseek(f,0,SEEK_END);
+	long size=ftell(f);
+	fseek(f,0,SEEK_SET);
+	ac3_stream *s=&streams[*count];
+	memset(s,0,sizeof(ac3_stream));
+	s->data=(byte *)malloc(size>0?size:1);
+	if(!s->data || fread(s->data,1,size,f)!=(size_t)size)
+	{
+		free(s->data);
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+	s->size=(int)size;
+	strncpy(s->name,name,sizeof(s->name)-1);
+	(*count)++;
+	return 0;
+}
+
+// a file, or all the files of a directory
+static int add_path(ac3_stream *streams,int *count,int max,const char *path)
+{
+	char name[260];
+#if defined(WIN32)
+	DWORD attr=GetFileAttributesA(path);
+	if(attr==INVALID_FILE_ATTRIBUTES || !(attr&FILE_ATTRIBUTE_DIRECTORY))
+		return add_file(streams,count,max,path);
+
+	WIN32_FIND_DATAA fd;
+	sprintf(name,"%.200s\\*",path);
+	HANDLE h=FindFirstFileA(name,&fd);
+	if(h==INVALID_HANDLE_VALUE)
+		return -1;
+	do
+	{
+		if(fd.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY)
+			continue;
+		sprintf(name,"%.200s\\%.50s",path,fd.cFileName);
+		add_file(streams,count,max,name);
+	}while(FindNextFileA(h,&fd));
+	FindClose(h);
+#else
+	DIR *d=opendir(path);
+	if(!d)
+		return add_file(streams,count,max,path);
+	struct dirent *e;
+	while((e=readdir(d))!=NULL)
+	{
+		if(e->d_name[0]=='.')
+			continue;
+		sprintf(name,"%.200s/%.50s",path,e->d_name);
+		add_file(streams,count,max,name);
+	}
+	closedir(d);
+#endif
+	return 0;
+}
+
+#define MAX_STREAMS		256
+#define GEN_STREAMS		16
+#define GEN_SECONDS		10
+
+// stream i: 5.1 at 448 kbps or 2/0 at 192 kbps
+static int generate(ac3_stream *s,int i,int seconds,float *ref)
+{
+	int acmod=(i&1)?2:7,lfeon=(i&1)?0:1,frmsizecod=(i&1)?20:30;
+	int frames=seconds*48000/1536;
+	s->data=(byte *)malloc(frames*3840);
+	if(!s->data)
+		return -1;
+	s->size=ac3_generate(s->data,frames,acmod,lfeon,frmsizecod,0x1234567+i*977,ref);
+	sprintf(s->name,"generated %d (%s)",i,acmod==7?"3/2+lfe":"2/0");
+	return s->size>0?0:-1;
+}
+
+// decoded output vs. the generator's source: SNR per channel
+// (ref: in the decoder's samples[] order; planar: the output channel of each)
+static const int planar_3_2_lfe[6]={ 0,1,2,3,4,5 };
+static const int planar_2_0[2]={ 0,2 };
+
+static int verify(ac3_stream *s,const float *ref,int frames,const int *planar,int channels)
+{
+	ac3_worker *w=(ac3_worker *)malloc(sizeof(ac3_worker));
+	float *out=(float *)calloc((size_t)frames*6*1536,sizeof(float));
+	if(!w || !out)
+	{
+		free(w); free(out);
+		return 1;
+	}
+	decode_stream(s,w,4096,out);
+
+	int errors=0;
+	printf("%-22s %d frames, %d bad, SNR:",s->name,s->frames,s->bad);
+	if(s->frames!=frames || s->bad)
+		errors++;
+	for(int c=0;c<channels;c++)
+	{
+		double sig=0,err=0;
+		for(int f=0;f<s->frames;f++)
+			for(int i=0;i<1536;i++)
+			{
+				size_t k=((size_t)f*6+c)*1536+i,o=((size_t)f*6+planar[c])*1536+i;
+				sig+=(double)ref[k]*ref[k];
+				err+=(double)(out[o]-ref[k])*(out[o]-ref[k]);
+			}
+		double snr=10.0*log10(sig/(err+1e-30));
+		printf(" %.1f",snr);
+		// ~30 dB: quantization noise at these bit rates; bitstream errors do not go above 10 dB
+		if(snr<20.0)
+			errors++;
+	}
+	printf(" dB\n");
+	free(w); free(out);
+	return errors;
+}
+
+static int write_streams(const char *dir,int count,int seconds)
+{
+	for(int i=0;i<count;i++)
+	{
+		ac3_stream s;
+		memset(&s,0,sizeof(s));
+		if(generate(&s,i,seconds,NULL))
+			return 1;
+		char name[260];
+		sprintf(name,"%.200s/stream%02d.ac3",dir,i);
+		FILE *f=fopen(name,"wb");
+		if(!f || fwrite(s.data,1,s.size,f)!=(size_t)s.size)
+		{
+			printf("cannot write '%s'\n",name);
+			if(f) fclose(f);
+			free(s.data);
+			return 1;
+		}
+		fclose(f);
+		free(s.data);
+	}
+	printf("%d streams (%d s) written to '%s'\n",count,seconds,dir);
+	return 0;
+}
+
+int bench_ac3dec(int argc,char **argv)
+{
+	if(argc>2 && strcmp(argv[1],"-gen")==0)
+		return write_streams(argv[2],argc>3?atoi(argv[3]):GEN_STREAMS,argc>4?atoi(argv[4]):GEN_SECONDS);
+
+	int max_threads=processors(),chunk=4096;
+	int errors=0;
+	ac3_stream *streams=(ac3_stream *)calloc(MAX_STREAMS,sizeof(ac3_stream));
+	int count=0;
+	if(!streams)
+		return 1;
+
+	for(int i=1;i<argc;i++)
+	{
+		if(strcmp(argv[i],"-threads")==0 && i+1<argc)
+			max_threads=atoi(argv[++i]);
+		else if(strcmp(argv[i],"-chunk")==0 && i+1<argc)
+			chunk=atoi(argv[++i]);
+		else if(add_path(streams,&count,MAX_STREAMS,argv[i]))
+			printf("cannot read '%s'\n",argv[i]);
+	}
+	if(max_threads<1) max_threads=1;
+	if(max_threads>64) max_threads=64;
+	if(chunk<1) chunk=1;
+
+	if(count==0)
+	{
+		// generated streams; the first 5.1 and 2/0 ones are checked against the source
+		for(int i=0;i<GEN_STREAMS;i++)
+		{
+			float *ref=NULL;
+			if(i<2)
+				ref=(float *)malloc((size_t)(GEN_SECONDS*48000/1536)*6*1536*sizeof(float));
+			if(generate(&streams[count],i,GEN_SECONDS,ref))
+			{
+				free(ref);
+				printf("cannot generate the streams\n");
+				return 1;
+			}
+			if(ref)
+			{
+				errors+=verify(&streams[count],ref,GEN_SECONDS*48000/1536,
+					i==0?planar_3_2_lfe:planar_2_0,i==0?6:2);
+				free(ref);
+			}
+			count++;
+		}
+		printf("\n");
+	}
+
+	printf("%d streams, %d bytes per ac3_feed() call, %d processors\n",count,chunk,processors());
+	printf("%8s %10s %10s %12s %12s %9s %11s\n","threads","frames/s","x realtime","frames/s/thr","x rt/thread","speedup","efficiency");
+
+	ac3_pool pool;
+	pool.streams=streams;
+	pool.count=count;
+	pool.chunk=chunk;
+
+	double fps_1=0;
+	for(int threads=1;;threads=(threads*2>max_threads && threads<max_threads)?max_threads:threads*2)
+	{
+		double t=pool_run(&pool,threads);
+		int frames=0,bad=0;
+		double seconds=0;
+		for(int i=0;i<count;i++)
+		{
+			frames+=streams[i].frames;
+			bad+=streams[i].bad;
+			seconds+=streams[i].seconds;
+			if(threads==1)
+				streams[i].checksum_1=streams[i].checksum;
+			else if(streams[i].checksum!=streams[i].checksum_1)
+			{
+				printf("!! %s: the output differs with %d threads\n",streams[i].name,threads);
+				errors++;
+			}
+		}
+		double fps=frames/t;
+		if(threads==1)
+		{
+			fps_1=fps;
+			if(bad)
+				printf("(%d bad frames)\n",bad);
+		}
+		printf("%8d %10.0f %10.1f %12.0f %12.1f %9.2f %10.0f%%\n",threads,fps,seconds/t,
+			fps/threads,seconds/t/threads,fps/fps_1,100.0*fps/fps_1/threads);
+
+		if(threads>=max_threads)
+			break;
+	}
+
+	for(int i=0;i<count;i++)
+		free(streams[i].data);
+	free(streams);
+	return errors;
+}
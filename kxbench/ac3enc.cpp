@@ -0,0 +1,510 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// AC-3 test streams for the decoder benchmarks (no .ac3 files needed)
+// a minimal encoder: the spectrum is synthesized directly (tones over a sloped noise floor),
+// long blocks only, D15 exponents sent in block 0 and reused, no coupling, no dither;
+// the SNR offset is the largest one that fits the frame (ac3/bit_allocate.c)
+
+#include <math.h>
+
+#include "kxbench.h"
+
+extern "C" {
+#include "driver/ac3.h"
+}
+
+#define ENC_CHBWCOD	46		// endmant 211: 19.8 kHz at 48 kHz
+
+static const int enc_nfchans[8] = {2,1,2,3,3,4,4,5};
+static const int enc_frame_words[38] = {
+	64, 64, 80, 80, 96, 96, 112, 112, 128, 128, 160, 160, 192, 192, 224, 224, 256, 256, 320, 320,
+	384, 384, 448, 448, 512, 512, 640, 640, 768, 768, 896, 896, 1024, 1024, 1152, 1152, 1280, 1280 };
+static const int enc_qnttz[16] = { 0, 0, 0, 3, 0, 4, 5, 6, 7, 8, 9, 10, 11, 12, 14, 16 };
+static const int enc_levels[6] = { 0, 3, 5, 7, 11, 15 };
+
+typedef struct
+{
+	byte *p;
+	int bits;
+	int limit;		// bits past the limit are counted, not written
+}bit_writer;
+
+static void put(bit_writer *w,int n,dword v)
+{
+	while(n>0)
+	{
+		int room=8-(w->bits&7),k=n<room?n:room;
+		if(w->bits<w->limit)
+			w->p[w->bits>>3]|=(byte)(((v>>(n-k))&((1<<k)-1))<<(room-k));
+		w->bits+=k;
+		n-=k;
+	}
+}
+
+static word crc16(const byte *p,int n)
+{
+	dword crc=0;
+	for(int i=0;i<n;i++)
+	{
+		crc^=(dword)p[i]<<8;
+		for(int b=0;b<8;b++)
+			crc=(crc&0x8000)?((crc<<1)^0x8005):(crc<<1);
+	}
+	return (word)crc;
+}
+
+// crc1 (bytes 2..3) makes the crc of the first 5/8 of the frame zero; the crc is linear
+// in crc1, so it is solved for over GF(2)
+static word solve_crc1(byte *frame,int words)
+{
+	int len=((words>>1)+(words>>3))*2-2;
+	frame[2]=frame[3]=0;
+	dword target=crc16(frame+2,len);
+
+	dword vec[16],comb[16],pivot[16];
+	int n=0;
+	for(int i=0;i<16;i++)
+	{
+		frame[2]=(byte)((1<<i)>>8); frame[3]=(byte)(1<<i);
+		dword v=crc16(frame+2,len)^target,m=1<<i;
+		for(int r=0;r<n;r++)
+			if(v&pivot[r])
+			{
+				v^=vec[r];
+				m^=comb[r];
+			}
+		if(v)
+		{
+			pivot[n]=1;
+			while(pivot[n]<=(v>>1))
+				pivot[n]<<=1;
+			vec[n]=v; comb[n++]=m;
+		}
+	}
+	dword c=0;
+	for(int r=0;r<n;r++)
+		if(target&pivot[r])
+		{
+			target^=vec[r];
+			c^=comb[r];
+		}
+	return (word)c;
+}
+
+static int exponent_of(float x)
+{
+	if(x==0.0f)
+		return 24;
+	int e;
+	frexp(x,&e);
+	e=-e;
+	return e<0?0:(e>24?24:e);
+}
+
+// mantissa (|m|<1) to a quantizer index (bap 1..5) or a two's complement value (bap 6..15)
+static int quantize(float m,int bap)
+{
+	if(bap<6)
+	{
+		int n=enc_levels[bap];
+		int k=(int)floor((m*n+(n-1))*0.5f+0.5f);
+		return k<0?0:(k>n-1?n-1:k);
+	}
+	int b=enc_qnttz[bap];
+	int q=(int)floor(m*(1<<(b-1))+0.5f);
+	if(q>(1<<(b-1))-1) q=(1<<(b-1))-1;
+	if(q<-(1<<(b-1))) q=-(1<<(b-1));
+	return q&((1<<b)-1);
+}
+
+typedef struct
+{
+	int acmod,lfeon,nfchans,nch;		// nch: nfchans+lfeon; the lfe is channel 5 in ac3_state
+	int frmsizecod,frame_bytes;
+	dword seed;
+	float tone_bin[6][4],tone_amp[6][4],tone_rate[6][4];
+	float floor[256];				// noise floor amplitude per bin
+	int block;						// blocks generated so far
+	int snr;						// SNR offset of the previous frame
+	float coef[6][6][256];			// [block][channel][bin]
+	ac3_state *ba;					// bit_allocate() scratch
+}encoder;
+
+static float enc_rand(encoder *e)
+{
+	e->seed^=e->seed<<13;
+	e->seed^=e->seed>>17;
+	e->seed^=e->seed<<5;
+	return (float)(e->seed&0xffffff)/(float)0x800000-1.0f;
+}
+
+static int channel_end(int ch)
+{
+	return ch==5?7:(ENC_CHBWCOD+12)*3+37;
+}
+
+// one frame of spectra: tones (a sinusoid's MDCT coefficients change sign from block to block)
+// over a noise floor falling by ~60 dB towards 20 kHz
+static void synthesize(encoder *e)
+{
+	for(int b=0;b<6;b++,e->block++)
+	{
+		for(int c=0;c<6;c++)
+		{
+			float *x=e->coef[b][c];
+			memset(x,0,sizeof(e->coef[b][c]));
+			if(c>=e->nfchans && c!=5)
+				continue;
+			if(c==5 && !e->lfeon)
+				continue;
+
+			int end=channel_end(c);
+			for(int k=0;k<end;k++)
+				x[k]=e->floor[k]*(enc_rand(e)+enc_rand(e));
+			for(int t=0;t<4;t++)
+			{
+				int k=(int)e->tone_bin[c][t];
+				float ph=e->tone_rate[c][t]*e->block;
+				float a=e->tone_amp[c][t]*(0.6f+0.4f*(float)sin(e->block*0.01+t));
+				x[k]+=a*(float)cos(ph);
+				if(k+1<end)
+					x[k+1]+=0.5f*a*(float)sin(ph);
+			}
+		}
+	}
+}
+
+// frame exponents: the smallest over the 6 blocks, with the D15 limits (difference within +-2,
+// first exponent <= 15)
+static void frame_exponents(encoder *e,int ch,uint_16 *exp)
+{
+	int end=channel_end(ch);
+	for(int k=0;k<end;k++)
+	{
+		int m=24;
+		for(int b=0;b<6;b++)
+		{
+			int x=exponent_of(e->coef[b][ch][k]);
+			if(x<m)
+				m=x;
+		}
+		exp[k]=(uint_16)m;
+	}
+	if(exp[0]>15)
+		exp[0]=15;
+	for(int k=1;k<end;k++)
+		if(exp[k]>exp[k-1]+2)
+			exp[k]=(uint_16)(exp[k-1]+2);
+	for(int k=end-2;k>=0;k--)
+		if(exp[k]>exp[k+1]+2)
+			exp[k]=(uint_16)(exp[k+1]+2);
+}
+
+static void write_exponents(bit_writer *w,const uint_16 *exp,int n)
+{
+	put(w,4,exp[0]);
+	for(int k=1;k<n;k+=3)
+		put(w,7,(exp[k]-exp[k-1]+2)*25+(exp[k+1]-exp[k]+2)*5+(exp[k+2]-exp[k+1]+2));
+}
+
+// mantissas of one block, in the decoder's order; the groups of the 3, 5 and 11-level
+// quantizers are sent with their first member and can span channels
+static void write_mantissas(encoder *e,bit_writer *w,int b)
+{
+	audblk_t *a=&e->ba->audblk;
+	int q[6*256],bap[6*256],n=0;
+	int list[6][6*256],len[6]={0};
+
+	for(int c=0;c<6;c++)
+	{
+		if((c>=e->nfchans && c!=5) || (c==5 && !e->lfeon))
+			continue;
+		int end=channel_end(c);
+		for(int k=0;k<end;k++)
+		{
+			int ba=c==5?a->lfe_bap[k]:a->fbw_bap[c][k];
+			int ex=c==5?a->lfe_exp[k]:a->fbw_exp[c][k];
+			bap[n]=ba;
+			q[n]=ba?quantize((float)ldexp(e->coef[b][c][k],ex),ba):0;
+			if(ba==1 || ba==2 || ba==4)
+				list[ba][len[ba]++]=q[n];
+			n++;
+		}
+	}
+
+	int used[6]={0};
+	for(int i=0;i<n;i++)
+	{
+		int ba=bap[i];
+		if(ba==0)
+			continue;
+		if(ba==1 || ba==2 || ba==4)
+		{
+			int size=ba==4?2:3;
+			if(used[ba]%size==0)
+			{
+				int v[3];
+				for(int j=0;j<size;j++)
+					v[j]=used[ba]+j<len[ba]?list[ba][used[ba]+j]:enc_levels[ba]/2;
+				int l=enc_levels[ba];
+				if(size==2)
+					put(w,7,v[0]*l+v[1]);
+				else
+					put(w,ba==1?5:7,(v[0]*l+v[1])*l+v[2]);
+			}
+			used[ba]++;
+		}
+		else if(ba==3 || ba==5)
+			put(w,ba==3?3:4,q[i]);
+		else
+			put(w,enc_qnttz[ba],q[i]);
+	}
+}
+
+// returns the number of bits used (the last 16 bits of the frame are crc2)
+static int write_frame(encoder *e,byte *frame,int csnr,int fsnr)
+{
+	audblk_t *a=&e->ba->audblk;
+
+	memset(frame,0,e->frame_bytes);
+	bit_writer w={frame,0,(e->frame_bytes-2)*8};
+
+	put(&w,16,0x0b77);
+	put(&w,16,0);						// crc1
+	put(&w,2,0);						// fscod: 48 kHz
+	put(&w,6,e->frmsizecod);
+
+	// bsi
+	put(&w,5,8); put(&w,3,0); put(&w,3,e->acmod);
+	if((e->acmod&1) && e->acmod!=1) put(&w,2,0);
+	if(e->acmod&4) put(&w,2,0);
+	if(e->acmod==2) put(&w,2,0);
+	put(&w,1,e->lfeon);
+	put(&w,5,27);						// dialnorm
+	put(&w,1,0); put(&w,1,0); put(&w,1,0);	// compre, langcode, audprodie
+	put(&w,1,0); put(&w,1,1);			// copyrightb, origbs
+	put(&w,1,0); put(&w,1,0); put(&w,1,0);	// timecod1e, timecod2e, addbsie
+
+	for(int b=0;b<6;b++)
+	{
+		int first=(b==0);
+		put(&w,e->nfchans,0);			// blksw
+		put(&w,e->nfchans,0);			// dithflag
+		put(&w,1,0);					// dynrnge
+		put(&w,1,first);				// cplstre
+		if(first)
+			put(&w,1,0);				// cplinu
+		if(e->acmod==2)
+		{
+			put(&w,1,first);			// rematstr
+			if(first)
+				put(&w,4,0);
+		}
+		for(int c=0;c<e->nfchans;c++)
+			put(&w,2,first?EXP_D15:EXP_REUSE);
+		if(e->lfeon)
+			put(&w,1,first);
+		if(first)
+		{
+			for(int c=0;c<e->nfchans;c++)
+				put(&w,6,ENC_CHBWCOD);
+			for(int c=0;c<e->nfchans;c++)
+			{
+				write_exponents(&w,a->fbw_exp[c],a->endmant[c]);
+				put(&w,2,0);			// gainrng
+			}
+			if(e->lfeon)
+				write_exponents(&w,a->lfe_exp,7);
+		}
+		put(&w,1,first);				// baie
+		if(first)
+		{
+			put(&w,2,a->sdcycod); put(&w,2,a->fdcycod); put(&w,2,a->sgaincod);
+			put(&w,2,a->dbpbcod); put(&w,3,a->floorcod);
+		}
+		put(&w,1,first);				// snroffste
+		if(first)
+		{
+			put(&w,6,csnr);
+			for(int c=0;c<e->nch;c++)
+			{
+				put(&w,4,fsnr);
+				put(&w,3,c<e->nfchans?a->fgaincod[c]:a->lfefgaincod);
+			}
+		}
+		put(&w,1,0);					// deltbaie
+		put(&w,1,0);					// skiple
+
+		write_mantissas(e,&w,b);
+	}
+	return w.bits;
+}
+
+static void allocate(encoder *e,int csnr,int fsnr)
+{
+	audblk_t *a=&e->ba->audblk;
+	a->csnroffst=(uint_16)csnr;
+	for(int c=0;c<5;c++)
+		a->fsnroffst[c]=(uint_16)(c<e->nfchans?fsnr:0);
+	a->lfefsnroffst=(uint_16)(e->lfeon?fsnr:0);
+	bit_allocate(0,&e->ba->bsi,a,e->ba);
+}
+
+#define SNR_MAX		(63*16+15)
+
+// allocates and writes the frame with the SNR offset csnroffst:fsnroffst (v>>4:v&15)
+static bool fits(encoder *e,byte *frame,int v)
+{
+	allocate(e,v>>4,v&15);
+	return write_frame(e,frame,v>>4,v&15)<=(e->frame_bytes-2)*8;
+}
+
+// ---- public
+
+int ac3_generate(unsigned char *out,int frames,int acmod,int lfeon,int frmsizecod,dword seed,float *ref)
+{
+	encoder *e=(encoder *)calloc(1,sizeof(encoder));
+	ac3_state *ba=(ac3_state *)calloc(1,sizeof(ac3_state));
+	ac3_state *ir=ref?(ac3_state *)calloc(1,sizeof(ac3_state)):NULL;
+	if(!e || !ba || (ref && !ir))
+	{
+		free(e); free(ba); free(ir);
+		return -1;
+	}
+
+	e->acmod=acmod;
+	e->lfeon=lfeon;
+	e->nfchans=enc_nfchans[acmod];
+	e->nch=e->nfchans+lfeon;
+	e->frmsizecod=frmsizecod;
+	e->frame_bytes=enc_frame_words[frmsizecod]*2;
+	e->seed=seed|1;
+	e->snr=SNR_MAX/2;
+	for(int k=0;k<256;k++)
+		e->floor[k]=0.002f*(float)exp(-k/30.0);
+	e->ba=ba;
+	for(int c=0;c<6;c++)
+		for(int t=0;t<4;t++)
+		{
+			// enc_rand(): -1..1
+			e->tone_bin[c][t]=c==5?(float)(1+t%3):(float)(3+(int)(75.0f*(enc_rand(e)+1.0f)));
+			e->tone_amp[c][t]=0.05f+0.03f*enc_rand(e);
+			e->tone_rate[c][t]=1.6f+1.4f*enc_rand(e);
+		}
+
+	bsi_t *bsi=&ba->bsi;
+	audblk_t *a=&ba->audblk;
+	bsi->acmod=(uint_16)acmod;
+	bsi->nfchans=(uint_16)e->nfchans;
+	bsi->lfeon=(uint_16)lfeon;
+	a->sdcycod=2; a->fdcycod=1; a->sgaincod=1; a->dbpbcod=2; a->floorcod=4;
+	a->baie=1; a->snroffste=1;
+	for(int c=0;c<5;c++)
+	{
+		a->chexpstr[c]=(uint_16)(c<e->nfchans?EXP_D15:EXP_REUSE);
+		a->endmant[c]=(uint_16)channel_end(c);
+		a->fgaincod[c]=4;
+	}
+	a->lfeexpstr=(uint_16)lfeon;
+	a->lfefgaincod=4;
+
+	if(ir)
+	{
+		imdct_init(ir);
+		ir->bsi=*bsi;
+	}
+
+	for(int f=0;f<frames;f++)
+	{
+		byte *frame=out+f*e->frame_bytes;
+
+		synthesize(e);
+		for(int c=0;c<e->nfchans;c++)
+			frame_exponents(e,c,a->fbw_exp[c]);
+		if(lfeon)
+			frame_exponents(e,5,a->lfe_exp);
+
+		// largest SNR offset (csnroffst:fsnroffst) that fits: a search around the
+		// previous frame's one
+		int lo=e->snr,hi,step=1;
+		if(fits(e,frame,lo))
+		{
+			hi=SNR_MAX;
+			while(lo<hi)
+			{
+				int p=lo+step<hi?lo+step:hi;
+				if(!fits(e,frame,p))
+				{
+					hi=p-1;
+					break;
+				}
+				lo=p;
+				step<<=1;
+			}
+		}
+		else
+		{
+			hi=lo-1;
+			lo=0;
+			while(lo<hi)
+			{
+				int p=hi-step+1>lo?hi-step+1:lo;
+				if(fits(e,frame,p))
+				{
+					lo=p;
+					break;
+				}
+				hi=p-1;
+				step<<=1;
+			}
+		}
+		while(lo<hi)
+		{
+			int mid=(lo+hi+1)/2;
+			if(fits(e,frame,mid))
+				lo=mid;
+			else
+				hi=mid-1;
+		}
+		e->snr=lo;
+		fits(e,frame,lo);
+
+		word crc1=solve_crc1(frame,e->frame_bytes/2);
+		frame[2]=(byte)(crc1>>8); frame[3]=(byte)crc1;
+		word crc2=crc16(frame+2,e->frame_bytes-4);
+		frame[e->frame_bytes-2]=(byte)(crc2>>8); frame[e->frame_bytes-1]=(byte)crc2;
+
+		// reference output: the unquantized spectra through the decoder's transform
+		if(ir)
+		{
+			for(int b=0;b<6;b++)
+			{
+				memcpy(ir->samples,e->coef[b],sizeof(ir->samples));
+				imdct(ir,&ir->bsi,&ir->audblk,ir->samples);
+				for(int c=0;c<6;c++)
+					memcpy(ref+((size_t)f*6+c)*1536+b*256,ir->samples[c],256*sizeof(float));
+			}
+		}
+	}
+
+	free(e); free(ba); free(ir);
+	return frames*enc_frame_words[frmsizecod]*2;
+}
@@ -0,0 +1,695 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// AC-3 IMDCT (ac3/imdct.c): previous radix-2 transform with static buffers vs. split-radix
+// transform with the state in ac3_state
+// kxbench ac3imdct                  accuracy and transform speed (random coefficients)
+// kxbench ac3imdct <file.ac3>       decodes the file with both transforms: frames/s, differences
+// kxbench ac3imdct -tables <file>   writes the constant tables (ac3/imdcttbl.h)
+
+#include <math.h>
+
+#include "kxbench.h"
+
+extern "C" {
+#include "driver/ac3.h"
+
+// ac3ref.c: ac3/decode.c built with the previous transform
+void __stdcall ac3_init_ref(ac3_state *state);
+int __stdcall ac3_decode_frame_ref(ac3_state *state);
+void imdct_ref(ac3_state *state,bsi_t *bsi,audblk_t *audblk,stream_samples_t samples);
+void imdct_init_ref(ac3_state *state);
+}
+
+#ifndef M_PI
+ #define M_PI 3.14159265358979323846
+#endif
+
+// Windowing function for Modified DCT - Thank you acroread
+static const float window[] = {
+	0.00014f, 0.00024f, 0.00037f, 0.00051f, 0.00067f, 0.00086f, 0.00107f, 0.00130f,
+	0.00157f, 0.00187f, 0.00220f, 0.00256f, 0.00297f, 0.00341f, 0.00390f, 0.00443f,
+	0.00501f, 0.00564f, 0.00632f, 0.00706f, 0.00785f, 0.00871f, 0.00962f, 0.01061f,
+	0.01166f, 0.01279f, 0.01399f, 0.01526f, 0.01662f, 0.01806f, 0.01959f, 0.02121f,
+	0.02292f, 0.02472f, 0.02662f, 0.02863f, 0.03073f, 0.03294f, 0.03527f, 0.03770f,
+	0.04025f, 0.04292f, 0.04571f, 0.04862f, 0.05165f, 0.05481f, 0.05810f, 0.06153f,
+	0.06508f, 0.06878f, 0.07261f, 0.07658f, 0.08069f, 0.08495f, 0.08935f, 0.09389f,
+	0.09859f, 0.10343f, 0.10842f, 0.11356f, 0.11885f, 0.12429f, 0.12988f, 0.13563f,
+	0.14152f, 0.14757f, 0.15376f, 0.16011f, 0.16661f, 0.17325f, 0.18005f, 0.18699f,
+	0.19407f, 0.20130f, 0.20867f, 0.21618f, 0.22382f, 0.23161f, 0.23952f, 0.24757f,
+	0.25574f, 0.26404f, 0.27246f, 0.28100f, 0.28965f, 0.29841f, 0.30729f, 0.31626f,
+	0.32533f, 0.33450f, 0.34376f, 0.35311f, 0.36253f, 0.37204f, 0.38161f, 0.39126f,
+	0.40096f, 0.41072f, 0.42054f, 0.43040f, 0.44030f, 0.45023f, 0.46020f, 0.47019f,
+	0.48020f, 0.49022f, 0.50025f, 0.51028f, 0.52031f, 0.53033f, 0.54033f, 0.55031f,
+	0.56026f, 0.57019f, 0.58007f, 0.58991f, 0.59970f, 0.60944f, 0.61912f, 0.62873f,
+	0.63827f, 0.64774f, 0.65713f, 0.66643f, 0.67564f, 0.68476f, 0.69377f, 0.70269f,
+	0.71150f, 0.72019f, 0.72877f, 0.73723f, 0.74557f, 0.75378f, 0.76186f, 0.76981f,
+	0.77762f, 0.78530f, 0.79283f, 0.80022f, 0.80747f, 0.81457f, 0.82151f, 0.82831f,
+	0.83496f, 0.84145f, 0.84779f, 0.85398f, 0.86001f, 0.86588f, 0.87160f, 0.87716f,
+	0.88257f, 0.88782f, 0.89291f, 0.89785f, 0.90264f, 0.90728f, 0.91176f, 0.91610f,
+	0.92028f, 0.92432f, 0.92822f, 0.93197f, 0.93558f, 0.93906f, 0.94240f, 0.94560f,
+	0.94867f, 0.95162f, 0.95444f, 0.95713f, 0.95971f, 0.96217f, 0.96451f, 0.96674f,
+	0.96887f, 0.97089f, 0.97281f, 0.97463f, 0.97635f, 0.97799f, 0.97953f, 0.98099f,
+	0.98236f, 0.98366f, 0.98488f, 0.98602f, 0.98710f, 0.98811f, 0.98905f, 0.98994f,
+	0.99076f, 0.99153f, 0.99225f, 0.99291f, 0.99353f, 0.99411f, 0.99464f, 0.99513f,
+	0.99558f, 0.99600f, 0.99639f, 0.99674f, 0.99706f, 0.99736f, 0.99763f, 0.99788f,
+	0.99811f, 0.99831f, 0.99850f, 0.99867f, 0.99882f, 0.99895f, 0.99908f, 0.99919f,
+	0.99929f, 0.99938f, 0.99946f, 0.99953f, 0.99959f, 0.99965f, 0.99969f, 0.99974f,
+	0.99978f, 0.99981f, 0.99984f, 0.99986f, 0.99988f, 0.99990f, 0.99992f, 0.99993f,
+	0.99994f, 0.99995f, 0.99996f, 0.99997f, 0.99998f, 0.99998f, 0.99998f, 0.99999f,
+	0.99999f, 0.99999f, 0.99999f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f,
+	1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f, 1.00000f };
+
+// ---- previous implementation (radix-2, static buffers, one stream at a time)
+typedef struct
+{
+	float real;
+	float imag;
+}complex_t;
+
+static const uint_8 bit_reverse_512[] = {
+	0x00, 0x40, 0x20, 0x60, 0x10, 0x50, 0x30, 0x70, 0x08, 0x48, 0x28, 0x68, 0x18, 0x58, 0x38, 0x78,
+	0x04, 0x44, 0x24, 0x64, 0x14, 0x54, 0x34, 0x74, 0x0c, 0x4c, 0x2c, 0x6c, 0x1c, 0x5c, 0x3c, 0x7c,
+	0x02, 0x42, 0x22, 0x62, 0x12, 0x52, 0x32, 0x72, 0x0a, 0x4a, 0x2a, 0x6a, 0x1a, 0x5a, 0x3a, 0x7a,
+	0x06, 0x46, 0x26, 0x66, 0x16, 0x56, 0x36, 0x76, 0x0e, 0x4e, 0x2e, 0x6e, 0x1e, 0x5e, 0x3e, 0x7e,
+	0x01, 0x41, 0x21, 0x61, 0x11, 0x51, 0x31, 0x71, 0x09, 0x49, 0x29, 0x69, 0x19, 0x59, 0x39, 0x79,
+	0x05, 0x45, 0x25, 0x65, 0x15, 0x55, 0x35, 0x75, 0x0d, 0x4d, 0x2d, 0x6d, 0x1d, 0x5d, 0x3d, 0x7d,
+	0x03, 0x43, 0x23, 0x63, 0x13, 0x53, 0x33, 0x73, 0x0b, 0x4b, 0x2b, 0x6b, 0x1b, 0x5b, 0x3b, 0x7b,
+	0x07, 0x47, 0x27, 0x67, 0x17, 0x57, 0x37, 0x77, 0x0f, 0x4f, 0x2f, 0x6f, 0x1f, 0x5f, 0x3f, 0x7f };
+
+static const uint_8 bit_reverse_256[] = {
+	0x00, 0x20, 0x10, 0x30, 0x08, 0x28, 0x18, 0x38, 0x04, 0x24, 0x14, 0x34, 0x0c, 0x2c, 0x1c, 0x3c,
+	0x02, 0x22, 0x12, 0x32, 0x0a, 0x2a, 0x1a, 0x3a, 0x06, 0x26, 0x16, 0x36, 0x0e, 0x2e, 0x1e, 0x3e,
+	0x01, 0x21, 0x11, 0x31, 0x09, 0x29, 0x19, 0x39, 0x05, 0x25, 0x15, 0x35, 0x0d, 0x2d, 0x1d, 0x3d,
+	0x03, 0x23, 0x13, 0x33, 0x0b, 0x2b, 0x1b, 0x3b, 0x07, 0x27, 0x17, 0x37, 0x0f, 0x2f, 0x1f, 0x3f };
+
+static complex_t buf[128];
+static complex_t *w[7];
+static complex_t w_1[1],w_2[2],w_4[4],w_8[8],w_16[16],w_32[32],w_64[64];
+static float xcos1[128],xsin1[128],xcos2[64],xsin2[64];
+static float delay[6][256];
+
+static complex_t cmplx_mult(complex_t a,complex_t b)
+{
+	complex_t ret;
+	ret.real=a.real*b.real-a.imag*b.imag;
+	ret.imag=a.real*b.imag+a.imag*b.real;
+	return ret;
+}
+
+static void swap_cmplx(complex_t *a,complex_t *b)
+{
+	complex_t tmp=*a;
+	*a=*b;
+	*b=tmp;
+}
+
+void imdct_init_ref(ac3_state *)
+{
+	const int N=512;
+
+	for(int i=0;i<128;i++)
+	{
+		xcos1[i]=-cosf(2.0f*(float)M_PI*((float)(8*i+1)/(float)(8*N)));
+		xsin1[i]=-sinf(2.0f*(float)M_PI*((float)(8*i+1)/(float)(8*N)));
+	}
+	for(int i=0;i<64;i++)
+	{
+		xcos2[i]=-cosf(2.0f*(float)M_PI*(float)(8*i+1)/(float)(4*N));
+		xsin2[i]=-sinf(2.0f*(float)M_PI*(float)(8*i+1)/(float)(4*N));
+	}
+
+	w[0]=w_1; w[1]=w_2; w[2]=w_4; w[3]=w_8; w[4]=w_16; w[5]=w_32; w[6]=w_64;
+	for(int i=0;i<7;i++)
+	{
+		complex_t angle_step,current_angle;
+		angle_step.real=cosf(-2.0f*(float)M_PI/(float)(1<<(i+1)));
+		angle_step.imag=sinf(-2.0f*(float)M_PI/(float)(1<<(i+1)));
+		current_angle.real=1.0f;
+		current_angle.imag=0.0f;
+		for(int k=0;k<1<<i;k++)
+		{
+			w[i][k]=current_angle;
+			current_angle=cmplx_mult(current_angle,angle_step);
+		}
+	}
+	memset(delay,0,sizeof(delay));
+}
+
+static void fft_merge_ref(complex_t *b,int n,int stages)
+{
+	for(int m=0;m<stages;m++)
+	{
+		int two_m=1<<m;
+		int two_m_plus_one=1<<(m+1);
+		for(int k=0;k<two_m;k++)
+			for(int i=0;i<n;i+=two_m_plus_one)
+			{
+				int p=k+i,q=p+two_m;
+				float tmp_a_r=b[p].real;
+				float tmp_a_i=b[p].imag;
+				float tmp_b_r=b[q].real*w[m][k].real-b[q].imag*w[m][k].imag;
+				float tmp_b_i=b[q].imag*w[m][k].real+b[q].real*w[m][k].imag;
+				b[p].real=tmp_a_r+tmp_b_r;
+				b[p].imag=tmp_a_i+tmp_b_i;
+				b[q].real=tmp_a_r-tmp_b_r;
+				b[q].imag=tmp_a_i-tmp_b_i;
+			}
+	}
+}
+
+static void imdct_do_512_ref(float data[],float delay[])
+{
+	for(int i=0;i<128;i++)
+	{
+		buf[i].real=(data[256-2*i-1]*xcos1[i])-(data[2*i]*xsin1[i]);
+		buf[i].imag=-1.0f*((data[2*i]*xcos1[i])+(data[256-2*i-1]*xsin1[i]));
+	}
+	for(int i=0;i<128;i++)
+	{
+		int k=bit_reverse_512[i];
+		if(k<i)
+			swap_cmplx(&buf[i],&buf[k]);
+	}
+	fft_merge_ref(buf,128,7);
+	for(int i=0;i<128;i++)
+	{
+		float tmp_a_r=buf[i].real;
+		float tmp_a_i=-1.0f*buf[i].imag;
+		buf[i].real=(tmp_a_r*xcos1[i])-(tmp_a_i*xsin1[i]);
+		buf[i].imag=(tmp_a_r*xsin1[i])+(tmp_a_i*xcos1[i]);
+	}
+
+	float *data_ptr=data;
+	float *delay_ptr=delay;
+	const float *window_ptr=window;
+
+	for(int i=0;i<64;i++)
+	{
+		*data_ptr++=2.0f*(-buf[64+i].imag*(*window_ptr++)+*delay_ptr++);
+		*data_ptr++=2.0f*(buf[64-i-1].real*(*window_ptr++)+*delay_ptr++);
+	}
+	for(int i=0;i<64;i++)
+	{
+		*data_ptr++=2.0f*(-buf[i].real*(*window_ptr++)+*delay_ptr++);
+		*data_ptr++=2.0f*(buf[128-i-1].imag*(*window_ptr++)+*delay_ptr++);
+	}
+	delay_ptr=delay;
+	for(int i=0;i<64;i++)
+	{
+		*delay_ptr++=-buf[64+i].real*(*--window_ptr);
+		*delay_ptr++=buf[64-i-1].imag*(*--window_ptr);
+	}
+	for(int i=0;i<64;i++)
+	{
+		*delay_ptr++=buf[i].imag*(*--window_ptr);
+		*delay_ptr++=-buf[128-i-1].real*(*--window_ptr);
+	}
+}
+
+static void imdct_do_256_ref(float data[],float delay[])
+{
+	complex_t *buf_1=&buf[0],*buf_2=&buf[64];
+
+	for(int k=0;k<64;k++)
+	{
+		int p=2*(128-2*k-1);
+		int q=2*(2*k);
+		buf_1[k].real=data[p]*xcos2[k]-data[q]*xsin2[k];
+		buf_1[k].imag=-1.0f*(data[q]*xcos2[k]+data[p]*xsin2[k]);
+		buf_2[k].real=data[p+1]*xcos2[k]-data[q+1]*xsin2[k];
+		buf_2[k].imag=-1.0f*(data[q+1]*xcos2[k]+data[p+1]*xsin2[k]);
+	}
+	for(int i=0;i<64;i++)
+	{
+		int k=bit_reverse_256[i];
+		if(k<i)
+		{
+			swap_cmplx(&buf_1[i],&buf_1[k]);
+			swap_cmplx(&buf_2[i],&buf_2[k]);
+		}
+	}
+	fft_merge_ref(buf_1,64,6);
+	fft_merge_ref(buf_2,64,6);
+	for(int i=0;i<64;i++)
+	{
+		float tmp_a_r=buf_1[i].real;
+		float tmp_a_i=-buf_1[i].imag;
+		buf_1[i].real=(tmp_a_r*xcos2[i])-(tmp_a_i*xsin2[i]);
+		buf_1[i].imag=(tmp_a_r*xsin2[i])+(tmp_a_i*xcos2[i]);
+		tmp_a_r=buf_2[i].real;
+		tmp_a_i=-buf_2[i].imag;
+		buf_2[i].real=(tmp_a_r*xcos2[i])-(tmp_a_i*xsin2[i]);
+		buf_2[i].imag=(tmp_a_r*xsin2[i])+(tmp_a_i*xcos2[i]);
+	}
+
+	float *data_ptr=data;
+	float *delay_ptr=delay;
+	const float *window_ptr=window;
+
+	for(int i=0;i<64;i++)
+	{
+		*data_ptr++=2.0f*(-buf_1[i].imag*(*window_ptr++)+*delay_ptr++);
+		*data_ptr++=2.0f*(buf_1[64-i-1].real*(*window_ptr++)+*delay_ptr++);
+	}
+	for(int i=0;i<64;i++)
+	{
+		*data_ptr++=2.0f*(-buf_1[i].real*(*window_ptr++)+*delay_ptr++);
+		*data_ptr++=2.0f*(buf_1[64-i-1].imag*(*window_ptr++)+*delay_ptr++);
+	}
+	delay_ptr=delay;
+	for(int i=0;i<64;i++)
+	{
+		*delay_ptr++=-buf_2[i].real*(*--window_ptr);
+		*delay_ptr++=buf_2[64-i-1].imag*(*--window_ptr);
+	}
+	for(int i=0;i<64;i++)
+	{
+		*delay_ptr++=buf_2[i].imag*(*--window_ptr);
+		*delay_ptr++=-buf_2[64-i-1].real*(*--window_ptr);
+	}
+}
+
+void imdct_ref(ac3_state *,bsi_t *bsi,audblk_t *audblk,stream_samples_t samples)
+{
+	for(int i=0;i<bsi->nfchans;i++)
+	{
+		if(audblk->blksw[i])
+			imdct_do_256_ref(samples[i],delay[i]);
+		else
+			imdct_do_512_ref(samples[i],delay[i]);
+	}
+	if(bsi->lfeon)
+		imdct_do_512_ref(samples[5],delay[5]);
+}
+
+// ---- tables
+// split-radix input order: order(n) = 2*order(n/2), 4*order(n/4)+1, 4*order(n/4)+3
+static void fft_order(int *order,int n)
+{
+	if(n<=2)
+	{
+		for(int i=0;i<n;i++)
+			order[i]=i;
+		return;
+	}
+	int *t=(int *)malloc(n*sizeof(int));
+	fft_order(t,n/2);
+	for(int i=0;i<n/2;i++)
+		order[i]=2*t[i];
+	fft_order(t,n/4);
+	for(int i=0;i<n/4;i++)
+	{
+		order[n/2+i]=4*t[i]+1;
+		order[3*n/4+i]=4*t[i]+3;
+	}
+	free(t);
+}
+
+// groups of four at the bottom of the recursion (see imdct.c: fft()): 4 point transform
+// (1) or two 2 point transforms (0)
+static void fft_leaves(int *leaf,int offset,int n)
+{
+	if(n==4)
+		leaf[offset/4]=1;
+	else if(n==8)
+	{
+		leaf[offset/4]=1;
+		leaf[offset/4+1]=0;
+	}
+	else
+	{
+		fft_leaves(leaf,offset,n/2);
+		fft_leaves(leaf,offset+n/2,n/4);
+		fft_leaves(leaf,offset+3*n/4,n/4);
+	}
+}
+
+static void print_floats(FILE *f,const char *name,const double *v,int n)
+{
+	fprintf(f,"IMDCT_ALIGN(static const float %s)=\n{",name);
+	for(int i=0;i<n;i++)
+		fprintf(f,"%s%#.9gf%s",(i%6)?" ":"\n ",(float)v[i],i<n-1?",":"\n");
+	fprintf(f,"};\n\n");
+}
+
+static int write_tables(const char *name)
+{
+	FILE *f=fopen(name,"w");
+	if(!f)
+	{
+		printf("cannot create '%s'\n",name);
+		return 1;
+	}
+
+	fprintf(f,"// kX Driver\n// Copyright (c) Eugene Gavrilov, 2001-2014.\n// All rights reserved\n\n"
+	       "// generated by 'kxbench ac3imdct -tables': do not edit\n"
+	       "// see imdct.c\n\n"
+	       "#ifndef KX_IMDCTTBL_H_\n#define KX_IMDCTTBL_H_\n\n");
+
+	// the FFT input order, used by the pre-twiddle, and the bottom of the recursion
+	for(int n=128;n>=64;n/=2)
+	{
+		int order[128];
+		fft_order(order,n);
+		fprintf(f,"static const uint_8 imdct_order%d[%d]=\n{",n,n);
+		for(int i=0;i<n;i++)
+			fprintf(f,"%s%3d%s",(i%16)?" ":"\n ",order[i],i<n-1?",":"\n");
+		fprintf(f,"};\n\n");
+
+		int leaf[32];
+		fft_leaves(leaf,0,n);
+		fprintf(f,"IMDCT_ALIGN(static const uint_32 imdct_leaf%d[%d])=\n{",n,n/4);
+		for(int i=0;i<n/4;i++)
+			fprintf(f,"%s0x%08x%s",(i%8)?" ":"\n ",leaf[i]?0xffffffff:0,i<n/4-1?",":"\n");
+		fprintf(f,"};\n\n");
+	}
+
+	// pre / post twiddles; pcos/psin: in the FFT input order
+	double v[256];
+	const int N=512;
+	for(int p=0;p<2;p++)
+	{
+		int order[128];
+		fft_order(order,128);
+		for(int i=0;i<128;i++)
+			v[i]=-cos(2.0*M_PI*(8*(p?order[i]:i)+1)/(8.0*N));
+		print_floats(f,p?"imdct_pcos1[128]":"imdct_xcos1[128]",v,128);
+		for(int i=0;i<128;i++)
+			v[i]=-sin(2.0*M_PI*(8*(p?order[i]:i)+1)/(8.0*N));
+		print_floats(f,p?"imdct_psin1[128]":"imdct_xsin1[128]",v,128);
+		fft_order(order,64);
+		for(int i=0;i<64;i++)
+			v[i]=-cos(2.0*M_PI*(8*(p?order[i]:i)+1)/(4.0*N));
+		print_floats(f,p?"imdct_pcos2[64]":"imdct_xcos2[64]",v,64);
+		for(int i=0;i<64;i++)
+			v[i]=-sin(2.0*M_PI*(8*(p?order[i]:i)+1)/(4.0*N));
+		print_floats(f,p?"imdct_psin2[64]":"imdct_xsin2[64]",v,64);
+	}
+
+	// split-radix twiddles: W^k, W^3k, W=exp(-2*pi*j/n)
+	for(int n=8;n<=128;n*=2)
+	{
+		int q=n/4;
+		for(int k=0;k<q;k++)
+		{
+			v[k]=cos(2.0*M_PI*k/n);
+			v[q+k]=-sin(2.0*M_PI*k/n);
+			v[2*q+k]=cos(2.0*M_PI*3*k/n);
+			v[3*q+k]=-sin(2.0*M_PI*3*k/n);
+		}
+		char s[32];
+		sprintf(s,"imdct_w%d[4][%d]",n,q);
+		fprintf(f,"IMDCT_ALIGN(static const float %s)=\n{",s);
+		for(int r=0;r<4;r++)
+		{
+			fprintf(f,"\n {");
+			for(int k=0;k<q;k++)
+				fprintf(f,"%s%#.9gf%s",(k%6)?" ":"\n  ",(float)v[r*q+k],k<q-1?",":"\n");
+			fprintf(f," }%s",r<3?",":"\n");
+		}
+		fprintf(f,"};\n\n");
+	}
+
+	// 2 * window: data; reversed: delay line
+	for(int i=0;i<256;i++)
+		v[i]=2.0*window[i];
+	print_floats(f,"imdct_window_data[256]",v,256);
+	for(int i=0;i<256;i++)
+		v[i]=2.0*window[255-i];
+	print_floats(f,"imdct_window_delay[256]",v,256);
+
+	fprintf(f,"#endif\n");
+	fclose(f);
+
+	printf("tables written to '%s'\n",name);
+	return 0;
+}
+
+// ---- decoding a file
+typedef struct
+{
+	uint_8 *data;
+	size_t size,pos;
+	int eof;
+	uint_8 pad[4096];
+}ac3_file;
+
+static void __stdcall fill_buffer(uint_8 **start,uint_8 **end,ac3_state *state,int)
+{
+	ac3_file *f=(ac3_file *)state->that;
+	if(f->pos<f->size)
+	{
+		*start=f->data+f->pos;
+		*end=f->data+f->size;
+		f->pos=f->size;
+	}
+	else
+	{
+		// past the end: zeroes until the current frame is done
+		f->eof=1;
+		*start=f->pad;
+		*end=f->pad+sizeof(f->pad);
+	}
+}
+
+#define DEC_FRAME 1536
+
+typedef struct
+{
+	ac3_state state;
+	ac3_file file;
+	sint_16 out[6][DEC_FRAME];
+}decoder;
+
+static void decoder_init(decoder *d,uint_8 *data,size_t size,int ref)
+{
+	memset(d,0,sizeof(decoder));
+	d->file.data=data;
+	d->file.size=size;
+	d->state.fill_buffer=fill_buffer;
+	d->state.that=&d->file;
+	d->state.left=d->out[0];
+	d->state.center=d->out[1];
+	d->state.right=d->out[2];
+	d->state.sleft=d->out[3];
+	d->state.sright=d->out[4];
+	d->state.subwoofer=d->out[5];
+	if(ref)
+		ac3_init_ref(&d->state);
+	else
+		ac3_init(&d->state);
+}
+
+static int decode_file(const char *name)
+{
+	FILE *f=fopen(name,"rb");
+	if(!f)
+	{
+		printf("cannot open '%s'\n",name);
+		return 1;
+	}
+	fseek(f,0,SEEK_END);
+	size_t size=(size_t)ftell(f);
+	fseek(f,0,SEEK_SET);
+	uint_8 *data=(uint_8 *)malloc(size);
+	if(fread(data,1,size,f)!=size)
+	{
+		printf("cannot read '%s'\n",name);
+		fclose(f);
+		free(data);
+		return 1;
+	}
+	fclose(f);
+
+	decoder *d[2];
+	double t[2];
+	int frames[2],bad[2];
+	int max_diff=0,diff_frames=0;
+
+	for(int m=0;m<2;m++)
+	{
+		d[m]=(decoder *)malloc(sizeof(decoder));
+		decoder_init(d[m],data,size,m==0);
+	}
+
+	// decode in lock step to compare, then once more for the timing
+	frames[0]=0;
+	while(!d[0]->file.eof && !d[1]->file.eof)
+	{
+		int r0=ac3_decode_frame_ref(&d[0]->state);
+		int r1=ac3_decode_frame(&d[1]->state);
+		if(d[0]->file.eof || d[1]->file.eof)
+			break;
+		if(r0!=r1)
+		{
+			printf("!! frame %d: decode result differs (%d / %d)\n",frames[0],r0,r1);
+			diff_frames++;
+		}
+		int md=0;
+		for(int c=0;c<6;c++)
+			for(int i=0;i<DEC_FRAME;i++)
+			{
+				int df=abs((int)d[0]->out[c][i]-(int)d[1]->out[c][i]);
+				if(df>md)
+					md=df;
+			}
+		if(md>max_diff)
+			max_diff=md;
+		frames[0]++;
+	}
+
+	for(int m=0;m<2;m++)
+	{
+		decoder_init(d[m],data,size,m==0);
+		frames[m]=0;
+		bad[m]=0;
+		double t0=bench_time();
+		while(1)
+		{
+			int r=m?ac3_decode_frame(&d[m]->state):ac3_decode_frame_ref(&d[m]->state);
+			if(d[m]->file.eof)
+				break;
+			frames[m]++;
+			if(r)
+				bad[m]++;
+		}
+		t[m]=bench_time()-t0;
+	}
+
+	printf("%s: %d bytes, %d frames (%d bad), %d Hz\n",name,(int)size,frames[1],bad[1],(int)d[1]->state.sampling_rate);
+	printf("  radix-2:     %10.0f frames/s\n",frames[0]/t[0]);
+	printf("  split-radix: %10.0f frames/s (%s)\n",frames[1]/t[1],d[1]->state.imdct_sse?"SSE":"scalar");
+	printf("  largest output difference: %d LSB\n",max_diff);
+
+	for(int m=0;m<2;m++)
+		free(d[m]);
+	free(data);
+
+	return (diff_frames || max_diff>2)?1:0;
+}
+
+// ---- random coefficients
+#define BLOCKS 256
+
+int bench_ac3imdct(int argc,char **argv)
+{
+	if(argc>2 && strcmp(argv[1],"-tables")==0)
+		return write_tables(argv[2]);
+	if(argc>1)
+		return decode_file(argv[1]);
+
+	// blocks of coefficients with random block switching; two states per transform
+	// kind decode the same blocks interleaved (reentrancy)
+	static float coeff[BLOCKS][6][256];
+	static uint_16 blksw[BLOCKS][5];
+	for(int b=0;b<BLOCKS;b++)
+	{
+		for(int c=0;c<6;c++)
+			for(int i=0;i<256;i++)
+			{
+				// AC-3 mantissa * 2^-exponent
+				float m=(float)((int)(bench_rand()%65536)-32768)/32768.0f;
+				coeff[b][c][i]=ldexpf(m,-(int)(bench_rand()%12));
+			}
+		for(int c=0;c<5;c++)
+			blksw[b][c]=(bench_rand()%4)==0;
+	}
+
+	bsi_t bsi;
+	memset(&bsi,0,sizeof(bsi));
+	bsi.nfchans=5;
+	bsi.lfeon=1;
+
+	static audblk_t audblk;
+	static ac3_state s[3];
+	static stream_samples_t out_ref,out_new[3];
+	for(int i=0;i<3;i++)
+	{
+		memset(&s[i],0,sizeof(ac3_state));
+		imdct_init(&s[i]);
+	}
+	s[2].imdct_sse=0;
+	imdct_init_ref(NULL);
+
+	double max_diff[3]={ 0,0,0 },peak=0;
+	for(int b=0;b<BLOCKS;b++)
+	{
+		memcpy(audblk.blksw,blksw[b],sizeof(audblk.blksw));
+		memcpy(out_ref,coeff[b],sizeof(out_ref));
+		imdct_ref(NULL,&bsi,&audblk,out_ref);
+		for(int i=0;i<3;i++)
+		{
+			memcpy(out_new[i],coeff[b],sizeof(out_ref));
+			imdct(&s[i],&bsi,&audblk,out_new[i]);
+		}
+		for(int c=0;c<6;c++)
+			for(int j=0;j<256;j++)
+			{
+				if(fabs(out_ref[c][j])>peak)
+					peak=fabs(out_ref[c][j]);
+				for(int i=0;i<3;i++)
+				{
+					double d=fabs(out_ref[c][j]-out_new[i][c][j]);
+					if(d>max_diff[i])
+						max_diff[i]=d;
+				}
+			}
+	}
+
+	printf("accuracy vs. radix-2, %d blocks x 6 channels, peak %.3f:\n",BLOCKS,peak);
+	printf("  split-radix (%s), stream 1: max diff %.3g\n",s[0].imdct_sse?"SSE":"scalar",max_diff[0]);
+	printf("  split-radix (%s), stream 2: max diff %.3g\n",s[1].imdct_sse?"SSE":"scalar",max_diff[1]);
+	printf("  split-radix (scalar):         max diff %.3g\n",max_diff[2]);
+
+	// speed: 6 transforms per block
+	#define ROUNDS 64
+	double t[3];
+	for(int m=0;m<3;m++)
+	{
+		double t0=bench_time();
+		for(int r=0;r<ROUNDS;r++)
+			for(int b=0;b<BLOCKS;b++)
+			{
+				memcpy(audblk.blksw,blksw[b],sizeof(audblk.blksw));
+				memcpy(out_ref,coeff[b],sizeof(out_ref));
+				if(m==0)
+					imdct_ref(NULL,&bsi,&audblk,out_ref);
+				else
+					imdct(&s[m==1?0:2],&bsi,&audblk,out_ref);
+			}
+		t[m]=(bench_time()-t0)/((double)ROUNDS*BLOCKS*6);
+	}
+
+	printf("\ntransform + window (25%% short blocks):\n");
+	printf("  radix-2:              %8.0f ns\n",t[0]*1e9);
+	printf("  split-radix (%s):  %8.0f ns\n",s[0].imdct_sse?"SSE   ":"scalar",t[1]*1e9);
+	printf("  split-radix (scalar): %8.0f ns\n",t[2]*1e9);
+
+	// differences must stay far below one 16-bit LSB
+	int errors=0;
+	for(int i=0;i<3;i++)
+		if(max_diff[i]>1e-5*(peak>1.0?peak:1.0))
+		{
+			printf("!! split-radix: difference is too large\n");
+			errors++;
+		}
+	return errors;
+}
@@ -0,0 +1,302 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// AC-3 output stage (ac3/output.c): previous per-sample sint_16 conversion and scalar
+// downmix (ac3/downmix.c) vs. the fused matrix/dither/saturation/packing pass
+// kxbench ac3out                    accuracy and speed per output mode and format
+
+#include <math.h>
+
+#include "kxbench.h"
+
+extern "C" {
+#include "driver/ac3.h"
+}
+
+// ---- previous code
+
+static void convert_ref(stream_samples_t samples,sint_16 *out[6],int block)
+{
+	for(int j=0;j<256;j++)
+	{
+		out[0][block*256+j]=(sint_16)(samples[0][j]*32767.0f);
+		out[1][block*256+j]=(sint_16)(samples[1][j]*32767.0f);
+		out[2][block*256+j]=(sint_16)(samples[2][j]*32767.0f);
+		out[3][block*256+j]=(sint_16)(samples[3][j]*32767.0f);
+		out[4][block*256+j]=(sint_16)(samples[4][j]*32767.0f);
+		out[5][block*256+j]=(sint_16)(samples[5][j]*32767.0f);
+	}
+}
+
+static const float cmixlev_ref[4]={ 0.2928f, 0.2468f, 0.2071f, 0.2468f };
+static const float smixlev_ref[4]={ 0.2928f, 0.2071f, 0.0f, 0.2071f };
+
+static void downmix_3f_2r_to_2ch_ref(bsi_t *bsi,stream_samples_t samples,sint_16 *s16_samples)
+{
+	float *left=samples[0],*centre=samples[1],*right=samples[2],*left_sur=samples[3],*right_sur=samples[4];
+	float clev=cmixlev_ref[bsi->cmixlev],slev=smixlev_ref[bsi->surmixlev];
+
+	for(int j=0;j<256;j++)
+	{
+		float left_tmp=0.4142f * *left++  + clev * *centre   + slev * *left_sur++;
+		float right_tmp=0.4142f * *right++ + clev * *centre++ + slev * *right_sur++;
+
+		s16_samples[j*2]=(sint_16)(left_tmp*32767.0f);
+		s16_samples[j*2+1]=(sint_16)(right_tmp*32767.0f);
+	}
+}
+
+// ----
+
+#define BLOCKS	96
+
+static stream_samples_t input[BLOCKS];
+static sint_16 planar[6][BLOCKS*256];
+static sint_32 inter[BLOCKS*256*6];
+static sint_32 inter_c[BLOCKS*256*6];
+
+static const char *mode_name[5]={ "5.1", "quad", "Lo/Ro", "Lt/Rt", "mono" };
+static const char *format_name[3]={ "s16", "s24/32", "f32" };
+
+static void setup(ac3_state *s,int mode,int format,int dither,void *out,int sse2)
+{
+	memset(s,0,sizeof(ac3_state));
+	s->left=planar[0]; s->center=planar[1]; s->right=planar[2];
+	s->sleft=planar[3]; s->sright=planar[4]; s->subwoofer=planar[5];
+	s->bsi.acmod=7;
+	s->bsi.lfeon=1;
+	s->bsi.nfchans=5;
+	ac3_set_output(s,mode,format,1.0f,dither,out);
+	if(!sse2)
+		s->out_sse2=0;
+	output_setup(s);
+}
+
+// time per block, the best of TRIALS runs: the output stage runs on the block the IMDCT
+// has just written, in the cache (kind 0: output_block(), 1: previous conversion, 2: previous downmix)
+// the previous code is called through volatile pointers, as output_block() is called from another
+// module: inlined, its loop over the (identical) blocks is reduced to one block, and its output,
+// never read, can be dropped
+#define TRIALS	20
+
+static void (*volatile convert_ref_f)(stream_samples_t samples,sint_16 *out[6],int block)=convert_ref;
+static void (*volatile downmix_ref_f)(bsi_t *bsi,stream_samples_t samples,sint_16 *s16_samples)=downmix_3f_2r_to_2ch_ref;
+
+static double time_block(ac3_state *s,int kind)
+{
+	static sint_16 ref[6][6*256],ref2[6*256*2];
+	sint_16 *ref_ch[6]={ ref[0],ref[1],ref[2],ref[3],ref[4],ref[5] };
+	double best=1e30;
+
+	for(int r=0;r<TRIALS;r++)
+	{
+		double t0=bench_time();
+		for(int b=0;b<BLOCKS;b++)
+			switch(kind)
+			{
+				case 0: output_block(s,b%6); break;
+				case 1: convert_ref_f(s->samples,ref_ch,b%6); break;
+				case 2: downmix_ref_f(&s->bsi,s->samples,ref2+(b%6)*256*2); break;
+			}
+		double t=(bench_time()-t0)/BLOCKS;
+		if(t<best)
+			best=t;
+	}
+	return best;
+}
+
+static double sample_at(void *out,int format,size_t k)
+{
+	if(format==AC3_FORMAT_S16)
+		return ((sint_16 *)out)[k];
+	if(format==AC3_FORMAT_S24_32)
+		return ((sint_32 *)out)[k]/256.0;
+	return ((float *)out)[k];
+}
+
+int bench_ac3out(int argc,char **argv)
+{
+	(void)argc; (void)argv;
+
+	// program material with peaks over full scale: 1 block in 8 is clipped
+	for(int b=0;b<BLOCKS;b++)
+	{
+		float peak=(b%8)==7?1.5f:0.9f;
+		for(int c=0;c<6;c++)
+			for(int j=0;j<256;j++)
+				input[b][c][j]=peak*((float)(bench_rand()%65536)-32768.0f)/32768.0f;
+	}
+
+	static ac3_state s,sc;
+	static sint_16 ref[6][6*256],ref2[6*256*2];
+	sint_16 *ref_ch[6]={ ref[0],ref[1],ref[2],ref[3],ref[4],ref[5] };
+	int errors=0;
+
+	// planar 5.1 (driver default) vs. the previous conversion; clipped blocks must saturate
+	{
+		int max_diff=0,wrapped=0;
+		setup(&s,AC3_OUTPUT_51,AC3_FORMAT_S16,0,NULL,1);
+		for(int b=0;b<BLOCKS;b++)
+		{
+			memcpy(s.samples,input[b],sizeof(stream_samples_t));
+			output_block(&s,0);
+			convert_ref(input[b],ref_ch,0);
+			for(int c=0;c<6;c++)
+				for(int j=0;j<256;j++)
+				{
+					float x=input[b][c][j]*32767.0f;
+					if(x>32767.0f || x<-32768.0f)
+					{
+						if(planar[c][j]!=(x>0?32767:-32768))
+							wrapped++;
+						continue;
+					}
+					int d=abs(planar[c][j]-ref[c][j]);
+					if(d>max_diff)
+						max_diff=d;
+				}
+		}
+		printf("planar 5.1 s16 vs. previous conversion: max diff %d LSB, %d clipped samples not saturated\n",max_diff,wrapped);
+		if(max_diff>1 || wrapped)
+			errors++;
+	}
+
+	// Lo/Ro vs. the previous 3/2 -> 2 downmix
+	{
+		int max_diff=0;
+		setup(&s,AC3_OUTPUT_STEREO,AC3_FORMAT_S16,0,inter,1);
+		for(int b=0;b<BLOCKS;b++)
+		{
+			if((b%8)==7)
+				continue;
+			memcpy(s.samples,input[b],sizeof(stream_samples_t));
+			output_block(&s,0);
+			downmix_3f_2r_to_2ch_ref(&s.bsi,input[b],ref2);
+			for(int j=0;j<512;j++)
+			{
+				int d=abs(((sint_16 *)inter)[j]-ref2[j]);
+				if(d>max_diff)
+					max_diff=d;
+			}
+		}
+		// the previous table is rounded to 4 digits (0.2928 vs. 0.7071/2.4142): up to ~3 LSB per term
+		printf("Lo/Ro s16 vs. previous downmix:         max diff %d LSB\n",max_diff);
+		if(max_diff>8)
+			errors++;
+	}
+
+	// SSE2 vs. scalar in every mode and format; dither: error within +-1 LSB, no DC
+	printf("\nSSE2 vs. scalar, max diff (LSB; f32: full scale):\n");
+	for(int mode=0;mode<5;mode++)
+		for(int format=0;format<3;format++)
+		{
+			double max_diff=0,lim=format==AC3_FORMAT_F32?1e-6:1.0;
+			int nch=ac3_output_channels(mode);
+			setup(&s,mode,format,0,inter,1);
+			setup(&sc,mode,format,0,inter_c,0);
+			if(!s.out_sse2)
+				break;
+			for(int b=0;b<BLOCKS;b++)
+			{
+				memcpy(s.samples,input[b],sizeof(stream_samples_t));
+				memcpy(sc.samples,input[b],sizeof(stream_samples_t));
+				output_block(&s,b%6);
+				output_block(&sc,b%6);
+			}
+			for(size_t k=0;k<(size_t)6*256*nch;k++)
+			{
+				double d=fabs(sample_at(inter,format,k)-sample_at(inter_c,format,k));
+				if(d>max_diff)
+					max_diff=d;
+			}
+			printf("  %-6s %-7s %g\n",mode_name[mode],format_name[format],max_diff);
+			if(max_diff>lim)
+				errors++;
+		}
+
+	for(int sse2=1;sse2>=0;sse2--)
+	{
+		double sum=0,max_err=0;
+		size_t n=0;
+		setup(&s,AC3_OUTPUT_51,AC3_FORMAT_S16,1,inter,sse2);
+		setup(&sc,AC3_OUTPUT_51,AC3_FORMAT_F32,0,inter_c,sse2);
+		for(int b=0;b<BLOCKS;b++)
+		{
+			if((b%8)==7)
+				continue;
+			memcpy(s.samples,input[b],sizeof(stream_samples_t));
+			memcpy(sc.samples,input[b],sizeof(stream_samples_t));
+			output_block(&s,0);
+			output_block(&sc,0);
+			for(int k=0;k<256*6;k++)
+			{
+				double e=((sint_16 *)inter)[k]-((float *)inter_c)[k]*32767.0;
+				sum+=e;
+				if(fabs(e)>max_err)
+					max_err=fabs(e);
+				n++;
+			}
+		}
+		printf("TPDF dither (%s): max error %.2f LSB, mean %.4f LSB\n",sse2?"SSE2":"scalar",max_err,sum/n);
+		if(max_err>1.5 || fabs(sum/n)>0.01)
+			errors++;
+	}
+
+	// speed per block (256 samples x 6 decoded channels)
+	printf("\nper block (256 samples, 3/2+lfe input):\n");
+	setup(&s,AC3_OUTPUT_STEREO,AC3_FORMAT_S16,0,inter,1);
+	memcpy(s.samples,input[0],sizeof(stream_samples_t));
+	double t_conv=time_block(&s,1),t_downmix=time_block(&s,2),t_lo_ro=0,t_planar=0;
+	printf("  previous: planar s16          %8.0f ns\n",t_conv*1e9);
+	printf("  previous: Lo/Ro downmix s16   %8.0f ns\n",t_downmix*1e9);
+
+	printf("                                  SSE2   scalar\n");
+	for(int mode=0;mode<5;mode++)
+		for(int format=0;format<3;format++)
+			for(int dither=0;dither<=(format!=AC3_FORMAT_F32);dither++)
+			{
+				double t[2]={ 0,0 };
+				for(int sse2=1;sse2>=0;sse2--)
+				{
+					setup(&s,mode,format,dither,inter,sse2);
+					memcpy(s.samples,input[0],sizeof(stream_samples_t));
+					t[sse2]=time_block(&s,0);
+				}
+				printf("  %-6s %-7s %-9s %8.0f %8.0f ns\n",mode_name[mode],format_name[format],dither?"dither":"",t[1]*1e9,t[0]*1e9);
+				if(mode==AC3_OUTPUT_STEREO && format==AC3_FORMAT_S16 && !dither)
+					t_lo_ro=t[1];
+			}
+	for(int dither=0;dither<2;dither++)
+	{
+		double t[2]={ 0,0 };
+		for(int sse2=1;sse2>=0;sse2--)
+		{
+			setup(&s,AC3_OUTPUT_51,AC3_FORMAT_S16,dither,NULL,sse2);
+			memcpy(s.samples,input[0],sizeof(stream_samples_t));
+			t[sse2]=time_block(&s,0);
+		}
+		printf("  5.1    planar  %-9s %8.0f %8.0f ns\n",dither?"dither":"",t[1]*1e9,t[0]*1e9);
+		if(!dither)
+			t_planar=t[1];
+	}
+	printf("\nSSE2 vs. previous: 5.1 planar s16 x%.2f, Lo/Ro s16 x%.2f\n",t_conv/t_planar,t_downmix/t_lo_ro);
+
+	return errors;
+}
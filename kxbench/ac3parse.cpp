@@ -0,0 +1,618 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// AC-3 syncframe parsing (ac3/bitstream.c, ac3/crc.c, ac3/parse.c): previous byte-wise crc and
+// 32-bit bit reader vs. slice-by-8 crc and the 64-bit cached reader; malformed input
+// kxbench ac3parse [-iter <frames>]  crc and reader equivalence and speed, front end speed per
+//                                    frame, then decodes mutated streams (bit flips, garbage runs,
+//                                    bad headers, truncated frames; most with a valid crc so that
+//                                    they reach parse_audblk) through ac3_feed() and through
+//                                    ac3_decode_frame(): no call may take much longer than a
+//                                    valid frame
+//
+// build with -fsanitize=address to catch out of bounds accesses
+
+#include "kxbench.h"
+
+extern "C" {
+#include "driver/ac3.h"
+}
+
+// ---- previous code
+
+static const uint_16 crc_lut_ref[256] =
+{
+	0x0000,0x8005,0x800f,0x000a,0x801b,0x001e,0x0014,0x8011,
+	0x8033,0x0036,0x003c,0x8039,0x0028,0x802d,0x8027,0x0022,
+	0x8063,0x0066,0x006c,0x8069,0x0078,0x807d,0x8077,0x0072,
+	0x0050,0x8055,0x805f,0x005a,0x804b,0x004e,0x0044,0x8041,
+	0x80c3,0x00c6,0x00cc,0x80c9,0x00d8,0x80dd,0x80d7,0x00d2,
+	0x00f0,0x80f5,0x80ff,0x00fa,0x80eb,0x00ee,0x00e4,0x80e1,
+	0x00a0,0x80a5,0x80af,0x00aa,0x80bb,0x00be,0x00b4,0x80b1,
+	0x8093,0x0096,0x009c,0x8099,0x0088,0x808d,0x8087,0x0082,
+	0x8183,0x0186,0x018c,0x8189,0x0198,0x819d,0x8197,0x0192,
+	0x01b0,0x81b5,0x81bf,0x01ba,0x81ab,0x01ae,0x01a4,0x81a1,
+	0x01e0,0x81e5,0x81ef,0x01ea,0x81fb,0x01fe,0x01f4,0x81f1,
+	0x81d3,0x01d6,0x01dc,0x81d9,0x01c8,0x81cd,0x81c7,0x01c2,
+	0x0140,0x8145,0x814f,0x014a,0x815b,0x015e,0x0154,0x8151,
+	0x8173,0x0176,0x017c,0x8179,0x0168,0x816d,0x8167,0x0162,
+	0x8123,0x0126,0x012c,0x8129,0x0138,0x813d,0x8137,0x0132,
+	0x0110,0x8115,0x811f,0x011a,0x810b,0x010e,0x0104,0x8101,
+	0x8303,0x0306,0x030c,0x8309,0x0318,0x831d,0x8317,0x0312,
+	0x0330,0x8335,0x833f,0x033a,0x832b,0x032e,0x0324,0x8321,
+	0x0360,0x8365,0x836f,0x036a,0x837b,0x037e,0x0374,0x8371,
+	0x8353,0x0356,0x035c,0x8359,0x0348,0x834d,0x8347,0x0342,
+	0x03c0,0x83c5,0x83cf,0x03ca,0x83db,0x03de,0x03d4,0x83d1,
+	0x83f3,0x03f6,0x03fc,0x83f9,0x03e8,0x83ed,0x83e7,0x03e2,
+	0x83a3,0x03a6,0x03ac,0x83a9,0x03b8,0x83bd,0x83b7,0x03b2,
+	0x0390,0x8395,0x839f,0x039a,0x838b,0x038e,0x0384,0x8381,
+	0x0280,0x8285,0x828f,0x028a,0x829b,0x029e,0x0294,0x8291,
+	0x82b3,0x02b6,0x02bc,0x82b9,0x02a8,0x82ad,0x82a7,0x02a2,
+	0x82e3,0x02e6,0x02ec,0x82e9,0x02f8,0x82fd,0x82f7,0x02f2,
+	0x02d0,0x82d5,0x82df,0x02da,0x82cb,0x02ce,0x02c4,0x82c1,
+	0x8243,0x0246,0x024c,0x8249,0x0258,0x825d,0x8257,0x0252,
+	0x0270,0x8275,0x827f,0x027a,0x826b,0x026e,0x0264,0x8261,
+	0x0220,0x8225,0x822f,0x022a,0x823b,0x023e,0x0234,0x8231,
+	0x8213,0x0216,0x021c,0x8219,0x0208,0x820d,0x8207,0x0202
+};
+
+static uint_16 crc_ref(uint_16 state,const uint_8 *data,uint_32 num_bytes)
+{
+	for(uint_32 i=0;i<num_bytes;i++)
+		state=crc_lut_ref[data[i]^(state>>8)]^(uint_16)(state<<8);
+	return state;
+}
+
+// 32-bit word reader; bits_left==0 shifted by 32 (undefined; x86 returned stale bits)
+typedef struct
+{
+	const uint_8 *buffer_start;
+	uint_32 bits_left;
+	uint_32 current_word;
+}reader_ref;
+
+static void fill_current_ref(reader_ref *r)
+{
+	const uint_8 *p=r->buffer_start;
+	r->current_word=((uint_32)p[0]<<24)|((uint_32)p[1]<<16)|((uint_32)p[2]<<8)|p[3];
+	r->buffer_start+=4;
+}
+
+static uint_32 get_bh_ref(uint_32 num_bits,reader_ref *r)
+{
+	uint_32 result;
+
+	num_bits-=r->bits_left;
+	result=r->bits_left?(r->current_word<<(32-r->bits_left))>>(32-r->bits_left):0;
+
+	fill_current_ref(r);
+
+	if(num_bits!=0)
+		result=(result<<num_bits)|(r->current_word>>(32-num_bits));
+
+	r->bits_left=32-num_bits;
+
+	return result;
+}
+
+static inline uint_32 get_ref(uint_32 num_bits,reader_ref *r)
+{
+	uint_32 result;
+
+	if(num_bits<r->bits_left)
+	{
+		result=(r->current_word<<(32-r->bits_left))>>(32-num_bits);
+		r->bits_left-=num_bits;
+		return result;
+	}
+	return get_bh_ref(num_bits,r);
+}
+
+// ----
+
+#define FRAMES		192
+#define MAX_FRAME	3840
+
+typedef struct
+{
+	uint_8 *data;
+	int size;			// bytes
+	int frame_bytes;
+}stream;
+
+static ac3_state s;
+static sint_16 pcm[6][6*256];
+
+static void state_init(ac3_state *st)
+{
+	memset(st,0,sizeof(ac3_state));
+	st->left=pcm[0]; st->center=pcm[1]; st->right=pcm[2];
+	st->sleft=pcm[3]; st->sright=pcm[4]; st->subwoofer=pcm[5];
+	ac3_init(st);
+}
+
+static int gen_stream(stream *st,int acmod,int lfeon,int frmsizecod,dword seed)
+{
+	st->data=(uint_8 *)malloc(FRAMES*MAX_FRAME);
+	st->size=ac3_generate(st->data,FRAMES,acmod,lfeon,frmsizecod,seed,NULL);
+	st->frame_bytes=st->size/FRAMES;
+	return st->size>0?0:-1;
+}
+
+// ---- crc and bit reader
+
+static int test_crc(const stream *st)
+{
+	static uint_8 buf[MAX_FRAME+64];
+	int errors=0;
+
+	// every length and alignment
+	for(int len=0;len<64;len++)
+		for(int align=0;align<8;align++)
+		{
+			for(int i=0;i<len;i++)
+				buf[align+i]=(uint_8)bench_rand();
+			s.state=(uint_16)bench_rand();
+			uint_16 ref=crc_ref(s.state,buf+align,len);
+			crc_process_frame(buf+align,len,&s);
+			if(s.state!=ref)
+				errors++;
+		}
+
+	// the generated frames are valid: zero over the frame after the sync word
+	for(int f=0;f<FRAMES;f++)
+	{
+		crc_init(&s);
+		crc_process_frame(st->data+f*st->frame_bytes+2,st->frame_bytes-2,&s);
+		if(!crc_validate(&s) || crc_ref(0,st->data+f*st->frame_bytes+2,st->frame_bytes-2))
+			errors++;
+	}
+	printf("crc: %d mismatches vs. byte-wise table\n",errors);
+
+	double best[2]={ 1e30,1e30 };
+	volatile uint_16 sink=0;
+	for(int r=0;r<20;r++)
+	{
+		double t0=bench_time();
+		for(int f=0;f<FRAMES;f++)
+			sink^=crc_ref(0,st->data+f*st->frame_bytes+2,st->frame_bytes-2);
+		double t1=bench_time();
+		for(int f=0;f<FRAMES;f++)
+		{
+			crc_init(&s);
+			crc_process_frame(st->data+f*st->frame_bytes+2,st->frame_bytes-2,&s);
+			sink^=s.state;
+		}
+		double t2=bench_time();
+		if(t1-t0<best[0]) best[0]=t1-t0;
+		if(t2-t1<best[1]) best[1]=t2-t1;
+	}
+	double mb=(double)FRAMES*(st->frame_bytes-2)/1e6;
+	printf("  byte-wise: %8.0f MB/s, slice-by-8: %8.0f MB/s (x%.2f)\n",mb/best[0],mb/best[1],best[0]/best[1]);
+
+	return errors;
+}
+
+// field widths of a syncframe: mostly 1..8 bit side information, mantissas of 3..16 bits
+#define FIELDS	8192
+
+// the 32-bit reader kept its state in ac3_state, as the cached reader does: in memory,
+// not in registers across the calls (a local reader_ref would be)
+static reader_ref r;
+
+static int test_reader(const stream *st)
+{
+	static uint_8 widths[FIELDS];
+	static uint_32 ref[FIELDS];
+	int errors=0;
+
+	for(int i=0;i<FIELDS;i++)
+	{
+		dword r=bench_rand();
+		widths[i]=(uint_8)((r&3)?1+(r>>8)%8:3+(r>>8)%14);
+	}
+	// the fields that fit in the frame body (the 32-bit reader has no end of frame)
+	int n=0;
+	for(int bits=0;n<FIELDS && bits+widths[n]<=(st->frame_bytes-5)*8;n++)
+		bits+=widths[n];
+
+	r.buffer_start=st->data+5;
+	r.bits_left=0;
+	r.current_word=0;
+	for(int i=0;i<n;i++)
+		ref[i]=get_ref(widths[i],&r);
+
+	memcpy(s.buffer,st->data+5,st->frame_bytes-5);
+	bitstream_set_frame(st->frame_bytes-5,&s);
+	uint_32 bits=40;
+	for(int i=0;i<n;i++)
+	{
+		if(bitstream_get(widths[i],&s)!=ref[i])
+			errors++;
+		bits+=widths[i];
+		if(bitstream_get_total_bits(&s)!=bits)
+			errors++;
+	}
+	// the rest of the frame, then zeroes
+	for(;bits+16<=(uint_32)st->frame_bytes*8;bits+=16)
+		bitstream_get(16,&s);
+	bitstream_get(st->frame_bytes*8-bits,&s);
+	for(int i=0;i<256;i++)
+		if(bitstream_get(1+i%32,&s)!=0)
+			errors++;
+	printf("bit reader: %d fields, %d mismatches vs. 32-bit reader\n",n,errors);
+
+	double best[2]={ 1e30,1e30 };
+	volatile uint_32 sink=0;
+	for(int rep=0;rep<20;rep++)
+	{
+		uint_32 x=0;
+		double t0=bench_time();
+		for(int k=0;k<16;k++)
+		{
+			r.buffer_start=st->data+5;
+			r.bits_left=0;
+			for(int i=0;i<n;i++)
+				x+=get_ref(widths[i],&r);
+		}
+		double t1=bench_time();
+		for(int k=0;k<16;k++)
+		{
+			bitstream_set_frame(st->frame_bytes-5,&s);
+			for(int i=0;i<n;i++)
+				x+=bitstream_get(widths[i],&s);
+		}
+		double t2=bench_time();
+		sink^=x;
+		if(t1-t0<best[0]) best[0]=t1-t0;
+		if(t2-t1<best[1]) best[1]=t2-t1;
+	}
+	printf("  per field: 32-bit %.2f ns, 64-bit cached %.2f ns (x%.2f)\n",
+		best[0]*1e9/(16*n),best[1]*1e9/(16*n),best[0]/best[1]);
+
+	return errors;
+}
+
+// ---- front end: crc, bsi and the audio blocks up to the mantissas (no IMDCT, no output)
+
+static int parse_frame(const uint_8 *frame,int *error_flag)
+{
+	uint_32 tmp=(frame[2]<<16)|(frame[3]<<8)|frame[4];
+
+	if(parse_syncinfo_header(&s.syncinfo,tmp,&s))
+		return -1;
+	int size=s.syncinfo.frame_size*2;
+	memcpy(s.buffer,frame+5,size-5);
+	bitstream_set_frame(size-5,&s);
+	if(parse_syncinfo_crc(&s.syncinfo,tmp,&s))
+		return -1;
+
+	parse_bsi(&s.bsi,&s);
+	s.ba_valid=0;
+	s.audblk.cpldeltbae=DELTA_BIT_NONE;
+	for(int i=0;i<5;i++)
+		s.audblk.deltbae[i]=DELTA_BIT_NONE;
+	for(int b=0;b<6;b++)
+	{
+		parse_audblk(&s.bsi,&s.audblk,b,error_flag,&s);
+		if(*error_flag)
+			return -1;
+		exponent_unpack(&s.bsi,&s.audblk,error_flag,&s);
+		if(*error_flag)
+			return -1;
+		bit_allocate(s.syncinfo.fscod,&s.bsi,&s.audblk,&s);
+		coeff_unpack(&s.bsi,&s.audblk,s.samples,error_flag,&s);
+		if(*error_flag)
+			return -1;
+	}
+	return 0;
+}
+
+static int test_front_end(const stream *st,const char *name)
+{
+	int errors=0;
+	double best=1e30;
+
+	state_init(&s);
+	for(int r=0;r<5;r++)
+	{
+		double t0=bench_time();
+		for(int f=0;f<FRAMES;f++)
+		{
+			int error_flag=0;
+			if(parse_frame(st->data+f*st->frame_bytes,&error_flag))
+				errors++;
+		}
+		double t=(bench_time()-t0)/FRAMES;
+		if(t<best)
+			best=t;
+	}
+	printf("front end, %s (%d bytes): %6.0f ns per frame, %.0f MB/s, %d bad frames\n",
+		name,st->frame_bytes,best*1e9,st->frame_bytes/best/1e6,errors/5);
+
+	return errors;
+}
+
+// ---- malformed input
+
+static void fix_crc(uint_8 *frame,int size)
+{
+	uint_16 crc=crc_ref(0,frame+2,size-4);
+	frame[size-2]=(uint_8)(crc>>8);
+	frame[size-1]=(uint_8)crc;
+}
+
+// one syncframe of the source, damaged; returns the bytes written to 'out'
+static int mutate(const stream *st,int f,uint_8 *out)
+{
+	int size=st->frame_bytes;
+	memcpy(out,st->data+f*size,size);
+
+	switch(bench_rand()%6)
+	{
+		case 0:		// bit flips
+			for(int n=1+bench_rand()%8;n;n--)
+			{
+				int bit=5*8+bench_rand()%((size-5)*8);
+				out[bit/8]^=(uint_8)(0x80>>(bit%8));
+			}
+			break;
+		case 1:		// a run of garbage
+			{
+				int len=1+bench_rand()%64,pos=5+bench_rand()%(size-5-len);
+				for(int i=0;i<len;i++)
+					out[pos+i]=(uint_8)bench_rand();
+			}
+			break;
+		case 2:		// garbage after the header
+			for(int i=5;i<size;i++)
+				out[i]=(uint_8)bench_rand();
+			break;
+		case 3:		// the bsi and the first block: the side information
+			for(int i=5;i<5+16;i++)
+				out[i]=(uint_8)bench_rand();
+			break;
+		case 4:		// fscod / frmsizecod: a different (or invalid) frame size
+			out[4]=(uint_8)bench_rand();
+			break;
+		case 5:		// truncated: the next syncframe starts early
+			size=6+bench_rand()%(size-6);
+			return size;
+	}
+	// most frames get a valid crc so that they are parsed
+	if(bench_rand()%4)
+		fix_crc(out,size);
+	return size;
+}
+
+typedef struct
+{
+	int calls,frames,bad;
+	double max_call;
+}fuzz_result;
+
+// the state before the call: a call slower than 'limit' is timed again (preemption)
+static ac3_state before;
+
+#define RETRIES	4
+
+static void fuzz_feed(const uint_8 *data,int size,double limit,fuzz_result *res)
+{
+	state_init(&s);
+	memset(res,0,sizeof(fuzz_result));
+
+	for(int pos=0;pos<size;)
+	{
+		int n=1+bench_rand()%4096,used=0,ret=0;
+		if(n>size-pos)
+			n=size-pos;
+		memcpy(&before,&s,sizeof(ac3_state));
+		double best=1e30;
+		for(int r=0;r<=RETRIES && best>limit;r++)
+		{
+			if(r)
+				memcpy(&s,&before,sizeof(ac3_state));
+			double t0=bench_time();
+			ret=ac3_feed(&s,data+pos,n,&used);
+			double t=bench_time()-t0;
+			if(t<best)
+				best=t;
+		}
+		res->calls++;
+		if(best>res->max_call)
+			res->max_call=best;
+		if(used<=0 && ret==0)
+		{
+			printf("!! ac3_feed() did not make progress at %d\n",pos);
+			res->bad=-1;
+			return;
+		}
+		pos+=used;
+		if(ret>0)
+			res->frames++;
+		if(ret<0)
+			res->bad++;
+	}
+}
+
+typedef struct
+{
+	const uint_8 *data;
+	int size,pos,eof;
+	uint_8 pad[4096];
+}pull_source;
+
+static void __stdcall fill_buffer(uint_8 **start,uint_8 **end,ac3_state *state,int)
+{
+	pull_source *src=(pull_source *)state->that;
+	if(src->pos<src->size)
+	{
+		// the driver passes one S/PDIF period at a time
+		int n=src->size-src->pos<1536?src->size-src->pos:1536;
+		*start=(uint_8 *)src->data+src->pos;
+		*end=*start+n;
+		src->pos+=n;
+	}
+	else
+	{
+		src->eof=1;
+		*start=src->pad;
+		*end=src->pad+sizeof(src->pad);
+	}
+}
+
+static void fuzz_pull(const uint_8 *data,int size,double limit,fuzz_result *res)
+{
+	static pull_source src,src_before;
+
+	state_init(&s);
+	memset(res,0,sizeof(fuzz_result));
+	memset(&src,0,sizeof(src));
+	src.data=data;
+	src.size=size;
+	s.fill_buffer=fill_buffer;
+	s.that=&src;
+
+	while(!src.eof)
+	{
+		int ret=0;
+		memcpy(&before,&s,sizeof(ac3_state));
+		src_before=src;
+		double best=1e30;
+		for(int r=0;r<=RETRIES && best>limit;r++)
+		{
+			if(r)
+			{
+				memcpy(&s,&before,sizeof(ac3_state));
+				src=src_before;
+			}
+			double t0=bench_time();
+			ret=ac3_decode_frame(&s);
+			double t=bench_time()-t0;
+			if(t<best)
+				best=t;
+		}
+		res->calls++;
+		if(best>res->max_call)
+			res->max_call=best;
+		if(ret)
+			res->bad++;
+		else
+			res->frames++;
+	}
+}
+
+// the decode time of a valid frame, best of several
+static double valid_frame_time(const stream *st)
+{
+	double best=1e30;
+	for(int r=0;r<5;r++)
+	{
+		state_init(&s);
+		for(int f=0;f<16;f++)
+		{
+			int used=0;
+			double t0=bench_time();
+			ac3_feed(&s,st->data+f*st->frame_bytes,st->frame_bytes,&used);
+			double t=bench_time()-t0;
+			if(t<best)
+				best=t;
+		}
+	}
+	return best;
+}
+
+static int test_fuzz(const stream *st,int frames)
+{
+	uint_8 *data=(uint_8 *)malloc((size_t)frames*MAX_FRAME+4096);
+	int size=0,errors=0;
+
+	for(int f=0;f<frames;f++)
+	{
+		// one frame in 8 is left intact: the decoder must resynchronize
+		if((f%8)==0)
+		{
+			memcpy(data+size,st->data+(f%FRAMES)*st->frame_bytes,st->frame_bytes);
+			size+=st->frame_bytes;
+		}
+		else
+			size+=mutate(st,f%FRAMES,data+size);
+	}
+	// S/PDIF noise: random bytes with sync words
+	for(int i=0;i<4096;i++)
+		data[size+i]=(uint_8)((bench_rand()%61)?bench_rand():0x0b);
+	size+=4096;
+
+	double valid=valid_frame_time(st);
+	fuzz_result r[2];
+	fuzz_feed(data,size,valid*2,&r[0]);
+	fuzz_pull(data,size,valid*2,&r[1]);
+
+	for(int m=0;m<2;m++)
+	{
+		printf("  %-16s %7d calls, %6d frames decoded, %6d rejected; slowest call %6.1f us (valid frame %.1f us)\n",
+			m?"ac3_decode_frame":"ac3_feed",r[m].calls,r[m].frames,r[m].bad,r[m].max_call*1e6,valid*1e6);
+		if(r[m].bad<0)
+			errors++;
+	}
+
+	// one call decodes one syncframe at most (or searches for one)
+	for(int m=0;m<2;m++)
+		if(r[m].max_call>valid*3)
+			errors++;
+
+	free(data);
+	return errors;
+}
+
+int bench_ac3parse(int argc,char **argv)
+{
+	int iter=4096;
+	int errors=0;
+
+	for(int i=1;i<argc;i++)
+		if(strcmp(argv[i],"-iter")==0 && i+1<argc)
+			iter=atoi(argv[++i]);
+
+	static stream st[2];
+	if(gen_stream(&st[0],7,1,30,0x1234567) || gen_stream(&st[1],2,0,20,0x7654321))
+	{
+		printf("cannot generate the streams\n");
+		return 1;
+	}
+
+	state_init(&s);
+	errors+=test_crc(&st[0]);
+	errors+=test_reader(&st[0]);
+	printf("\n");
+	errors+=test_front_end(&st[0],"3/2+lfe 448 kbps");
+	errors+=test_front_end(&st[1],"2/0 192 kbps");
+
+	for(int i=0;i<2;i++)
+	{
+		printf("\nmalformed input, %s: %d syncframes\n",i?"2/0":"3/2+lfe",iter);
+		errors+=test_fuzz(&st[i],iter);
+	}
+
+	for(int i=0;i<2;i++)
+		free(st[i].data);
+
+	return errors;
+}
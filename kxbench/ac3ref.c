@@ -0,0 +1,29 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// ac3/decode.c built against the previous IMDCT (ac3imdct.cpp), for the decode comparison
+
+#define ac3_init ac3_init_ref
+#define ac3_decode_frame ac3_decode_frame_ref
+#define ac3_feed ac3_feed_ref
+#define imdct_init imdct_init_ref
+#define imdct imdct_ref
+
+#include "../ac3/decode.c"
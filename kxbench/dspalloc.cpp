@@ -0,0 +1,207 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// allocate_microcode() / xTRAM placement: bit-by-bit first fit and sliding TRAM window
+// vs. the extent allocator, on a random load / unload sequence (kX Mixer session)
+
+#include "kxbench.h"
+#include "interface/ikx.h"
+#include "interface/dsp.h"
+#include "driver/dspalloc.h"
+
+#define BENCH_CODE_SIZE		E10K2_MAX_INSTRUCTIONS
+#define BENCH_XTRAM_SIZE	(16*1024*1024/2)	// 16Mb of 16-bit samples
+#define BENCH_SLOTS		48
+#define BENCH_STEPS		20000
+
+typedef struct
+{
+	int used;
+	int offset,size;
+	dword xtram_start,xtramsize;
+}bench_slot;
+
+typedef struct
+{
+	dword usage[BENCH_CODE_SIZE/32];
+	bench_slot slots[BENCH_SLOTS];
+	int failed_code,failed_tram;
+	double t_code,t_tram;
+}bench_state;
+
+#define get_bit(a,b) ((a[(b)/32]&(1<<((b)%32)))?1:0)
+#define set_bit(a,b) (a[(b)/32])|=(1<<(((b)%32)))
+#define clear_bit(a,b) (a[(b)/32])&=~(1<<(((b)%32)))
+
+// previous implementation (KX_MICROCODE_ANY)
+static int alloc_code_old(dword *usage,int size)
+{
+	for(int offset=0;offset<BENCH_CODE_SIZE;offset++)
+	{
+		if(!get_bit(usage,offset))
+		{
+			int i;
+			for(i=0;i<size && (offset+i)<BENCH_CODE_SIZE;i++)
+				if(get_bit(usage,offset+i))
+					break;
+			if(i==size)
+			{
+				for(i=0;i<size;i++)
+					set_bit(usage,offset+i);
+				return offset;
+			}
+			offset+=i-1;
+		}
+	}
+	return -1;
+}
+
+static int alloc_tram_old(bench_state *st,int self,dword size,dword *ret)
+{
+	dword start=0,end=size;
+	while(1)
+	{
+		int found=1;
+		for(int i=0;i<BENCH_SLOTS;i++)
+		{
+			bench_slot *s=&st->slots[i];
+			if(i==self || !s->used || (s->xtram_start==0 && s->xtramsize==0))
+				continue;
+			if((start>=s->xtram_start && start<=s->xtram_start+s->xtramsize) ||
+			   (end>=s->xtram_start && end<=s->xtram_start+s->xtramsize) ||
+			   (start<=s->xtram_start && end>=s->xtram_start+s->xtramsize))
+			{
+				found=0;
+				break;
+			}
+		}
+		if(found)
+			break;
+		start+=512;
+		end+=512;
+		if(end>=BENCH_XTRAM_SIZE)
+			return -1;
+	}
+	*ret=start;
+	return 0;
+}
+
+static int alloc_tram_new(bench_state *st,int self,dword size,dword *ret)
+{
+	kx_extent e[BENCH_SLOTS];
+	int n=0;
+	for(int i=0;i<BENCH_SLOTS;i++)
+	{
+		bench_slot *s=&st->slots[i];
+		if(i==self || !s->used || (s->xtram_start==0 && s->xtramsize==0))
+			continue;
+		n=kx_extent_insert(e,n,s->xtram_start,s->xtramsize);
+	}
+	return kx_extent_alloc(e,n,BENCH_XTRAM_SIZE,size,512,ret);
+}
+
+static void run(bench_state *st,int use_new,dword seed_base)
+{
+	memset(st,0,sizeof(bench_state));
+
+	dword seed=seed_base;
+	for(int step=0;step<BENCH_STEPS;step++)
+	{
+		seed^=seed<<13; seed^=seed>>17; seed^=seed<<5;
+		bench_slot *s=&st->slots[seed%BENCH_SLOTS];
+
+		if(s->used)
+		{
+			for(int i=s->offset;i<s->offset+s->size;i++)
+				clear_bit(st->usage,i);
+			s->used=0;
+			continue;
+		}
+
+		// typical da_*.cpp: 2..120 instructions; every 4th one has a delay line
+		s->size=2+(seed>>8)%119;
+		s->xtramsize=((seed>>16)&3)==0?(1000+(seed>>4)%200000):0;
+		s->xtram_start=0;
+
+		double t0=bench_time();
+		s->offset=use_new?kx_bitmap_alloc(st->usage,0,BENCH_CODE_SIZE,s->size,KX_ALLOC_BEST):alloc_code_old(st->usage,s->size);
+		st->t_code+=bench_time()-t0;
+		if(s->offset<0)
+		{
+			st->failed_code++;
+			continue;
+		}
+
+		if(s->xtramsize)
+		{
+			t0=bench_time();
+			int ret=use_new?alloc_tram_new(st,(int)(s-st->slots),s->xtramsize,&s->xtram_start):
+			                alloc_tram_old(st,(int)(s-st->slots),s->xtramsize,&s->xtram_start);
+			st->t_tram+=bench_time()-t0;
+			if(ret)
+			{
+				st->failed_tram++;
+				for(int i=s->offset;i<s->offset+s->size;i++)
+					clear_bit(st->usage,i);
+				continue;
+			}
+		}
+		s->used=1;
+	}
+}
+
+int bench_dspalloc(int argc,char **argv)
+{
+	static bench_state st[2];
+	int errors=0;
+	(void)argc; (void)argv;
+
+	dword seed=bench_rand()|1;
+	run(&st[0],0,seed);
+	run(&st[1],1,seed);
+
+	printf("%d load/unload steps, %d slots; %d instructions, %d xTRAM samples\n",
+		BENCH_STEPS,BENCH_SLOTS,BENCH_CODE_SIZE,BENCH_XTRAM_SIZE);
+	printf("%10s %14s %14s %12s %12s\n","","code time","xTRAM time","code fails","xTRAM fails");
+	for(int i=0;i<2;i++)
+		printf("%10s %12.1fus %12.1fus %12d %12d\n",i?"extent":"previous",
+			st[i].t_code*1e6,st[i].t_tram*1e6,st[i].failed_code,st[i].failed_tram);
+
+	kx_dsp_pool_info info;
+	kx_bitmap_stats(st[1].usage,0,BENCH_CODE_SIZE,&info);
+	printf("final code pool: %u free, largest %u, %u blocks, fragmentation %u%%\n",
+		info.free,info.largest_free,info.free_blocks,info.fragmentation);
+
+	// check: the statistics agree with the allocator
+	dword tmp[BENCH_CODE_SIZE/32];
+	memcpy(tmp,st[1].usage,sizeof(tmp));
+	if(info.largest_free && kx_bitmap_alloc(tmp,0,BENCH_CODE_SIZE,info.largest_free,KX_ALLOC_BEST)<0)
+	{
+		printf("!! largest free block cannot be allocated\n");
+		errors++;
+	}
+	memcpy(tmp,st[1].usage,sizeof(tmp));
+	if(kx_bitmap_alloc(tmp,0,BENCH_CODE_SIZE,info.largest_free+1,KX_ALLOC_BEST)>=0)
+	{
+		printf("!! block larger than the largest free one was allocated\n");
+		errors++;
+	}
+	return errors;
+}
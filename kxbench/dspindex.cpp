@@ -0,0 +1,191 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// find_dsp_register() cost: list walk + linear info[] scan vs. pgm map + register index
+
+#include "kxbench.h"
+#include "interface/dsp.h"
+#include "driver/dspindex.h"
+
+#define BENCH_PGMS	32		// microcodes loaded in a typical DSP setup
+#define BENCH_LOOKUPS	200000
+
+typedef struct
+{
+	int pgm;
+	dsp_register_info *info;
+	dword n;
+	kx_register_index *idx;
+}bench_pgm;
+
+static bench_pgm pgms[BENCH_PGMS];
+static bench_pgm *pgm_map[MAX_PGM_NUMBER];
+
+static void make_pgm(bench_pgm *p,int pgm,dword n)
+{
+	p->pgm=pgm;
+	p->n=n;
+	p->info=(dsp_register_info *)calloc(n,sizeof(dsp_register_info));
+
+	// same layout as da_*.cpp: inputs first (0x4000+), then everything else (0x8000+)
+	dword n_ins=n/10+1;
+	for(dword i=0;i<n;i++)
+	{
+		if(i<n_ins)
+		{
+			sprintf(p->info[i].name,"in%d",i);
+			p->info[i].num=(word)(0x4000+i);
+			p->info[i].type=GPR_INPUT;
+		}
+		else
+		{
+			sprintf(p->info[i].name,"r%d_%x",i,pgm);
+			p->info[i].num=(word)(0x8000+i-n_ins);
+			p->info[i].type=GPR_STATIC;
+		}
+		p->info[i].translated=DSP_REG_NOT_TRANSLATED;
+	}
+
+	word base[KX_INDEX_NUM_GROUPS],span[KX_INDEX_NUM_GROUPS];
+	p->idx=(kx_register_index *)malloc(kx_register_index_size(p->info,n,0,base,span));
+	kx_register_index_build(p->idx,p->info,n,NULL,0);
+	pgm_map[pgm]=p;
+}
+
+// previous implementation: walk the microcode list, then scan info[]
+static dsp_register_info *find_linear(int pgm,const char *name)
+{
+	for(int i=0;i<BENCH_PGMS;i++)
+	{
+		if(pgms[i].pgm!=pgm)
+			continue;
+		for(dword j=0;j<pgms[i].n;j++)
+			if(strncmp(name,pgms[i].info[j].name,MAX_GPR_NAME)==0)
+				return &pgms[i].info[j];
+		break;
+	}
+	return NULL;
+}
+
+static dsp_register_info *find_linear(int pgm,word id)
+{
+	for(int i=0;i<BENCH_PGMS;i++)
+	{
+		if(pgms[i].pgm!=pgm)
+			continue;
+		for(dword j=0;j<pgms[i].n;j++)
+			if(pgms[i].info[j].num==id)
+				return &pgms[i].info[j];
+		break;
+	}
+	return NULL;
+}
+
+static dsp_register_info *find_indexed(int pgm,const char *name)
+{
+	bench_pgm *p=pgm_map[pgm];
+	return p?kx_register_index_find(p->idx,name):NULL;
+}
+
+static dsp_register_info *find_indexed(int pgm,word id)
+{
+	bench_pgm *p=pgm_map[pgm];
+	return p?kx_register_index_find(p->idx,id):NULL;
+}
+
+int bench_dspindex(int argc,char **argv)
+{
+	static const dword sizes[]={ 50, 200, 500 };
+	int errors=0;
+	(void)argc; (void)argv;
+
+	printf("%d microcodes loaded; %d lookups per test; the measured microcode is the last one in the list\n",
+		BENCH_PGMS,BENCH_LOOKUPS);
+	printf("%6s %12s %12s %8s %12s %12s %8s\n","regs","name:linear","name:index","x","num:linear","num:index","x");
+
+	for(int s=0;s<(int)(sizeof(sizes)/sizeof(sizes[0]));s++)
+	{
+		int i;
+		memset(pgm_map,0,sizeof(pgm_map));
+		for(i=0;i<BENCH_PGMS;i++)
+			make_pgm(&pgms[i],i+1,i==BENCH_PGMS-1?sizes[s]:30);
+
+		int pgm=BENCH_PGMS;
+		bench_pgm *p=pgm_map[pgm];
+
+		// query set: existing registers plus 10% misses
+		char (*names)[MAX_GPR_NAME]=(char (*)[MAX_GPR_NAME])malloc(BENCH_LOOKUPS*MAX_GPR_NAME);
+		word *nums=(word *)malloc(BENCH_LOOKUPS*sizeof(word));
+		for(i=0;i<BENCH_LOOKUPS;i++)
+		{
+			dword r=bench_rand();
+			if(r%10==0)
+			{
+				strcpy(names[i],"missing");
+				nums[i]=(word)(0x8000+p->n+(r>>8)%16);
+			}
+			else
+			{
+				dsp_register_info *info=&p->info[(r>>8)%p->n];
+				memcpy(names[i],info->name,MAX_GPR_NAME);
+				nums[i]=info->num;
+			}
+		}
+
+		// results must match the linear search exactly
+		for(i=0;i<BENCH_LOOKUPS;i++)
+		{
+			if(find_linear(pgm,names[i])!=find_indexed(pgm,names[i]) ||
+			   find_linear(pgm,nums[i])!=find_indexed(pgm,nums[i]))
+			{
+				printf("!! lookup mismatch: '%s' / %x\n",names[i],nums[i]);
+				errors++;
+				break;
+			}
+		}
+
+		double t[4];
+		dword acc=0;
+		double t0=bench_time();
+		for(i=0;i<BENCH_LOOKUPS;i++) { dsp_register_info *r=find_linear(pgm,names[i]); acc+=r?r->num:0; }
+		t[0]=bench_time()-t0; t0=bench_time();
+		for(i=0;i<BENCH_LOOKUPS;i++) { dsp_register_info *r=find_indexed(pgm,names[i]); acc+=r?r->num:0; }
+		t[1]=bench_time()-t0; t0=bench_time();
+		for(i=0;i<BENCH_LOOKUPS;i++) { dsp_register_info *r=find_linear(pgm,nums[i]); acc+=r?r->num:0; }
+		t[2]=bench_time()-t0; t0=bench_time();
+		for(i=0;i<BENCH_LOOKUPS;i++) { dsp_register_info *r=find_indexed(pgm,nums[i]); acc+=r?r->num:0; }
+		t[3]=bench_time()-t0;
+
+		for(i=0;i<4;i++)
+			t[i]=t[i]*1e9/BENCH_LOOKUPS;
+
+		printf("%6d %10.1fns %10.1fns %7.1fx %10.1fns %10.1fns %7.1fx %s\n",sizes[s],
+			t[0],t[1],t[1]>0?t[0]/t[1]:0.0,t[2],t[3],t[3]>0?t[2]/t[3]:0.0,acc==0?"(?)":"");
+
+		free(names);
+		free(nums);
+		for(i=0;i<BENCH_PGMS;i++)
+		{
+			free(pgms[i].info);
+			free(pgms[i].idx);
+		}
+	}
+	return errors;
+}
@@ -0,0 +1,369 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// kxemu: reference interpreter vs. compiled engine (kxemu/jit.cpp)
+// every effect library microcode and a set of random programs (SKIP chains, ACCUM / CCR
+// operands, modulated and overlapping delay lines) is run on both engines with the same
+// random input, block sizes and parameter changes; outputs, registers, TRAM and
+// the DSP state should be bit-identical
+
+#include "kxbench.h"
+#include "hw/8010x.h"		// note: #undef's CCR; keep it before dsp.h
+#include "emu/kxemu.h"
+#include "emu/emufx.h"
+
+#define BENCH_CHANNELS		8
+#define BENCH_BLOCK		1024
+#define BENCH_XTRAM		(256*1024)	// bytes
+#define BENCH_PASSES		12
+#define BENCH_RANDOM		300		// random programs per chip
+#define BENCH_RANDOM_CODE	96
+
+typedef struct
+{
+	kx_emu *emu;
+	int pgm;
+	dword out[BENCH_BLOCK*BENCH_CHANNELS];
+	double t;
+}bench_engine;
+
+static dword in_buf[BENCH_BLOCK*BENCH_CHANNELS];
+
+static dword random_sample(void)
+{
+	switch(bench_rand()%4)
+	{
+		case 0: return 0;
+		case 1: return (dword)((int)bench_rand()>>12);	// quiet
+		default: return bench_rand();
+	}
+}
+
+static int engine_init(bench_engine *e,int is_10k2,int engine,const char *name,const dsp_code *code,int code_size,
+	const dsp_register_info *info,int info_size,int itramsize,int xtramsize)
+{
+	memset(e,0,sizeof(bench_engine));
+	if(kx_emu_create(&e->emu,is_10k2,BENCH_XTRAM))
+		return -1;
+	kx_emu_set_engine(e->emu,engine);
+
+	e->pgm=kx_emu_load_microcode(e->emu,name,code,code_size*sizeof(dsp_code),info,info_size*sizeof(dsp_register_info),
+		itramsize,xtramsize,"","","","","");
+	if(e->pgm<=0 || kx_emu_translate_microcode(e->emu,e->pgm) || kx_emu_enable_microcode(e->emu,e->pgm))
+		return -1;
+
+	// inputs: FXBus, outputs: physical outputs; unconnected i/o stays at C_0
+	int n_in=0,n_out=0;
+	for(int i=0;i<info_size;i++)
+	{
+		int type=info[i].type&GPR_MASK;
+		if(type==GPR_INPUT && n_in<BENCH_CHANNELS)
+		{
+			kx_emu_connect_microcode(e->emu,-1,(word)KX_FX(n_in),e->pgm,info[i].num);
+			kx_emu_bind_input(e->emu,(word)KX_FX(n_in),in_buf+n_in,BENCH_CHANNELS);
+			n_in++;
+		}
+		if(type==GPR_OUTPUT && n_out<BENCH_CHANNELS)
+		{
+			kx_emu_connect_microcode(e->emu,e->pgm,info[i].num,-1,(word)KX_OUT(n_out));
+			kx_emu_bind_output(e->emu,(word)KX_OUT(n_out),e->out+n_out,BENCH_CHANNELS);
+			n_out++;
+		}
+	}
+	return 0;
+}
+
+static void engine_close(bench_engine *e)
+{
+	if(e->emu)
+		kx_emu_destroy(e->emu);
+	e->emu=NULL;
+}
+
+// returns the first difference, or NULL
+static const char *engine_compare(bench_engine *a,bench_engine *b,int samples)
+{
+	kx_emu *x=a->emu,*y=b->emu;
+
+	if(memcmp(a->out,b->out,samples*BENCH_CHANNELS*sizeof(dword)))
+		return "output";
+	if(memcmp(x->regs,y->regs,KX_EMU_MAX_REGS*sizeof(dword)))	// the write sink is excluded
+		return "registers";
+	if(memcmp(x->itram,y->itram,KX_EMU_ITRAM_SIZE*sizeof(dword)))
+		return "iTRAM";
+	if(memcmp(x->xtram,y->xtram,x->xtram_size*sizeof(word)))
+		return "xTRAM";
+	if(x->accum!=y->accum || x->last_result!=y->last_result || x->last_sat!=y->last_sat)
+		return "ACCUM / CCR";
+	if(x->dbac!=y->dbac || x->noise!=y->noise || x->irq_count!=y->irq_count || x->samples!=y->samples)
+		return "DBAC / noise / IRQ";
+
+	kx_emu_pgm_stats sa,sb;
+	kx_emu_get_stats(x,a->pgm,&sa);
+	kx_emu_get_stats(y,b->pgm,&sb);
+	if(sa.executed!=sb.executed || sa.skipped!=sb.skipped)
+		return "statistics";
+	return NULL;
+}
+
+static void dump_regs(bench_engine *a,bench_engine *b)
+{
+	int shown=0;
+	for(int i=0;i<KX_EMU_MAX_REGS && shown<8;i++)
+		if(a->emu->regs[i]!=b->emu->regs[i])
+		{
+			printf("   reg 0x%03x: interpreter %08x, compiled %08x\n",i,a->emu->regs[i],b->emu->regs[i]);
+			shown++;
+		}
+}
+
+// runs the microcode on both engines; returns 0 if the results are identical
+static int run_pair(int is_10k2,const char *name,const dsp_code *code,int code_size,
+	const dsp_register_info *info,int info_size,int itramsize,int xtramsize,double *t_interp,double *t_jit,int verbose)
+{
+	bench_engine e[2];
+	int ret=0;
+
+	if(engine_init(&e[0],is_10k2,KX_EMU_ENGINE_INTERP,name,code,code_size,info,info_size,itramsize,xtramsize) ||
+	   engine_init(&e[1],is_10k2,KX_EMU_ENGINE_JIT,name,code,code_size,info,info_size,itramsize,xtramsize))
+	{
+		engine_close(&e[0]);
+		engine_close(&e[1]);
+		return 1; // does not fit: not an engine problem
+	}
+
+	for(int pass=0;pass<BENCH_PASSES && !ret;pass++)
+	{
+		// a new parameter set every few passes: SKIP counts, delay times, gains...
+		if(pass%4==3)
+			for(int i=0;i<info_size;i++)
+			{
+				int type=info[i].type&GPR_MASK;
+				if(type==GPR_CONTROL || type==GPR_STATIC || type==GPR_TRAMA)
+				{
+					dword v=(type==GPR_TRAMA)?(bench_rand()%4096)<<(is_10k2?11:0):random_sample();
+					if(bench_rand()%2)
+						continue;
+					kx_emu_set_dsp_register(e[0].emu,e[0].pgm,info[i].num,v);
+					kx_emu_set_dsp_register(e[1].emu,e[1].pgm,info[i].num,v);
+				}
+			}
+
+		// odd block sizes: the DSP state is carried over between calls
+		int samples=(pass%3==0)?BENCH_BLOCK:(int)(bench_rand()%BENCH_BLOCK)+1;
+		for(int i=0;i<samples*BENCH_CHANNELS;i++)
+			in_buf[i]=random_sample();
+
+		for(int k=0;k<2;k++)
+		{
+			double t=bench_time();
+			kx_emu_process(e[k].emu,samples);
+			e[k].t+=bench_time()-t;
+		}
+
+		const char *diff=engine_compare(&e[0],&e[1],samples);
+		if(diff)
+		{
+			printf("!! %s (%s): %s differ after pass %d (%d samples)\n",name,is_10k2?"10k2":"10k1",diff,pass,samples);
+			if(verbose)
+				dump_regs(&e[0],&e[1]);
+			ret=2;
+		}
+	}
+
+	*t_interp+=e[0].t;
+	*t_jit+=e[1].t;
+
+	engine_close(&e[0]);
+	engine_close(&e[1]);
+	return ret;
+}
+
+// random microcode: GPRs, hardware constants and special registers, a few delay lines
+static word rnd_pick(const word *set,int n)
+{
+	return set[bench_rand()%n];
+}
+
+static int make_random(dsp_code *code,dsp_register_info *info,int *info_size,int is_10k2)
+{
+	static const word consts[]={ C_0,C_1,C_2,C_3,C_4,C_8,C_10,C_20,C_100,C_10000,C_80000,C_10000000,C_20000000,C_40000000,
+		C_80000000,C_7fffffff,C_ffffffff,C_fffffffe,C_c0000000,C_4f1bbcdc,C_5a7ef9db,C_00100000 };
+	static const word specials[]={ ACCUM,CCR,NOISE1,NOISE2,DBAC };
+	static const word counts[]={ C_0,C_1,C_2,C_3,C_4,C_8 };
+
+	word gprs[32],dst[32],tram_addr[8];
+	int n_gprs=0,n_dst=0,n_addr=0,n=0;
+
+	memset(info,0,64*sizeof(dsp_register_info));
+
+	#define RND_REG(nm,tp,val) { sprintf(info[n].name,nm "%d",n); info[n].num=(word)(0x8000+n); info[n].type=(byte)(tp); info[n].translated=0xffff; info[n].p=(val); n++; }
+
+	for(int i=0;i<2;i++)
+	{
+		RND_REG("in",GPR_INPUT,0);
+		info[n-1].num=(word)(0x4000+i);
+		gprs[n_gprs++]=info[n-1].num;
+		RND_REG("out",GPR_OUTPUT,0);
+		gprs[n_gprs++]=dst[n_dst++]=info[n-1].num;
+	}
+	for(int i=0;i<10;i++)
+	{
+		RND_REG("s",GPR_STATIC,random_sample());
+		gprs[n_gprs++]=dst[n_dst++]=info[n-1].num;
+	}
+	for(int i=0;i<3;i++)
+	{
+		RND_REG("t",GPR_TEMP,0);
+		gprs[n_gprs++]=dst[n_dst++]=info[n-1].num;
+	}
+
+	// delay lines: short distances between the taps make sample periods depend on each other
+	int lines=bench_rand()%5;
+	for(int i=0;i<lines;i++)
+	{
+		int ext=bench_rand()%2;
+		int type=(ext?GPR_XTRAM:GPR_ITRAM)|((bench_rand()%2)?TRAM_WRITE:TRAM_READ);
+		dword addr=(bench_rand()%3)?(bench_rand()%24):(bench_rand()%200);
+		RND_REG("d",type,0);
+		gprs[n_gprs++]=dst[n_dst++]=info[n-1].num;
+		RND_REG("&d",GPR_TRAMA,addr<<(is_10k2?11:0));
+		tram_addr[n_addr++]=info[n-1].num;
+	}
+	*info_size=n;
+	#undef RND_REG
+
+	int size=8+bench_rand()%BENCH_RANDOM_CODE;
+	for(int pc=0;pc<size;pc++)
+	{
+		dsp_code *c=&code[pc];
+		word operands[4];
+
+		for(int k=0;k<4;k++)
+		{
+			int what=bench_rand()%10;
+			if(what<6)
+				operands[k]=rnd_pick(gprs,n_gprs);
+			else if(what<8)
+				operands[k]=rnd_pick(consts,sizeof(consts)/sizeof(consts[0]));
+			else
+				operands[k]=rnd_pick(specials,sizeof(specials)/sizeof(specials[0]));
+		}
+
+		c->op=(byte)(bench_rand()%16);
+		c->r=rnd_pick(dst,n_dst);
+		c->a=operands[1];
+		c->x=operands[2];
+		c->y=operands[3];
+
+		switch(bench_rand()%16)
+		{
+			case 0: if(n_addr) c->r=rnd_pick(tram_addr,n_addr); break;	// modulated delay
+			case 1: c->r=operands[0]; break;				// writes to read-only registers
+			case 2: c->r=IRQREG; break;
+			case 3: c->a=ACCUM; break;
+		}
+
+		if(c->op==SKIP)
+		{
+			c->a=(bench_rand()%4)?CCR:c->a;
+			c->x=(bench_rand()%2)?rnd_pick(gprs,n_gprs):rnd_pick(consts,sizeof(consts)/sizeof(consts[0]));
+			c->y=(bench_rand()%4)?rnd_pick(counts,sizeof(counts)/sizeof(counts[0])):rnd_pick(gprs,n_gprs);
+		}
+	}
+	return size;
+}
+
+int bench_dspjit(int argc,char **argv)
+{
+	const char *only=NULL;
+	int verbose=0,failed=0,tested=0,skipped=0;
+	double ti_all=0.0,tj_all=0.0;
+
+	for(int i=1;i<argc;i++)
+	{
+		if(strcmp(argv[i],"-v")==0)
+			verbose=1;
+		else
+			only=argv[i];
+	}
+
+	printf("%d passes of up to %d samples per microcode\n",BENCH_PASSES,BENCH_BLOCK);
+	printf("%-24s %6s %14s %14s %8s\n","microcode","code","interpreter","compiled","speedup");
+
+	for(int i=0;kx_emu_fx_library[i].name;i++)
+	{
+		const kx_emu_fx *m=&kx_emu_fx_library[i];
+		if(only && strcmp(only,m->name))
+			continue;
+
+		double ti=0.0,tj=0.0;
+		int ret=0;
+		for(int is_10k2=0;is_10k2<2;is_10k2++)
+		{
+			int r=run_pair(is_10k2,m->name,m->code,m->code_size,m->info,m->info_size,*m->itramsize,*m->xtramsize,&ti,&tj,verbose);
+			if(r>ret)
+				ret=r;
+		}
+		if(ret==1 && ti==0.0)
+		{
+			skipped++;
+			continue;
+		}
+		tested++;
+		if(ret==2)
+			failed++;
+
+		ti_all+=ti;
+		tj_all+=tj;
+		if(verbose || ret==2)
+			printf("%-24s %6d %12.2fms %12.2fms %7.2fx\n",m->name,m->code_size,ti*1000.0,tj*1000.0,tj>0.0?ti/tj:0.0);
+	}
+	printf("%-24s %6s %12.2fms %12.2fms %7.2fx\n","effect library","",ti_all*1000.0,tj_all*1000.0,tj_all>0.0?ti_all/tj_all:0.0);
+	printf("%d microcode tested, %d mismatches, %d not loaded\n",tested,failed,skipped);
+
+	if(!only)
+	{
+		dsp_code code[8+BENCH_RANDOM_CODE];
+		dsp_register_info info[64];
+		int info_size,random_failed=0;
+		double ti=0.0,tj=0.0;
+
+		for(int is_10k2=0;is_10k2<2;is_10k2++)
+			for(int i=0;i<BENCH_RANDOM;i++)
+			{
+				char name[32];
+				sprintf(name,"random%d",i);
+				int size=make_random(code,info,&info_size,is_10k2);
+				if(run_pair(is_10k2,name,code,size,info,info_size,256,1024,&ti,&tj,verbose)==2)
+					random_failed++;
+			}
+		printf("%-24s %6s %12.2fms %12.2fms %7.2fx\n","random microcode","",ti*1000.0,tj*1000.0,tj>0.0?ti/tj:0.0);
+		printf("%d random microcode tested, %d mismatches\n",2*BENCH_RANDOM,random_failed);
+		failed+=random_failed;
+	}
+
+	if(failed)
+	{
+		printf("!! engines differ\n");
+		return -1;
+	}
+	return 0;
+}
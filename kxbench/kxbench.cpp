@@ -0,0 +1,105 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+#include "kxbench.h"
+
+#if defined(WIN32)
+	#include <windows.h>
+#else
+	#include <time.h>
+	#include <sys/time.h>
+#endif
+
+double bench_time(void)
+{
+#if defined(WIN32)
+	LARGE_INTEGER f,c;
+	QueryPerformanceFrequency(&f);
+	QueryPerformanceCounter(&c);
+	return (double)c.QuadPart/(double)f.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv,NULL);
+	return (double)tv.tv_sec+(double)tv.tv_usec/1000000.0;
+#endif
+}
+
+static dword bench_seed=0x2545f491;
+
+dword bench_rand(void)
+{
+	bench_seed^=bench_seed<<13;
+	bench_seed^=bench_seed>>17;
+	bench_seed^=bench_seed<<5;
+	return bench_seed;
+}
+
+typedef struct
+{
+	const char *name;
+	const char *help;
+	int (*func)(int argc,char **argv);
+}bench_t;
+
+static bench_t benchmarks[]=
+{
+	{ "dspindex", "DSP register lookup: linear search vs. register index", bench_dspindex },
+	{ "dspalloc", "DSP instruction / xTRAM allocation: first fit scan vs. extent allocator", bench_dspalloc },
+	{ "dspjit", "DSP emulator: reference interpreter vs. compiled engine (bit-exactness and speed)", bench_dspjit },
+	{ "synthcalc", "synth unit conversions: double precision vs. fixed-point tables (accuracy and speed)", bench_synthcalc },
+	{ "sfparse", "SoundFont parser: fread / small uploads vs. memory-mapped reader / large uploads", bench_sfparse },
+	{ "ac3imdct", "AC-3 IMDCT: radix-2 with static buffers vs. split-radix (SSE), per-stream state", bench_ac3imdct },
+	{ "ac3dec", "AC-3 decoder library: push-style decoding of many streams on a thread pool (scaling)", bench_ac3dec },
+	{ "ac3out", "AC-3 output stage: fused downmix, dither, saturation and packing vs. per-sample conversion", bench_ac3out },
+	{ "ac3balloc", "AC-3 exponents and bit allocation: per-bin logadd vs. band tables, per-channel reuse (bit-exactness)", bench_ac3balloc },
+	{ "ac3parse", "AC-3 syncframe parsing: byte-wise crc and 32-bit reader vs. slice-by-8 crc and 64-bit cached reader, malformed input", bench_ac3parse },
+	{ NULL, NULL, NULL }
+};
+
+int main(int argc,char **argv)
+{
+	printf("kX Driver micro-benchmarks\n");
+
+	if(argc<2)
+	{
+		printf("usage: kxbench <benchmark|all> [options]\n");
+		for(int i=0;benchmarks[i].name;i++)
+			printf("  %-12s %s\n",benchmarks[i].name,benchmarks[i].help);
+		return 1;
+	}
+
+	int ret=0,found=0;
+	for(int i=0;benchmarks[i].name;i++)
+	{
+		if(strcmp(argv[1],"all")==0 || strcmp(argv[1],benchmarks[i].name)==0)
+		{
+			printf("\n--- %s: %s\n",benchmarks[i].name,benchmarks[i].help);
+			found=1;
+			if(benchmarks[i].func(argc-1,argv+1))
+				ret=2;
+		}
+	}
+	if(!found)
+	{
+		printf("unknown benchmark: '%s'\n",argv[1]);
+		return 1;
+	}
+	return ret;
+}
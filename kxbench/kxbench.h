@@ -0,0 +1,57 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// kxbench: host-side micro-benchmarks for driver algorithms
+// each benchmark compiles the OS-independent part of the driver code on the host
+// and compares it against the previous implementation
+
+#ifndef KXBENCH_H_
+#define KXBENCH_H_
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "defs.h"
+
+// high resolution timer, seconds
+double bench_time(void);
+
+// simple xorshift generator: benchmarks must be reproducible
+dword bench_rand(void);
+
+// benchmarks
+int bench_dspindex(int argc,char **argv);
+int bench_dspalloc(int argc,char **argv);
+int bench_dspjit(int argc,char **argv);
+int bench_synthcalc(int argc,char **argv);
+int bench_sfparse(int argc,char **argv);
+int bench_ac3imdct(int argc,char **argv);
+int bench_ac3dec(int argc,char **argv);
+int bench_ac3out(int argc,char **argv);
+int bench_ac3balloc(int argc,char **argv);
+int bench_ac3parse(int argc,char **argv);
+
+// ac3enc.cpp: synthetic AC-3 stream, 48 kHz, 'frames' syncframes of frmsizecod's size
+// ref (optional): the source, [frame][channel 0..5][1536] in the decoder's samples[] order (acmod)
+// returns the size written to 'out', bytes
+int ac3_generate(unsigned char *out,int frames,int acmod,int lfeon,int frmsizecod,dword seed,float *ref);
+
+#endif
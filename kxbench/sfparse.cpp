@@ -0,0 +1,553 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// SoundFont parser (iKX::parse_soundfont(), interface/sfreader.h): fread / fseek parser with
+// 4084-byte uploads vs. the memory-mapped reader with KX_SF_UPLOAD_CHUNK uploads
+// kxbench sfparse [file.sf2]       correctness, truncated / corrupted fonts, two fonts at a time,
+//                                  parse + upload throughput (a generated font or 'file.sf2')
+
+#include "kxbench.h"
+#include "interface/ikx.h"
+#include "interface/dsp.h"
+#include "interface/soundfont.h"
+#include "interface/sfreader.h"
+
+// generated font
+typedef struct
+{
+	byte *data;
+	size_t size,alloc;
+	size_t smpl;			// offset of the sample data
+	size_t tables[9];		// offsets of the pdta tables (phdr...shdr)
+}gen_font;
+
+static void put(gen_font *f,const void *data,size_t size)
+{
+	if(f->size+size>f->alloc)
+	{
+		f->alloc=(f->size+size)*2;
+		f->data=(byte *)realloc(f->data,f->alloc);
+	}
+	memcpy(f->data+f->size,data,size);
+	f->size+=size;
+}
+
+static void put_dword(gen_font *f,dword v)
+{
+	byte b[4]={ (byte)v,(byte)(v>>8),(byte)(v>>16),(byte)(v>>24) };
+	put(f,b,4);
+}
+
+static size_t begin_chunk(gen_font *f,const char *id,const char *list_id)
+{
+	put(f,id,4);
+	size_t at=f->size;
+	put_dword(f,0);
+	if(list_id)
+		put(f,list_id,4);
+	return at;
+}
+
+static void end_chunk(gen_font *f,size_t at)
+{
+	dword size=(dword)(f->size-at-4);
+	for(int i=0;i<4;i++)
+		f->data[at+i]=(byte)(size>>(i*8));
+}
+
+// 'presets' presets of 2 zones -> 'insts' instruments of 2 zones -> 'samples' samples
+static void generate(gen_font *f,int presets,int insts,int samples,int sample_frames,dword seed)
+{
+	memset(f,0,sizeof(gen_font));
+
+	size_t riff=begin_chunk(f,"RIFF","sfbk");
+
+	size_t list=begin_chunk(f,"LIST","INFO");
+	size_t c=begin_chunk(f,"ifil",NULL);
+	put_dword(f,0x00010002);
+	end_chunk(f,c);
+	c=begin_chunk(f,"INAM",NULL);
+	put(f,"kxbench font\0\0",14);
+	end_chunk(f,c);
+	end_chunk(f,list);
+
+	list=begin_chunk(f,"LIST","sdta");
+	c=begin_chunk(f,"smpl",NULL);
+	f->smpl=f->size;
+	for(int i=0;i<samples;i++)
+	{
+		for(int j=0;j<sample_frames;j++)
+		{
+			short v=(short)(seed*(i+1)+j*7);
+			put(f,&v,2);
+		}
+		short zero[46];
+		memset(zero,0,sizeof(zero));
+		put(f,zero,sizeof(zero));
+	}
+	end_chunk(f,c);
+	end_chunk(f,list);
+
+	list=begin_chunk(f,"LIST","pdta");
+
+	c=begin_chunk(f,"phdr",NULL);
+	f->tables[0]=f->size;
+	for(int i=0;i<=presets;i++)
+	{
+		sfPresetHeader p;
+		memset(&p,0,sizeof(p));
+		sprintf(p.name,i<presets?"preset %d":"EOP",i);
+		p.preset=(word)(i&0x7f);
+		p.bank=(word)(i>>7);
+		p.preset_bag_ndx=(word)(i*2);
+		put(f,&p,sizeof(p));
+	}
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"pbag",NULL);
+	f->tables[1]=f->size;
+	for(int i=0;i<=presets*2;i++)
+	{
+		sfModGenBag b={ (word)(i*2),0 };
+		put(f,&b,sizeof(b));
+	}
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"pmod",NULL);
+	f->tables[2]=f->size;
+	sfModList m;
+	memset(&m,0,sizeof(m));
+	put(f,&m,sizeof(m));
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"pgen",NULL);
+	f->tables[3]=f->size;
+	for(int i=0;i<presets*2;i++)
+	{
+		sfGenList g;
+		g.gen_oper=48; // attenuation
+		g.gen_amount.amount_w=(word)i;
+		put(f,&g,sizeof(g));
+		g.gen_oper=41; // instrument
+		g.gen_amount.amount_w=(word)(i%insts);
+		put(f,&g,sizeof(g));
+	}
+	sfGenList end={ 0,{ { 0,0 } } };
+	put(f,&end,sizeof(end));
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"inst",NULL);
+	f->tables[4]=f->size;
+	for(int i=0;i<=insts;i++)
+	{
+		sfInst in;
+		memset(&in,0,sizeof(in));
+		sprintf(in.name,i<insts?"inst %d":"EOI",i);
+		in.inst_bag_ndx=(word)(i*2);
+		put(f,&in,sizeof(in));
+	}
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"ibag",NULL);
+	f->tables[5]=f->size;
+	for(int i=0;i<=insts*2;i++)
+	{
+		sfModGenBag b={ (word)(i*2),0 };
+		put(f,&b,sizeof(b));
+	}
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"imod",NULL);
+	f->tables[6]=f->size;
+	put(f,&m,sizeof(m));
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"igen",NULL);
+	f->tables[7]=f->size;
+	for(int i=0;i<insts*2;i++)
+	{
+		sfGenList g;
+		g.gen_amount.range.lo=(byte)((i&1)*64);
+		g.gen_amount.range.high=(byte)((i&1)*64+63);
+		g.gen_oper=43; // key range
+		put(f,&g,sizeof(g));
+		g.gen_oper=53; // sample
+		g.gen_amount.amount_w=(word)(i%samples);
+		put(f,&g,sizeof(g));
+	}
+	put(f,&end,sizeof(end));
+	end_chunk(f,c);
+
+	c=begin_chunk(f,"shdr",NULL);
+	f->tables[8]=f->size;
+	for(int i=0;i<=samples;i++)
+	{
+		sfSample s;
+		memset(&s,0,sizeof(s));
+		sprintf(s.name,i<samples?"sample %d":"EOS",i);
+		if(i<samples)
+		{
+			s.start=(dword)(i*(sample_frames+46));
+			s.end=s.start+sample_frames;
+			s.start_loop=s.start+8;
+			s.end_loop=s.end-8;
+			s.sample_rate=44100;
+			s.original_key=60;
+			s.sample_type=monoSample;
+		}
+		put(f,&s,sizeof(s));
+	}
+	end_chunk(f,c);
+
+	end_chunk(f,list);
+	end_chunk(f,riff);
+}
+
+static int write_file(const char *name,const gen_font *f)
+{
+	FILE *fo=fopen(name,"wb");
+	if(!fo)
+		return -1;
+	int ret=(fwrite(f->data,1,f->size,fo)==f->size)?0:-1;
+	fclose(fo);
+	return ret;
+}
+
+// KX_PROP_SOUNDFONT_LOAD_SMPL as seen by kx_load_soundfont_samples()
+typedef struct
+{
+	byte *data;			// sample_len+4
+	int size;
+	int blocks;
+	int errors;
+}upload_target;
+
+static int upload_block(void *context,sf_load_sample_property *block,int block_size)
+{
+	upload_target *t=(upload_target *)context;
+	t->blocks++;
+	if(block->size<0 || block->size>KX_SF_UPLOAD_CHUNK || block_size!=(int)offsetof(sf_load_sample_property,data)+block->size ||
+	   block->pos<0 || block->pos+block->size>t->size || (block->pos%KX_SF_UPLOAD_CHUNK)!=0)
+	{
+		t->errors++;
+		return -1;
+	}
+	memcpy(t->data+block->pos,block->data,block->size);
+	return 0;
+}
+
+static int upload_target_init(upload_target *t,int sample_len)
+{
+	memset(t,0,sizeof(upload_target));
+	t->size=sample_len+4;
+	t->data=(byte *)malloc(t->size);
+	return t->data?0:-1;
+}
+
+// previous implementation (parse.cpp): tables are read into allocated memory; the file is read
+// again for the upload, one 4084-byte property at a time
+static int legacy_parse(const char *name,upload_target *t,sfHeader *h,void **tables)
+{
+	FILE *f=fopen(name,"rb");
+	if(!f)
+		return -1;
+
+	static const char *ids[9]={ "phdr","pbag","pmod","pgen","inst","ibag","imod","igen","shdr" };
+	static const int records[9]={ sizeof(sfPresetHeader),sizeof(sfModGenBag),sizeof(sfModList),sizeof(sfGenList),
+		sizeof(sfInst),sizeof(sfModGenBag),sizeof(sfModList),sizeof(sfGenList),sizeof(sfSample) };
+	int *counts[9]={ &h->presets,&h->preset_bags,&h->pmodlists,&h->pgenlists,&h->insts,&h->inst_bags,
+		&h->imodlists,&h->igenlists,&h->samples };
+
+	memset(h,0,sizeof(sfHeader));
+	char id[4];
+	dword size;
+	long sf_pos=0;
+
+	fseek(f,12,SEEK_SET);
+	while(fread(id,1,4,f)==4 && fread(&size,4,1,f)==1)
+	{
+		fread(id,1,4,f);
+		long end=ftell(f)+(long)size-4;
+		if(memcmp(id,"sdta",4)==0)
+		{
+			fread(id,1,4,f);
+			fread(&size,4,1,f);
+			h->sample_len=(int)size;
+			sf_pos=ftell(f);
+		}
+		else if(memcmp(id,"pdta",4)==0)
+		{
+			while(ftell(f)<end && fread(id,1,4,f)==4 && fread(&size,4,1,f)==1)
+			{
+				for(int i=0;i<9;i++)
+					if(memcmp(id,ids[i],4)==0)
+					{
+						tables[i]=malloc(size+1);
+						fread(tables[i],1,size,f);
+						*counts[i]=(int)size/records[i];
+						size=0;
+					}
+				fseek(f,size,SEEK_CUR);
+			}
+		}
+		fseek(f,end,SEEK_SET);
+	}
+
+	// upload
+	fseek(f,sf_pos,SEEK_SET);
+	int ret=0;
+	for(int pos=0,count=h->sample_len+4;count>0 && ret==0;)
+	{
+		sf_load_sample_property sf_l;
+		char tmp_mem[4096-12];
+		int sfl_size=(count<(4096-12))?count:(4096-12);
+		fread(tmp_mem,4096-12,1,f);
+		sf_l.id=1;
+		sf_l.size=sfl_size;
+		sf_l.pos=pos;
+		memcpy(&sf_l.data[0],tmp_mem,sfl_size);
+
+		// as the driver: no alignment
+		t->blocks++;
+		memcpy(t->data+sf_l.pos,sf_l.data,sf_l.size);
+
+		count-=sfl_size;
+		pos+=sfl_size;
+	}
+	fclose(f);
+	return ret;
+}
+
+// parse + build + upload; returns 0 if everything matches the generated font
+static int check_font(const sf_reader *r,const gen_font *f)
+{
+	const void *tables[9]={ r->presets,r->preset_bags,r->pmodlists,r->pgenlists,r->insts,r->inst_bags,
+		r->imodlists,r->igenlists,r->samples };
+	for(int i=0;i<9;i++)
+		if((const byte *)tables[i]!=f->data+f->tables[i])
+			return -1;
+	if(r->sample_data!=f->data+f->smpl)
+		return -2;
+
+	kx_sound_font *fnt=sf_reader_build_font(r);
+	if(fnt==NULL)
+		return -3;
+	int errors=0;
+	dword magic;
+	memcpy(&magic,(byte *)fnt+fnt->size-r->header.sample_len-4-1,4);
+	if(magic!=KX_SOUNDFONT_MAGIC)
+		errors++;
+	if(memcmp(&fnt->data+(size_t)fnt->samples,f->data+f->tables[8],r->header.samples*sizeof(sfSample)))
+		errors++;
+	free(fnt);
+
+	upload_target t;
+	if(upload_target_init(&t,r->header.sample_len))
+		return -4;
+	if(sf_reader_upload_samples(r,1,KX_SF_UPLOAD_CHUNK,upload_block,&t) || t.errors ||
+	   memcmp(t.data,f->data+f->smpl,r->header.sample_len))
+		errors++;
+	memcpy(&magic,t.data+r->header.sample_len,4);
+	if(magic!=KX_SOUNDFONT_MAGIC)
+		errors++;
+	free(t.data);
+	return errors?-5:0;
+}
+
+// truncated fonts and random corruption of the chunk headers and tables: the reader must fail
+// cleanly or produce a font that can be uploaded (exact-size copies: out-of-bounds reads are
+// caught by memory checkers)
+static int fuzz(const gen_font *f,int rounds,int *rejected)
+{
+	int errors=0;
+	size_t pdta_end=f->size;
+	*rejected=0;
+
+	for(size_t len=0;len<f->size;len+=(len<64)?1:37)
+	{
+		byte *copy=(byte *)malloc(len+1);
+		memcpy(copy,f->data,len);
+		sf_reader r;
+		int ret=sf_reader_open_mem(&r,copy,len,0);
+		if(ret==0)
+			errors++; // the pdta list is at the end: truncated fonts must be rejected
+		sf_reader_close(&r);
+		free(copy);
+	}
+
+	for(int i=0;i<rounds;i++)
+	{
+		byte *copy=(byte *)malloc(f->size);
+		memcpy(copy,f->data,f->size);
+		int n=1+(int)(bench_rand()%4);
+		for(int j=0;j<n;j++)
+		{
+			// chunk headers and tables (the sample data is not interpreted)
+			size_t at=(bench_rand()&1)?f->tables[0]-8+bench_rand()%(pdta_end-f->tables[0]+8):bench_rand()%f->smpl;
+			switch(bench_rand()%3)
+			{
+				case 0: copy[at]^=(byte)(1<<(bench_rand()%8)); break;
+				case 1: copy[at]=(byte)bench_rand(); break;
+				case 2: copy[at]=0xff; break;
+			}
+		}
+
+		sf_reader r;
+		if(sf_reader_open_mem(&r,copy,f->size,0)==0)
+		{
+			kx_sound_font *fnt=sf_reader_build_font(&r);
+			upload_target t;
+			if(fnt==NULL || upload_target_init(&t,r.header.sample_len))
+				errors++;
+			else
+			{
+				if(sf_reader_upload_samples(&r,1,KX_SF_UPLOAD_CHUNK,upload_block,&t) || t.errors)
+					errors++;
+				free(t.data);
+			}
+			free(fnt);
+		}
+		else
+			(*rejected)++;
+		sf_reader_close(&r);
+		free(copy);
+	}
+	return errors;
+}
+
+int bench_sfparse(int argc,char **argv)
+{
+	const char *name_a="kxbench_sfparse_a.sf2",*name_b="kxbench_sfparse_b.sf2";
+	int errors=0;
+
+	gen_font a,b;
+	generate(&a,256,128,512,20000,0x1234);	// ~20 MB
+	generate(&b,16,8,16,1000,0x5678);
+	if(write_file(name_a,&a) || write_file(name_b,&b))
+	{
+		printf("cannot create '%s'\n",name_a);
+		return 1;
+	}
+
+	// correctness: in memory and mapped
+	sf_reader r;
+	int ret=sf_reader_open_mem(&r,a.data,a.size,0);
+	if(ret || check_font(&r,&a))
+	{
+		printf("!! generated font: parse error %d (%s)\n",ret,sf_reader_error(ret));
+		errors++;
+	}
+	sf_reader_close(&r);
+
+	// two fonts at a time: the readers do not share any state
+	sf_reader ra,rb;
+	int ret_a=sf_reader_open(&ra,name_a);
+	int ret_b=sf_reader_open(&rb,name_b);
+	gen_font fa=a,fb=b;
+	if(ret_a==0 && ret_b==0)
+	{
+		// check_font() compares the table pointers: re-base the generated offsets
+		fa.data=(byte *)ra.base;
+		fb.data=(byte *)rb.base;
+	}
+	if(ret_a || ret_b || check_font(&rb,&fb) || check_font(&ra,&fa) ||
+	   ra.header.presets!=257 || rb.header.presets!=17 || strcmp(ra.header.name,"kxbench font"))
+	{
+		printf("!! two fonts: parse error %d / %d\n",ret_a,ret_b);
+		errors++;
+	}
+	else
+		printf("two fonts at a time: ok (%d / %d presets, %d / %d bytes of sample data)\n",
+			ra.header.presets-1,rb.header.presets-1,ra.header.sample_len,rb.header.sample_len);
+	sf_reader_close(&ra);
+	sf_reader_close(&rb);
+
+	int rejected;
+	int fuzz_errors=fuzz(&b,20000,&rejected);
+	printf("truncated / corrupted fonts: %d errors (%d of %d corrupted fonts rejected)\n",fuzz_errors,rejected,20000);
+	errors+=fuzz_errors;
+
+	// throughput: parse + upload, the file is in the cache
+	const char *name=(argc>1)?argv[1]:name_a;
+	ret=sf_reader_open(&r,name);
+	if(ret)
+	{
+		printf("!! '%s': %s (%d)\n",name,sf_reader_error(ret),ret);
+		sf_reader_close(&r);
+		errors++;
+	}
+	else
+	{
+		printf("\n'%s': %d presets, %d instruments, %d samples, %.1f MB of sample data\n",name,
+			r.header.presets-1,r.header.insts-1,r.header.samples-1,r.header.sample_len/1048576.0);
+		int sample_len=r.header.sample_len;
+		sf_reader_close(&r);
+
+		#define ROUNDS 8
+		upload_target t,t_old;
+		if(upload_target_init(&t,sample_len) || upload_target_init(&t_old,sample_len))
+			return 1;
+
+		double t0=bench_time();
+		for(int i=0;i<ROUNDS;i++)
+		{
+			sfHeader h;
+			void *tables[9]={ NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL };
+			t_old.blocks=0;
+			legacy_parse(name,&t_old,&h,tables);
+			for(int j=0;j<9;j++)
+				free(tables[j]);
+		}
+		double t_old_s=(bench_time()-t0)/ROUNDS;
+
+		t0=bench_time();
+		for(int i=0;i<ROUNDS;i++)
+		{
+			t.blocks=0;
+			if(sf_reader_open(&r,name)==0)
+			{
+				kx_sound_font *fnt=sf_reader_build_font(&r);
+				sf_reader_upload_samples(&r,1,KX_SF_UPLOAD_CHUNK,upload_block,&t);
+				free(fnt);
+			}
+			sf_reader_close(&r);
+		}
+		double t_new_s=(bench_time()-t0)/ROUNDS;
+
+		if(memcmp(t.data,t_old.data,sample_len) || t.errors)
+		{
+			printf("!! uploaded sample data differs\n");
+			errors++;
+		}
+
+		printf("  fread, %5d-byte blocks:  %8.2f ms  %7.0f MB/s  (%d properties)\n",4096-12,
+			t_old_s*1000.0,sample_len/1048576.0/t_old_s,t_old.blocks);
+		printf("  mapped, %5d-byte blocks: %8.2f ms  %7.0f MB/s  (%d properties)\n",KX_SF_UPLOAD_CHUNK,
+			t_new_s*1000.0,sample_len/1048576.0/t_new_s,t.blocks);
+		free(t.data);
+		free(t_old.data);
+	}
+
+	remove(name_a);
+	remove(name_b);
+	free(a.data);
+	free(b.data);
+	return errors;
+}
@@ -0,0 +1,286 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// synth / volume unit conversions (synth.cpp, calc.cpp): double precision pow2() / pow10()
+// vs. the fixed-point tables (driver/fixmath.h)
+// kxbench synthcalc          accuracy report and note-on cost
+// kxbench synthcalc -tables <file>  writes the tables (h/driver/fixtbl.h)
+
+#include <math.h>
+
+#include "kxbench.h"
+#include "interface/ikx.h"
+#include "driver/fixmath.h"
+
+// previous implementation
+static int timecent_to_msec_old(int timecent)
+{
+	return (int)(1000 * pow(2.0,(double)timecent / 1200.0));
+}
+
+static int abscent_to_mHz_old(int abscents)
+{
+	return (int)(8176.0 * pow(2.0,(double)abscents / 1200.0));
+}
+
+static dword pitch_target_old(dword ip)
+{
+	return (dword)pow(2.0,(double)((float)ip/(float)0x1000));
+}
+
+static dword calc_volume_old(dword value,dword max)
+{
+	if(max!=0x80000000)
+		return (dword)(pow(10.0,(((double)(int)value)*(7.62939453125e-7)))*(double)max);
+	else
+		return (dword)(int)(-pow(10.0,(((double)(int)value)*(7.62939453125e-7)))*(double)max);
+}
+
+static int awe_cutoff_old(int n)
+{
+	return (int)(log10(((float)n*62.0f+100.0f)/8.176f)*3986.313713864834f);
+}
+
+// fixed point (as in synth.cpp, calc.cpp)
+static int timecent_to_msec_new(int timecent)
+{
+	return (int)kx_fixed_cents(timecent,1000);
+}
+
+static int abscent_to_mHz_new(int abscents)
+{
+	return (int)kx_fixed_cents(abscents,8176);
+}
+
+static dword pitch_target_new(dword ip)
+{
+	return kx_fixed_pow2((int)(ip<<4),1);
+}
+
+static dword calc_volume_new(dword value,dword max)
+{
+	if(max!=0x80000000)
+		return kx_fixed_db((int)value,max);
+	else
+		return 0-kx_fixed_db((int)value,max);
+}
+
+static int awe_cutoff_new(int n)
+{
+	return (int)(((__int64)(kx_fixed_log2((dword)(n*62+100)*1000)-kx_fixed_log2(8176))*1200)>>16);
+}
+
+// synth.cpp: attack_time_tbl_new, decay_time_tbl_new, calc_parm_search()
+static int attack_tbl[128] = {
+32767, 5656, 3999, 2828, 2378, 2000, 1682, 1414, 1297, 1189, 1091, 1000, 917, 841, 771, 649,
+622, 595, 570, 546, 523, 501, 479, 459, 439, 421, 403, 386, 370, 354, 339, 325,
+311, 298, 285, 273, 262, 251, 240, 230, 220, 211, 202, 193, 185, 177, 170, 163,
+156, 149, 143, 137, 131, 126, 120, 115, 110, 106, 101,  97,  93,  89,  85,  83,
+78, 75, 72, 69, 66, 63, 60, 58, 55, 53, 51, 49, 47, 45, 43, 41,
+39, 38, 36, 35, 33, 32, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21,
+20, 19, 18, 18, 17, 16, 15, 15, 14, 14, 13, 13, 12, 12, 11, 11,
+10, 10, 9,  9,  9,  8,  8,  8,  7,  7,  7,  7,  6,  6,  6,  5
+};
+
+static int decay_tbl[128] = {
+41487, 20744, 14668, 10372, 8722, 7334,6186, 5186, 4756, 4361, 3999, 3667, 3363, 3084, 2828, 2595,
+2593, 2483, 2378, 2277, 2181, 2088, 2000, 1915, 1834, 1756, 1682, 1611, 1542, 1477, 1414, 1354,
+1297, 1242, 1189, 1139, 1091, 1044, 958,  918 , 879,  842,  806,  772,  739,  708,  678,  649,
+622,  595,  570,  546,  523,  501,  479,  459,  440,  421,  403,  386,  370,  354, 339, 325,
+311, 298, 285, 273, 262, 251, 240, 230, 220, 211, 202, 193, 185, 177, 170, 163,
+156, 149, 143, 137, 131, 126, 120, 115, 110, 106, 101,  97,  93,  89,  85,  82,
+78, 75, 72, 69, 66, 63, 60, 58, 55, 53, 51, 49, 47, 45, 43, 41,
+39, 38, 36, 35, 33, 32, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21
+};
+
+static int parm_search(int msec,const int *table)
+{
+	int left = 1, right = 127, mid;
+	while(left < right)
+	{
+		mid = (left + right) / 2;
+		if(msec < (int)table[mid])
+			left = mid + 1;
+		else
+			right = mid;
+	}
+	return left;
+}
+
+static int write_tables(const char *name)
+{
+	FILE *f=fopen(name,"w");
+	if(!f)
+	{
+		printf("cannot create '%s'\n",name);
+		return 1;
+	}
+
+	fprintf(f,"// kX Driver\n// Copyright (c) Eugene Gavrilov, 2001-2014.\n// All rights reserved\n\n"
+	       "// generated by 'kxbench synthcalc -tables': do not edit\n"
+	       "// see driver/fixmath.h\n\n"
+	       "#ifndef KX_FIXTBL_H_\n#define KX_FIXTBL_H_\n\n"
+	       "#define KX_FIXED_TABLE_BITS\t%d\n\n",8);
+
+	// 2^(i/256), 2.30
+	fprintf(f,"static const dword kx_exp2_table[%d]=\n{",257);
+	for(int i=0;i<=256;i++)
+		fprintf(f,"%s0x%08x%s",(i%8)?" ":"\n ",(dword)floor(pow(2.0,i/256.0)*1073741824.0+0.5),i<256?",":"\n");
+	fprintf(f,"};\n\n");
+
+	// log2(1+i/256), 16.16
+	fprintf(f,"static const dword kx_log2_table[%d]=\n{",257);
+	for(int i=0;i<=256;i++)
+		fprintf(f,"%s0x%05x%s",(i%8)?" ":"\n ",(dword)floor(log(1.0+i/256.0)/log(2.0)*65536.0+0.5),i<256?",":"\n");
+	fprintf(f,"};\n\n#endif\n");
+	fclose(f);
+
+	printf("tables written to '%s'\n",name);
+	return 0;
+}
+
+typedef struct
+{
+	const char *name;
+	int inputs;
+	int mismatches;		// integer results that differ
+	double max_diff;	// largest difference, LSBs
+	double max_rel;		// largest relative error (results >= 10000: not truncation)
+}accuracy;
+
+static void add(accuracy *a,double o,double n)
+{
+	a->inputs++;
+	if(o==n)
+		return;
+	a->mismatches++;
+	double d=fabs(o-n);
+	if(d>a->max_diff)
+		a->max_diff=d;
+	if(fabs(o)>=10000.0 && d/fabs(o)>a->max_rel)
+		a->max_rel=d/fabs(o);
+}
+
+static void print(const accuracy *a)
+{
+	printf("%-28s %9d %11d %11.0f %12.2e\n",a->name,a->inputs,a->mismatches,a->max_diff,a->max_rel);
+}
+
+// conversions done per note-on by kx_synth_start(): recalc_sf(), recalc_modulation(),
+// recalc_pitch(), recalc_model()
+#define NOTE_TIMECENTS	15
+#define NOTE_ABSCENTS	2
+
+typedef struct
+{
+	int tc[NOTE_TIMECENTS];
+	int ac[NOTE_ABSCENTS];
+	dword ip;
+}note_params;
+
+int bench_synthcalc(int argc,char **argv)
+{
+	if(argc>2 && strcmp(argv[1],"-tables")==0)
+		return write_tables(argv[2]);
+
+	accuracy acc[9];
+	memset(acc,0,sizeof(acc));
+	acc[0].name="timecent_to_msec";
+	acc[1].name="abscent_to_mHz";
+	acc[2].name="pitch target";
+	acc[3].name="calc_volume(0xffff)";
+	acc[4].name="calc_volume(0x8000)";
+	acc[5].name="calc_volume(0x80000000)";
+	acc[6].name="AWE cutoff (abs cents)";
+	acc[7].name="attack (register)";
+	acc[8].name="decay/release (register)";
+
+	for(int tc=-12000;tc<=8000;tc++)
+	{
+		add(&acc[0],timecent_to_msec_old(tc),timecent_to_msec_new(tc));
+		add(&acc[7],parm_search(timecent_to_msec_old(tc),attack_tbl),parm_search(timecent_to_msec_new(tc),attack_tbl));
+		add(&acc[8],parm_search(timecent_to_msec_old(tc),decay_tbl)&0x7f,parm_search(timecent_to_msec_new(tc),decay_tbl)&0x7f);
+	}
+	for(int ac=-16000;ac<=4500;ac++)
+		add(&acc[1],abscent_to_mHz_old(ac),abscent_to_mHz_new(ac));
+	for(dword ip=0;ip<0x10000;ip++)
+		add(&acc[2],pitch_target_old(ip),pitch_target_new(ip));
+	for(int v=(int)KX_MIN_VOLUME;v<=0;v+=7)
+	{
+		add(&acc[3],calc_volume_old(v,0xffff),calc_volume_new(v,0xffff));
+		add(&acc[4],calc_volume_old(v,0x8000),calc_volume_new(v,0x8000));
+		add(&acc[5],(int)calc_volume_old(v,0x80000000),(int)calc_volume_new(v,0x80000000));
+	}
+	for(int n=1;n<128;n++)
+		add(&acc[6],awe_cutoff_old(n),awe_cutoff_new(n));
+
+	printf("%-28s %9s %11s %11s %12s\n","accuracy vs. double","inputs","mismatches","max diff","max rel err");
+	for(int i=0;i<9;i++)
+		print(&acc[i]);
+
+	// note-on cost
+	#define NOTES 4096
+	#define ROUNDS 64
+	static note_params notes[NOTES];
+	for(int i=0;i<NOTES;i++)
+	{
+		for(int j=0;j<NOTE_TIMECENTS;j++)
+			notes[i].tc[j]=(int)(bench_rand()%20000)-12000;
+		for(int j=0;j<NOTE_ABSCENTS;j++)
+			notes[i].ac[j]=(int)(bench_rand()%20500)-16000;
+		notes[i].ip=0xc000+bench_rand()%0x4000;
+	}
+
+	double t[2];
+	volatile dword sink=0;
+	for(int m=0;m<2;m++)
+	{
+		double t0=bench_time();
+		for(int r=0;r<ROUNDS;r++)
+		{
+			dword s=0;
+			for(int i=0;i<NOTES;i++)
+			{
+				const note_params *p=&notes[i];
+				for(int j=0;j<NOTE_TIMECENTS;j++)
+					s+=m?timecent_to_msec_new(p->tc[j]):timecent_to_msec_old(p->tc[j]);
+				for(int j=0;j<NOTE_ABSCENTS;j++)
+					s+=m?abscent_to_mHz_new(p->ac[j]):abscent_to_mHz_old(p->ac[j]);
+				s+=m?pitch_target_new(p->ip):pitch_target_old(p->ip);
+			}
+			sink+=s;
+		}
+		t[m]=(bench_time()-t0)/((double)NOTES*ROUNDS);
+	}
+
+	printf("\nnote-on conversions (%d timecents, %d abs cents, pitch):\n",NOTE_TIMECENTS,NOTE_ABSCENTS);
+	printf("  double: %8.1f ns/note (+ FPU state save/restore in the driver)\n",t[0]*1e9);
+	printf("  fixed:  %8.1f ns/note\n",t[1]*1e9);
+
+	// register values must not move by more than one step
+	int errors=0;
+	for(int i=0;i<9;i++)
+		if((i==2 || i==6 || i==7 || i==8) && acc[i].max_diff>1.0)
+		{
+			printf("!! %s: difference is too large\n",acc[i].name);
+			errors++;
+		}
+	return errors;
+}
@@ -504,7 +504,8 @@ int print_info(void)
 			{
 				for(dword i=0;i<sz/sizeof(sfHeader);i++)
 				{
-					printf("[%d] '%s'\n",hdr[i].rom_ver.minor,&hdr[i].name[0]);
+					printf("[%d] '%s' [%d KB; %d KB shared]\n",hdr[i].rom_ver.minor,&hdr[i].name[0],
+						hdr[i].sample_len/1024,hdr[i].sample_shared/1024);
 				}
 			} else { printf("Error enumerating sf\n"); sz=-2; }
 			free(hdr);
@@ -0,0 +1,204 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// emudsp.h
+// -----
+// host-side DSP emulator internals: instruction arithmetic shared by the
+// reference interpreter (interp.cpp) and the native code compiler (jit.cpp)
+// both engines should produce bit-identical results: any change here affects both
+// requires hw/8010x.h and emu/kxemu.h
+
+#ifndef _KX_EMUDSP_H_
+#define _KX_EMUDSP_H_
+
+static inline dword sat32(__int64 v,int &sat)
+{
+ if(v>(__int64)0x7fffffff)
+ {
+  sat=1;
+  return 0x7fffffff;
+ }
+ if(v<-(__int64)0x80000000)
+ {
+  sat=1;
+  return 0x80000000;
+ }
+ sat=0;
+ return (dword)v;
+}
+
+static inline dword make_ccr(dword r,int sat)
+{
+ dword ccr=0;
+ if(sat) ccr|=0x10;             // S: saturation
+ if(r==0) ccr|=0x8;             // Z: zero
+ if((int)r<0) ccr|=0x4;         // M: minus
+ if(((r>>31)^(r>>30))&1) ccr|=0x2;  // N: normalized
+ return ccr;
+}
+
+// SKIP test value: three 10-bit terms of 'set' (bits 0..4) and 'clear' (bits 5..9) CCR masks
+// combined according to bits 30..31: OR, NOR, AND, NAND
+static inline int skip_test(dword ccr,dword test)
+{
+ int t[3];
+ for(int i=0;i<3;i++)
+ {
+  dword field=(test>>(i*10))&0x3ff;
+  dword set=field&0x1f;
+  dword clr=(field>>5)&0x1f;
+  t[i]=field && ((ccr&set)==set) && ((~ccr&clr)==clr);
+ }
+ switch(test>>30)
+ {
+  case 0: return t[0]||t[1]||t[2];
+  case 1: return !(t[0]||t[1]||t[2]);
+  case 2: return t[0]&&t[1]&&t[2];
+  default: return !(t[0]&&t[1]&&t[2]);
+ }
+}
+
+// SKIP count: negative or past-the-end counts skip the rest of the program
+static inline int skip_count(int cnt,int pc,int n)
+{
+ if(cnt>n-1-pc || cnt<0)
+  cnt=n-1-pc;
+ return cnt;
+}
+
+static inline int mantissa_bits(dword max_exp)
+{
+ int ebits=1;
+ while((dword)(1<<ebits)<=max_exp)
+  ebits++;
+ return 31-ebits;
+}
+
+static inline dword apply_sign(dword r,int neg,dword mode)
+{
+ switch(mode&3)
+ {
+  case 0: return neg?~r:r;      // normal
+  case 1: return r;             // absolute value
+  case 2: return ~r;            // negative absolute value
+  default: return neg?r:~r;     // inverted
+ }
+}
+
+static inline dword dsp_log(dword a,dword max_exp,dword mode)
+{
+ max_exp&=0x1f;
+ if(max_exp==0)
+  max_exp=1;
+
+ int neg=((int)a<0);
+ dword mag=neg?~a:a;
+ int mbits=mantissa_bits(max_exp);
+
+ int lz=0;
+ dword t=mag<<1;
+ if(t==0)
+  lz=32;
+ else
+  while(!(t&0x80000000))
+  {
+   t<<=1;
+   lz++;
+  }
+
+ dword r;
+ dword frac=(max_exp+1<32)?(mag<<(max_exp+1)):0;
+ if(lz<(int)max_exp)
+ {
+  // normalized: the leading one is implicit
+  frac=mag<<(lz+2);
+  r=((max_exp-lz)<<mbits)|(frac>>(32-mbits));
+ }
+ else
+  r=frac>>(32-mbits);
+
+ return apply_sign(r,neg,mode);
+}
+
+static inline dword dsp_exp(dword a,dword max_exp,dword mode)
+{
+ max_exp&=0x1f;
+ if(max_exp==0)
+  max_exp=1;
+
+ int neg=((int)a<0);
+ dword v=neg?~a:a;
+ int mbits=mantissa_bits(max_exp);
+
+ dword e=v>>mbits;
+ dword f=(v&((1<<mbits)-1))<<(32-mbits);
+ dword mag;
+
+ if(e==0)
+  mag=(max_exp+1<32)?(f>>(max_exp+1)):0;
+ else
+ if(e>max_exp)
+  mag=0x7fffffff;
+ else
+  mag=(0x80000000|(f>>1))>>(max_exp-e+1);
+
+ return apply_sign(mag,neg,mode);
+}
+
+// TRAM address register -> delay line position (without DBAC)
+static inline dword tram_base(kx_emu *emu,dword a)
+{
+ if(emu->is_10k2)
+  return a>>0xb;
+ return a&TANKMEMADDRREG_ADDR_MASK_K1;
+}
+
+// DBAC as seen by the microcode
+static inline dword dbac_reg_value(kx_emu *emu,dword dbac)
+{
+ return emu->is_10k2?(dbac<<0xb):(dbac&TANKMEMADDRREG_ADDR_MASK_K1);
+}
+
+// physical operands of the special registers
+#define emu_c0(emu)         ((word)((emu)->is_10k2?0xc0:0x40))
+#define emu_special(emu,r)  ((word)(emu_c0(emu)+((r)-C_0)))
+
+// first TRAM data register of external TRAM; number of TRAM data registers
+#define emu_xtram_first(emu)    ((emu)->is_10k2?192:128)
+#define emu_tram_count(emu)     ((emu)->is_10k2?256:160)
+
+// native code compiler (jit.cpp)
+// DSP state of the compiled program: loaded on entry, saved on return
+typedef struct
+{
+ kx_emu *emu;
+ __int64 acc;
+ dword last;
+ int sat;
+}kx_emu_jit_state;
+
+// executes prog[] for one sample period
+typedef void (*kx_emu_jit_func)(kx_emu_jit_state *st,dword *regs);
+
+// returns the compiled program or NULL if the interpreter should be used instead
+kx_emu_jit_func kx_emu_jit_get(kx_emu *emu);
+void kx_emu_jit_free(kx_emu *emu);
+
+#endif
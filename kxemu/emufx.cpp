@@ -0,0 +1,659 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// host-side DSP emulator: built-in copy of the kX effect library microcode (kxfxlib, kxfx_pack),
+// as generated by the dane compiler
+// each da_*.cpp file is wrapped into its own namespace: the symbol names are not unique
+// the register name macros (R_S, R_B0, ...) are not either: those defined again by a later file are
+// #undef'd after the file that defines them
+// da_prolog.cpp / da_epilog.cpp are not included: they are built at run-time
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "emu/kxemu.h"
+#include "interface/kxcompat.h"
+#include "emu/emufx.h"
+
+namespace fxlib_asio {
+#include "../kxfxlib/da_asio.cpp"
+#undef _CODE
+}
+namespace fxlib_asio51 {
+#include "../kxfxlib/da_asio51.cpp"
+#undef _CODE
+}
+namespace fxlib_chorus {
+#include "../kxfxlib/da_chorus.cpp"
+}
+namespace fxlib_delay {
+#include "../kxfxlib/da_delay.cpp"
+}
+namespace fxlib_delay_a {
+#include "../kxfxlib/da_delay_a.cpp"
+}
+namespace fxlib_delay_b {
+#include "../kxfxlib/da_delay_b.cpp"
+}
+namespace fxlib_demo {
+#include "../kxfxlib/da_demo.cpp"
+}
+namespace fxlib_div4 {
+#include "../kxfxlib/da_div4.cpp"
+}
+namespace fxlib_epiloglt_k1 {
+#include "../kxfxlib/da_epiloglt_k1.cpp"
+}
+namespace fxlib_epiloglt_k2 {
+#include "../kxfxlib/da_epiloglt_k2.cpp"
+}
+namespace fxlib_eq10a {
+#include "../kxfxlib/da_eq10a.cpp"
+#undef R_S
+#undef I_BYPS1
+#undef I_BYPS2
+#undef R_INL
+#undef R_INR
+}
+namespace fxlib_fxbus {
+#include "../kxfxlib/da_fxbus.cpp"
+}
+namespace fxlib_fxbus2 {
+#include "../kxfxlib/da_fxbus2.cpp"
+}
+namespace fxlib_FXBusX {
+#include "../kxfxlib/da_FXBusX.cpp"
+}
+namespace fxlib_fxmix {
+#include "../kxfxlib/da_fxmix.cpp"
+}
+namespace fxlib_fxmix2 {
+#include "../kxfxlib/da_fxmix2.cpp"
+}
+namespace fxlib_k1lt {
+#include "../kxfxlib/da_k1lt.cpp"
+#undef _CODE
+}
+namespace fxlib_k2lt {
+#include "../kxfxlib/da_k2lt.cpp"
+}
+namespace fxlib_p16v {
+#include "../kxfxlib/da_p16v.cpp"
+}
+namespace fxlib_pan {
+#include "../kxfxlib/da_pan.cpp"
+}
+namespace fxlib_panx2 {
+#include "../kxfxlib/da_panx2.cpp"
+}
+namespace fxlib_peak {
+#include "../kxfxlib/da_peak.cpp"
+}
+namespace fxlib_phase {
+#include "../kxfxlib/da_phase.cpp"
+}
+namespace fxlib_prologlt {
+#include "../kxfxlib/da_prologlt.cpp"
+}
+namespace fxlib_reverblt {
+#include "../kxfxlib/da_reverblt.cpp"
+#undef _R_PREDELAY_LW
+#undef _R_PREDELAY_LR
+#undef _R_PREDELAY_RW
+#undef _R_PREDELAY_RR
+}
+namespace fxlib_src {
+#include "../kxfxlib/da_src.cpp"
+}
+namespace fxlib_stchorus {
+#include "../kxfxlib/da_stchorus.cpp"
+}
+namespace fxlib_stvol {
+#include "../kxfxlib/da_stvol.cpp"
+}
+namespace fxlib_summ {
+#include "../kxfxlib/da_summ.cpp"
+}
+namespace fxlib_surrounder2 {
+#include "../kxfxlib/da_surrounder2.cpp"
+}
+namespace fxlib_timbre {
+#include "../kxfxlib/da_timbre.cpp"
+#undef R_LB1
+#undef R_LA1
+#undef R_HB0
+#undef R_HB1
+#undef R_HA1
+}
+namespace fxlib_vol {
+#include "../kxfxlib/da_vol.cpp"
+}
+namespace fxlib_x4 {
+#include "../kxfxlib/da_x4.cpp"
+}
+namespace fxlib_xrouting {
+#include "../kxfxlib/da_xrouting.cpp"
+}
+namespace fxlib_xsumm {
+#include "../kxfxlib/da_xsumm.cpp"
+}
+namespace pack_16to32 {
+#include "../kxfx_pack/da_16to32.cpp"
+}
+namespace pack_16to32o {
+#include "../kxfx_pack/da_16to32o.cpp"
+}
+namespace pack_ac3passthrough {
+#include "../kxfx_pack/da_ac3passthrough.cpp"
+}
+namespace pack_ac3passthru {
+#include "../kxfx_pack/da_ac3passthru.cpp"
+}
+namespace pack_ac3passthru_x {
+#include "../kxfx_pack/da_ac3passthru_x.cpp"
+}
+namespace pack_agc {
+#include "../kxfx_pack/da_agc.cpp"
+}
+namespace pack_amp {
+#include "../kxfx_pack/da_amp.cpp"
+}
+namespace pack_apscomp {
+#include "../kxfx_pack/da_apscomp.cpp"
+#undef _ATTACK_TIME
+#undef _RELEASE_TIME
+#undef _POST_GAIN_1
+#undef _POST_GAIN_2
+#undef _THRESHOLD
+#undef _RATIO
+#undef _R_PREDELAY_LW
+#undef _R_PREDELAY_LR
+#undef _R_PREDELAY_RW
+#undef _R_PREDELAY_RR
+}
+namespace pack_apscompsc {
+#include "../kxfx_pack/da_apscompsc.cpp"
+#undef _ATTACK_TIME
+#undef _RELEASE_TIME
+#undef _POST_GAIN_1
+#undef _POST_GAIN_2
+#undef _THRESHOLD
+#undef _RATIO
+#undef _R_PREDELAY_LW
+#undef _R_PREDELAY_LR
+#undef _R_PREDELAY_RW
+#undef _R_PREDELAY_RR
+}
+namespace pack_apsexp {
+#include "../kxfx_pack/da_apsexp.cpp"
+#undef _ATTACK_TIME
+#undef _RELEASE_TIME
+#undef _POST_GAIN_1
+#undef _POST_GAIN_2
+#undef _THRESHOLD
+#undef _RATIO
+#undef _R_PREDELAY_LW
+#undef _R_PREDELAY_LR
+#undef _R_PREDELAY_RW
+#undef _R_PREDELAY_RR
+}
+namespace pack_apsexp_plus {
+#include "../kxfx_pack/da_apsexp_plus.cpp"
+}
+namespace pack_apsfuzz {
+#include "../kxfx_pack/da_apsfuzz.cpp"
+#undef _GAIN
+}
+namespace pack_autowah {
+#include "../kxfx_pack/da_autowah.cpp"
+}
+namespace pack_b2b {
+#include "../kxfx_pack/da_b2b.cpp"
+}
+namespace pack_b2bv2 {
+#include "../kxfx_pack/da_b2bv2.cpp"
+}
+namespace pack_booblegum {
+#include "../kxfx_pack/da_booblegum.cpp"
+}
+namespace pack_cleax3reverb {
+#include "../kxfx_pack/da_cleax3reverb.cpp"
+}
+namespace pack_cleax4reverb {
+#define CLEAX4Reverb_MAX_PRESET 38 // kxfx_pack/cleax4reverb.h
+#include "../kxfx_pack/da_cleax4reverb.cpp"
+}
+namespace pack_clreverb {
+#include "../kxfx_pack/da_clreverb.cpp"
+}
+namespace pack_cnv51to2 {
+#include "../kxfx_pack/da_cnv51to2.cpp"
+}
+namespace pack_crossfade {
+#include "../kxfx_pack/da_crossfade.cpp"
+}
+namespace pack_Crossover_2nd {
+#include "../kxfx_pack/da_Crossover_2nd.cpp"
+}
+namespace pack_Crossover_4th {
+#include "../kxfx_pack/da_Crossover_4th.cpp"
+}
+namespace pack_decimator {
+#include "../kxfx_pack/da_decimator.cpp"
+}
+namespace pack_Dither {
+#include "../kxfx_pack/da_Dither.cpp"
+}
+namespace pack_downmix {
+#include "../kxfx_pack/da_downmix.cpp"
+}
+namespace pack_dynamica {
+#include "../kxfx_pack/da_dynamica.cpp"
+#undef R_Level
+}
+namespace pack_encode4 {
+#include "../kxfx_pack/da_encode4.cpp"
+}
+namespace pack_EQ_Bandpass {
+#include "../kxfx_pack/da_EQ_Bandpass.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_EQ_Highpass {
+#include "../kxfx_pack/da_EQ_Highpass.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_EQ_Highshelf {
+#include "../kxfx_pack/da_EQ_Highshelf.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_EQ_Lowpass {
+#include "../kxfx_pack/da_EQ_Lowpass.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_EQ_Lowshelf {
+#include "../kxfx_pack/da_EQ_Lowshelf.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_EQ_Notch {
+#include "../kxfx_pack/da_EQ_Notch.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_EQ_Peaking {
+#include "../kxfx_pack/da_EQ_Peaking.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_everb {
+#include "../kxfx_pack/da_everb.cpp"
+#undef _LEVEL
+}
+namespace pack_Feedback_Destroyer {
+#include "../kxfx_pack/da_Feedback_Destroyer.cpp"
+}
+namespace pack_flanger {
+#include "../kxfx_pack/da_flanger.cpp"
+}
+namespace pack_Freq_Splitter {
+#include "../kxfx_pack/da_Freq_Splitter.cpp"
+}
+namespace pack_gain {
+#include "../kxfx_pack/da_gain.cpp"
+}
+namespace pack_HarmonicsGen {
+#include "../kxfx_pack/da_HarmonicsGen.cpp"
+}
+namespace pack_HPhSp {
+#include "../kxfx_pack/da_HPhSp.cpp"
+}
+namespace pack_hphsp2 {
+#include "../kxfx_pack/da_hphsp2.cpp"
+}
+namespace pack_info {
+#include "../kxfx_pack/da_info.cpp"
+}
+namespace pack_Leslie {
+#include "../kxfx_pack/da_Leslie.cpp"
+}
+namespace pack_monomix {
+#include "../kxfx_pack/da_monomix.cpp"
+}
+namespace pack_MoreBass {
+#include "../kxfx_pack/da_MoreBass.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+}
+namespace pack_mx6 {
+#include "../kxfx_pack/da_mx6.cpp"
+}
+namespace pack_NoiseGate2T {
+#include "../kxfx_pack/da_NoiseGate2T.cpp"
+#undef efxHOLD
+#undef efxTHUP
+#undef efxTHDN
+#undef efxER
+#undef efxEA
+}
+namespace pack_NoiseGate2Ts {
+#include "../kxfx_pack/da_NoiseGate2Ts.cpp"
+}
+namespace pack_osc {
+#include "../kxfx_pack/da_osc.cpp"
+}
+namespace pack_overdrive {
+#include "../kxfx_pack/da_overdrive.cpp"
+}
+namespace pack_overdrive2 {
+#include "../kxfx_pack/da_overdrive2.cpp"
+}
+namespace pack_Phaser {
+#include "../kxfx_pack/da_Phaser.cpp"
+}
+namespace pack_Phat_EQ_Mono {
+#include "../kxfx_pack/da_Phat_EQ_Mono.cpp"
+#undef R_B0
+#undef R_B1
+#undef R_B2
+#undef R_A1
+#undef R_A2
+#undef R_VOL
+}
+namespace pack_Phat_EQ_Stereo {
+#include "../kxfx_pack/da_Phat_EQ_Stereo.cpp"
+}
+namespace pack_pitch {
+#include "../kxfx_pack/da_pitch.cpp"
+}
+namespace pack_Pos3DFX {
+#include "../kxfx_pack/da_Pos3DFX.cpp"
+}
+namespace pack_Prologic {
+#include "../kxfx_pack/da_Prologic.cpp"
+}
+namespace pack_prologica {
+#include "../kxfx_pack/da_prologica.cpp"
+}
+namespace pack_ProPhaser {
+#include "../kxfx_pack/da_ProPhaser.cpp"
+}
+namespace pack_ReverbEax2 {
+#include "../kxfx_pack/da_ReverbEax2.cpp"
+}
+namespace pack_ringmod {
+#include "../kxfx_pack/da_ringmod.cpp"
+}
+namespace pack_soundgen {
+#include "../kxfx_pack/da_soundgen.cpp"
+}
+namespace pack_Sputnik {
+#include "../kxfx_pack/da_Sputnik.cpp"
+}
+namespace pack_stereomix {
+#include "../kxfx_pack/da_stereomix.cpp"
+}
+namespace pack_stmix {
+#include "../kxfx_pack/da_stmix.cpp"
+}
+namespace pack_stvocoder {
+#include "../kxfx_pack/da_stvocoder.cpp"
+}
+namespace pack_surrounderlt {
+#include "../kxfx_pack/da_surrounderlt.cpp"
+}
+namespace pack_TheDelay {
+#include "../kxfx_pack/da_TheDelay.cpp"
+#undef DW
+#undef DR
+}
+namespace pack_TheSmallDelay {
+#include "../kxfx_pack/da_TheSmallDelay.cpp"
+}
+namespace pack_TimeBalanceV2 {
+#include "../kxfx_pack/da_TimeBalanceV2.cpp"
+}
+namespace pack_tremolo {
+#include "../kxfx_pack/da_tremolo.cpp"
+}
+namespace pack_ts {
+#include "../kxfx_pack/da_ts.cpp"
+}
+namespace pack_vibrato {
+#include "../kxfx_pack/da_vibrato.cpp"
+}
+namespace pack_virtual5_1 {
+#include "../kxfx_pack/da_virtual5_1.cpp"
+}
+namespace pack_vocoder {
+#include "../kxfx_pack/da_vocoder.cpp"
+}
+namespace pack_voldc {
+#include "../kxfx_pack/da_voldc.cpp"
+}
+namespace pack_wavegen {
+#include "../kxfx_pack/da_wavegen.cpp"
+#undef R_Level
+#undef R_PT
+#undef R_PS
+#undef R_y2
+#undef R_y1
+#undef R_d
+}
+namespace pack_wavegen2 {
+#include "../kxfx_pack/da_wavegen2.cpp"
+#undef R_Level
+}
+namespace pack_wavegen3 {
+#include "../kxfx_pack/da_wavegen3.cpp"
+}
+namespace pack_Wibrato {
+#include "../kxfx_pack/da_Wibrato.cpp"
+}
+namespace pack_xor {
+#include "../kxfx_pack/da_xor.cpp"
+}
+
+const kx_emu_fx kx_emu_fx_library[]=
+{
+ { "kxfxlib/da_asio.cpp", "asio", fxlib_asio::asio_guid, fxlib_asio::asio_code, sizeof(fxlib_asio::asio_code)/sizeof(dsp_code), fxlib_asio::asio_info, sizeof(fxlib_asio::asio_info)/sizeof(dsp_register_info), &fxlib_asio::asio_itramsize, &fxlib_asio::asio_xtramsize },
+ { "kxfxlib/da_asio51.cpp", "asio51", fxlib_asio51::asio51_guid, fxlib_asio51::asio51_code, sizeof(fxlib_asio51::asio51_code)/sizeof(dsp_code), fxlib_asio51::asio51_info, sizeof(fxlib_asio51::asio51_info)/sizeof(dsp_register_info), &fxlib_asio51::asio51_itramsize, &fxlib_asio51::asio51_xtramsize },
+ { "kxfxlib/da_chorus.cpp", "chorus", fxlib_chorus::chorus_guid, fxlib_chorus::chorus_code, sizeof(fxlib_chorus::chorus_code)/sizeof(dsp_code), fxlib_chorus::chorus_info, sizeof(fxlib_chorus::chorus_info)/sizeof(dsp_register_info), &fxlib_chorus::chorus_itramsize, &fxlib_chorus::chorus_xtramsize },
+ { "kxfxlib/da_delay.cpp", "delay", fxlib_delay::delay_guid, fxlib_delay::delay_code, sizeof(fxlib_delay::delay_code)/sizeof(dsp_code), fxlib_delay::delay_info, sizeof(fxlib_delay::delay_info)/sizeof(dsp_register_info), &fxlib_delay::delay_itramsize, &fxlib_delay::delay_xtramsize },
+ { "kxfxlib/da_delay_a.cpp", "delay_a", fxlib_delay_a::delay_a_guid, fxlib_delay_a::delay_a_code, sizeof(fxlib_delay_a::delay_a_code)/sizeof(dsp_code), fxlib_delay_a::delay_a_info, sizeof(fxlib_delay_a::delay_a_info)/sizeof(dsp_register_info), &fxlib_delay_a::delay_a_itramsize, &fxlib_delay_a::delay_a_xtramsize },
+ { "kxfxlib/da_delay_b.cpp", "delay_b", fxlib_delay_b::delay_b_guid, fxlib_delay_b::delay_b_code, sizeof(fxlib_delay_b::delay_b_code)/sizeof(dsp_code), fxlib_delay_b::delay_b_info, sizeof(fxlib_delay_b::delay_b_info)/sizeof(dsp_register_info), &fxlib_delay_b::delay_b_itramsize, &fxlib_delay_b::delay_b_xtramsize },
+ { "kxfxlib/da_demo.cpp", "demo", fxlib_demo::demo_guid, fxlib_demo::demo_code, sizeof(fxlib_demo::demo_code)/sizeof(dsp_code), fxlib_demo::demo_info, sizeof(fxlib_demo::demo_info)/sizeof(dsp_register_info), &fxlib_demo::demo_itramsize, &fxlib_demo::demo_xtramsize },
+ { "kxfxlib/da_div4.cpp", "div4", fxlib_div4::div4_guid, fxlib_div4::div4_code, sizeof(fxlib_div4::div4_code)/sizeof(dsp_code), fxlib_div4::div4_info, sizeof(fxlib_div4::div4_info)/sizeof(dsp_register_info), &fxlib_div4::div4_itramsize, &fxlib_div4::div4_xtramsize },
+ { "kxfxlib/da_epiloglt_k1.cpp", "epiloglt_k1", fxlib_epiloglt_k1::epiloglt_k1_guid, fxlib_epiloglt_k1::epiloglt_k1_code, sizeof(fxlib_epiloglt_k1::epiloglt_k1_code)/sizeof(dsp_code), fxlib_epiloglt_k1::epiloglt_k1_info, sizeof(fxlib_epiloglt_k1::epiloglt_k1_info)/sizeof(dsp_register_info), &fxlib_epiloglt_k1::epiloglt_k1_itramsize, &fxlib_epiloglt_k1::epiloglt_k1_xtramsize },
+ { "kxfxlib/da_epiloglt_k2.cpp", "epiloglt_k2", fxlib_epiloglt_k2::epiloglt_k2_guid, fxlib_epiloglt_k2::epiloglt_k2_code, sizeof(fxlib_epiloglt_k2::epiloglt_k2_code)/sizeof(dsp_code), fxlib_epiloglt_k2::epiloglt_k2_info, sizeof(fxlib_epiloglt_k2::epiloglt_k2_info)/sizeof(dsp_register_info), &fxlib_epiloglt_k2::epiloglt_k2_itramsize, &fxlib_epiloglt_k2::epiloglt_k2_xtramsize },
+ { "kxfxlib/da_eq10a.cpp", "eq10a", fxlib_eq10a::eq10a_guid, fxlib_eq10a::eq10a_code, sizeof(fxlib_eq10a::eq10a_code)/sizeof(dsp_code), fxlib_eq10a::eq10a_info, sizeof(fxlib_eq10a::eq10a_info)/sizeof(dsp_register_info), &fxlib_eq10a::eq10a_itramsize, &fxlib_eq10a::eq10a_xtramsize },
+ { "kxfxlib/da_fxbus.cpp", "fxbus", fxlib_fxbus::fxbus_guid, fxlib_fxbus::fxbus_code, sizeof(fxlib_fxbus::fxbus_code)/sizeof(dsp_code), fxlib_fxbus::fxbus_info, sizeof(fxlib_fxbus::fxbus_info)/sizeof(dsp_register_info), &fxlib_fxbus::fxbus_itramsize, &fxlib_fxbus::fxbus_xtramsize },
+ { "kxfxlib/da_fxbus2.cpp", "fxbus2", fxlib_fxbus2::fxbus2_guid, fxlib_fxbus2::fxbus2_code, sizeof(fxlib_fxbus2::fxbus2_code)/sizeof(dsp_code), fxlib_fxbus2::fxbus2_info, sizeof(fxlib_fxbus2::fxbus2_info)/sizeof(dsp_register_info), &fxlib_fxbus2::fxbus2_itramsize, &fxlib_fxbus2::fxbus2_xtramsize },
+ { "kxfxlib/da_FXBusX.cpp", "FXBusX_10k2", fxlib_FXBusX::FXBusX_guid, fxlib_FXBusX::FXBusX_10k2_code, sizeof(fxlib_FXBusX::FXBusX_10k2_code)/sizeof(dsp_code), fxlib_FXBusX::FXBusX_info, sizeof(fxlib_FXBusX::FXBusX_info)/sizeof(dsp_register_info), &fxlib_FXBusX::FXBusX_itramsize, &fxlib_FXBusX::FXBusX_xtramsize },
+ { "kxfxlib/da_FXBusX.cpp", "FXBusX_10k8", NULL, fxlib_FXBusX::FXBusX_10k8_code, sizeof(fxlib_FXBusX::FXBusX_10k8_code)/sizeof(dsp_code), fxlib_FXBusX::FXBusX_info, sizeof(fxlib_FXBusX::FXBusX_info)/sizeof(dsp_register_info), &fxlib_FXBusX::FXBusX_itramsize, &fxlib_FXBusX::FXBusX_xtramsize },
+ { "kxfxlib/da_fxmix.cpp", "fx_mix", fxlib_fxmix::fx_mix_guid, fxlib_fxmix::fx_mix_code, sizeof(fxlib_fxmix::fx_mix_code)/sizeof(dsp_code), fxlib_fxmix::fx_mix_info, sizeof(fxlib_fxmix::fx_mix_info)/sizeof(dsp_register_info), &fxlib_fxmix::fx_mix_itramsize, &fxlib_fxmix::fx_mix_xtramsize },
+ { "kxfxlib/da_fxmix2.cpp", "fx_mix2", fxlib_fxmix2::fx_mix2_guid, fxlib_fxmix2::fx_mix2_code, sizeof(fxlib_fxmix2::fx_mix2_code)/sizeof(dsp_code), fxlib_fxmix2::fx_mix2_info, sizeof(fxlib_fxmix2::fx_mix2_info)/sizeof(dsp_register_info), &fxlib_fxmix2::fx_mix2_itramsize, &fxlib_fxmix2::fx_mix2_xtramsize },
+ { "kxfxlib/da_k1lt.cpp", "k1lt", fxlib_k1lt::k1lt_guid, fxlib_k1lt::k1lt_code, sizeof(fxlib_k1lt::k1lt_code)/sizeof(dsp_code), fxlib_k1lt::k1lt_info, sizeof(fxlib_k1lt::k1lt_info)/sizeof(dsp_register_info), &fxlib_k1lt::k1lt_itramsize, &fxlib_k1lt::k1lt_xtramsize },
+ { "kxfxlib/da_k2lt.cpp", "k2lt", fxlib_k2lt::k2lt_guid, fxlib_k2lt::k2lt_code, sizeof(fxlib_k2lt::k2lt_code)/sizeof(dsp_code), fxlib_k2lt::k2lt_info, sizeof(fxlib_k2lt::k2lt_info)/sizeof(dsp_register_info), &fxlib_k2lt::k2lt_itramsize, &fxlib_k2lt::k2lt_xtramsize },
+ { "kxfxlib/da_p16v.cpp", "p16v", fxlib_p16v::p16v_guid, fxlib_p16v::p16v_code, sizeof(fxlib_p16v::p16v_code)/sizeof(dsp_code), fxlib_p16v::p16v_info, sizeof(fxlib_p16v::p16v_info)/sizeof(dsp_register_info), &fxlib_p16v::p16v_itramsize, &fxlib_p16v::p16v_xtramsize },
+ { "kxfxlib/da_pan.cpp", "pan", fxlib_pan::pan_guid, fxlib_pan::pan_code, sizeof(fxlib_pan::pan_code)/sizeof(dsp_code), fxlib_pan::pan_info, sizeof(fxlib_pan::pan_info)/sizeof(dsp_register_info), &fxlib_pan::pan_itramsize, &fxlib_pan::pan_xtramsize },
+ { "kxfxlib/da_panx2.cpp", "panx2", fxlib_panx2::panx2_guid, fxlib_panx2::panx2_code, sizeof(fxlib_panx2::panx2_code)/sizeof(dsp_code), fxlib_panx2::panx2_info, sizeof(fxlib_panx2::panx2_info)/sizeof(dsp_register_info), &fxlib_panx2::panx2_itramsize, &fxlib_panx2::panx2_xtramsize },
+ { "kxfxlib/da_peak.cpp", "peak", fxlib_peak::peak_guid, fxlib_peak::peak_code, sizeof(fxlib_peak::peak_code)/sizeof(dsp_code), fxlib_peak::peak_info, sizeof(fxlib_peak::peak_info)/sizeof(dsp_register_info), &fxlib_peak::peak_itramsize, &fxlib_peak::peak_xtramsize },
+ { "kxfxlib/da_phase.cpp", "phase", fxlib_phase::phase_guid, fxlib_phase::phase_code, sizeof(fxlib_phase::phase_code)/sizeof(dsp_code), fxlib_phase::phase_info, sizeof(fxlib_phase::phase_info)/sizeof(dsp_register_info), &fxlib_phase::phase_itramsize, &fxlib_phase::phase_xtramsize },
+ { "kxfxlib/da_prologlt.cpp", "prologlt", fxlib_prologlt::prologlt_guid, fxlib_prologlt::prologlt_code, sizeof(fxlib_prologlt::prologlt_code)/sizeof(dsp_code), fxlib_prologlt::prologlt_info, sizeof(fxlib_prologlt::prologlt_info)/sizeof(dsp_register_info), &fxlib_prologlt::prologlt_itramsize, &fxlib_prologlt::prologlt_xtramsize },
+ { "kxfxlib/da_reverblt.cpp", "reverblt", fxlib_reverblt::reverblt_guid, fxlib_reverblt::reverblt_code, sizeof(fxlib_reverblt::reverblt_code)/sizeof(dsp_code), fxlib_reverblt::reverblt_info, sizeof(fxlib_reverblt::reverblt_info)/sizeof(dsp_register_info), &fxlib_reverblt::reverblt_itramsize, &fxlib_reverblt::reverblt_xtramsize },
+ { "kxfxlib/da_src.cpp", "src", fxlib_src::src_guid, fxlib_src::src_code, sizeof(fxlib_src::src_code)/sizeof(dsp_code), fxlib_src::src_info, sizeof(fxlib_src::src_info)/sizeof(dsp_register_info), &fxlib_src::src_itramsize, &fxlib_src::src_xtramsize },
+ { "kxfxlib/da_stchorus.cpp", "stchorus", fxlib_stchorus::stchorus_guid, fxlib_stchorus::stchorus_code, sizeof(fxlib_stchorus::stchorus_code)/sizeof(dsp_code), fxlib_stchorus::stchorus_info, sizeof(fxlib_stchorus::stchorus_info)/sizeof(dsp_register_info), &fxlib_stchorus::stchorus_itramsize, &fxlib_stchorus::stchorus_xtramsize },
+ { "kxfxlib/da_stvol.cpp", "stvol", fxlib_stvol::stvol_guid, fxlib_stvol::stvol_code, sizeof(fxlib_stvol::stvol_code)/sizeof(dsp_code), fxlib_stvol::stvol_info, sizeof(fxlib_stvol::stvol_info)/sizeof(dsp_register_info), &fxlib_stvol::stvol_itramsize, &fxlib_stvol::stvol_xtramsize },
+ { "kxfxlib/da_summ.cpp", "summ", fxlib_summ::summ_guid, fxlib_summ::summ_code, sizeof(fxlib_summ::summ_code)/sizeof(dsp_code), fxlib_summ::summ_info, sizeof(fxlib_summ::summ_info)/sizeof(dsp_register_info), &fxlib_summ::summ_itramsize, &fxlib_summ::summ_xtramsize },
+ { "kxfxlib/da_surrounder2.cpp", "surrounder2_51DP", NULL, fxlib_surrounder2::surrounder2_code_51DP, sizeof(fxlib_surrounder2::surrounder2_code_51DP)/sizeof(dsp_code), fxlib_surrounder2::surrounder2_info, sizeof(fxlib_surrounder2::surrounder2_info)/sizeof(dsp_register_info), &fxlib_surrounder2::surrounder2_itramsize, &fxlib_surrounder2::surrounder2_xtramsize },
+ { "kxfxlib/da_surrounder2.cpp", "surrounder2_71DP", fxlib_surrounder2::surrounder2_guid, fxlib_surrounder2::surrounder2_code_71DP, sizeof(fxlib_surrounder2::surrounder2_code_71DP)/sizeof(dsp_code), fxlib_surrounder2::surrounder2_info, sizeof(fxlib_surrounder2::surrounder2_info)/sizeof(dsp_register_info), &fxlib_surrounder2::surrounder2_itramsize, &fxlib_surrounder2::surrounder2_xtramsize },
+ { "kxfxlib/da_timbre.cpp", "timbre", fxlib_timbre::timbre_guid, fxlib_timbre::timbre_code, sizeof(fxlib_timbre::timbre_code)/sizeof(dsp_code), fxlib_timbre::timbre_info, sizeof(fxlib_timbre::timbre_info)/sizeof(dsp_register_info), &fxlib_timbre::timbre_itramsize, &fxlib_timbre::timbre_xtramsize },
+ { "kxfxlib/da_vol.cpp", "vol", fxlib_vol::vol_guid, fxlib_vol::vol_code, sizeof(fxlib_vol::vol_code)/sizeof(dsp_code), fxlib_vol::vol_info, sizeof(fxlib_vol::vol_info)/sizeof(dsp_register_info), &fxlib_vol::vol_itramsize, &fxlib_vol::vol_xtramsize },
+ { "kxfxlib/da_x4.cpp", "x4", fxlib_x4::x4_guid, fxlib_x4::x4_code, sizeof(fxlib_x4::x4_code)/sizeof(dsp_code), fxlib_x4::x4_info, sizeof(fxlib_x4::x4_info)/sizeof(dsp_register_info), &fxlib_x4::x4_itramsize, &fxlib_x4::x4_xtramsize },
+ { "kxfxlib/da_xrouting.cpp", "xrouting", fxlib_xrouting::xrouting_guid, fxlib_xrouting::xrouting_code, sizeof(fxlib_xrouting::xrouting_code)/sizeof(dsp_code), fxlib_xrouting::xrouting_info, sizeof(fxlib_xrouting::xrouting_info)/sizeof(dsp_register_info), &fxlib_xrouting::xrouting_itramsize, &fxlib_xrouting::xrouting_xtramsize },
+ { "kxfxlib/da_xsumm.cpp", "xsumm", fxlib_xsumm::xsumm_guid, fxlib_xsumm::xsumm_code, sizeof(fxlib_xsumm::xsumm_code)/sizeof(dsp_code), fxlib_xsumm::xsumm_info, sizeof(fxlib_xsumm::xsumm_info)/sizeof(dsp_register_info), &fxlib_xsumm::xsumm_itramsize, &fxlib_xsumm::xsumm_xtramsize },
+ { "kxfx_pack/da_16to32.cpp", "do16to32", pack_16to32::do16to32_guid, pack_16to32::do16to32_code, sizeof(pack_16to32::do16to32_code)/sizeof(dsp_code), pack_16to32::do16to32_info, sizeof(pack_16to32::do16to32_info)/sizeof(dsp_register_info), &pack_16to32::do16to32_itramsize, &pack_16to32::do16to32_xtramsize },
+ { "kxfx_pack/da_16to32o.cpp", "do16to32", pack_16to32o::do16to32_guid, pack_16to32o::do16to32_code, sizeof(pack_16to32o::do16to32_code)/sizeof(dsp_code), pack_16to32o::do16to32_info, sizeof(pack_16to32o::do16to32_info)/sizeof(dsp_register_info), &pack_16to32o::do16to32_itramsize, &pack_16to32o::do16to32_xtramsize },
+ { "kxfx_pack/da_ac3passthrough.cpp", "ac3passthrough", pack_ac3passthrough::ac3passthrough_guid, pack_ac3passthrough::ac3passthrough_code, sizeof(pack_ac3passthrough::ac3passthrough_code)/sizeof(dsp_code), pack_ac3passthrough::ac3passthrough_info, sizeof(pack_ac3passthrough::ac3passthrough_info)/sizeof(dsp_register_info), &pack_ac3passthrough::ac3passthrough_itramsize, &pack_ac3passthrough::ac3passthrough_xtramsize },
+ { "kxfx_pack/da_ac3passthru.cpp", "ac3passthru", pack_ac3passthru::ac3passthru_guid, pack_ac3passthru::ac3passthru_code, sizeof(pack_ac3passthru::ac3passthru_code)/sizeof(dsp_code), pack_ac3passthru::ac3passthru_info, sizeof(pack_ac3passthru::ac3passthru_info)/sizeof(dsp_register_info), &pack_ac3passthru::ac3passthru_itramsize, &pack_ac3passthru::ac3passthru_xtramsize },
+ { "kxfx_pack/da_ac3passthru_x.cpp", "ac3passthru_x", pack_ac3passthru_x::ac3passthru_x_guid, pack_ac3passthru_x::ac3passthru_x_code, sizeof(pack_ac3passthru_x::ac3passthru_x_code)/sizeof(dsp_code), pack_ac3passthru_x::ac3passthru_x_info, sizeof(pack_ac3passthru_x::ac3passthru_x_info)/sizeof(dsp_register_info), &pack_ac3passthru_x::ac3passthru_x_itramsize, &pack_ac3passthru_x::ac3passthru_x_xtramsize },
+ { "kxfx_pack/da_agc.cpp", "agc", pack_agc::agc_guid, pack_agc::agc_code, sizeof(pack_agc::agc_code)/sizeof(dsp_code), pack_agc::agc_info, sizeof(pack_agc::agc_info)/sizeof(dsp_register_info), &pack_agc::agc_itramsize, &pack_agc::agc_xtramsize },
+ { "kxfx_pack/da_amp.cpp", "amp", pack_amp::amp_guid, pack_amp::amp_code, sizeof(pack_amp::amp_code)/sizeof(dsp_code), pack_amp::amp_info, sizeof(pack_amp::amp_info)/sizeof(dsp_register_info), &pack_amp::amp_itramsize, &pack_amp::amp_xtramsize },
+ { "kxfx_pack/da_apscomp.cpp", "apscomp", pack_apscomp::apscomp_guid, pack_apscomp::apscomp_code, sizeof(pack_apscomp::apscomp_code)/sizeof(dsp_code), pack_apscomp::apscomp_info, sizeof(pack_apscomp::apscomp_info)/sizeof(dsp_register_info), &pack_apscomp::apscomp_itramsize, &pack_apscomp::apscomp_xtramsize },
+ { "kxfx_pack/da_apscompsc.cpp", "apscomp_sc", pack_apscompsc::apscomp_sc_guid, pack_apscompsc::apscomp_sc_code, sizeof(pack_apscompsc::apscomp_sc_code)/sizeof(dsp_code), pack_apscompsc::apscomp_sc_info, sizeof(pack_apscompsc::apscomp_sc_info)/sizeof(dsp_register_info), &pack_apscompsc::apscomp_sc_itramsize, &pack_apscompsc::apscomp_sc_xtramsize },
+ { "kxfx_pack/da_apsexp.cpp", "apsexp", pack_apsexp::apsexp_guid, pack_apsexp::apsexp_code, sizeof(pack_apsexp::apsexp_code)/sizeof(dsp_code), pack_apsexp::apsexp_info, sizeof(pack_apsexp::apsexp_info)/sizeof(dsp_register_info), &pack_apsexp::apsexp_itramsize, &pack_apsexp::apsexp_xtramsize },
+ { "kxfx_pack/da_apsexp_plus.cpp", "apsexp_plus", pack_apsexp_plus::apsexp_plus_guid, pack_apsexp_plus::apsexp_plus_code, sizeof(pack_apsexp_plus::apsexp_plus_code)/sizeof(dsp_code), pack_apsexp_plus::apsexp_plus_info, sizeof(pack_apsexp_plus::apsexp_plus_info)/sizeof(dsp_register_info), &pack_apsexp_plus::apsexp_plus_itramsize, &pack_apsexp_plus::apsexp_plus_xtramsize },
+ { "kxfx_pack/da_apsfuzz.cpp", "apsfuzz", pack_apsfuzz::apsfuzz_guid, pack_apsfuzz::apsfuzz_code, sizeof(pack_apsfuzz::apsfuzz_code)/sizeof(dsp_code), pack_apsfuzz::apsfuzz_info, sizeof(pack_apsfuzz::apsfuzz_info)/sizeof(dsp_register_info), &pack_apsfuzz::apsfuzz_itramsize, &pack_apsfuzz::apsfuzz_xtramsize },
+ { "kxfx_pack/da_autowah.cpp", "autowah", pack_autowah::autowah_guid, pack_autowah::autowah_code, sizeof(pack_autowah::autowah_code)/sizeof(dsp_code), pack_autowah::autowah_info, sizeof(pack_autowah::autowah_info)/sizeof(dsp_register_info), &pack_autowah::autowah_itramsize, &pack_autowah::autowah_xtramsize },
+ { "kxfx_pack/da_b2b.cpp", "b2b", pack_b2b::b2b_guid, pack_b2b::b2b_code, sizeof(pack_b2b::b2b_code)/sizeof(dsp_code), pack_b2b::b2b_info, sizeof(pack_b2b::b2b_info)/sizeof(dsp_register_info), &pack_b2b::b2b_itramsize, &pack_b2b::b2b_xtramsize },
+ { "kxfx_pack/da_b2bv2.cpp", "b2bv2", pack_b2bv2::b2bv2_guid, pack_b2bv2::b2bv2_code, sizeof(pack_b2bv2::b2bv2_code)/sizeof(dsp_code), pack_b2bv2::b2bv2_info, sizeof(pack_b2bv2::b2bv2_info)/sizeof(dsp_register_info), &pack_b2bv2::b2bv2_itramsize, &pack_b2bv2::b2bv2_xtramsize },
+ { "kxfx_pack/da_booblegum.cpp", "booblegum", pack_booblegum::booblegum_guid, pack_booblegum::booblegum_code, sizeof(pack_booblegum::booblegum_code)/sizeof(dsp_code), pack_booblegum::booblegum_info, sizeof(pack_booblegum::booblegum_info)/sizeof(dsp_register_info), &pack_booblegum::booblegum_itramsize, &pack_booblegum::booblegum_xtramsize },
+ { "kxfx_pack/da_cleax3reverb.cpp", "CLEAX3Reverb", pack_cleax3reverb::CLEAX3Reverb_guid, pack_cleax3reverb::CLEAX3Reverb_code, sizeof(pack_cleax3reverb::CLEAX3Reverb_code)/sizeof(dsp_code), pack_cleax3reverb::CLEAX3Reverb_info, sizeof(pack_cleax3reverb::CLEAX3Reverb_info)/sizeof(dsp_register_info), &pack_cleax3reverb::CLEAX3Reverb_itramsize, &pack_cleax3reverb::CLEAX3Reverb_xtramsize },
+ { "kxfx_pack/da_cleax4reverb.cpp", "CLEAX4Reverb", pack_cleax4reverb::CLEAX4Reverb_guid, pack_cleax4reverb::CLEAX4Reverb_code, sizeof(pack_cleax4reverb::CLEAX4Reverb_code)/sizeof(dsp_code), pack_cleax4reverb::CLEAX4Reverb_info, sizeof(pack_cleax4reverb::CLEAX4Reverb_info)/sizeof(dsp_register_info), &pack_cleax4reverb::CLEAX4Reverb_itramsize, &pack_cleax4reverb::CLEAX4Reverb_xtramsize },
+ { "kxfx_pack/da_clreverb.cpp", "clreverb", pack_clreverb::clreverb_guid, pack_clreverb::clreverb_code, sizeof(pack_clreverb::clreverb_code)/sizeof(dsp_code), pack_clreverb::clreverb_info, sizeof(pack_clreverb::clreverb_info)/sizeof(dsp_register_info), &pack_clreverb::clreverb_itramsize, &pack_clreverb::clreverb_xtramsize },
+ { "kxfx_pack/da_cnv51to2.cpp", "cnv51to20", pack_cnv51to2::cnv51to20_guid, pack_cnv51to2::cnv51to20_code, sizeof(pack_cnv51to2::cnv51to20_code)/sizeof(dsp_code), pack_cnv51to2::cnv51to20_info, sizeof(pack_cnv51to2::cnv51to20_info)/sizeof(dsp_register_info), &pack_cnv51to2::cnv51to20_itramsize, &pack_cnv51to2::cnv51to20_xtramsize },
+ { "kxfx_pack/da_crossfade.cpp", "crossfade", pack_crossfade::crossfade_guid, pack_crossfade::crossfade_code, sizeof(pack_crossfade::crossfade_code)/sizeof(dsp_code), pack_crossfade::crossfade_info, sizeof(pack_crossfade::crossfade_info)/sizeof(dsp_register_info), &pack_crossfade::crossfade_itramsize, &pack_crossfade::crossfade_xtramsize },
+ { "kxfx_pack/da_Crossover_2nd.cpp", "Crossover_2", pack_Crossover_2nd::Crossover_2_guid, pack_Crossover_2nd::Crossover_2_code, sizeof(pack_Crossover_2nd::Crossover_2_code)/sizeof(dsp_code), pack_Crossover_2nd::Crossover_2_info, sizeof(pack_Crossover_2nd::Crossover_2_info)/sizeof(dsp_register_info), &pack_Crossover_2nd::Crossover_2_itramsize, &pack_Crossover_2nd::Crossover_2_xtramsize },
+ { "kxfx_pack/da_Crossover_4th.cpp", "Crossover_4", pack_Crossover_4th::Crossover_4_guid, pack_Crossover_4th::Crossover_4_code, sizeof(pack_Crossover_4th::Crossover_4_code)/sizeof(dsp_code), pack_Crossover_4th::Crossover_4_info, sizeof(pack_Crossover_4th::Crossover_4_info)/sizeof(dsp_register_info), &pack_Crossover_4th::Crossover_4_itramsize, &pack_Crossover_4th::Crossover_4_xtramsize },
+ { "kxfx_pack/da_decimator.cpp", "decimator", pack_decimator::decimator_guid, pack_decimator::decimator_code, sizeof(pack_decimator::decimator_code)/sizeof(dsp_code), pack_decimator::decimator_info, sizeof(pack_decimator::decimator_info)/sizeof(dsp_register_info), &pack_decimator::decimator_itramsize, &pack_decimator::decimator_xtramsize },
+ { "kxfx_pack/da_Dither.cpp", "Dither", pack_Dither::Dither_guid, pack_Dither::Dither_code, sizeof(pack_Dither::Dither_code)/sizeof(dsp_code), pack_Dither::Dither_info, sizeof(pack_Dither::Dither_info)/sizeof(dsp_register_info), &pack_Dither::Dither_itramsize, &pack_Dither::Dither_xtramsize },
+ { "kxfx_pack/da_downmix.cpp", "downmix", pack_downmix::downmix_guid, pack_downmix::downmix_code, sizeof(pack_downmix::downmix_code)/sizeof(dsp_code), pack_downmix::downmix_info, sizeof(pack_downmix::downmix_info)/sizeof(dsp_register_info), &pack_downmix::downmix_itramsize, &pack_downmix::downmix_xtramsize },
+ { "kxfx_pack/da_dynamica.cpp", "dynamica", pack_dynamica::dynamica_guid, pack_dynamica::dynamica_code, sizeof(pack_dynamica::dynamica_code)/sizeof(dsp_code), pack_dynamica::dynamica_info, sizeof(pack_dynamica::dynamica_info)/sizeof(dsp_register_info), &pack_dynamica::dynamica_itramsize, &pack_dynamica::dynamica_xtramsize },
+ { "kxfx_pack/da_encode4.cpp", "encode4", pack_encode4::encode4_guid, pack_encode4::encode4_code, sizeof(pack_encode4::encode4_code)/sizeof(dsp_code), pack_encode4::encode4_info, sizeof(pack_encode4::encode4_info)/sizeof(dsp_register_info), &pack_encode4::encode4_itramsize, &pack_encode4::encode4_xtramsize },
+ { "kxfx_pack/da_EQ_Bandpass.cpp", "EQ_Bandpass", pack_EQ_Bandpass::EQ_Bandpass_guid, pack_EQ_Bandpass::EQ_Bandpass_code, sizeof(pack_EQ_Bandpass::EQ_Bandpass_code)/sizeof(dsp_code), pack_EQ_Bandpass::EQ_Bandpass_info, sizeof(pack_EQ_Bandpass::EQ_Bandpass_info)/sizeof(dsp_register_info), &pack_EQ_Bandpass::EQ_Bandpass_itramsize, &pack_EQ_Bandpass::EQ_Bandpass_xtramsize },
+ { "kxfx_pack/da_EQ_Highpass.cpp", "EQ_Highpass", pack_EQ_Highpass::EQ_Highpass_guid, pack_EQ_Highpass::EQ_Highpass_code, sizeof(pack_EQ_Highpass::EQ_Highpass_code)/sizeof(dsp_code), pack_EQ_Highpass::EQ_Highpass_info, sizeof(pack_EQ_Highpass::EQ_Highpass_info)/sizeof(dsp_register_info), &pack_EQ_Highpass::EQ_Highpass_itramsize, &pack_EQ_Highpass::EQ_Highpass_xtramsize },
+ { "kxfx_pack/da_EQ_Highshelf.cpp", "EQ_Highshelf", pack_EQ_Highshelf::EQ_Highshelf_guid, pack_EQ_Highshelf::EQ_Highshelf_code, sizeof(pack_EQ_Highshelf::EQ_Highshelf_code)/sizeof(dsp_code), pack_EQ_Highshelf::EQ_Highshelf_info, sizeof(pack_EQ_Highshelf::EQ_Highshelf_info)/sizeof(dsp_register_info), &pack_EQ_Highshelf::EQ_Highshelf_itramsize, &pack_EQ_Highshelf::EQ_Highshelf_xtramsize },
+ { "kxfx_pack/da_EQ_Lowpass.cpp", "EQ_Lowpass", pack_EQ_Lowpass::EQ_Lowpass_guid, pack_EQ_Lowpass::EQ_Lowpass_code, sizeof(pack_EQ_Lowpass::EQ_Lowpass_code)/sizeof(dsp_code), pack_EQ_Lowpass::EQ_Lowpass_info, sizeof(pack_EQ_Lowpass::EQ_Lowpass_info)/sizeof(dsp_register_info), &pack_EQ_Lowpass::EQ_Lowpass_itramsize, &pack_EQ_Lowpass::EQ_Lowpass_xtramsize },
+ { "kxfx_pack/da_EQ_Lowshelf.cpp", "EQ_Lowshelf", pack_EQ_Lowshelf::EQ_Lowshelf_guid, pack_EQ_Lowshelf::EQ_Lowshelf_code, sizeof(pack_EQ_Lowshelf::EQ_Lowshelf_code)/sizeof(dsp_code), pack_EQ_Lowshelf::EQ_Lowshelf_info, sizeof(pack_EQ_Lowshelf::EQ_Lowshelf_info)/sizeof(dsp_register_info), &pack_EQ_Lowshelf::EQ_Lowshelf_itramsize, &pack_EQ_Lowshelf::EQ_Lowshelf_xtramsize },
+ { "kxfx_pack/da_EQ_Notch.cpp", "EQ_Notch", pack_EQ_Notch::EQ_Notch_guid, pack_EQ_Notch::EQ_Notch_code, sizeof(pack_EQ_Notch::EQ_Notch_code)/sizeof(dsp_code), pack_EQ_Notch::EQ_Notch_info, sizeof(pack_EQ_Notch::EQ_Notch_info)/sizeof(dsp_register_info), &pack_EQ_Notch::EQ_Notch_itramsize, &pack_EQ_Notch::EQ_Notch_xtramsize },
+ { "kxfx_pack/da_EQ_Peaking.cpp", "EQ_Peaking", pack_EQ_Peaking::EQ_Peaking_guid, pack_EQ_Peaking::EQ_Peaking_code, sizeof(pack_EQ_Peaking::EQ_Peaking_code)/sizeof(dsp_code), pack_EQ_Peaking::EQ_Peaking_info, sizeof(pack_EQ_Peaking::EQ_Peaking_info)/sizeof(dsp_register_info), &pack_EQ_Peaking::EQ_Peaking_itramsize, &pack_EQ_Peaking::EQ_Peaking_xtramsize },
+ { "kxfx_pack/da_everb.cpp", "everb", pack_everb::everb_guid, pack_everb::everb_code, sizeof(pack_everb::everb_code)/sizeof(dsp_code), pack_everb::everb_info, sizeof(pack_everb::everb_info)/sizeof(dsp_register_info), &pack_everb::everb_itramsize, &pack_everb::everb_xtramsize },
+ { "kxfx_pack/da_Feedback_Destroyer.cpp", "Feedback_Destroyer", pack_Feedback_Destroyer::Feedback_Destroyer_guid, pack_Feedback_Destroyer::Feedback_Destroyer_code, sizeof(pack_Feedback_Destroyer::Feedback_Destroyer_code)/sizeof(dsp_code), pack_Feedback_Destroyer::Feedback_Destroyer_info, sizeof(pack_Feedback_Destroyer::Feedback_Destroyer_info)/sizeof(dsp_register_info), &pack_Feedback_Destroyer::Feedback_Destroyer_itramsize, &pack_Feedback_Destroyer::Feedback_Destroyer_xtramsize },
+ { "kxfx_pack/da_flanger.cpp", "flanger", pack_flanger::flanger_guid, pack_flanger::flanger_code, sizeof(pack_flanger::flanger_code)/sizeof(dsp_code), pack_flanger::flanger_info, sizeof(pack_flanger::flanger_info)/sizeof(dsp_register_info), &pack_flanger::flanger_itramsize, &pack_flanger::flanger_xtramsize },
+ { "kxfx_pack/da_Freq_Splitter.cpp", "Freq_Splitter", pack_Freq_Splitter::Freq_Splitter_guid, pack_Freq_Splitter::Freq_Splitter_code, sizeof(pack_Freq_Splitter::Freq_Splitter_code)/sizeof(dsp_code), pack_Freq_Splitter::Freq_Splitter_info, sizeof(pack_Freq_Splitter::Freq_Splitter_info)/sizeof(dsp_register_info), &pack_Freq_Splitter::Freq_Splitter_itramsize, &pack_Freq_Splitter::Freq_Splitter_xtramsize },
+ { "kxfx_pack/da_gain.cpp", "gain", pack_gain::gain_guid, pack_gain::gain_code, sizeof(pack_gain::gain_code)/sizeof(dsp_code), pack_gain::gain_info, sizeof(pack_gain::gain_info)/sizeof(dsp_register_info), &pack_gain::gain_itramsize, &pack_gain::gain_xtramsize },
+ { "kxfx_pack/da_HarmonicsGen.cpp", "HarmonicsGen", pack_HarmonicsGen::HarmonicsGen_guid, pack_HarmonicsGen::HarmonicsGen_code, sizeof(pack_HarmonicsGen::HarmonicsGen_code)/sizeof(dsp_code), pack_HarmonicsGen::HarmonicsGen_info, sizeof(pack_HarmonicsGen::HarmonicsGen_info)/sizeof(dsp_register_info), &pack_HarmonicsGen::HarmonicsGen_itramsize, &pack_HarmonicsGen::HarmonicsGen_xtramsize },
+ { "kxfx_pack/da_HPhSp.cpp", "hphsp", pack_HPhSp::hphsp_guid, pack_HPhSp::hphsp_code, sizeof(pack_HPhSp::hphsp_code)/sizeof(dsp_code), pack_HPhSp::hphsp_info, sizeof(pack_HPhSp::hphsp_info)/sizeof(dsp_register_info), &pack_HPhSp::hphsp_itramsize, &pack_HPhSp::hphsp_xtramsize },
+ { "kxfx_pack/da_hphsp2.cpp", "hphsp2", pack_hphsp2::hphsp2_guid, pack_hphsp2::hphsp2_code, sizeof(pack_hphsp2::hphsp2_code)/sizeof(dsp_code), pack_hphsp2::hphsp2_info, sizeof(pack_hphsp2::hphsp2_info)/sizeof(dsp_register_info), &pack_hphsp2::hphsp2_itramsize, &pack_hphsp2::hphsp2_xtramsize },
+ { "kxfx_pack/da_info.cpp", "info", pack_info::info_guid, pack_info::info_code, sizeof(pack_info::info_code)/sizeof(dsp_code), pack_info::info_info, sizeof(pack_info::info_info)/sizeof(dsp_register_info), &pack_info::info_itramsize, &pack_info::info_xtramsize },
+ { "kxfx_pack/da_Leslie.cpp", "Leslie_Horn", pack_Leslie::Leslie_Horn_guid, pack_Leslie::Leslie_Horn_code, sizeof(pack_Leslie::Leslie_Horn_code)/sizeof(dsp_code), pack_Leslie::Leslie_Horn_info, sizeof(pack_Leslie::Leslie_Horn_info)/sizeof(dsp_register_info), &pack_Leslie::Leslie_Horn_itramsize, &pack_Leslie::Leslie_Horn_xtramsize },
+ { "kxfx_pack/da_monomix.cpp", "monomix", pack_monomix::monomix_guid, pack_monomix::monomix_code, sizeof(pack_monomix::monomix_code)/sizeof(dsp_code), pack_monomix::monomix_info, sizeof(pack_monomix::monomix_info)/sizeof(dsp_register_info), &pack_monomix::monomix_itramsize, &pack_monomix::monomix_xtramsize },
+ { "kxfx_pack/da_MoreBass.cpp", "MoreBass", pack_MoreBass::MoreBass_guid, pack_MoreBass::MoreBass_code, sizeof(pack_MoreBass::MoreBass_code)/sizeof(dsp_code), pack_MoreBass::MoreBass_info, sizeof(pack_MoreBass::MoreBass_info)/sizeof(dsp_register_info), &pack_MoreBass::MoreBass_itramsize, &pack_MoreBass::MoreBass_xtramsize },
+ { "kxfx_pack/da_mx6.cpp", "mx6", pack_mx6::mx6_guid, pack_mx6::mx6_code, sizeof(pack_mx6::mx6_code)/sizeof(dsp_code), pack_mx6::mx6_info, sizeof(pack_mx6::mx6_info)/sizeof(dsp_register_info), &pack_mx6::mx6_itramsize, &pack_mx6::mx6_xtramsize },
+ { "kxfx_pack/da_NoiseGate2T.cpp", "NoiseGate2T", pack_NoiseGate2T::NoiseGate2T_guid, pack_NoiseGate2T::NoiseGate2T_code, sizeof(pack_NoiseGate2T::NoiseGate2T_code)/sizeof(dsp_code), pack_NoiseGate2T::NoiseGate2T_info, sizeof(pack_NoiseGate2T::NoiseGate2T_info)/sizeof(dsp_register_info), &pack_NoiseGate2T::NoiseGate2T_itramsize, &pack_NoiseGate2T::NoiseGate2T_xtramsize },
+ { "kxfx_pack/da_NoiseGate2Ts.cpp", "NoiseGate2Ts", pack_NoiseGate2Ts::NoiseGate2Ts_guid, pack_NoiseGate2Ts::NoiseGate2Ts_code, sizeof(pack_NoiseGate2Ts::NoiseGate2Ts_code)/sizeof(dsp_code), pack_NoiseGate2Ts::NoiseGate2Ts_info, sizeof(pack_NoiseGate2Ts::NoiseGate2Ts_info)/sizeof(dsp_register_info), &pack_NoiseGate2Ts::NoiseGate2Ts_itramsize, &pack_NoiseGate2Ts::NoiseGate2Ts_xtramsize },
+ { "kxfx_pack/da_osc.cpp", "osc", pack_osc::osc_guid, pack_osc::osc_code, sizeof(pack_osc::osc_code)/sizeof(dsp_code), pack_osc::osc_info, sizeof(pack_osc::osc_info)/sizeof(dsp_register_info), &pack_osc::osc_itramsize, &pack_osc::osc_xtramsize },
+ { "kxfx_pack/da_overdrive.cpp", "overdrive", pack_overdrive::overdrive_guid, pack_overdrive::overdrive_code, sizeof(pack_overdrive::overdrive_code)/sizeof(dsp_code), pack_overdrive::overdrive_info, sizeof(pack_overdrive::overdrive_info)/sizeof(dsp_register_info), &pack_overdrive::overdrive_itramsize, &pack_overdrive::overdrive_xtramsize },
+ { "kxfx_pack/da_overdrive2.cpp", "overdrive2", pack_overdrive2::overdrive2_guid, pack_overdrive2::overdrive2_code, sizeof(pack_overdrive2::overdrive2_code)/sizeof(dsp_code), pack_overdrive2::overdrive2_info, sizeof(pack_overdrive2::overdrive2_info)/sizeof(dsp_register_info), &pack_overdrive2::overdrive2_itramsize, &pack_overdrive2::overdrive2_xtramsize },
+ { "kxfx_pack/da_Phaser.cpp", "Phaser", pack_Phaser::Phaser_guid, pack_Phaser::Phaser_code, sizeof(pack_Phaser::Phaser_code)/sizeof(dsp_code), pack_Phaser::Phaser_info, sizeof(pack_Phaser::Phaser_info)/sizeof(dsp_register_info), &pack_Phaser::Phaser_itramsize, &pack_Phaser::Phaser_xtramsize },
+ { "kxfx_pack/da_Phat_EQ_Mono.cpp", "Phat_EQ_Mono", pack_Phat_EQ_Mono::Phat_EQ_Mono_guid, pack_Phat_EQ_Mono::Phat_EQ_Mono_code, sizeof(pack_Phat_EQ_Mono::Phat_EQ_Mono_code)/sizeof(dsp_code), pack_Phat_EQ_Mono::Phat_EQ_Mono_info, sizeof(pack_Phat_EQ_Mono::Phat_EQ_Mono_info)/sizeof(dsp_register_info), &pack_Phat_EQ_Mono::Phat_EQ_Mono_itramsize, &pack_Phat_EQ_Mono::Phat_EQ_Mono_xtramsize },
+ { "kxfx_pack/da_Phat_EQ_Stereo.cpp", "Phat_EQ_Stereo", pack_Phat_EQ_Stereo::Phat_EQ_Stereo_guid, pack_Phat_EQ_Stereo::Phat_EQ_Stereo_code, sizeof(pack_Phat_EQ_Stereo::Phat_EQ_Stereo_code)/sizeof(dsp_code), pack_Phat_EQ_Stereo::Phat_EQ_Stereo_info, sizeof(pack_Phat_EQ_Stereo::Phat_EQ_Stereo_info)/sizeof(dsp_register_info), &pack_Phat_EQ_Stereo::Phat_EQ_Stereo_itramsize, &pack_Phat_EQ_Stereo::Phat_EQ_Stereo_xtramsize },
+ { "kxfx_pack/da_pitch.cpp", "pitch", pack_pitch::pitch_guid, pack_pitch::pitch_code, sizeof(pack_pitch::pitch_code)/sizeof(dsp_code), pack_pitch::pitch_info, sizeof(pack_pitch::pitch_info)/sizeof(dsp_register_info), &pack_pitch::pitch_itramsize, &pack_pitch::pitch_xtramsize },
+ { "kxfx_pack/da_Pos3DFX.cpp", "pos3dfx", pack_Pos3DFX::pos3dfx_guid, pack_Pos3DFX::pos3dfx_code, sizeof(pack_Pos3DFX::pos3dfx_code)/sizeof(dsp_code), pack_Pos3DFX::pos3dfx_info, sizeof(pack_Pos3DFX::pos3dfx_info)/sizeof(dsp_register_info), &pack_Pos3DFX::pos3dfx_itramsize, &pack_Pos3DFX::pos3dfx_xtramsize },
+ { "kxfx_pack/da_Prologic.cpp", "Prologic", pack_Prologic::Prologic_guid, pack_Prologic::Prologic_code, sizeof(pack_Prologic::Prologic_code)/sizeof(dsp_code), pack_Prologic::Prologic_info, sizeof(pack_Prologic::Prologic_info)/sizeof(dsp_register_info), &pack_Prologic::Prologic_itramsize, &pack_Prologic::Prologic_xtramsize },
+ { "kxfx_pack/da_prologica.cpp", "prologica", pack_prologica::prologica_guid, pack_prologica::prologica_code, sizeof(pack_prologica::prologica_code)/sizeof(dsp_code), pack_prologica::prologica_info, sizeof(pack_prologica::prologica_info)/sizeof(dsp_register_info), &pack_prologica::prologica_itramsize, &pack_prologica::prologica_xtramsize },
+ { "kxfx_pack/da_ProPhaser.cpp", "ProPhaser", pack_ProPhaser::ProPhaser_guid, pack_ProPhaser::ProPhaser_code, sizeof(pack_ProPhaser::ProPhaser_code)/sizeof(dsp_code), pack_ProPhaser::ProPhaser_info, sizeof(pack_ProPhaser::ProPhaser_info)/sizeof(dsp_register_info), &pack_ProPhaser::ProPhaser_itramsize, &pack_ProPhaser::ProPhaser_xtramsize },
+ { "kxfx_pack/da_ReverbEax2.cpp", "ReverbEax2", pack_ReverbEax2::ReverbEax2_guid, pack_ReverbEax2::ReverbEax2_code, sizeof(pack_ReverbEax2::ReverbEax2_code)/sizeof(dsp_code), pack_ReverbEax2::ReverbEax2_info, sizeof(pack_ReverbEax2::ReverbEax2_info)/sizeof(dsp_register_info), &pack_ReverbEax2::ReverbEax2_itramsize, &pack_ReverbEax2::ReverbEax2_xtramsize },
+ { "kxfx_pack/da_ringmod.cpp", "ringmod", pack_ringmod::ringmod_guid, pack_ringmod::ringmod_code, sizeof(pack_ringmod::ringmod_code)/sizeof(dsp_code), pack_ringmod::ringmod_info, sizeof(pack_ringmod::ringmod_info)/sizeof(dsp_register_info), &pack_ringmod::ringmod_itramsize, &pack_ringmod::ringmod_xtramsize },
+ { "kxfx_pack/da_soundgen.cpp", "soundgen", pack_soundgen::soundgen_guid, pack_soundgen::soundgen_code, sizeof(pack_soundgen::soundgen_code)/sizeof(dsp_code), pack_soundgen::soundgen_info, sizeof(pack_soundgen::soundgen_info)/sizeof(dsp_register_info), &pack_soundgen::soundgen_itramsize, &pack_soundgen::soundgen_xtramsize },
+ { "kxfx_pack/da_Sputnik.cpp", "Sputnik", pack_Sputnik::Sputnik_guid, pack_Sputnik::Sputnik_code, sizeof(pack_Sputnik::Sputnik_code)/sizeof(dsp_code), pack_Sputnik::Sputnik_info, sizeof(pack_Sputnik::Sputnik_info)/sizeof(dsp_register_info), &pack_Sputnik::Sputnik_itramsize, &pack_Sputnik::Sputnik_xtramsize },
+ { "kxfx_pack/da_stereomix.cpp", "stereomix", pack_stereomix::stereomix_guid, pack_stereomix::stereomix_code, sizeof(pack_stereomix::stereomix_code)/sizeof(dsp_code), pack_stereomix::stereomix_info, sizeof(pack_stereomix::stereomix_info)/sizeof(dsp_register_info), &pack_stereomix::stereomix_itramsize, &pack_stereomix::stereomix_xtramsize },
+ { "kxfx_pack/da_stmix.cpp", "stmix", pack_stmix::stmix_guid, pack_stmix::stmix_code, sizeof(pack_stmix::stmix_code)/sizeof(dsp_code), pack_stmix::stmix_info, sizeof(pack_stmix::stmix_info)/sizeof(dsp_register_info), &pack_stmix::stmix_itramsize, &pack_stmix::stmix_xtramsize },
+ { "kxfx_pack/da_stvocoder.cpp", "stvocoder", pack_stvocoder::stvocoder_guid, pack_stvocoder::stvocoder_code, sizeof(pack_stvocoder::stvocoder_code)/sizeof(dsp_code), pack_stvocoder::stvocoder_info, sizeof(pack_stvocoder::stvocoder_info)/sizeof(dsp_register_info), &pack_stvocoder::stvocoder_itramsize, &pack_stvocoder::stvocoder_xtramsize },
+ { "kxfx_pack/da_surrounderlt.cpp", "surrounderlt", pack_surrounderlt::surrounderlt_guid, pack_surrounderlt::surrounderlt_code, sizeof(pack_surrounderlt::surrounderlt_code)/sizeof(dsp_code), pack_surrounderlt::surrounderlt_info, sizeof(pack_surrounderlt::surrounderlt_info)/sizeof(dsp_register_info), &pack_surrounderlt::surrounderlt_itramsize, &pack_surrounderlt::surrounderlt_xtramsize },
+ { "kxfx_pack/da_TheDelay.cpp", "TheDelay", pack_TheDelay::TheDelay_guid, pack_TheDelay::TheDelay_code, sizeof(pack_TheDelay::TheDelay_code)/sizeof(dsp_code), pack_TheDelay::TheDelay_info, sizeof(pack_TheDelay::TheDelay_info)/sizeof(dsp_register_info), &pack_TheDelay::TheDelay_itramsize, &pack_TheDelay::TheDelay_xtramsize },
+ { "kxfx_pack/da_TheSmallDelay.cpp", "TheSmallDelay", pack_TheSmallDelay::TheSmallDelay_guid, pack_TheSmallDelay::TheSmallDelay_code, sizeof(pack_TheSmallDelay::TheSmallDelay_code)/sizeof(dsp_code), pack_TheSmallDelay::TheSmallDelay_info, sizeof(pack_TheSmallDelay::TheSmallDelay_info)/sizeof(dsp_register_info), &pack_TheSmallDelay::TheSmallDelay_itramsize, &pack_TheSmallDelay::TheSmallDelay_xtramsize },
+ { "kxfx_pack/da_TimeBalanceV2.cpp", "TimeBalanceV2", pack_TimeBalanceV2::TimeBalanceV2_guid, pack_TimeBalanceV2::TimeBalanceV2_code, sizeof(pack_TimeBalanceV2::TimeBalanceV2_code)/sizeof(dsp_code), pack_TimeBalanceV2::TimeBalanceV2_info, sizeof(pack_TimeBalanceV2::TimeBalanceV2_info)/sizeof(dsp_register_info), &pack_TimeBalanceV2::TimeBalanceV2_itramsize, &pack_TimeBalanceV2::TimeBalanceV2_xtramsize },
+ { "kxfx_pack/da_tremolo.cpp", "tremolo", pack_tremolo::tremolo_guid, pack_tremolo::tremolo_code, sizeof(pack_tremolo::tremolo_code)/sizeof(dsp_code), pack_tremolo::tremolo_info, sizeof(pack_tremolo::tremolo_info)/sizeof(dsp_register_info), &pack_tremolo::tremolo_itramsize, &pack_tremolo::tremolo_xtramsize },
+ { "kxfx_pack/da_ts.cpp", "ts", pack_ts::ts_guid, pack_ts::ts_code, sizeof(pack_ts::ts_code)/sizeof(dsp_code), pack_ts::ts_info, sizeof(pack_ts::ts_info)/sizeof(dsp_register_info), &pack_ts::ts_itramsize, &pack_ts::ts_xtramsize },
+ { "kxfx_pack/da_vibrato.cpp", "vibrato", pack_vibrato::vibrato_guid, pack_vibrato::vibrato_code, sizeof(pack_vibrato::vibrato_code)/sizeof(dsp_code), pack_vibrato::vibrato_info, sizeof(pack_vibrato::vibrato_info)/sizeof(dsp_register_info), &pack_vibrato::vibrato_itramsize, &pack_vibrato::vibrato_xtramsize },
+ { "kxfx_pack/da_virtual5_1.cpp", "virtual51", pack_virtual5_1::virtual51_guid, pack_virtual5_1::virtual51_code, sizeof(pack_virtual5_1::virtual51_code)/sizeof(dsp_code), pack_virtual5_1::virtual51_info, sizeof(pack_virtual5_1::virtual51_info)/sizeof(dsp_register_info), &pack_virtual5_1::virtual51_itramsize, &pack_virtual5_1::virtual51_xtramsize },
+ { "kxfx_pack/da_vocoder.cpp", "vocoder", pack_vocoder::vocoder_guid, pack_vocoder::vocoder_code, sizeof(pack_vocoder::vocoder_code)/sizeof(dsp_code), pack_vocoder::vocoder_info, sizeof(pack_vocoder::vocoder_info)/sizeof(dsp_register_info), &pack_vocoder::vocoder_itramsize, &pack_vocoder::vocoder_xtramsize },
+ { "kxfx_pack/da_voldc.cpp", "voldc", pack_voldc::voldc_guid, pack_voldc::voldc_code, sizeof(pack_voldc::voldc_code)/sizeof(dsp_code), pack_voldc::voldc_info, sizeof(pack_voldc::voldc_info)/sizeof(dsp_register_info), &pack_voldc::voldc_itramsize, &pack_voldc::voldc_xtramsize },
+ { "kxfx_pack/da_wavegen.cpp", "wavegen", pack_wavegen::wavegen_guid, pack_wavegen::wavegen_code, sizeof(pack_wavegen::wavegen_code)/sizeof(dsp_code), pack_wavegen::wavegen_info, sizeof(pack_wavegen::wavegen_info)/sizeof(dsp_register_info), &pack_wavegen::wavegen_itramsize, &pack_wavegen::wavegen_xtramsize },
+ { "kxfx_pack/da_wavegen2.cpp", "wavegen2", pack_wavegen2::wavegen2_guid, pack_wavegen2::wavegen2_code, sizeof(pack_wavegen2::wavegen2_code)/sizeof(dsp_code), pack_wavegen2::wavegen2_info, sizeof(pack_wavegen2::wavegen2_info)/sizeof(dsp_register_info), &pack_wavegen2::wavegen2_itramsize, &pack_wavegen2::wavegen2_xtramsize },
+ { "kxfx_pack/da_wavegen3.cpp", "wavegen3", pack_wavegen3::wavegen3_guid, pack_wavegen3::wavegen3_code, sizeof(pack_wavegen3::wavegen3_code)/sizeof(dsp_code), pack_wavegen3::wavegen3_info, sizeof(pack_wavegen3::wavegen3_info)/sizeof(dsp_register_info), &pack_wavegen3::wavegen3_itramsize, &pack_wavegen3::wavegen3_xtramsize },
+ { "kxfx_pack/da_Wibrato.cpp", "Wibrato", pack_Wibrato::Wibrato_guid, pack_Wibrato::Wibrato_code, sizeof(pack_Wibrato::Wibrato_code)/sizeof(dsp_code), pack_Wibrato::Wibrato_info, sizeof(pack_Wibrato::Wibrato_info)/sizeof(dsp_register_info), &pack_Wibrato::Wibrato_itramsize, &pack_Wibrato::Wibrato_xtramsize },
+ { "kxfx_pack/da_xor.cpp", "xor", pack_xor::xor_guid, pack_xor::xor_code, sizeof(pack_xor::xor_code)/sizeof(dsp_code), pack_xor::xor_info, sizeof(pack_xor::xor_info)/sizeof(dsp_register_info), &pack_xor::xor_itramsize, &pack_xor::xor_xtramsize },
+ { NULL, NULL, NULL, NULL, 0, NULL, 0, NULL, NULL }
+};
+
+static int guid_equal(const char *a,const char *b)
+{
+ for(;*a && *b;a++,b++)
+ {
+  char x=*a,y=*b;
+  if(x>='A' && x<='Z') x=(char)(x-'A'+'a');
+  if(y>='A' && y<='Z') y=(char)(y-'A'+'a');
+  if(x!=y)
+   return 0;
+ }
+ return *a==*b;
+}
+
+const kx_emu_fx *kx_emu_find_fx(const char *name)
+{
+ if(!name)
+  return NULL;
+
+ // the GUID is case-insensitive: kX DSP settings keep it as declared by the plugin
+ for(int i=0;kx_emu_fx_library[i].name;i++)
+  if(kx_emu_fx_library[i].guid && guid_equal(kx_emu_fx_library[i].guid,name))
+   return &kx_emu_fx_library[i];
+ for(int i=0;kx_emu_fx_library[i].name;i++)
+  if(strcmp(kx_emu_fx_library[i].name,name)==0)
+   return &kx_emu_fx_library[i];
+ return NULL;
+}
+
+int kx_emu_load_fx(kx_emu *emu,const kx_emu_fx *fx,const char *name,int force_pgm_id)
+{
+ return kx_emu_load_microcode(emu,name?name:fx->name,fx->code,fx->code_size*sizeof(dsp_code),
+    fx->info,fx->info_size*sizeof(dsp_register_info),*fx->itramsize,*fx->xtramsize,
+    "","","","",fx->guid?fx->guid:"",force_pgm_id);
+}
@@ -0,0 +1,344 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// host-side DSP emulator: instruction execution
+// -----
+// arithmetic model (see also www/help/dane.htm):
+//  - operands are 32-bit signed fractions (1.31) or integers
+//  - the accumulator is kept as a 64-bit integer; it is readable as the 'a' operand only
+//  - every instruction except SKIP updates the accumulator and the CCR
+//  - CCR is not stored: it is computed from the last result when it is read
+//    (CCR 'borrow' bit is not emulated)
+// TRAM model:
+//  - data registers flagged TRAM_READ are loaded before the sample period starts,
+//    data registers flagged TRAM_WRITE are stored after it ends
+//  - delay line address = (TRAM address register + DBAC) & (size-1); DBAC is decremented
+//    every sample period, so 'write at 0 / read at N' gives a delay of N samples
+//  - external TRAM keeps 16-bit samples only (as stored in host memory)
+
+#include <string.h>
+
+#include "hw/8010x.h"     // note: #undef's CCR; keep it before dsp.h
+#include "emu/kxemu.h"
+#include "emudsp.h"
+
+static inline int is_read_only(kx_emu *emu,word reg)
+{
+ word base=emu->is_10k2?0xc0:0x40;
+ if(reg>=base && reg<=base+(DBAC-KX_CONST-0x40) && reg!=base+(IRQREG-KX_CONST-0x40))
+  return 1;
+ if(emu->is_10k2 && reg==0xeb)
+  return 1;
+ return 0;
+}
+
+static void kx_emu_link(kx_emu *emu)
+{
+ int lo=0,hi=emu->microcode_size-1;
+ word c0=(word)(emu->is_10k2?0xc0:0x40);
+ word accum_reg=c0+(ACCUM-C_0);
+ word ccr_reg=c0+(CCR-C_0);
+
+ // hardware executes the whole instruction memory; leading and trailing
+ // empty instructions only leave ACCUM=0 / CCR=Z, which is restored per sample instead
+ #define is_nop(i) (emu->instr[i].op==ACC3 && emu->instr[i].r==c0 && emu->instr[i].a==c0 && \
+                    emu->instr[i].x==c0 && emu->instr[i].y==c0)
+ while(lo<=hi && is_nop(lo)) lo++;
+ while(hi>=lo && is_nop(hi)) hi--;
+ #undef is_nop
+
+ emu->trimmed=(lo>0 || hi<emu->microcode_size-1);
+ emu->prog_size=0;
+
+ for(int i=lo;i<=hi;i++)
+ {
+  kx_emu_op *o=&emu->prog[emu->prog_size++];
+  dsp_code *c=&emu->instr[i];
+
+  o->op=c->op&0xf;
+  o->pgm=emu->instr_pgm[i];
+  o->r=c->r;
+  o->a=c->a;
+  o->x=c->x;
+  o->y=c->y;
+
+  if(o->r>=emu->n_regs) o->r=c0;
+  if(o->a>=emu->n_regs) o->a=c0;
+  if(o->x>=emu->n_regs) o->x=c0;
+  if(o->y>=emu->n_regs) o->y=c0;
+
+  if(is_read_only(emu,o->r))
+   o->r=KX_EMU_SINK;
+
+  o->flags=0;
+  if(o->a==accum_reg)
+   o->flags|=KX_EMU_A_ACCUM;
+  if(o->a==ccr_reg || o->x==ccr_reg || o->y==ccr_reg || o->x==accum_reg || o->y==accum_reg)
+   o->flags|=KX_EMU_SPECIAL;
+ }
+
+ emu->dirty=0;
+ emu->link_serial++;
+}
+
+static inline dword tram_addr(kx_emu *emu,int k)
+{
+ return tram_base(emu,emu->regs[TANKMEMADDRREGBASE+k])+emu->dbac;
+}
+
+int kx_emu_process(kx_emu *emu,int samples)
+{
+ int i,k;
+
+ if(emu->dirty)
+  kx_emu_link(emu);
+
+ kx_emu_jit_func jit=(emu->engine==KX_EMU_ENGINE_JIT)?kx_emu_jit_get(emu):NULL;
+ kx_emu_jit_state st;
+ st.emu=emu;
+
+ // collect active i/o and TRAM registers once per block
+ word ins[KX_EMU_MAX_IO],outs[KX_EMU_MAX_IO];
+ int n_ins=0,n_outs=0;
+ for(i=0;i<KX_EMU_MAX_IO;i++)
+ {
+  if(emu->in_buf[i]) ins[n_ins++]=(word)i;
+  if(emu->out_buf[i]) outs[n_outs++]=(word)i;
+ }
+
+ word tram_rd[0x100],tram_wr[0x100];
+ int n_rd=0,n_wr=0;
+ int xtram_off=emu->is_10k2?192:128;
+ int n_tram=emu->is_10k2?256:160;
+ for(k=0;k<n_tram;k++)
+ {
+  if(k>=xtram_off && !emu->xtram)
+   break;
+  if(emu->tram_flags[k]&TRAM_READ) tram_rd[n_rd++]=(word)k;
+  if(emu->tram_flags[k]&TRAM_WRITE) tram_wr[n_wr++]=(word)k;
+ }
+
+ word c0=(word)(emu->is_10k2?0xc0:0x40);
+ word accum_reg=c0+(ACCUM-C_0);
+ word ccr_reg=c0+(CCR-C_0);
+ word noise1_reg=c0+(NOISE1-C_0);
+ word noise2_reg=c0+(NOISE2-C_0);
+ word irq_reg=c0+(IRQREG-C_0);
+ word dbac_reg=c0+(DBAC-C_0);
+ dword xmask=emu->xtram_size-1;
+
+ dword *regs=emu->regs;
+ const kx_emu_op *prog=emu->prog;
+ int n=emu->prog_size;
+ kx_emu_pgm_stats *stats=emu->stats;
+
+ __int64 acc=emu->accum;
+ dword last=emu->last_result;
+ int sat=emu->last_sat;
+
+ for(int s=0;s<samples;s++)
+ {
+  for(i=0;i<n_ins;i++)
+   regs[ins[i]]=emu->in_buf[ins[i]][s*emu->in_stride[ins[i]]];
+
+  for(i=0;i<n_rd;i++)
+  {
+   k=tram_rd[i];
+   dword a=tram_addr(emu,k);
+   if(k<xtram_off)
+    regs[TANKMEMDATAREGBASE+k]=emu->itram[a&(KX_EMU_ITRAM_SIZE-1)];
+   else
+    regs[TANKMEMDATAREGBASE+k]=((dword)emu->xtram[a&xmask])<<16;
+  }
+
+  // xorshift: deterministic noise so that renders are reproducible
+  emu->noise^=emu->noise<<13;
+  emu->noise^=emu->noise>>17;
+  emu->noise^=emu->noise<<5;
+  regs[noise1_reg]=emu->noise;
+  regs[noise2_reg]=(emu->noise>>16)|(emu->noise<<16);
+  regs[dbac_reg]=dbac_reg_value(emu,emu->dbac);
+
+  if(emu->trimmed)
+  {
+   acc=0;
+   last=0;
+   sat=0;
+  }
+
+  if(jit)
+  {
+   st.acc=acc;
+   st.last=last;
+   st.sat=sat;
+   jit(&st,regs);
+   acc=st.acc;
+   last=st.last;
+   sat=st.sat;
+  }
+  else
+  for(int pc=0;pc<n;pc++)
+  {
+   const kx_emu_op *o=&prog[pc];
+
+   if(o->flags&KX_EMU_SPECIAL)
+   {
+    regs[ccr_reg]=make_ccr(last,sat);
+    int dummy;
+    regs[accum_reg]=sat32(acc,dummy);
+   }
+
+   __int64 A=(o->flags&KX_EMU_A_ACCUM)?acc:(__int64)(int)regs[o->a];
+   int X=(int)regs[o->x];
+   int Y=(int)regs[o->y];
+   dword r;
+
+   switch(o->op)
+   {
+    case MACS:
+    	acc=A+(((__int64)X*Y)>>31);
+    	r=sat32(acc,sat);
+    	break;
+    case MACS1:
+    	acc=A-(((__int64)X*Y)>>31);
+    	r=sat32(acc,sat);
+    	break;
+    case MACW:
+    	acc=A+(((__int64)X*Y)>>31);
+    	r=(dword)acc;
+    	sat=0;
+    	break;
+    case MACW1:
+    	acc=A-(((__int64)X*Y)>>31);
+    	r=(dword)acc;
+    	sat=0;
+    	break;
+    case MACINTS:
+    	acc=A+(__int64)X*Y;
+    	r=sat32(acc,sat);
+    	break;
+    case MACINTW:
+    	// wraps around at 31 bits; the sign is kept
+    	acc=A+(__int64)X*Y;
+    	r=((dword)acc&0x7fffffff)|(acc<0?0x80000000:0);
+    	sat=0;
+    	break;
+    case ACC3:
+    	acc=A+X+Y;
+    	r=sat32(acc,sat);
+    	break;
+    case MACMV:
+    	{
+    	 int dummy;
+    	 r=(o->flags&KX_EMU_A_ACCUM)?sat32(A,dummy):(dword)A;
+    	 acc+=((__int64)X*Y)>>31;
+    	 sat=0;
+    	}
+    	break;
+    case ANDXOR:
+    	r=((dword)A&(dword)X)^(dword)Y;
+    	acc=(int)r;
+    	sat=0;
+    	break;
+    case TSTNEG:
+    	r=(A>=Y)?(dword)X:~(dword)X;
+    	acc=(int)r;
+    	sat=0;
+    	break;
+    case LIMIT:
+    	r=(A>=Y)?(dword)X:(dword)Y;
+    	acc=(int)r;
+    	sat=0;
+    	break;
+    case LIMIT1:
+    	r=(A<Y)?(dword)X:(dword)Y;
+    	acc=(int)r;
+    	sat=0;
+    	break;
+    case LOG:
+    	r=dsp_log((dword)A,(dword)X,(dword)Y);
+    	acc=(int)r;
+    	sat=0;
+    	break;
+    case EXP:
+    	r=dsp_exp((dword)A,(dword)X,(dword)Y);
+    	acc=(int)r;
+    	sat=0;
+    	break;
+    case INTERP:
+    	acc=A+((X*((__int64)Y-A))>>31);
+    	r=sat32(acc,sat);
+    	break;
+    default: // SKIP r, ccr, test, count
+    	{
+    	 dword ccr=(o->a==ccr_reg)?make_ccr(last,sat):(dword)A;
+    	 regs[o->r]=ccr;
+    	 if(skip_test(ccr,(dword)X))
+    	 {
+    	  int cnt=skip_count(Y,pc,n);
+    	  for(k=1;k<=cnt;k++)
+    	   stats[prog[pc+k].pgm].skipped++;
+    	  pc+=cnt;
+    	 }
+    	}
+    	continue;
+   }
+   regs[o->r]=r;
+   last=r;
+  }
+
+  for(i=0;i<n_wr;i++)
+  {
+   k=tram_wr[i];
+   dword a=tram_addr(emu,k);
+   if(k<xtram_off)
+    emu->itram[a&(KX_EMU_ITRAM_SIZE-1)]=regs[TANKMEMDATAREGBASE+k];
+   else
+    emu->xtram[a&xmask]=(word)(regs[TANKMEMDATAREGBASE+k]>>16);
+  }
+
+  for(i=0;i<n_outs;i++)
+   emu->out_buf[outs[i]][s*emu->out_stride[outs[i]]]=regs[outs[i]];
+
+  if(regs[irq_reg]&0x80000000)
+  {
+   emu->irq_count++;
+   regs[irq_reg]=0;
+  }
+
+  emu->dbac--;
+ }
+
+ emu->accum=acc;
+ emu->last_result=last;
+ emu->last_sat=sat;
+
+ // ACCUM / CCR registers reflect the state after the last sample period
+ int dummy;
+ regs[accum_reg]=sat32(acc,dummy);
+ regs[ccr_reg]=make_ccr(last,sat);
+ emu->samples+=samples;
+
+ // executed = issued - skipped; issued instructions are counted per owner
+ for(i=0;i<n;i++)
+  stats[prog[i].pgm].executed+=samples;
+
+ return 0;
+}
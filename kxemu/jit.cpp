@@ -0,0 +1,637 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// host-side DSP emulator: native code compiler
+// -----
+// the resolved program (prog[], see interp.cpp: kx_emu_link()) is translated into x86-64
+// machine code: one straight-line function per program that executes one sample period
+// - DSP registers are addressed directly (rbx: emu->regs); the accumulator, the last result
+//   and the saturation flag (the CCR source) are kept in r12, r13d and r14d
+// - MACS...INTERP and the CCR are emitted inline, saturation is branch-free (cmov);
+//   LOG / EXP call the same code as the interpreter
+// - SKIP calls jit_skip() (test, statistics) and jumps through a table of instruction addresses
+// - accumulator and CCR updates that are overwritten before they are read are not emitted
+// the sample period frame (host i/o, TRAM, noise, DBAC, IRQ) is run by kx_emu_process()
+// the results are bit-identical to the interpreter, including the accumulator, CCR, TRAM,
+// IRQ and SKIP statistics (kxbench: 'dspjit')
+// code is only generated for x86-64 (Win64 and System V calling conventions); elsewhere, or if
+// executable memory cannot be allocated, kx_emu_jit_get() fails and the interpreter is used
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hw/8010x.h"     // note: #undef's CCR; keep it before dsp.h
+#include "emu/kxemu.h"
+#include "emudsp.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+ #define JIT_X64
+ #ifdef _WIN32
+  #include <windows.h>
+ #else
+  #include <sys/mman.h>
+ #endif
+#endif
+
+typedef struct kx_emu_jit_t
+{
+ int serial;                    // emu->link_serial the program was compiled for
+ byte *code;
+ int code_size;
+ kx_emu_jit_func func;          // NULL: could not be compiled
+ size_t *labels;                // code address of every instruction; [prog_size]: epilogue
+}kx_emu_jit;
+
+static void jit_release(kx_emu_jit *j)
+{
+#ifdef JIT_X64
+ if(j->code)
+ {
+  #ifdef _WIN32
+   VirtualFree(j->code,0,MEM_RELEASE);
+  #else
+   munmap(j->code,j->code_size);
+  #endif
+ }
+#endif
+ if(j->labels)
+  free(j->labels);
+ j->code=NULL;
+ j->code_size=0;
+ j->func=NULL;
+ j->labels=NULL;
+}
+
+#ifdef JIT_X64
+
+// ------------------------------------------------------------------------------------------
+// run-time helpers: called from the generated code
+
+static dword jit_log(dword a,dword x,dword y)
+{
+ return dsp_log(a,x,y);
+}
+
+static dword jit_exp(dword a,dword x,dword y)
+{
+ return dsp_exp(a,x,y);
+}
+
+// stores the CCR operand, returns the number of instructions to skip
+static int jit_skip(kx_emu_jit_state *st,dword ccr,int pc)
+{
+ kx_emu *emu=st->emu;
+ const kx_emu_op *o=&emu->prog[pc];
+ dword x=emu->regs[o->x];
+ int y=(int)emu->regs[o->y];
+
+ emu->regs[o->r]=ccr;
+ if(!skip_test(ccr,x))
+  return 0;
+
+ int cnt=skip_count(y,pc,emu->prog_size);
+ for(int k=1;k<=cnt;k++)
+  emu->stats[emu->prog[pc+k].pgm].skipped++;
+ return cnt;
+}
+
+// ------------------------------------------------------------------------------------------
+// x86-64 encoder
+
+#define RAX     0
+#define RCX     1
+#define RDX     2
+#define RBX     3
+#define RSI     6
+#define RDI     7
+#define R8      8
+#define R12     12
+#define R13     13
+#define R14     14
+#define R15     15
+
+#define ACC     R12             // accumulator, 64-bit
+#define LAST    R13             // last result
+#define SAT     R14             // saturation flag
+
+#ifdef _WIN32
+ #define ARG0   RCX
+ #define ARG1   RDX
+ #define ARG2   R8
+ #define JIT_SHADOW 32          // home space for the callee
+#else
+ #define ARG0   RDI
+ #define ARG1   RSI
+ #define ARG2   RDX
+ #define JIT_SHADOW 0
+#endif
+
+typedef struct
+{
+ byte *p;
+ int pos,size;                  // pos>size: out of space
+}jit_emitter;
+
+static void jit_bytes(jit_emitter *e,const char *b,int n)
+{
+ if(e->pos+n<=e->size)
+  memcpy(e->p+e->pos,b,n);
+ e->pos+=n;
+}
+
+static void jit_byte(jit_emitter *e,int b)
+{
+ char c=(char)b;
+ jit_bytes(e,&c,1);
+}
+
+static void jit_dword(jit_emitter *e,dword v)
+{
+ for(int i=0;i<4;i++)
+  jit_byte(e,(v>>(i*8))&0xff);
+}
+
+static void jit_qword(jit_emitter *e,unsigned __int64 v)
+{
+ jit_dword(e,(dword)v);
+ jit_dword(e,(dword)(v>>32));
+}
+
+static void jit_rex(jit_emitter *e,int w,int reg,int rm)
+{
+ int rex=(w?8:0)|((reg&8)?4:0)|((rm&8)?1:0);
+ if(rex)
+  jit_byte(e,0x40|rex);
+}
+
+// op reg,rm (register operands)
+static void jit_rr(jit_emitter *e,int w,const char *op,int n,int reg,int rm)
+{
+ jit_rex(e,w,reg,rm);
+ jit_bytes(e,op,n);
+ jit_byte(e,0xc0|((reg&7)<<3)|(rm&7));
+}
+
+// op reg,[rbx+r*4] (DSP register r)
+static void jit_rm(jit_emitter *e,int w,const char *op,int n,int reg,word r)
+{
+ jit_rex(e,w,reg,0);
+ jit_bytes(e,op,n);
+ jit_byte(e,0x80|((reg&7)<<3)|RBX);
+ jit_dword(e,(dword)r*4);
+}
+
+// op reg,[r15+offset] (kx_emu_jit_state)
+static void jit_st(jit_emitter *e,int w,const char *op,int reg,int offset)
+{
+ jit_rex(e,w,reg,R15);
+ jit_bytes(e,op,1);
+ jit_byte(e,0x40|((reg&7)<<3)|(R15&7));
+ jit_byte(e,offset);
+}
+
+#define jit_load(e,reg,r)       jit_rm(e,1,"\x63",1,reg,r)          // movsxd reg,[r]
+#define jit_load32(e,reg,r)     jit_rm(e,0,"\x8b",1,reg,r)          // mov reg32,[r]
+#define jit_store(e,reg,r)      jit_rm(e,0,"\x89",1,reg,r)          // mov [r],reg32
+#define jit_mov(e,d,s)          jit_rr(e,1,"\x89",1,s,d)            // mov d,s
+#define jit_mov32(e,d,s)        jit_rr(e,0,"\x89",1,s,d)            // mov d32,s32
+#define jit_sext(e,d,s)         jit_rr(e,1,"\x63",1,d,s)            // movsxd d,s32
+#define jit_add(e,d,s)          jit_rr(e,1,"\x01",1,s,d)
+#define jit_sub(e,d,s)          jit_rr(e,1,"\x29",1,s,d)
+#define jit_cmp(e,d,s)          jit_rr(e,1,"\x39",1,s,d)            // flags of d-s
+#define jit_imul(e,d,s)         jit_rr(e,1,"\x0f\xaf",2,d,s)
+#define jit_zero32(e,d)         jit_rr(e,0,"\x31",1,d,d)            // xor d32,d32
+#define jit_not32(e,d)          jit_rr(e,0,"\xf7",1,2,d)
+#define jit_or32(e,d,s)         jit_rr(e,0,"\x09",1,s,d)
+#define jit_cmovne32(e,d,s)     jit_rr(e,0,"\x0f\x45",2,d,s)
+#define jit_cmovl32(e,d,s)      jit_rr(e,0,"\x0f\x4c",2,d,s)
+#define jit_cmovge32(e,d,s)     jit_rr(e,0,"\x0f\x4d",2,d,s)
+#define jit_add32(e,d,s)        jit_rr(e,0,"\x01",1,s,d)
+#define jit_xor32(e,d,s)        jit_rr(e,0,"\x31",1,s,d)
+#define jit_setne8(e,d)         jit_rr(e,0,"\x0f\x95",2,0,d)
+#define jit_sete8(e,d)          jit_rr(e,0,"\x0f\x94",2,0,d)
+
+// shifts by an immediate: ext 4: shl, 5: shr, 7: sar
+static void jit_shift(jit_emitter *e,int w,int ext,int d,int count)
+{
+ jit_rr(e,w,"\xc1",1,ext,d);
+ jit_byte(e,count);
+}
+
+// op32 d,imm32: ext 4: and, 6: xor
+static void jit_imm32(jit_emitter *e,int ext,int d,dword v)
+{
+ jit_rr(e,0,"\x81",1,ext,d);
+ jit_dword(e,v);
+}
+
+static void jit_mov_imm32(jit_emitter *e,int d,dword v)
+{
+ jit_rex(e,0,0,d);
+ jit_byte(e,0xb8|(d&7));
+ jit_dword(e,v);
+}
+
+static void jit_mov_imm64(jit_emitter *e,int d,unsigned __int64 v)
+{
+ jit_rex(e,1,0,d);
+ jit_byte(e,0xb8|(d&7));
+ jit_qword(e,v);
+}
+
+static void jit_call(jit_emitter *e,unsigned __int64 f)
+{
+ jit_mov_imm64(e,RAX,f);
+ jit_rr(e,0,"\xff",1,2,RAX);    // call rax
+}
+
+// ------------------------------------------------------------------------------------------
+// code generation
+
+// liveness of the DSP state after an instruction
+#define LIVE_ACC    0x1
+#define LIVE_LAST   0x2
+#define LIVE_SAT    0x4
+#define LIVE_ALL    (LIVE_ACC|LIVE_LAST|LIVE_SAT)
+
+// eax=sat32(rax); sat is updated if 'set_sat'; clobbers rcx, rdx
+static void jit_sat32(jit_emitter *e,int set_sat)
+{
+ jit_mov(e,RDX,RAX);
+ jit_shift(e,1,7,RDX,63);
+ jit_imm32(e,6,RDX,0x7fffffff); // 0x7fffffff or 0x80000000, by the sign
+ if(set_sat)
+  jit_zero32(e,SAT);
+ jit_sext(e,RCX,RAX);
+ jit_cmp(e,RCX,RAX);            // fits in 32 bits?
+ if(set_sat)
+  jit_setne8(e,SAT);
+ jit_cmovne32(e,RAX,RDX);
+}
+
+// eax=make_ccr(last,sat); clobbers rcx, rdx
+static void jit_ccr(jit_emitter *e)
+{
+ jit_zero32(e,RAX);
+ jit_zero32(e,RCX);
+ jit_rr(e,0,"\x85",1,SAT,SAT);     // test sat,sat
+ jit_setne8(e,RAX);
+ jit_rr(e,0,"\x85",1,LAST,LAST);   // test last,last
+ jit_sete8(e,RCX);
+ jit_shift(e,0,4,RAX,4);            // S
+ jit_shift(e,0,4,RCX,3);            // Z
+ jit_or32(e,RAX,RCX);
+ jit_mov32(e,RCX,LAST);
+ jit_shift(e,0,5,RCX,31);
+ jit_shift(e,0,4,RCX,2);            // M
+ jit_or32(e,RAX,RCX);
+ jit_mov32(e,RCX,LAST);
+ jit_mov32(e,RDX,LAST);
+ jit_add32(e,RDX,RDX);
+ jit_xor32(e,RDX,RCX);
+ jit_shift(e,0,5,RDX,31);
+ jit_shift(e,0,4,RDX,1);            // N: bit 31 != bit 30
+ jit_or32(e,RAX,RDX);
+}
+
+// rax='a' operand, sign-extended to 64 bits (the accumulator is used as is)
+static void jit_operand_a(jit_emitter *e,const kx_emu_op *o)
+{
+ if(o->flags&KX_EMU_A_ACCUM)
+  jit_mov(e,RAX,ACC);
+ else
+  jit_load(e,RAX,o->a);
+}
+
+// eax=(dword)'a'
+static void jit_operand_a32(jit_emitter *e,const kx_emu_op *o,int reg)
+{
+ if(o->flags&KX_EMU_A_ACCUM)
+  jit_mov32(e,reg,ACC);
+ else
+  jit_load32(e,reg,o->a);
+}
+
+// rcx=(X*Y)>>31
+static void jit_mul_shr31(jit_emitter *e,const kx_emu_op *o)
+{
+ jit_load(e,RCX,o->x);
+ jit_load(e,RDX,o->y);
+ jit_imul(e,RCX,RDX);
+ jit_shift(e,1,7,RCX,31);
+}
+
+static void jit_op(jit_emitter *e,kx_emu *emu,const kx_emu_op *o,int pc,int live,size_t *labels)
+{
+ if(o->flags&KX_EMU_SPECIAL)
+ {
+  jit_mov(e,RAX,ACC);
+  jit_sat32(e,0);
+  jit_store(e,RAX,emu_special(emu,ACCUM));
+  jit_ccr(e);
+  jit_store(e,RAX,emu_special(emu,CCR));
+ }
+
+ switch(o->op)
+ {
+  case MACS:
+  case MACS1:
+  case MACW:
+  case MACW1:
+  	jit_operand_a(e,o);
+  	jit_mul_shr31(e,o);
+  	if(o->op==MACS || o->op==MACW)
+  	 jit_add(e,RAX,RCX);
+  	else
+  	 jit_sub(e,RAX,RCX);
+  	if(live&LIVE_ACC)
+  	 jit_mov(e,ACC,RAX);
+  	if(o->op==MACS || o->op==MACS1)
+  	 jit_sat32(e,live&LIVE_SAT);
+  	else
+  	if(live&LIVE_SAT)
+  	 jit_zero32(e,SAT);
+  	break;
+  case MACINTS:
+  case MACINTW:
+  	jit_operand_a(e,o);
+  	jit_load(e,RCX,o->x);
+  	jit_load(e,RDX,o->y);
+  	jit_imul(e,RCX,RDX);
+  	jit_add(e,RAX,RCX);
+  	if(live&LIVE_ACC)
+  	 jit_mov(e,ACC,RAX);
+  	if(o->op==MACINTS)
+  	 jit_sat32(e,live&LIVE_SAT);
+  	else
+  	{
+  	 // wraps around at 31 bits; the sign is kept
+  	 jit_mov(e,RDX,RAX);
+  	 jit_shift(e,1,5,RDX,63);
+  	 jit_shift(e,0,4,RDX,31);
+  	 jit_imm32(e,4,RAX,0x7fffffff);
+  	 jit_or32(e,RAX,RDX);
+  	 if(live&LIVE_SAT)
+  	  jit_zero32(e,SAT);
+  	}
+  	break;
+  case ACC3:
+  	jit_operand_a(e,o);
+  	jit_load(e,RCX,o->x);
+  	jit_load(e,RDX,o->y);
+  	jit_add(e,RAX,RCX);
+  	jit_add(e,RAX,RDX);
+  	if(live&LIVE_ACC)
+  	 jit_mov(e,ACC,RAX);
+  	jit_sat32(e,live&LIVE_SAT);
+  	break;
+  case INTERP:
+  	jit_operand_a(e,o);
+  	jit_load(e,RCX,o->x);
+  	jit_load(e,RDX,o->y);
+  	jit_sub(e,RDX,RAX);
+  	jit_imul(e,RCX,RDX);
+  	jit_shift(e,1,7,RCX,31);
+  	jit_add(e,RAX,RCX);
+  	if(live&LIVE_ACC)
+  	 jit_mov(e,ACC,RAX);
+  	jit_sat32(e,live&LIVE_SAT);
+  	break;
+  case MACMV:
+  	if(o->flags&KX_EMU_A_ACCUM)
+  	{
+  	 jit_mov(e,RAX,ACC);
+  	 jit_sat32(e,0);
+  	}
+  	else
+  	 jit_load32(e,RAX,o->a);
+  	if(live&LIVE_ACC)
+  	{
+  	 jit_mul_shr31(e,o);
+  	 jit_add(e,ACC,RCX);
+  	}
+  	if(live&LIVE_SAT)
+  	 jit_zero32(e,SAT);
+  	break;
+  case ANDXOR:
+  case TSTNEG:
+  case LIMIT:
+  case LIMIT1:
+  case LOG:
+  case EXP:
+  	if(o->op==ANDXOR)
+  	{
+  	 jit_operand_a32(e,o,RAX);
+  	 jit_rm(e,0,"\x23",1,RAX,o->x);     // and eax,[x]
+  	 jit_rm(e,0,"\x33",1,RAX,o->y);     // xor eax,[y]
+  	}
+  	else
+  	if(o->op==LOG || o->op==EXP)
+  	{
+  	 jit_operand_a32(e,o,ARG0);
+  	 jit_load32(e,ARG1,o->x);
+  	 jit_load32(e,ARG2,o->y);
+  	 jit_call(e,(o->op==LOG)?(size_t)jit_log:(size_t)jit_exp);
+  	}
+  	else
+  	{
+  	 jit_operand_a(e,o);
+  	 jit_load(e,RDX,o->y);
+  	 jit_load32(e,RCX,o->x);
+  	 jit_cmp(e,RAX,RDX);
+  	 jit_mov32(e,RAX,RCX);
+  	 if(o->op==TSTNEG)
+  	 {
+  	  jit_not32(e,RCX);             // does not change the flags
+  	  jit_cmovl32(e,RAX,RCX);
+  	 }
+  	 else
+  	 if(o->op==LIMIT)
+  	  jit_cmovl32(e,RAX,RDX);
+  	 else
+  	  jit_cmovge32(e,RAX,RDX);
+  	}
+  	if(live&LIVE_ACC)
+  	 jit_sext(e,ACC,RAX);
+  	if(live&LIVE_SAT)
+  	 jit_zero32(e,SAT);
+  	break;
+  default: // SKIP r, ccr, test, count
+  	// ccr_reg is an operand: KX_EMU_SPECIAL has set it to the CCR already
+  	jit_operand_a32(e,o,ARG1);
+  	jit_mov(e,ARG0,R15);
+  	jit_mov_imm32(e,ARG2,pc);
+  	jit_call(e,(size_t)jit_skip);
+  	jit_mov32(e,RAX,RAX);           // zero-extends the count
+  	jit_rr(e,0,"\x85",1,RAX,RAX);   // test eax,eax
+  	jit_bytes(e,"\x74\x0d",2);      // jz: not taken
+  	jit_mov_imm64(e,RCX,(size_t)&labels[pc+1]);
+  	jit_bytes(e,"\xff\x24\xc1",3);  // jmp [rcx+rax*8]
+  	return;
+ }
+
+ jit_store(e,RAX,o->r);
+ if(live&LIVE_LAST)
+  jit_mov32(e,LAST,RAX);
+}
+
+#define JIT_MAX_CODE    192     // bytes per instruction, worst case
+#define JIT_MAX_FRAME   128     // prologue, epilogue
+
+static int jit_compile(kx_emu *emu,kx_emu_jit *j)
+{
+ int i,n=emu->prog_size;
+
+ jit_release(j);
+
+ byte *live=(byte *)malloc(n+1);
+ j->labels=(size_t *)malloc((n+1)*sizeof(size_t));
+ j->code_size=n*JIT_MAX_CODE+JIT_MAX_FRAME;
+ #ifdef _WIN32
+  j->code=(byte *)VirtualAlloc(NULL,j->code_size,MEM_COMMIT|MEM_RESERVE,PAGE_READWRITE);
+ #else
+  j->code=(byte *)mmap(NULL,j->code_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if(j->code==(byte *)MAP_FAILED)
+   j->code=NULL;
+ #endif
+ if(!live || !j->labels || !j->code)
+ {
+  if(live) free(live);
+  jit_release(j);
+  return -1;
+ }
+
+ // DSP state read by later instructions; a SKIP may go to any of them,
+ // the state is saved after the last one
+ int l=LIVE_ALL;
+ for(i=n-1;i>=0;i--)
+ {
+  const kx_emu_op *o=&emu->prog[i];
+  live[i]=(byte)l;
+  if(o->op==SKIP)
+   l=LIVE_ALL;
+  else
+  {
+   l=0;                         // every other instruction sets all of the state
+   if((o->flags&KX_EMU_A_ACCUM) || o->op==MACMV)
+    l|=LIVE_ACC;
+  }
+  if(o->flags&KX_EMU_SPECIAL)
+   l=LIVE_ALL;
+ }
+
+ jit_emitter e;
+ e.p=j->code;
+ e.pos=0;
+ e.size=j->code_size;
+
+ // void func(kx_emu_jit_state *st,dword *regs)
+ jit_bytes(&e,"\x53\x41\x54\x41\x55\x41\x56\x41\x57",9); // push rbx, r12..r15: the stack is aligned
+ if(JIT_SHADOW)
+ {
+  jit_bytes(&e,"\x48\x83\xec",3);    // sub rsp,JIT_SHADOW
+  jit_byte(&e,JIT_SHADOW);
+ }
+ jit_mov(&e,R15,ARG0);
+ jit_mov(&e,RBX,ARG1);
+ jit_st(&e,1,"\x8b",ACC,offsetof(kx_emu_jit_state,acc));
+ jit_st(&e,0,"\x8b",LAST,offsetof(kx_emu_jit_state,last));
+ jit_st(&e,0,"\x8b",SAT,offsetof(kx_emu_jit_state,sat));
+
+ for(i=0;i<n;i++)
+ {
+  j->labels[i]=(size_t)(j->code+e.pos);
+  jit_op(&e,emu,&emu->prog[i],i,live[i],j->labels);
+ }
+ j->labels[n]=(size_t)(j->code+e.pos);
+
+ jit_st(&e,1,"\x89",ACC,offsetof(kx_emu_jit_state,acc));
+ jit_st(&e,0,"\x89",LAST,offsetof(kx_emu_jit_state,last));
+ jit_st(&e,0,"\x89",SAT,offsetof(kx_emu_jit_state,sat));
+ if(JIT_SHADOW)
+ {
+  jit_bytes(&e,"\x48\x83\xc4",3);    // add rsp,JIT_SHADOW
+  jit_byte(&e,JIT_SHADOW);
+ }
+ jit_bytes(&e,"\x41\x5f\x41\x5e\x41\x5d\x41\x5c\x5b\xc3",10); // pop r15..r12, rbx; ret
+
+ free(live);
+
+ if(e.pos>e.size)
+ {
+  jit_release(j);
+  return -1;
+ }
+
+ // W^X: the code is not writable once generated
+ #ifdef _WIN32
+  DWORD old;
+  if(!VirtualProtect(j->code,j->code_size,PAGE_EXECUTE_READ,&old))
+ #else
+  if(mprotect(j->code,j->code_size,PROT_READ|PROT_EXEC))
+ #endif
+ {
+  jit_release(j);
+  return -1;
+ }
+
+ j->func=(kx_emu_jit_func)(void *)j->code;
+ return 0;
+}
+
+#endif // JIT_X64
+
+kx_emu_jit_func kx_emu_jit_get(kx_emu *emu)
+{
+#ifdef JIT_X64
+ kx_emu_jit *j=emu->jit;
+
+ if(!j)
+ {
+  j=(kx_emu_jit *)calloc(1,sizeof(kx_emu_jit));
+  if(!j)
+   return NULL;
+  j->serial=emu->link_serial-1;
+  emu->jit=j;
+ }
+
+ // a program that could not be compiled is not retried until it changes
+ if(j->serial!=emu->link_serial)
+ {
+  jit_compile(emu,j);
+  j->serial=emu->link_serial;
+ }
+ return j->func;
+#else
+ (void)emu;
+ return NULL;
+#endif
+}
+
+void kx_emu_jit_free(kx_emu *emu)
+{
+ if(emu->jit)
+ {
+  jit_release(emu->jit);
+  free(emu->jit);
+  emu->jit=NULL;
+ }
+}
@@ -0,0 +1,1142 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// host-side DSP emulator: microcode management
+// this follows driver/dsp.cpp closely: register allocation, microcode placement,
+// connections and bypass produce the same physical instruction memory as the driver does
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hw/8010x.h"     // note: #undef's CCR; keep it before dsp.h
+#include "emu/kxemu.h"
+#include "driver/dspalloc.h"
+#include "emudsp.h"
+
+#define is_valid_gpr(a) ( ((a)!=DSP_REG_NOT_TRANSLATED) && ((a)>=E10K1_GPR_BASE) && ((a)<emu->first_instruction) )
+#define is_register(a) (a&0xd000)
+
+#define get_bit(a,b) (a[(b)/32]&(1<<((b)%32)))
+#define set_bit(a,b) a[(b)/32]|=(1<<((b)%32))
+#define clear_bit(a,b) a[(b)/32]&=(~(1<<((b)%32)))
+
+// physical constant values (0x40.. for 10k1; 0xc0.. for 10k2)
+static const dword kx_emu_constants[C_00100000-C_0+1]=
+{
+ 0x0, 0x1, 0x2, 0x3, 0x4, 0x8, 0x10, 0x20, 0x100, 0x10000, 0x80000 /* 10k2: 0x800 */,
+ 0x10000000, 0x20000000, 0x40000000, 0x80000000, 0x7fffffff, 0xffffffff, 0xfffffffe,
+ 0xc0000000, 0x4f1bbcdc, 0x5a7ef9db, 0x00100000
+};
+
+static inline word phys_const(kx_emu *emu,word c)
+{
+ return (word)(c-KX_CONST+(emu->is_10k2?0x80:0));
+}
+
+static void emu_op(kx_emu *emu,int addr,int pgm,word op,word r,word a,word x,word y)
+{
+ emu->instr[addr].op=(byte)op;
+ emu->instr[addr].r=r;
+ emu->instr[addr].a=a;
+ emu->instr[addr].x=x;
+ emu->instr[addr].y=y;
+ emu->instr_pgm[addr]=(word)pgm;
+ emu->dirty=1;
+}
+
+static void emu_nop(kx_emu *emu,int addr)
+{
+ word c0=phys_const(emu,C_0);
+ emu_op(emu,addr,0,ACC3,c0,c0,c0,c0);
+}
+
+// same as check_const() in driver/dsp.cpp for generic (non-p17v) boards
+word kx_emu_map_operand(kx_emu *emu,word a)
+{
+ if((a>=KX_CONST)&&(a<KX_IN(0)))  // const
+ {
+   a=a-KX_CONST+(emu->is_10k2?0x80:0);
+   if(emu->is_10k2)
+   {
+    if(a>0xdb && a!=0xeb)
+     a=0xc0;
+   }
+   else
+   {
+    if(a>0x5b)
+     a=0x40;
+   }
+ }
+ else
+  if((a>=KX_IN(0))&&(a<KX_OUT(0))) // inputs
+  {
+   if(!emu->is_10k2)
+   {
+    a=a-KX_IN(0)+0x10;
+    if(a>=0x20)
+     a=0x40;
+   }
+   else
+   {
+    // swap 4:5 <--> 6:7 for 10k2
+    if(a==KX_IN(6)) a=KX_IN(4);
+    else if(a==KX_IN(7)) a=KX_IN(5);
+    else if(a==KX_IN(4)) a=KX_IN(6);
+    else if(a==KX_IN(5)) a=KX_IN(7);
+
+    if(a>=KX_IN(0) && a<=KX_IN(0xe))
+     a=a-KX_IN(0)+0x40;
+    else
+     a=0xc0;
+   }
+  }
+  else
+   if((a>=KX_OUT(0))&&(a<KX_FX(0))) // outputs
+   {
+    if(!emu->is_10k2)
+    {
+     a=a-KX_OUT(0)+0x20;
+     if(a>0x34)
+      a=0x40;
+    }
+    else
+    switch(a)
+    {
+        case 0x2300: a=0x68; break; // front l (i2s 0)
+        case 0x2301: a=0x69; break; // front r (i2s 0)
+        case 0x2320: a=0x70; break; // AC97 DAC Front L
+        case 0x2321: a=0x71; break; // AC97 DAC Front R
+        case 0x2302: a=0x60; break; // din front l (spdif 0)
+        case 0x2303: a=0x61; break; // din front r (spdif 0)
+        case 0x2304: a=0x62; break; // din center (spdif 1)
+        case 0x2305: a=0x63; break; // din sub (spdif 1)
+        case 0x2306: a=0x64; break; // headphones l (spdif 2)
+        case 0x2307: a=0x65; break; // headphones r (spdif 2)
+        case 0x2308: a=0x6e; break; // rear l (i2s 3)
+        case 0x2309: a=0x6f; break; // rear r (i2s 3)
+        case 0x2328: a=0x66; break; // din rear l (spdif 3)
+        case 0x2329: a=0x67; break; // din rear r (spdif 3)
+        case 0x2311: a=0x6a; break; // center (i2s 1)
+        case 0x2312: a=0x6b; break; // sub (i2s 1)
+        case 0x2330: a=0x6c; break; // (i2s 2) l
+        case 0x2331: a=0x6d; break; // (i2s 2) r
+        case 0x2372: a=0x72; break; // AC97 DAC Center
+        case 0x2373: a=0x73; break; // AC97 DAC Rear L
+        case 0x2374: a=0x74; break; // AC97 DAC Rear R
+        case 0x2375: a=0x75; break; // AC97 DAC Subwoofer
+        case 0x230a: a=0x76; break; // Recording ADC buffers
+        case 0x230b: a=0x77; break;
+        case 0x230c: a=0x78; break; // Mic 8kHz src output
+        default:
+         if(a>=0x2360 && a<=0x23ff)
+          a-=0x2300;
+         else
+          a=0xc0;
+    }
+   }
+  else
+   if((a>=KX_FX(0))&&(a<KX_FX2(0))) // FX busses
+   {
+     a=a-KX_FX(0);
+     if(a>=0x40)
+      a=0x40+(emu->is_10k2?0x80:0);
+   }
+  else
+   if((a>=KX_FX2(0))&&(a<KX_E32IN(0))) // FX2
+   {
+    if(!emu->is_10k2)
+    {
+     a=a-KX_FX2(0)+0x30;
+     if(a>=0x40)
+      a=0x40;
+    }
+    else
+    {
+     a=a-KX_FX2(0)+0x80;
+     if(a>=0xc0)
+      a=0xc0;
+    }
+   }
+   else
+    if((a>=KX_E32IN(0))&&(a<KX_E32IN(0x3f)))
+    {
+     if(emu->is_10k2)
+     {
+      a=a-KX_E32IN(0)+0x50;
+      if(a>=0x60)
+       a=0xc0;
+     }
+     else
+      a=0x40;
+    }
+    else
+     if((a>=KX_E32OUT(0)) && (a<KX_E32OUT(0x3f)))
+     {
+       if(emu->is_10k2)
+       {
+         if(a<KX_E32OUT(0x10))
+           a=a-KX_E32OUT(0)+0xb0;
+         else
+          if(a<KX_E32OUT(0x20))
+            a=a-KX_E32OUT(0x10)+0xa0;
+          else
+            a=0xc0;
+       }
+       else
+        a=0x40;
+     }
+ return a;
+}
+
+int kx_emu_create(kx_emu **ret,int is_10k2,dword xtram_size_bytes)
+{
+ *ret=NULL;
+
+ kx_emu *emu=(kx_emu *)calloc(1,sizeof(kx_emu));
+ if(!emu)
+  return -1;
+
+ emu->is_10k2=is_10k2?1:0;
+ emu->microcode_size=is_10k2?E10K2_MAX_INSTRUCTIONS:E10K1_MAX_INSTRUCTIONS;
+ emu->first_instruction=is_10k2?E10K2_MICROCODE_BASE:E10K1_MICROCODE_BASE;
+ emu->n_regs=is_10k2?KX_EMU_REGS_K2:KX_EMU_REGS_K1;
+
+ // external TRAM is addressed with a power-of-two mask
+ dword xs=xtram_size_bytes/2;
+ emu->xtram_size=0;
+ while(xs>1 && (emu->xtram_size<<1)<=xs)
+  emu->xtram_size=emu->xtram_size?(emu->xtram_size<<1):1;
+ if(emu->xtram_size<2)
+  emu->xtram_size=0;
+
+ emu->itram=(dword *)calloc(KX_EMU_ITRAM_SIZE,sizeof(dword));
+ if(emu->xtram_size)
+  emu->xtram=(word *)calloc(emu->xtram_size,sizeof(word));
+ emu->prog=(kx_emu_op *)calloc(E10K2_MAX_INSTRUCTIONS,sizeof(kx_emu_op));
+ emu->engine=KX_EMU_ENGINE_JIT;
+
+ if(!emu->itram || !emu->prog || (emu->xtram_size && !emu->xtram))
+ {
+  kx_emu_destroy(emu);
+  return -2;
+ }
+
+ kx_emu_reset(emu);
+
+ *ret=emu;
+ return 0;
+}
+
+void kx_emu_destroy(kx_emu *emu)
+{
+ if(!emu)
+  return;
+
+ for(int i=0;i<MAX_PGM_NUMBER;i++)
+  kx_emu_unload_microcode(emu,i);
+
+ if(emu->itram) free(emu->itram);
+ if(emu->xtram) free(emu->xtram);
+ if(emu->prog) free(emu->prog);
+ kx_emu_jit_free(emu);
+ free(emu);
+}
+
+int kx_emu_set_engine(kx_emu *emu,int engine)
+{
+ if(engine!=KX_EMU_ENGINE_INTERP && engine!=KX_EMU_ENGINE_JIT)
+  return -1;
+ emu->engine=engine;
+ return 0;
+}
+
+int kx_emu_reset(kx_emu *emu)
+{
+ int i;
+ for(i=0;i<MAX_PGM_NUMBER;i++)
+  kx_emu_unload_microcode(emu,i);
+
+ for(i=0;i<emu->microcode_size;i++)
+  emu_nop(emu,i);
+
+ memset(emu->regs,0,sizeof(emu->regs));
+ memset(emu->regs_usage,0,sizeof(emu->regs_usage));
+ memset(emu->microcode_usage,0,sizeof(emu->microcode_usage));
+ memset(emu->tram_flags,0,sizeof(emu->tram_flags));
+ memset(emu->itram,0,KX_EMU_ITRAM_SIZE*sizeof(dword));
+ if(emu->xtram)
+  memset(emu->xtram,0,emu->xtram_size*sizeof(word));
+
+ word base=phys_const(emu,C_0);
+ for(i=0;i<=C_00100000-C_0;i++)
+  emu->regs[base+i]=kx_emu_constants[i];
+ if(emu->is_10k2)
+ {
+  emu->regs[base+(C_80000-C_0)]=0x800;
+  emu->regs[phys_const(emu,C_1F)]=0x1f;
+ }
+
+ emu->dbac=0;
+ emu->accum=0;
+ emu->last_result=0;
+ emu->last_sat=0;
+ emu->noise=0x1d872b41;
+ emu->samples=0;
+ emu->irq_count=0;
+ emu->dirty=1;
+
+ kx_emu_reset_stats(emu);
+
+ return 0;
+}
+
+dsp_microcode *kx_emu_get_microcode(kx_emu *emu,int pgm)
+{
+ if(pgm<=0 || pgm>=MAX_PGM_NUMBER)
+  return NULL;
+ return emu->pgms[pgm];
+}
+
+static dsp_register_info *find_register(dsp_microcode *m,word id)
+{
+   for(dword i=0;i<m->info_size/sizeof(dsp_register_info);i++)
+   	if(m->info[i].num==id)
+   		return &m->info[i];
+   return NULL;
+}
+
+static dsp_register_info *find_register(dsp_microcode *m,const char *name)
+{
+   for(dword i=0;i<m->info_size/sizeof(dsp_register_info);i++)
+ 	if(strncmp(name,&m->info[i].name[0],MAX_GPR_NAME)==0)
+   		return &m->info[i];
+   return NULL;
+}
+
+// instruction upload: same as upload_instruction() in the driver
+static int upload_instruction(kx_emu *emu,dsp_microcode *m,int i)
+{
+   word z,w,x,y;
+   dsp_register_info *tmp;
+   int have_outputs=0;
+
+   if(!(m->flag&MICROCODE_TRANSLATED) || m->offset==DSP_MICROCODE_NOT_TRANSLATED)
+    return -1;
+
+   z=m->code[i].r;
+   if(is_register(z))
+   {
+      tmp=find_register(m,z);
+      if(!tmp || tmp->translated==DSP_REG_NOT_TRANSLATED) return -1;
+      z=tmp->translated;
+      if((tmp->type&GPR_MASK)==GPR_OUTPUT)
+        have_outputs|=1;
+   }
+   w=m->code[i].a;
+   if(is_register(w))
+   {
+      tmp=find_register(m,w);
+      if(!tmp || tmp->translated==DSP_REG_NOT_TRANSLATED) return -1;
+      w=tmp->translated;
+   }
+   x=m->code[i].x;
+   if(is_register(x))
+   {
+      tmp=find_register(m,x);
+      if(!tmp || tmp->translated==DSP_REG_NOT_TRANSLATED) return -1;
+      x=tmp->translated;
+   }
+   y=m->code[i].y;
+   if(is_register(y))
+   {
+      tmp=find_register(m,y);
+      if(!tmp || tmp->translated==DSP_REG_NOT_TRANSLATED) return -1;
+      y=tmp->translated;
+   }
+
+   word operation=m->code[i].op;
+
+   // bypass / mute: 'any_op out, a, b, c' -> 'macs out, in, 0, 0' / 'macs out, 0, 0, 0'
+   if(((m->flag&MICROCODE_BYPASS)||(!(m->flag&MICROCODE_ENABLED))) && (have_outputs&1))
+   {
+     operation=MACS;
+     w=C_0;
+     x=C_0;
+     y=C_0;
+
+     if(m->flag&MICROCODE_BYPASS)
+     {
+       int n_outs=0,n_ins=0;
+       int this_out=-1;
+       dword j;
+
+       for(j=0;j<m->info_size/sizeof(dsp_register_info);j++)
+       {
+        if((m->info[j].type&GPR_MASK)==GPR_OUTPUT)
+        {
+         n_outs++;
+         if(z==m->info[j].translated)
+          this_out=n_outs;
+        }
+        if((m->info[j].type&GPR_MASK)==GPR_INPUT)
+         n_ins++;
+       }
+       if(n_outs>0 && n_ins>0 && this_out>0)
+       {
+        while(this_out>n_ins)
+         this_out-=n_ins;
+        n_ins=0;
+        for(j=0;j<m->info_size/sizeof(dsp_register_info);j++)
+        {
+         if((m->info[j].type&GPR_MASK)==GPR_INPUT)
+         {
+          n_ins++;
+          if(n_ins==this_out)
+          {
+           w=m->info[j].translated;
+           break;
+          }
+         }
+        }
+       }
+     }
+   }
+
+   emu_op(emu,i+m->offset,m->pgm,operation,
+     kx_emu_map_operand(emu,z),kx_emu_map_operand(emu,w),
+     kx_emu_map_operand(emu,x),kx_emu_map_operand(emu,y));
+
+   return 0;
+}
+
+static void upload_microcode(kx_emu *emu,dsp_microcode *m)
+{
+ for(dword i=0;i<m->code_size/sizeof(dsp_code);i++)
+  upload_instruction(emu,m,i);
+}
+
+static void upload_register_users(kx_emu *emu,dsp_microcode *m,word num)
+{
+ if(!(m->flag&MICROCODE_TRANSLATED))
+  return;
+ for(dword i=0;i<m->code_size/sizeof(dsp_code);i++)
+  if(m->code[i].r==num || m->code[i].a==num || m->code[i].x==num || m->code[i].y==num)
+   upload_instruction(emu,m,i);
+}
+
+// regs_usage bit range [from,to) for the given register type
+static void get_register_pool(kx_emu *emu,dword type,int *from,int *to)
+{
+ if(emu->is_10k2)
+ {
+  *from=0x200;
+  *to=*from+0x200;
+ }
+ else
+ {
+  *from=0;
+  *to=0x100;
+ }
+
+ int xtram_off=emu->is_10k2?192:128;
+ int xtram_count=emu->is_10k2?64:32;
+
+ if((type&GPR_MASK)==GPR_ITRAM)
+ {
+  *from=0x100;
+  *to=*from+xtram_off;
+ }
+ if((type&GPR_MASK)==GPR_XTRAM)
+ {
+  *from=0x100+xtram_off;
+  *to=*from+xtram_count;
+ }
+}
+
+static int allocate_register(kx_emu *emu,dsp_microcode *m,int reg)
+{
+ int from,to;
+ get_register_pool(emu,m->info[reg].type,&from,&to);
+
+ int bit=kx_bitmap_alloc_bit(emu->regs_usage,from,to);
+ if(bit<0)
+  return -10;
+
+ m->info[reg].translated=(word)(bit+0x100);
+ if(from==0x200) // 10k2 GPR
+  m->info[reg].translated+=0x100;
+ return 0;
+}
+
+static void free_register(kx_emu *emu,dsp_microcode *m,int reg)
+{
+ word t=m->info[reg].translated;
+ if(is_valid_gpr(t))
+ {
+  if(t>=0x400)
+   clear_bit(emu->regs_usage,t-0x200);
+  else
+   clear_bit(emu->regs_usage,t-0x100);
+ }
+ m->info[reg].translated=DSP_REG_NOT_TRANSLATED;
+}
+
+static int allocate_microcode(kx_emu *emu,dsp_microcode *m,int pos,int pos_pgm)
+{
+ int size=(int)(m->code_size/sizeof(dsp_code));
+ int initial=0,final=emu->microcode_size;
+ int mode=KX_ALLOC_BEST;
+
+ if(pos!=KX_EMU_MICROCODE_ABSOLUTE)
+ {
+  if(pos_pgm!=0)
+  {
+   dsp_microcode *mm=kx_emu_get_microcode(emu,pos_pgm);
+   if(mm && mm->offset!=DSP_MICROCODE_NOT_TRANSLATED)
+   {
+    if(pos==KX_EMU_MICROCODE_BEFORE)
+     final=mm->offset;
+    else
+     initial=mm->offset+mm->code_size/sizeof(dsp_code);
+   }
+  }
+  if(pos==KX_EMU_MICROCODE_BEFORE)
+   mode=KX_ALLOC_BEST_TOP;
+ }
+ else
+ {
+  if(pos_pgm>=emu->microcode_size)
+   return -10;
+  initial=pos_pgm;
+  final=pos_pgm+size*2-1;
+  if(final>emu->microcode_size)
+   final=emu->microcode_size;
+  mode=KX_ALLOC_FIRST;
+ }
+
+ int offset=kx_bitmap_alloc(emu->microcode_usage,initial,final,size,mode);
+ if(offset<0)
+  return -10;
+ m->offset=offset;
+ return 0;
+}
+
+static void set_tram_addr(kx_emu *emu,dsp_microcode *m,dsp_register_info *info,dword addr)
+{
+ info->p=addr;
+
+ if((info->type&GPR_MASK)==GPR_ITRAM)
+  addr+=m->itram_start;
+ else
+  addr+=m->xtram_start;
+
+ if(emu->is_10k2)
+  addr=addr<<0xb;
+ else
+  addr=addr&TANKMEMADDRREG_ADDR_MASK_K1;
+
+ if(is_valid_gpr(info->translated))
+  emu->regs[info->translated+0x100]=addr;
+}
+
+#define tram_limit(is_x) ((is_x)?emu->xtram_size:(dword)KX_EMU_ITRAM_SIZE)
+
+// TRAM extents of all translated microcode except 'm', sorted
+static int get_tram_extents(kx_emu *emu,dsp_microcode *m,int is_x,kx_extent *e)
+{
+ int n=0;
+ for(int i=1;i<MAX_PGM_NUMBER;i++)
+ {
+  dsp_microcode *mm=emu->pgms[i];
+  if(!mm || mm==m || !(mm->flag&MICROCODE_TRANSLATED))
+   continue;
+  dword s=is_x?mm->xtram_start:mm->itram_start;
+  dword sz=is_x?mm->xtramsize:mm->itramsize;
+  if(s==0 && sz==0)
+   continue;
+  n=kx_extent_insert(e,n,s,sz);
+ }
+ return n;
+}
+
+static int find_tram_region(kx_emu *emu,dsp_microcode *m,int is_x,int *ret)
+{
+ kx_extent e[MAX_PGM_NUMBER];
+ int n=get_tram_extents(emu,m,is_x,e);
+ dword start;
+ if(kx_extent_alloc(e,n,tram_limit(is_x),is_x?m->xtramsize:m->itramsize,is_x?512:16,&start))
+  return -1;
+ *ret=(int)start;
+ return 0;
+}
+
+static void disconnect_output(kx_emu *emu,word src_gpr)
+{
+ for(int i=1;i<MAX_PGM_NUMBER;i++)
+ {
+  dsp_microcode *m=emu->pgms[i];
+  if(!m || !(m->flag&MICROCODE_TRANSLATED))
+   continue;
+  for(dword rg=0;rg<m->info_size/sizeof(dsp_register_info);rg++)
+  {
+   if((m->info[rg].type&GPR_MASK)==GPR_INPUT && m->info[rg].translated==src_gpr)
+   {
+    m->info[rg].translated=C_0;
+    upload_register_users(emu,m,m->info[rg].num);
+   }
+  }
+ }
+}
+
+static int untranslate_microcode(kx_emu *emu,dsp_microcode *m)
+{
+ if(m->offset!=DSP_MICROCODE_NOT_TRANSLATED)
+ {
+  for(dword i=0;i<m->code_size/sizeof(dsp_code);i++)
+  {
+   emu_nop(emu,m->offset+i);
+   clear_bit(emu->microcode_usage,m->offset+i);
+  }
+  m->offset=DSP_MICROCODE_NOT_TRANSLATED;
+ }
+
+ for(dword i=0;i<m->info_size/sizeof(dsp_register_info);i++)
+ {
+  dsp_register_info *info=&m->info[i];
+  if((info->type&GPR_MASK)==GPR_OUTPUT && is_valid_gpr(info->translated))
+   disconnect_output(emu,info->translated);
+  if((info->type&GPR_MASK)==GPR_INPUT)
+   info->translated=C_0;
+  if(info->translated!=DSP_REG_NOT_TRANSLATED && (info->type&GPR_MASK)!=GPR_INPUT)
+  {
+   if(is_valid_gpr(info->translated))
+   {
+    emu->regs[info->translated]=0;
+    if((info->type&GPR_MASK)==GPR_ITRAM || (info->type&GPR_MASK)==GPR_XTRAM)
+    {
+     emu->regs[info->translated+0x100]=0;
+     emu->tram_flags[info->translated-TANKMEMDATAREGBASE]=0;
+    }
+   }
+   if((info->type&GPR_MASK)!=GPR_TRAMA)
+    free_register(emu,m,i);
+   else
+    info->translated=DSP_REG_NOT_TRANSLATED;
+  }
+ }
+ m->flag&=~(MICROCODE_TRANSLATED|MICROCODE_ENABLED|MICROCODE_BYPASS);
+ m->itram_start=0;
+ m->xtram_start=0;
+ emu->dirty=1;
+ return 0;
+}
+
+int kx_emu_load_microcode(kx_emu *emu,const char *name,const dsp_code *code,int code_size,
+    const dsp_register_info *info,int info_size,int itramsize,int xtramsize,
+    const char *copyright,const char *engine,const char *created,const char *comment,
+    const char *guid,int force_pgm_id)
+{
+ int pgm=0;
+
+ if(force_pgm_id==0)
+ {
+  for(int i=1;i<MAX_PGM_NUMBER;i++)
+   if(emu->pgms[i]==NULL)
+   {
+    pgm=i;
+    break;
+   }
+ }
+ else
+ {
+  if(force_pgm_id<0 || force_pgm_id>=MAX_PGM_NUMBER || emu->pgms[force_pgm_id])
+   return -1;
+  pgm=force_pgm_id;
+ }
+ if(pgm==0)
+  return -1;
+
+ dsp_microcode *m=(dsp_microcode *)calloc(1,sizeof(dsp_microcode));
+ if(!m)
+  return -1;
+ if(code_size)
+ {
+  m->code=(dsp_code *)malloc(code_size);
+  if(!m->code) { free(m); return -1; }
+  memcpy(m->code,code,code_size);
+ }
+ if(info_size)
+ {
+  m->info=(dsp_register_info *)malloc(info_size);
+  if(!m->info) { if(m->code) free(m->code); free(m); return -1; }
+  memcpy(m->info,info,info_size);
+ }
+
+ if(name) strncpy(m->name,name,KX_MAX_STRING-1);
+ if(copyright) strncpy(m->copyright,copyright,KX_MAX_STRING-1);
+ if(engine) strncpy(m->engine,engine,KX_MAX_STRING-1);
+ if(created) strncpy(m->created,created,KX_MAX_STRING-1);
+ if(comment) strncpy(m->comment,comment,KX_MAX_STRING-1);
+ if(guid) strncpy(m->guid,guid,KX_MAX_STRING-1);
+ m->code_size=code_size;
+ m->info_size=info_size;
+ m->itramsize=itramsize;
+ m->xtramsize=xtramsize;
+ m->pgm=pgm;
+ m->offset=DSP_MICROCODE_NOT_TRANSLATED;
+
+ for(dword j=0;j<m->info_size/sizeof(dsp_register_info);j++)
+  m->info[j].translated=DSP_REG_NOT_TRANSLATED;
+
+ emu->pgms[pgm]=m;
+ memset(&emu->stats[pgm],0,sizeof(kx_emu_pgm_stats));
+ emu->stats[pgm].code_size=code_size/sizeof(dsp_code);
+
+ return pgm;
+}
+
+int kx_emu_unload_microcode(kx_emu *emu,int pgm)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ if(!m)
+  return -1;
+
+ untranslate_microcode(emu,m);
+ emu->pgms[pgm]=NULL;
+
+ if(m->info) free(m->info);
+ if(m->code) free(m->code);
+ free(m);
+ return 0;
+}
+
+int kx_emu_translate_microcode(kx_emu *emu,int pgm,int place,int pos_pgm)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ if(!m)
+  return -1;
+ if(m->flag&MICROCODE_TRANSLATED)
+  return 0;
+
+ dword n_info=m->info_size/sizeof(dsp_register_info);
+ dword i;
+
+ m->itram_start=0;
+ m->xtram_start=0;
+
+ // special system microcode: see kx_translate_microcode()
+ if(strcmp(m->guid,"2b8b7fa8-98b9-4f6e-81a0-400d3ba39c6f")==0) // fxbus
+ {
+  for(i=0;i<n_info;i++) m->info[i].translated=(word)i;
+ }
+ else if(strcmp(m->guid,"131f1059-f384-4403-abd0-16ef6025bb9b")==0) // fxbus2
+ {
+  for(i=0;i<n_info;i++) m->info[i].translated=(word)(i+32);
+ }
+ else if(strcmp(m->guid,"d25a7874-7c00-47ca-8ad3-1b13106bde91")==0) // fxbusx
+ {
+  for(i=16;i<32 && i<n_info;i++) m->info[i].translated=(word)i;
+ }
+ else if(strcmp(m->guid,"06f1854e-8e8f-465f-8d9c-966cfcc20dc7")==0) // prolog lite
+ {
+  for(i=0;i<n_info;i++) m->info[i].translated=(word)KX_IN(i);
+ }
+ else if(strcmp(m->guid,"85e97848-0004-4006-a500-5a6a03b1bf09")==0) // epilog k1 lite
+ {
+  for(i=0;i<n_info;i++) m->info[i].translated=(word)KX_OUT(i);
+ }
+ else if(strcmp(m->guid,"f88a3e59-ed54-4fb6-9b7d-4e213ed150f2")==0 && n_info==0x29) // epilog k2 lite
+ {
+  for(i=0;i<0x19;i++) m->info[i].translated=(word)(0x60+i);
+  for(i=0x19;i<0x29;i++) m->info[i].translated=(word)KX_FX2(i-0x19);
+ }
+
+ if(m->itramsize && find_tram_region(emu,m,0,&m->itram_start))
+  return -1;
+ if(m->xtramsize && find_tram_region(emu,m,1,&m->xtram_start))
+  return -2;
+
+ for(i=0;i<n_info;i++)
+ {
+  dsp_register_info *info=&m->info[i];
+  if(info->translated!=DSP_REG_NOT_TRANSLATED)
+   continue;
+
+  switch(info->type&GPR_MASK)
+  {
+   case GPR_INPUT:
+   case 0:
+   	info->translated=C_0;
+   	break;
+   case GPR_STATIC:
+   case GPR_CONST:
+   case GPR_TEMP:
+   case GPR_CONTROL:
+   case GPR_OUTPUT:
+   	if(allocate_register(emu,m,i))
+   	{
+   	 untranslate_microcode(emu,m);
+   	 return -3;
+   	}
+   	emu->regs[info->translated]=info->p;
+   	break;
+   case GPR_ITRAM:
+   case GPR_XTRAM:
+   	if(i+1>=n_info || (m->info[i+1].type&GPR_MASK)!=GPR_TRAMA)
+   	{
+   	 untranslate_microcode(emu,m);
+   	 return -4;
+   	}
+   	if(allocate_register(emu,m,i))
+   	{
+   	 untranslate_microcode(emu,m);
+   	 return -5;
+   	}
+   	m->info[i+1].translated=info->translated+0x100;
+   	emu->regs[info->translated]=0;
+   	set_tram_addr(emu,m,info,info->p);
+   	emu->tram_flags[info->translated-TANKMEMDATAREGBASE]=info->type&(TRAM_READ|TRAM_WRITE);
+   	i++;
+   	break;
+   default: // GPR_TRAMA w/o data or unknown
+   	untranslate_microcode(emu,m);
+   	return -4;
+  }
+ }
+
+ if(m->offset==DSP_MICROCODE_NOT_TRANSLATED && m->code_size>0)
+  if(allocate_microcode(emu,m,place,pos_pgm))
+  {
+   untranslate_microcode(emu,m);
+   return -7;
+  }
+
+ m->flag|=MICROCODE_TRANSLATED;
+ upload_microcode(emu,m);
+ emu->dirty=1;
+ return 0;
+}
+
+int kx_emu_untranslate_microcode(kx_emu *emu,int pgm)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ if(!m)
+  return -1;
+ return untranslate_microcode(emu,m);
+}
+
+int kx_emu_enable_microcode(kx_emu *emu,int pgm)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ if(!m)
+  return -1;
+ if(!(m->flag&MICROCODE_ENABLED) && (m->flag&MICROCODE_TRANSLATED))
+ {
+  m->flag|=MICROCODE_ENABLED;
+  m->flag&=~MICROCODE_BYPASS;
+  upload_microcode(emu,m);
+ }
+ return 0;
+}
+
+int kx_emu_disable_microcode(kx_emu *emu,int pgm)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ if(!m)
+  return -1;
+ if((m->flag&MICROCODE_ENABLED) && (m->flag&MICROCODE_TRANSLATED))
+ {
+  m->flag&=~(MICROCODE_ENABLED|MICROCODE_BYPASS);
+  upload_microcode(emu,m);
+ }
+ return 0;
+}
+
+int kx_emu_set_microcode_bypass(kx_emu *emu,int pgm,int state)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ if(!m)
+  return -1;
+ if(m->offset!=DSP_MICROCODE_NOT_TRANSLATED && (m->flag&MICROCODE_ENABLED))
+ {
+  if(strstr(m->comment,"$nobypass")!=0)
+  {
+   m->flag&=~MICROCODE_BYPASS;
+   return -30;
+  }
+  if(state)
+   m->flag|=MICROCODE_BYPASS;
+  else
+   m->flag&=~MICROCODE_BYPASS;
+  upload_microcode(emu,m);
+ }
+ if(state)
+  return (m->flag&MICROCODE_BYPASS)?0:-20;
+ else
+  return (m->flag&MICROCODE_BYPASS)?-20:0;
+}
+
+static int is_epilog(dsp_microcode *m)
+{
+ return strcmp(m->guid,"85e97848-0004-4006-a500-5a6a03b1bf09")==0 ||
+        strcmp(m->guid,"f88a3e59-ed54-4fb6-9b7d-4e213ed150f2")==0;
+}
+
+// same rules as kx_connect_microcode(): an input takes the GPR of the output it is connected to
+int kx_emu_connect_microcode(kx_emu *emu,int pgm1,word src,int pgm2,word dst)
+{
+ dsp_register_info *source=NULL,*destination=NULL,*process=NULL;
+ dsp_microcode *src_m=NULL,*dst_m=NULL,*m=NULL;
+ word dst_reg=0,src_reg=0,process_reg=0;
+ int src_type=-1,dst_type=-1;
+
+ if(pgm1!=-1)
+ {
+  src_m=kx_emu_get_microcode(emu,pgm1);
+  source=src_m?find_register(src_m,src):NULL;
+  if(!source || ((source->type&GPR_MASK)!=GPR_INPUT && (source->type&GPR_MASK)!=GPR_OUTPUT))
+   return -1;
+  src_reg=source->translated;
+  src_type=source->type&GPR_MASK;
+  if(is_epilog(src_m))
+  {
+   src_type=-1;
+   src=src_reg;
+  }
+ }
+ else
+  src_reg=src;
+
+ if(pgm2!=-1)
+ {
+  dst_m=kx_emu_get_microcode(emu,pgm2);
+  destination=dst_m?find_register(dst_m,dst):NULL;
+  if(!destination || ((destination->type&GPR_MASK)!=GPR_INPUT && (destination->type&GPR_MASK)!=GPR_OUTPUT))
+   return -2;
+  dst_reg=destination->translated;
+  dst_type=destination->type&GPR_MASK;
+  if(is_epilog(dst_m))
+  {
+   dst_type=-1;
+   dst=dst_reg;
+  }
+ }
+ else
+  dst_reg=dst;
+
+ if(src_type==-1)
+ {
+  if(dst_type!=GPR_OUTPUT && dst_type!=GPR_INPUT)
+   return -3;
+  process=destination;
+  process_reg=src;
+  m=dst_m;
+ }
+ else if(dst_type==-1)
+ {
+  if(src_type!=GPR_OUTPUT && src_type!=GPR_INPUT)
+   return -4;
+  process=source;
+  process_reg=dst;
+  m=src_m;
+ }
+ else if(src_type==GPR_INPUT)
+ {
+  if(dst_type!=GPR_OUTPUT)
+   return -5;
+  process=source;
+  process_reg=dst_reg;
+  m=src_m;
+ }
+ else
+ {
+  if(dst_type!=GPR_INPUT)
+   return -6;
+  process=destination;
+  process_reg=src_reg;
+  m=dst_m;
+ }
+
+ if(process_reg==DSP_REG_NOT_TRANSLATED)
+  return -10;
+
+ if((process->type&GPR_MASK)==GPR_OUTPUT && is_valid_gpr(process->translated))
+  free_register(emu,m,(int)(process-m->info));
+
+ process->translated=process_reg;
+ upload_register_users(emu,m,process->num);
+ return 0;
+}
+
+int kx_emu_connect_microcode(kx_emu *emu,int pgm1,const char *src,int pgm2,const char *dst)
+{
+ word src_num=0xffff,dst_num=0xffff;
+ dsp_register_info *r;
+ dsp_microcode *m;
+
+ if(pgm1!=-1)
+ {
+  m=kx_emu_get_microcode(emu,pgm1);
+  r=m?find_register(m,src):NULL;
+  if(!r) return -1;
+  src_num=r->num;
+ }
+ if(pgm2!=-1)
+ {
+  m=kx_emu_get_microcode(emu,pgm2);
+  r=m?find_register(m,dst):NULL;
+  if(!r) return -2;
+  dst_num=r->num;
+ }
+ return kx_emu_connect_microcode(emu,pgm1,src_num,pgm2,dst_num);
+}
+
+static int set_register(kx_emu *emu,dsp_register_info *info,dword val)
+{
+ if(!info)
+  return -1;
+ info->p=val;
+ if(is_valid_gpr(info->translated))
+  emu->regs[info->translated]=val;
+ return 0;
+}
+
+static int get_register(kx_emu *emu,dsp_register_info *info,dword *val)
+{
+ if(!info)
+  return -1;
+ *val=info->p;
+ if(is_valid_gpr(info->translated))
+  *val=emu->regs[info->translated];
+ return 0;
+}
+
+int kx_emu_set_dsp_register(kx_emu *emu,int pgm,const char *name,dword val)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ return set_register(emu,m?find_register(m,name):NULL,val);
+}
+
+int kx_emu_get_dsp_register(kx_emu *emu,int pgm,const char *name,dword *val)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ return get_register(emu,m?find_register(m,name):NULL,val);
+}
+
+int kx_emu_set_dsp_register(kx_emu *emu,int pgm,word id,dword val)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ return set_register(emu,m?find_register(m,id):NULL,val);
+}
+
+int kx_emu_get_dsp_register(kx_emu *emu,int pgm,word id,dword *val)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ return get_register(emu,m?find_register(m,id):NULL,val);
+}
+
+int kx_emu_set_tram_addr(kx_emu *emu,int pgm,const char *name,dword addr)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ dsp_register_info *info=m?find_register(m,name):NULL;
+ if(!info || ((info->type&GPR_MASK)!=GPR_ITRAM && (info->type&GPR_MASK)!=GPR_XTRAM))
+  return -1;
+ set_tram_addr(emu,m,info,addr);
+ return 0;
+}
+
+int kx_emu_get_tram_addr(kx_emu *emu,int pgm,const char *name,dword *addr)
+{
+ dsp_microcode *m=kx_emu_get_microcode(emu,pgm);
+ dsp_register_info *info=m?find_register(m,name):NULL;
+ if(!info || ((info->type&GPR_MASK)!=GPR_ITRAM && (info->type&GPR_MASK)!=GPR_XTRAM))
+  return -1;
+ *addr=info->p;
+ if(is_valid_gpr(info->translated))
+ {
+  dword a=emu->regs[info->translated+0x100];
+  a=emu->is_10k2?(a>>0xb):(a&TANKMEMADDRREG_ADDR_MASK_K1);
+  *addr=a-(((info->type&GPR_MASK)==GPR_ITRAM)?m->itram_start:m->xtram_start);
+ }
+ return 0;
+}
+
+int kx_emu_bind_input(kx_emu *emu,word reg,const dword *buf,int stride)
+{
+ if(reg>=KX_CONST)
+  reg=kx_emu_map_operand(emu,reg);
+ if(reg>=KX_EMU_MAX_IO)
+  return -1;
+ emu->in_buf[reg]=buf;
+ emu->in_stride[reg]=stride;
+ return 0;
+}
+
+int kx_emu_bind_output(kx_emu *emu,word reg,dword *buf,int stride)
+{
+ if(reg>=KX_CONST)
+  reg=kx_emu_map_operand(emu,reg);
+ if(reg>=KX_EMU_MAX_IO)
+  return -1;
+ emu->out_buf[reg]=buf;
+ emu->out_stride[reg]=stride;
+ return 0;
+}
+
+int kx_emu_get_stats(kx_emu *emu,int pgm,kx_emu_pgm_stats *st)
+{
+ if(pgm<0 || pgm>=MAX_PGM_NUMBER)
+  return -1;
+ *st=emu->stats[pgm];
+ st->executed-=st->skipped;    // kx_emu_process() counts issued instructions
+ return 0;
+}
+
+void kx_emu_reset_stats(kx_emu *emu)
+{
+ for(int i=0;i<MAX_PGM_NUMBER;i++)
+ {
+  emu->stats[i].executed=0;
+  emu->stats[i].skipped=0;
+ }
+}
+
+// same figures as kx_get_dsp_resources()
+int kx_emu_get_resources(kx_emu *emu,kx_dsp_resources *res)
+{
+ kx_extent e[MAX_PGM_NUMBER];
+ int from,to;
+
+ memset(res,0,sizeof(kx_dsp_resources));
+
+ kx_bitmap_stats(emu->microcode_usage,0,emu->microcode_size,&res->pool[KX_DSP_POOL_MICROCODE]);
+
+ get_register_pool(emu,GPR_STATIC,&from,&to);
+ kx_bitmap_stats(emu->regs_usage,from,to,&res->pool[KX_DSP_POOL_GPR]);
+ get_register_pool(emu,GPR_ITRAM,&from,&to);
+ kx_bitmap_stats(emu->regs_usage,from,to,&res->pool[KX_DSP_POOL_ITRAM_REGS]);
+ get_register_pool(emu,GPR_XTRAM,&from,&to);
+ kx_bitmap_stats(emu->regs_usage,from,to,&res->pool[KX_DSP_POOL_XTRAM_REGS]);
+
+ kx_extent_stats(e,get_tram_extents(emu,NULL,0,e),tram_limit(0),16,&res->pool[KX_DSP_POOL_ITRAM]);
+ kx_extent_stats(e,get_tram_extents(emu,NULL,1,e),tram_limit(1),512,&res->pool[KX_DSP_POOL_XTRAM]);
+
+ return 0;
+}
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'do16to32'
 
-char *do16to32_copyright="Copyright (c) Eugene Gavrilov, 2003-2004. All rights reserved";
-char *do16to32_engine="kX";
-char *do16to32_comment="Patents pending";
-char *do16to32_created="05/09/2003";
-char *do16to32_guid="3a5ee31e-9acb-4d57-b0cc-367396ce621f";
+const char *do16to32_copyright="Copyright (c) Eugene Gavrilov, 2003-2004. All rights reserved";
+const char *do16to32_engine="kX";
+const char *do16to32_comment="Patents pending";
+const char *do16to32_created="05/09/2003";
+const char *do16to32_guid="3a5ee31e-9acb-4d57-b0cc-367396ce621f";
 
-char *do16to32_name="16to32";
+const char *do16to32_name="16to32";
 int do16to32_itramsize=0,do16to32_xtramsize=0;
 
 dsp_register_info do16to32_info[]={
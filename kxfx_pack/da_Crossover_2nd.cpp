@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'Crossover 2nd'
 
-char *Crossover_2_copyright="Copyright  Max Mikhailov and Dmitry Kapustin, 2003-2004.";
-char *Crossover_2_engine="3537";
-char *Crossover_2_comment="";
-char *Crossover_2_created="";
-char *Crossover_2_guid="12dcd040-169c-11d8-b0d0-f2dc5a29df10";
+const char *Crossover_2_copyright="Copyright  Max Mikhailov and Dmitry Kapustin, 2003-2004.";
+const char *Crossover_2_engine="3537";
+const char *Crossover_2_comment="";
+const char *Crossover_2_created="";
+const char *Crossover_2_guid="12dcd040-169c-11d8-b0d0-f2dc5a29df10";
 
-char *Crossover_2_name="2nd order crossover";
+const char *Crossover_2_name="2nd order crossover";
 int Crossover_2_itramsize=0,Crossover_2_xtramsize=0;
 
 efx_register_info Crossover_2_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'Crossover 4th'
 
-char *Crossover_4_copyright="Copyright  Max Mikhailov and Dmitry Kapustin, 2003-2004.";
-char *Crossover_4_engine="3537";
-char *Crossover_4_comment="";
-char *Crossover_4_created="";
-char *Crossover_4_guid="8b5a4e20-7642-11d8-b0d0-993aaeed8613";
+const char *Crossover_4_copyright="Copyright  Max Mikhailov and Dmitry Kapustin, 2003-2004.";
+const char *Crossover_4_engine="3537";
+const char *Crossover_4_comment="";
+const char *Crossover_4_created="";
+const char *Crossover_4_guid="8b5a4e20-7642-11d8-b0d0-993aaeed8613";
 
-char *Crossover_4_name="4th order crossover";
+const char *Crossover_4_name="4th order crossover";
 int Crossover_4_itramsize=0,Crossover_4_xtramsize=0;
 
 efx_register_info Crossover_4_info[]={
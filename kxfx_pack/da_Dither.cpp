@@ -19,18 +19,18 @@
 // 10kX microcode
 // Patch name: 'Dither'
 
-char *Dither_copyright="JoshuaChang, 2002-2004";
+const char *Dither_copyright="JoshuaChang, 2002-2004";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *Dither_engine="Emu10kX";
-char *Dither_comment="Simple Dither System for Loopback Recording & Analog Output @ 48kHz";
-char *Dither_created="July 22 2004";
-char *Dither_guid="23e00a6e-6646-47e7-877d-0a3beb7bc7d8";
+const char *Dither_engine="Emu10kX";
+const char *Dither_comment="Simple Dither System for Loopback Recording & Analog Output @ 48kHz";
+const char *Dither_created="July 22 2004";
+const char *Dither_guid="23e00a6e-6646-47e7-877d-0a3beb7bc7d8";
 
-char *Dither_name="Dither";
+const char *Dither_name="Dither";
 int Dither_itramsize=0,Dither_xtramsize=0;
 
 dsp_register_info Dither_info[]={
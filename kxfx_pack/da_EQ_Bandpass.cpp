@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'EQ_Bandpass'
 
-char *EQ_Bandpass_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *EQ_Bandpass_engine="kX";
-char *EQ_Bandpass_comment="Bandpass Filter";
-char *EQ_Bandpass_created="2002/05/14";
-char *EQ_Bandpass_guid="6dc235cf-4155-4885-b010-5a91ef76a249";
+const char *EQ_Bandpass_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *EQ_Bandpass_engine="kX";
+const char *EQ_Bandpass_comment="Bandpass Filter";
+const char *EQ_Bandpass_created="2002/05/14";
+const char *EQ_Bandpass_guid="6dc235cf-4155-4885-b010-5a91ef76a249";
 
-char *EQ_Bandpass_name="EQ Bandpass";
+const char *EQ_Bandpass_name="EQ Bandpass";
 int EQ_Bandpass_itramsize=0,EQ_Bandpass_xtramsize=0;
 
 #define R_B0	0x8002
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'EQ_Highpass'
 
-char *EQ_Highpass_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *EQ_Highpass_engine="kX";
-char *EQ_Highpass_comment="HighPass Filter";
-char *EQ_Highpass_created="2002/05/14";
-char *EQ_Highpass_guid="b9c879c8-e95e-4463-a470-41348f475d59";
+const char *EQ_Highpass_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *EQ_Highpass_engine="kX";
+const char *EQ_Highpass_comment="HighPass Filter";
+const char *EQ_Highpass_created="2002/05/14";
+const char *EQ_Highpass_guid="b9c879c8-e95e-4463-a470-41348f475d59";
 
-char *EQ_Highpass_name="EQ Highpass";
+const char *EQ_Highpass_name="EQ Highpass";
 int EQ_Highpass_itramsize=0,EQ_Highpass_xtramsize=0;
 
 #define R_B0	0x8002
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'EQ_Highshelf'
 
-char *EQ_Highshelf_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *EQ_Highshelf_engine="kX";
-char *EQ_Highshelf_comment="High Shelf Equalizer";
-char *EQ_Highshelf_created="2002/05/14";
-char *EQ_Highshelf_guid="928f4f40-2909-44d8-88ea-570bc6a12a15";
+const char *EQ_Highshelf_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *EQ_Highshelf_engine="kX";
+const char *EQ_Highshelf_comment="High Shelf Equalizer";
+const char *EQ_Highshelf_created="2002/05/14";
+const char *EQ_Highshelf_guid="928f4f40-2909-44d8-88ea-570bc6a12a15";
 
-char *EQ_Highshelf_name="EQ Highshelf";
+const char *EQ_Highshelf_name="EQ Highshelf";
 int EQ_Highshelf_itramsize=0,EQ_Highshelf_xtramsize=0;
 
 #define R_B0	0x8002
@@ -21,15 +21,15 @@
 // 10kX microcode
 // Patch name: 'EQ_Lowpass'
 
-char *EQ_Lowpass_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *EQ_Lowpass_engine="kX";
-char *EQ_Lowpass_comment="Lowpass Filter";
-char *EQ_Lowpass_created="2002/05/14";
+const char *EQ_Lowpass_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *EQ_Lowpass_engine="kX";
+const char *EQ_Lowpass_comment="Lowpass Filter";
+const char *EQ_Lowpass_created="2002/05/14";
 
 //char *EQ_Lowpass_guid="f2f86011-2b66-4769-9637-3c5fcaf4b7c5";
-char *EQ_Lowpass_guid="bfd8a72a-58ae-453a-ab80-34c9a3c62a5d";
+const char *EQ_Lowpass_guid="bfd8a72a-58ae-453a-ab80-34c9a3c62a5d";
 
-char *EQ_Lowpass_name="EQ Lowpass";
+const char *EQ_Lowpass_name="EQ Lowpass";
 int EQ_Lowpass_itramsize=0,EQ_Lowpass_xtramsize=0;
 
 #define R_B0	0x8002
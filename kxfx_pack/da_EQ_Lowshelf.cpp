@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'EQ_Lowshelf'
 
-char *EQ_Lowshelf_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *EQ_Lowshelf_engine="kX";
-char *EQ_Lowshelf_comment="Low Shelf Equalizer";
-char *EQ_Lowshelf_created="2002/05/14";
-char *EQ_Lowshelf_guid="70d21f6a-37e6-41f7-8dc3-b69162f10cba";
+const char *EQ_Lowshelf_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *EQ_Lowshelf_engine="kX";
+const char *EQ_Lowshelf_comment="Low Shelf Equalizer";
+const char *EQ_Lowshelf_created="2002/05/14";
+const char *EQ_Lowshelf_guid="70d21f6a-37e6-41f7-8dc3-b69162f10cba";
 
-char *EQ_Lowshelf_name="EQ Lowshelf";
+const char *EQ_Lowshelf_name="EQ Lowshelf";
 int EQ_Lowshelf_itramsize=0,EQ_Lowshelf_xtramsize=0;
 
 #define R_B0	0x8002
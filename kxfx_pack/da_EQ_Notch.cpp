@@ -22,13 +22,13 @@
 // 10kX microcode
 // Patch name: 'EQ_Notch'
 
-char *EQ_Notch_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *EQ_Notch_engine="kX";
-char *EQ_Notch_comment="Notch Filter";
-char *EQ_Notch_created="2002/05/14";
-char *EQ_Notch_guid="7b42d5c9-5ae3-47c0-9342-452e38c84408";
+const char *EQ_Notch_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *EQ_Notch_engine="kX";
+const char *EQ_Notch_comment="Notch Filter";
+const char *EQ_Notch_created="2002/05/14";
+const char *EQ_Notch_guid="7b42d5c9-5ae3-47c0-9342-452e38c84408";
 
-char *EQ_Notch_name="EQ Notch";
+const char *EQ_Notch_name="EQ Notch";
 int EQ_Notch_itramsize=0,EQ_Notch_xtramsize=0;
 
 #define R_B0	0x8002
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'EQ_Peaking'
 
-char *EQ_Peaking_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *EQ_Peaking_engine="kX";
-char *EQ_Peaking_comment="Peaking Equalizer";
-char *EQ_Peaking_created="2002/05/14";
-char *EQ_Peaking_guid="7b0797d1-f131-4a21-b6e3-eca250d751fc";
+const char *EQ_Peaking_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *EQ_Peaking_engine="kX";
+const char *EQ_Peaking_comment="Peaking Equalizer";
+const char *EQ_Peaking_created="2002/05/14";
+const char *EQ_Peaking_guid="7b0797d1-f131-4a21-b6e3-eca250d751fc";
 
-char *EQ_Peaking_name="EQ Peaking";
+const char *EQ_Peaking_name="EQ Peaking";
 int EQ_Peaking_itramsize=0,EQ_Peaking_xtramsize=0;
 
 #define R_B0	0x8002
@@ -19,18 +19,18 @@
 // 10kX microcode
 // Patch name: 'Feedback Destroyer 1.2'
 
-char *Feedback_Destroyer_copyright="Copyright (c) 2004.";
+const char *Feedback_Destroyer_copyright="Copyright (c) 2004.";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *Feedback_Destroyer_engine="kX";
-char *Feedback_Destroyer_comment="v 1.2";
-char *Feedback_Destroyer_created="03/05/2005";
-char *Feedback_Destroyer_guid="d78d06ad-8c71-419b-8ff7-3c00b1b4860f";
+const char *Feedback_Destroyer_engine="kX";
+const char *Feedback_Destroyer_comment="v 1.2";
+const char *Feedback_Destroyer_created="03/05/2005";
+const char *Feedback_Destroyer_guid="d78d06ad-8c71-419b-8ff7-3c00b1b4860f";
 
-char *Feedback_Destroyer_name="Feedback Destroyer 1.2";
+const char *Feedback_Destroyer_name="Feedback Destroyer 1.2";
 int Feedback_Destroyer_itramsize=0,Feedback_Destroyer_xtramsize=0;
 
 dsp_register_info Feedback_Destroyer_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'EQ_Highshelf'
 
-char *Freq_Splitter_copyright="(c) Soeren Bovbjerg, 2002";
-char *Freq_Splitter_engine="kX";
-char *Freq_Splitter_comment="Frequency splitter";
-char *Freq_Splitter_created="2002/06/30";
-char *Freq_Splitter_guid="e4e2da89-23d4-4b6a-8238-4315035e1dde";
+const char *Freq_Splitter_copyright="(c) Soeren Bovbjerg, 2002";
+const char *Freq_Splitter_engine="kX";
+const char *Freq_Splitter_comment="Frequency splitter";
+const char *Freq_Splitter_created="2002/06/30";
+const char *Freq_Splitter_guid="e4e2da89-23d4-4b6a-8238-4315035e1dde";
 
-char *Freq_Splitter_name="Freq Splitter";
+const char *Freq_Splitter_name="Freq Splitter";
 int Freq_Splitter_itramsize=0,Freq_Splitter_xtramsize=0;
 
 #define R_HB0	0x8002
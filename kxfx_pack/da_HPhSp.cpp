@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'hphsp'
 
-char *hphsp_copyright="Copyright 1999 E-mu Systems/Creative Technology, Ltd. Default parameters and Dane Source (c) Eugene Gavrilov, 2003-2004";
-char *hphsp_engine="EMU10K1_A0";
-char *hphsp_comment="You should have the original Creative Labs .DLL in order to use this effect legally";
-char *hphsp_created="Mon Jan 06 14:30:48 2003 ";
-char *hphsp_guid="00b1c997-3f21-4e1d-b7cb-dad5a0d3dce8";
+const char *hphsp_copyright="Copyright 1999 E-mu Systems/Creative Technology, Ltd. Default parameters and Dane Source (c) Eugene Gavrilov, 2003-2004";
+const char *hphsp_engine="EMU10K1_A0";
+const char *hphsp_comment="You should have the original Creative Labs .DLL in order to use this effect legally";
+const char *hphsp_created="Mon Jan 06 14:30:48 2003 ";
+const char *hphsp_guid="00b1c997-3f21-4e1d-b7cb-dad5a0d3dce8";
 
-char *hphsp_name="HPhSp";
+const char *hphsp_name="HPhSp";
 int hphsp_itramsize=140,hphsp_xtramsize=0;
 
 dsp_register_info hphsp_info[]={
@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'HarmonicsGen'
 
-char *HarmonicsGen_copyright="Copyright (c) 2005. Tril";
+const char *HarmonicsGen_copyright="Copyright (c) 2005. Tril";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *HarmonicsGen_engine="kX";
-char *HarmonicsGen_comment="";
-char *HarmonicsGen_created="11/24/2005";
-char *HarmonicsGen_guid="251a33a7-412d-4ee4-a8b6-c6503c1bd23b";
+const char *HarmonicsGen_engine="kX";
+const char *HarmonicsGen_comment="";
+const char *HarmonicsGen_created="11/24/2005";
+const char *HarmonicsGen_guid="251a33a7-412d-4ee4-a8b6-c6503c1bd23b";
 
-char *HarmonicsGen_name="HarmonicsGen";
+const char *HarmonicsGen_name="HarmonicsGen";
 int HarmonicsGen_itramsize=0,HarmonicsGen_xtramsize=0;
 
 dsp_register_info HarmonicsGen_info[]={
@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'Leslie Horn'
 
-char *Leslie_Horn_copyright="";
+const char *Leslie_Horn_copyright="";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *Leslie_Horn_engine="";
-char *Leslie_Horn_comment="Simulate Leslie Horn";
-char *Leslie_Horn_created="";
-char *Leslie_Horn_guid="02a2a5d2-8e28-4068-82b7-d0809d34ef73";
+const char *Leslie_Horn_engine="";
+const char *Leslie_Horn_comment="Simulate Leslie Horn";
+const char *Leslie_Horn_created="";
+const char *Leslie_Horn_guid="02a2a5d2-8e28-4068-82b7-d0809d34ef73";
 
-char *Leslie_Horn_name="Leslie Horn";
+const char *Leslie_Horn_name="Leslie Horn";
 int Leslie_Horn_itramsize=240,Leslie_Horn_xtramsize=0;
 
 dsp_register_info Leslie_Horn_info[]={
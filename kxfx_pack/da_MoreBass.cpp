@@ -20,18 +20,18 @@
  */
 
 
-char *MoreBass_copyright="Copyright (c) 2006. Tril";
+const char *MoreBass_copyright="Copyright (c) 2006. Tril";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *MoreBass_engine="kX";
-char *MoreBass_comment="";
-char *MoreBass_created="03/03/2006";
-char *MoreBass_guid="7badd2cf-5b8c-4c49-a647-e659c0d3d4d9";
+const char *MoreBass_engine="kX";
+const char *MoreBass_comment="";
+const char *MoreBass_created="03/03/2006";
+const char *MoreBass_guid="7badd2cf-5b8c-4c49-a647-e659c0d3d4d9";
 
-char *MoreBass_name="MoreBass";
+const char *MoreBass_name="MoreBass";
 int MoreBass_itramsize=0,MoreBass_xtramsize=0;
 
 dsp_register_info MoreBass_info[]={
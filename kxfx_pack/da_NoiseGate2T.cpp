@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'Noise Gate 2T'
 
-char *NoiseGate2T_copyright="Copyright (c) 2004 Eugeniy Sokol. All rights reserved";
-char *NoiseGate2T_engine="kX";
-char *NoiseGate2T_comment="";
-char *NoiseGate2T_created="01/23/2004";
-char *NoiseGate2T_guid="6b74d1e4-f8b0-4c40-b867-c82bf42ab8c5";
+const char *NoiseGate2T_copyright="Copyright (c) 2004 Eugeniy Sokol. All rights reserved";
+const char *NoiseGate2T_engine="kX";
+const char *NoiseGate2T_comment="";
+const char *NoiseGate2T_created="01/23/2004";
+const char *NoiseGate2T_guid="6b74d1e4-f8b0-4c40-b867-c82bf42ab8c5";
 
-char *NoiseGate2T_name="Noise Gate 2T";
+const char *NoiseGate2T_name="Noise Gate 2T";
 int NoiseGate2T_itramsize=0,NoiseGate2T_xtramsize=0;
 
 dsp_register_info NoiseGate2T_info[]={
@@ -23,13 +23,13 @@
 // 10kX microcode
 // Patch name: 'Noise Gate 2Ts'
 
-char *NoiseGate2Ts_copyright="Copyright (c) 2004 Eugeniy Sokol. All rights reserved";
-char *NoiseGate2Ts_engine="kX";
-char *NoiseGate2Ts_comment="";
-char *NoiseGate2Ts_created="01/23/2004";
-char *NoiseGate2Ts_guid="7065d870-c198-4304-84ae-d9aecdbd857b";
+const char *NoiseGate2Ts_copyright="Copyright (c) 2004 Eugeniy Sokol. All rights reserved";
+const char *NoiseGate2Ts_engine="kX";
+const char *NoiseGate2Ts_comment="";
+const char *NoiseGate2Ts_created="01/23/2004";
+const char *NoiseGate2Ts_guid="7065d870-c198-4304-84ae-d9aecdbd857b";
 
-char *NoiseGate2Ts_name="Noise Gate 2Ts";
+const char *NoiseGate2Ts_name="Noise Gate 2Ts";
 int NoiseGate2Ts_itramsize=0,NoiseGate2Ts_xtramsize=0;
 
 dsp_register_info NoiseGate2Ts_info[]={
@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'Phaser'
 
-char *Phaser_copyright="Copyright (c) Russ, 2005";
+const char *Phaser_copyright="Copyright (c) Russ, 2005";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *Phaser_engine="kX 3538i";
-char *Phaser_comment="Phaser v2.0";
-char *Phaser_created="08/03/2005";
-char *Phaser_guid="ab0284b2-3caf-4850-84ca-6eb772cd68a4";
+const char *Phaser_engine="kX 3538i";
+const char *Phaser_comment="Phaser v2.0";
+const char *Phaser_created="08/03/2005";
+const char *Phaser_guid="ab0284b2-3caf-4850-84ca-6eb772cd68a4";
 
-char *Phaser_name="Phaser";
+const char *Phaser_name="Phaser";
 int Phaser_itramsize=0,Phaser_xtramsize=0;
 
 dsp_register_info Phaser_info[]={
@@ -21,14 +21,14 @@
 // 10kX microcode
 // Patch name: 'Phat_EQ_Mono'
 
-char *Phat_EQ_Mono_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *Phat_EQ_Mono_engine="kX";
-char *Phat_EQ_Mono_comment="Powerfull resonant filter! Warning :-)\nNo overload protection! Use input gain to compensate";
+const char *Phat_EQ_Mono_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *Phat_EQ_Mono_engine="kX";
+const char *Phat_EQ_Mono_comment="Powerfull resonant filter! Warning :-)\nNo overload protection! Use input gain to compensate";
 							  
-char *Phat_EQ_Mono_created="2002/07/23";
-char *Phat_EQ_Mono_guid="4f279d7b-d1b8-4937-84aa-516a2d72c625";
+const char *Phat_EQ_Mono_created="2002/07/23";
+const char *Phat_EQ_Mono_guid="4f279d7b-d1b8-4937-84aa-516a2d72c625";
 
-char *Phat_EQ_Mono_name="Phat EQ Mono";
+const char *Phat_EQ_Mono_name="Phat EQ Mono";
 int Phat_EQ_Mono_itramsize=0,Phat_EQ_Mono_xtramsize=0;
 
 #define R_B0	0x8001
@@ -21,14 +21,14 @@
 // 10kX microcode
 // Patch name: 'Phat_EQ_Stereo'
 
-char *Phat_EQ_Stereo_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *Phat_EQ_Stereo_engine="kX";
-char *Phat_EQ_Stereo_comment="Powerfull resonant filter! Warning :-)\nNo overload protection! Use input gain to compensate";
+const char *Phat_EQ_Stereo_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *Phat_EQ_Stereo_engine="kX";
+const char *Phat_EQ_Stereo_comment="Powerfull resonant filter! Warning :-)\nNo overload protection! Use input gain to compensate";
 							  
-char *Phat_EQ_Stereo_created="2002/07/23";
-char *Phat_EQ_Stereo_guid="5fbec50d-a132-4ed3-9c87-316c7ac8724b";
+const char *Phat_EQ_Stereo_created="2002/07/23";
+const char *Phat_EQ_Stereo_guid="5fbec50d-a132-4ed3-9c87-316c7ac8724b";
 
-char *Phat_EQ_Stereo_name="Phat EQ Stereo";
+const char *Phat_EQ_Stereo_name="Phat EQ Stereo";
 int Phat_EQ_Stereo_itramsize=0,Phat_EQ_Stereo_xtramsize=0;
 
 #define R_B0	0x8002
@@ -25,13 +25,13 @@
 // FIXME: do we need 'bottom' input, too?.. [depends on kernel-part]
 // -----
 
-char *pos3dfx_copyright="Copyright (c) Eugene Gavrilov, 2003-2004. All rights reserved";
-char *pos3dfx_engine="kX";
-char *pos3dfx_comment="3-D positioned Stereo + 8.1chn sound + 8.1chn reverb";
-char *pos3dfx_created="09/19/2003";
-char *pos3dfx_guid="a5d3d288-c35e-4aa2-b295-2cb7d3d86ed4";
+const char *pos3dfx_copyright="Copyright (c) Eugene Gavrilov, 2003-2004. All rights reserved";
+const char *pos3dfx_engine="kX";
+const char *pos3dfx_comment="3-D positioned Stereo + 8.1chn sound + 8.1chn reverb";
+const char *pos3dfx_created="09/19/2003";
+const char *pos3dfx_guid="a5d3d288-c35e-4aa2-b295-2cb7d3d86ed4";
 
-char *pos3dfx_name="Pos3DFX";
+const char *pos3dfx_name="Pos3DFX";
 int pos3dfx_itramsize=0,pos3dfx_xtramsize=0;
 
 dsp_register_info pos3dfx_info[]={
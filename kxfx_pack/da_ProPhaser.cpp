@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'ProPhaser'
 
-char *ProPhaser_copyright=" Max Mikhailov, 2001-2006";
+const char *ProPhaser_copyright=" Max Mikhailov, 2001-2006";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *ProPhaser_engine="What does this field mean?";
-char *ProPhaser_comment="Phaser. To the ladies i've ever loved...";
-char *ProPhaser_created="May 9 2004";
-char *ProPhaser_guid="D8DC1380-1122-8904-960F-44E461F818D0";
+const char *ProPhaser_engine="What does this field mean?";
+const char *ProPhaser_comment="Phaser. To the ladies i've ever loved...";
+const char *ProPhaser_created="May 9 2004";
+const char *ProPhaser_guid="D8DC1380-1122-8904-960F-44E461F818D0";
 
-char *ProPhaser_name="ProPhaser";
+const char *ProPhaser_name="ProPhaser";
 int ProPhaser_itramsize=0,ProPhaser_xtramsize=0;
 
 dsp_register_info ProPhaser_info[]={
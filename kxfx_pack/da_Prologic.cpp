@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'Prologic'
 
-char *Prologic_copyright="Copyright (c) 2004.";
+const char *Prologic_copyright="Copyright (c) 2004.";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *Prologic_engine="kX";
-char *Prologic_comment="Dolby Prologic encoder";
-char *Prologic_created="12/17/2007";
-char *Prologic_guid="c3cbd3ac-b3bc-4022-b18d-5b157b305838";
+const char *Prologic_engine="kX";
+const char *Prologic_comment="Dolby Prologic encoder";
+const char *Prologic_created="12/17/2007";
+const char *Prologic_guid="c3cbd3ac-b3bc-4022-b18d-5b157b305838";
 
-char *Prologic_name="Dolby Prologic";
+const char *Prologic_name="Dolby Prologic";
 int Prologic_itramsize=0,Prologic_xtramsize=0;
 
 dsp_register_info Prologic_info[]={
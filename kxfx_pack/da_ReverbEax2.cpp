@@ -24,18 +24,18 @@
 // 10kX microcode
 // Patch name: 'ReverbEax2'
 
-char *ReverbEax2_copyright="Copyright 2000 E-mu Systems/Creative Technology, Ltd.  Presets added for kX by Russ 2008";
+const char *ReverbEax2_copyright="Copyright 2000 E-mu Systems/Creative Technology, Ltd.  Presets added for kX by Russ 2008";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *ReverbEax2_engine="kX";
-char *ReverbEax2_comment="You should have original Creative Labs .DLL in order to use this effect legally; $nobypass";
-char *ReverbEax2_created="Thu Aug 28 16:26:01 2003 ";
-char *ReverbEax2_guid="ebe0f788-3d69-4a9e-ac88-1e3d5a37c7c6";
+const char *ReverbEax2_engine="kX";
+const char *ReverbEax2_comment="You should have original Creative Labs .DLL in order to use this effect legally; $nobypass";
+const char *ReverbEax2_created="Thu Aug 28 16:26:01 2003 ";
+const char *ReverbEax2_guid="ebe0f788-3d69-4a9e-ac88-1e3d5a37c7c6";
 
-char *ReverbEax2_name="CLEAX2Reverb";
+const char *ReverbEax2_name="CLEAX2Reverb";
 int ReverbEax2_itramsize=3760,ReverbEax2_xtramsize=78154;
 
 dsp_register_info ReverbEax2_info[]={
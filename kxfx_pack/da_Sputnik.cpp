@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'Sputnik'
 
-char *Sputnik_copyright=" Max Mikhailov, 2001-2006";
+const char *Sputnik_copyright=" Max Mikhailov, 2001-2006";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *Sputnik_engine="Oops";
-char *Sputnik_comment="Unusual vibrato...";
-char *Sputnik_created="August 23 2006";
-char *Sputnik_guid="84B75746-50A1-47df-B100-17AB91BD4606";
+const char *Sputnik_engine="Oops";
+const char *Sputnik_comment="Unusual vibrato...";
+const char *Sputnik_created="August 23 2006";
+const char *Sputnik_guid="84B75746-50A1-47df-B100-17AB91BD4606";
 
-char *Sputnik_name="Sputnik";
+const char *Sputnik_name="Sputnik";
 int Sputnik_itramsize=404,Sputnik_xtramsize=0;
 
 dsp_register_info Sputnik_info[]={
@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'TheDelay'
 
-char *TheDelay_copyright="Copyright (c) 2007. Tril";
+const char *TheDelay_copyright="Copyright (c) 2007. Tril";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *TheDelay_engine="kX";
-char *TheDelay_comment="Can delay a signal from 25 to 24000 samples.";
-char *TheDelay_created="02/24/2007";
-char *TheDelay_guid="f83701f0-59bd-4677-8de4-2c974be925bf";
+const char *TheDelay_engine="kX";
+const char *TheDelay_comment="Can delay a signal from 25 to 24000 samples.";
+const char *TheDelay_created="02/24/2007";
+const char *TheDelay_guid="f83701f0-59bd-4677-8de4-2c974be925bf";
 
-char *TheDelay_name="TheDelay";
+const char *TheDelay_name="TheDelay";
 int TheDelay_itramsize=0,TheDelay_xtramsize=24000;
 
 dsp_register_info TheDelay_info[]={
@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'TheSmallDelay'
 
-char *TheSmallDelay_copyright="Copyright (c) 2007. Tril";
+const char *TheSmallDelay_copyright="Copyright (c) 2007. Tril";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *TheSmallDelay_engine="kX";
-char *TheSmallDelay_comment="Can delay a signal from 0.02ms to 25 ms.";
-char *TheSmallDelay_created="02/24/2007";
-char *TheSmallDelay_guid="1e8ca177-74eb-4842-901c-7d93265836e9";
+const char *TheSmallDelay_engine="kX";
+const char *TheSmallDelay_comment="Can delay a signal from 0.02ms to 25 ms.";
+const char *TheSmallDelay_created="02/24/2007";
+const char *TheSmallDelay_guid="1e8ca177-74eb-4842-901c-7d93265836e9";
 
-char *TheSmallDelay_name="TheSmallDelay";
+const char *TheSmallDelay_name="TheSmallDelay";
 int TheSmallDelay_itramsize=1200,TheSmallDelay_xtramsize=0;
 
 dsp_register_info TheSmallDelay_info[]={
@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'TimeBalanceV2'
 
-char *TimeBalanceV2_copyright="Copyright (c) 2007. Tril";
+const char *TimeBalanceV2_copyright="Copyright (c) 2007. Tril";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *TimeBalanceV2_engine="kX";
-char *TimeBalanceV2_comment="Ajusts delays to five speakers";
-char *TimeBalanceV2_created="02/23/2007";
-char *TimeBalanceV2_guid="02522ae9-a39e-4548-b2d8-9623364767cc";
+const char *TimeBalanceV2_engine="kX";
+const char *TimeBalanceV2_comment="Ajusts delays to five speakers";
+const char *TimeBalanceV2_created="02/23/2007";
+const char *TimeBalanceV2_guid="02522ae9-a39e-4548-b2d8-9623364767cc";
 
-char *TimeBalanceV2_name="TimeBalanceV2";
+const char *TimeBalanceV2_name="TimeBalanceV2";
 int TimeBalanceV2_itramsize=4190,TimeBalanceV2_xtramsize=0;
 
 dsp_register_info TimeBalanceV2_info[]={
@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'Wibrato'
 
-char *Wibrato_copyright=" Max Mikhailov, 2001-2006";
+const char *Wibrato_copyright=" Max Mikhailov, 2001-2006";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *Wibrato_engine="Who's modulating there, eh?";
-char *Wibrato_comment="Retriggering vibrato.";
-char *Wibrato_created="August 24 2006";
-char *Wibrato_guid="7013B431-AFE1-40b3-AA3F-B49AB0877FBE";
+const char *Wibrato_engine="Who's modulating there, eh?";
+const char *Wibrato_comment="Retriggering vibrato.";
+const char *Wibrato_created="August 24 2006";
+const char *Wibrato_guid="7013B431-AFE1-40b3-AA3F-B49AB0877FBE";
 
-char *Wibrato_name="Wibrato";
+const char *Wibrato_name="Wibrato";
 int Wibrato_itramsize=204,Wibrato_xtramsize=0;
 
 dsp_register_info Wibrato_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'ac3passthrough'
 
-char *ac3passthrough_copyright="Copyright (c) 2002-2004, kX Project.";
-char *ac3passthrough_engine="kX";
-char *ac3passthrough_comment="v2.0; includes x4";
-char *ac3passthrough_created="10/08/2002";
-char *ac3passthrough_guid="9812dce7-5738-48aa-b700-927caec84053";
+const char *ac3passthrough_copyright="Copyright (c) 2002-2004, kX Project.";
+const char *ac3passthrough_engine="kX";
+const char *ac3passthrough_comment="v2.0; includes x4";
+const char *ac3passthrough_created="10/08/2002";
+const char *ac3passthrough_guid="9812dce7-5738-48aa-b700-927caec84053";
 
-char *ac3passthrough_name="ac3passthrough";
+const char *ac3passthrough_name="ac3passthrough";
 int ac3passthrough_itramsize=0,ac3passthrough_xtramsize=0;
 
 dsp_register_info ac3passthrough_info[]={
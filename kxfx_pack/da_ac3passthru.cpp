@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'ac3passthru'
 
-char *ac3passthru_copyright="Copyright (c) Eugene Gavrilov, 2003-2004.";
-char *ac3passthru_engine="kX";
-char *ac3passthru_comment="v2.0; includes x4";
-char *ac3passthru_created="05/11/2003";
-char *ac3passthru_guid="459fd76d-a110-438e-908f-fcd1872d5a06";
+const char *ac3passthru_copyright="Copyright (c) Eugene Gavrilov, 2003-2004.";
+const char *ac3passthru_engine="kX";
+const char *ac3passthru_comment="v2.0; includes x4";
+const char *ac3passthru_created="05/11/2003";
+const char *ac3passthru_guid="459fd76d-a110-438e-908f-fcd1872d5a06";
 
-char *ac3passthru_name="ac3passthru_old";
+const char *ac3passthru_name="ac3passthru_old";
 int ac3passthru_itramsize=0,ac3passthru_xtramsize=0;
 
 dsp_register_info ac3passthru_info[]={ 
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'ac3passthru_x'
 
-char *ac3passthru_x_copyright="Copyright (c) Eugene Gavrilov and Max Mikhailov, 2004. All rights reserved";
-char *ac3passthru_x_engine="kX";
-char *ac3passthru_x_comment="";
-char *ac3passthru_x_created="01/06/2004";
-char *ac3passthru_x_guid="64824522-f847-4bca-ac45-7a58c321d4e3";
+const char *ac3passthru_x_copyright="Copyright (c) Eugene Gavrilov and Max Mikhailov, 2004. All rights reserved";
+const char *ac3passthru_x_engine="kX";
+const char *ac3passthru_x_comment="";
+const char *ac3passthru_x_created="01/06/2004";
+const char *ac3passthru_x_guid="64824522-f847-4bca-ac45-7a58c321d4e3";
 
-char *ac3passthru_x_name="ac3passthru_x";
+const char *ac3passthru_x_name="ac3passthru_x";
 int ac3passthru_x_itramsize=0,ac3passthru_x_xtramsize=6144;
 
 dsp_register_info ac3passthru_x_info[]={
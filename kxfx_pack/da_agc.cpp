@@ -19,18 +19,18 @@
 // 10kX microcode
 // Patch name: 'agc'
 
-char *agc_copyright="eyagos - Copyright (c) 2005.";
+const char *agc_copyright="eyagos - Copyright (c) 2005.";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *agc_engine="kX";
-char *agc_comment="";
-char *agc_created="03/13/2005";
-char *agc_guid="1b63e04c-6f88-4d03-afca-e86887cc6a23";
+const char *agc_engine="kX";
+const char *agc_comment="";
+const char *agc_created="03/13/2005";
+const char *agc_guid="1b63e04c-6f88-4d03-afca-e86887cc6a23";
 
-char *agc_name="agc";
+const char *agc_name="agc";
 int agc_itramsize=0,agc_xtramsize=0;
 
 dsp_register_info agc_info[]={
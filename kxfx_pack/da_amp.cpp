@@ -23,13 +23,13 @@
 // 10kX microcode
 // Patch name: 'amp'
 
-char *amp_copyright="by eYagos - Copyright (c) 2003-2004.";
-char *amp_engine="kX";
-char *amp_comment="Amplifies the signal without looses ";
-char *amp_created="02/14/2003";
-char *amp_guid="d7e58d27-eb7f-4cde-84fc-a4a238fc1025";
+const char *amp_copyright="by eYagos - Copyright (c) 2003-2004.";
+const char *amp_engine="kX";
+const char *amp_comment="Amplifies the signal without looses ";
+const char *amp_created="02/14/2003";
+const char *amp_guid="d7e58d27-eb7f-4cde-84fc-a4a238fc1025";
 
-char *amp_name="gainHQ";
+const char *amp_name="gainHQ";
 int amp_itramsize=0,amp_xtramsize=0;
 
 #define R_GAINL_I	0x8002
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'apscomp'
 
-char *apscomp_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
-char *apscomp_engine="EMU10K1_A0";
-char *apscomp_comment="APS Diet Compressor, DLLed by Hanz Petrov, Oct 2002";
-char *apscomp_created="Fri Jul 13 12:59:04 2001 ";
-char *apscomp_guid="441a09a2-3d0b-11d6-a4c7-8fae6d701845";
+const char *apscomp_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
+const char *apscomp_engine="EMU10K1_A0";
+const char *apscomp_comment="APS Diet Compressor, DLLed by Hanz Petrov, Oct 2002";
+const char *apscomp_created="Fri Jul 13 12:59:04 2001 ";
+const char *apscomp_guid="441a09a2-3d0b-11d6-a4c7-8fae6d701845";
 
-char *apscomp_name="APS Compressor";
+const char *apscomp_name="APS Compressor";
 int apscomp_itramsize=400,apscomp_xtramsize=0;
 
 dsp_register_info apscomp_info[]={
@@ -24,13 +24,13 @@
 // 10kX microcode
 // Patch name: 'apscomp_sc'
 
-char *apscomp_sc_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
-char *apscomp_sc_engine="EMU10K1_A0";
-char *apscomp_sc_comment="APS Diet Compressor, DLLed by Hanz Petrov, Oct 2002\nSide Chain option added by Soeren Bovbjerg";
-char *apscomp_sc_created="Fri Jul 13 12:59:04 2001 / Sep'03 ";
-char *apscomp_sc_guid="a3dd55eb-490d-44da-9f8d-067fa18a1ea2";
+const char *apscomp_sc_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
+const char *apscomp_sc_engine="EMU10K1_A0";
+const char *apscomp_sc_comment="APS Diet Compressor, DLLed by Hanz Petrov, Oct 2002\nSide Chain option added by Soeren Bovbjerg";
+const char *apscomp_sc_created="Fri Jul 13 12:59:04 2001 / Sep'03 ";
+const char *apscomp_sc_guid="a3dd55eb-490d-44da-9f8d-067fa18a1ea2";
 
-char *apscomp_sc_name="APS Compressor+";
+const char *apscomp_sc_name="APS Compressor+";
 int apscomp_sc_itramsize=400,apscomp_sc_xtramsize=0;
 
 dsp_register_info apscomp_sc_info[]={
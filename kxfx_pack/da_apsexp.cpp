@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'apsexp'
 
-char *apsexp_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
-char *apsexp_engine="EMU10K1_A0";
-char *apsexp_comment="Expander by eYagos (based on the APS Diet Compressor)";
-char *apsexp_created="11/01/2003 ";
-char *apsexp_guid="141a09a2-3d0b-11d6-a4c7-8fae6d701847";
+const char *apsexp_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
+const char *apsexp_engine="EMU10K1_A0";
+const char *apsexp_comment="Expander by eYagos (based on the APS Diet Compressor)";
+const char *apsexp_created="11/01/2003 ";
+const char *apsexp_guid="141a09a2-3d0b-11d6-a4c7-8fae6d701847";
 
-char *apsexp_name="APS Expander";
+const char *apsexp_name="APS Expander";
 int apsexp_itramsize=400,apsexp_xtramsize=0;
 
 #ifndef KX_INTERNAL
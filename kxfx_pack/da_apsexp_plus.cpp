@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'apsexp_plus'
 
-char *apsexp_plus_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
-char *apsexp_plus_engine="EMU10K1_A0";
-char *apsexp_plus_comment="Expander by eYagos (based on the APS Diet Compressor)";
-char *apsexp_plus_created="11/01/2003 ";
-char *apsexp_plus_guid="141a09a2-3d0b-11d6-a4c7-8fae6d701846";
+const char *apsexp_plus_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
+const char *apsexp_plus_engine="EMU10K1_A0";
+const char *apsexp_plus_comment="Expander by eYagos (based on the APS Diet Compressor)";
+const char *apsexp_plus_created="11/01/2003 ";
+const char *apsexp_plus_guid="141a09a2-3d0b-11d6-a4c7-8fae6d701846";
 
-char *apsexp_plus_name="APS Expander +";
+const char *apsexp_plus_name="APS Expander +";
 int apsexp_plus_itramsize=400,apsexp_plus_xtramsize=0;
 
 #ifndef KX_INTERNAL
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'APS Fuzz'
 
-char *apsfuzz_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
-char *apsfuzz_engine="EMU10K1_A0";
-char *apsfuzz_comment="APS Fuzz, DLLed by Hanz, Apr 25 2002";
-char *apsfuzz_created="Fri Jul 13 12:59:03 2001 ";
-char *apsfuzz_guid="0fc51a60-4cdc-11d6-a4c7-bc36166a1e45";
+const char *apsfuzz_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
+const char *apsfuzz_engine="EMU10K1_A0";
+const char *apsfuzz_comment="APS Fuzz, DLLed by Hanz, Apr 25 2002";
+const char *apsfuzz_created="Fri Jul 13 12:59:03 2001 ";
+const char *apsfuzz_guid="0fc51a60-4cdc-11d6-a4c7-bc36166a1e45";
 
-char *apsfuzz_name="APS Fuzz";
+const char *apsfuzz_name="APS Fuzz";
 int apsfuzz_itramsize=0,apsfuzz_xtramsize=0;
 
 dsp_register_info apsfuzz_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'AutoWah'
 
-char *autowah_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
-char *autowah_engine="EMU10K1_A0";
-char *autowah_comment="DLLed by Hanz";
-char *autowah_created="Fri Jul 13 12:59:04 2001 ";
-char *autowah_guid="441a09a0-3d0b-11d6-a4c7-8fae6d701845";
+const char *autowah_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
+const char *autowah_engine="EMU10K1_A0";
+const char *autowah_comment="DLLed by Hanz";
+const char *autowah_created="Fri Jul 13 12:59:04 2001 ";
+const char *autowah_guid="441a09a0-3d0b-11d6-a4c7-8fae6d701845";
 
-char *autowah_name="APS AutoWah";
+const char *autowah_name="APS AutoWah";
 int autowah_itramsize=0,autowah_xtramsize=0;
 
 dsp_register_info autowah_info[]={
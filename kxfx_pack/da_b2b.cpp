@@ -39,13 +39,13 @@ limit out, 0x10000, in, t
 // 10kX microcode
 // Patch name: 'b2b'
 
-char *b2b_copyright="Copyright (c) 2002-2004. kX Project. All rights reserved";
-char *b2b_engine="kX";
-char *b2b_comment="pre-x4 mode; v2.1";
-char *b2b_created="26/06/2003";
-char *b2b_guid="e4c6b77f-ee7a-4df0-92ea-cac787dd223c";
+const char *b2b_copyright="Copyright (c) 2002-2004. kX Project. All rights reserved";
+const char *b2b_engine="kX";
+const char *b2b_comment="pre-x4 mode; v2.1";
+const char *b2b_created="26/06/2003";
+const char *b2b_guid="e4c6b77f-ee7a-4df0-92ea-cac787dd223c";
 
-char *b2b_name="b2b";
+const char *b2b_name="b2b";
 int b2b_itramsize=0,b2b_xtramsize=0;
 
 dsp_register_info b2b_info[]={
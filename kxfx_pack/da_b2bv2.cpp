@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'b2b'
 
-char *b2bv2_copyright="Copyright (c) 2002-2004, Eugene Gavrilov. kX Project. All rights reserved";
-char *b2bv2_engine="kX";
-char *b2bv2_comment="v3.0; pre-x4 mode";
-char *b2bv2_created="06/26/2003";
-char *b2bv2_guid="e4c6b77f-ee7a-4df0-92ea-cac787dd223d";
+const char *b2bv2_copyright="Copyright (c) 2002-2004, Eugene Gavrilov. kX Project. All rights reserved";
+const char *b2bv2_engine="kX";
+const char *b2bv2_comment="v3.0; pre-x4 mode";
+const char *b2bv2_created="06/26/2003";
+const char *b2bv2_guid="e4c6b77f-ee7a-4df0-92ea-cac787dd223d";
 
-char *b2bv2_name="b2b_old";
+const char *b2bv2_name="b2b_old";
 int b2bv2_itramsize=0,b2bv2_xtramsize=0;
 
 dsp_register_info b2bv2_info[]={
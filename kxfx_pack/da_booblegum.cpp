@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'booblegum'
 
-char *booblegum_copyright="Copyright c Max Mikhailov, 2004.";
-char *booblegum_engine="kX";
-char *booblegum_comment="";
-char *booblegum_created="April'2004";
-char *booblegum_guid="4016dea0-8e53-11d8-bad1-c15710887410";
+const char *booblegum_copyright="Copyright c Max Mikhailov, 2004.";
+const char *booblegum_engine="kX";
+const char *booblegum_comment="";
+const char *booblegum_created="April'2004";
+const char *booblegum_guid="4016dea0-8e53-11d8-bad1-c15710887410";
 
-char *booblegum_name="Booble Gum";
+const char *booblegum_name="Booble Gum";
 int booblegum_itramsize=0,booblegum_xtramsize=0;
 
 dsp_register_info booblegum_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'CLEAX3Reverb'
 
-char *CLEAX3Reverb_copyright="Copyright 2000 E-mu Systems/Creative Technology, Ltd. Default parameters and Dane Source (c) Eugene Gavrilov, 2003-2004";
-char *CLEAX3Reverb_engine="EMU10K2_A0";
-char *CLEAX3Reverb_comment="You should have the original Creative Labs .DLL in order to use this effect legally";
-char *CLEAX3Reverb_created="Mon Jan 06 14:30:48 2003 ";
-char *CLEAX3Reverb_guid="0590bebd-4774-4092-b181-812535591331";
+const char *CLEAX3Reverb_copyright="Copyright 2000 E-mu Systems/Creative Technology, Ltd. Default parameters and Dane Source (c) Eugene Gavrilov, 2003-2004";
+const char *CLEAX3Reverb_engine="EMU10K2_A0";
+const char *CLEAX3Reverb_comment="You should have the original Creative Labs .DLL in order to use this effect legally";
+const char *CLEAX3Reverb_created="Mon Jan 06 14:30:48 2003 ";
+const char *CLEAX3Reverb_guid="0590bebd-4774-4092-b181-812535591331";
 
-char *CLEAX3Reverb_name="CLEAX3Reverb";
+const char *CLEAX3Reverb_name="CLEAX3Reverb";
 int CLEAX3Reverb_itramsize=4119,CLEAX3Reverb_xtramsize=78154;
 
 
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'CLEAX4Reverb'
 
-char *CLEAX4Reverb_copyright="Copyright 2001-2002 E-mu Systems/Creative Technology, Ltd. Presets and kXL Code Copyright (c) Eugene Gavrilov, 2004";
-char *CLEAX4Reverb_engine="EMU10K2_A0";
-char *CLEAX4Reverb_comment="you need to have ctaudfx.dll to use this effect legally";
-char *CLEAX4Reverb_created="Mon Oct 06 14:44:32 2003 -- 02/03/2004";
-char *CLEAX4Reverb_guid="89b8f385-1c9e-46cb-9b6f-7bcd6e913917";
+const char *CLEAX4Reverb_copyright="Copyright 2001-2002 E-mu Systems/Creative Technology, Ltd. Presets and kXL Code Copyright (c) Eugene Gavrilov, 2004";
+const char *CLEAX4Reverb_engine="EMU10K2_A0";
+const char *CLEAX4Reverb_comment="you need to have ctaudfx.dll to use this effect legally";
+const char *CLEAX4Reverb_created="Mon Oct 06 14:44:32 2003 -- 02/03/2004";
+const char *CLEAX4Reverb_guid="89b8f385-1c9e-46cb-9b6f-7bcd6e913917";
 
-char *CLEAX4Reverb_name="CLEAX4Reverb";
+const char *CLEAX4Reverb_name="CLEAX4Reverb";
 int CLEAX4Reverb_itramsize=3418,CLEAX4Reverb_xtramsize=76575;
 
 #define CLEAX4STATIC_OFFSET	0xb
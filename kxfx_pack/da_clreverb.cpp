@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'CL Reverb'
 
-char *clreverb_copyright="Reverb: (c) E-mu Systems/Creative Technology, Ltd., 2000. Default parameters and Dane Source (c) Eugene Gavrilov, 2002-2004";
-char *clreverb_engine="kX";
-char *clreverb_comment="You should have original Creative Labs .DLL in order to use this effect legally; $nobypass";
-char *clreverb_created="Feb 8 2002";
-char *clreverb_guid="3EF83B67-66A6-4e30-90D6-8D11A6BD3D3A";
+const char *clreverb_copyright="Reverb: (c) E-mu Systems/Creative Technology, Ltd., 2000. Default parameters and Dane Source (c) Eugene Gavrilov, 2002-2004";
+const char *clreverb_engine="kX";
+const char *clreverb_comment="You should have original Creative Labs .DLL in order to use this effect legally; $nobypass";
+const char *clreverb_created="Feb 8 2002";
+const char *clreverb_guid="3EF83B67-66A6-4e30-90D6-8D11A6BD3D3A";
 
-char *clreverb_name="CL Reverb";
+const char *clreverb_name="CL Reverb";
 int clreverb_itramsize=3760,clreverb_xtramsize=78154;
 
 dsp_register_info clreverb_info[]={
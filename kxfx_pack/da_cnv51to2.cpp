@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'cnv51to20'
 
-char *cnv51to20_copyright="(c) kX Project, 2002-2004.";
-char *cnv51to20_engine="kX";
-char *cnv51to20_comment="5.1 to Stereo Encoder";
-char *cnv51to20_created="09/30/2002";
-char *cnv51to20_guid="e38441c0-d40c-11d6-8f89-a22ffa804d06";
+const char *cnv51to20_copyright="(c) kX Project, 2002-2004.";
+const char *cnv51to20_engine="kX";
+const char *cnv51to20_comment="5.1 to Stereo Encoder";
+const char *cnv51to20_created="09/30/2002";
+const char *cnv51to20_guid="e38441c0-d40c-11d6-8f89-a22ffa804d06";
 
-char *cnv51to20_name="cnv51to20";
+const char *cnv51to20_name="cnv51to20";
 int cnv51to20_itramsize=0,cnv51to20_xtramsize=0;
 
 dsp_register_info cnv51to20_info[]={
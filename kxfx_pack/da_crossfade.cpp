@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'crossfade'
 
-char *crossfade_copyright="Copyright (c) kX Project, 2003-2004. All rights reserved";
-char *crossfade_engine="kX";
-char *crossfade_comment="";
-char *crossfade_created="03/14/2003";
-char *crossfade_guid="2f0ef3c1-87cd-4469-9d05-caa78687c703";
+const char *crossfade_copyright="Copyright (c) kX Project, 2003-2004. All rights reserved";
+const char *crossfade_engine="kX";
+const char *crossfade_comment="";
+const char *crossfade_created="03/14/2003";
+const char *crossfade_guid="2f0ef3c1-87cd-4469-9d05-caa78687c703";
 
-char *crossfade_name="crossfade";
+const char *crossfade_name="crossfade";
 int crossfade_itramsize=0,crossfade_xtramsize=0;
 
 dsp_register_info crossfade_info[]={
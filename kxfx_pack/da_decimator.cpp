@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'decimator'
 
-char *decimator_copyright="Copyright (c) David Descheneau, 2003.";
-char *decimator_engine="kX";
-char *decimator_comment="";
-char *decimator_created="02/11/2003";
-char *decimator_guid="46c99605-edc7-4443-a2b2-f9d451c19483";
+const char *decimator_copyright="Copyright (c) David Descheneau, 2003.";
+const char *decimator_engine="kX";
+const char *decimator_comment="";
+const char *decimator_created="02/11/2003";
+const char *decimator_guid="46c99605-edc7-4443-a2b2-f9d451c19483";
 
-char *decimator_name="Stereo Decimator";
+const char *decimator_name="Stereo Decimator";
 int decimator_itramsize=0,decimator_xtramsize=0;
 
 dsp_register_info decimator_info[]={
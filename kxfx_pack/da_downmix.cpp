@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'downmix'
 
-char *downmix_copyright="Copyright (c) 2002.04.22 Mathias Wagner";
-char *downmix_engine="kX";
-char *downmix_comment="Simple 5.1 -> 4 Quadro mixer";
-char *downmix_created="04/22/2002";
-char *downmix_guid="fa2bb22a-1d9b-4ace-9e82-eca900b120ef";
+const char *downmix_copyright="Copyright (c) 2002.04.22 Mathias Wagner";
+const char *downmix_engine="kX";
+const char *downmix_comment="Simple 5.1 -> 4 Quadro mixer";
+const char *downmix_created="04/22/2002";
+const char *downmix_guid="fa2bb22a-1d9b-4ace-9e82-eca900b120ef";
 
-char *downmix_name="downmix";
+const char *downmix_name="downmix";
 int downmix_itramsize=0,downmix_xtramsize=0;
 
 dsp_register_info downmix_info[]={
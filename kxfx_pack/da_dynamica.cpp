@@ -24,13 +24,13 @@
 // 10kX microcode
 // Patch name: 'dynamica'
 
-char *dynamica_copyright="by eYagos - Copyright (c) 2003-2004, All rights reserved";
-char *dynamica_engine="EMU10K1_A0";
-char *dynamica_comment="Dynamics Processor Agent v2.0";
-char *dynamica_created="11/16/2003";
-char *dynamica_guid="88bbe0dc-d6d5-4468-86f1-eb5a2658eb42";
+const char *dynamica_copyright="by eYagos - Copyright (c) 2003-2004, All rights reserved";
+const char *dynamica_engine="EMU10K1_A0";
+const char *dynamica_comment="Dynamics Processor Agent v2.0";
+const char *dynamica_created="11/16/2003";
+const char *dynamica_guid="88bbe0dc-d6d5-4468-86f1-eb5a2658eb42";
 
-char *dynamica_name="Dynamics Processor";
+const char *dynamica_name="Dynamics Processor";
 int dynamica_itramsize=400,dynamica_xtramsize=0;
 
 #ifndef KX_INTERNAL	// why?..
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'encode4'
 
-char *encode4_copyright="(c) Soeren Bovbjerg, 2002-2004";
-char *encode4_engine="kX";
-char *encode4_comment="v0.1, beta; downmixes left+right+center+subwoofer -> stereo";
-char *encode4_created="2002/04/22";
-char *encode4_guid="bb5186f4-6844-4169-8e49-8333b69f0020";
+const char *encode4_copyright="(c) Soeren Bovbjerg, 2002-2004";
+const char *encode4_engine="kX";
+const char *encode4_comment="v0.1, beta; downmixes left+right+center+subwoofer -> stereo";
+const char *encode4_created="2002/04/22";
+const char *encode4_guid="bb5186f4-6844-4169-8e49-8333b69f0020";
 
-char *encode4_name="encode4";
+const char *encode4_name="encode4";
 int encode4_itramsize=0,encode4_xtramsize=0;
 
 dsp_register_info encode4_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'everb'
 
-char *everb_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
-char *everb_engine="EMU10K1_A0";
-char *everb_comment="APS Everb, DLLed by Hanz Petrov, Jan 2003";
-char *everb_created="Fri Jul 13 12:59:02 2001 ";
-char *everb_guid="441a09a8-3d0b-11d6-a4c7-8fae6d701845";
+const char *everb_copyright="Copyright 1998 E-mu Systems/Creative Technology, Ltd.";
+const char *everb_engine="EMU10K1_A0";
+const char *everb_comment="APS Everb, DLLed by Hanz Petrov, Jan 2003";
+const char *everb_created="Fri Jul 13 12:59:02 2001 ";
+const char *everb_guid="441a09a8-3d0b-11d6-a4c7-8fae6d701845";
 
-char *everb_name="APS Everb";
+const char *everb_name="APS Everb";
 int everb_itramsize=2943,everb_xtramsize=62590;
 
 dsp_register_info everb_info[]={
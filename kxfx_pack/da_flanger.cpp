@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'Stereo Flanger'
 
-char *flanger_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
-char *flanger_engine="EMU10K1_A0";
-char *flanger_comment="APS Stereo Flanger, DLLed by Hanz, Apr 5 2002";
-char *flanger_created="Fri Jul 13 12:59:04 2001 ";
-char *flanger_guid="99651dbe-9d73-45f1-97e4-07c1a9459839";
+const char *flanger_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
+const char *flanger_engine="EMU10K1_A0";
+const char *flanger_comment="APS Stereo Flanger, DLLed by Hanz, Apr 5 2002";
+const char *flanger_created="Fri Jul 13 12:59:04 2001 ";
+const char *flanger_guid="99651dbe-9d73-45f1-97e4-07c1a9459839";
 
-char *flanger_name="APS Flanger";
+const char *flanger_name="APS Flanger";
 int flanger_itramsize=780,flanger_xtramsize=0;
 
 dsp_register_info flanger_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'gain'
 
-char *gain_copyright="Copyright (c) kX Project, 2003-2004.";
-char *gain_engine="kX";
-char *gain_comment="";
-char *gain_created="02/14/2003";
-char *gain_guid="79b68b0b-cd7e-4856-ba97-31189a6ae8e9";
+const char *gain_copyright="Copyright (c) kX Project, 2003-2004.";
+const char *gain_engine="kX";
+const char *gain_comment="";
+const char *gain_created="02/14/2003";
+const char *gain_guid="79b68b0b-cd7e-4856-ba97-31189a6ae8e9";
 
-char *gain_name="gain";
+const char *gain_name="gain";
 int gain_itramsize=0,gain_xtramsize=0;
 
 dsp_register_info gain_info[]={
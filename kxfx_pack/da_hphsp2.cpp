@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'hphsp+'
 
-char *hphsp2_copyright="Copyright 1999 E-mu Systems/Creative Technology, Ltd. Default parameters and Dane Source (c) Eugene Gavrilov, 2003-2004";
-char *hphsp2_engine="EMU10K1_A0";
-char *hphsp2_comment="You should have the original Creative Labs .DLL in order to use this effect legally";
-char *hphsp2_created="2009/Apr/24";
-char *hphsp2_guid="9aa908e6-1ffd-47b6-a51e-d1535ef878ce";
+const char *hphsp2_copyright="Copyright 1999 E-mu Systems/Creative Technology, Ltd. Default parameters and Dane Source (c) Eugene Gavrilov, 2003-2004";
+const char *hphsp2_engine="EMU10K1_A0";
+const char *hphsp2_comment="You should have the original Creative Labs .DLL in order to use this effect legally";
+const char *hphsp2_created="2009/Apr/24";
+const char *hphsp2_guid="9aa908e6-1ffd-47b6-a51e-d1535ef878ce";
 
-char *hphsp2_name="HPhSp+";
+const char *hphsp2_name="HPhSp+";
 int hphsp2_itramsize=140,hphsp2_xtramsize=0;
 
 dsp_register_info hphsp2_info[]={
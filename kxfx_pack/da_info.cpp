@@ -20,13 +20,13 @@
 
 // 10kX pseudo-microcode
 
-char *info_copyright="Copyright (c) Eugene Gavrilov, 2004.";
-char *info_engine="kX";
-char *info_comment="Simple 'Info' effect -- doesn't use any resources";
-char *info_created="29 March, 2004";
-char *info_guid="6189318b-be5c-4566-adbf-6afa80b8acf3";
+const char *info_copyright="Copyright (c) Eugene Gavrilov, 2004.";
+const char *info_engine="kX";
+const char *info_comment="Simple 'Info' effect -- doesn't use any resources";
+const char *info_created="29 March, 2004";
+const char *info_guid="6189318b-be5c-4566-adbf-6afa80b8acf3";
 
-char *info_name="Info";
+const char *info_name="Info";
 int info_itramsize=0,info_xtramsize=0;
 
 dsp_register_info info_info[]={
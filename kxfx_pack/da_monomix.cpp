@@ -22,13 +22,13 @@
 // 10kX microcode
 // Patch name: 'monomix'
 
-char *monomix_copyright="Copyright (c) 2002-2004, kX Project";
-char *monomix_engine="kX";
-char *monomix_comment="";
-char *monomix_created="05/10/2002";
-char *monomix_guid="2b53ce82-8b75-43c3-9a8e-07cb812bce06";
+const char *monomix_copyright="Copyright (c) 2002-2004, kX Project";
+const char *monomix_engine="kX";
+const char *monomix_comment="";
+const char *monomix_created="05/10/2002";
+const char *monomix_guid="2b53ce82-8b75-43c3-9a8e-07cb812bce06";
 
-char *monomix_name="Mono Mix";
+const char *monomix_name="Mono Mix";
 int monomix_itramsize=0,monomix_xtramsize=0;
 
 dsp_register_info monomix_info[]={
@@ -23,13 +23,13 @@
 // 10kX microcode
 // Patch name: 'mx6'
 
-char *mx6_copyright="Copyright (c) LeMury, 2003-2004. All rights reserved.";
-char *mx6_engine="kX";
-char *mx6_comment="General Purpose Mixer v1.13b; $nobypass";
-char *mx6_created="05/03/2004";
-char *mx6_guid="1175058b-a0df-4960-bdfb-0d4d2b3fd750";
+const char *mx6_copyright="Copyright (c) LeMury, 2003-2004. All rights reserved.";
+const char *mx6_engine="kX";
+const char *mx6_comment="General Purpose Mixer v1.13b; $nobypass";
+const char *mx6_created="05/03/2004";
+const char *mx6_guid="1175058b-a0df-4960-bdfb-0d4d2b3fd750";
 
-char *mx6_name="MX6";
+const char *mx6_name="MX6";
 int mx6_itramsize=0,mx6_xtramsize=0;
 
 //PARAMS COUNT 
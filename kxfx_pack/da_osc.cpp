@@ -23,13 +23,13 @@
 // 10kX microcode
 // Patch name: 'osc'
 
-char *osc_copyright="Copyright (c) kX Project, 2002-2004. All rights reserved";
-char *osc_engine="kX";
-char *osc_comment="";
-char *osc_created="05/03/2002";
-char *osc_guid="7c644915-4fef-4951-ac4a-694fb29a72b8";
+const char *osc_copyright="Copyright (c) kX Project, 2002-2004. All rights reserved";
+const char *osc_engine="kX";
+const char *osc_comment="";
+const char *osc_created="05/03/2002";
+const char *osc_guid="7c644915-4fef-4951-ac4a-694fb29a72b8";
 
-char *osc_name="EFX Oscilloscope";
+const char *osc_name="EFX Oscilloscope";
 int osc_itramsize=0,osc_xtramsize=0;
 
 dsp_register_info osc_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'Overdrive'
 
-char *overdrive_copyright="(c) Cybercurve, 2002";
-char *overdrive_engine="kX";
-char *overdrive_comment="simple overdrive";
-char *overdrive_created="Jan 15 2002";
-char *overdrive_guid="3753C6BA-FA55-4e79-A35C-A3B9F1EF3D45";
+const char *overdrive_copyright="(c) Cybercurve, 2002";
+const char *overdrive_engine="kX";
+const char *overdrive_comment="simple overdrive";
+const char *overdrive_created="Jan 15 2002";
+const char *overdrive_guid="3753C6BA-FA55-4e79-A35C-A3B9F1EF3D45";
 
-char *overdrive_name="Overdrive";
+const char *overdrive_name="Overdrive";
 int overdrive_itramsize=0,overdrive_xtramsize=0;
 
 dsp_register_info overdrive_info[]={
@@ -23,13 +23,13 @@
 // 10kX microcode
 // Patch name: 'overdrive2'
 
-char *overdrive2_copyright="by eYagos";
-char *overdrive2_engine="kX";
-char *overdrive2_comment="simple overdrive";
-char *overdrive2_created="March 25 2002";
-char *overdrive2_guid="3753C6BA-FA53-4e79-A35C-A3B9F1EF3D45";
+const char *overdrive2_copyright="by eYagos";
+const char *overdrive2_engine="kX";
+const char *overdrive2_comment="simple overdrive";
+const char *overdrive2_created="March 25 2002";
+const char *overdrive2_guid="3753C6BA-FA53-4e79-A35C-A3B9F1EF3D45";
 
-char *overdrive2_name="Overdrive2";
+const char *overdrive2_name="Overdrive2";
 int overdrive2_itramsize=0,overdrive2_xtramsize=0;
 
 dsp_register_info overdrive2_info[]={
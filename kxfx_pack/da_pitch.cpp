@@ -22,13 +22,13 @@
 // 10kX microcode
 // Patch name: 'APS Pitch Shift'
 
-char *pitch_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
-char *pitch_engine="EMU10K1_A0";
-char *pitch_comment="APS Pitch Shifter, DLLed by Hanz Petrov, Mar 2003";
-char *pitch_created="Fri Jul 13 12:59:02 2001 ";
-char *pitch_guid="441a09a7-3d0b-11d6-a4c7-8fae6d701845";
+const char *pitch_copyright="Copyright 1997 E-mu Systems/Creative Technology, Ltd.";
+const char *pitch_engine="EMU10K1_A0";
+const char *pitch_comment="APS Pitch Shifter, DLLed by Hanz Petrov, Mar 2003";
+const char *pitch_created="Fri Jul 13 12:59:02 2001 ";
+const char *pitch_guid="441a09a7-3d0b-11d6-a4c7-8fae6d701845";
 
-char *pitch_name="APS Pitch";
+const char *pitch_name="APS Pitch";
 int pitch_itramsize=2048,pitch_xtramsize=0;
 
 dsp_register_info pitch_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'ProLogica'
 
-char *prologica_copyright="Robert Mazur, Martijn van Eeten";
-char *prologica_engine="kX";
-char *prologica_comment="Surround Decoder (2->5.1)\nLicense: GNU General Public License; $nobypass";
-char *prologica_created="Jan 19 2002";
-char *prologica_guid="9aac2f24-7527-47fb-94c1-d665a4c25d92";
+const char *prologica_copyright="Robert Mazur, Martijn van Eeten";
+const char *prologica_engine="kX";
+const char *prologica_comment="Surround Decoder (2->5.1)\nLicense: GNU General Public License; $nobypass";
+const char *prologica_created="Jan 19 2002";
+const char *prologica_guid="9aac2f24-7527-47fb-94c1-d665a4c25d92";
 
-char *prologica_name="ProLogica";
+const char *prologica_name="ProLogica";
 int prologica_itramsize=960,prologica_xtramsize=0;
 
 dsp_register_info prologica_info[]={
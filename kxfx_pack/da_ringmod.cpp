@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'ringmod'
 
-char *ringmod_copyright="By eYagos";
-char *ringmod_engine="kX";
-char *ringmod_comment="License: Public Domain; $legacy";
-char *ringmod_created="Jan 29 2002";
-char *ringmod_guid="28d91c3d-c21e-4eab-8ff0-f08ad6e9ddf0";
+const char *ringmod_copyright="By eYagos";
+const char *ringmod_engine="kX";
+const char *ringmod_comment="License: Public Domain; $legacy";
+const char *ringmod_created="Jan 29 2002";
+const char *ringmod_guid="28d91c3d-c21e-4eab-8ff0-f08ad6e9ddf0";
 
-char *ringmod_name="RingMod";
+const char *ringmod_name="RingMod";
 int ringmod_itramsize=119,ringmod_xtramsize=0;
 
 dsp_register_info ringmod_info[]={
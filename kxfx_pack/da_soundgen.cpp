@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: '3D Sound Gen'
 
-char* soundgen_copyright="  WORM  ";
-char* soundgen_engine="kX";
-char* soundgen_comment="LGPL";
-char* soundgen_created="March 10 2002";
-char* soundgen_guid="82ed3514-615a-4aac-aee0-0ddaefa024e1";
+const char *soundgen_copyright="  WORM  ";
+const char *soundgen_engine="kX";
+const char *soundgen_comment="LGPL";
+const char *soundgen_created="March 10 2002";
+const char *soundgen_guid="82ed3514-615a-4aac-aee0-0ddaefa024e1";
 
-char* soundgen_name = "3D Sound Gen";
+const char *soundgen_name = "3D Sound Gen";
 int soundgen_itramsize=0,soundgen_xtramsize=7681;
 
 dsp_register_info soundgen_info[]={
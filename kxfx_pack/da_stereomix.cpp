@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'StereoMix'
 
-char *stereomix_copyright="Copyright (c) 2002-2004, kX Project";
-char *stereomix_engine="kX";
-char *stereomix_comment="";
-char *stereomix_created="05/05/2002";
-char *stereomix_guid="32a03c8a-5c04-487e-9cc4-e8c5a25f0ef4";
+const char *stereomix_copyright="Copyright (c) 2002-2004, kX Project";
+const char *stereomix_engine="kX";
+const char *stereomix_comment="";
+const char *stereomix_created="05/05/2002";
+const char *stereomix_guid="32a03c8a-5c04-487e-9cc4-e8c5a25f0ef4";
 
-char *stereomix_name="Stereo Mix";
+const char *stereomix_name="Stereo Mix";
 int stereomix_itramsize=0,stereomix_xtramsize=0;
 
 dsp_register_info stereomix_info[]={
@@ -23,13 +23,13 @@
 // 10kX microcode
 // Patch name: 'stmix'
 
-char *stmix_copyright="by eYagos, Copyright (c) 2003-2004.";
-char *stmix_engine="kX";
-char *stmix_comment="Mixes two stereo channels";
-char *stmix_created="02/14/2003";
-char *stmix_guid="34131ae6-3e2d-416f-acd9-7d1bf4e77860";
+const char *stmix_copyright="by eYagos, Copyright (c) 2003-2004.";
+const char *stmix_engine="kX";
+const char *stmix_comment="Mixes two stereo channels";
+const char *stmix_created="02/14/2003";
+const char *stmix_guid="34131ae6-3e2d-416f-acd9-7d1bf4e77860";
 
-char *stmix_name="Stereo Mix + Gain";
+const char *stmix_name="Stereo Mix + Gain";
 int stmix_itramsize=0,stmix_xtramsize=0;
 
 #define R_GAIN1_I	0x8002
@@ -23,13 +23,13 @@
 // 10kX microcode
 // Patch name: 'stvocoder'
 
-char *stvocoder_copyright="Copyright Remy TROTIN (c) 2002.";
-char *stvocoder_engine="kX";
-char *stvocoder_comment="";
-char *stvocoder_created="03/20/2002";
-char *stvocoder_guid="171dfbe2-d584-459b-942c-97af87ba959b";
+const char *stvocoder_copyright="Copyright Remy TROTIN (c) 2002.";
+const char *stvocoder_engine="kX";
+const char *stvocoder_comment="";
+const char *stvocoder_created="03/20/2002";
+const char *stvocoder_guid="171dfbe2-d584-459b-942c-97af87ba959b";
 
-char *stvocoder_name="Stereo Vocoder";
+const char *stvocoder_name="Stereo Vocoder";
 int stvocoder_itramsize=0,stvocoder_xtramsize=0;
 
 dsp_register_info stvocoder_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'surrounder lt'
 
-char *surrounderlt_copyright="(c) kX Project, 2002-2004.";
-char *surrounderlt_engine="kX";
-char *surrounderlt_comment="Surround Lite; $nobypass";
-char *surrounderlt_created="02/13/2003";
-char *surrounderlt_guid="bba48159-60af-4772-a931-c74547820353";
+const char *surrounderlt_copyright="(c) kX Project, 2002-2004.";
+const char *surrounderlt_engine="kX";
+const char *surrounderlt_comment="Surround Lite; $nobypass";
+const char *surrounderlt_created="02/13/2003";
+const char *surrounderlt_guid="bba48159-60af-4772-a931-c74547820353";
 
-char *surrounderlt_name="surrounderlt";
+const char *surrounderlt_name="surrounderlt";
 int surrounderlt_itramsize=0,surrounderlt_xtramsize=0;
 
 dsp_register_info surrounderlt_info[]={
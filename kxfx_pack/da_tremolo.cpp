@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'remolo'
 
-char *tremolo_copyright=" Max Mikhailov, 2001-2006";
+const char *tremolo_copyright=" Max Mikhailov, 2001-2006";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *tremolo_engine=" ,   , ,   !";
-char *tremolo_comment="Just tremolo...";
-char *tremolo_created="August 22 2006";
-char *tremolo_guid="C27CE4A1-2717-48C1-AF56-E6C0737B3361";
+const char *tremolo_engine=" ,   , ,   !";
+const char *tremolo_comment="Just tremolo...";
+const char *tremolo_created="August 22 2006";
+const char *tremolo_guid="C27CE4A1-2717-48C1-AF56-E6C0737B3361";
 
-char *tremolo_name="remolo";
+const char *tremolo_name="remolo";
 int tremolo_itramsize=0,tremolo_xtramsize=0;
 
 dsp_register_info tremolo_info[]={
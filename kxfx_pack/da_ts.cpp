@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'TS Effect'
 
-char *ts_copyright="(c) Max Mikhailov and Eugene Gavrilov, 2001-2005";
-char *ts_engine="kX";
-char *ts_comment="version 0.2";
-char *ts_created="2001";
-char *ts_guid="33E8D755-AC3D-4bcc-9681-7DE25B989DD9";
+const char *ts_copyright="(c) Max Mikhailov and Eugene Gavrilov, 2001-2005";
+const char *ts_engine="kX";
+const char *ts_comment="version 0.2";
+const char *ts_created="2001";
+const char *ts_guid="33E8D755-AC3D-4bcc-9681-7DE25B989DD9";
 
-char *ts_name="TubeSound";
+const char *ts_name="TubeSound";
 int ts_itramsize=0,ts_xtramsize=0;
 
 dsp_register_info ts_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'vibrato'
 
-char *vibrato_copyright="Copyright c Max Mikhailov, 2004";
-char *vibrato_engine="kX";
-char *vibrato_comment="";
-char *vibrato_created="April'2004";
-char *vibrato_guid="d8dc1380-56ec-4098-960f-44e461f818d0";
+const char *vibrato_copyright="Copyright c Max Mikhailov, 2004";
+const char *vibrato_engine="kX";
+const char *vibrato_comment="";
+const char *vibrato_created="April'2004";
+const char *vibrato_guid="d8dc1380-56ec-4098-960f-44e461f818d0";
 
-char *vibrato_name="vibrato";
+const char *vibrato_name="vibrato";
 int vibrato_itramsize=2002,vibrato_xtramsize=0;
 
 dsp_register_info vibrato_info[]={
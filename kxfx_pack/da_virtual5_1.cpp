@@ -20,18 +20,18 @@
 // 10kX microcode
 // Patch name: 'virtual5.1'
 
-char *virtual51_copyright="Copyright (c) 2004. Foolou";
+const char *virtual51_copyright="Copyright (c) 2004. Foolou";
 // NOTE: The present DSP microcode dump is protected by the 
 // license agreement bundled with the appropriate software 
 // package containing this microcode,
 // regardless the particular copyright notice is present in the dump.
 
-char *virtual51_engine="kX";
-char *virtual51_comment="This plugin does a reduced HRTF-convolution to achieve virtual 5point-surround-sound";
-char *virtual51_created="10/22/2004";
-char *virtual51_guid="b2d90700-13e6-4aba-ae11-fb3a34eb986a";
+const char *virtual51_engine="kX";
+const char *virtual51_comment="This plugin does a reduced HRTF-convolution to achieve virtual 5point-surround-sound";
+const char *virtual51_created="10/22/2004";
+const char *virtual51_guid="b2d90700-13e6-4aba-ae11-fb3a34eb986a";
 
-char *virtual51_name="virtual5.1";
+const char *virtual51_name="virtual5.1";
 int virtual51_itramsize=172,virtual51_xtramsize=0;
 
 dsp_register_info virtual51_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'vocoder'
 
-char *vocoder_copyright="Copyright Remy TROTIN (c) 2002.";
-char *vocoder_engine="kX";
-char *vocoder_comment="";
-char *vocoder_created="03/20/2002";
-char *vocoder_guid="7e4ffe03-9b28-4fe8-90ab-2dd896d11077";
+const char *vocoder_copyright="Copyright Remy TROTIN (c) 2002.";
+const char *vocoder_engine="kX";
+const char *vocoder_comment="";
+const char *vocoder_created="03/20/2002";
+const char *vocoder_guid="7e4ffe03-9b28-4fe8-90ab-2dd896d11077";
 
-char *vocoder_name="Mono Vocoder";
+const char *vocoder_name="Mono Vocoder";
 int vocoder_itramsize=0,vocoder_xtramsize=0;
 
 dsp_register_info vocoder_info[]={
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'vol'
 
-char *voldc_copyright="(c) Max Mikhailov and Eugene Gavrilov, 2001-2005";
-char *voldc_engine="kX";
-char *voldc_comment="";
-char *voldc_created="2001";
-char *voldc_guid="F924CD0E-893F-4175-89CF-3591E2C80BBD";
+const char *voldc_copyright="(c) Max Mikhailov and Eugene Gavrilov, 2001-2005";
+const char *voldc_engine="kX";
+const char *voldc_comment="";
+const char *voldc_created="2001";
+const char *voldc_guid="F924CD0E-893F-4175-89CF-3591E2C80BBD";
 
-char *voldc_name="Vol+DC";
+const char *voldc_name="Vol+DC";
 int voldc_itramsize=0,voldc_xtramsize=0;
 
 dsp_register_info voldc_info[]={
@@ -20,13 +20,13 @@
 
 // 10kX microcode
 
-char *wavegen_copyright="Copyright (c) eYagos, 2002. All rights reserved.";
-char *wavegen_engine="kX";
-char *wavegen_comment="Wave Generator: Sine, Square, Triangle and Sawtooth. Triangle only works fine at frecuencies lower than 12KHz";
-char *wavegen_created="10/31/2002";
-char *wavegen_guid="e6580857-eb69-45a6-bb78-9ecf4f74eeb1";
+const char *wavegen_copyright="Copyright (c) eYagos, 2002. All rights reserved.";
+const char *wavegen_engine="kX";
+const char *wavegen_comment="Wave Generator: Sine, Square, Triangle and Sawtooth. Triangle only works fine at frecuencies lower than 12KHz";
+const char *wavegen_created="10/31/2002";
+const char *wavegen_guid="e6580857-eb69-45a6-bb78-9ecf4f74eeb1";
 
-char *wavegen_name="Wave Generator";
+const char *wavegen_name="Wave Generator";
 int wavegen_itramsize=0,wavegen_xtramsize=0;
 
 #define	R_Level	0x8004u	
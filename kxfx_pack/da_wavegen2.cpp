@@ -22,13 +22,13 @@
 
 // Patch name: 'wavegen2'
 
-char *wavegen2_copyright="by eYagos - Copyright (c) 2002. All rights reserved";
-char *wavegen2_engine="kX";
-char *wavegen2_comment="Wave Generator 2.0: Sine, Square, Triangle, Sawtooth and White Noise. Triangle only works fien at frecuencies lower than 12kHz.";
-char *wavegen2_created="10/27/2002";
-char *wavegen2_guid="e6580857-eb69-45a6-bb78-9ecf4f74eeb0";
+const char *wavegen2_copyright="by eYagos - Copyright (c) 2002. All rights reserved";
+const char *wavegen2_engine="kX";
+const char *wavegen2_comment="Wave Generator 2.0: Sine, Square, Triangle, Sawtooth and White Noise. Triangle only works fien at frecuencies lower than 12kHz.";
+const char *wavegen2_created="10/27/2002";
+const char *wavegen2_guid="e6580857-eb69-45a6-bb78-9ecf4f74eeb0";
 
-char *wavegen2_name="Wave Generator 2.0";
+const char *wavegen2_name="Wave Generator 2.0";
 int wavegen2_itramsize=0,wavegen2_xtramsize=0;
 
 #define	R_Level	0x8005u	
@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'wavegen3'
 
-char *wavegen3_copyright="by eYagos - Copyright (c) 2003-2004. All rights reserved";
-char *wavegen3_engine="kX";
-char *wavegen3_comment="Wave Generator 3.0: Sine, Square, Triangle, Sawtooth and White Noise. Not intended for making music";
-char *wavegen3_created="07/23/2003";
-char *wavegen3_guid="e6580857-eb69-45a6-bb78-9ecf4f74eeb3";
+const char *wavegen3_copyright="by eYagos - Copyright (c) 2003-2004. All rights reserved";
+const char *wavegen3_engine="kX";
+const char *wavegen3_comment="Wave Generator 3.0: Sine, Square, Triangle, Sawtooth and White Noise. Not intended for making music";
+const char *wavegen3_created="07/23/2003";
+const char *wavegen3_guid="e6580857-eb69-45a6-bb78-9ecf4f74eeb3";
 
-char *wavegen3_name="Wave Generator 3.0";
+const char *wavegen3_name="Wave Generator 3.0";
 int wavegen3_itramsize=0,wavegen3_xtramsize=0;
 
 #define		R_Level	0x8005
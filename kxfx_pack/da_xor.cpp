@@ -21,13 +21,13 @@
 // 10kX microcode
 // Patch name: 'xor'
 
-char *xor_copyright="Copyright (c) Eugene Gavrilov, 2001-2005.";
-char *xor_engine="kX";
-char *xor_comment="";
-char *xor_created="01/14/2002";
-char *xor_guid="cb09c9c9-725a-4338-945d-7596b137dfee";
+const char *xor_copyright="Copyright (c) Eugene Gavrilov, 2001-2005.";
+const char *xor_engine="kX";
+const char *xor_comment="";
+const char *xor_created="01/14/2002";
+const char *xor_guid="cb09c9c9-725a-4338-945d-7596b137dfee";
 
-char *xor_name="xor";
+const char *xor_name="xor";
 int xor_itramsize=0,xor_xtramsize=0;
 
 dsp_register_info xor_info[]={
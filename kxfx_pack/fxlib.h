@@ -23,12 +23,12 @@
 
 // declare 'da_*.cpp' variables
 #define declare_effect_source(effect_name)			\
-	extern char * effect_name##_name;			\
-	extern char * effect_name##_copyright;			\
-	extern char * effect_name##_created;			\
-	extern char * effect_name##_engine;			\
-	extern char * effect_name##_guid;			\
-	extern char * effect_name##_comment;			\
+	extern const char * effect_name##_name;			\
+	extern const char * effect_name##_copyright;			\
+	extern const char * effect_name##_created;			\
+	extern const char * effect_name##_engine;			\
+	extern const char * effect_name##_guid;			\
+	extern const char * effect_name##_comment;			\
         extern int effect_name##_itramsize,effect_name##_xtramsize; \
         extern dsp_register_info effect_name##_info[];		\
         extern dsp_code effect_name##_code[]
@@ -124,8 +124,8 @@ declare_plugin_members(effect_name,class_name)
 // Plugin list
 typedef struct
 {
- char *name;
- char *guid;
+ const char *name;
+ const char *guid;
 }kxplugin_list_t;
 
 #endif
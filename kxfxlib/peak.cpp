@@ -67,6 +67,10 @@ iPeakPluginDlg::iPeakPluginDlg(iPeakPlugin *plg, kDialog *parent_,kFile *mf_)
 	  plugin=plg;
 
           timer_id=(UINT_PTR)-1;
+          telemetry=NULL;
+          tap_l=-1;
+          tap_r=-1;
+          telemetry_seq=0;
           mode=1;
           max_l=-120;
           max_r=-120;
@@ -102,6 +106,18 @@ int iPeakPluginDlg::turn_on(int what)
 {
  if((what==1) && (timer_id==-1))
  {
+  // the driver samples (and resets) the peaks; the dialog only reads the shared page
+  telemetry=plugin->ikx->map_telemetry();
+  if(telemetry)
+  {
+   tap_l=plugin->ikx->add_telemetry_tap(plugin->pgm_id,"result_l",KX_TAP_RESET);
+   tap_r=plugin->ikx->add_telemetry_tap(plugin->pgm_id,"result_r",KX_TAP_RESET);
+   if(tap_l<0 || tap_r<0)
+    turn_off_telemetry();
+   else
+    telemetry_seq=telemetry->seq;
+  }
+
   timer_id=SetTimer(4321+plugin->pgm_id,70,NULL);
   						// FIXME: timer ID should be unique
   						// perhaps, we will need a better code 
@@ -116,10 +132,22 @@ int iPeakPluginDlg::turn_on(int what)
 	 KillTimer(timer_id);
 	 timer_id=(UINT_PTR)-1;
 	}
+	turn_off_telemetry();
  }
  return 0;
 }
 
+void iPeakPluginDlg::turn_off_telemetry()
+{
+ if(tap_l>=0)
+  plugin->ikx->remove_telemetry_tap(tap_l);
+ if(tap_r>=0)
+  plugin->ikx->remove_telemetry_tap(tap_r);
+ tap_l=-1;
+ tap_r=-1;
+ telemetry=NULL;
+}
+
 
 void iPeakPluginDlg::init()
 {
@@ -197,11 +225,20 @@ void iPeakPluginDlg::init()
 void iPeakPluginDlg::OnTimer(UINT_PTR)
 {
 	// recalc
-        dword left,right;
-        plugin->get_dsp_register("result_l",&left);
-        plugin->get_dsp_register("result_r",&right);
-        plugin->set_dsp_register("result_l",0);
-        plugin->set_dsp_register("result_r",0);
+        dword left=0,right=0;
+        if(telemetry)
+        {
+         dword seq=telemetry_seq;
+         kx_telemetry_read(telemetry,tap_l,&seq,&left);
+         kx_telemetry_read(telemetry,tap_r,&telemetry_seq,&right);
+        }
+        else
+        {
+         plugin->get_dsp_register("result_l",&left);
+         plugin->get_dsp_register("result_r",&right);
+         plugin->set_dsp_register("result_l",0);
+         plugin->set_dsp_register("result_r",0);
+        }
 
         #define UNITY_GAIN_COEFF 0x78000000L // level is 0.25
         #define MAGIC_SHIFT    24
@@ -50,6 +50,11 @@ public:
 	UINT_PTR timer_id;
 	kPeak *peak;
 
+	// driver-side sampling (see iKX::map_telemetry()); the registers are polled otherwise
+	const kx_telemetry_page *telemetry;
+	int tap_l,tap_r;
+	dword telemetry_seq;
+
 	int mode; // 0 - horizontal; 1 - vertical
 	float max_l,max_r;
 
@@ -68,6 +73,7 @@ public:
 
 	// declare GUI Elements
 	int turn_on(int what);
+	void turn_off_telemetry();
 
 	int on_command(int,int);
 	void on_mouse_r_up(kPoint ,int );
@@ -0,0 +1,86 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// .da sources: assembled with iKX::assemble_microcode() (kxapi)
+// iKX is not initialized: no kX driver or sound card is required (see kxapi/dane_demo.cpp)
+// kxapi is only available for Windows and OS X (RENDER_HAS_KXAPI); elsewhere only the built-in
+// effect library (emu/emufx.h) can be used and this file is not built
+
+#if defined(WIN32)
+	#include <afx.h>
+	#include <afxwin.h>
+#endif
+
+#include "interface/kxapi.h"
+
+#include "kxrender.h"
+
+int render_assemble(const char *file_name,char *name,dsp_code **code,int *code_size,
+	dsp_register_info **info,int *info_size,int *itramsize,int *xtramsize,char *guid)
+{
+	FILE *f=fopen(file_name,"rb");
+	if(!f)
+	{
+		fprintf(stderr,"kxrender: cannot open '%s'\n",file_name);
+		return -1;
+	}
+	fseek(f,0,SEEK_END);
+	long size=ftell(f);
+	fseek(f,0,SEEK_SET);
+
+	char *buf=(char *)malloc(size+1);
+	if(!buf || fread(buf,1,size,f)!=(size_t)size)
+	{
+		fprintf(stderr,"kxrender: cannot read '%s'\n",file_name);
+		fclose(f);
+		free(buf);
+		return -2;
+	}
+	fclose(f);
+	buf[size]=0;
+
+	char copyright[KX_MAX_STRING],engine[KX_MAX_STRING],created[KX_MAX_STRING],comment[KX_MAX_STRING];
+	kString err;
+
+	iKX *ikx=new iKX();	// no init(): the assembler does not need the driver
+	int ret=ikx->assemble_microcode(buf,&err,name,code,code_size,info,info_size,itramsize,xtramsize,
+		copyright,engine,created,comment,guid);
+	delete ikx;
+	free(buf);
+
+	if(ret)
+	{
+		fprintf(stderr,"kxrender: '%s': %s\n",file_name,(const char *)err);
+		return -3;
+	}
+	return 0;
+}
+
+void render_free_microcode(dsp_code *code,dsp_register_info *info)
+{
+	// see kxapi/gendic.cpp: dane_alloc()
+#if defined(WIN32)
+	if(code) LocalFree((HLOCAL)code);
+	if(info) LocalFree((HLOCAL)info);
+#else
+	if(code) free(code);
+	if(info) free(info);
+#endif
+}
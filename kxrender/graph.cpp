@@ -0,0 +1,569 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// DSP graph: microcode loading and wiring
+// a .kx file is restored the way iKXPluginManager::load_all_plugin_settings() does it:
+// microcode is loaded in [microcode] order with its saved pgm id, translated at the saved
+// offset and connected with kx_connect_microcode() semantics; the epilog is not emulated:
+// its inputs become the output channels
+
+#include "kxrender.h"
+#include "interface/kxcfg.h"
+
+// plugins that have no microcode of their own
+static const char *fxbus_guids[]=
+{
+	"2b8b7fa8-98b9-4f6e-81a0-400d3ba39c6f",	// FXBus
+	"d25a7874-7c00-47ca-8ad3-1b13106bde91",	// FXBusX
+	NULL
+};
+
+// epilog versions: the inputs are the physical outputs of the card
+static const char *epilog_guids[]=
+{
+	"ceffc302-ea28-44df-873f-d3df1ba31736",	// kxfxlib/da_epilog.cpp
+	"aa81bfd5-5400-47c0-bfca-cf0dc5ae41a6",	// epilog, as saved in kxmixer/kxdefault.kx
+	"85e97848-0004-4006-a500-5a6a03b1bf09",	// epilog lite (10k1)
+	"f88a3e59-ed54-4fb6-9b7d-4e213ed150f2",	// epilog lite (10k2)
+	NULL
+};
+
+static int guid_in_list(const char *guid,const char **list)
+{
+	for(int i=0;list[i];i++)
+	{
+		const char *a=guid,*b=list[i];
+		while(*a && *b && (*a|0x20)==(*b|0x20))
+			a++,b++;
+		if(*a==0 && *b==0)
+			return 1;
+	}
+	return 0;
+}
+
+// .kx files are plain .ini files; the whole file is kept in memory while the graph is built
+typedef struct
+{
+	char *text;
+	char **line;
+	int n_lines;
+}render_ini;
+
+static int ini_load(render_ini *ini,const char *file_name)
+{
+	memset(ini,0,sizeof(render_ini));
+
+	FILE *f=fopen(file_name,"rb");
+	if(!f)
+		return -1;
+	fseek(f,0,SEEK_END);
+	long size=ftell(f);
+	fseek(f,0,SEEK_SET);
+
+	ini->text=(char *)malloc(size+1);
+	ini->line=(char **)malloc((size+1)*sizeof(char *));
+	if(!ini->text || !ini->line || fread(ini->text,1,size,f)!=(size_t)size)
+	{
+		fclose(f);
+		free(ini->text);
+		free(ini->line);
+		return -2;
+	}
+	fclose(f);
+	ini->text[size]=0;
+
+	char *p=ini->text;
+	while(*p)
+	{
+		char *e=p;
+		while(*e && *e!='\n' && *e!='\r')
+			e++;
+		int more=(*e!=0);
+		*e=0;
+		ini->line[ini->n_lines++]=p;
+		p=e+more;
+	}
+	return 0;
+}
+
+static void ini_free(render_ini *ini)
+{
+	free(ini->text);
+	free(ini->line);
+	memset(ini,0,sizeof(render_ini));
+}
+
+static const char *ini_read(render_ini *ini,const char *section,const char *key)
+{
+	int in_section=0;
+	size_t key_len=strlen(key),section_len=strlen(section);
+
+	for(int i=0;i<ini->n_lines;i++)
+	{
+		const char *l=ini->line[i];
+		if(l[0]=='[')
+		{
+			in_section=(strncmp(l+1,section,section_len)==0 && l[section_len+1]==']');
+			continue;
+		}
+		if(in_section && strncmp(l,key,key_len)==0 && l[key_len]=='=')
+			return l+key_len+1;
+	}
+	return NULL;
+}
+
+static int ini_read(render_ini *ini,const char *section,const char *key,dword *val)
+{
+	const char *v=ini_read(ini,section,key);
+	if(!v)
+		return -1;
+	*val=(dword)strtoul(v,NULL,0);
+	return 0;
+}
+
+word graph_output_reg(render_graph *g,int channel)
+{
+	// 10k2: physical outputs 0x60..0x7f; 10k1: 0x20..0x34
+	return (word)(g->is_10k2?KX_OUT(0x60+channel):KX_OUT(channel));
+}
+
+word graph_input_reg(render_graph *g,int channel)
+{
+	return (word)(g->input_fx?KX_FX(channel):KX_IN(channel));
+}
+
+int graph_init(render_graph *g,int is_10k2,dword xtram_size,int input_fx)
+{
+	memset(g,0,sizeof(render_graph));
+	g->is_10k2=is_10k2;
+	g->xtram_size=xtram_size;
+	g->input_fx=input_fx;
+	for(int i=0;i<RENDER_MAX_CHANNELS;i++)
+		g->out_copy[i]=-1;
+	return 0;
+}
+
+void graph_close(render_graph *g)
+{
+	if(g->emu)
+		kx_emu_destroy(g->emu);
+	g->emu=NULL;
+}
+
+static int graph_create(render_graph *g)
+{
+	if(g->emu)
+		return 0;
+	if(g->is_10k2<0)
+		g->is_10k2=1;
+	if(g->xtram_size==0)
+		g->xtram_size=RENDER_XTRAM;
+	if(kx_emu_create(&g->emu,g->is_10k2,g->xtram_size))
+	{
+		fprintf(stderr,"kxrender: cannot create the DSP emulator\n");
+		return -1;
+	}
+	return 0;
+}
+
+static render_plugin *graph_plugin(render_graph *g,int pgm)
+{
+	for(int i=0;i<g->n_plugins;i++)
+		if(g->plugins[i].pgm==pgm)
+			return &g->plugins[i];
+	return NULL;
+}
+
+int graph_find_plugin(render_graph *g,const char *name)
+{
+	char *end;
+	long pgm=strtol(name,&end,0);
+	if(*end==0 && graph_plugin(g,(int)pgm))
+		return (int)pgm;
+
+	for(int i=0;i<g->n_plugins;i++)
+		if(strcmp(g->plugins[i].name,name)==0)
+			return g->plugins[i].pgm;
+	return -1;
+}
+
+static void graph_add_plugin(render_graph *g,int pgm,const char *name,const char *source)
+{
+	render_plugin *p=&g->plugins[g->n_plugins++];
+	p->pgm=pgm;
+	strncpy(p->name,name,KX_MAX_STRING-1);
+	p->source=source;
+}
+
+// connects epilog input 'channel' to output 'reg' of microcode 'pgm'
+// kx_connect_microcode() gives an output a single register: an output that goes to
+// several epilog inputs is captured once and copied
+static void graph_connect_output(render_graph *g,int channel,int pgm,word reg,int *src_pgm,word *src_reg)
+{
+	src_pgm[channel]=pgm;
+	src_reg[channel]=reg;
+
+	for(int i=0;i<channel;i++)
+		if(g->out_reg[i] && src_pgm[i]==pgm && src_reg[i]==reg)
+		{
+			g->out_copy[channel]=i;
+			return;
+		}
+
+	word out=graph_output_reg(g,channel);
+	if(kx_emu_connect_microcode(g->emu,pgm,reg,-1,out)==0)
+		g->out_reg[channel]=out;
+	else
+	{
+		fprintf(stderr,"kxrender: warning: output %d: cannot connect microcode %d register 0x%x\n",channel,pgm,reg);
+		g->warnings++;
+	}
+}
+
+int graph_load_settings(render_graph *g,const char *file_name,int n_out)
+{
+	render_ini ini;
+	if(ini_load(&ini,file_name))
+	{
+		fprintf(stderr,"kxrender: cannot read '%s'\n",file_name);
+		return -1;
+	}
+
+	dword v;
+	if(ini_read(&ini,"General","flag",&v) || !(v&KX_SAVED_DSP))
+	{
+		fprintf(stderr,"kxrender: '%s' has no DSP settings\n",file_name);
+		ini_free(&ini);
+		return -2;
+	}
+	if(g->is_10k2<0)
+	{
+		const char *dev=ini_read(&ini,"General","device_0");
+		g->is_10k2=(dev && strstr(dev,"10k1"))?0:1;
+	}
+	if(g->xtram_size==0 && ini_read(&ini,"buffers","tankmem",&v)==0)
+		g->xtram_size=v;
+	if(graph_create(g))
+	{
+		ini_free(&ini);
+		return -3;
+	}
+
+	// load the microcode
+	int epilog=0;
+	int refused=0;
+	for(int cnt=0;;cnt++)
+	{
+		char key[32],section[32];
+		dword id;
+
+		sprintf(key,"mc_%d",cnt);
+		if(ini_read(&ini,"microcode",key,&id) || id==0)
+			break;
+		sprintf(section,"pgm_%d",(int)id);
+
+		const char *guid=ini_read(&ini,section,"guid");
+		const char *name=ini_read(&ini,section,"name");
+		dword flag=0,offset=0;
+		ini_read(&ini,section,"flag",&flag);
+		ini_read(&ini,section,"offset",&offset);
+		if(!guid)
+			continue;
+		if(!name)
+			name=guid;
+
+		if(guid_in_list(guid,epilog_guids))
+		{
+			epilog=(int)id;
+			continue;
+		}
+		if(guid_in_list(guid,fxbus_guids) || !(flag&MICROCODE_TRANSLATED))
+			continue;
+
+		const kx_emu_fx *fx=kx_emu_find_fx(guid);
+		if(!fx)
+		{
+			fprintf(stderr,"kxrender: warning: '%s' (pgm %d): microcode not available; skipped\n",name,(int)id);
+			g->warnings++;
+			continue;
+		}
+
+		int pgm=kx_emu_load_fx(g->emu,fx,name,(int)id);
+		if(pgm<=0)
+		{
+			fprintf(stderr,"kxrender: warning: '%s' (pgm %d): cannot load\n",name,(int)id);
+			g->warnings++;
+			continue;
+		}
+		if(kx_emu_translate_microcode(g->emu,pgm,KX_EMU_MICROCODE_ABSOLUTE,(int)offset) &&
+		   kx_emu_translate_microcode(g->emu,pgm))
+		{
+			fprintf(stderr,"kxrender: warning: '%s' (pgm %d): not enough DSP resources\n",name,pgm);
+			kx_emu_unload_microcode(g->emu,pgm);
+			g->warnings++;
+			continue;
+		}
+		if(flag&MICROCODE_ENABLED)
+			kx_emu_enable_microcode(g->emu,pgm);
+		if(flag&MICROCODE_BYPASS)
+			kx_emu_set_microcode_bypass(g->emu,pgm,1);
+
+		// plugin parameters (p0, p1, ...) are interpreted by the plugin code, which is not available
+		// here: the microcode would run with its default register values instead
+		int params=0;
+		for(;;params++)
+		{
+			sprintf(key,"p%d",params);
+			if(!ini_read(&ini,section,key))
+				break;
+		}
+		if(params)
+		{
+			if(!g->param_defaults)
+			{
+				fprintf(stderr,"kxrender: '%s' (pgm %d): %d plugin parameters cannot be applied\n",name,pgm,params);
+				refused++;
+			}
+			else
+			{
+				fprintf(stderr,"kxrender: warning: '%s' (pgm %d): %d plugin parameters ignored; rendered with the defaults\n",
+					name,pgm,params);
+				g->warnings++;
+			}
+		}
+
+		graph_add_plugin(g,pgm,name,fx->file);
+	}
+
+	// outputs: connected before the other inputs, since connecting an output moves it
+	if(epilog)
+	{
+		int src_pgm[RENDER_MAX_CHANNELS];
+		word src_reg[RENDER_MAX_CHANNELS];
+		char section[32];
+		sprintf(section,"pgm_%d",epilog);
+		for(int i=0;i<n_out;i++)
+		{
+			char key[32];
+			const char *conn;
+			int pgm;
+			dword reg;
+
+			sprintf(key,"conn_%x",0x4000+i);
+			conn=ini_read(&ini,section,key);
+			if(conn && sscanf(conn,"%d %x",&pgm,&reg)==2 && graph_plugin(g,pgm))
+				graph_connect_output(g,i,pgm,(word)reg,src_pgm,src_reg);
+		}
+	}
+	else
+	{
+		fprintf(stderr,"kxrender: warning: no epilog: the outputs are not connected\n");
+		g->warnings++;
+	}
+	g->n_out=n_out;
+
+	// connections
+	char reported[MAX_PGM_NUMBER];
+	memset(reported,0,sizeof(reported));
+	for(int p=0;p<g->n_plugins;p++)
+	{
+		dsp_microcode *m=kx_emu_get_microcode(g->emu,g->plugins[p].pgm);
+		char section[32];
+		sprintf(section,"pgm_%d",m->pgm);
+
+		for(int i=0;i<(int)(m->info_size/sizeof(dsp_register_info));i++)
+		{
+			if((m->info[i].type&GPR_MASK)!=GPR_INPUT)
+				continue;
+
+			char key[32];
+			const char *conn;
+			int pgm;
+			dword reg;
+
+			sprintf(key,"conn_%x",m->info[i].num);
+			conn=ini_read(&ini,section,key);
+			if(!conn || sscanf(conn,"%d %x",&pgm,&reg)!=2)
+				continue;
+			if(pgm!=-1 && !graph_plugin(g,pgm))
+			{
+				if(pgm>0 && pgm<MAX_PGM_NUMBER && !reported[pgm])
+				{
+					fprintf(stderr,"kxrender: warning: inputs connected to microcode %d are left unconnected\n",pgm);
+					reported[pgm]=1;
+					g->warnings++;
+				}
+				continue;
+			}
+			kx_emu_connect_microcode(g->emu,m->pgm,m->info[i].num,pgm,(word)reg);
+		}
+	}
+
+	ini_free(&ini);
+
+	if(refused)
+	{
+		fprintf(stderr,"kxrender: %d plugins have parameters that require the plugin code; use -defaults to render them\n"
+			"          with the default register values of their microcode (and -set to change registers)\n",refused);
+		return -4;
+	}
+	return 0;
+}
+
+int graph_add_effect(render_graph *g,const char *effect)
+{
+	if(graph_create(g))
+		return -1;
+
+	int pgm;
+	const char *source;
+	char name[KX_MAX_STRING];
+	const kx_emu_fx *fx=kx_emu_find_fx(effect);
+
+	if(fx)
+	{
+		pgm=kx_emu_load_fx(g->emu,fx);
+		source=fx->file;
+		strncpy(name,fx->name,KX_MAX_STRING-1);
+		name[KX_MAX_STRING-1]=0;
+	}
+	else
+	{
+#if defined(RENDER_HAS_KXAPI)
+		dsp_code *code;
+		dsp_register_info *info;
+		int code_size,info_size,itramsize,xtramsize;
+		char guid[KX_MAX_STRING];
+
+		if(render_assemble(effect,name,&code,&code_size,&info,&info_size,&itramsize,&xtramsize,guid))
+			return -2;
+		pgm=kx_emu_load_microcode(g->emu,name,code,code_size,info,info_size,itramsize,xtramsize,
+			"","","","",guid);
+		render_free_microcode(code,info);
+		source=effect;
+#else
+		fprintf(stderr,"kxrender: '%s': not a built-in effect; .da sources are not supported on this platform\n"
+			"(they need the kX API); see kxrender -list\n",effect);
+		return -2;
+#endif
+	}
+	if(pgm<=0)
+	{
+		fprintf(stderr,"kxrender: '%s': cannot load the microcode\n",effect);
+		return -3;
+	}
+
+	// effects run in the order they are given
+	int ret=g->n_plugins?kx_emu_translate_microcode(g->emu,pgm,KX_EMU_MICROCODE_AFTER,g->plugins[g->n_plugins-1].pgm):
+		kx_emu_translate_microcode(g->emu,pgm);
+	if(ret || kx_emu_enable_microcode(g->emu,pgm))
+	{
+		fprintf(stderr,"kxrender: '%s': not enough DSP resources\n",effect);
+		return -4;
+	}
+	graph_add_plugin(g,pgm,name,source);
+	return 0;
+}
+
+// chain: input channels -> first effect -> ... -> last effect -> output channels
+// the n-th input of an effect is connected to the n-th output of the previous one
+int graph_connect_chain(render_graph *g,int n_in,int n_out)
+{
+	for(int p=0;p<g->n_plugins;p++)
+	{
+		dsp_microcode *m=kx_emu_get_microcode(g->emu,g->plugins[p].pgm);
+		dsp_microcode *prev=p?kx_emu_get_microcode(g->emu,g->plugins[p-1].pgm):NULL;
+		int n_info=(int)(m->info_size/sizeof(dsp_register_info));
+		int in=0,out=0,prev_out=0;
+
+		for(int i=0;i<n_info;i++)
+		{
+			int type=m->info[i].type&GPR_MASK;
+			if(type==GPR_INPUT)
+			{
+				if(!prev)
+				{
+					if(in<n_in)
+						kx_emu_connect_microcode(g->emu,-1,graph_input_reg(g,in),m->pgm,m->info[i].num);
+				}
+				else
+				{
+					// find the next output of the previous effect
+					int n_prev=(int)(prev->info_size/sizeof(dsp_register_info));
+					while(prev_out<n_prev && (prev->info[prev_out].type&GPR_MASK)!=GPR_OUTPUT)
+						prev_out++;
+					if(prev_out<n_prev)
+					{
+						kx_emu_connect_microcode(g->emu,prev->pgm,prev->info[prev_out].num,m->pgm,m->info[i].num);
+						prev_out++;
+					}
+				}
+				in++;
+			}
+			if(type==GPR_OUTPUT && p==g->n_plugins-1)
+			{
+				if(n_out<=0 || out<n_out)
+				{
+					if(out<RENDER_MAX_CHANNELS && kx_emu_connect_microcode(g->emu,m->pgm,m->info[i].num,-1,graph_output_reg(g,out))==0)
+						g->out_reg[out]=graph_output_reg(g,out);
+				}
+				out++;
+			}
+		}
+		if(p==g->n_plugins-1)
+			g->n_out=(n_out>0)?n_out:(out<RENDER_MAX_CHANNELS?out:RENDER_MAX_CHANNELS);
+	}
+	return 0;
+}
+
+int graph_set_register(render_graph *g,const char *assignment)
+{
+	char plugin[KX_MAX_STRING],reg[KX_MAX_STRING];
+	const char *dot=strchr(assignment,'.');
+	const char *eq=strchr(assignment,'=');
+
+	if(!dot || !eq || eq<dot || dot-assignment>=KX_MAX_STRING || eq-dot>KX_MAX_STRING)
+	{
+		fprintf(stderr,"kxrender: -set %s: expected <plugin>.<register>=<value>\n",assignment);
+		return -1;
+	}
+	memcpy(plugin,assignment,dot-assignment);
+	plugin[dot-assignment]=0;
+	memcpy(reg,dot+1,eq-dot-1);
+	reg[eq-dot-1]=0;
+
+	// values with a decimal point are fractions: 0.5 = 0x40000000
+	dword val;
+	if(strchr(eq+1,'.'))
+	{
+		double d=atof(eq+1)*2147483648.0;
+		val=(d>=2147483647.0)?0x7fffffff:(d<=-2147483648.0?0x80000000:(dword)(int)d);
+	}
+	else
+		val=(dword)strtoul(eq+1,NULL,0);
+
+	int pgm=graph_find_plugin(g,plugin);
+	if(pgm<0 || kx_emu_set_dsp_register(g->emu,pgm,reg,val))
+	{
+		fprintf(stderr,"kxrender: -set %s: no such plugin or register\n",assignment);
+		return -2;
+	}
+	return 0;
+}
@@ -0,0 +1,305 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// kxrender: offline rendering of kX DSP configurations
+// usage: see usage() below
+// the input is streamed through the DSP emulator one block at a time, so memory use does not
+// depend on the length of the files
+
+#include "kxrender.h"
+
+#if defined(WIN32)
+	#include <windows.h>
+#else
+	#include <time.h>
+	#include <sys/time.h>
+#endif
+
+double render_time(void)
+{
+#if defined(WIN32)
+	LARGE_INTEGER f,c;
+	QueryPerformanceFrequency(&f);
+	QueryPerformanceCounter(&c);
+	return (double)c.QuadPart/(double)f.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv,NULL);
+	return (double)tv.tv_sec+(double)tv.tv_usec/1000000.0;
+#endif
+}
+
+static void usage(void)
+{
+	printf("usage: kxrender [options] <settings.kx | effect ...> <input.wav> <output.wav>\n"
+	       "  settings.kx        kX Mixer settings file: the saved DSP configuration is rendered;\n"
+	       "                     output channel n is epilog input n\n"
+	       "  effect             .da source or effect library name / GUID (see -list); several effects\n"
+	       "                     are chained: input n of an effect takes output n of the previous one\n"
+	       "options:\n"
+	       "  -10k1, -10k2       DSP model (default: as saved in the settings file; 10k2)\n"
+	       "  -input fx|in       input channel n feeds FXBus n (default) or physical input n\n"
+	       "  -outputs <n>       number of output channels (default: input channels for .kx files,\n"
+	       "                     outputs of the last effect otherwise)\n"
+	       "  -format <f>        output format: 16, 24, 32 or float (default: same as the input)\n"
+	       "  -block <n>         sample periods per DSP call (default: %d)\n"
+	       "  -tail <n>          sample periods of silence to render after the input (reverb tails)\n"
+	       "  -tram <n>          external TRAM size, KB (default: as saved; %d)\n"
+	       "  -engine interp|jit DSP emulator engine (default: jit)\n"
+	       "  -set <p>.<r>=<v>   sets register <r> of plugin <p> (pgm id or name); 0.5 is 0x40000000\n"
+	       "  -defaults          renders .kx plugins with stored parameters using the default register\n"
+	       "                     values of their microcode (the parameters need the plugin code); without\n"
+	       "                     it, such settings files are refused\n"
+	       "  -list              lists the built-in effect library\n",
+	       RENDER_BLOCK,RENDER_XTRAM/1024);
+}
+
+static void list_effects(void)
+{
+	printf("%-24s %-38s %6s  %s\n","name","guid","code","source");
+	for(int i=0;kx_emu_fx_library[i].name;i++)
+	{
+		const kx_emu_fx *fx=&kx_emu_fx_library[i];
+		printf("%-24s %-38s %6d  %s\n",fx->name,fx->guid?fx->guid:"-",fx->code_size,fx->file);
+	}
+}
+
+static int has_extension(const char *name,const char *ext)
+{
+	size_t l=strlen(name),e=strlen(ext);
+	if(l<e)
+		return 0;
+	for(size_t i=0;i<e;i++)
+		if((name[l-e+i]|0x20)!=ext[i])
+			return 0;
+	return 1;
+}
+
+static void report(render_graph *g,__int64 frames,int rate,double t_dsp,double t_total)
+{
+	kx_emu *emu=g->emu;
+	__int64 total=0;
+	int total_size=0;
+
+	printf("\n%-28s %5s %7s %12s %12s\n","plugin","pgm","instr","executed","skipped");
+	for(int i=0;i<g->n_plugins;i++)
+	{
+		kx_emu_pgm_stats st;
+		if(kx_emu_get_stats(emu,g->plugins[i].pgm,&st))
+			continue;
+		printf("%-28s %5d %7d %12.2f %12.2f\n",g->plugins[i].name,g->plugins[i].pgm,(int)st.code_size,
+			frames?(double)st.executed/(double)frames:0.0,frames?(double)st.skipped/(double)frames:0.0);
+		total+=st.executed;
+		total_size+=st.code_size;
+	}
+	printf("%-28s %5s %7d %12.2f   (instructions per sample period; %d available)\n","total","",total_size,
+		frames?(double)total/(double)frames:0.0,emu->microcode_size);
+
+	printf("\n%lld sample periods (%.2f s at %d Hz)\n",(long long)frames,rate?(double)frames/rate:0.0,rate);
+	if(t_dsp>0.0)
+		printf("DSP:   %.3f s, %.0f samples/s, %.1fx real time\n",t_dsp,(double)frames/t_dsp,
+			rate?(double)frames/t_dsp/rate:0.0);
+	if(t_total>0.0)
+		printf("total: %.3f s, %.0f samples/s (including file i/o)\n",t_total,(double)frames/t_total);
+}
+
+int main(int argc,char **argv)
+{
+	int is_10k2=-1,input_fx=1,n_out=0,block=RENDER_BLOCK,engine=KX_EMU_ENGINE_JIT;
+	int out_bits=0,out_format=0,param_defaults=0;
+	__int64 tail=0;
+	dword xtram=0;
+	const char *args[MAX_PGM_NUMBER+2];
+	const char *sets[64];
+	int n_args=0,n_sets=0;
+
+	for(int i=1;i<argc;i++)
+	{
+		const char *a=argv[i];
+		const char *v=(i+1<argc)?argv[i+1]:NULL;
+
+		if(strcmp(a,"-10k1")==0) is_10k2=0;
+		else if(strcmp(a,"-10k2")==0) is_10k2=1;
+		else if(strcmp(a,"-list")==0) { list_effects(); return 0; }
+		else if(strcmp(a,"-defaults")==0) param_defaults=1;
+		else if(a[0]=='-' && a[1] && !v)
+		{
+			fprintf(stderr,"kxrender: %s: value expected\n",a);
+			return 1;
+		}
+		else if(strcmp(a,"-input")==0) { input_fx=(strcmp(v,"in")!=0); i++; }
+		else if(strcmp(a,"-outputs")==0) { n_out=atoi(v); i++; }
+		else if(strcmp(a,"-block")==0) { block=atoi(v); i++; }
+		else if(strcmp(a,"-tail")==0) { tail=atoi(v); i++; }
+		else if(strcmp(a,"-tram")==0) { xtram=(dword)atoi(v)*1024; i++; }
+		else if(strcmp(a,"-engine")==0) { engine=strcmp(v,"jit")?KX_EMU_ENGINE_INTERP:KX_EMU_ENGINE_JIT; i++; }
+		else if(strcmp(a,"-format")==0)
+		{
+			if(strcmp(v,"float")==0) { out_format=WAV_FORMAT_FLOAT; out_bits=32; }
+			else { out_format=WAV_FORMAT_PCM; out_bits=atoi(v); }
+			i++;
+		}
+		else if(strcmp(a,"-set")==0)
+		{
+			if(n_sets<(int)(sizeof(sets)/sizeof(sets[0])))
+				sets[n_sets++]=v;
+			i++;
+		}
+		else if(a[0]=='-' && a[1])
+		{
+			fprintf(stderr,"kxrender: unknown option '%s'\n",a);
+			return 1;
+		}
+		else if(n_args<(int)(sizeof(args)/sizeof(args[0])))
+			args[n_args++]=a;
+	}
+
+	if(n_args<3)
+	{
+		usage();
+		return 1;
+	}
+	if(block<=0 || block>65536 || n_out<0 || n_out>RENDER_MAX_CHANNELS ||
+	   (out_format==WAV_FORMAT_PCM && out_bits!=16 && out_bits!=24 && out_bits!=32))
+	{
+		fprintf(stderr,"kxrender: invalid option value\n");
+		return 1;
+	}
+
+	const char *in_name=args[n_args-2],*out_name=args[n_args-1];
+	wav_file in,out;
+	if(wav_open_read(&in,in_name))
+		return 2;
+
+	// DSP graph
+	render_graph g;
+	int ret=0;
+	graph_init(&g,is_10k2,xtram,input_fx);
+	g.param_defaults=param_defaults;
+
+	if(n_args==3 && has_extension(args[0],".kx"))
+		ret=graph_load_settings(&g,args[0],n_out?n_out:in.channels);
+	else
+	{
+		for(int i=0;i<n_args-2 && ret==0;i++)
+			ret=graph_add_effect(&g,args[i]);
+		if(ret==0)
+			ret=graph_connect_chain(&g,in.channels,n_out);
+	}
+	for(int i=0;i<n_sets && ret==0;i++)
+		ret=graph_set_register(&g,sets[i]);
+
+	int max_in=g.input_fx?(g.is_10k2?64:16):(g.is_10k2?15:16);
+	int max_out=g.is_10k2?32:21;
+	if(ret==0 && (in.channels>max_in || g.n_out>max_out || g.n_out<=0))
+	{
+		fprintf(stderr,"kxrender: %d input / %d output channels are not supported (%d / %d max)\n",
+			in.channels,g.n_out,max_in,max_out);
+		ret=-1;
+	}
+	if(ret)
+	{
+		graph_close(&g);
+		wav_close(&in);
+		return 3;
+	}
+	kx_emu_set_engine(g.emu,engine);
+
+	if(out_format==0)
+	{
+		out_format=in.format;
+		out_bits=in.bits;
+	}
+	if(wav_open_write(&out,out_name,out_format,g.n_out,in.rate,out_bits))
+	{
+		graph_close(&g);
+		wav_close(&in);
+		return 4;
+	}
+
+	printf("kxrender: %s: %d plugins, %s, %d -> %d channels, %d Hz\n",n_args==3?args[0]:"chain",g.n_plugins,
+		g.is_10k2?"10k2":"10k1",in.channels,g.n_out,in.rate);
+
+	// i/o buffers: one block
+	dword *in_buf=(dword *)calloc(block*in.channels,sizeof(dword));
+	dword *out_buf=(dword *)calloc(block*g.n_out,sizeof(dword));
+	if(!in_buf || !out_buf)
+	{
+		fprintf(stderr,"kxrender: not enough memory\n");
+		ret=-1;
+	}
+	else
+	{
+		for(int i=0;i<in.channels;i++)
+			kx_emu_bind_input(g.emu,graph_input_reg(&g,i),in_buf+i,in.channels);
+		for(int i=0;i<g.n_out;i++)
+			if(g.out_reg[i] && g.out_copy[i]<0)
+				kx_emu_bind_output(g.emu,g.out_reg[i],out_buf+i,g.n_out);
+	}
+
+	__int64 frames=0;
+	double t_dsp=0.0,t_start=render_time();
+	while(ret==0)
+	{
+		int n=wav_read(&in,in_buf,block);
+		if(n<=0)
+		{
+			if(tail<=0)
+				break;
+			n=(tail<block)?(int)tail:block;
+			memset(in_buf,0,n*in.channels*sizeof(dword));
+			tail-=n;
+		}
+
+		double t=render_time();
+		kx_emu_process(g.emu,n);
+		t_dsp+=render_time()-t;
+
+		for(int i=0;i<g.n_out;i++)
+			if(g.out_copy[i]>=0)
+				for(int j=0;j<n;j++)
+					out_buf[j*g.n_out+i]=out_buf[j*g.n_out+g.out_copy[i]];
+
+		if(wav_write(&out,out_buf,n))
+		{
+			fprintf(stderr,"kxrender: error writing '%s'\n",out_name);
+			ret=-1;
+		}
+		frames+=n;
+	}
+	double t_total=render_time()-t_start;
+
+	int rate=in.rate;
+	if(wav_close(&out) && ret==0)
+	{
+		fprintf(stderr,"kxrender: error writing '%s'\n",out_name);
+		ret=-1;
+	}
+	wav_close(&in);
+
+	if(ret==0)
+		report(&g,frames,rate,t_dsp,t_total);
+
+	free(in_buf);
+	free(out_buf);
+	graph_close(&g);
+
+	return ret?5:0;
+}
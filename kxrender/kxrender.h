@@ -0,0 +1,121 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// kxrender: runs a kX DSP configuration on the host DSP emulator (kxemu) over WAV files
+// the DSP graph is built either from a kX Mixer settings file (.kx; see kxmixer/settings.cpp)
+// or from a chain of effects (.da sources, effect library names)
+
+#ifndef KXRENDER_H_
+#define KXRENDER_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "emu/kxemu.h"
+#include "emu/emufx.h"
+
+#define RENDER_MAX_CHANNELS	32
+#define RENDER_BLOCK		1024		// default sample periods per kx_emu_process()
+#define RENDER_XTRAM		(256*1024)	// default external TRAM size, bytes
+
+// wavfile.cpp: streaming WAV i/o
+// samples are exchanged as interleaved DSP words (32-bit, left-justified)
+#define WAV_FORMAT_PCM		1
+#define WAV_FORMAT_FLOAT	3
+
+typedef struct
+{
+	FILE *f;
+	int write;
+	int format;			// WAV_FORMAT_xxx
+	int channels;
+	int rate;
+	int bits;			// 16, 24, 32 (PCM); 32 (float)
+	int frame_size;			// bytes
+	__int64 frames;			// read: frames in the data chunk; write: frames written
+	__int64 pos;			// read: frames read so far
+	long data_offset;		// file offset of the data chunk size
+	byte *buf;			// conversion buffer: 'buf_frames' frames
+	int buf_frames;
+}wav_file;
+
+int wav_open_read(wav_file *w,const char *name);
+int wav_open_write(wav_file *w,const char *name,int format,int channels,int rate,int bits);
+int wav_read(wav_file *w,dword *out,int frames);	// returns the number of frames read
+int wav_write(wav_file *w,const dword *in,int frames);
+int wav_close(wav_file *w);				// patches the header of the output file
+
+// graph.cpp: DSP graph
+typedef struct
+{
+	int pgm;
+	char name[KX_MAX_STRING];
+	const char *source;		// library file or .da source
+}render_plugin;
+
+typedef struct
+{
+	kx_emu *emu;
+	int is_10k2;			// -1: not known yet
+	dword xtram_size;		// bytes
+
+	render_plugin plugins[MAX_PGM_NUMBER];
+	int n_plugins;
+
+	// host i/o: input channel i feeds in_reg[i]; output channel i is read from out_reg[i]
+	// output channels that share a source are copied from channel out_copy[i] (-1: none)
+	int n_in,n_out;
+	word in_reg[RENDER_MAX_CHANNELS];
+	word out_reg[RENDER_MAX_CHANNELS];
+	int out_copy[RENDER_MAX_CHANNELS];
+	int input_fx;			// inputs: 1: FXBus, 0: physical inputs
+
+	// .kx plugins with stored parameters: 1: rendered with the defaults of their microcode;
+	// 0: refused (graph_load_settings() fails)
+	int param_defaults;
+
+	int warnings;
+}render_graph;
+
+int graph_init(render_graph *g,int is_10k2,dword xtram_size,int input_fx);
+void graph_close(render_graph *g);
+int graph_load_settings(render_graph *g,const char *file_name,int n_out);
+int graph_add_effect(render_graph *g,const char *effect);
+int graph_connect_chain(render_graph *g,int n_in,int n_out);
+int graph_set_register(render_graph *g,const char *assignment);	// "<pgm or name>.<register>=<value>"
+int graph_find_plugin(render_graph *g,const char *name);
+word graph_output_reg(render_graph *g,int channel);
+word graph_input_reg(render_graph *g,int channel);
+
+// assemble.cpp: .da sources (iKX::assemble_microcode); kxapi is only available for Windows and OS X
+// (RENDER_NO_KXAPI: built without it, see CMakeLists.txt)
+#if (defined(WIN32) || defined(__APPLE__)) && !defined(RENDER_NO_KXAPI)
+	#define RENDER_HAS_KXAPI
+#endif
+#if defined(RENDER_HAS_KXAPI)
+int render_assemble(const char *file_name,char *name,dsp_code **code,int *code_size,
+	dsp_register_info **info,int *info_size,int *itramsize,int *xtramsize,char *guid);
+void render_free_microcode(dsp_code *code,dsp_register_info *info);
+#endif
+
+double render_time(void);
+
+#endif
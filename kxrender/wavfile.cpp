@@ -0,0 +1,273 @@
+// kX Driver
+// Copyright (c) Eugene Gavrilov, 2001-2014.
+// All rights reserved
+
+/*
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307 USA
+ */
+
+// streaming WAV i/o: PCM 16/24/32-bit and 32-bit float, WAVE_FORMAT_EXTENSIBLE
+// only one block of frames is kept in memory at a time
+
+#include "kxrender.h"
+
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+
+static dword get_le(const byte *p,int n)
+{
+	dword v=0;
+	for(int i=n-1;i>=0;i--)
+		v=(v<<8)|p[i];
+	return v;
+}
+
+static void put_le(byte *p,dword v,int n)
+{
+	for(int i=0;i<n;i++,v>>=8)
+		p[i]=(byte)v;
+}
+
+static int alloc_buffer(wav_file *w,int frames)
+{
+	if(w->buf_frames>=frames)
+		return 0;
+	free(w->buf);
+	w->buf=(byte *)malloc(frames*w->frame_size);
+	w->buf_frames=w->buf?frames:0;
+	return w->buf?0:-1;
+}
+
+int wav_open_read(wav_file *w,const char *name)
+{
+	memset(w,0,sizeof(wav_file));
+
+	w->f=fopen(name,"rb");
+	if(!w->f)
+	{
+		fprintf(stderr,"kxrender: cannot open '%s'\n",name);
+		return -1;
+	}
+
+	byte hdr[40];
+	if(fread(hdr,1,12,w->f)!=12 || memcmp(hdr,"RIFF",4) || memcmp(hdr+8,"WAVE",4))
+	{
+		fprintf(stderr,"kxrender: '%s' is not a WAV file\n",name);
+		wav_close(w);
+		return -2;
+	}
+
+	int have_fmt=0;
+	while(fread(hdr,1,8,w->f)==8)
+	{
+		dword size=get_le(hdr+4,4);
+
+		if(memcmp(hdr,"fmt ",4)==0)
+		{
+			if(size<16 || fread(hdr,1,size<40?size:40,w->f)!=(size<40?size:40))
+				break;
+			if(size>40)
+				fseek(w->f,size-40,SEEK_CUR);
+			if(size&1)
+				fseek(w->f,1,SEEK_CUR);
+
+			w->format=get_le(hdr,2);
+			w->channels=get_le(hdr+2,2);
+			w->rate=get_le(hdr+4,4);
+			w->bits=get_le(hdr+14,2);
+			if(w->format==WAV_FORMAT_EXTENSIBLE && size>=40)
+				w->format=get_le(hdr+24,2);	// sub-format GUID: the first two bytes
+			have_fmt=1;
+			continue;
+		}
+		if(memcmp(hdr,"data",4)==0 && have_fmt)
+		{
+			if(!((w->format==WAV_FORMAT_PCM && (w->bits==16 || w->bits==24 || w->bits==32)) ||
+			     (w->format==WAV_FORMAT_FLOAT && w->bits==32)) ||
+			   w->channels<=0 || w->channels>RENDER_MAX_CHANNELS)
+			{
+				fprintf(stderr,"kxrender: '%s': unsupported format (format %d, %d bits, %d channels)\n",
+					name,w->format,w->bits,w->channels);
+				wav_close(w);
+				return -3;
+			}
+			w->frame_size=w->channels*w->bits/8;
+			w->frames=size/w->frame_size;
+			return 0;
+		}
+		fseek(w->f,size+(size&1),SEEK_CUR);
+	}
+
+	fprintf(stderr,"kxrender: '%s': no audio data\n",name);
+	wav_close(w);
+	return -4;
+}
+
+int wav_open_write(wav_file *w,const char *name,int format,int channels,int rate,int bits)
+{
+	memset(w,0,sizeof(wav_file));
+
+	w->f=fopen(name,"wb");
+	if(!w->f)
+	{
+		fprintf(stderr,"kxrender: cannot create '%s'\n",name);
+		return -1;
+	}
+	w->write=1;
+	w->format=format;
+	w->channels=channels;
+	w->rate=rate;
+	w->bits=bits;
+	w->frame_size=channels*bits/8;
+
+	// sizes are patched by wav_close()
+	byte hdr[44];
+	memcpy(hdr,"RIFF",4);
+	put_le(hdr+4,0,4);
+	memcpy(hdr+8,"WAVEfmt ",8);
+	put_le(hdr+16,16,4);
+	put_le(hdr+20,format,2);
+	put_le(hdr+22,channels,2);
+	put_le(hdr+24,rate,4);
+	put_le(hdr+28,rate*w->frame_size,4);
+	put_le(hdr+32,w->frame_size,2);
+	put_le(hdr+34,bits,2);
+	memcpy(hdr+36,"data",4);
+	put_le(hdr+40,0,4);
+	w->data_offset=40;
+
+	if(fwrite(hdr,1,44,w->f)!=44)
+	{
+		fprintf(stderr,"kxrender: error writing '%s'\n",name);
+		wav_close(w);
+		return -2;
+	}
+	return 0;
+}
+
+int wav_read(wav_file *w,dword *out,int frames)
+{
+	if(frames>w->frames-w->pos)
+		frames=(int)(w->frames-w->pos);
+	if(frames<=0 || alloc_buffer(w,frames))
+		return 0;
+
+	frames=(int)fread(w->buf,w->frame_size,frames,w->f);
+	w->pos+=frames;
+
+	int n=frames*w->channels;
+	const byte *p=w->buf;
+	switch(w->bits)
+	{
+		case 16:
+			for(int i=0;i<n;i++,p+=2)
+				out[i]=get_le(p,2)<<16;
+			break;
+		case 24:
+			for(int i=0;i<n;i++,p+=3)
+				out[i]=get_le(p,3)<<8;
+			break;
+		default:
+			if(w->format==WAV_FORMAT_PCM)
+			{
+				for(int i=0;i<n;i++,p+=4)
+					out[i]=get_le(p,4);
+			}
+			else
+			{
+				for(int i=0;i<n;i++,p+=4)
+				{
+					dword v=get_le(p,4);
+					float f;
+					memcpy(&f,&v,sizeof(f));
+					double d=(double)f*2147483648.0;
+					if(d>=2147483647.0)
+						out[i]=0x7fffffff;
+					else if(d<=-2147483648.0)
+						out[i]=0x80000000;
+					else
+						out[i]=(dword)(int)d;
+				}
+			}
+			break;
+	}
+	return frames;
+}
+
+int wav_write(wav_file *w,const dword *in,int frames)
+{
+	if(frames<=0)
+		return 0;
+	if(alloc_buffer(w,frames))
+		return -1;
+
+	int n=frames*w->channels;
+	byte *p=w->buf;
+	switch(w->bits)
+	{
+		case 16:
+			for(int i=0;i<n;i++,p+=2)
+				put_le(p,in[i]>>16,2);
+			break;
+		case 24:
+			for(int i=0;i<n;i++,p+=3)
+				put_le(p,in[i]>>8,3);
+			break;
+		default:
+			if(w->format==WAV_FORMAT_PCM)
+			{
+				for(int i=0;i<n;i++,p+=4)
+					put_le(p,in[i],4);
+			}
+			else
+			{
+				for(int i=0;i<n;i++,p+=4)
+				{
+					float f=(float)((double)(int)in[i]/2147483648.0);
+					dword v;
+					memcpy(&v,&f,sizeof(v));
+					put_le(p,v,4);
+				}
+			}
+			break;
+	}
+
+	if(fwrite(w->buf,w->frame_size,frames,w->f)!=(size_t)frames)
+		return -1;
+	w->frames+=frames;
+	return 0;
+}
+
+int wav_close(wav_file *w)
+{
+	int ret=0;
+
+	if(w->f && w->write)
+	{
+		byte b[4];
+		dword data_size=(dword)(w->frames*w->frame_size);
+
+		put_le(b,data_size+36,4);
+		if(fseek(w->f,4,SEEK_SET) || fwrite(b,1,4,w->f)!=4)
+			ret=-1;
+		put_le(b,data_size,4);
+		if(fseek(w->f,w->data_offset,SEEK_SET) || fwrite(b,1,4,w->f)!=4)
+			ret=-1;
+	}
+	if(w->f && fclose(w->f))
+		ret=-1;
+	free(w->buf);
+	memset(w,0,sizeof(wav_file));
+	return ret;
+}
@@ -207,6 +207,25 @@ IOReturn kXUserClient::clientDied( void )
     return result;
 }
 
+// IOConnectMapMemory(): the telemetry page (read-only)
+IOReturn kXUserClient::clientMemoryForType( UInt32 type, IOOptionBits *options, IOMemoryDescriptor **memory )
+{
+	if(device==NULL || isInactive())
+		return kIOReturnNotAttached;
+	
+	if(type!=kTelemetryMemory)
+		return kIOReturnBadArgument;
+	
+	IOMemoryDescriptor *mem=device->get_telemetry_memory();
+	if(mem==NULL)
+		return kIOReturnNoMemory;
+	
+	*options=kIOMapReadOnly;
+	*memory=mem; // the reference is passed to IOKit
+	
+	return kIOReturnSuccess;
+}
+
 // willTerminate is called at the beginning of the termination process. It is a notification
 // that a provider has been terminated, sent before recursing up the stack, in root-to-leaf order.
 //
@@ -291,6 +310,7 @@ IOReturn kXUserClient::closeUserClient(void)
 		// debug(DBGCLASS"[%p]::closeUserClient()\n", this);
 		
 		// Make sure we're the one who opened our provider before we tell it to close.
+		device->client_closed(this);
 		device->close(this);
 	}
 	else {
@@ -304,11 +324,80 @@ IOReturn kXUserClient::closeUserClient(void)
 #if !defined(USE_TIGER_IPC)
 IOReturn kXUserClient::sStructIStructO(kXUserClient* target, void* reference, IOExternalMethodArguments* arguments)
 {
+	// structures over 4096 bytes (io_struct_inband_t) are passed as memory descriptors
+	if(arguments->structureInputDescriptor || arguments->structureOutputDescriptor)
+		return target->StructIStructODescriptor(arguments);
+
     return target->StructIStructO(arguments->structureInput,
 								  arguments->structureOutput,
 								  (uint32_t) arguments->structureInputSize,
 								  (const uint32_t*) &arguments->structureOutputSize);
 }
+
+// e.g. KX_PROP_SOUNDFONT_LOAD_SMPL blocks (KX_SF_UPLOAD_CHUNK) and microcode: copied in and out of kernel buffers
+IOReturn kXUserClient::StructIStructODescriptor(IOExternalMethodArguments* arguments)
+{
+	IOMemoryDescriptor *in_desc=arguments->structureInputDescriptor;
+	IOMemoryDescriptor *out_desc=arguments->structureOutputDescriptor;
+	uint32_t in_size=in_desc?(uint32_t)in_desc->getLength():arguments->structureInputSize;
+	uint32_t out_size=out_desc?(uint32_t)out_desc->getLength():arguments->structureOutputSize;
+	IOReturn result;
+	
+	#define MAX_STRUCT_SIZE (1024*1024)
+	if(in_size>MAX_STRUCT_SIZE || out_size>MAX_STRUCT_SIZE)
+		return kIOReturnBadArgument;
+	
+	void *in=IOMalloc(in_size+1);
+	void *out=IOMalloc(out_size+1);
+	if(in==NULL || out==NULL)
+	{
+		if(in) IOFree(in,in_size+1);
+		if(out) IOFree(out,out_size+1);
+		return kIOReturnNoMemory;
+	}
+	bzero(out,out_size);
+	
+	if(in_desc)
+	{
+		result=in_desc->prepare(kIODirectionOut);
+		if(result==kIOReturnSuccess)
+		{
+			if(in_desc->readBytes(0,in,in_size)!=in_size)
+				result=kIOReturnVMError;
+			in_desc->complete(kIODirectionOut);
+		}
+	}
+	else
+	{
+		memcpy(in,arguments->structureInput,in_size);
+		result=kIOReturnSuccess;
+	}
+	
+	if(result==kIOReturnSuccess)
+		result=StructIStructO(in,out,in_size,&out_size);
+	
+	if(result==kIOReturnSuccess)
+	{
+		if(out_desc)
+		{
+			result=out_desc->prepare(kIODirectionIn);
+			if(result==kIOReturnSuccess)
+			{
+				if(out_desc->writeBytes(0,out,out_size)!=out_size)
+					result=kIOReturnVMError;
+				out_desc->complete(kIODirectionIn);
+			}
+			arguments->structureOutputDescriptorSize=out_size;
+		}
+		else
+			memcpy(arguments->structureOutput,out,out_size);
+	}
+	
+	IOFree(in,in_size+1);
+	IOFree(out,out_size+1);
+	
+	return result;
+}
 #endif
 
 
@@ -331,7 +420,7 @@ IOReturn kXUserClient::StructIStructO(const void* inStruct, void* outStruct,uint
 	}
 	else
 	{
-		result = device->user_request(inStruct, outStruct, inStructSize, outStructSize);
+		result = device->user_request(this, inStruct, outStruct, inStructSize, outStructSize);
 	}
     
     return result;
@@ -49,6 +49,7 @@ class kXUserClient : public IOUserClient
 		virtual bool initWithTask( task_t owningTask, void * securityID, UInt32 type,  OSDictionary * properties );
 		virtual IOReturn clientClose( void );
 		virtual IOReturn clientDied( void );
+		virtual IOReturn clientMemoryForType( UInt32 type, IOOptionBits *options, IOMemoryDescriptor **memory );
 		
 		#if defined(USE_TIGER_IPC)
 		// get methods (10.4)
@@ -62,6 +63,7 @@ class kXUserClient : public IOUserClient
 		static IOReturn sOpenUserClient(kXUserClient* target, void* reference, IOExternalMethodArguments* arguments);
 		static IOReturn sCloseUserClient(kXUserClient* target, void* reference, IOExternalMethodArguments* arguments);
 		static IOReturn sStructIStructO(kXUserClient* target, void* reference, IOExternalMethodArguments* arguments);
+		virtual IOReturn StructIStructODescriptor(IOExternalMethodArguments* arguments);
 		#endif
 	
 		// implementation
@@ -48,6 +48,9 @@ bool kXAudioDevice::init(OSDictionary *dictionary)
     
     engine=NULL;
     
+    telemetry_buffer=NULL;
+    telemetry_lock=IOLockAlloc();
+    
     fpga_fw=0;
     fpga_fw_offset=0;
     fpga_fw_size=0;
@@ -175,6 +178,7 @@ bool kXAudioDevice::initHardware(IOService *provider)
     cb.rest_fpu_state=&kXAudioDevice::rest_fpu_state;
     cb.sync=&kXAudioDevice::sync;
     cb.usleep=&kXAudioDevice::usleep;
+    cb.time_ms=&kXAudioDevice::time_ms;
     
     // default parameters:
     kx_defaults(NULL,&cb);
@@ -265,6 +269,32 @@ void kXAudioDevice::stop(IOService *provider)
     super::stop(provider);
 }
 
+// the page is allocated on the first request; the mappings are released by IOKit with the client task
+IOMemoryDescriptor *kXAudioDevice::get_telemetry_memory()
+{
+    if(hw==NULL || telemetry_lock==NULL)
+        return NULL;
+    
+    IOLockLock(telemetry_lock);
+    if(telemetry_buffer==NULL)
+    {
+        IOBufferMemoryDescriptor *buff=IOBufferMemoryDescriptor::withOptions(kIODirectionInOut|kIOMemoryKernelUserShared,
+                                                                             PAGE_SIZE,PAGE_SIZE);
+        if(buff)
+        {
+            if(kx_telemetry_attach(hw,(kx_telemetry_page *)buff->getBytesNoCopy())==0)
+                telemetry_buffer=buff;
+            else
+                buff->release();
+        }
+    }
+    if(telemetry_buffer)
+        telemetry_buffer->retain(); // released by the caller
+    IOLockUnlock(telemetry_lock);
+    
+    return telemetry_buffer;
+}
+
 void kXAudioDevice::free()
 {
     debug(DBGCLASS"[%p]::free()\n", this);
@@ -288,6 +318,21 @@ void kXAudioDevice::free()
         interruptEventSource = NULL;
     }
     
+    if(hw)
+        kx_telemetry_attach(hw,NULL);
+    
+    if(telemetry_buffer)
+    {
+        telemetry_buffer->release();
+        telemetry_buffer=NULL;
+    }
+    
+    if(telemetry_lock)
+    {
+        IOLockFree(telemetry_lock);
+        telemetry_lock=NULL;
+    }
+    
     if(hw)
     {
         if((hw->initialized&KX_DEVICE_INITED) && !(hw->initialized&KX_ENGINE_INITED))
@@ -793,7 +838,29 @@ IOReturn kXAudioDevice::inputMuteChanged(IOAudioControl *muteControl, SInt32 old
 #define prep_in(type) type *in; in=(type *)(((dword *)inStruct+1));
 #define prep_out(type) type *out; out=(type *)(((dword *)outStruct+1));
 
-IOReturn kXAudioDevice::user_request(const void* inStruct, void* outStruct,uint32_t inStructSize, const uint32_t* outStructSize)
+IOReturn kXAudioDevice::user_request(void *client,const void* inStruct, void* outStruct,uint32_t inStructSize, const uint32_t* outStructSize)
+{
+    // the microcode and DSP register requests of the owner of a DSP transaction become part of it
+    // (see dsp.cpp); other requests do not touch the DSP
+    if(inStructSize<sizeof(dword))
+        return kIOReturnInvalid;
+    dword prop=(*(dword *)inStruct)&0xfffff; // function # (see process_request())
+    if(prop<KX_PROP_DSP_REGISTER_NAME || prop>KX_PROP_UPDATE_MICROCODE)
+        return process_request(client,inStruct,outStruct,inStructSize,outStructSize);
+    
+    kx_dsp_enter(hw,client);
+    IOReturn ret=process_request(client,inStruct,outStruct,inStructSize,outStructSize);
+    kx_dsp_leave(hw,client);
+    return ret;
+}
+
+void kXAudioDevice::client_closed(void *client)
+{
+    kx_telemetry_release(hw,client);
+    kx_dsp_release(hw,client);
+}
+
+IOReturn kXAudioDevice::process_request(void *client,const void* inStruct, void* outStruct,uint32_t inStructSize, const uint32_t* outStructSize)
 {
     // first part is 'prop', the rest is data struct
     // prop is:
@@ -1272,6 +1339,27 @@ IOReturn kXAudioDevice::user_request(const void* inStruct, void* outStruct,uint3
             }
         }
             break;
+        case KX_PROP_DSP_REGISTERS+KX_PROP_GET:
+        {
+            prep_in(dsp_registers_property);
+            prep_out(dsp_registers_property);
+            if(inStructSize-4<sizeof(dsp_registers_property))
+                return kIOReturnBadArgument;
+            size_t size=sizeof(dsp_registers_property)+in->n*sizeof(kx_reg_update);
+            if(in->n<0 || in->n>KX_MAX_DSP_REGISTERS || inStructSize-4!=size || *outStructSize-4!=size)
+            {
+                debug(DBGCLASS"::property: !! dsp_registers(): valuesize=%d instancesize=%d\n",*outStructSize,inStructSize);
+                return kIOReturnBadArgument;
+            }
+            if((void *)out!=(void *)in)
+                memcpy(out,in,size);
+            kx_reg_update *regs=(kx_reg_update *)&out[1];
+            if(in->cmd==KX_DSP_REGISTERS_SET)
+                out->ret=kx_set_dsp_registers(hw,in->pgm,regs,in->n);
+            else
+                out->ret=kx_get_dsp_registers(hw,in->pgm,regs,in->n);
+        }
+            break;
         case KX_PROP_TRAM_ADDR_NAME+KX_PROP_GET:
         {
             prep_in(dsp_register_property);
@@ -1530,6 +1618,18 @@ IOReturn kXAudioDevice::user_request(const void* inStruct, void* outStruct,uint3
                 case KX_PROP_MICROCODE_GET_FLAG:
                     out->cmd=kx_get_microcode_flag(hw,in->pgm,(dword *)&out->p1);
                     break;
+                case KX_PROP_MICROCODE_DSP_COMPACT:
+                    out->cmd=kx_dsp_compact(hw,in->p1);
+                    break;
+                case KX_PROP_MICROCODE_DSP_BEGIN:
+                    out->cmd=kx_dsp_begin(hw,client);
+                    break;
+                case KX_PROP_MICROCODE_DSP_COMMIT:
+                    out->cmd=kx_dsp_commit(hw,client);
+                    break;
+                case KX_PROP_MICROCODE_DSP_ABORT:
+                    out->cmd=kx_dsp_abort(hw,client);
+                    break;
                 default:
                     debug(DBGCLASS"::property: !!! Bad cmd in prop::microcode()\n");
                     return kIOReturnBadArgument;
@@ -1757,6 +1857,12 @@ IOReturn kXAudioDevice::user_request(const void* inStruct, void* outStruct,uint3
         case KX_PROP_SOUNDFONT_LOAD_SMPL+KX_PROP_GET:
         {
             prep_in(sf_load_sample_property);
+            // variable size: the block header and up to KX_SF_UPLOAD_CHUNK bytes of sample data
+            // (over 4096 bytes: see kXUserClient::StructIStructODescriptor())
+            if(inStructSize<sizeof(dword)+offsetof(sf_load_sample_property,data) ||
+               in->size<0 || in->size>KX_SF_UPLOAD_CHUNK ||
+               inStructSize-sizeof(dword)-offsetof(sf_load_sample_property,data)<(uint32_t)in->size)
+                return kIOReturnBadArgument;
             if(kx_load_soundfont_samples(hw,in))
                 return kIOReturnBadArgument;
         }
@@ -1822,6 +1928,22 @@ IOReturn kXAudioDevice::user_request(const void* inStruct, void* outStruct,uint3
             // 0xf0: skip
         }
             break;
+        case KX_PROP_SOUNDFONT_SYNTH_AT+KX_PROP_GET:
+        {
+            prep_in(kx_synth_event);
+            int cmd=in->data&0xf0;
+            int len=((cmd==0xc0) || (cmd==0xd0))?2:3;
+            if(cmd<0x80 || cmd==0xf0) // 0xf0: skip
+                break;
+            if(hw->midi[in->synth_id&1]==NULL)
+            {
+                debug(DBGCLASS"::property: kXdirectSynth: no midi device opened\n");
+                break;
+            }
+            if(kx_midi_schedule(hw->midi[in->synth_id&1],in->time,(byte *)&in->data,len))
+                return kIOReturnBadArgument;
+        }
+            break;
         case KX_PROP_MICROCODE_QUERY+KX_PROP_GET:
         {
             prep_in(int);
@@ -1909,6 +2031,37 @@ IOReturn kXAudioDevice::user_request(const void* inStruct, void* outStruct,uint3
             kx_get_voice_info(hw,KX_VOICE_INFO_SPECTRAL,out);
         }
             break;
+        case KX_PROP_DSP_RESOURCES+KX_PROP_GET:
+        {
+            prep_out(kx_dsp_resources);
+            if(*outStructSize-4!=sizeof(kx_dsp_resources))
+                return kIOReturnBadArgument;
+            if(kx_get_dsp_resources(hw,out))
+                return kIOReturnBadArgument;
+        }
+            break;
+        case KX_PROP_TELEMETRY+KX_PROP_GET:
+        {
+            prep_in(telemetry_property);
+            prep_out(telemetry_property);
+            if(inStructSize-4!=sizeof(telemetry_property) || *outStructSize-4!=sizeof(telemetry_property))
+                return kIOReturnBadArgument;
+            switch(in->cmd)
+            {
+                case KX_TELEMETRY_ADD_TAP:
+                    if(in->name[0])
+                        out->ret=kx_telemetry_add_tap(hw,in->pgm,in->name,in->flags,client);
+                    else
+                        out->ret=kx_telemetry_add_tap(hw,in->pgm,in->id,in->flags,client);
+                    break;
+                case KX_TELEMETRY_REMOVE_TAP:
+                    out->ret=kx_telemetry_remove_tap(hw,in->tap,client);
+                    break;
+                default: // the page is mapped with IOConnectMapMemory(kTelemetryMemory)
+                    return kIOReturnUnsupported;
+            }
+        }
+            break;
         case KX_PROP_MUTE+KX_PROP_GET:
         {
             kx_mute(hw);
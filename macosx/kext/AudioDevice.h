@@ -33,6 +33,8 @@
 #include <IOKit/pci/IOPCIDevice.h>
 #include <IOKit/IOFilterInterruptEventSource.h>
 #include <IOKit/IOUserClient.h>
+#include <IOKit/IOBufferMemoryDescriptor.h>
+#include <IOKit/IOLocks.h>
 #include <AvailabilityMacros.h>
 
 #include "driver/kx.h"
@@ -69,6 +71,11 @@ public:
 	dword							master_volume[2];
 	kXAudioEngine					*engine;
 	
+	// DSP telemetry page; mapped read-only into the clients by kXUserClient::clientMemoryForType()
+	IOBufferMemoryDescriptor		*telemetry_buffer;
+	IOLock							*telemetry_lock;
+	IOMemoryDescriptor *get_telemetry_memory();
+	
 	bool init(OSDictionary *dictionary);
 	virtual bool initHardware(IOService *provider);
     virtual bool createAudioEngine();
@@ -97,6 +104,7 @@ public:
     static void pci_free(void *call_with,struct memhandle *h) { ((kXAudioDevice *)call_with)->pci_free(h); };
     static void sync(void *call_with,sync_data*s) { ((kXAudioDevice *)call_with)->sync(s); };
     static void usleep(int microseconds) { IODelay(microseconds); };
+    static dword time_ms(void *call_with);
 	static void get_physical(void *call_with,kx_voice_buffer *buff,int offset,__int64 *physical) { ((kXAudioDevice *)call_with)->get_physical(buff,offset,physical); };
 
 	static int debug_func(int where,const char *__format, ... );
@@ -115,9 +123,12 @@ public:
     virtual IOReturn outputMuteChanged(IOAudioControl *muteControl, SInt32 oldValue, SInt32 newValue);
 	
 	int create_audio_controls(IOAudioEngine *audioEngine);
+	IOReturn process_request(void *client,const void* inStruct, void* outStruct,uint32_t inStructSize, const uint32_t* outStructSize);
 	
 public:
-	virtual IOReturn user_request(const void* inStruct, void* outStruct,uint32_t inStructSize, const uint32_t* outStructSize);
+	// 'client' is the kXUserClient; client_closed(): it is gone (DSP transactions are rolled back)
+	virtual IOReturn user_request(void *client,const void* inStruct, void* outStruct,uint32_t inStructSize, const uint32_t* outStructSize);
+	virtual void client_closed(void *client);
 
 	virtual IOReturn performPowerStateChange(IOAudioDevicePowerState oldPowerState, IOAudioDevicePowerState newPowerState, UInt32 *microsecondsUntilComplete);
 
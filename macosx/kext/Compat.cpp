@@ -29,6 +29,8 @@
 #include <IOKit/IOLib.h>
 #include <IOKit/pci/IOPCIDevice.h>
 #include <IOKit/IOFilterInterruptEventSource.h>
+#include <kern/thread.h>
+#include <kern/clock.h>
 
 #include "driver/kx.h"
 
@@ -126,6 +128,14 @@ void kXAudioDevice::send_message(int len,const void *b)
 	debug("kXAudioDevice[%p]::send_message: notification message\n",this);
 }
 
+dword kXAudioDevice::time_ms(void *call_with)
+{
+	uint64_t t,ns;
+	clock_get_uptime(&t);
+	absolutetime_to_nanoseconds(t,&ns);
+	return (dword)(ns/1000000);
+}
+
 void kXAudioDevice::notify_func(void *data,int what)
 {
 	if(what==LLA_NOTIFY_TIMER)
@@ -215,6 +225,15 @@ KX_API(void,kx_spin_lock_init(kx_hw *hw,spinlock_t *lock,const char *name))
 	lock->kx_lock=0;
 }
 
+KX_API(void,kx_spin_lock_free(kx_hw *hw,spinlock_t *lock))
+{
+	if(lock->lock)
+	{
+		IORecursiveLockFree(lock->lock);
+		lock->lock=NULL;
+	}
+}
+
 #undef kx_lock_acquire
 KX_API(void,kx_lock_acquire(kx_hw *hw, spinlock_t *lock, unsigned long *,const char *file,int line))
 {
@@ -233,6 +252,11 @@ KX_API(void,kx_lock_release(kx_hw *hw, spinlock_t *lock, unsigned long *,const c
 	IORecursiveLockUnlock(lock->lock);
 }
 
+KX_API(void *,kx_current_thread(void))
+{
+	return current_thread();
+}
+
 double kx_log10(register double _x_)
 {
 	// FIXME
@@ -29,6 +29,7 @@
 #include <IOKit/IOLib.h>
 #include <IOKit/pci/IOPCIDevice.h>
 #include <IOKit/IOFilterInterruptEventSource.h>
+#include <kern/thread.h>
 
 #include "driver/kx.h"
 
@@ -224,6 +225,11 @@ KX_API(void,kx_lock_release(kx_hw *hw, spinlock_t *lock, unsigned long *,const c
 	IORecursiveLockUnlock(lock->lock);
 }
 
+KX_API(void *,kx_current_thread(void))
+{
+	return current_thread();
+}
+
 double kx_log10(register double _x_)
 {
 	// FIXME
@@ -146,6 +146,10 @@ KX_API(void,kx_spin_lock_init(struct kx_hw*,spinlock_t *l,const char *name))
 // KeInitializeSpinLock((PKSPIN_LOCK)l);
 }
 
+KX_API(void,kx_spin_lock_free(struct kx_hw*,spinlock_t *l))
+{
+}
+
 #pragma warning(disable:4035)
 static dword inpd(word __port)
 {
@@ -241,6 +245,11 @@ int __cdecl main(int argc,char **argv)
   cb.save_fpu_state=&save_fpu_state;
   cb.rest_fpu_state=&rest_fpu_state;
   cb.usleep=&usleep_func;
+  cb.queue_work=NULL;
+  cb.flush_work=NULL;
+  cb.backing_alloc=NULL;
+  cb.backing_free=NULL;
+  cb.time_ms=NULL;
 
   cb.def_routings[DEF_WAVE01_ROUTING]=KX_MAKE_ROUTING(FXBUS0,FXBUS1,FXBUSD,FXBUSE);
   cb.def_xroutings[DEF_WAVE01_ROUTING]=KX_MAKE_ROUTING(0x3f,0x3f,0x3f,0x3f);
@@ -28,6 +28,9 @@
 #include "wdm/miniwave_p16v.h"
 
 extern "C" NTKERNELAPI PHYSICAL_ADDRESS MmGetPhysicalAddress (__in PVOID BaseAddress);
+// ntifs.h
+extern "C" NTKERNELAPI VOID KeStackAttachProcess(__inout PEPROCESS Process,__out PRKAPC_STATE ApcState);
+extern "C" NTKERNELAPI VOID KeUnstackDetachProcess(__in PRKAPC_STATE ApcState);
 
 
 /*****************************************************************************
@@ -84,10 +87,19 @@ Init
 
     DeviceObject=DeviceObject_;
     physical_device_object=0;
+    adapter_from_device(DeviceObject)=this;
 
     gsif_interface=NULL;
     gsif_device.Buffer=0;
 
+    KeInitializeSpinLock(&work_lock);
+    work_pending=0;
+    KeInitializeEvent(&work_idle,NotificationEvent,TRUE);
+
+    telemetry_page=NULL;
+    ExInitializeFastMutex(&telemetry_mutex);
+    RtlZeroMemory(telemetry_map,sizeof(telemetry_map));
+
     for(int i=0;i<MAX_MPU_DEVICES;i++)
      Uart[i]=NULL;
     for(int i=0;i<MAX_SYNTH_DEVICES;i++)
@@ -186,6 +198,22 @@ CAdapterCommon::~CAdapterCommon(void)
         hw=NULL;
     }
 
+    if(telemetry_page)
+    {
+        // the mappings are normally gone with the client handles (cleanup_file())
+        for(int i=0;i<MAX_TELEMETRY_MAPPINGS;i++)
+         if(telemetry_map[i].mdl)
+         {
+          debug(DWDM,"!!! ~CAdapterCommon: telemetry page is still mapped [%d]\n",i);
+          release_telemetry(i);
+         }
+        ExFreePool(telemetry_page);
+        telemetry_page=NULL;
+    }
+
+    if(DeviceObject && adapter_from_device(DeviceObject)==this)
+     adapter_from_device(DeviceObject)=NULL;
+
     if (InterruptSync)
     {
         InterruptSync->Disconnect();
@@ -570,6 +598,12 @@ void usleep(int microseconds)
  KeStallExecutionProcessor((ULONG)microseconds);
 }
 
+#pragma code_seg()
+dword time_ms_func(void *call_with)
+{
+ return (dword)(KeQueryInterruptTime()/10000); // 100 ns units
+}
+
 #pragma code_seg()
 int lmem_alloc_func(void *call_with,int len,void **lm,kx_cpu_cache_type_t cache)
 {
@@ -635,6 +669,119 @@ void * lmem_get_addr_func(void *call_with,void **lm,int offset,__int64 *phys_add
  return 0;
 }
 
+// work items for kx_callbacks::queue_work; counted in work_pending, so that flush_work_func() can wait for them
+struct kx_work_item
+{
+ WORK_QUEUE_ITEM item;
+ CAdapterCommon *adapter;
+ void (*func)(void *data);
+ void *data;
+};
+
+#pragma code_seg()
+static VOID work_item_routine(PVOID context)
+{
+ kx_work_item *w=(kx_work_item *)context;
+ CAdapterCommon *adapter=w->adapter;
+
+ w->func(w->data);
+ ExFreePool(w);
+
+ KIRQL old;
+ KeAcquireSpinLock(&adapter->work_lock,&old);
+ if(--adapter->work_pending==0)
+  KeSetEvent(&adapter->work_idle,0,FALSE);
+ KeReleaseSpinLock(&adapter->work_lock,old);
+}
+
+#pragma code_seg()
+int queue_work_func(void *call_with,void (*func)(void *data),void *data)
+{
+ CAdapterCommon *adapter=(CAdapterCommon *)call_with;
+
+ kx_work_item *w=(kx_work_item *)ExAllocatePoolWithTag(NonPagedPool,sizeof(kx_work_item),'wqXk');
+ if(w==NULL)
+ {
+  debug(DWDM,"!! queue_work: not enough memory\n");
+  return -1;
+ }
+ w->adapter=adapter;
+ w->func=func;
+ w->data=data;
+
+ KIRQL old;
+ KeAcquireSpinLock(&adapter->work_lock,&old);
+ if(adapter->work_pending++==0)
+  KeClearEvent(&adapter->work_idle);
+ KeReleaseSpinLock(&adapter->work_lock,old);
+
+ ExInitializeWorkItem(&w->item,work_item_routine,w);
+ ExQueueWorkItem(&w->item,DelayedWorkQueue);
+ return 0;
+}
+
+#pragma code_seg("PAGE")
+void flush_work_func(void *call_with)
+{
+ PAGED_CODE();
+
+ CAdapterCommon *adapter=(CAdapterCommon *)call_with;
+ KeWaitForSingleObject(&adapter->work_idle,Executive,KernelMode,FALSE,NULL);
+}
+
+// streamed SoundFont samples: a pagefile-backed section mapped into the system space; its pages are
+// committed as they are written and can be paged out, and it does not use the paged pool
+#pragma code_seg("PAGE")
+int backing_alloc_func(void *call_with,dword len,void **addr,void **handle)
+{
+ PAGED_CODE();
+
+ *addr=NULL;
+ *handle=NULL;
+
+ OBJECT_ATTRIBUTES oa;
+ InitializeObjectAttributes(&oa,NULL,OBJ_KERNEL_HANDLE,NULL,NULL);
+ LARGE_INTEGER size;
+ size.QuadPart=len;
+
+ HANDLE h=NULL;
+ NTSTATUS status=ZwCreateSection(&h,SECTION_ALL_ACCESS,&oa,&size,PAGE_READWRITE,SEC_COMMIT,NULL);
+ if(!NT_SUCCESS(status))
+ {
+  debug(DWDM,"!! backing_alloc: cannot create a section (%x)\n",status);
+  return -1;
+ }
+
+ PVOID section=NULL;
+ status=ObReferenceObjectByHandle(h,SECTION_ALL_ACCESS,NULL,KernelMode,&section,NULL);
+ ZwClose(h);
+ if(!NT_SUCCESS(status))
+  return -1;
+
+ PVOID base=NULL;
+ SIZE_T view=0;
+ status=MmMapViewInSystemSpace(section,&base,&view);
+ if(!NT_SUCCESS(status))
+ {
+  debug(DWDM,"!! backing_alloc: cannot map the section (%x)\n",status);
+  ObDereferenceObject(section);
+  return -2;
+ }
+
+ *addr=base;
+ *handle=section;
+ return 0;
+}
+
+#pragma code_seg("PAGE")
+void backing_free_func(void *call_with,void *addr,void *handle)
+{
+ PAGED_CODE();
+
+ MmUnmapViewInSystemSpace(addr);
+ ObDereferenceObject(handle);
+}
+
 #pragma code_seg()
 void notify_func(void *data,int what)
 {
@@ -1037,6 +1184,12 @@ KX_API(void,kx_lock_release(kx_hw *hw, spinlock_t *l, unsigned long *irq,const c
        }
 }
 
+#pragma code_seg()
+KX_API(void *,kx_current_thread(void))
+{
+ return KeGetCurrentThread();
+}
+
 #pragma code_seg()
 KX_API(void,kx_spin_lock_init(kx_hw *hw, spinlock_t *l,const char *name))
 {
@@ -1046,6 +1199,12 @@ KX_API(void,kx_spin_lock_init(kx_hw *hw, spinlock_t *l,const char *name))
  l->name=name;
 }
 
+#pragma code_seg()
+KX_API(void,kx_spin_lock_free(kx_hw *hw, spinlock_t *l))
+{
+ // KSPIN_LOCK has nothing to free
+}
+
 #pragma code_seg()
 void save_fpu_state(kx_fpu_state *state)
 {
@@ -1100,6 +1259,11 @@ int CAdapterCommon::my_init(dword device,dword subsys,byte chip_rev,
   cb.lmem_free_func=&lmem_free_func;
   cb.lmem_get_addr_func=&lmem_get_addr_func;
   cb.usleep=&usleep;
+  cb.queue_work=&queue_work_func;
+  cb.flush_work=&flush_work_func;
+  cb.backing_alloc=&backing_alloc_func;
+  cb.backing_free=&backing_free_func;
+  cb.time_ms=&time_ms_func;
 
   ResetSettings(&cb);
 
@@ -1121,3 +1285,156 @@ int CAdapterCommon::my_init(dword device,dword subsys,byte chip_rev,
  return 0;
 }
 
+
+// DSP telemetry: the page is allocated on the first request and mapped once per client handle;
+// the mapping is released with KX_TELEMETRY_UNMAP (iKX::close()) or when the handle is closed
+#pragma code_seg("PAGE")
+kx_telemetry_page *CAdapterCommon::map_telemetry(PFILE_OBJECT file)
+{
+ PAGED_CODE();
+
+ void *addr=NULL;
+ int i,slot=-1;
+
+ if(file==NULL || hw==NULL)
+  return NULL;
+
+ ExAcquireFastMutex(&telemetry_mutex);
+
+ if(telemetry_page==NULL)
+ {
+  // a whole page: no other kernel memory becomes visible to the clients
+  kx_telemetry_page *page=(kx_telemetry_page *)ExAllocatePoolWithTag(NonPagedPool,PAGE_SIZE,'mtXk');
+  if(page && kx_telemetry_attach(hw,page)==0)
+   telemetry_page=page;
+  else if(page)
+   ExFreePool(page);
+ }
+
+ if(telemetry_page)
+ for(i=0;i<MAX_TELEMETRY_MAPPINGS;i++)
+ {
+  if(telemetry_map[i].mdl==NULL)
+  {
+   if(slot==-1)
+    slot=i;
+   continue;
+  }
+  if(telemetry_map[i].file==file && telemetry_map[i].process==IoGetCurrentProcess())
+  {
+   telemetry_map[i].refs++;
+   addr=telemetry_map[i].addr;
+   slot=-1;
+   break;
+  }
+ }
+
+ if(slot!=-1)
+ {
+  PMDL mdl=IoAllocateMdl(telemetry_page,PAGE_SIZE,FALSE,FALSE,NULL);
+  if(mdl)
+  {
+   MmBuildMdlForNonPagedPool(mdl);
+   mdl->MdlFlags|=MDL_MAPPING_CAN_FAIL;
+
+   ULONG priority=NormalPagePriority;
+#if defined(MdlMappingNoWrite)
+   if(RtlIsNtDdiVersionAvailable(NTDDI_WIN8))
+    priority|=MdlMappingNoWrite; // read-only for the clients
+#endif
+   __try
+   {
+     addr=MmMapLockedPagesSpecifyCache(mdl,UserMode,MmCached,NULL,FALSE,(MM_PAGE_PRIORITY)priority);
+   }
+    __except(EXCEPTION_EXECUTE_HANDLER)
+   {
+     addr=NULL;
+   }
+
+   if(addr)
+   {
+    telemetry_map[slot].file=file;
+    telemetry_map[slot].process=IoGetCurrentProcess();
+    ObReferenceObject(telemetry_map[slot].process);
+    telemetry_map[slot].mdl=mdl;
+    telemetry_map[slot].addr=addr;
+    telemetry_map[slot].refs=1;
+   }
+   else
+    IoFreeMdl(mdl);
+  }
+ }
+ if(addr==NULL)
+  debug(DWDM,"!! telemetry: cannot map the page\n");
+
+ ExReleaseFastMutex(&telemetry_mutex);
+
+ return (kx_telemetry_page *)addr;
+}
+
+#pragma code_seg("PAGE")
+int CAdapterCommon::unmap_telemetry(PFILE_OBJECT file)
+{
+ PAGED_CODE();
+
+ int ret=-1;
+
+ ExAcquireFastMutex(&telemetry_mutex);
+ for(int i=0;i<MAX_TELEMETRY_MAPPINGS;i++)
+ {
+  if(telemetry_map[i].mdl && telemetry_map[i].file==file)
+  {
+   if(--telemetry_map[i].refs==0)
+    release_telemetry(i);
+   ret=0;
+   break;
+  }
+ }
+ ExReleaseFastMutex(&telemetry_mutex);
+
+ return ret;
+}
+
+// a user-mode mapping must be removed in the address space of its process:
+// IRP_MJ_CLEANUP can come from another one if the handle was duplicated
+#pragma code_seg()
+void CAdapterCommon::release_telemetry(int slot)
+{
+ KAPC_STATE apc_state;
+ PEPROCESS process=telemetry_map[slot].process;
+ int attach=(process!=IoGetCurrentProcess());
+
+ if(attach)
+  KeStackAttachProcess(process,&apc_state);
+ MmUnmapLockedPages(telemetry_map[slot].addr,telemetry_map[slot].mdl);
+ if(attach)
+  KeUnstackDetachProcess(&apc_state);
+
+ IoFreeMdl(telemetry_map[slot].mdl);
+ ObDereferenceObject(process);
+
+ telemetry_map[slot].file=NULL;
+ telemetry_map[slot].process=NULL;
+ telemetry_map[slot].mdl=NULL;
+ telemetry_map[slot].addr=NULL;
+ telemetry_map[slot].refs=0;
+}
+
+#pragma code_seg("PAGE")
+void CAdapterCommon::cleanup_file(PFILE_OBJECT file)
+{
+ PAGED_CODE();
+
+ ExAcquireFastMutex(&telemetry_mutex);
+ for(int i=0;i<MAX_TELEMETRY_MAPPINGS;i++)
+  if(telemetry_map[i].mdl && telemetry_map[i].file==file)
+   release_telemetry(i);
+ ExReleaseFastMutex(&telemetry_mutex);
+
+ if(hw)
+ {
+  // the taps of the client are removed, and a DSP transaction it left open is rolled back
+  kx_telemetry_release(hw,file);
+  kx_dsp_release(hw,file);
+ }
+}
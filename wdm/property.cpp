@@ -143,7 +143,17 @@ NTSTATUS process_property(CAdapterCommon *adapter,kx_hw *hw,PPCPROPERTY_REQUEST
        return STATUS_INVALID_PARAMETER;
       }
  }
- return actual_process(adapter,hw,that2,inst,req);
+ // the microcode and DSP register requests of the owner of a DSP transaction become part of it
+ // (see dsp.cpp); other requests do not touch the DSP
+ dword prop=inst->inst.prop&~(KX_PROP_GET|KX_PROP_SET);
+ if(prop<KX_PROP_DSP_REGISTER_NAME || prop>KX_PROP_UPDATE_MICROCODE)
+  return actual_process(adapter,hw,that2,inst,req);
+
+ PFILE_OBJECT file=IoGetCurrentIrpStackLocation(req->Irp)->FileObject;
+ kx_dsp_enter(hw,file);
+ NTSTATUS ret=actual_process(adapter,hw,that2,inst,req);
+ kx_dsp_leave(hw,file);
+ return ret;
 }
 
 #pragma code_seg("PAGE")
@@ -751,6 +761,26 @@ static NTSTATUS actual_process(CAdapterCommon *adapter,kx_hw *hw,CMiniportWaveSt
     }
     }
     break;
+  case KX_PROP_DSP_REGISTERS+KX_PROP_GET:
+    {
+    prep_ds_in(dsp_registers_property);
+    dsp_registers_property *out=(dsp_registers_property *)req->Value;
+    size_t size=sizeof(dsp_registers_property)+in->n*sizeof(kx_reg_update);
+    if(in->n<0 || in->n>KX_MAX_DSP_REGISTERS ||
+       req->InstanceSize-sizeof(my_prop)!=size || req->ValueSize!=size)
+    {
+     debug(DWDM,"!! dsp_registers(): n=%d valuesize=%d instancesize=%d\n",in->n,req->ValueSize,req->InstanceSize);
+     return STATUS_INVALID_PARAMETER;
+    }
+    kx_reg_update *regs=(kx_reg_update *)&out[1];
+    if(out!=in)
+     memcpy(out,in,size);
+    if(in->cmd==KX_DSP_REGISTERS_SET)
+     out->ret=kx_set_dsp_registers(hw,in->pgm,regs,in->n);
+    else
+     out->ret=kx_get_dsp_registers(hw,in->pgm,regs,in->n);
+    }
+    break;
   case KX_PROP_TRAM_ADDR_NAME+KX_PROP_GET:
     {
     prep_in(dsp_register_property);
@@ -1008,6 +1038,18 @@ static NTSTATUS actual_process(CAdapterCommon *adapter,kx_hw *hw,CMiniportWaveSt
         case KX_PROP_MICROCODE_GET_FLAG:
             out->cmd=kx_get_microcode_flag(hw,in->pgm,(dword *)&out->p1);
             break;
+        case KX_PROP_MICROCODE_DSP_COMPACT:
+            out->cmd=kx_dsp_compact(hw,in->p1);
+            break;
+        case KX_PROP_MICROCODE_DSP_BEGIN:
+            out->cmd=kx_dsp_begin(hw,IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+            break;
+        case KX_PROP_MICROCODE_DSP_COMMIT:
+            out->cmd=kx_dsp_commit(hw,IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+            break;
+        case KX_PROP_MICROCODE_DSP_ABORT:
+            out->cmd=kx_dsp_abort(hw,IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+            break;
         default:
             debug(DWDM,"!!! Bad cmd in prop::microcode()\n");
             return STATUS_INVALID_PARAMETER;
@@ -1227,7 +1269,15 @@ static NTSTATUS actual_process(CAdapterCommon *adapter,kx_hw *hw,CMiniportWaveSt
     break;
   case KX_PROP_SOUNDFONT_LOAD_SMPL+KX_PROP_GET:
     {
-    prep_in(sf_load_sample_property);
+    // variable size: the block header and up to KX_SF_UPLOAD_CHUNK bytes of sample data
+    sf_load_sample_property *in=(sf_load_sample_property *)&inst[1];
+    if(req->InstanceSize<sizeof(my_prop)+FIELD_OFFSET(sf_load_sample_property,data) ||
+       in->size<0 || in->size>KX_SF_UPLOAD_CHUNK ||
+       req->InstanceSize-sizeof(my_prop)-FIELD_OFFSET(sf_load_sample_property,data)<(dword)in->size)
+    {
+     debug(DWDM,"!!! sf load samples: invalid block (instance: %d)\n",req->InstanceSize);
+     return STATUS_INVALID_PARAMETER;
+    }
     if(kx_load_soundfont_samples(hw,in))
      return STATUS_INVALID_PARAMETER;
     }
@@ -1292,6 +1342,22 @@ static NTSTATUS actual_process(CAdapterCommon *adapter,kx_hw *hw,CMiniportWaveSt
          // 0xf0: skip
     }
     break;
+  case KX_PROP_SOUNDFONT_SYNTH_AT+KX_PROP_GET:
+    {
+     prep_in(kx_synth_event);
+     int cmd=in->data&0xf0;
+     int len=((cmd==0xc0) || (cmd==0xd0))?2:3;
+     if(cmd<0x80 || cmd==0xf0) // 0xf0: skip
+      break;
+     if(hw->midi[in->synth_id&1]==NULL)
+     {
+      debug(DWDM,"kXdirectSynth: no midi device opened\n");
+      break;
+     }
+     if(kx_midi_schedule(hw->midi[in->synth_id&1],in->time,(byte *)&in->data,len))
+      return STATUS_UNSUCCESSFUL;
+    }
+    break;
   case KX_PROP_MICROCODE_QUERY+KX_PROP_GET:
     {
     prep_in(int);
@@ -1379,6 +1445,42 @@ static NTSTATUS actual_process(CAdapterCommon *adapter,kx_hw *hw,CMiniportWaveSt
     kx_get_voice_info(hw,KX_VOICE_INFO_SPECTRAL,out);
     }
     break;
+  case KX_PROP_DSP_RESOURCES+KX_PROP_GET:
+    {
+    prep_out(kx_dsp_resources);
+    if(kx_get_dsp_resources(hw,out))
+     return STATUS_INVALID_PARAMETER;
+    }
+    break;
+  case KX_PROP_TELEMETRY+KX_PROP_GET:
+    {
+    prep_in(telemetry_property);
+    prep_out(telemetry_property);
+    if(adapter==NULL)
+     return STATUS_INVALID_PARAMETER;
+    switch(in->cmd)
+    {
+     case KX_TELEMETRY_MAP:
+        out->page=adapter->map_telemetry(IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+        out->ret=out->page?0:-1;
+        break;
+     case KX_TELEMETRY_UNMAP:
+        out->ret=adapter->unmap_telemetry(IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+        break;
+     case KX_TELEMETRY_ADD_TAP:
+        if(in->name[0])
+         out->ret=kx_telemetry_add_tap(hw,in->pgm,in->name,in->flags,IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+        else
+         out->ret=kx_telemetry_add_tap(hw,in->pgm,in->id,in->flags,IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+        break;
+     case KX_TELEMETRY_REMOVE_TAP:
+        out->ret=kx_telemetry_remove_tap(hw,in->tap,IoGetCurrentIrpStackLocation(req->Irp)->FileObject);
+        break;
+     default:
+        return STATUS_INVALID_PARAMETER;
+    }
+    }
+    break;
   case KX_PROP_MUTE+KX_PROP_GET:
     {
       kx_mute(hw);
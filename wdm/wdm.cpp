@@ -41,6 +41,7 @@ void parse_names(CAdapterCommon *adapter);
 #pragma code_seg("PAGE")
 
 DRIVER_ADD_DEVICE wdm_AddDevice;
+DRIVER_DISPATCH wdm_DispatchCleanup;
 
 extern "C" NTSTATUS wdm_StartDevice(
     IN      PDEVICE_OBJECT  pDeviceObject,  // Context for the class driver.
@@ -66,9 +67,27 @@ extern "C" NTSTATUS DriverEntry(IN PDRIVER_OBJECT   DriverObject,IN PUNICODE_STR
     NTSTATUS ntStatus = PcInitializeAdapterDriver( DriverObject,
                                                    RegistryPathName,
                                                    wdm_AddDevice);
+    // the rest goes to PortCls (see wdm_DispatchCleanup())
+    if(NT_SUCCESS(ntStatus))
+     DriverObject->MajorFunction[IRP_MJ_CLEANUP]=wdm_DispatchCleanup;
+
     return ntStatus;
 }
 
+// the last handle to a file object is closed: by the client or because its process is terminating,
+// in which case nothing else releases the resources the client holds (e.g. user-mode mappings)
+#pragma code_seg("PAGE")
+NTSTATUS wdm_DispatchCleanup(IN PDEVICE_OBJECT DeviceObject,IN PIRP Irp)
+{
+    PAGED_CODE();
+
+    CAdapterCommon *adapter=adapter_from_device(DeviceObject);
+    if(adapter && adapter->magic==ADAPTER_MAGIC)
+     adapter->cleanup_file(IoGetCurrentIrpStackLocation(Irp)->FileObject);
+
+    return PcDispatchIrp(DeviceObject,Irp);
+}
+
 
 #define MAX_KX_BOARDS   16
 PDEVICE_OBJECT physical_device_objects[MAX_KX_BOARDS]={0,};
@@ -103,7 +122,7 @@ NTSTATUS wdm_AddDevice(IN PDRIVER_OBJECT   DriverObject,IN PDEVICE_OBJECT   Phys
                                PhysicalDeviceObject,
                                PCPFNSTARTDEVICE( wdm_StartDevice ),
                                MAX_MINIPORTS,
-                               0);
+                               KX_DEVICE_EXTENSION_SIZE);
 
     return ret;
 }